@@ -14,6 +14,7 @@
 
 
 #include <string.h>
+#include <sys/socket.h>
 
 #include "esp_system.h"
 #define LOG_LOCAL_LEVEL 3
@@ -37,6 +38,9 @@
 
 static const char *TAG = "HTTP_CLIENT";
 
+/* Exported by tcp_transport, but declared only in its private header esp_transport_internal.h */
+int esp_transport_get_socket(esp_transport_handle_t t);
+
 /**
  * HTTP Buffer
  */
@@ -2047,6 +2051,41 @@ esp_http_client_transport_t esp_http_client_get_transport_type(esp_http_client_h
     }
 }
 
+bool esp_http_client_is_connection_alive(esp_http_client_handle_t client)
+{
+    if ((NULL == client) || (client->state != HTTP_STATE_CONNECTED)) {
+        return false;
+    }
+    const int sock = esp_transport_get_socket(client->transport);
+    if (sock < 0) {
+        /* The socket is not available for this transport, so the EOF can't be distinguished from pending data */
+        if (0 != esp_transport_poll_read(client->transport, 0)) {
+            ESP_LOGI(TAG, "Keep-alive connection to %s was closed by the server", client->connection_info.host);
+            esp_http_client_close(client);
+            return false;
+        }
+        return true;
+    }
+    /* Pending bytes (e.g. TLS 1.3 NewSessionTicket sent after the handshake) don't mean that the connection is closed,
+     * so only EOF or a socket error is checked by peeking without consuming the data. */
+    char byte = 0;
+    const int len = recv(sock, &byte, sizeof(byte), MSG_PEEK | MSG_DONTWAIT);
+    if (len > 0) {
+        return true;
+    }
+    if (len < 0) {
+        const int sock_errno = errno;
+        if ((EAGAIN == sock_errno) || (EWOULDBLOCK == sock_errno)) {
+            return true;
+        }
+        ESP_LOGI(TAG, "Keep-alive connection to %s failed, errno=%d", client->connection_info.host, sock_errno);
+    } else {
+        ESP_LOGI(TAG, "Keep-alive connection to %s was closed by the server", client->connection_info.host);
+    }
+    esp_http_client_close(client);
+    return false;
+}
+
 void esp_http_client_add_auth(esp_http_client_handle_t client)
 {
     if (client == NULL) {
@@ -525,6 +525,19 @@ esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
  */
 esp_http_client_transport_t esp_http_client_get_transport_type(esp_http_client_handle_t client);
 
+/**
+ * @brief      Check that the connection kept alive after the previous request can be used for the next one.
+ *
+ *             If the server has closed the idle connection (EOF) or the socket has an error,
+ *             then the connection is closed and the next esp_http_client_perform will reconnect.
+ *             Pending data (e.g. TLS 1.3 NewSessionTicket) is not consumed and does not close the connection.
+ *
+ * @param[in]  client   The esp_http_client handle
+ *
+ * @return     true if the next request will be sent over the already established connection
+ */
+bool esp_http_client_is_connection_alive(esp_http_client_handle_t client);
+
 /**
  * @brief      Set redirection URL.
  *             When received the 30x code from the server, the client stores the redirect URL provided by the server.
@@ -7,10 +7,20 @@
 #include <stdbool.h>
 #include "esp_crt_bundle.h"
 #include "esp_log.h"
+#include "mbedtls/sha256.h"
+#include <freertos/FreeRTOS.h>
 
 #define BUNDLE_HEADER_OFFSET 2
 #define CRT_HEADER_OFFSET 4
 
+#ifdef CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE_SIZE
+#define VERIFY_CACHE_SIZE CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE_SIZE
+#else
+#define VERIFY_CACHE_SIZE 0
+#endif
+
+#define VERIFY_CACHE_HASH_SIZE 32
+
 static const char *TAG = "esp-x509-crt-bundle";
 
 /* a dummy certificate so that
@@ -30,8 +40,59 @@ typedef struct crt_bundle_t {
 
 static crt_bundle_t s_crt_bundle;
 
+/* Cache of the certificates which were successfully verified against the bundle.
+ * The certificate is identified by the SHA-256 of its DER encoding, so a cache hit means that exactly
+ * the same certificate was already checked against the same root key and the expensive public-key
+ * verification can be skipped.
+ */
+typedef struct verify_cache_t {
+#if VERIFY_CACHE_SIZE > 0
+    uint8_t hash[VERIFY_CACHE_SIZE][VERIFY_CACHE_HASH_SIZE];
+    uint8_t num_entries;
+    uint8_t next_idx;
+#endif
+    uint32_t hits;
+    uint32_t misses;
+} verify_cache_t;
+
+static verify_cache_t s_verify_cache;
+static portMUX_TYPE s_verify_cache_lock = portMUX_INITIALIZER_UNLOCKED;
+
 static int esp_crt_check_signature(mbedtls_x509_crt *child, const uint8_t *pub_key_buf, size_t pub_key_len);
 
+#if VERIFY_CACHE_SIZE > 0
+static bool esp_crt_verify_cache_find(const uint8_t *hash)
+{
+    bool found = false;
+    portENTER_CRITICAL(&s_verify_cache_lock);
+    for (int i = 0; i < s_verify_cache.num_entries; i++) {
+        if (memcmp(s_verify_cache.hash[i], hash, VERIFY_CACHE_HASH_SIZE) == 0) {
+            found = true;
+            break;
+        }
+    }
+    if (found) {
+        s_verify_cache.hits++;
+    } else {
+        s_verify_cache.misses++;
+    }
+    portEXIT_CRITICAL(&s_verify_cache_lock);
+    return found;
+}
+
+static void esp_crt_verify_cache_add(const uint8_t *hash)
+{
+    portENTER_CRITICAL(&s_verify_cache_lock);
+    /* The oldest entry is replaced when the cache is full */
+    memcpy(s_verify_cache.hash[s_verify_cache.next_idx], hash, VERIFY_CACHE_HASH_SIZE);
+    s_verify_cache.next_idx = (s_verify_cache.next_idx + 1) % VERIFY_CACHE_SIZE;
+    if (s_verify_cache.num_entries < VERIFY_CACHE_SIZE) {
+        s_verify_cache.num_entries++;
+    }
+    portEXIT_CRITICAL(&s_verify_cache_lock);
+}
+#endif
+
 
 static int esp_crt_check_signature(mbedtls_x509_crt *child, const uint8_t *pub_key_buf, size_t pub_key_len)
 {
@@ -99,6 +160,18 @@ int esp_crt_verify_callback(void *buf, mbedtls_x509_crt *crt, int depth, uint32_
         return MBEDTLS_ERR_X509_FATAL_ERROR;
     }
 
+#if VERIFY_CACHE_SIZE > 0
+    /* Expired or not yet valid certificates never get here (flags_filtered contains other bits than
+       MBEDTLS_X509_BADCERT_NOT_TRUSTED for them), so a cached entry is used only while the certificate is valid */
+    uint8_t crt_hash[VERIFY_CACHE_HASH_SIZE];
+    const bool crt_hash_valid = (mbedtls_sha256(child->raw.p, child->raw.len, crt_hash, 0) == 0);
+    if (crt_hash_valid && esp_crt_verify_cache_find(crt_hash)) {
+        ESP_LOGD(TAG, "Certificate validated (cached)");
+        *flags = 0;
+        return 0;
+    }
+#endif
+
     ESP_LOGD(TAG, "%d certificates in bundle", s_crt_bundle.num_certs);
 
     size_t name_len = 0;
@@ -134,6 +207,11 @@ int esp_crt_verify_callback(void *buf, mbedtls_x509_crt *crt, int depth, uint32_
 
     if (ret == 0) {
         ESP_LOGI(TAG, "Certificate validated");
+#if VERIFY_CACHE_SIZE > 0
+        if (crt_hash_valid) {
+            esp_crt_verify_cache_add(crt_hash);
+        }
+#endif
         *flags = 0;
         return 0;
     }
@@ -196,6 +274,8 @@ static esp_err_t esp_crt_bundle_init(const uint8_t *x509_bundle, size_t bundle_s
     free(s_crt_bundle.crts);
     s_crt_bundle.num_certs = num_certs;
     s_crt_bundle.crts = crts;
+    /* The certificates verified against the previous bundle are not trusted anymore */
+    esp_crt_bundle_verify_cache_flush();
     return ESP_OK;
 }
 
@@ -230,6 +310,7 @@ void esp_crt_bundle_detach(mbedtls_ssl_config *conf)
 {
     free(s_crt_bundle.crts);
     s_crt_bundle.crts = NULL;
+    esp_crt_bundle_verify_cache_flush();
     if (conf) {
         mbedtls_ssl_conf_verify(conf, NULL, NULL);
     }
@@ -239,3 +320,21 @@ esp_err_t esp_crt_bundle_set(const uint8_t *x509_bundle, size_t bundle_size)
 {
     return esp_crt_bundle_init(x509_bundle, bundle_size);
 }
+
+void esp_crt_bundle_verify_cache_flush(void)
+{
+    portENTER_CRITICAL(&s_verify_cache_lock);
+#if VERIFY_CACHE_SIZE > 0
+    s_verify_cache.num_entries = 0;
+    s_verify_cache.next_idx = 0;
+#endif
+    portEXIT_CRITICAL(&s_verify_cache_lock);
+}
+
+void esp_crt_bundle_verify_cache_get_stat(esp_crt_bundle_verify_cache_stat_t *stat)
+{
+    portENTER_CRITICAL(&s_verify_cache_lock);
+    stat->hits = s_verify_cache.hits;
+    stat->misses = s_verify_cache.misses;
+    portEXIT_CRITICAL(&s_verify_cache_lock);
+}
@@ -60,6 +60,33 @@ void esp_crt_bundle_detach(mbedtls_ssl_config *conf);
 esp_err_t esp_crt_bundle_set(const uint8_t *x509_bundle, size_t bundle_size);
 
 
+/**
+ * @brief      Counters of the certificate verification cache
+ */
+typedef struct {
+    uint32_t hits;      /*!< Number of certificates which were found in the cache */
+    uint32_t misses;    /*!< Number of certificates which were verified with the public key of the root certificate */
+} esp_crt_bundle_verify_cache_stat_t;
+
+
+/**
+ * @brief      Flush the certificate verification cache
+ *
+ * The certificates which were successfully verified against the bundle are cached
+ * (see CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE_SIZE), so the signature check is skipped when the same
+ * server certificate is presented again. The cache is flushed automatically when the bundle is changed or detached.
+ */
+void esp_crt_bundle_verify_cache_flush(void);
+
+
+/**
+ * @brief      Get the hit/miss counters of the certificate verification cache
+ *
+ * @param[out] stat      Pointer to the structure to fill.
+ */
+void esp_crt_bundle_verify_cache_get_stat(esp_crt_bundle_verify_cache_stat_t *stat);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,7 @@
 #include "unity.h"
 #include "test_utils.h"
 #include "unity_test_utils.h"
+#include "ccomp_timer.h"
 
 #define SERVER_ADDRESS "localhost"
 #define SERVER_PORT "4433"
@@ -439,6 +440,64 @@ TEST_CASE("custom certificate bundle - wrong signature", "[mbedtls]")
     esp_crt_bundle_detach(NULL);
 }
 
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE_VERIFY_CACHE_SIZE > 0
+TEST_CASE("custom certificate bundle - verify cache", "[mbedtls]")
+{
+    /* Check that the repeated verification of the same certificate chain is served from the cache
+       and that the failed verifications are not cached */
+    const int num_repeats = 10;
+    mbedtls_x509_crt crt;
+    uint32_t flags = 0;
+    esp_crt_bundle_verify_cache_stat_t stat_prev;
+    esp_crt_bundle_verify_cache_stat_t stat;
+
+    esp_crt_bundle_attach(NULL);
+    esp_crt_bundle_verify_cache_flush();
+
+    mbedtls_x509_crt_init( &crt );
+    mbedtls_x509_crt_parse(&crt, correct_sig_crt_pem_start, correct_sig_crt_pem_end - correct_sig_crt_pem_start);
+
+    esp_crt_bundle_verify_cache_get_stat(&stat_prev);
+    ccomp_timer_start();
+    TEST_ASSERT(mbedtls_x509_crt_verify(&crt, NULL, NULL, NULL, &flags, esp_crt_verify_callback, NULL) == 0);
+    int64_t elapsed_usec_miss = ccomp_timer_stop();
+    esp_crt_bundle_verify_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(stat_prev.misses + 1, stat.misses);
+    TEST_ASSERT_EQUAL_UINT32(stat_prev.hits, stat.hits);
+
+    ccomp_timer_start();
+    for (int i = 0; i < num_repeats; i++) {
+        TEST_ASSERT(mbedtls_x509_crt_verify(&crt, NULL, NULL, NULL, &flags, esp_crt_verify_callback, NULL) == 0);
+    }
+    int64_t elapsed_usec_hit = ccomp_timer_stop() / num_repeats;
+    esp_crt_bundle_verify_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(stat_prev.misses + 1, stat.misses);
+    TEST_ASSERT_EQUAL_UINT32(stat_prev.hits + num_repeats, stat.hits);
+
+    printf("Certificate chain verification: %lld us without cache, %lld us with cache, %lld us saved\n",
+           elapsed_usec_miss, elapsed_usec_hit, elapsed_usec_miss - elapsed_usec_hit);
+    TEST_ASSERT_LESS_THAN(elapsed_usec_miss, elapsed_usec_hit);
+
+    /* After flushing the certificate must be verified again */
+    esp_crt_bundle_verify_cache_flush();
+    TEST_ASSERT(mbedtls_x509_crt_verify(&crt, NULL, NULL, NULL, &flags, esp_crt_verify_callback, NULL) == 0);
+    esp_crt_bundle_verify_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(stat_prev.misses + 2, stat.misses);
+    mbedtls_x509_crt_free(&crt);
+
+    /* The certificate with the wrong signature must fail every time */
+    mbedtls_x509_crt_init( &crt );
+    mbedtls_x509_crt_parse(&crt, wrong_sig_crt_pem_start, wrong_sig_crt_pem_end - wrong_sig_crt_pem_start);
+    TEST_ASSERT(mbedtls_x509_crt_verify(&crt, NULL, NULL, NULL, &flags, esp_crt_verify_callback, NULL) != 0);
+    TEST_ASSERT(mbedtls_x509_crt_verify(&crt, NULL, NULL, NULL, &flags, esp_crt_verify_callback, NULL) != 0);
+    esp_crt_bundle_verify_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(stat_prev.hits + num_repeats, stat.hits);
+    mbedtls_x509_crt_free(&crt);
+
+    esp_crt_bundle_detach(NULL);
+}
+#endif
+
 TEST_CASE("custom certificate bundle init API - bound checking", "[mbedtls]")
 {
 
@@ -99,4 +99,11 @@
 #define OUTBOX_MAX_SIZE             (4*1024)
 #endif
 
+// The maximum number of messages in the outbox, it must be a power of 2
+#ifdef  CONFIG_MQTT_OUTBOX_MAX_ITEMS
+#define OUTBOX_MAX_ITEMS            CONFIG_MQTT_OUTBOX_MAX_ITEMS
+#else
+#define OUTBOX_MAX_ITEMS            (64)
+#endif
+
 #endif
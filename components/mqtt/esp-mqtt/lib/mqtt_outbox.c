@@ -3,71 +3,253 @@
 #include <string.h>
 #include "sys/queue.h"
 #include "esp_log.h"
+#include "mqtt_config.h"
 
 #ifndef CONFIG_MQTT_CUSTOM_OUTBOX
 static const char *TAG = "OUTBOX";
 
+/*
+ * The outbox has a fixed capacity and it does not allocate memory for every message:
+ * - the storage (the descriptors of items, the index and the ring buffer for the data) is allocated
+ *   once on the first enqueue and it's freed in outbox_destroy,
+ * - the data of the messages are placed one after another into the ring buffer of OUTBOX_MAX_SIZE bytes,
+ *   the space is reclaimed when the oldest item is deleted (the items are kept in the order of allocation),
+ *   the holes left by the items deleted out of order (e.g. QoS1 acks) are merged by outbox_ring_compact
+ *   when there is no contiguous space for a new item,
+ * - the items are looked up by msg_id using a hash index, so enqueue/ack are O(1).
+ */
+
+#define OUTBOX_INDEX_SIZE (2 * OUTBOX_MAX_ITEMS)
+
+_Static_assert((OUTBOX_INDEX_SIZE & (OUTBOX_INDEX_SIZE - 1)) == 0, "OUTBOX_INDEX_SIZE must be a power of 2");
+
 typedef struct outbox_item {
-    char *buffer;
+    uint8_t *buffer;
     int len;
     int msg_id;
     int msg_type;
     int msg_qos;
     outbox_tick_t tick;
     pending_state_t pending;
-    STAILQ_ENTRY(outbox_item) next;
+    bool used;
+    TAILQ_ENTRY(outbox_item) next;
+    struct outbox_item *index_next;
 } outbox_item_t;
 
-STAILQ_HEAD(outbox_list_t, outbox_item);
+TAILQ_HEAD(outbox_items_list_t, outbox_item);
+
+typedef struct outbox_storage {
+    outbox_item_t items[OUTBOX_MAX_ITEMS];
+    outbox_item_t *index[OUTBOX_INDEX_SIZE];
+    uint8_t ring[OUTBOX_MAX_SIZE];
+} outbox_storage_t;
+
+struct outbox_list_t {
+    struct outbox_items_list_t items;   // Items in the order of allocation of their data in the ring buffer
+    outbox_item_t *free_items;          // Unused descriptors linked via index_next
+    outbox_storage_t *storage;
+    int ring_head;
+    int size;
+    int num_items_by_state[CONFIRMED + 1];
+};
+
+
+static bool outbox_storage_alloc(outbox_handle_t outbox)
+{
+    outbox->storage = calloc(1, sizeof(*outbox->storage));
+    ESP_MEM_CHECK(TAG, outbox->storage, return false);
+    for (int i = OUTBOX_MAX_ITEMS - 1; i >= 0; --i) {
+        outbox->storage->items[i].index_next = outbox->free_items;
+        outbox->free_items = &outbox->storage->items[i];
+    }
+    return true;
+}
+
+static outbox_item_t **outbox_index_bucket(outbox_handle_t outbox, int msg_id)
+{
+    return &outbox->storage->index[(unsigned)msg_id & (OUTBOX_INDEX_SIZE - 1)];
+}
+
+static void outbox_index_insert(outbox_handle_t outbox, outbox_item_t *item)
+{
+    // Items with the same msg_id (e.g. PUBLISH and PUBREL) are kept in the order of insertion
+    outbox_item_t **p_link = outbox_index_bucket(outbox, item->msg_id);
+    while (*p_link) {
+        p_link = &(*p_link)->index_next;
+    }
+    item->index_next = NULL;
+    *p_link = item;
+}
+
+static void outbox_index_remove(outbox_handle_t outbox, outbox_item_t *item)
+{
+    outbox_item_t **p_link = outbox_index_bucket(outbox, item->msg_id);
+    while (*p_link) {
+        if (*p_link == item) {
+            *p_link = item->index_next;
+            return;
+        }
+        p_link = &(*p_link)->index_next;
+    }
+}
+
+/**
+ * Find a contiguous space for len bytes in the ring buffer,
+ * the live data occupy [tail, head) or [tail, OUTBOX_MAX_SIZE) + [0, head) if the ring is wrapped.
+ */
+static int outbox_ring_alloc(outbox_handle_t outbox, int len)
+{
+    const outbox_item_t *oldest = TAILQ_FIRST(&outbox->items);
+    if (oldest == NULL) {
+        return (len <= OUTBOX_MAX_SIZE) ? 0 : -1;
+    }
+    const int tail = oldest->buffer - outbox->storage->ring;
+    const int head = outbox->ring_head;
+    if (head > tail) {
+        if (len <= (OUTBOX_MAX_SIZE - head)) {
+            return head;
+        }
+        return (len <= tail) ? 0 : -1;
+    }
+    return (len <= (tail - head)) ? head : -1;
+}
+
+/**
+ * Move the data of the live items together, so that all the free space of the ring buffer becomes contiguous.
+ * The order of the items is kept: the items placed after the wrap of the ring buffer (or all the items
+ * if the ring is not wrapped) are moved down to its beginning, the items before the wrap are moved up to its end.
+ */
+static void outbox_ring_compact(outbox_handle_t outbox)
+{
+    uint8_t *const ring = outbox->storage->ring;
+    outbox_item_t *first_wrapped = NULL;
+    const uint8_t *prev_buffer = NULL;
+    outbox_item_t *item;
+    TAILQ_FOREACH(item, &outbox->items, next) {
+        if ((prev_buffer != NULL) && (item->buffer < prev_buffer)) {
+            first_wrapped = item;
+            break;
+        }
+        prev_buffer = item->buffer;
+    }
+    int head = 0;
+    for (item = (first_wrapped != NULL) ? first_wrapped : TAILQ_FIRST(&outbox->items); item != NULL;
+            item = TAILQ_NEXT(item, next)) {
+        memmove(&ring[head], item->buffer, item->len);
+        item->buffer = &ring[head];
+        head += item->len;
+    }
+    if (first_wrapped != NULL) {
+        int tail = OUTBOX_MAX_SIZE;
+        for (item = TAILQ_PREV(first_wrapped, outbox_items_list_t, next); item != NULL;
+                item = TAILQ_PREV(item, outbox_items_list_t, next)) {
+            tail -= item->len;
+            memmove(&ring[tail], item->buffer, item->len);
+            item->buffer = &ring[tail];
+        }
+    }
+    outbox->ring_head = head;
+}
 
+static void outbox_item_free(outbox_handle_t outbox, outbox_item_t *item)
+{
+    TAILQ_REMOVE(&outbox->items, item, next);
+    outbox_index_remove(outbox, item);
+    outbox->size -= item->len;
+    outbox->num_items_by_state[item->pending]--;
+    item->used = false;
+    item->index_next = outbox->free_items;
+    outbox->free_items = item;
+    if (TAILQ_EMPTY(&outbox->items)) {
+        outbox->ring_head = 0;
+    }
+}
+
+static bool outbox_item_is_valid(outbox_handle_t outbox, outbox_item_handle_t item)
+{
+    if ((outbox->storage == NULL) || (item < &outbox->storage->items[0])
+            || (item >= &outbox->storage->items[OUTBOX_MAX_ITEMS])) {
+        return false;
+    }
+    return item->used;
+}
 
 outbox_handle_t outbox_init(void)
 {
     outbox_handle_t outbox = calloc(1, sizeof(struct outbox_list_t));
     ESP_MEM_CHECK(TAG, outbox, return NULL);
-    STAILQ_INIT(outbox);
+    TAILQ_INIT(&outbox->items);
     return outbox;
 }
 
 outbox_item_handle_t outbox_enqueue(outbox_handle_t outbox, outbox_message_handle_t message, outbox_tick_t tick)
 {
-    outbox_item_handle_t item = calloc(1, sizeof(outbox_item_t));
-    ESP_MEM_CHECK(TAG, item, return NULL);
+    if ((outbox->storage == NULL) && !outbox_storage_alloc(outbox)) {
+        return NULL;
+    }
+    const int len = message->len + message->remaining_len;
+    if (outbox->free_items == NULL) {
+        ESP_LOGE(TAG, "Can't enqueue msgid=%d, the maximum number of items (%d) reached",
+                 message->msg_id, OUTBOX_MAX_ITEMS);
+        return NULL;
+    }
+    int offset = outbox_ring_alloc(outbox, len);
+    if ((offset < 0) && (len <= (OUTBOX_MAX_SIZE - outbox->size))) {
+        ESP_LOGD(TAG, "Compact the ring buffer to enqueue msgid=%d, len=%d, size=%d", message->msg_id, len, outbox->size);
+        outbox_ring_compact(outbox);
+        offset = outbox_ring_alloc(outbox, len);
+    }
+    if (offset < 0) {
+        ESP_LOGE(TAG, "Can't enqueue msgid=%d, len=%d: no contiguous space in the ring buffer (size=%d)",
+                 message->msg_id, len, outbox->size);
+        return NULL;
+    }
+    outbox_item_handle_t item = outbox->free_items;
+    outbox->free_items = item->index_next;
+
     item->msg_id = message->msg_id;
     item->msg_type = message->msg_type;
     item->msg_qos = message->msg_qos;
     item->tick = tick;
-    item->len =  message->len + message->remaining_len;
+    item->len = len;
     item->pending = QUEUED;
-    item->buffer = malloc(message->len + message->remaining_len);
-    ESP_MEM_CHECK(TAG, item->buffer, {
-        free(item);
-        return NULL;
-    });
+    item->used = true;
+    item->buffer = &outbox->storage->ring[offset];
     memcpy(item->buffer, message->data, message->len);
     if (message->remaining_data) {
         memcpy(item->buffer + message->len, message->remaining_data, message->remaining_len);
     }
-    STAILQ_INSERT_TAIL(outbox, item, next);
-    ESP_LOGD(TAG, "ENQUEUE msgid=%d, msg_type=%d, len=%d, size=%d", message->msg_id, message->msg_type, message->len + message->remaining_len, outbox_get_size(outbox));
+    outbox->ring_head = offset + len;
+    outbox->size += len;
+    outbox->num_items_by_state[QUEUED]++;
+    TAILQ_INSERT_TAIL(&outbox->items, item, next);
+    outbox_index_insert(outbox, item);
+    ESP_LOGD(TAG, "ENQUEUE msgid=%d, msg_type=%d, len=%d, size=%d", message->msg_id, message->msg_type, len, outbox_get_size(outbox));
     return item;
 }
 
 outbox_item_handle_t outbox_get(outbox_handle_t outbox, int msg_id)
 {
-    outbox_item_handle_t item;
-    STAILQ_FOREACH(item, outbox, next) {
+    if (outbox->storage == NULL) {
+        return NULL;
+    }
+    outbox_item_handle_t item = *outbox_index_bucket(outbox, msg_id);
+    while (item) {
         if (item->msg_id == msg_id) {
             return item;
         }
+        item = item->index_next;
     }
     return NULL;
 }
 
 outbox_item_handle_t outbox_dequeue(outbox_handle_t outbox, pending_state_t pending, outbox_tick_t *tick)
 {
+    if (outbox->num_items_by_state[pending] == 0) {
+        return NULL;
+    }
     outbox_item_handle_t item;
-    STAILQ_FOREACH(item, outbox, next) {
+    TAILQ_FOREACH(item, &outbox->items, next) {
         if (item->pending == pending) {
             if (tick) {
                 *tick = item->tick;
@@ -80,16 +262,11 @@ outbox_item_handle_t outbox_dequeue(outbox_handle_t outbox, pending_state_t pend
 
 esp_err_t outbox_delete_item(outbox_handle_t outbox, outbox_item_handle_t item_to_delete)
 {
-    outbox_item_handle_t item;
-    STAILQ_FOREACH(item, outbox, next) {
-        if (item == item_to_delete) {
-            STAILQ_REMOVE(outbox, item, outbox_item, next);
-            free(item->buffer);
-            free(item);
-            return ESP_OK;
-        }
+    if (!outbox_item_is_valid(outbox, item_to_delete)) {
+        return ESP_FAIL;
     }
-    return ESP_FAIL;
+    outbox_item_free(outbox, item_to_delete);
+    return ESP_OK;
 }
 
 uint8_t *outbox_item_get_data(outbox_item_handle_t item,  size_t *len, uint16_t *msg_id, int *msg_type, int *qos)
@@ -99,43 +276,43 @@ uint8_t *outbox_item_get_data(outbox_item_handle_t item,  size_t *len, uint16_t
         *msg_id = item->msg_id;
         *msg_type = item->msg_type;
         *qos = item->msg_qos;
-        return (uint8_t *)item->buffer;
+        return item->buffer;
     }
     return NULL;
 }
 
 esp_err_t outbox_delete(outbox_handle_t outbox, int msg_id, int msg_type)
 {
-    outbox_item_handle_t item, tmp;
-    STAILQ_FOREACH_SAFE(item, outbox, next, tmp) {
+    if (outbox->storage == NULL) {
+        return ESP_FAIL;
+    }
+    outbox_item_handle_t item = *outbox_index_bucket(outbox, msg_id);
+    while (item) {
         if (item->msg_id == msg_id && (0xFF & (item->msg_type)) == msg_type) {
-            STAILQ_REMOVE(outbox, item, outbox_item, next);
-            free(item->buffer);
-            free(item);
+            outbox_item_free(outbox, item);
             ESP_LOGD(TAG, "DELETED msgid=%d, msg_type=%d, remain size=%d", msg_id, msg_type, outbox_get_size(outbox));
             return ESP_OK;
         }
-
+        item = item->index_next;
     }
     return ESP_FAIL;
 }
+
 esp_err_t outbox_delete_msgid(outbox_handle_t outbox, int msg_id)
 {
-    outbox_item_handle_t item, tmp;
-    STAILQ_FOREACH_SAFE(item, outbox, next, tmp) {
-        if (item->msg_id == msg_id) {
-            STAILQ_REMOVE(outbox, item, outbox_item, next);
-            free(item->buffer);
-            free(item);
-        }
-
+    outbox_item_handle_t item;
+    while ((item = outbox_get(outbox, msg_id)) != NULL) {
+        outbox_item_free(outbox, item);
     }
     return ESP_OK;
 }
+
 esp_err_t outbox_set_pending(outbox_handle_t outbox, int msg_id, pending_state_t pending)
 {
     outbox_item_handle_t item = outbox_get(outbox, msg_id);
     if (item) {
+        outbox->num_items_by_state[item->pending]--;
+        outbox->num_items_by_state[pending]++;
         item->pending = pending;
         return ESP_OK;
     }
@@ -155,59 +332,43 @@ esp_err_t outbox_set_tick(outbox_handle_t outbox, int msg_id, outbox_tick_t tick
 esp_err_t outbox_delete_msgtype(outbox_handle_t outbox, int msg_type)
 {
     outbox_item_handle_t item, tmp;
-    STAILQ_FOREACH_SAFE(item, outbox, next, tmp) {
+    TAILQ_FOREACH_SAFE(item, &outbox->items, next, tmp) {
         if (item->msg_type == msg_type) {
-            STAILQ_REMOVE(outbox, item, outbox_item, next);
-            free(item->buffer);
-            free(item);
+            outbox_item_free(outbox, item);
         }
-
     }
     return ESP_OK;
 }
+
 int outbox_delete_single_expired(outbox_handle_t outbox, outbox_tick_t current_tick, outbox_tick_t timeout)
 {
-    int msg_id = -1;
     outbox_item_handle_t item;
-    STAILQ_FOREACH(item, outbox, next) {
+    TAILQ_FOREACH(item, &outbox->items, next) {
         if (current_tick - item->tick > timeout) {
-            STAILQ_REMOVE(outbox, item, outbox_item, next);
-            free(item->buffer);
-            msg_id = item->msg_id;
-            free(item);
+            const int msg_id = item->msg_id;
+            outbox_item_free(outbox, item);
             return msg_id;
         }
-
     }
-    return msg_id;
+    return -1;
 }
 
 int outbox_delete_expired(outbox_handle_t outbox, outbox_tick_t current_tick, outbox_tick_t timeout)
 {
     int deleted_items = 0;
     outbox_item_handle_t item, tmp;
-    STAILQ_FOREACH_SAFE(item, outbox, next, tmp) {
+    TAILQ_FOREACH_SAFE(item, &outbox->items, next, tmp) {
         if (current_tick - item->tick > timeout) {
-            STAILQ_REMOVE(outbox, item, outbox_item, next);
-            free(item->buffer);
-            free(item);
+            outbox_item_free(outbox, item);
             deleted_items ++;
         }
-
     }
     return deleted_items;
 }
 
 int outbox_get_size(outbox_handle_t outbox)
 {
-    int siz = 0;
-    outbox_item_handle_t item;
-    STAILQ_FOREACH(item, outbox, next) {
-        // Suppressing "use after free" warning as this could happen only if queue is in inconsistent state
-        // which never happens if STAILQ interface used
-        siz += item->len; // NOLINT(clang-analyzer-unix.Malloc)
-    }
-    return siz;
+    return outbox->size;
 }
 
 esp_err_t outbox_cleanup(outbox_handle_t outbox, int max_size)
@@ -217,9 +378,7 @@ esp_err_t outbox_cleanup(outbox_handle_t outbox, int max_size)
         if (item == NULL) {
             return ESP_FAIL;
         }
-        STAILQ_REMOVE(outbox, item, outbox_item, next);
-        free(item->buffer);
-        free(item);
+        outbox_item_free(outbox, item);
     }
     return ESP_OK;
 }
@@ -227,15 +386,15 @@ esp_err_t outbox_cleanup(outbox_handle_t outbox, int max_size)
 void outbox_delete_all_items(outbox_handle_t outbox)
 {
     outbox_item_handle_t item, tmp;
-    STAILQ_FOREACH_SAFE(item, outbox, next, tmp) {
-        STAILQ_REMOVE(outbox, item, outbox_item, next);
-        free(item->buffer);
-        free(item);
+    TAILQ_FOREACH_SAFE(item, &outbox->items, next, tmp) {
+        outbox_item_free(outbox, item);
     }
 }
+
 void outbox_destroy(outbox_handle_t outbox)
 {
     outbox_delete_all_items(outbox);
+    free(outbox->storage);
     free(outbox);
 }
 
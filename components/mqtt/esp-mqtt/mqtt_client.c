@@ -1124,7 +1124,9 @@ static bool mqtt_enqueue_oversized(esp_mqtt_client_handle_t client, uint8_t *rem
     msg.remaining_data = remaining_data;
     msg.remaining_len = remaining_len;
     //Copy to queue buffer
-    outbox_enqueue(client->outbox, &msg, platform_tick_get_ms());
+    if (outbox_enqueue(client->outbox, &msg, platform_tick_get_ms()) == NULL) {
+        return false;
+    }
 
     //unlock
     return true;
@@ -1147,7 +1149,9 @@ static bool mqtt_enqueue(esp_mqtt_client_handle_t client)
         msg.msg_type = client->mqtt_state.pending_msg_type;
         msg.msg_qos = client->mqtt_state.pending_publish_qos;
         //Copy to queue buffer
-        outbox_enqueue(client->outbox, &msg, platform_tick_get_ms());
+        if (outbox_enqueue(client->outbox, &msg, platform_tick_get_ms()) == NULL) {
+            return false;
+        }
     }
     //unlock
     return true;
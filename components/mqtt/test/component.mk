@@ -2,3 +2,4 @@
 #Component Makefile
 #
 COMPONENT_ADD_LDFLAGS = -Wl,--whole-archive -l$(COMPONENT_NAME) -Wl,--no-whole-archive
+COMPONENT_PRIV_INCLUDEDIRS := ../esp-mqtt/lib/include
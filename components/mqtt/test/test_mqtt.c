@@ -59,12 +59,15 @@ TEST_CASE("mqtt enqueue and destroy outbox", "[mqtt][leaks=0]")
     esp_mqtt_client_handle_t client = esp_mqtt_client_init(&mqtt_cfg);
     TEST_ASSERT_NOT_EQUAL(NULL, client );
     int bytes_before = esp_get_free_heap_size();
-    for (int i=0; i<messages; ++i) {
+    esp_mqtt_client_publish(client, "test", bin_addr, size, 1, 0);
+    int bytes_after_first = esp_get_free_heap_size();
+    for (int i=1; i<messages; ++i) {
         esp_mqtt_client_publish(client, "test", bin_addr, size, 1, 0);
     }
     int bytes_after = esp_get_free_heap_size();
-    // check that outbox allocated all messages on heap
-    TEST_ASSERT_GREATER_OR_EQUAL(messages*size, bytes_before - bytes_after);
+    // check that outbox allocated its storage once and it does not grow with the number of messages
+    TEST_ASSERT_GREATER_OR_EQUAL(size, bytes_before - bytes_after_first);
+    TEST_ASSERT_EQUAL(bytes_after_first, bytes_after);
 
     esp_mqtt_client_destroy(client);
 }
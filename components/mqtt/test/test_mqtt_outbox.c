@@ -0,0 +1,166 @@
+#include "mqtt_outbox.h"
+#include "mqtt_config.h"
+#include "unity.h"
+#include <string.h>
+
+static uint8_t g_msg_data[OUTBOX_MAX_SIZE];
+
+static outbox_item_handle_t enqueue_msg(outbox_handle_t outbox, int msg_id, int msg_type, int len, outbox_tick_t tick)
+{
+    memset(g_msg_data, msg_id & 0xFF, len);
+    outbox_message_t msg = {
+        .data = g_msg_data,
+        .len = len,
+        .msg_id = msg_id,
+        .msg_qos = 1,
+        .msg_type = msg_type,
+    };
+    return outbox_enqueue(outbox, &msg, tick);
+}
+
+static void check_msg_data(outbox_handle_t outbox, int msg_id, int len)
+{
+    size_t data_len = 0;
+    uint16_t item_msg_id = 0;
+    int msg_type = 0;
+    int qos = 0;
+    const uint8_t *p_data = outbox_item_get_data(outbox_get(outbox, msg_id), &data_len, &item_msg_id, &msg_type, &qos);
+    TEST_ASSERT_NOT_EQUAL(NULL, p_data);
+    TEST_ASSERT_EQUAL(len, data_len);
+    TEST_ASSERT_EQUAL(msg_id, item_msg_id);
+    for (int i = 0; i < len; ++i) {
+        TEST_ASSERT_EQUAL(msg_id & 0xFF, p_data[i]);
+    }
+}
+
+TEST_CASE("mqtt outbox reuses the ring buffer", "[mqtt][outbox][leaks=0]")
+{
+    const int len = OUTBOX_MAX_SIZE / 4;
+    outbox_handle_t outbox = outbox_init();
+    TEST_ASSERT_NOT_EQUAL(NULL, outbox);
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, i + 1, 3, len, i));
+    }
+    TEST_ASSERT_EQUAL(4 * len, outbox_get_size(outbox));
+    TEST_ASSERT_EQUAL(NULL, enqueue_msg(outbox, 5, 3, 1, 4));
+
+    // The space of the oldest items is reclaimed and the ring buffer wraps
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete(outbox, 1, 3));
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete(outbox, 2, 3));
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, 5, 3, 2 * len, 4));
+
+    check_msg_data(outbox, 3, len);
+    check_msg_data(outbox, 4, len);
+    check_msg_data(outbox, 5, 2 * len);
+    TEST_ASSERT_EQUAL(OUTBOX_MAX_SIZE, outbox_get_size(outbox));
+
+    outbox_destroy(outbox);
+}
+
+TEST_CASE("mqtt outbox reuses the space of the items acknowledged out of order", "[mqtt][outbox][leaks=0]")
+{
+    const int len = OUTBOX_MAX_SIZE / 8;
+    outbox_handle_t outbox = outbox_init();
+    for (int i = 0; i < 8; ++i) {
+        TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, i + 1, 3, len, i));
+    }
+    // QoS1 acks arrive out of order: every second message is acknowledged, while the oldest one is still pending
+    for (int i = 2; i <= 8; i += 2) {
+        TEST_ASSERT_EQUAL(ESP_OK, outbox_delete(outbox, i, 3));
+    }
+    TEST_ASSERT_EQUAL(4 * len, outbox_get_size(outbox));
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, 9, 3, 4 * len, 8));
+    TEST_ASSERT_EQUAL(NULL, enqueue_msg(outbox, 10, 3, 1, 9));
+
+    for (int i = 1; i <= 7; i += 2) {
+        check_msg_data(outbox, i, len);
+    }
+    check_msg_data(outbox, 9, 4 * len);
+
+    // The items keep the order of enqueueing after the ring buffer is compacted
+    outbox_tick_t tick = -1;
+    TEST_ASSERT_EQUAL(outbox_get(outbox, 1), outbox_dequeue(outbox, QUEUED, &tick));
+    TEST_ASSERT_EQUAL(0, tick);
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete(outbox, 1, 3));
+    TEST_ASSERT_EQUAL(outbox_get(outbox, 3), outbox_dequeue(outbox, QUEUED, &tick));
+    TEST_ASSERT_EQUAL(2, tick);
+    outbox_destroy(outbox);
+}
+
+TEST_CASE("mqtt outbox compacts the wrapped ring buffer", "[mqtt][outbox][leaks=0]")
+{
+    const int len = OUTBOX_MAX_SIZE / 4;
+    outbox_handle_t outbox = outbox_init();
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, i + 1, 3, len, i));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete(outbox, 1, 3));
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, 5, 3, len, 4)); // The ring buffer is wrapped
+    TEST_ASSERT_EQUAL(NULL, enqueue_msg(outbox, 6, 3, 1, 5));
+
+    // The hole in the middle of the items before the wrap is merged with the free space
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete(outbox, 3, 3));
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, 6, 3, len, 5));
+    TEST_ASSERT_EQUAL(NULL, enqueue_msg(outbox, 7, 3, 1, 6));
+    check_msg_data(outbox, 2, len);
+    check_msg_data(outbox, 4, len);
+    check_msg_data(outbox, 5, len);
+    check_msg_data(outbox, 6, len);
+    TEST_ASSERT_EQUAL(OUTBOX_MAX_SIZE, outbox_get_size(outbox));
+
+    // A hole which is smaller than a new item is not enough
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete(outbox, 5, 3));
+    TEST_ASSERT_EQUAL(NULL, enqueue_msg(outbox, 7, 3, len + 1, 6));
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, 7, 3, len, 6));
+    check_msg_data(outbox, 2, len);
+    check_msg_data(outbox, 4, len);
+    check_msg_data(outbox, 6, len);
+    check_msg_data(outbox, 7, len);
+    outbox_destroy(outbox);
+}
+
+TEST_CASE("mqtt outbox limits the number of items", "[mqtt][outbox][leaks=0]")
+{
+    outbox_handle_t outbox = outbox_init();
+    for (int i = 0; i < OUTBOX_MAX_ITEMS; ++i) {
+        TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, i + 1, 3, 1, i));
+    }
+    TEST_ASSERT_EQUAL(NULL, enqueue_msg(outbox, OUTBOX_MAX_ITEMS + 1, 3, 1, 0));
+
+    outbox_item_handle_t item = outbox_get(outbox, 1);
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete_item(outbox, item));
+    TEST_ASSERT_EQUAL(ESP_FAIL, outbox_delete_item(outbox, item));
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, OUTBOX_MAX_ITEMS + 1, 3, 1, 0));
+
+    TEST_ASSERT_EQUAL(OUTBOX_MAX_ITEMS / 2, outbox_delete_expired(outbox, OUTBOX_MAX_ITEMS / 2, 0));
+    TEST_ASSERT_EQUAL(OUTBOX_MAX_ITEMS / 2, outbox_get_size(outbox));
+    outbox_destroy(outbox);
+}
+
+TEST_CASE("mqtt outbox lookup by msg_id", "[mqtt][outbox][leaks=0]")
+{
+    outbox_handle_t outbox = outbox_init();
+    // PUBLISH and PUBREL with the same msg_id and an item which falls into the same bucket of the index
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, 7, 3, 10, 0));
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, 7, 6, 10, 0));
+    TEST_ASSERT_NOT_EQUAL(NULL, enqueue_msg(outbox, 7 + 2 * OUTBOX_MAX_ITEMS, 3, 10, 0));
+
+    TEST_ASSERT_EQUAL(ESP_FAIL, outbox_set_pending(outbox, 8, TRANSMITTED));
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_set_pending(outbox, 7 + 2 * OUTBOX_MAX_ITEMS, TRANSMITTED));
+    outbox_tick_t tick = -1;
+    TEST_ASSERT_EQUAL(outbox_get(outbox, 7 + 2 * OUTBOX_MAX_ITEMS), outbox_dequeue(outbox, TRANSMITTED, &tick));
+    TEST_ASSERT_EQUAL(0, tick);
+    TEST_ASSERT_EQUAL(NULL, outbox_dequeue(outbox, ACKNOWLEDGED, NULL));
+
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete(outbox, 7, 6));
+    TEST_ASSERT_NOT_EQUAL(NULL, outbox_get(outbox, 7));
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_delete_msgid(outbox, 7));
+    TEST_ASSERT_EQUAL(NULL, outbox_get(outbox, 7));
+    TEST_ASSERT_NOT_EQUAL(NULL, outbox_get(outbox, 7 + 2 * OUTBOX_MAX_ITEMS));
+
+    TEST_ASSERT_EQUAL(ESP_FAIL, outbox_cleanup(outbox, 0));
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_set_pending(outbox, 7 + 2 * OUTBOX_MAX_ITEMS, CONFIRMED));
+    TEST_ASSERT_EQUAL(ESP_OK, outbox_cleanup(outbox, 0));
+    TEST_ASSERT_EQUAL(0, outbox_get_size(outbox));
+    outbox_destroy(outbox);
+}
@@ -13,19 +13,162 @@
 // limitations under the License.
 
 #include "nvs_item_hash_list.hpp"
+#include <algorithm>
 
 namespace nvs
 {
 
+ItemIndex::ItemIndex()
+{
+}
+
+ItemIndex::~ItemIndex()
+{
+    delete[] mNodes;
+}
+
+void ItemIndex::clear()
+{
+    delete[] mNodes;
+    mNodes = nullptr;
+    mCapacity = 0;
+    mCount = 0;
+}
+
+esp_err_t ItemIndex::grow()
+{
+    const size_t newCapacity = mCapacity ? mCapacity * 2 : INITIAL_CAPACITY;
+    Node* newNodes = new (std::nothrow) Node[newCapacity];
+    if (!newNodes) return ESP_ERR_NO_MEM;
+
+    std::fill_n(newNodes, newCapacity, Node{nullptr, 0, 0});
+    Node* oldNodes = mNodes;
+    const size_t oldCapacity = mCapacity;
+    mNodes = newNodes;
+    mCapacity = newCapacity;
+    for (size_t i = 0; i < oldCapacity; ++i) {
+        if (oldNodes[i].mPage) {
+            size_t pos = slot(oldNodes[i].mHash);
+            while (mNodes[pos].mPage) {
+                pos = (pos + 1) & (mCapacity - 1);
+            }
+            mNodes[pos] = oldNodes[i];
+        }
+    }
+    delete[] oldNodes;
+    return ESP_OK;
+}
+
+esp_err_t ItemIndex::insert(uint32_t hash, const Page* page, size_t index)
+{
+    // keep the load factor below 3/4, so that the probe sequences stay short
+    if ((mCount + 1) * 4 > mCapacity * 3) {
+        auto err = grow();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    size_t pos = slot(hash);
+    while (mNodes[pos].mPage) {
+        pos = (pos + 1) & (mCapacity - 1);
+    }
+    mNodes[pos].mPage = page;
+    mNodes[pos].mHash = hash;
+    mNodes[pos].mIndex = static_cast<uint32_t>(index);
+    ++mCount;
+    return ESP_OK;
+}
+
+void ItemIndex::erase(uint32_t hash, const Page* page, size_t index)
+{
+    if (!mCount) return;
+
+    size_t pos = slot(hash);
+    while (mNodes[pos].mPage) {
+        if (mNodes[pos].mPage == page && mNodes[pos].mHash == hash && mNodes[pos].mIndex == index) {
+            break;
+        }
+        pos = (pos + 1) & (mCapacity - 1);
+    }
+    if (!mNodes[pos].mPage) {
+        return;
+    }
+
+    // backward shift deletion: move up the nodes which would become unreachable because of the new hole
+    size_t hole = pos;
+    size_t next = (hole + 1) & (mCapacity - 1);
+    while (mNodes[next].mPage) {
+        const size_t home = slot(mNodes[next].mHash);
+        if (((next - home) & (mCapacity - 1)) >= ((next - hole) & (mCapacity - 1))) {
+            mNodes[hole] = mNodes[next];
+            hole = next;
+        }
+        next = (next + 1) & (mCapacity - 1);
+    }
+    mNodes[hole] = Node{nullptr, 0, 0};
+    --mCount;
+}
+
+bool ItemIndex::contains(uint32_t hash) const
+{
+    if (!mCount) return false;
+
+    for (size_t pos = slot(hash); mNodes[pos].mPage; pos = (pos + 1) & (mCapacity - 1)) {
+        if (mNodes[pos].mHash == hash) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ItemIndex::find(uint32_t hash, const Page* page) const
+{
+    size_t result = SIZE_MAX;
+    if (!mCount) return result;
+
+    for (size_t pos = slot(hash); mNodes[pos].mPage; pos = (pos + 1) & (mCapacity - 1)) {
+        if (mNodes[pos].mPage == page && mNodes[pos].mHash == hash && mNodes[pos].mIndex < result) {
+            result = mNodes[pos].mIndex;
+        }
+    }
+    return result;
+}
+
 HashList::HashList()
 {
 }
 
+esp_err_t HashList::attachItemIndex(ItemIndex* itemIndex, const Page* page)
+{
+    mItemIndex = itemIndex;
+    mPage = page;
+    if (!mItemIndex) return ESP_OK;
+
+    for (auto it = mBlockList.begin(); it != mBlockList.end(); ++it) {
+        for (size_t i = 0; i < it->mCount; ++i) {
+            if (it->mNodes[i].mIndex != 0xff) {
+                auto err = mItemIndex->insert(it->mNodes[i].mHash, mPage, it->mNodes[i].mIndex);
+                if (err != ESP_OK) {
+                    return err;
+                }
+            }
+        }
+    }
+    return ESP_OK;
+}
+
 void HashList::clear()
 {
     for (auto it = mBlockList.begin(); it != mBlockList.end();) {
         auto tmp = it;
         ++it;
+        if (mItemIndex) {
+            for (size_t i = 0; i < tmp->mCount; ++i) {
+                if (tmp->mNodes[i].mIndex != 0xff) {
+                    mItemIndex->erase(tmp->mNodes[i].mHash, mPage, tmp->mNodes[i].mIndex);
+                }
+            }
+        }
         mBlockList.erase(tmp);
         delete static_cast<HashListBlock*>(tmp);
     }
@@ -44,7 +187,13 @@ HashList::HashListBlock::HashListBlock()
 
 esp_err_t HashList::insert(const Item& item, size_t index)
 {
-    const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
+    const uint32_t hash_24 = ItemIndex::hash(item);
+    if (mItemIndex) {
+        auto err = mItemIndex->insert(hash_24, mPage, index);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
     // add entry to the end of last block if possible
     if (mBlockList.size()) {
         auto& block = mBlockList.back();
@@ -56,7 +205,12 @@ esp_err_t HashList::insert(const Item& item, size_t index)
     // if the above failed, create a new block and add entry to it
     HashListBlock* newBlock = new (std::nothrow) HashListBlock;
 
-    if (!newBlock) return ESP_ERR_NO_MEM;
+    if (!newBlock) {
+        if (mItemIndex) {
+            mItemIndex->erase(hash_24, mPage, index);
+        }
+        return ESP_ERR_NO_MEM;
+    }
 
     mBlockList.push_back(newBlock);
     newBlock->mNodes[0] = HashListNode(hash_24, index);
@@ -72,6 +226,9 @@ void HashList::erase(size_t index, bool itemShouldExist)
         bool foundIndex = false;
         for (size_t i = 0; i < it->mCount; ++i) {
             if (it->mNodes[i].mIndex == index) {
+                if (mItemIndex) {
+                    mItemIndex->erase(it->mNodes[i].mHash, mPage, index);
+                }
                 it->mNodes[i].mIndex = 0xff;
                 foundIndex = true;
                 /* found the item and removed it */
@@ -105,7 +262,7 @@ void HashList::erase(size_t index, bool itemShouldExist)
 
 size_t HashList::find(size_t start, const Item& item)
 {
-    const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
+    const uint32_t hash_24 = ItemIndex::hash(item);
     for (auto it = mBlockList.begin(); it != mBlockList.end(); ++it) {
         for (size_t index = 0; index < it->mCount; ++index) {
             HashListNode& e = it->mNodes[index];
@@ -15,12 +15,68 @@
 namespace nvs
 {
 
+class Page;
+
+/**
+ * Storage-wide index of the items of all pages: <24-bit hash of ns/key/chunkIndex, page> -> entry index.
+ * It mirrors the HashLists of the pages attached to it, so Storage can locate the page holding an item
+ * with a single probe instead of walking the HashList of every page.
+ * Open addressing with linear probing, the same hash may be stored for several entries (collisions, chunks).
+ */
+class ItemIndex
+{
+public:
+    ItemIndex();
+    ~ItemIndex();
+
+    static uint32_t hash(const Item& item)
+    {
+        return item.calculateCrc32WithoutValue() & 0xffffff;
+    }
+
+    esp_err_t insert(uint32_t hash, const Page* page, size_t index);
+    void erase(uint32_t hash, const Page* page, size_t index);
+    bool contains(uint32_t hash) const;
+    /* Returns the lowest entry index with the given hash on the page or SIZE_MAX */
+    size_t find(uint32_t hash, const Page* page) const;
+    void clear();
+
+    size_t size() const
+    {
+        return mCount;
+    }
+
+private:
+    ItemIndex(const ItemIndex& other);
+    const ItemIndex& operator= (const ItemIndex& rhs);
+
+    struct Node {
+        const Page* mPage;
+        uint32_t mHash  : 24;
+        uint32_t mIndex : 8;
+    };
+
+    static const size_t INITIAL_CAPACITY = 32;
+
+    size_t slot(uint32_t hash) const
+    {
+        return hash & (mCapacity - 1);
+    }
+
+    esp_err_t grow();
+
+    Node* mNodes = nullptr;
+    size_t mCapacity = 0;
+    size_t mCount = 0;
+}; // class ItemIndex
+
 class HashList
 {
 public:
     HashList();
     ~HashList();
 
+    esp_err_t attachItemIndex(ItemIndex* itemIndex, const Page* page);
     esp_err_t insert(const Item& item, size_t index);
     void erase(const size_t index, bool itemShouldExist=true);
     size_t find(size_t start, const Item& item);
@@ -59,6 +115,8 @@ protected:
 
     typedef intrusive_list<HashListBlock> TBlockList;
     TBlockList mBlockList;
+    ItemIndex* mItemIndex = nullptr;
+    const Page* mPage = nullptr;
 }; // class HashList
 
 } // namespace nvs
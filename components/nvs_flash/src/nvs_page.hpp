@@ -155,6 +155,11 @@ public:
 
     esp_err_t calcEntries(nvs_stats_t &nvsStats);
 
+    esp_err_t attachItemIndex(ItemIndex* itemIndex)
+    {
+        return mHashList.attachItemIndex(itemIndex, this);
+    }
+
 protected:
 
     class Header
@@ -15,7 +15,7 @@
 
 namespace nvs
 {
-esp_err_t PageManager::load(uint32_t baseSector, uint32_t sectorCount)
+esp_err_t PageManager::load(uint32_t baseSector, uint32_t sectorCount, ItemIndex* pItemIndex)
 {
     mBaseSector = baseSector;
     mPageCount = sectorCount;
@@ -26,7 +26,12 @@ esp_err_t PageManager::load(uint32_t baseSector, uint32_t sectorCount)
     if (!mPages) return ESP_ERR_NO_MEM;
 
     for (uint32_t i = 0; i < sectorCount; ++i) {
-        auto err = mPages[i].load(baseSector + i);
+        // attach the index before loading, so that it is filled while the entry tables are read
+        auto err = mPages[i].attachItemIndex(pItemIndex);
+        if (err != ESP_OK) {
+            return err;
+        }
+        err = mPages[i].load(baseSector + i);
         if (err != ESP_OK) {
             return err;
         }
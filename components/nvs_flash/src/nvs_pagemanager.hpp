@@ -31,7 +31,7 @@ public:
 
     PageManager() {}
 
-    esp_err_t load(uint32_t baseSector, uint32_t sectorCount);
+    esp_err_t load(uint32_t baseSector, uint32_t sectorCount, ItemIndex* pItemIndex = nullptr);
 
     TPageListIterator begin()
     {
@@ -83,7 +83,7 @@ void Storage::eraseOrphanDataBlobs(TBlobIndexList& blobIdxList)
 
 esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
 {
-    auto err = mPageManager.load(baseSector, sectorCount);
+    auto err = mPageManager.load(baseSector, sectorCount, &mItemIndex);
     if (err != ESP_OK) {
         mState = StorageState::INVALID;
         return err;
@@ -142,8 +142,24 @@ bool Storage::isValid() const
 
 esp_err_t Storage::findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart)
 {
+    // Page::findItem uses its HashList for such requests, so the pages which are not in the index can be skipped
+    const bool useIndex = (nsIndex != Page::NS_ANY && datatype != ItemType::ANY && key != nullptr);
+    uint32_t hash = 0;
+    if (useIndex) {
+        hash = ItemIndex::hash(Item(nsIndex, datatype, 0, key, chunkIdx));
+        if (!mItemIndex.contains(hash)) {
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+    }
+
     for (auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
         size_t itemIndex = 0;
+        if (useIndex) {
+            itemIndex = mItemIndex.find(hash, it);
+            if (itemIndex == SIZE_MAX) {
+                continue;
+            }
+        }
         auto err = it->findItem(nsIndex, datatype, key, itemIndex, item, chunkIdx, chunkStart);
         if (err == ESP_OK) {
             page = it;
@@ -755,6 +771,7 @@ void Storage::debugCheck()
                 assert(0);
             }
             keys.insert(std::make_pair(keystr, static_cast<Page*>(p)));
+            assert(mItemIndex.find(ItemIndex::hash(item), p) <= itemIndex);
             itemIndex += item.span;
             usedCount += item.span;
         }
@@ -146,6 +146,7 @@ protected:
 protected:
     char mPartitionName [NVS_PART_NAME_MAX_SIZE + 1];
     size_t mPageCount;
+    ItemIndex mItemIndex; // must outlive the pages of mPageManager
     PageManager mPageManager;
     TNamespaces mNamespaces;
     CompressedEnumTable<bool, 1, 256> mNamespaceUsage;
@@ -29,6 +29,7 @@
 #include <string>
 #include <cstdlib>
 #include <cstdio>
+#include <chrono>
 
 #define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
 #define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
@@ -3885,6 +3886,102 @@ TEST_CASE("check and read data from partition generated via manufacturing utilit
 }
 #endif
 
+class StorageLookupBenchmark : public Storage
+{
+public:
+    esp_err_t findItemByIndex(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page)
+    {
+        Item item;
+        return findItem(nsIndex, datatype, key, page, item);
+    }
+
+    // lookup without the item index: every page is asked in turn, as it was done before the index was added
+    esp_err_t findItemByScan(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page)
+    {
+        Item item;
+        for (auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
+            size_t itemIndex = 0;
+            auto err = it->findItem(nsIndex, datatype, key, itemIndex, item);
+            if (err == ESP_OK) {
+                page = it;
+                return ESP_OK;
+            }
+        }
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+};
+
+TEST_CASE("benchmark mount and lookup of 600 keys with item index", "[nvs]")
+{
+    const size_t sectors = 12;
+    const size_t keyCount = 600;
+    const size_t rounds = 10;
+    SpiFlashEmulator emu(sectors);
+    {
+        Storage storage;
+        REQUIRE(storage.init(0, sectors) == ESP_OK);
+        for (size_t i = 0; i < keyCount; ++i) {
+            char name[Item::MAX_KEY_LENGTH + 1];
+            snprintf(name, sizeof(name), "key%05d", static_cast<int>(i));
+            REQUIRE(storage.writeItem(1, name, static_cast<uint32_t>(i)) == ESP_OK);
+        }
+    }
+
+    std::chrono::microseconds mountTime[2] = {};
+    for (int withIndex = 0; withIndex < 2; ++withIndex) {
+        ItemIndex itemIndex;
+        PageManager pm;
+        emu.clearStats();
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(pm.load(0, sectors, withIndex ? &itemIndex : nullptr) == ESP_OK);
+        mountTime[withIndex] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        CHECK(itemIndex.size() == (withIndex ? keyCount : 0));
+    }
+    s_perf << "Mount with " << keyCount << " keys: " << emu.getTotalTime() << " us flash (" << emu.getReadOps() << "R), "
+           << mountTime[1].count() << " us CPU with item index, " << mountTime[0].count() << " us CPU without" << std::endl;
+
+    StorageLookupBenchmark storage;
+    REQUIRE(storage.init(0, sectors) == ESP_OK);
+
+    auto find = [&storage](bool byScan, const char* key, Page* &page) -> esp_err_t {
+        return byScan ? storage.findItemByScan(1, ItemType::U32, key, page)
+                      : storage.findItemByIndex(1, ItemType::U32, key, page);
+    };
+    size_t readOps[2] = {};
+    std::chrono::microseconds lookupTime[2] = {};
+    for (int byScan = 0; byScan < 2; ++byScan) {
+        emu.clearStats();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t i = 0; i < keyCount; ++i) {
+                char name[Item::MAX_KEY_LENGTH + 1];
+                Page* page = nullptr;
+                snprintf(name, sizeof(name), "key%05d", static_cast<int>(i));
+                REQUIRE(find(byScan, name, page) == ESP_OK);
+                snprintf(name, sizeof(name), "missing%05d", static_cast<int>(i));
+                REQUIRE(find(byScan, name, page) == ESP_ERR_NVS_NOT_FOUND);
+            }
+        }
+        lookupTime[byScan] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        readOps[byScan] = emu.getReadOps();
+    }
+    s_perf << "Lookup of " << keyCount << " existing and " << keyCount << " missing keys " << rounds << " times: "
+           << lookupTime[0].count() << " us CPU (" << readOps[0] << "R) with item index, "
+           << lookupTime[1].count() << " us CPU (" << readOps[1] << "R) by scanning pages" << std::endl;
+    CHECK(readOps[0] <= readOps[1]);
+
+    // both lookups must find the same page
+    for (size_t i = 0; i < keyCount; ++i) {
+        char name[Item::MAX_KEY_LENGTH + 1];
+        snprintf(name, sizeof(name), "key%05d", static_cast<int>(i));
+        Page* pageByIndex = nullptr;
+        Page* pageByScan = nullptr;
+        REQUIRE(find(false, name, pageByIndex) == ESP_OK);
+        REQUIRE(find(true, name, pageByScan) == ESP_OK);
+        CHECK(pageByIndex == pageByScan);
+    }
+}
+
 /* Add new tests above */
 /* This test has to be the final one */
 
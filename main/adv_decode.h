@@ -8,6 +8,8 @@
 #ifndef RUUVI_GATEWAY_ESP_ADV_DECODE_H
 #define RUUVI_GATEWAY_ESP_ADV_DECODE_H
 
+#include <math.h>
+#include <stdbool.h>
 #include "json_stream_gen.h"
 #include "adv_table.h"
 
@@ -15,15 +17,44 @@
 extern "C" {
 #endif
 
+/**
+ * @brief The key which marks the decoded object as a delta (only the changed fields are present).
+ */
+#define ADV_DECODE_JSON_KEY_DELTA "delta"
+
+/**
+ * @brief Check if the field of the decoded data should be emitted.
+ * @param p_data_prev - ptr to the previously published decoded data or NULL to emit all fields (keyframe)
+ * @param data - the current decoded data
+ * @param field - the name of the field
+ */
+#define ADV_DECODE_IS_CHANGED(p_data_prev, data, field) \
+    ((NULL == (p_data_prev)) || adv_decode_is_value_changed((double)(p_data_prev)->field, (double)(data).field))
+
+/**
+ * @brief Compare the values of the decoded fields, the invalid values (NAN) are considered equal.
+ */
+static inline bool
+adv_decode_is_value_changed(const double val_prev, const double val)
+{
+    if (isnan(val_prev) || isnan(val))
+    {
+        return isnan(val_prev) != isnan(val);
+    }
+    return val_prev != val;
+}
+
 JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
     adv_decode_df5_cb_json_stream_gen,
     json_stream_gen_t* const  p_gen,
-    const adv_report_t* const p_adv);
+    const adv_report_t* const p_adv,
+    const adv_report_t* const p_adv_prev);
 
 JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
     adv_decode_df6_cb_json_stream_gen,
     json_stream_gen_t* const  p_gen,
-    const adv_report_t* const p_adv);
+    const adv_report_t* const p_adv,
+    const adv_report_t* const p_adv_prev);
 
 JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
     adv_decode_dfxf0_cb_json_stream_gen,
@@ -38,7 +69,8 @@ JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
 JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
     adv_decode_dfxe1_cb_json_stream_gen,
     json_stream_gen_t* const  p_gen,
-    const adv_report_t* const p_adv);
+    const adv_report_t* const p_adv,
+    const adv_report_t* const p_adv_prev);
 
 #ifdef __cplusplus
 }
@@ -12,58 +12,97 @@
 JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
     adv_decode_df5_cb_json_stream_gen,
     json_stream_gen_t* const  p_gen,
-    const adv_report_t* const p_adv)
+    const adv_report_t* const p_adv,
+    const adv_report_t* const p_adv_prev)
 {
     re_5_data_t       data          = { 0 };
     const re_status_t decode_status = re_5_decode(p_adv->data_buf, &data);
     if (RE_SUCCESS == decode_status)
     {
+        re_5_data_t        data_prev   = { 0 };
+        const re_5_data_t* p_data_prev = NULL;
+        if ((NULL != p_adv_prev) && re_5_check_format(p_adv_prev->data_buf)
+            && (RE_SUCCESS == re_5_decode(p_adv_prev->data_buf, &data_prev)))
+        {
+            p_data_prev = &data_prev;
+        }
         JSON_STREAM_GEN_ADD_INT32(p_gen, "dataFormat", RE_5_DESTINATION);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "temperature",
-            data.temperature_c,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "humidity",
-            data.humidity_rh,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_4);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "pressure",
-            data.pressure_pa,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "accelX",
-            data.accelerationx_g,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "accelY",
-            data.accelerationy_g,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "accelZ",
-            data.accelerationz_g,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "movementCounter",
-            data.movement_count,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "voltage",
-            data.battery_v,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "txPower",
-            data.tx_power,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        if (NULL != p_data_prev)
+        {
+            JSON_STREAM_GEN_ADD_BOOL(p_gen, ADV_DECODE_JSON_KEY_DELTA, true);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, temperature_c))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "temperature",
+                data.temperature_c,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, humidity_rh))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "humidity",
+                data.humidity_rh,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_4);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, pressure_pa))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "pressure",
+                data.pressure_pa,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, accelerationx_g))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "accelX",
+                data.accelerationx_g,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, accelerationy_g))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "accelY",
+                data.accelerationy_g,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, accelerationz_g))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "accelZ",
+                data.accelerationz_g,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, movement_count))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "movementCounter",
+                data.movement_count,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, battery_v))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "voltage",
+                data.battery_v,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, tx_power))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "txPower",
+                data.tx_power,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        }
         JSON_STREAM_GEN_ADD_INT32(p_gen, "measurementSequenceNumber", data.measurement_count);
         mac_address_bin_t tag_mac = { 0 };
         for (uint32_t mac_idx = 0; mac_idx < MAC_ADDRESS_NUM_BYTES; ++mac_idx)
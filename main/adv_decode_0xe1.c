@@ -12,75 +12,138 @@
 JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
     adv_decode_dfxe1_cb_json_stream_gen,
     json_stream_gen_t* const  p_gen,
-    const adv_report_t* const p_adv)
+    const adv_report_t* const p_adv,
+    const adv_report_t* const p_adv_prev)
 {
     re_e1_data_t      data          = { 0 };
     const re_status_t decode_status = re_e1_decode(p_adv->data_buf, &data);
     if (RE_SUCCESS == decode_status)
     {
+        re_e1_data_t        data_prev   = { 0 };
+        const re_e1_data_t* p_data_prev = NULL;
+        if ((NULL != p_adv_prev) && re_e1_check_format(p_adv_prev->data_buf)
+            && (RE_SUCCESS == re_e1_decode(p_adv_prev->data_buf, &data_prev)))
+        {
+            p_data_prev = &data_prev;
+        }
         JSON_STREAM_GEN_ADD_INT32(p_gen, "dataFormat", RE_E1_DESTINATION);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "temperature",
-            data.temperature_c,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "humidity",
-            data.humidity_rh,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_2);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "pressure",
-            data.pressure_pa,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "PM1.0",
-            data.pm1p0_ppm,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "PM2.5",
-            data.pm2p5_ppm,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "PM4.0",
-            data.pm4p0_ppm,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "PM10.0",
-            data.pm10p0_ppm,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(p_gen, "CO2", data.co2, JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(p_gen, "VOC", data.voc, JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(p_gen, "NOx", data.nox, JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "luminosity",
-            data.luminosity,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "sound_inst_dba",
-            data.sound_inst_dba,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "sound_avg_dba",
-            data.sound_avg_dba,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
-        JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
-            p_gen,
-            "sound_peak_spl_db",
-            data.sound_peak_spl_db,
-            JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
+        if (NULL != p_data_prev)
+        {
+            JSON_STREAM_GEN_ADD_BOOL(p_gen, ADV_DECODE_JSON_KEY_DELTA, true);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, temperature_c))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "temperature",
+                data.temperature_c,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_3);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, humidity_rh))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "humidity",
+                data.humidity_rh,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_2);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, pressure_pa))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "pressure",
+                data.pressure_pa,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, pm1p0_ppm))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "PM1.0",
+                data.pm1p0_ppm,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, pm2p5_ppm))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "PM2.5",
+                data.pm2p5_ppm,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, pm4p0_ppm))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "PM4.0",
+                data.pm4p0_ppm,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, pm10p0_ppm))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "PM10.0",
+                data.pm10p0_ppm,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, co2))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(p_gen, "CO2", data.co2, JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, voc))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(p_gen, "VOC", data.voc, JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, nox))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(p_gen, "NOx", data.nox, JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, luminosity))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "luminosity",
+                data.luminosity,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_0);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, sound_inst_dba))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "sound_inst_dba",
+                data.sound_inst_dba,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, sound_avg_dba))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "sound_avg_dba",
+                data.sound_avg_dba,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, sound_peak_spl_db))
+        {
+            JSON_STREAM_GEN_ADD_FLOAT_LIMITED_FIXED_POINT(
+                p_gen,
+                "sound_peak_spl_db",
+                data.sound_peak_spl_db,
+                JSON_STREAM_GEN_NUM_DECIMALS_FLOAT_1);
+        }
         JSON_STREAM_GEN_ADD_UINT32(p_gen, "measurementSequenceNumber", data.seq_cnt);
-        JSON_STREAM_GEN_ADD_BOOL(p_gen, "flag_calibration_in_progress", data.flags.flag_calibration_in_progress);
-        JSON_STREAM_GEN_ADD_BOOL(p_gen, "flag_button_pressed", data.flags.flag_button_pressed);
-        JSON_STREAM_GEN_ADD_BOOL(p_gen, "flag_rtc_running_on_boot", data.flags.flag_rtc_running_on_boot);
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, flags.flag_calibration_in_progress))
+        {
+            JSON_STREAM_GEN_ADD_BOOL(p_gen, "flag_calibration_in_progress", data.flags.flag_calibration_in_progress);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, flags.flag_button_pressed))
+        {
+            JSON_STREAM_GEN_ADD_BOOL(p_gen, "flag_button_pressed", data.flags.flag_button_pressed);
+        }
+        if (ADV_DECODE_IS_CHANGED(p_data_prev, data, flags.flag_rtc_running_on_boot))
+        {
+            JSON_STREAM_GEN_ADD_BOOL(p_gen, "flag_rtc_running_on_boot", data.flags.flag_rtc_running_on_boot);
+        }
         mac_address_bin_t tag_mac = { 0 };
         for (uint32_t mac_idx = 0; mac_idx < MAC_ADDRESS_NUM_BYTES; ++mac_idx)
         {
@@ -0,0 +1,191 @@
+/**
+ * @file adv_delta.c
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "adv_delta.h"
+#include <string.h>
+#include "os_malloc.h"
+
+#define ADV_DELTA_NUM_BITS_PER_BYTE (8U)
+
+typedef uint64_t adv_delta_mac_t;
+
+typedef struct adv_delta_entry_t
+{
+    adv_delta_mac_t mac;
+    uint32_t        last_commit_seq;
+    uint32_t        cnt_since_keyframe;
+    adv_report_t    adv;
+} adv_delta_entry_t;
+
+struct adv_delta_t
+{
+    num_of_advs_t     capacity;
+    num_of_advs_t     num_of_tags;
+    uint32_t          keyframe_interval;
+    uint32_t          commit_seq;
+    adv_delta_entry_t arr_of_entries[]; //<! Sorted by MAC address
+};
+
+static adv_delta_mac_t
+adv_delta_conv_mac(const mac_address_bin_t* const p_mac_addr)
+{
+    adv_delta_mac_t mac = 0;
+    for (uint32_t i = 0; i < MAC_ADDRESS_NUM_BYTES; ++i)
+    {
+        mac = (mac << ADV_DELTA_NUM_BITS_PER_BYTE) | p_mac_addr->mac[i];
+    }
+    return mac;
+}
+
+/**
+ * @brief Find the entry for the MAC address with the binary search.
+ * @param p_delta - ptr to adv_delta_t
+ * @param mac - MAC address
+ * @param[out] p_idx - index of the found entry or the index where the new entry should be inserted
+ * @return true if the entry was found
+ */
+static bool
+adv_delta_find(const adv_delta_t* const p_delta, const adv_delta_mac_t mac, num_of_advs_t* const p_idx)
+{
+    num_of_advs_t idx_begin = 0;
+    num_of_advs_t idx_end   = p_delta->num_of_tags;
+    while (idx_begin < idx_end)
+    {
+        const num_of_advs_t   idx_mid = idx_begin + ((idx_end - idx_begin) / 2);
+        const adv_delta_mac_t mac_mid = p_delta->arr_of_entries[idx_mid].mac;
+        if (mac_mid == mac)
+        {
+            *p_idx = idx_mid;
+            return true;
+        }
+        if (mac_mid < mac)
+        {
+            idx_begin = idx_mid + 1;
+        }
+        else
+        {
+            idx_end = idx_mid;
+        }
+    }
+    *p_idx = idx_begin;
+    return false;
+}
+
+adv_delta_t*
+adv_delta_create(const num_of_advs_t capacity, const uint32_t keyframe_interval)
+{
+    if ((0 == capacity) || (0 == keyframe_interval))
+    {
+        return NULL;
+    }
+    adv_delta_t* const p_delta = os_calloc(1, sizeof(*p_delta) + (capacity * sizeof(p_delta->arr_of_entries[0])));
+    if (NULL == p_delta)
+    {
+        return NULL;
+    }
+    p_delta->capacity          = capacity;
+    p_delta->num_of_tags       = 0;
+    p_delta->keyframe_interval = keyframe_interval;
+    p_delta->commit_seq        = 0;
+    return p_delta;
+}
+
+void
+adv_delta_delete(adv_delta_t** const p_p_delta)
+{
+    if (NULL != *p_p_delta)
+    {
+        os_free(*p_p_delta);
+    }
+}
+
+bool
+adv_delta_get_prev(
+    const adv_delta_t* const       p_delta,
+    const mac_address_bin_t* const p_tag_mac,
+    adv_report_t* const            p_adv_prev)
+{
+    num_of_advs_t idx = 0;
+    if (!adv_delta_find(p_delta, adv_delta_conv_mac(p_tag_mac), &idx))
+    {
+        return false;
+    }
+    const adv_delta_entry_t* const p_entry = &p_delta->arr_of_entries[idx];
+    if (0 == p_entry->cnt_since_keyframe)
+    {
+        return false;
+    }
+    *p_adv_prev = p_entry->adv;
+    return true;
+}
+
+static num_of_advs_t
+adv_delta_find_least_recently_committed(const adv_delta_t* const p_delta)
+{
+    num_of_advs_t idx_oldest = 0;
+    uint32_t      max_age    = 0;
+    for (num_of_advs_t i = 0; i < p_delta->num_of_tags; ++i)
+    {
+        // The difference is correct even if commit_seq has wrapped around.
+        const uint32_t age = p_delta->commit_seq - p_delta->arr_of_entries[i].last_commit_seq;
+        if (age > max_age)
+        {
+            max_age    = age;
+            idx_oldest = i;
+        }
+    }
+    return idx_oldest;
+}
+
+static void
+adv_delta_remove_entry(adv_delta_t* const p_delta, const num_of_advs_t idx)
+{
+    p_delta->num_of_tags -= 1;
+    memmove(
+        &p_delta->arr_of_entries[idx],
+        &p_delta->arr_of_entries[idx + 1],
+        (p_delta->num_of_tags - idx) * sizeof(p_delta->arr_of_entries[0]));
+}
+
+void
+adv_delta_commit(adv_delta_t* const p_delta, const adv_report_t* const p_adv)
+{
+    const adv_delta_mac_t mac = adv_delta_conv_mac(&p_adv->tag_mac);
+    num_of_advs_t         idx = 0;
+    p_delta->commit_seq += 1;
+    if (!adv_delta_find(p_delta, mac, &idx))
+    {
+        if (p_delta->num_of_tags >= p_delta->capacity)
+        {
+            adv_delta_remove_entry(p_delta, adv_delta_find_least_recently_committed(p_delta));
+            (void)adv_delta_find(p_delta, mac, &idx);
+        }
+        memmove(
+            &p_delta->arr_of_entries[idx + 1],
+            &p_delta->arr_of_entries[idx],
+            (p_delta->num_of_tags - idx) * sizeof(p_delta->arr_of_entries[0]));
+        p_delta->num_of_tags += 1;
+        p_delta->arr_of_entries[idx].mac                = mac;
+        p_delta->arr_of_entries[idx].cnt_since_keyframe = 0; // The first message for the tag is a keyframe
+    }
+    adv_delta_entry_t* const p_entry = &p_delta->arr_of_entries[idx];
+    p_entry->last_commit_seq         = p_delta->commit_seq;
+    p_entry->cnt_since_keyframe      = (p_entry->cnt_since_keyframe + 1) % p_delta->keyframe_interval;
+    p_entry->adv                     = *p_adv;
+}
+
+void
+adv_delta_reset(adv_delta_t* const p_delta)
+{
+    p_delta->num_of_tags = 0;
+}
+
+num_of_advs_t
+adv_delta_get_num_of_tags(const adv_delta_t* const p_delta)
+{
+    return p_delta->num_of_tags;
+}
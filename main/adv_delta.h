@@ -0,0 +1,91 @@
+/**
+ * @file adv_delta.h
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ * @brief Per-target shadow of the last published advertisements for delta-encoded payloads.
+ *
+ * Every publishing target (MQTT, HTTP) has its own shadow. For every tag the shadow keeps a copy of the last
+ * published advertisement and the number of messages sent since the last keyframe. The decoders
+ * (see adv_decode.h) compare the current data with the previously published data and emit only the changed fields.
+ * Every keyframe_interval-th message for the tag is a keyframe which contains all fields.
+ * The shadow has a fixed capacity, when it's full, then the least recently published tag is evicted,
+ * so the next message for the evicted tag is a keyframe.
+ *
+ * The shadow is not thread-safe, the caller must serialize the access.
+ */
+
+#ifndef RUUVI_GATEWAY_ADV_DELTA_H
+#define RUUVI_GATEWAY_ADV_DELTA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "adv_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct adv_delta_t adv_delta_t;
+
+/**
+ * @brief Create the shadow of the last published advertisements.
+ * @param capacity - the maximum number of tags in the shadow
+ * @param keyframe_interval - send a keyframe (all fields) every keyframe_interval messages for the tag,
+ *                            1 means that every message is a keyframe
+ * @return ptr to adv_delta_t or NULL if there is not enough memory or the params are invalid
+ */
+adv_delta_t*
+adv_delta_create(const num_of_advs_t capacity, const uint32_t keyframe_interval);
+
+/**
+ * @brief Delete the shadow.
+ * @param p_p_delta - ptr to the variable with ptr to adv_delta_t, it's set to NULL
+ */
+void
+adv_delta_delete(adv_delta_t** const p_p_delta);
+
+/**
+ * @brief Get the previously published advertisement for the tag to generate a delta against it.
+ * @note The result does not change until the next call of adv_delta_commit or adv_delta_reset,
+ *       so it can be called on every pass of json_stream_gen.
+ * @param p_delta - ptr to adv_delta_t
+ * @param p_tag_mac - ptr to MAC address of the tag
+ * @param[out] p_adv_prev - ptr to the output buffer for the previously published advertisement
+ * @return true if a delta can be sent, false if a keyframe must be sent
+ */
+bool
+adv_delta_get_prev(
+    const adv_delta_t* const       p_delta,
+    const mac_address_bin_t* const p_tag_mac,
+    adv_report_t* const            p_adv_prev);
+
+/**
+ * @brief Save the published advertisement to the shadow.
+ * @note It must be called once for every published message generated with the result of adv_delta_get_prev.
+ * @param p_delta - ptr to adv_delta_t
+ * @param p_adv - ptr to the published advertisement
+ */
+void
+adv_delta_commit(adv_delta_t* const p_delta, const adv_report_t* const p_adv);
+
+/**
+ * @brief Clear the shadow, so that the next message for every tag is a keyframe.
+ * @param p_delta - ptr to adv_delta_t
+ */
+void
+adv_delta_reset(adv_delta_t* const p_delta);
+
+/**
+ * @brief Get the number of tags in the shadow.
+ * @param p_delta - ptr to adv_delta_t
+ * @return the number of tags
+ */
+num_of_advs_t
+adv_delta_get_num_of_tags(const adv_delta_t* const p_delta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_ADV_DELTA_H
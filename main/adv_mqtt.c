@@ -42,3 +42,9 @@ adv_mqtt_stop(void)
     LOG_INFO("adv_mqtt_stop");
     adv_mqtt_signals_send_sig(ADV_MQTT_SIG_STOP);
 }
+
+void
+adv_mqtt_publish_periodic(void)
+{
+    adv_mqtt_signals_send_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC);
+}
@@ -23,6 +23,13 @@ adv_mqtt_is_initialized(void);
 void
 adv_mqtt_stop(void);
 
+/**
+ * @brief Publish the advertisements accumulated since the previous periodic publication (list3 of adv_table).
+ * @note It's called by the MQTT timer of adv_post when the periodic mode (mqtt_sending_interval != 0) is active.
+ */
+void
+adv_mqtt_publish_periodic(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,6 +9,8 @@
 #define RUUVI_GATEWAY_ESP_ADV_MQTT_INTERNAL_H
 
 #include <stdbool.h>
+#include <time.h>
+#include "adv_table.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,9 +19,27 @@ extern "C" {
 #define ADV_MQTT_TASK_WATCHDOG_FEEDING_PERIOD_TICKS  pdMS_TO_TICKS(1000)
 #define ADV_MQTT_TASK_RETRY_SENDING_ADVS_AFTER_TICKS pdMS_TO_TICKS(50)
 
+#if !defined(ADV_MQTT_BURST_MAX_ADVS)
+/**
+ * @brief The maximum number of advs which are published in one burst,
+ *        after that the rest of advs are published on the next iteration of the task loop,
+ *        so that the other signals (e.g. feeding the task watchdog) are not delayed.
+ * @note It's configured by RUUVI_ADV_MQTT_BURST_MAX_ADVS in the top-level CMakeLists.txt.
+ */
+#define ADV_MQTT_BURST_MAX_ADVS (32U)
+#endif
+
+/**
+ * @brief The maximum number of advs which are read from the snapshot for one call of mqtt_publish_advs.
+ */
+#define ADV_MQTT_PERIODIC_ADVS_BUF_SIZE (8U)
+
 typedef struct adv_mqtt_state_t
 {
-    bool flag_stop;
+    bool                  flag_stop;
+    adv_table_snapshot_t* p_snapshot_periodic; //<! Snapshot of list3 which is being published in periodic mode
+    num_of_advs_t         snapshot_idx;        //<! Index of the next adv in p_snapshot_periodic
+    time_t                snapshot_timestamp;  //<! Gateway timestamp of the periodic publication
 } adv_mqtt_state_t;
 
 #ifdef __cplusplus
@@ -8,6 +8,8 @@
 #include "adv_mqtt_signals.h"
 #include <esp_task_wdt.h>
 #include <esp_attr.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "os_malloc.h"
 #include "event_mgr.h"
 #include "adv_table.h"
@@ -34,6 +36,7 @@ typedef void (*adv_mqtt_sig_handler_t)(adv_mqtt_state_t* const p_adv_mqtt_state)
 
 static os_signal_t* IRAM_ATTR g_p_adv_mqtt_sig;
 static os_signal_static_t     g_adv_mqtt_sig_mem;
+static adv_report_t           g_adv_mqtt_advs_buf[ADV_MQTT_PERIODIC_ADVS_BUF_SIZE];
 
 ATTR_PURE
 os_signal_num_e
@@ -78,16 +81,117 @@ adv_mqtt_handle_sig_stop(adv_mqtt_state_t* p_adv_mqtt_state)
 }
 
 static void
-adv_mqtt_handle_sig_recv_adv(ATTR_UNUSED adv_mqtt_state_t* const p_adv_mqtt_state) // NOSONAR
+adv_mqtt_add_publish_latency(
+    const metrics_mqtt_publish_mode_e mode,
+    const adv_report_t* const         p_advs,
+    const num_of_advs_t               num_of_advs)
 {
-    LOG_DBG("Got ADV_MQTT_SIG_RECV_ADV");
+    const uint32_t cur_tick = (uint32_t)xTaskGetTickCount();
+    for (num_of_advs_t i = 0; i < num_of_advs; ++i)
+    {
+        if (0 != p_advs[i].recv_tick)
+        {
+            metrics_mqtt_publish_latency_add(mode, (cur_tick - p_advs[i].recv_tick) * portTICK_PERIOD_MS);
+        }
+    }
+    if (0 != num_of_advs)
+    {
+        metrics_boot_first_adv_relayed();
+    }
+}
 
+/**
+ * @brief Publish the head of list3 (instant mode).
+ * @return the number of published advs, 0 if list3 is empty or on error.
+ */
+static num_of_advs_t
+adv_mqtt_publish_next_from_list3(const mqtt_publish_ctx_t* const p_ctx)
+{
+    adv_report_t* const p_adv = &g_adv_mqtt_advs_buf[0];
+    if (!adv_table_read_retransmission_list3_head(p_adv))
+    {
+        return 0;
+    }
+    if (!mqtt_publish_adv(p_ctx, p_adv))
+    {
+        LOG_ERR("%s failed", "mqtt_publish_adv");
+        return 0;
+    }
+    adv_mqtt_add_publish_latency(METRICS_MQTT_PUBLISH_MODE_INSTANT, p_adv, 1);
+    return 1;
+}
+
+/**
+ * @brief Publish the next advs from the snapshot of list3 (periodic mode), the snapshot is released when it's done.
+ * @return the number of published advs, 0 if there is no snapshot or on error.
+ */
+static num_of_advs_t
+adv_mqtt_publish_next_from_snapshot(adv_mqtt_state_t* const p_state, const mqtt_publish_ctx_t* const p_ctx)
+{
+    if (NULL == p_state->p_snapshot_periodic)
+    {
+        return 0;
+    }
+    const num_of_advs_t num_of_advs = adv_table_snapshot_get_num_of_advs(p_state->p_snapshot_periodic);
+    num_of_advs_t       cnt         = 0;
+    while ((cnt < ADV_MQTT_PERIODIC_ADVS_BUF_SIZE) && ((p_state->snapshot_idx + cnt) < num_of_advs))
+    {
+        if (!adv_table_snapshot_get_adv(
+                p_state->p_snapshot_periodic,
+                p_state->snapshot_idx + cnt,
+                &g_adv_mqtt_advs_buf[cnt]))
+        {
+            break;
+        }
+        cnt += 1;
+    }
+    num_of_advs_t num_published = 0;
+    if (0 == cnt)
+    {
+        // The content of the tag was lost because of lack of memory, skip it
+        num_published = 1;
+    }
+    else
+    {
+        num_published = mqtt_publish_advs(p_ctx, g_adv_mqtt_advs_buf, cnt);
+        if (0 == num_published)
+        {
+            LOG_ERR("%s failed", "mqtt_publish_advs");
+            adv_table_snapshot_release(&p_state->p_snapshot_periodic);
+            return 0;
+        }
+        adv_mqtt_add_publish_latency(METRICS_MQTT_PUBLISH_MODE_PERIODIC, g_adv_mqtt_advs_buf, num_published);
+    }
+    p_state->snapshot_idx += num_published;
+    if (p_state->snapshot_idx >= num_of_advs)
+    {
+        adv_table_snapshot_release(&p_state->p_snapshot_periodic);
+    }
+    return num_published;
+}
+
+/**
+ * @brief Publish the pending advs in a burst while there is free space in the MQTT buffer.
+ * @note The advs are taken from the snapshot of the periodic publication if it's in progress,
+ *       otherwise from list3 in the instant mode. The cfg cache and gw_cfg are locked once per burst.
+ *       The burst is limited by ADV_MQTT_BURST_MAX_ADVS, the rest of advs are published after handling other signals.
+ */
+static void
+adv_mqtt_publish_burst(adv_mqtt_state_t* const p_state)
+{
     if ((!gw_status_is_mqtt_connected()) || (!gw_status_is_relaying_via_mqtt_enabled()))
     {
+        if (NULL != p_state->p_snapshot_periodic)
+        {
+            LOG_WARN("MQTT is not available, discard the rest of advs of the periodic publication");
+            adv_table_snapshot_release(&p_state->p_snapshot_periodic);
+        }
         return;
     }
-    adv_mqtt_cfg_cache_t* p_cfg_cache = adv_mqtt_cfg_cache_mutex_lock();
-    if (!p_cfg_cache->flag_mqtt_instant_mode_active)
+    adv_mqtt_cfg_cache_t* p_cfg_cache   = adv_mqtt_cfg_cache_mutex_lock();
+    const bool            flag_periodic = (NULL != p_state->p_snapshot_periodic);
+    if ((!flag_periodic)
+        && ((!p_cfg_cache->flag_mqtt_instant_mode_active) || adv_table_read_retransmission_list3_is_empty()))
     {
         adv_mqtt_cfg_cache_mutex_unlock(&p_cfg_cache);
         return;
@@ -101,26 +205,107 @@ adv_mqtt_handle_sig_recv_adv(ATTR_UNUSED adv_mqtt_state_t* const p_adv_mqtt_stat
         return;
     }
 
-    adv_report_t adv_report = { 0 };
-    if (adv_table_read_retransmission_list3_head(&adv_report))
+    mqtt_publish_ctx_t publish_ctx = { 0 };
+    if (flag_periodic)
+    {
+        mqtt_publish_ctx_init(&publish_ctx, p_cfg_cache->flag_use_ntp, p_state->snapshot_timestamp);
+    }
+    else
     {
         const time_t timestamp_if_synchronized = time_is_synchronized() ? time(NULL) : 0;
         const time_t timestamp                 = p_cfg_cache->flag_use_ntp ? timestamp_if_synchronized
                                                                            : (time_t)metrics_received_advs_get();
-        if (mqtt_publish_adv(&adv_report, p_cfg_cache->flag_use_ntp, timestamp))
+        mqtt_publish_ctx_init(&publish_ctx, p_cfg_cache->flag_use_ntp, timestamp);
+    }
+
+    num_of_advs_t num_published = 0;
+    for (;;)
+    {
+        const num_of_advs_t num = flag_periodic ? adv_mqtt_publish_next_from_snapshot(p_state, &publish_ctx)
+                                                : adv_mqtt_publish_next_from_list3(&publish_ctx);
+        if (0 == num)
+        {
+            break;
+        }
+        num_published += num;
+        const bool flag_pending = flag_periodic ? (NULL != p_state->p_snapshot_periodic)
+                                                : (!adv_table_read_retransmission_list3_is_empty());
+        if (!flag_pending)
+        {
+            break;
+        }
+        if (num_published >= ADV_MQTT_BURST_MAX_ADVS)
         {
-            network_timeout_update_timestamp();
+            os_signal_send(g_p_adv_mqtt_sig, adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_ON_RECV_ADV));
+            break;
         }
-        else
+        if (!mqtt_is_buffer_available_for_publish())
         {
-            LOG_ERR("%s failed", "mqtt_publish_adv");
+            LOG_DBG("MQTT buffer is full - postpone sending advs to MQTT");
+            adv_mqtt_timers_start_timer_sig_retry_sending_advs();
+            break;
         }
     }
-    if (!adv_table_read_retransmission_list3_is_empty())
+    adv_mqtt_cfg_cache_mutex_unlock(&p_cfg_cache);
+
+    if (0 != num_published)
     {
-        os_signal_send(g_p_adv_mqtt_sig, adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_ON_RECV_ADV));
+        network_timeout_update_timestamp();
     }
+}
+
+static void
+adv_mqtt_handle_sig_recv_adv(adv_mqtt_state_t* const p_adv_mqtt_state)
+{
+    LOG_DBG("Got ADV_MQTT_SIG_RECV_ADV");
+    event_mgr_ack(EVENT_MGR_EV_RECV_ADV);
+
+    adv_mqtt_publish_burst(p_adv_mqtt_state);
+}
+
+static void
+adv_mqtt_handle_sig_publish_periodic(adv_mqtt_state_t* const p_adv_mqtt_state)
+{
+    LOG_INFO("Got ADV_MQTT_SIG_PUBLISH_PERIODIC");
+    if (NULL != p_adv_mqtt_state->p_snapshot_periodic)
+    {
+        LOG_WARN("The previous periodic publication is still in progress, skip this period");
+        return;
+    }
+    if ((!gw_status_is_mqtt_connected()) || (!gw_status_is_relaying_via_mqtt_enabled()))
+    {
+        LOG_DBG("Can't send advs via MQTT, MQTT is not connected");
+        return;
+    }
+    adv_mqtt_cfg_cache_t* p_cfg_cache  = adv_mqtt_cfg_cache_mutex_lock();
+    const bool            flag_use_ntp = p_cfg_cache->flag_use_ntp;
     adv_mqtt_cfg_cache_mutex_unlock(&p_cfg_cache);
+    if (flag_use_ntp && (!time_is_synchronized()))
+    {
+        LOG_DBG("Can't send advs via MQTT, the time is not yet synchronized");
+        return;
+    }
+
+    // For thread safety, the advertisements are published from a snapshot of the retransmission list,
+    // which refers to the changed tags in adv_table without copying them.
+    p_adv_mqtt_state->p_snapshot_periodic = adv_table_read_retransmission_list3_snapshot_and_clear();
+    if (NULL == p_adv_mqtt_state->p_snapshot_periodic)
+    {
+        LOG_ERR("Can't allocate memory for snapshot of adv_table");
+        gateway_restart_low_memory();
+        return;
+    }
+    const num_of_advs_t num_of_advs = adv_table_snapshot_get_num_of_advs(p_adv_mqtt_state->p_snapshot_periodic);
+    LOG_INFO("Advertisements in table for target=MQTT (num=%u)", (printf_uint_t)num_of_advs);
+    if (0 == num_of_advs)
+    {
+        adv_table_snapshot_release(&p_adv_mqtt_state->p_snapshot_periodic);
+        return;
+    }
+    p_adv_mqtt_state->snapshot_idx       = 0;
+    p_adv_mqtt_state->snapshot_timestamp = flag_use_ntp ? time(NULL) : 0;
+
+    adv_mqtt_publish_burst(p_adv_mqtt_state);
 }
 
 static void
@@ -200,6 +385,7 @@ adv_mqtt_handle_sig(const adv_mqtt_sig_e adv_mqtt_sig, adv_mqtt_state_t* const p
         [ADV_MQTT_SIG_RELAYING_MODE_CHANGED] = &adv_mqtt_handle_sig_relaying_mode_changed,
         [ADV_MQTT_SIG_CFG_MODE_ACTIVATED]    = &adv_mqtt_handle_sig_cfg_mode_activated,
         [ADV_MQTT_SIG_CFG_MODE_DEACTIVATED]  = &adv_mqtt_handle_sig_cfg_mode_deactivated,
+        [ADV_MQTT_SIG_PUBLISH_PERIODIC]      = &adv_mqtt_handle_sig_publish_periodic,
     };
 
     assert(adv_mqtt_sig < OS_ARRAY_SIZE(g_adv_mqtt_sig_handlers));
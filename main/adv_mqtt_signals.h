@@ -26,10 +26,11 @@ typedef enum adv_mqtt_sig_e
     ADV_MQTT_SIG_RELAYING_MODE_CHANGED = OS_SIGNAL_NUM_6,
     ADV_MQTT_SIG_CFG_MODE_ACTIVATED    = OS_SIGNAL_NUM_7,
     ADV_MQTT_SIG_CFG_MODE_DEACTIVATED  = OS_SIGNAL_NUM_8,
+    ADV_MQTT_SIG_PUBLISH_PERIODIC      = OS_SIGNAL_NUM_9,
 } adv_mqtt_sig_e;
 
 #define ADV_MQTT_SIG_FIRST (ADV_MQTT_SIG_STOP)
-#define ADV_MQTT_SIG_LAST  (ADV_MQTT_SIG_CFG_MODE_DEACTIVATED)
+#define ADV_MQTT_SIG_LAST  (ADV_MQTT_SIG_PUBLISH_PERIODIC)
 
 ATTR_PURE
 os_signal_num_e
@@ -60,7 +60,10 @@ adv_mqtt_task(void)
     adv_mqtt_wdt_add_and_start();
 
     adv_mqtt_state_t adv_mqtt_state = {
-        .flag_stop = false,
+        .flag_stop           = false,
+        .p_snapshot_periodic = NULL,
+        .snapshot_idx        = 0,
+        .snapshot_timestamp  = 0,
     };
 
     while (!adv_mqtt_state.flag_stop)
@@ -88,6 +91,10 @@ adv_mqtt_task(void)
 #endif
     }
     LOG_INFO("Stop task adv_mqtt");
+    if (NULL != adv_mqtt_state.p_snapshot_periodic)
+    {
+        adv_table_snapshot_release(&adv_mqtt_state.p_snapshot_periodic);
+    }
 
     LOG_INFO("TaskWatchdog: Unregister current thread");
     esp_task_wdt_delete(xTaskGetCurrentTaskHandle());
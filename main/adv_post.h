@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include "gw_cfg.h"
 #include "http_json.h"
+#include "adv_post_recv.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,9 +21,6 @@ extern "C" {
 void
 adv_post_init(void);
 
-uint32_t
-adv_post_advs_cnt_get_and_clear(void);
-
 #ifdef __cplusplus
 }
 #endif
@@ -14,8 +14,8 @@
 #include "ruuvi_gateway.h"
 #include "gw_status.h"
 #include "adv_table.h"
+#include "adv_spool.h"
 #include "http.h"
-#include "mqtt.h"
 #include "leds.h"
 #include "adv_post.h"
 #include "adv_post_statistics.h"
@@ -32,31 +32,105 @@
 static const char TAG[] = "ADV_POST_ASYNC_COMM";
 
 static uint32_t IRAM_ATTR g_adv_post_nonce;
-static adv_post_action_e  g_adv_post_action = ADV_POST_ACTION_NONE;
 
-static const adv_report_table_t* IRAM_ATTR g_p_adv_post_reports_mqtt;
-static uint32_t IRAM_ATTR                  g_adv_post_reports_mqtt_idx;
-static time_t IRAM_ATTR                    g_adv_post_reports_mqtt_timestamp;
+/**
+ * @brief The async HTTP slot of the request in progress for each target (NULL if there is no request).
+ * @note The requests to different targets are sent concurrently, but only one request per target is allowed.
+ */
+static http_async_info_t* g_adv_post_action_slot[ADV_POST_ACTION_NUM];
+
+static adv_post_action_e g_adv_post_spool_drain_action; //<! Target of the record being sent from the spool
+static adv_spool_rec_id_t g_adv_post_spool_drain_rec_id; //<! Identifier of the record being sent from the spool
+static bool g_adv_post_flag_spool_drain_paused; //<! Set after a failed HTTP POST, cleared after a successful one
 
 void
 adv_post_async_comm_init(void)
 {
-    g_adv_post_nonce                  = esp_random();
-    g_adv_post_action                 = ADV_POST_ACTION_NONE;
-    g_p_adv_post_reports_mqtt         = NULL;
-    g_adv_post_reports_mqtt_idx       = 0;
-    g_adv_post_reports_mqtt_timestamp = 0;
+    g_adv_post_nonce = esp_random();
+    for (uint32_t i = 0; i < ADV_POST_ACTION_NUM; ++i)
+    {
+        g_adv_post_action_slot[i] = NULL;
+    }
+
+    g_adv_post_spool_drain_action      = ADV_POST_ACTION_NONE;
+    g_adv_post_flag_spool_drain_paused = false;
 }
 
+bool
+adv_post_is_action_in_progress(const adv_post_action_e action)
+{
+    return NULL != g_adv_post_action_slot[action];
+}
+
+static bool
+adv_post_is_any_action_in_progress(void)
+{
+    for (uint32_t i = 0; i < ADV_POST_ACTION_NUM; ++i)
+    {
+        if (NULL != g_adv_post_action_slot[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief The HTTP server is locked while at least one HTTP POST is in progress, so unlock it after the last one.
+ */
 static void
-adv_post_log(const adv_report_table_t* p_reports, const bool flag_use_timestamps, const char* const p_target_name)
+adv_post_unlock_http_server_mutex_if_idle(void)
+{
+    if (!adv_post_is_any_action_in_progress())
+    {
+        LOG_DBG("http_server_mutex_unlock");
+        http_server_mutex_unlock();
+    }
+}
+
+static http_async_info_t*
+adv_post_acquire_slot(const http_post_recipient_e recipient, const char* const p_target_name)
+{
+    if (!adv_post_is_any_action_in_progress())
+    {
+        LOG_DBG("http_server_mutex_try_lock");
+        if (!http_server_mutex_try_lock())
+        {
+            LOG_DBG("Wait until incoming HTTP connection is handled, postpone sending %s", p_target_name);
+            return NULL;
+        }
+    }
+    http_async_info_t* const p_http_async_info = http_async_slot_acquire(recipient);
+    if (NULL == p_http_async_info)
+    {
+        LOG_DBG("No free slot for async HTTP request, postpone sending %s", p_target_name);
+        adv_post_unlock_http_server_mutex_if_idle();
+    }
+    return p_http_async_info;
+}
+
+static void
+adv_post_release_slot(http_async_info_t* const p_http_async_info)
+{
+    http_async_slot_release(p_http_async_info);
+    adv_post_unlock_http_server_mutex_if_idle();
+}
+
+static void
+adv_post_log(const adv_table_snapshot_t* p_snapshot, const bool flag_use_timestamps, const char* const p_target_name)
 {
     (void)flag_use_timestamps;
-    LOG_INFO("Advertisements in table for target=%s (num=%u):", p_target_name, (printf_uint_t)p_reports->num_of_advs);
+    const num_of_advs_t num_of_advs = adv_table_snapshot_get_num_of_advs(p_snapshot);
+    LOG_INFO("Advertisements in table for target=%s (num=%u):", p_target_name, (printf_uint_t)num_of_advs);
 #if LOG_LOCAL_LEVEL >= LOG_LEVEL_INFO
-    for (num_of_advs_t i = 0; i < p_reports->num_of_advs; ++i)
+    for (num_of_advs_t i = 0; i < num_of_advs; ++i)
     {
-        const adv_report_t* p_adv = &p_reports->table[i];
+        adv_report_t adv = { 0 };
+        if (!adv_table_snapshot_get_adv(p_snapshot, i, &adv))
+        {
+            continue;
+        }
+        const adv_report_t* p_adv = &adv;
 
         const mac_address_str_t mac_str = mac_address_to_str(&p_adv->tag_mac);
         LOG_DUMP_INFO(
@@ -75,9 +149,10 @@ adv_post_log(const adv_report_table_t* p_reports, const bool flag_use_timestamps
 
 static bool
 adv_post_retransmit_advs(
-    const adv_report_table_t* const p_reports,
-    const bool                      flag_use_timestamps,
-    const bool                      flag_post_to_ruuvi)
+    http_async_info_t* const    p_http_async_info,
+    adv_table_snapshot_t* const p_snapshot,
+    const bool                  flag_use_timestamps,
+    const bool                  flag_post_to_ruuvi)
 {
     const ruuvi_gw_cfg_http_t* p_cfg_http = gw_cfg_get_http_copy();
     if (NULL == p_cfg_http)
@@ -85,8 +160,14 @@ adv_post_retransmit_advs(
         LOG_ERR("%s failed", "gw_cfg_get_http_copy");
         return false;
     }
-    const bool res
-        = http_post_advs(p_reports, g_adv_post_nonce, flag_use_timestamps, flag_post_to_ruuvi, p_cfg_http, NULL);
+    const bool res = http_post_advs(
+        p_http_async_info,
+        p_snapshot,
+        g_adv_post_nonce,
+        flag_use_timestamps,
+        flag_post_to_ruuvi,
+        p_cfg_http,
+        NULL);
     os_free(p_cfg_http);
     if (!res)
     {
@@ -95,60 +176,129 @@ adv_post_retransmit_advs(
     return true;
 }
 
+static adv_table_snapshot_t*
+adv_post_take_snapshot(const adv_post_action_e adv_post_action)
+{
+    switch (adv_post_action)
+    {
+        case ADV_POST_ACTION_POST_ADVS_TO_RUUVI:
+            return adv_table_read_retransmission_list1_snapshot_and_clear();
+        case ADV_POST_ACTION_POST_ADVS_TO_CUSTOM:
+            return adv_table_read_retransmission_list2_snapshot_and_clear();
+        default:
+            break;
+    }
+    LOG_ERR("Incorrect adv_post_action: %d", (printf_int_t)adv_post_action);
+    assert(0);
+    return NULL;
+}
+
 static bool
-adv_post_do_retransmission(const bool flag_use_timestamps, const adv_post_action_e adv_post_action)
+adv_post_do_retransmission(
+    http_async_info_t* const p_http_async_info,
+    const bool               flag_use_timestamps,
+    const adv_post_action_e  adv_post_action)
 {
-    LOG_DBG("Allocate %u bytes for adv reports buffer", (printf_uint_t)sizeof(adv_report_table_t));
-    adv_report_table_t* p_adv_reports_buf = os_calloc(1, sizeof(*p_adv_reports_buf));
-    if (NULL == p_adv_reports_buf)
+    // For thread safety, the advertisements are posted from a snapshot of the retransmission list,
+    // which refers to the changed tags in adv_table without copying them.
+    adv_table_snapshot_t* p_snapshot = adv_post_take_snapshot(adv_post_action);
+    if (NULL == p_snapshot)
     {
-        LOG_ERR("Can't allocate %u bytes of memory", (printf_uint_t)sizeof(*p_adv_reports_buf));
+        LOG_ERR("Can't allocate memory for snapshot of adv_table");
         gateway_restart_low_memory();
         return false;
     }
 
     bool res = false;
 
-    // for thread safety copy the advertisements to a separate buffer for posting
     switch (adv_post_action)
     {
-        case ADV_POST_ACTION_NONE:
-            LOG_ERR("Incorrect adv_post_action: %s", "ADV_POST_ACTION_NONE");
-            assert(0);
-            break;
         case ADV_POST_ACTION_POST_ADVS_TO_RUUVI:
-            adv_table_read_retransmission_list1_and_clear(p_adv_reports_buf);
-            adv_post_log(p_adv_reports_buf, flag_use_timestamps, "HTTP(Ruuvi)");
-            res = adv_post_retransmit_advs(p_adv_reports_buf, flag_use_timestamps, true);
-            os_free(p_adv_reports_buf);
+            adv_post_log(p_snapshot, flag_use_timestamps, "HTTP(Ruuvi)");
+            res = adv_post_retransmit_advs(p_http_async_info, p_snapshot, flag_use_timestamps, true);
+            adv_table_snapshot_release(&p_snapshot);
             break;
         case ADV_POST_ACTION_POST_ADVS_TO_CUSTOM:
-            adv_table_read_retransmission_list2_and_clear(p_adv_reports_buf);
-            adv_post_log(p_adv_reports_buf, flag_use_timestamps, "HTTP(Custom)");
-            res = adv_post_retransmit_advs(p_adv_reports_buf, flag_use_timestamps, false);
-            os_free(p_adv_reports_buf);
+            adv_post_log(p_snapshot, flag_use_timestamps, "HTTP(Custom)");
+            res = adv_post_retransmit_advs(p_http_async_info, p_snapshot, flag_use_timestamps, false);
+            adv_table_snapshot_release(&p_snapshot);
             break;
-        case ADV_POST_ACTION_POST_STATS:
-            LOG_ERR("Incorrect adv_post_action: %s", "ADV_POST_ACTION_POST_STATS");
-            assert(0);
-            break;
-        case ADV_POST_ACTION_POST_ADVS_TO_MQTT:
-            adv_table_read_retransmission_list3_and_clear(p_adv_reports_buf);
-            adv_post_log(p_adv_reports_buf, flag_use_timestamps, "MQTT");
-            g_p_adv_post_reports_mqtt         = p_adv_reports_buf;
-            g_adv_post_reports_mqtt_idx       = 0;
-            g_adv_post_reports_mqtt_timestamp = (gw_cfg_get_ntp_use() ? time(NULL) : 0);
-            res                               = true;
+        default:
+            adv_table_snapshot_release(&p_snapshot);
             break;
     }
     return res;
 }
 
+/**
+ * @brief Move the advs from the retransmission list to the persistent spool while there is no network connection.
+ * @return false if the spool is disabled or the advs can't be spooled now, so they should stay in adv_table.
+ */
+static bool
+adv_post_spool_advs(const adv_post_state_t* const p_adv_post_state, const adv_post_action_e adv_post_action)
+{
+    if (!adv_spool_is_enabled())
+    {
+        return false;
+    }
+    if (p_adv_post_state->flag_use_timestamps && (!time_is_synchronized()))
+    {
+        // The advs without valid timestamps are useless after the connection is restored.
+        return false;
+    }
+    adv_report_t* p_arr_of_advs = os_malloc(ADV_SPOOL_MAX_ADVS_PER_RECORD * sizeof(*p_arr_of_advs));
+    if (NULL == p_arr_of_advs)
+    {
+        LOG_ERR("Can't allocate memory");
+        return false;
+    }
+    adv_table_snapshot_t* p_snapshot = adv_post_take_snapshot(adv_post_action);
+    if (NULL == p_snapshot)
+    {
+        LOG_ERR("Can't allocate memory for snapshot of adv_table");
+        os_free(p_arr_of_advs);
+        return false;
+    }
+    const adv_spool_target_e target = (ADV_POST_ACTION_POST_ADVS_TO_RUUVI == adv_post_action)
+                                          ? ADV_SPOOL_TARGET_HTTP_RUUVI
+                                          : ADV_SPOOL_TARGET_HTTP_CUSTOM;
+    const num_of_advs_t      num_of_advs = adv_table_snapshot_get_num_of_advs(p_snapshot);
+    num_of_advs_t            cnt         = 0;
+    for (num_of_advs_t i = 0; i < num_of_advs; ++i)
+    {
+        if (adv_table_snapshot_get_adv(p_snapshot, i, &p_arr_of_advs[cnt]))
+        {
+            cnt += 1;
+        }
+        if (ADV_SPOOL_MAX_ADVS_PER_RECORD == cnt)
+        {
+            (void)adv_spool_append(target, p_arr_of_advs, cnt);
+            cnt = 0;
+        }
+    }
+    if (0 != cnt)
+    {
+        (void)adv_spool_append(target, p_arr_of_advs, cnt);
+    }
+    adv_table_snapshot_release(&p_snapshot);
+    os_free(p_arr_of_advs);
+    LOG_INFO(
+        "No network connection, %u advs for target=%s are saved to the spool",
+        (printf_uint_t)num_of_advs,
+        (ADV_SPOOL_TARGET_HTTP_RUUVI == target) ? "HTTP(Ruuvi)" : "HTTP(Custom)");
+    return true;
+}
+
 static void
 adv_post_do_async_comm_send_advs1(adv_post_state_t* const p_adv_post_state)
 {
     if (!p_adv_post_state->flag_network_connected)
     {
+        if (adv_post_spool_advs(p_adv_post_state, ADV_POST_ACTION_POST_ADVS_TO_RUUVI))
+        {
+            p_adv_post_state->flag_need_to_send_advs1 = false;
+            return;
+        }
         LOG_DBG("Can't send advs1, no network connection");
         return;
     }
@@ -157,22 +307,22 @@ adv_post_do_async_comm_send_advs1(adv_post_state_t* const p_adv_post_state)
         LOG_DBG("Can't send advs1, the time is not yet synchronized");
         return;
     }
-    LOG_DBG("http_server_mutex_try_lock");
-    if (!http_server_mutex_try_lock())
+    http_async_info_t* const p_http_async_info = adv_post_acquire_slot(HTTP_POST_RECIPIENT_ADVS1, "advs1");
+    if (NULL == p_http_async_info)
     {
-        LOG_DBG("Wait until incoming HTTP connection is handled, postpone sending advs1");
         return;
     }
-    g_adv_post_action = ADV_POST_ACTION_POST_ADVS_TO_RUUVI;
-    if (!adv_post_do_retransmission(p_adv_post_state->flag_use_timestamps, ADV_POST_ACTION_POST_ADVS_TO_RUUVI))
+    if (!adv_post_do_retransmission(
+            p_http_async_info,
+            p_adv_post_state->flag_use_timestamps,
+            ADV_POST_ACTION_POST_ADVS_TO_RUUVI))
     {
-        g_adv_post_action = ADV_POST_ACTION_NONE;
+        adv_post_release_slot(p_http_async_info);
         leds_notify_http1_data_sent_fail();
         p_adv_post_state->flag_need_to_send_advs1 = false;
-        LOG_DBG("http_server_mutex_unlock");
-        http_server_mutex_unlock();
         return;
     }
+    g_adv_post_action_slot[ADV_POST_ACTION_POST_ADVS_TO_RUUVI] = p_http_async_info;
     g_adv_post_nonce += 1;
     p_adv_post_state->flag_async_comm_in_progress = true;
     p_adv_post_state->flag_need_to_send_advs1     = false;
@@ -183,6 +333,11 @@ adv_post_do_async_comm_send_advs2(adv_post_state_t* const p_adv_post_state)
 {
     if (!p_adv_post_state->flag_network_connected)
     {
+        if (adv_post_spool_advs(p_adv_post_state, ADV_POST_ACTION_POST_ADVS_TO_CUSTOM))
+        {
+            p_adv_post_state->flag_need_to_send_advs2 = false;
+            return;
+        }
         LOG_DBG("Can't send advs2, no network connection");
         return;
     }
@@ -191,22 +346,22 @@ adv_post_do_async_comm_send_advs2(adv_post_state_t* const p_adv_post_state)
         LOG_DBG("Can't send advs2, the time is not yet synchronized");
         return;
     }
-    LOG_DBG("http_server_mutex_try_lock");
-    if (!http_server_mutex_try_lock())
+    http_async_info_t* const p_http_async_info = adv_post_acquire_slot(HTTP_POST_RECIPIENT_ADVS2, "advs2");
+    if (NULL == p_http_async_info)
     {
-        LOG_DBG("Wait until incoming HTTP connection is handled, postpone sending advs2");
         return;
     }
-    g_adv_post_action = ADV_POST_ACTION_POST_ADVS_TO_CUSTOM;
-    if (!adv_post_do_retransmission(p_adv_post_state->flag_use_timestamps, ADV_POST_ACTION_POST_ADVS_TO_CUSTOM))
+    if (!adv_post_do_retransmission(
+            p_http_async_info,
+            p_adv_post_state->flag_use_timestamps,
+            ADV_POST_ACTION_POST_ADVS_TO_CUSTOM))
     {
-        g_adv_post_action = ADV_POST_ACTION_NONE;
+        adv_post_release_slot(p_http_async_info);
         leds_notify_http2_data_sent_fail();
         p_adv_post_state->flag_need_to_send_advs2 = false;
-        LOG_DBG("http_server_mutex_unlock");
-        http_server_mutex_unlock();
         return;
     }
+    g_adv_post_action_slot[ADV_POST_ACTION_POST_ADVS_TO_CUSTOM] = p_http_async_info;
     g_adv_post_nonce += 1;
     p_adv_post_state->flag_async_comm_in_progress = true;
     p_adv_post_state->flag_need_to_send_advs2     = false;
@@ -231,138 +386,211 @@ adv_post_do_async_comm_send_statistics(adv_post_state_t* const p_adv_post_state)
         LOG_DBG("Can't send statistics, the time is not yet synchronized");
         return;
     }
-    LOG_DBG("http_server_mutex_try_lock");
-    if (!http_server_mutex_try_lock())
+    http_async_info_t* const p_http_async_info = adv_post_acquire_slot(HTTP_POST_RECIPIENT_STATS, "statistics");
+    if (NULL == p_http_async_info)
     {
-        LOG_DBG("Wait until incoming HTTP connection is handled, postpone sending statistics");
         return;
     }
-    g_adv_post_action = ADV_POST_ACTION_POST_STATS;
-    if (!adv_post_statistics_do_send())
+    if (!adv_post_statistics_do_send(p_http_async_info))
     {
         LOG_ERR("Failed to send statistics");
-        g_adv_post_action                              = ADV_POST_ACTION_NONE;
+        adv_post_release_slot(p_http_async_info);
         p_adv_post_state->flag_need_to_send_statistics = false;
-        LOG_DBG("http_server_mutex_unlock");
-        http_server_mutex_unlock();
         return;
     }
-    p_adv_post_state->flag_need_to_send_statistics = false;
-    p_adv_post_state->flag_async_comm_in_progress  = true;
+    g_adv_post_action_slot[ADV_POST_ACTION_POST_STATS] = p_http_async_info;
+    p_adv_post_state->flag_need_to_send_statistics     = false;
+    p_adv_post_state->flag_async_comm_in_progress      = true;
+}
+
+static bool
+adv_post_is_spool_drain_allowed(const adv_post_state_t* const p_adv_post_state)
+{
+    if ((!p_adv_post_state->flag_network_connected) || g_adv_post_flag_spool_drain_paused || adv_spool_is_empty())
+    {
+        return false;
+    }
+    if (p_adv_post_state->flag_use_timestamps && (!time_is_synchronized()))
+    {
+        LOG_DBG("Can't send advs from the spool, the time is not yet synchronized");
+        return false;
+    }
+    return true;
 }
 
+/**
+ * @brief Send the oldest record from the spool to its HTTP target.
+ * @note Only one record is sent at a time, the next one is sent after the previous one has been delivered.
+ */
 static void
-adv_post_do_async_comm_start_sending_periodic_mqtt(adv_post_state_t* const p_adv_post_state)
+adv_post_do_async_comm_drain_spool(adv_post_state_t* const p_adv_post_state)
 {
-    if (!gw_cfg_get_mqtt_use_mqtt())
+    adv_report_t* p_arr_of_advs = os_malloc(ADV_SPOOL_MAX_ADVS_PER_RECORD * sizeof(*p_arr_of_advs));
+    if (NULL == p_arr_of_advs)
     {
-        LOG_DBG("Can't send advs via MQTT, it was disabled in gw_cfg");
-        p_adv_post_state->flag_need_to_send_mqtt_periodic = false;
+        LOG_ERR("Can't allocate memory");
         return;
     }
-    if (!p_adv_post_state->flag_network_connected)
+    adv_spool_target_e  target      = ADV_SPOOL_TARGET_HTTP_RUUVI;
+    adv_spool_rec_id_t  rec_id      = { 0 };
+    const num_of_advs_t num_of_advs = adv_spool_read(&target, p_arr_of_advs, &rec_id);
+    const bool          flag_ruuvi  = (ADV_SPOOL_TARGET_HTTP_RUUVI == target) ? true : false;
+    if ((0 == num_of_advs) || (!(flag_ruuvi ? gw_cfg_get_http_use_http_ruuvi() : gw_cfg_get_http_use_http())))
     {
-        LOG_DBG("Can't send advs via MQTT, no network connection");
-        p_adv_post_state->flag_need_to_send_mqtt_periodic = false;
+        if (0 != num_of_advs)
+        {
+            LOG_WARN("Target=%s is disabled, discard advs from the spool", flag_ruuvi ? "HTTP(Ruuvi)" : "HTTP(Custom)");
+            (void)adv_spool_consume(&rec_id, false);
+        }
+        os_free(p_arr_of_advs);
         return;
     }
-    if (!gw_status_is_mqtt_connected())
+    const adv_post_action_e action = flag_ruuvi ? ADV_POST_ACTION_POST_ADVS_TO_RUUVI
+                                                : ADV_POST_ACTION_POST_ADVS_TO_CUSTOM;
+    if (adv_post_is_action_in_progress(action))
     {
-        LOG_DBG("Can't send advs via MQTT, MQTT is not connected");
-        p_adv_post_state->flag_need_to_send_mqtt_periodic = false;
+        LOG_DBG("HTTP POST to the same target is in progress, postpone sending advs from the spool");
+        os_free(p_arr_of_advs);
         return;
     }
-    if (p_adv_post_state->flag_use_timestamps && (!time_is_synchronized()))
+    http_async_info_t* const p_http_async_info = adv_post_acquire_slot(
+        flag_ruuvi ? HTTP_POST_RECIPIENT_ADVS1 : HTTP_POST_RECIPIENT_ADVS2,
+        "advs from the spool");
+    if (NULL == p_http_async_info)
     {
-        LOG_DBG("Can't send advs via MQTT, the time is not yet synchronized");
+        os_free(p_arr_of_advs);
         return;
     }
-    g_adv_post_action = ADV_POST_ACTION_POST_ADVS_TO_MQTT;
-
-    if (!adv_post_do_retransmission(p_adv_post_state->flag_use_timestamps, ADV_POST_ACTION_POST_ADVS_TO_MQTT))
+    // The snapshot takes ownership of p_arr_of_advs.
+    adv_table_snapshot_t* p_snapshot = adv_table_snapshot_create_detached(p_arr_of_advs, num_of_advs);
+    if (NULL == p_snapshot)
     {
-        g_adv_post_action                                 = ADV_POST_ACTION_NONE;
-        p_adv_post_state->flag_need_to_send_mqtt_periodic = false;
-        main_task_send_sig_restart_services();
+        LOG_ERR("Can't allocate memory for snapshot of the spool");
+        adv_post_release_slot(p_http_async_info);
         return;
     }
-
-    p_adv_post_state->flag_need_to_send_mqtt_periodic = false;
-    p_adv_post_state->flag_async_comm_in_progress     = true;
-    adv_post_signals_send_sig(ADV_POST_SIG_DO_ASYNC_COMM);
+    adv_post_log(p_snapshot, p_adv_post_state->flag_use_timestamps, flag_ruuvi ? "Spool(Ruuvi)" : "Spool(Custom)");
+    const bool res = adv_post_retransmit_advs(
+        p_http_async_info,
+        p_snapshot,
+        p_adv_post_state->flag_use_timestamps,
+        flag_ruuvi);
+    adv_table_snapshot_release(&p_snapshot);
+    if (!res)
+    {
+        adv_post_release_slot(p_http_async_info);
+        g_adv_post_flag_spool_drain_paused = true;
+        return;
+    }
+    g_adv_post_action_slot[action] = p_http_async_info;
+    g_adv_post_spool_drain_action  = action;
+    g_adv_post_spool_drain_rec_id  = rec_id;
+    g_adv_post_nonce += 1;
+    p_adv_post_state->flag_async_comm_in_progress = true;
 }
 
-static bool
-adv_post_do_async_comm_in_progress_mqtt(void)
+static void
+adv_post_handle_spool_drain_completion(const bool flag_success)
 {
-    assert(NULL != g_p_adv_post_reports_mqtt);
-
-    const adv_report_t* const p_adv_report = &g_p_adv_post_reports_mqtt->table[g_adv_post_reports_mqtt_idx];
-
-    if (!mqtt_publish_adv(p_adv_report, gw_cfg_get_ntp_use(), g_adv_post_reports_mqtt_timestamp))
+    g_adv_post_spool_drain_action = ADV_POST_ACTION_NONE;
+    if (flag_success)
     {
-        LOG_ERR("%s failed", "mqtt_publish_adv");
-        os_free(g_p_adv_post_reports_mqtt);
-        g_p_adv_post_reports_mqtt   = NULL;
-        g_adv_post_reports_mqtt_idx = 0;
-        return true;
+        // The record could be dropped while it was being sent if the spool had overflowed,
+        // in this case the ack is ignored by adv_spool_consume.
+        (void)adv_spool_consume(&g_adv_post_spool_drain_rec_id, true);
+        g_adv_post_flag_spool_drain_paused = false;
     }
-
-    g_adv_post_reports_mqtt_idx += 1;
-    if (g_adv_post_reports_mqtt_idx >= g_p_adv_post_reports_mqtt->num_of_advs)
+    else
     {
-        os_free(g_p_adv_post_reports_mqtt);
-        g_p_adv_post_reports_mqtt   = NULL;
-        g_adv_post_reports_mqtt_idx = 0;
-        return true;
+        LOG_WARN("Failed to send advs from the spool, retry after the next successful HTTP POST");
+        g_adv_post_flag_spool_drain_paused = true;
     }
-    return false;
 }
 
-static bool
-adv_post_do_async_comm_in_progress(adv_post_state_t* const p_adv_post_state)
+static adv_post_action_e
+adv_post_find_action_by_slot(const http_async_info_t* const p_http_async_info)
 {
-    if (ADV_POST_ACTION_POST_ADVS_TO_MQTT != g_adv_post_action)
+    for (uint32_t i = 0; i < ADV_POST_ACTION_NUM; ++i)
     {
-        if (!http_async_poll())
+        if (p_http_async_info == g_adv_post_action_slot[i])
         {
-            LOG_DBG("os_timer_sig_one_shot_start: g_p_adv_post_timer_sig_do_async_comm");
-            adv_post_timers_start_timer_sig_do_async_comm();
-            return false;
+            return (adv_post_action_e)i;
         }
-        switch (g_adv_post_action)
+    }
+    return ADV_POST_ACTION_NONE;
+}
+
+static void
+adv_post_handle_completion(adv_post_state_t* const p_adv_post_state, const http_async_info_t* const p_http_async_info)
+{
+    const adv_post_action_e action = adv_post_find_action_by_slot(p_http_async_info);
+    if (ADV_POST_ACTION_NONE == action)
+    {
+        LOG_ERR("Completed HTTP request does not belong to any target");
+        return;
+    }
+    g_adv_post_action_slot[action] = NULL;
+
+    const bool flag_success = p_http_async_info->flag_last_req_successful;
+    if (action == g_adv_post_spool_drain_action)
+    {
+        adv_post_handle_spool_drain_completion(flag_success);
+    }
+    else
+    {
+        switch (action)
         {
             case ADV_POST_ACTION_POST_ADVS_TO_RUUVI:
                 p_adv_post_state->flag_need_to_send_advs1 = false;
-                g_adv_post_action                         = ADV_POST_ACTION_NONE;
+                g_adv_post_flag_spool_drain_paused        = !flag_success;
                 break;
             case ADV_POST_ACTION_POST_ADVS_TO_CUSTOM:
                 p_adv_post_state->flag_need_to_send_advs2 = false;
-                g_adv_post_action                         = ADV_POST_ACTION_NONE;
+                g_adv_post_flag_spool_drain_paused        = !flag_success;
                 break;
             case ADV_POST_ACTION_POST_STATS:
                 p_adv_post_state->flag_need_to_send_statistics = false;
-                g_adv_post_action                              = ADV_POST_ACTION_NONE;
                 break;
             default:
                 break;
         }
+    }
+    adv_post_unlock_http_server_mutex_if_idle();
+}
 
-        LOG_DBG("http_server_mutex_unlock");
-        http_server_mutex_unlock();
-
-        ruuvi_log_heap_usage();
+/**
+ * @brief Start the HTTP requests to the targets, which need to be sent and have no request in progress.
+ * @return true if at least one of the targets had to be sent.
+ */
+static bool
+adv_post_do_async_comm_start_requests(adv_post_state_t* const p_adv_post_state)
+{
+    bool flag_attempted = false;
+    if (p_adv_post_state->flag_need_to_send_advs1
+        && (!adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI)))
+    {
+        adv_post_do_async_comm_send_advs1(p_adv_post_state);
+        flag_attempted = true;
     }
-    else
+    if (p_adv_post_state->flag_need_to_send_advs2
+        && (!adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM)))
     {
-        if (!adv_post_do_async_comm_in_progress_mqtt())
-        {
-            LOG_DBG("os_timer_sig_one_shot_start: g_p_adv_post_timer_sig_do_async_comm");
-            adv_post_timers_start_timer_sig_do_async_comm();
-            return false;
-        }
+        adv_post_do_async_comm_send_advs2(p_adv_post_state);
+        flag_attempted = true;
     }
-    return true;
+    if (p_adv_post_state->flag_need_to_send_statistics
+        && (!adv_post_is_action_in_progress(ADV_POST_ACTION_POST_STATS)))
+    {
+        adv_post_do_async_comm_send_statistics(p_adv_post_state);
+        flag_attempted = true;
+    }
+    if ((!flag_attempted) && (ADV_POST_ACTION_NONE == g_adv_post_spool_drain_action)
+        && adv_post_is_spool_drain_allowed(p_adv_post_state))
+    {
+        adv_post_do_async_comm_drain_spool(p_adv_post_state);
+        flag_attempted = true;
+    }
+    return flag_attempted;
 }
 
 void
@@ -371,46 +599,30 @@ adv_post_do_async_comm(adv_post_state_t* const p_adv_post_state)
     LOG_DBG("flag_async_comm_in_progress=%d", p_adv_post_state->flag_async_comm_in_progress);
     if (p_adv_post_state->flag_async_comm_in_progress)
     {
-        if (!adv_post_do_async_comm_in_progress(p_adv_post_state))
+        const http_async_info_t* const p_http_async_info = http_async_poll();
+        if (NULL != p_http_async_info)
         {
-            return;
+            adv_post_handle_completion(p_adv_post_state, p_http_async_info);
+            ruuvi_log_heap_usage();
         }
-        p_adv_post_state->flag_async_comm_in_progress = false;
+        p_adv_post_state->flag_async_comm_in_progress = adv_post_is_any_action_in_progress();
     }
-    if (!p_adv_post_state->flag_relaying_enabled)
+    bool flag_attempted = false;
+    if (p_adv_post_state->flag_relaying_enabled)
     {
-        return;
+        flag_attempted = adv_post_do_async_comm_start_requests(p_adv_post_state);
     }
-    if (p_adv_post_state->flag_need_to_send_advs1)
+    if (p_adv_post_state->flag_async_comm_in_progress || flag_attempted)
     {
-        adv_post_do_async_comm_send_advs1(p_adv_post_state);
+        LOG_DBG("os_timer_sig_one_shot_start: g_p_adv_post_timer_sig_do_async_comm");
         adv_post_timers_start_timer_sig_do_async_comm();
-        return;
-    }
-    if (p_adv_post_state->flag_need_to_send_advs2)
-    {
-        adv_post_do_async_comm_send_advs2(p_adv_post_state);
-        adv_post_timers_start_timer_sig_do_async_comm();
-        return;
-    }
-    if (p_adv_post_state->flag_need_to_send_statistics)
-    {
-        adv_post_do_async_comm_send_statistics(p_adv_post_state);
-        adv_post_timers_start_timer_sig_do_async_comm();
-        return;
-    }
-    if (p_adv_post_state->flag_need_to_send_mqtt_periodic)
-    {
-        adv_post_do_async_comm_start_sending_periodic_mqtt(p_adv_post_state);
-        adv_post_timers_start_timer_sig_do_async_comm();
-        return;
     }
 }
 
 void
-adv_post_set_default_period(const uint32_t period_ms)
+adv_post_set_default_period(const adv_post_action_e action, const uint32_t period_ms)
 {
-    switch (g_adv_post_action)
+    switch (action)
     {
         case ADV_POST_ACTION_NONE:
             break;
@@ -421,16 +633,14 @@ adv_post_set_default_period(const uint32_t period_ms)
             adv2_post_timer_set_default_period_by_server_resp(period_ms);
             break;
         case ADV_POST_ACTION_POST_STATS:
-            ATTR_FALLTHROUGH;
-        case ADV_POST_ACTION_POST_ADVS_TO_MQTT:
             break;
     }
 }
 
 bool
-adv_post_set_hmac_sha256_key(const char* const p_key_str)
+adv_post_set_hmac_sha256_key(const adv_post_action_e action, const char* const p_key_str)
 {
-    switch (g_adv_post_action)
+    switch (action)
     {
         case ADV_POST_ACTION_NONE:
             break;
@@ -443,27 +653,6 @@ adv_post_set_hmac_sha256_key(const char* const p_key_str)
         case ADV_POST_ACTION_POST_STATS:
             LOG_INFO("Ruuvi-HMAC-KEY: Server updated HMAC_SHA256 key for stats");
             return hmac_sha256_set_key_for_stats(p_key_str);
-        case ADV_POST_ACTION_POST_ADVS_TO_MQTT:
-            break;
     }
     return false;
 }
-
-void
-adv_post_set_adv_post_http_action(const bool flag_post_to_ruuvi)
-{
-    if (flag_post_to_ruuvi)
-    {
-        g_adv_post_action = ADV_POST_ACTION_POST_ADVS_TO_RUUVI;
-    }
-    else
-    {
-        g_adv_post_action = ADV_POST_ACTION_POST_ADVS_TO_CUSTOM;
-    }
-}
-
-adv_post_action_e
-adv_post_get_adv_post_action(void)
-{
-    return g_adv_post_action;
-}
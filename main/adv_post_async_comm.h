@@ -21,26 +21,38 @@ typedef enum adv_post_action_e
     ADV_POST_ACTION_POST_ADVS_TO_RUUVI,
     ADV_POST_ACTION_POST_ADVS_TO_CUSTOM,
     ADV_POST_ACTION_POST_STATS,
-    ADV_POST_ACTION_POST_ADVS_TO_MQTT,
 } adv_post_action_e;
 
+#define ADV_POST_ACTION_NUM (ADV_POST_ACTION_POST_STATS + 1)
+
 void
 adv_post_async_comm_init(void);
 
 void
 adv_post_do_async_comm(adv_post_state_t* const p_adv_post_state);
 
+/**
+ * @brief Set the default period of posting advs to the target of the HTTP response (X-Ruuvi-Gateway-Rate).
+ * @param action - the target of the HTTP request to which the response belongs
+ * @param period_ms - the period in milliseconds
+ */
 void
-adv_post_set_default_period(const uint32_t period_ms);
+adv_post_set_default_period(const adv_post_action_e action, const uint32_t period_ms);
 
+/**
+ * @brief Set the HMAC_SHA256 key for the target of the HTTP response (Ruuvi-HMAC-KEY).
+ * @param action - the target of the HTTP request to which the response belongs
+ * @param p_key_str - the key
+ * @return true on success.
+ */
 bool
-adv_post_set_hmac_sha256_key(const char* const p_key_str);
+adv_post_set_hmac_sha256_key(const adv_post_action_e action, const char* const p_key_str);
 
-void
-adv_post_set_adv_post_http_action(const bool flag_post_to_ruuvi);
-
-adv_post_action_e
-adv_post_get_adv_post_action(void);
+/**
+ * @brief Check if the async HTTP request to the target is in progress.
+ */
+bool
+adv_post_is_action_in_progress(const adv_post_action_e action);
 
 #ifdef __cplusplus
 }
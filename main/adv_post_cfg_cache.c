@@ -7,8 +7,10 @@
 
 #include "adv_post_cfg_cache.h"
 #include <stddef.h>
+#include <stdlib.h>
 #include <esp_attr.h>
 #include "os_mutex.h"
+#include "os_malloc.h"
 
 static adv_post_cfg_cache_t g_adv_post_cfg_cache;
 static os_mutex_t IRAM_ATTR g_p_adv_post_cfg_cache_access_mutex;
@@ -63,3 +65,123 @@ adv_post_cfg_cache_mutex_unlock(adv_post_cfg_cache_t** p_p_cfg_cache)
     *p_p_cfg_cache = NULL;
     os_mutex_unlock(g_p_adv_post_cfg_cache_access_mutex);
 }
+
+adv_post_cfg_cache_mac_t
+adv_post_cfg_cache_conv_mac(const mac_address_bin_t* const p_mac_addr)
+{
+    adv_post_cfg_cache_mac_t mac = 0;
+    for (uint32_t i = 0; i < MAC_ADDRESS_NUM_BYTES; ++i)
+    {
+        mac = (mac << 8U) | p_mac_addr->mac[i];
+    }
+    return mac;
+}
+
+static int
+adv_post_cfg_cache_cmp_mac(const void* const p_mac1, const void* const p_mac2)
+{
+    const adv_post_cfg_cache_mac_t mac1 = *(const adv_post_cfg_cache_mac_t*)p_mac1;
+    const adv_post_cfg_cache_mac_t mac2 = *(const adv_post_cfg_cache_mac_t*)p_mac2;
+    if (mac1 < mac2)
+    {
+        return -1;
+    }
+    if (mac1 > mac2)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+void
+adv_post_cfg_cache_scan_filter_clear(adv_post_cfg_cache_t* const p_cfg_cache)
+{
+    p_cfg_cache->scan_filter_length = 0;
+    if (NULL != p_cfg_cache->p_arr_of_scan_filter_mac)
+    {
+        os_free(p_cfg_cache->p_arr_of_scan_filter_mac);
+    }
+}
+
+bool
+adv_post_cfg_cache_scan_filter_set(
+    adv_post_cfg_cache_t* const    p_cfg_cache,
+    const bool                     flag_allow_listed,
+    const mac_address_bin_t* const p_arr_of_mac,
+    const uint32_t                 num_of_macs)
+{
+    adv_post_cfg_cache_scan_filter_clear(p_cfg_cache);
+    p_cfg_cache->scan_filter_allow_listed = flag_allow_listed;
+    if (0 == num_of_macs)
+    {
+        return true;
+    }
+    p_cfg_cache->p_arr_of_scan_filter_mac = os_calloc(num_of_macs, sizeof(*p_cfg_cache->p_arr_of_scan_filter_mac));
+    if (NULL == p_cfg_cache->p_arr_of_scan_filter_mac)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < num_of_macs; ++i)
+    {
+        p_cfg_cache->p_arr_of_scan_filter_mac[i] = adv_post_cfg_cache_conv_mac(&p_arr_of_mac[i]);
+    }
+    qsort(
+        p_cfg_cache->p_arr_of_scan_filter_mac,
+        num_of_macs,
+        sizeof(*p_cfg_cache->p_arr_of_scan_filter_mac),
+        &adv_post_cfg_cache_cmp_mac);
+
+    uint32_t num_of_unique_macs = 1;
+    for (uint32_t i = 1; i < num_of_macs; ++i)
+    {
+        if (p_cfg_cache->p_arr_of_scan_filter_mac[i] != p_cfg_cache->p_arr_of_scan_filter_mac[num_of_unique_macs - 1])
+        {
+            p_cfg_cache->p_arr_of_scan_filter_mac[num_of_unique_macs] = p_cfg_cache->p_arr_of_scan_filter_mac[i];
+            num_of_unique_macs += 1;
+        }
+    }
+    p_cfg_cache->scan_filter_length = num_of_unique_macs;
+    return true;
+}
+
+bool
+adv_post_cfg_cache_scan_filter_contains(
+    const adv_post_cfg_cache_t* const p_cfg_cache,
+    const mac_address_bin_t* const    p_mac_addr)
+{
+    const adv_post_cfg_cache_mac_t mac = adv_post_cfg_cache_conv_mac(p_mac_addr);
+
+    uint32_t idx_begin = 0;
+    uint32_t idx_end   = p_cfg_cache->scan_filter_length;
+    while (idx_begin < idx_end)
+    {
+        const uint32_t                 idx_mid = idx_begin + ((idx_end - idx_begin) / 2);
+        const adv_post_cfg_cache_mac_t mac_mid = p_cfg_cache->p_arr_of_scan_filter_mac[idx_mid];
+        if (mac_mid == mac)
+        {
+            return true;
+        }
+        if (mac_mid < mac)
+        {
+            idx_begin = idx_mid + 1;
+        }
+        else
+        {
+            idx_end = idx_mid;
+        }
+    }
+    return false;
+}
+
+bool
+adv_post_cfg_cache_is_mac_filtered_out(
+    const adv_post_cfg_cache_t* const p_cfg_cache,
+    const mac_address_bin_t* const    p_mac_addr)
+{
+    if (0 == p_cfg_cache->scan_filter_length)
+    {
+        return false;
+    }
+    const bool flag_in_list = adv_post_cfg_cache_scan_filter_contains(p_cfg_cache, p_mac_addr);
+    return p_cfg_cache->scan_filter_allow_listed ? (!flag_in_list) : flag_in_list;
+}
@@ -16,12 +16,18 @@
 extern "C" {
 #endif
 
+/**
+ * @brief MAC address packed into the 48 least significant bits of uint64_t (the first byte of MAC is the most
+ * significant one), so that the scan filter can be sorted and searched using integer comparison.
+ */
+typedef uint64_t adv_post_cfg_cache_mac_t;
+
 typedef struct adv_post_cfg_cache_t
 {
-    bool               flag_use_ntp;
-    bool               scan_filter_allow_listed;
-    uint32_t           scan_filter_length;
-    mac_address_bin_t* p_arr_of_scan_filter_mac;
+    bool                      flag_use_ntp;
+    bool                      scan_filter_allow_listed;
+    uint32_t                  scan_filter_length;
+    adv_post_cfg_cache_mac_t* p_arr_of_scan_filter_mac; //!< sorted in ascending order, without duplicates
 } adv_post_cfg_cache_t;
 
 void
@@ -39,6 +45,53 @@ adv_post_cfg_cache_mutex_lock(void);
 void
 adv_post_cfg_cache_mutex_unlock(adv_post_cfg_cache_t** p_p_cfg_cache);
 
+adv_post_cfg_cache_mac_t
+adv_post_cfg_cache_conv_mac(const mac_address_bin_t* const p_mac_addr);
+
+/**
+ * @brief Replace the scan filter in the cache with the sorted copy of the given list of MAC addresses.
+ * @param p_cfg_cache - ptr to adv_post_cfg_cache_t (must be locked)
+ * @param flag_allow_listed - true if the list contains allowed MAC addresses, false if it contains denied ones
+ * @param p_arr_of_mac - ptr to the array of MAC addresses
+ * @param num_of_macs - number of MAC addresses in the array
+ * @return false if there is not enough memory (the scan filter is cleared in this case).
+ */
+bool
+adv_post_cfg_cache_scan_filter_set(
+    adv_post_cfg_cache_t* const    p_cfg_cache,
+    const bool                     flag_allow_listed,
+    const mac_address_bin_t* const p_arr_of_mac,
+    const uint32_t                 num_of_macs);
+
+/**
+ * @brief Release the scan filter in the cache.
+ * @param p_cfg_cache - ptr to adv_post_cfg_cache_t (must be locked)
+ */
+void
+adv_post_cfg_cache_scan_filter_clear(adv_post_cfg_cache_t* const p_cfg_cache);
+
+/**
+ * @brief Check if MAC address is in the list of the scan filter (binary search).
+ * @param p_cfg_cache - ptr to adv_post_cfg_cache_t (must be locked)
+ * @param p_mac_addr - ptr to MAC address
+ * @return true if MAC address is in the list.
+ */
+bool
+adv_post_cfg_cache_scan_filter_contains(
+    const adv_post_cfg_cache_t* const p_cfg_cache,
+    const mac_address_bin_t* const    p_mac_addr);
+
+/**
+ * @brief Check if the advertisement from the given MAC address should be dropped according to the scan filter.
+ * @param p_cfg_cache - ptr to adv_post_cfg_cache_t (must be locked)
+ * @param p_mac_addr - ptr to MAC address
+ * @return true if the advertisement should be dropped.
+ */
+bool
+adv_post_cfg_cache_is_mac_filtered_out(
+    const adv_post_cfg_cache_t* const p_cfg_cache,
+    const mac_address_bin_t* const    p_mac_addr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,7 +31,6 @@ typedef struct adv_post_state_t
     bool flag_need_to_send_advs1;
     bool flag_need_to_send_advs2;
     bool flag_need_to_send_statistics;
-    bool flag_need_to_send_mqtt_periodic;
     bool flag_relaying_enabled;
     bool flag_use_timestamps;
     bool flag_stop;
@@ -10,6 +10,8 @@
 #include <stdbool.h>
 #include <string.h>
 #include <esp_attr.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
 #include "os_mutex.h"
 #include "os_timer_sig.h"
 #include "ruuvi_endpoint_ca_uart.h"
@@ -30,6 +32,8 @@ static const char TAG[] = "ADV_POST_NRF52";
 #define ADV_POST_NRF52_ACK_TIMEOUT_MS     (100U)
 #define ADV_POST_NRF52_NO_ACK_MAX_CNT     (10)
 
+#define ADV_POST_NRF52_EV_BIT_HW_RESET_OFF (1U << 0U)
+
 typedef struct adv_post_nrf52_cfg_t
 {
     ruuvi_gw_cfg_scan_t   scan;
@@ -43,6 +47,9 @@ typedef struct adv_post_nrf52_cfg_t
 
 static adv_post_nrf52_cfg_t g_adv_post_nrf52_cfg;
 
+static EventGroupHandle_t g_p_adv_post_nrf52_ev_grp;
+static StaticEventGroup_t g_adv_post_nrf52_ev_grp_mem;
+
 static os_task_handle_t IRAM_ATTR g_adv_post_nrf52_task_handle;
 // All functions that send commands to nRF52 must be called from the same thread.
 // So, there is no need to use mutexes to protect the access to the following global variables.
@@ -72,6 +79,18 @@ adv_post_nrf52_is_in_hw_reset_state(void)
     return flag_nrf52_in_hw_reset_state;
 }
 
+void
+adv_post_nrf52_wait_until_hw_reset_off(void)
+{
+    assert(NULL != g_p_adv_post_nrf52_ev_grp);
+    (void)xEventGroupWaitBits(
+        g_p_adv_post_nrf52_ev_grp,
+        ADV_POST_NRF52_EV_BIT_HW_RESET_OFF,
+        pdFALSE,
+        pdTRUE,
+        portMAX_DELAY);
+}
+
 static void
 adv_post_nrf52_cfg_update_cached(const ruuvi_gw_cfg_scan_t* const p_scan, const ruuvi_gw_cfg_filter_t* const p_filter)
 {
@@ -83,6 +102,7 @@ adv_post_nrf52_cfg_update_cached(const ruuvi_gw_cfg_scan_t* const p_scan, const
     g_adv_post_nrf52_cfg.flag_nrf52_configured        = false;
     g_adv_post_nrf52_cfg.flag_nrf52_in_hw_reset_state = false;
     g_adv_post_nrf52_cfg.flag_cfg_ready               = true;
+    (void)xEventGroupSetBits(g_p_adv_post_nrf52_ev_grp, ADV_POST_NRF52_EV_BIT_HW_RESET_OFF);
     os_mutex_unlock(g_adv_post_nrf52_cfg.mutex);
 }
 
@@ -228,6 +248,7 @@ adv_post_nrf52_reset(void)
     g_adv_post_nrf52_led_ctrl_time_interval_ms        = ADV_POST_LED_CTRL_TIME_INTERVAL_INVALID;
     g_adv_post_nrf52_flag_cfg_required                = false;
     g_adv_post_nrf52_is_waiting_ack                   = false;
+    (void)xEventGroupClearBits(g_p_adv_post_nrf52_ev_grp, ADV_POST_NRF52_EV_BIT_HW_RESET_OFF);
     os_mutex_unlock(g_adv_post_nrf52_cfg.mutex);
     LOG_INFO("Start timer nrf52_reset");
     os_timer_sig_one_shot_start(g_adv_post_timer_sig_nrf52_reset);
@@ -242,12 +263,16 @@ adv_post_nrf52_init(void)
     g_adv_post_nrf52_cfg.mutex                 = os_mutex_create_static(&g_adv_post_nrf52_cfg.mutex_mem);
     g_adv_post_nrf52_cfg.flag_nrf52_configured = false;
 
+    // Static creation can't fail, so there is no need to check the result.
+    g_p_adv_post_nrf52_ev_grp = xEventGroupCreateStatic(&g_adv_post_nrf52_ev_grp_mem);
+
     const gw_cfg_t* p_gw_cfg    = gw_cfg_lock_ro();
     g_adv_post_nrf52_cfg.scan   = p_gw_cfg->ruuvi_cfg.scan;
     g_adv_post_nrf52_cfg.filter = p_gw_cfg->ruuvi_cfg.filter;
     gw_cfg_unlock_ro(&p_gw_cfg);
     g_adv_post_nrf52_cfg.flag_cfg_ready               = false;
     g_adv_post_nrf52_cfg.flag_nrf52_in_hw_reset_state = false;
+    (void)xEventGroupSetBits(g_p_adv_post_nrf52_ev_grp, ADV_POST_NRF52_EV_BIT_HW_RESET_OFF);
 
     g_adv_post_nrf52_last_cmd                  = (re_ca_uart_cmd_t)0;
     g_adv_post_nrf52_is_waiting_ack            = false;
@@ -380,6 +405,7 @@ adv_post_nrf52_on_sig_nrf52_hw_reset_off(void)
 
     os_mutex_lock(g_adv_post_nrf52_cfg.mutex);
     g_adv_post_nrf52_cfg.flag_nrf52_in_hw_reset_state = false;
+    (void)xEventGroupSetBits(g_p_adv_post_nrf52_ev_grp, ADV_POST_NRF52_EV_BIT_HW_RESET_OFF);
     os_mutex_unlock(g_adv_post_nrf52_cfg.mutex);
 
     LOG_INFO("Start timer nrf52_cfg_req_timeout");
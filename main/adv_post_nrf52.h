@@ -23,6 +23,12 @@ adv_post_nrf52_init(void);
 bool
 adv_post_nrf52_is_in_hw_reset_state(void);
 
+/**
+ * @brief Block the caller until nRF52 is released from hw_reset state (without polling).
+ */
+void
+adv_post_nrf52_wait_until_hw_reset_off(void);
+
 bool
 adv_post_nrf52_is_configured(void);
 
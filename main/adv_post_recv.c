@@ -0,0 +1,419 @@
+/**
+ * @file adv_post_recv.c
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "adv_post_recv.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <esp_attr.h>
+#include "esp_type_wrapper.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ruuvi_endpoint_ca_uart.h"
+#include "time_task.h"
+#include "metrics.h"
+#include "mac_addr.h"
+#include "event_mgr.h"
+#include "gw_cfg.h"
+#include "adv_table.h"
+#include "adv_ring.h"
+#include "adv_post_signals.h"
+#include "adv_post_timers.h"
+#include "adv_post_cfg_cache.h"
+#include "adv_post_nrf52.h"
+#if defined(RUUVI_TESTS) && RUUVI_TESTS
+#define LOG_LOCAL_DISABLED 1
+#define LOG_LOCAL_LEVEL    LOG_LEVEL_NONE
+#else
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#endif
+#include "log.h"
+static const char TAG[] = "ADV_POST";
+
+#define ADV_POST_RECV_ADVS_BATCH_SIZE (16U)
+
+#define ADV_POST_RECV_ADV_MAX_COALESCING_PERIOD_MS (1000U)
+
+static uint32_t IRAM_ATTR g_adv_post_advs_cnt;
+
+static void
+adv_post_advs_cnt_inc(void)
+{
+    g_adv_post_advs_cnt += 1;
+}
+
+uint32_t
+adv_post_advs_cnt_get_and_clear(void)
+{
+    const uint32_t cnt  = g_adv_post_advs_cnt;
+    g_adv_post_advs_cnt = 0;
+    return cnt;
+}
+
+static bool
+parse_adv_report_from_uart(const re_ca_uart_payload_t* const p_msg, const time_t timestamp, adv_report_t* const p_adv)
+{
+    if (NULL == p_msg)
+    {
+        return false;
+    }
+    if (NULL == p_adv)
+    {
+        return false;
+    }
+    if ((RE_CA_UART_ADV_RPRT != p_msg->cmd) && (RE_CA_UART_ADV_RPRT2 != p_msg->cmd))
+    {
+        return false;
+    }
+    const re_ca_uart_ble_adv_t* const p_report = &(p_msg->params.adv);
+    if (p_report->adv_len > sizeof(p_adv->data_buf))
+    {
+        LOG_ERR(
+            "Got advertisement with len=%u, max allowed len=%u",
+            (unsigned)p_report->adv_len,
+            (unsigned)sizeof(p_adv->data_buf));
+        return false;
+    }
+    if (0 == p_report->adv_len)
+    {
+        LOG_WARN("Got advertisement with zero len");
+        return false;
+    }
+    mac_address_bin_init(&p_adv->tag_mac, p_report->mac);
+    p_adv->timestamp       = timestamp;
+    p_adv->samples_counter = 0;
+    p_adv->rssi            = p_report->rssi_db;
+    p_adv->primary_phy     = p_report->primary_phy;
+    p_adv->secondary_phy   = p_report->secondary_phy;
+    p_adv->ch_index        = p_report->ch_index;
+    p_adv->is_coded_phy    = p_report->is_coded_phy;
+    p_adv->tx_power        = p_report->tx_power;
+    p_adv->data_len        = p_report->adv_len;
+    memcpy(p_adv->data_buf, p_report->adv, p_report->adv_len);
+
+    return true;
+}
+
+static const char*
+ble_phy_to_str(const re_ca_uart_ble_phy_e phy)
+{
+    switch (phy)
+    {
+        case RE_CA_UART_BLE_PHY_1MBPS:
+            return "1M";
+        case RE_CA_UART_BLE_PHY_2MBPS:
+            return "2M";
+        case RE_CA_UART_BLE_PHY_CODED:
+            return "Coded";
+        case RE_CA_UART_BLE_PHY_NOT_SET:
+            return "NA";
+        default:
+            break;
+    }
+    return "UNK";
+}
+
+static const char*
+ble_phy_info_str(
+    const re_ca_uart_ble_phy_e primary_phy,
+    const re_ca_uart_ble_phy_e secondary_phy,
+    const bool                 is_coded_phy)
+{
+    if (is_coded_phy)
+    {
+        if ((RE_CA_UART_BLE_PHY_CODED == primary_phy) && (RE_CA_UART_BLE_PHY_CODED == secondary_phy))
+        {
+            return "Coded";
+        }
+    }
+    else
+    {
+        if ((RE_CA_UART_BLE_PHY_1MBPS == primary_phy) && (RE_CA_UART_BLE_PHY_NOT_SET == secondary_phy))
+        {
+            return "1M";
+        }
+        if ((RE_CA_UART_BLE_PHY_1MBPS == primary_phy) && (RE_CA_UART_BLE_PHY_2MBPS == secondary_phy))
+        {
+            return "2M";
+        }
+    }
+    return NULL;
+}
+
+typedef struct ble_phy_agg_info_str_t
+{
+    char buf[32];
+} ble_phy_agg_info_str_t;
+
+static ble_phy_agg_info_str_t
+ble_phy_agg_info_str(
+    const re_ca_uart_ble_phy_e primary_phy,
+    const re_ca_uart_ble_phy_e secondary_phy,
+    const bool                 is_coded_phy)
+{
+    ble_phy_agg_info_str_t phy_agg_info   = { 0 };
+    const char* const      p_phy_info_str = ble_phy_info_str(primary_phy, secondary_phy, is_coded_phy);
+    if (NULL != p_phy_info_str)
+    {
+        snprintf(phy_agg_info.buf, sizeof(phy_agg_info.buf), "%s", p_phy_info_str);
+    }
+    else
+    {
+        snprintf(
+            phy_agg_info.buf,
+            sizeof(phy_agg_info.buf),
+            "%s/%s(is_coded=%d)",
+            ble_phy_to_str(primary_phy),
+            ble_phy_to_str(secondary_phy),
+            is_coded_phy);
+    }
+    return phy_agg_info;
+}
+
+typedef struct ble_phy_tx_power_str_t
+{
+    char buf[8];
+} ble_phy_tx_power_str_t;
+
+static ble_phy_tx_power_str_t
+ble_tx_power_to_str(const int8_t tx_power)
+{
+    ble_phy_tx_power_str_t tx_power_str = { 0 };
+    if (RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID == tx_power)
+    {
+        snprintf(tx_power_str.buf, sizeof(tx_power_str.buf), "NA");
+    }
+    else
+    {
+        snprintf(tx_power_str.buf, sizeof(tx_power_str.buf), "%d", tx_power);
+    }
+    return tx_power_str;
+}
+
+#define BLE_MSG_CHUNK_LEN_OFFSET                                             (0U)
+#define BLE_MSG_CHUNK_TYPE_OFFSET                                            (1U)
+#define BLE_MSG_CHUNK_TYPE_MANUFACTURED_SPECIFIC_DATA                        (0xFFU)
+#define BLE_MSG_CHUNK_DATA_OFFSET                                            (2U)
+#define BLE_MSG_CHUNK_MANUFACTURED_SPECIFIC_DATA_MIN_LEN                     (3U)
+#define BLE_MSG_CHUNK_MANUFACTURED_SPECIFIC_DATA_MANUFACTURER_ID_LOW_OFFSET  (2U)
+#define BLE_MSG_CHUNK_MANUFACTURED_SPECIFIC_DATA_MANUFACTURER_ID_HIGH_OFFSET (3U)
+#define NUM_BITS_PER_BYTE                                                    (8U)
+
+static uint16_t
+get_ble_manuf_id(const adv_report_t* const p_adv)
+{
+    if (p_adv->data_len < BLE_MSG_CHUNK_DATA_OFFSET)
+    {
+        return 0;
+    }
+    const uint8_t* p_data = p_adv->data_buf;
+    while (((ptrdiff_t)p_adv->data_len - (p_data - p_adv->data_buf)) >= BLE_MSG_CHUNK_DATA_OFFSET)
+    {
+        const uint8_t len  = p_data[BLE_MSG_CHUNK_LEN_OFFSET];
+        const uint8_t type = p_data[BLE_MSG_CHUNK_TYPE_OFFSET];
+        if (BLE_MSG_CHUNK_TYPE_MANUFACTURED_SPECIFIC_DATA != type)
+        {
+            p_data += len + 1;
+            continue;
+        }
+        if (len < BLE_MSG_CHUNK_MANUFACTURED_SPECIFIC_DATA_MIN_LEN)
+        {
+            break;
+        }
+        return (uint16_t)((uint16_t)p_data[BLE_MSG_CHUNK_MANUFACTURED_SPECIFIC_DATA_MANUFACTURER_ID_HIGH_OFFSET] << NUM_BITS_PER_BYTE)
+               | (uint16_t)p_data[BLE_MSG_CHUNK_MANUFACTURED_SPECIFIC_DATA_MANUFACTURER_ID_LOW_OFFSET];
+    }
+    return 0;
+}
+
+#define ADV_POST_MAX_NUM_SCAN_FILTERS_FOR_LOGGING (3U)
+
+static void
+adv_post_log_adv_report(
+    const adv_report_t* const         p_adv,
+    const adv_post_cfg_cache_t* const p_cfg_cache,
+    const time_t                      timestamp)
+{
+#if 1 && LOG_LOCAL_LEVEL < LOG_LEVEL_VERBOSE
+    bool flag_log_single_allowed_mac = false;
+    if (p_cfg_cache->scan_filter_allow_listed && (p_cfg_cache->scan_filter_length > 0)
+        && (p_cfg_cache->scan_filter_length <= ADV_POST_MAX_NUM_SCAN_FILTERS_FOR_LOGGING))
+    {
+        flag_log_single_allowed_mac = adv_post_cfg_cache_scan_filter_contains(p_cfg_cache, &p_adv->tag_mac);
+    }
+
+    if (flag_log_single_allowed_mac)
+    {
+        LOG_DUMP_INFO(
+            p_adv->data_buf,
+            p_adv->data_len,
+            "Recv Adv: MAC=%s, ID=0x%04x, time=%lu, RSSI=%d, PHY=%s, Chan=%d, tx_power=%s",
+            mac_address_to_str(&p_adv->tag_mac).str_buf,
+            get_ble_manuf_id(p_adv),
+            (printf_ulong_t)timestamp,
+            p_adv->rssi,
+            ble_phy_agg_info_str(p_adv->primary_phy, p_adv->secondary_phy, p_adv->is_coded_phy).buf,
+            p_adv->ch_index,
+            ble_tx_power_to_str(p_adv->tx_power).buf);
+    }
+#else
+    LOG_DUMP_VERBOSE(
+        p_adv->data_buf,
+        p_adv->data_len,
+        "Recv Adv: MAC=%s, ID=0x%04x, time=%lu, RSSI=%d, PHY=%s, Chan=%d, tx_power=%s",
+        mac_address_to_str(&p_adv->tag_mac).str_buf,
+        get_ble_manuf_id(p_adv),
+        (printf_ulong_t)timestamp,
+        p_adv->rssi,
+        ble_phy_agg_info_str(p_adv->primary_phy, p_adv->secondary_phy, p_adv->is_coded_phy).buf,
+        p_adv->ch_index,
+        ble_tx_power_to_str(p_adv->tx_power).buf);
+#endif
+}
+
+void
+adv_post_recv_nrf52_cb_on_recv_adv(void* p_arg)
+{
+    LOG_DBG("%s", __func__);
+    if (!adv_post_nrf52_is_configured())
+    {
+        LOG_DBG("Drop adv - nRF52 is not configured");
+        return;
+    }
+    if (!gw_cfg_is_initialized())
+    {
+        LOG_DBG("Drop adv - gw_cfg is not ready yet");
+        return;
+    }
+    adv_post_advs_cnt_inc();
+
+    // If NTP is not used, the timestamp is replaced with the counter of received advertisements by adv_post_task.
+    const time_t timestamp = time_is_synchronized() ? time(NULL) : 0;
+
+    adv_report_t adv_report = { 0 };
+    METRICS_STAGE_BEGIN(METRICS_STAGE_UART_PARSE);
+    const bool flag_parsed = parse_adv_report_from_uart((re_ca_uart_payload_t*)p_arg, timestamp, &adv_report);
+    METRICS_STAGE_END(METRICS_STAGE_UART_PARSE);
+    if (!flag_parsed)
+    {
+        METRICS_PIPELINE_CNT_INC(METRICS_PIPELINE_CNT_UART_PARSE_ERR);
+        LOG_WARN("Drop adv - parsing failed");
+        return;
+    }
+    // It's used to measure the latency of MQTT publications (see metrics_mqtt_publish_latency_add).
+    adv_report.recv_tick = (uint32_t)xTaskGetTickCount();
+
+    bool flag_notify_consumer = false;
+    if (!adv_ring_push(&adv_report, &flag_notify_consumer))
+    {
+        LOG_DBG("Drop adv - adv_ring is full");
+        return;
+    }
+    if (flag_notify_consumer)
+    {
+        adv_post_signals_send_sig(ADV_POST_SIG_RECV_ADV);
+    }
+}
+
+static bool
+adv_post_prepare_adv_for_table(const adv_post_cfg_cache_t* const p_cfg_cache, adv_report_t* const p_adv)
+{
+    const bool flag_ntp_use = p_cfg_cache->flag_use_ntp;
+    if (!flag_ntp_use)
+    {
+        p_adv->timestamp = (time_t)metrics_received_advs_get();
+    }
+
+    adv_post_log_adv_report(p_adv, p_cfg_cache, p_adv->timestamp);
+
+    if (flag_ntp_use && (0 == p_adv->timestamp))
+    {
+        LOG_DBG("Drop adv - time has not yet synchronized");
+        return false;
+    }
+    metrics_received_advs_increment(p_adv->secondary_phy);
+    return true;
+}
+
+static void
+adv_post_handle_batch_of_advs(adv_report_t* const p_arr_of_advs, const uint32_t num_of_advs)
+{
+    adv_post_cfg_cache_t* p_cfg_cache        = adv_post_cfg_cache_mutex_lock();
+    bool                  flag_recv_adv      = false;
+    uint32_t              num_of_advs_to_put = 0;
+    for (uint32_t i = 0; i < num_of_advs; ++i)
+    {
+        adv_report_t* const p_adv = &p_arr_of_advs[i];
+        if (adv_post_cfg_cache_is_mac_filtered_out(p_cfg_cache, &p_adv->tag_mac))
+        {
+            LOG_DBG("Drop adv - MAC is filtered out");
+            METRICS_PIPELINE_CNT_INC(METRICS_PIPELINE_CNT_FILTER_DROPPED);
+            continue;
+        }
+        flag_recv_adv = true;
+        if (!adv_post_prepare_adv_for_table(p_cfg_cache, p_adv))
+        {
+            continue;
+        }
+        if (num_of_advs_to_put != i)
+        {
+            p_arr_of_advs[num_of_advs_to_put] = *p_adv;
+        }
+        num_of_advs_to_put += 1;
+    }
+    adv_post_cfg_cache_mutex_unlock(&p_cfg_cache);
+
+    if (flag_recv_adv)
+    {
+        adv_post_timers_relaunch_timer_sig_recv_adv_timeout();
+    }
+    if (0 == num_of_advs_to_put)
+    {
+        return;
+    }
+    const num_of_advs_t num_of_updated = adv_table_put_batch(p_arr_of_advs, num_of_advs_to_put);
+    if (num_of_updated != num_of_advs_to_put)
+    {
+        LOG_DBG(
+            "Drop %u advs because the same data is already in the buffer",
+            (printf_uint_t)(num_of_advs_to_put - num_of_updated));
+    }
+    if (0 != num_of_updated)
+    {
+        event_mgr_notify(EVENT_MGR_EV_RECV_ADV);
+    }
+}
+
+void
+adv_post_on_recv_advs(void)
+{
+    static adv_report_t g_adv_post_batch_of_advs[ADV_POST_RECV_ADVS_BATCH_SIZE];
+
+    adv_ring_on_consumer_wakeup();
+    for (;;)
+    {
+        const uint32_t num_of_advs = adv_ring_pop_batch(
+            g_adv_post_batch_of_advs,
+            sizeof(g_adv_post_batch_of_advs) / sizeof(g_adv_post_batch_of_advs[0]));
+        if (0 == num_of_advs)
+        {
+            break;
+        }
+        adv_post_handle_batch_of_advs(g_adv_post_batch_of_advs, num_of_advs);
+    }
+}
+
+void
+adv_post_recv_init(void)
+{
+    g_adv_post_advs_cnt = 0;
+    adv_ring_init();
+    // The subscribers of EVENT_MGR_EV_RECV_ADV only need to know that new advertisements have arrived,
+    // so there is no need to notify them about every batch until they have handled the previous notification.
+    event_mgr_set_edge_triggered(EVENT_MGR_EV_RECV_ADV, ADV_POST_RECV_ADV_MAX_COALESCING_PERIOD_MS);
+}
@@ -0,0 +1,42 @@
+/**
+ * @file adv_post_recv.h
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_GATEWAY_ESP_ADV_POST_RECV_H
+#define RUUVI_GATEWAY_ESP_ADV_POST_RECV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void
+adv_post_recv_init(void);
+
+/**
+ * @brief Handle the advertisement report received from nRF52: parse it and push it to the ring of received advs.
+ * @note This function is called from the context of the UART task (registered as AdvReportCallback).
+ * @param p_arg - ptr to re_ca_uart_payload_t
+ */
+void
+adv_post_recv_nrf52_cb_on_recv_adv(void* p_arg);
+
+uint32_t
+adv_post_advs_cnt_get_and_clear(void);
+
+/**
+ * @brief Drain the ring of received advertisements, filter them and put them to adv_table in batches.
+ * @note This function is called from adv_post_task on ADV_POST_SIG_RECV_ADV.
+ */
+void
+adv_post_on_recv_advs(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_ESP_ADV_POST_RECV_H
@@ -18,6 +18,7 @@
 #include "leds.h"
 #include "reset_task.h"
 #include "adv_post.h"
+#include "adv_mqtt.h"
 #include "adv_post_internal.h"
 #include "adv_post_async_comm.h"
 #include "network_timeout.h"
@@ -115,6 +116,7 @@ adv_post_handle_sig_network_disconnected(adv_post_state_t* const p_adv_post_stat
 {
     LOG_INFO("Handle event: NETWORK_DISCONNECTED");
     p_adv_post_state->flag_network_connected = false;
+    http_keep_alive_close_all();
 }
 
 static void
@@ -170,8 +172,8 @@ adv_post_handle_sig_retransmit_mqtt(adv_post_state_t* const p_adv_post_state)
     LOG_INFO("Got ADV_POST_SIG_RETRANSMIT_MQTT");
     if (p_adv_post_state->flag_relaying_enabled && gw_cfg_get_mqtt_use_mqtt())
     {
-        p_adv_post_state->flag_need_to_send_mqtt_periodic = true;
-        os_signal_send(g_p_adv_post_sig, adv_post_conv_to_sig_num(ADV_POST_SIG_DO_ASYNC_COMM));
+        // The advs are published by adv_mqtt task in bursts, so HTTP requests are not delayed by MQTT publications.
+        adv_mqtt_publish_periodic();
     }
 }
 
@@ -201,6 +203,10 @@ adv_post_handle_sig_relaying_mode_changed(adv_post_state_t* const p_adv_post_sta
         LOG_DBG("http_server_mutex_unlock");
         http_server_mutex_unlock();
     }
+    if (!p_adv_post_state->flag_relaying_enabled)
+    {
+        http_keep_alive_close_all();
+    }
     gw_status_clear_http_relaying_cmd();
 }
 
@@ -239,63 +245,29 @@ adv_post_handle_sig_task_watchdog_feed(ATTR_UNUSED adv_post_state_t* const p_adv
     }
 }
 
-static bool
-adv_post_on_gw_cfg_change_handle_scan_filter(
-    adv_post_cfg_cache_t* const             p_cfg_cache,
-    const ruuvi_gw_cfg_scan_filter_t* const p_scan_filter)
-{
-    p_cfg_cache->scan_filter_allow_listed = p_scan_filter->scan_filter_allow_listed;
-
-    if (0 != p_scan_filter->scan_filter_length)
-    {
-        p_cfg_cache->p_arr_of_scan_filter_mac = os_calloc(
-            p_scan_filter->scan_filter_length,
-            sizeof(*p_cfg_cache->p_arr_of_scan_filter_mac));
-        if (NULL == p_cfg_cache->p_arr_of_scan_filter_mac)
-        {
-            LOG_ERR("Can't allocate memory for scan_filter");
-            p_cfg_cache->scan_filter_length = 0;
-            return false;
-        }
-    }
-    if (NULL != p_cfg_cache->p_arr_of_scan_filter_mac)
-    {
-        for (uint32_t i = 0; i < p_scan_filter->scan_filter_length; ++i)
-        {
-            memcpy(
-                &p_cfg_cache->p_arr_of_scan_filter_mac[i],
-                &p_scan_filter->scan_filter_list[i],
-                sizeof(p_cfg_cache->p_arr_of_scan_filter_mac[i]));
-        }
-        p_cfg_cache->scan_filter_length = p_scan_filter->scan_filter_length;
-    }
-    else
-    {
-        p_cfg_cache->scan_filter_length = 0;
-    }
-    return true;
-}
-
 static void
 adv_post_on_gw_cfg_change(adv_post_state_t* const p_adv_post_state)
 {
     p_adv_post_state->flag_use_timestamps = gw_cfg_get_ntp_use();
 
+    // The kept alive connections could be opened to the previously configured targets.
+    http_keep_alive_close_all();
+
     adv_post_cfg_cache_t* p_cfg_cache = adv_post_cfg_cache_mutex_lock();
 
     p_cfg_cache->flag_use_ntp = p_adv_post_state->flag_use_timestamps;
-    if (NULL != p_cfg_cache->p_arr_of_scan_filter_mac)
-    {
-        p_cfg_cache->scan_filter_length = 0;
-        os_free(p_cfg_cache->p_arr_of_scan_filter_mac);
-        p_cfg_cache->p_arr_of_scan_filter_mac = NULL;
-    }
 
-    const gw_cfg_t* p_gw_cfg = gw_cfg_lock_ro();
-    const bool      res = adv_post_on_gw_cfg_change_handle_scan_filter(p_cfg_cache, &p_gw_cfg->ruuvi_cfg.scan_filter);
+    const gw_cfg_t*                         p_gw_cfg      = gw_cfg_lock_ro();
+    const ruuvi_gw_cfg_scan_filter_t* const p_scan_filter = &p_gw_cfg->ruuvi_cfg.scan_filter;
+    const bool                              res           = adv_post_cfg_cache_scan_filter_set(
+        p_cfg_cache,
+        p_scan_filter->scan_filter_allow_listed,
+        p_scan_filter->scan_filter_list,
+        p_scan_filter->scan_filter_length);
     gw_cfg_unlock_ro(&p_gw_cfg);
     if (!res)
     {
+        LOG_ERR("Can't allocate memory for scan_filter");
         gateway_restart("Low memory on gw_cfg_change");
         return;
     }
@@ -410,12 +382,7 @@ adv_post_handle_sig_cfg_mode_activated(ATTR_UNUSED adv_post_state_t* const p_adv
     LOG_INFO("Update network watchdog timestamp");
     network_timeout_update_timestamp();
     adv_post_cfg_cache_t* p_cfg_cache = adv_post_cfg_cache_mutex_lock();
-    if (NULL != p_cfg_cache->p_arr_of_scan_filter_mac)
-    {
-        p_cfg_cache->scan_filter_length = 0;
-        os_free(p_cfg_cache->p_arr_of_scan_filter_mac);
-        p_cfg_cache->p_arr_of_scan_filter_mac = NULL;
-    }
+    adv_post_cfg_cache_scan_filter_clear(p_cfg_cache);
     adv_post_cfg_cache_mutex_unlock(&p_cfg_cache);
 
     LOG_INFO("Clear adv_table");
@@ -514,6 +481,12 @@ adv_post_handle_sig_recv_adv_timeout(ATTR_UNUSED adv_post_state_t* const p_adv_p
     event_mgr_notify(EVENT_MGR_EV_RECV_ADV_TIMEOUT);
 }
 
+static void
+adv_post_handle_sig_recv_adv(ATTR_UNUSED adv_post_state_t* const p_adv_post_state) // NOSONAR
+{
+    adv_post_on_recv_advs();
+}
+
 bool
 adv_post_handle_sig(const adv_post_sig_e adv_post_sig, adv_post_state_t* const p_adv_post_state)
 {
@@ -547,6 +520,7 @@ adv_post_handle_sig(const adv_post_sig_e adv_post_sig, adv_post_state_t* const p
         [ADV_POST_SIG_GREEN_LED_STATE_CHANGED] = &adv_post_handle_sig_green_led_state_changed,
         [ADV_POST_SIG_GREEN_LED_UPDATE]        = &adv_post_handle_sig_green_led_update,
         [ADV_POST_SIG_RECV_ADV_TIMEOUT]        = &adv_post_handle_sig_recv_adv_timeout,
+        [ADV_POST_SIG_RECV_ADV]                = &adv_post_handle_sig_recv_adv,
     };
 
     assert(adv_post_sig < OS_ARRAY_SIZE(g_adv_post_sig_handlers));
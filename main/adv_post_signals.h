@@ -45,10 +45,11 @@ typedef enum adv_post_sig_e
     ADV_POST_SIG_GREEN_LED_STATE_CHANGED = OS_SIGNAL_NUM_25,
     ADV_POST_SIG_GREEN_LED_UPDATE        = OS_SIGNAL_NUM_26,
     ADV_POST_SIG_RECV_ADV_TIMEOUT        = OS_SIGNAL_NUM_27,
+    ADV_POST_SIG_RECV_ADV                = OS_SIGNAL_NUM_28,
 } adv_post_sig_e;
 
 #define ADV_POST_SIG_FIRST (ADV_POST_SIG_STOP)
-#define ADV_POST_SIG_LAST  (ADV_POST_SIG_RECV_ADV_TIMEOUT)
+#define ADV_POST_SIG_LAST  (ADV_POST_SIG_RECV_ADV)
 
 ATTR_PURE
 os_signal_num_e
@@ -76,7 +76,10 @@ adv_post_statistics_info_generate(const str_buf_t* const p_reset_info)
 }
 
 static bool
-adv_post_stat(const ruuvi_gw_cfg_http_stat_t* const p_cfg_http_stat, void* const p_user_data)
+adv_post_stat(
+    http_async_info_t* const              p_http_async_info,
+    const ruuvi_gw_cfg_http_stat_t* const p_cfg_http_stat,
+    void* const                           p_user_data)
 {
     log_runtime_statistics();
 
@@ -105,6 +108,7 @@ adv_post_stat(const ruuvi_gw_cfg_http_stat_t* const p_cfg_http_stat, void* const
     }
 
     const bool res = http_post_stat(
+        p_http_async_info,
         p_stat_info,
         p_reports,
         p_cfg_http_stat,
@@ -119,7 +123,7 @@ adv_post_stat(const ruuvi_gw_cfg_http_stat_t* const p_cfg_http_stat, void* const
 }
 
 bool
-adv_post_statistics_do_send(void)
+adv_post_statistics_do_send(http_async_info_t* const p_http_async_info)
 {
     const ruuvi_gw_cfg_http_stat_t* p_cfg_http_stat = gw_cfg_get_http_stat_copy();
     if (NULL == p_cfg_http_stat)
@@ -127,7 +131,7 @@ adv_post_statistics_do_send(void)
         LOG_ERR("%s failed", "gw_cfg_get_http_copy");
         return false;
     }
-    const bool res = adv_post_stat(p_cfg_http_stat, NULL);
+    const bool res = adv_post_stat(p_http_async_info, p_cfg_http_stat, NULL);
     os_free(p_cfg_http_stat);
 
     return res;
@@ -11,6 +11,7 @@
 #include <stdbool.h>
 #include "http_json.h"
 #include "os_str.h"
+#include "http.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,8 +20,12 @@ extern "C" {
 void
 adv_post_statistics_init(void);
 
+/**
+ * @brief Send the statistics asynchronously using the slot acquired by http_async_slot_acquire.
+ * @return false if the request was not started, in this case the slot must be released by the caller.
+ */
 bool
-adv_post_statistics_do_send(void);
+adv_post_statistics_do_send(http_async_info_t* const p_http_async_info);
 
 http_json_statistics_info_t*
 adv_post_statistics_info_generate(const str_buf_t* const p_reset_info);
@@ -65,16 +65,15 @@ adv_post_task(void)
     adv_post_wdt_add_and_start();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = false,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = false,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = false,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = false,
+        .flag_stop                      = false,
     };
 
     while (!adv_post_state.flag_stop)
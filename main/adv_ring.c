@@ -0,0 +1,96 @@
+/**
+ * @file adv_ring.c
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "adv_ring.h"
+#include <stdatomic.h>
+
+#define ADV_RING_IDX_MASK (ADV_RING_SIZE - 1U)
+
+// head and tail are free-running counters, the index in g_adv_ring_buf is obtained by masking them.
+// head is written only by the producer, tail - only by the consumer.
+static adv_report_t g_adv_ring_buf[ADV_RING_SIZE];
+static atomic_uint  g_adv_ring_head;
+static atomic_uint  g_adv_ring_tail;
+static atomic_bool  g_adv_ring_flag_consumer_notified;
+static atomic_uint  g_adv_ring_high_water_mark;
+static atomic_uint  g_adv_ring_overflow_cnt;
+
+void
+adv_ring_init(void)
+{
+    atomic_store(&g_adv_ring_head, 0U);
+    atomic_store(&g_adv_ring_tail, 0U);
+    atomic_store(&g_adv_ring_flag_consumer_notified, false);
+    atomic_store(&g_adv_ring_high_water_mark, 0U);
+    atomic_store(&g_adv_ring_overflow_cnt, 0U);
+}
+
+bool
+adv_ring_push(const adv_report_t* const p_adv, bool* const p_flag_notify_consumer)
+{
+    *p_flag_notify_consumer = false;
+
+    const uint32_t head = (uint32_t)atomic_load(&g_adv_ring_head);
+    const uint32_t tail = (uint32_t)atomic_load(&g_adv_ring_tail);
+    if ((uint32_t)(head - tail) >= ADV_RING_SIZE)
+    {
+        atomic_fetch_add(&g_adv_ring_overflow_cnt, 1U);
+        return false;
+    }
+    g_adv_ring_buf[head & ADV_RING_IDX_MASK] = *p_adv;
+    atomic_store(&g_adv_ring_head, head + 1U);
+
+    const uint32_t num_of_advs = (uint32_t)(head + 1U - tail);
+    if (num_of_advs > (uint32_t)atomic_load(&g_adv_ring_high_water_mark))
+    {
+        atomic_store(&g_adv_ring_high_water_mark, num_of_advs);
+    }
+
+    // The flag is set after publishing the new head, so if the consumer has already acknowledged
+    // the previous notification, then either it sees the new head or it gets a new notification.
+    if (!atomic_exchange(&g_adv_ring_flag_consumer_notified, true))
+    {
+        *p_flag_notify_consumer = true;
+    }
+    return true;
+}
+
+void
+adv_ring_on_consumer_wakeup(void)
+{
+    atomic_store(&g_adv_ring_flag_consumer_notified, false);
+}
+
+uint32_t
+adv_ring_pop_batch(adv_report_t* const p_arr_of_advs, const uint32_t max_num_of_advs)
+{
+    const uint32_t tail        = (uint32_t)atomic_load(&g_adv_ring_tail);
+    const uint32_t head        = (uint32_t)atomic_load(&g_adv_ring_head);
+    uint32_t       num_of_advs = (uint32_t)(head - tail);
+    if (num_of_advs > max_num_of_advs)
+    {
+        num_of_advs = max_num_of_advs;
+    }
+    for (uint32_t i = 0; i < num_of_advs; ++i)
+    {
+        p_arr_of_advs[i] = g_adv_ring_buf[(tail + i) & ADV_RING_IDX_MASK];
+    }
+    atomic_store(&g_adv_ring_tail, tail + num_of_advs);
+    return num_of_advs;
+}
+
+uint32_t
+adv_ring_get_high_water_mark(void)
+{
+    return (uint32_t)atomic_load(&g_adv_ring_high_water_mark);
+}
+
+uint32_t
+adv_ring_get_overflow_cnt(void)
+{
+    return (uint32_t)atomic_load(&g_adv_ring_overflow_cnt);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file adv_ring.h
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ * @brief Lock-free single-producer/single-consumer ring of received advertisements.
+ *
+ * The producer is the nRF52 UART callback which only parses advertisements and pushes them into the ring,
+ * the consumer is adv_post_task which drains the ring in batches and puts advertisements to adv_table.
+ * The producer must notify the consumer when adv_ring_push requests it, the consumer must call
+ * adv_ring_on_consumer_wakeup before draining the ring - this guarantees that no advertisement
+ * remains in the ring without a pending notification.
+ */
+
+#ifndef RUUVI_GATEWAY_ESP_ADV_RING_H
+#define RUUVI_GATEWAY_ESP_ADV_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "adv_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of advertisements which can be buffered while adv_post_task is busy.
+ * @note adv_post_task also generates JSON/CBOR, calculates HMAC and starts HTTP POSTs, so the ring must hold
+ *       all the advertisements received during the worst-case time of this work (about 2 seconds for the full
+ *       adv_table with ~100 advertisements per second). The size can be changed with RUUVI_ADV_RING_SIZE,
+ *       each slot takes sizeof(adv_report_t) bytes of RAM (72 bytes on ESP32).
+ */
+#if !defined(ADV_RING_SIZE)
+#define ADV_RING_SIZE (256U)
+#endif
+
+#if (0U != (ADV_RING_SIZE & (ADV_RING_SIZE - 1U)))
+#error ADV_RING_SIZE must be a power of two
+#endif
+
+/**
+ * @brief Reset the ring and its counters.
+ * @note Must be called before the producer and the consumer are started.
+ */
+void
+adv_ring_init(void);
+
+/**
+ * @brief Push an advertisement to the ring (called by the producer).
+ * @param p_adv - ptr to the advertisement
+ * @param[out] p_flag_notify_consumer - set to true if the consumer needs to be notified
+ * @return true if the advertisement was pushed, false if the ring is full (the overflow counter is incremented).
+ */
+bool
+adv_ring_push(const adv_report_t* const p_adv, bool* const p_flag_notify_consumer);
+
+/**
+ * @brief Acknowledge the notification from the producer (called by the consumer before draining the ring).
+ */
+void
+adv_ring_on_consumer_wakeup(void);
+
+/**
+ * @brief Pop up to max_num_of_advs advertisements from the ring (called by the consumer).
+ * @param[out] p_arr_of_advs - ptr to the array to copy the advertisements to
+ * @param max_num_of_advs - size of the array
+ * @return number of advertisements copied to the array, 0 if the ring is empty.
+ */
+uint32_t
+adv_ring_pop_batch(adv_report_t* const p_arr_of_advs, const uint32_t max_num_of_advs);
+
+/**
+ * @brief Get the maximum number of advertisements which were in the ring simultaneously since adv_ring_init.
+ */
+uint32_t
+adv_ring_get_high_water_mark(void);
+
+/**
+ * @brief Get the number of advertisements dropped because the ring was full since adv_ring_init.
+ */
+uint32_t
+adv_ring_get_overflow_cnt(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_ESP_ADV_RING_H
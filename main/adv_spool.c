@@ -0,0 +1,840 @@
+/**
+ * @file adv_spool.c
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "adv_spool.h"
+#include <stddef.h>
+#include <string.h>
+#include "esp_partition.h"
+#include "esp32/rom/crc.h"
+#include "os_mutex.h"
+#include "os_malloc.h"
+
+#if defined(RUUVI_TESTS) && RUUVI_TESTS
+#define LOG_LOCAL_DISABLED 1
+#define LOG_LOCAL_LEVEL    LOG_LEVEL_NONE
+#else
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#endif
+#include "log.h"
+
+#define ADV_SPOOL_SECTOR_SIZE  (4096U)
+#define ADV_SPOOL_SECTOR_MAGIC (0x4C4F5053U) // "SPOL"
+
+#define ADV_SPOOL_REC_LEN_FREE       (0xFFFFU) //<! The rest of the sector has not been written yet
+#define ADV_SPOOL_REC_STATE_WRITTEN  (0xFEU)
+#define ADV_SPOOL_REC_STATE_CONSUMED (0xFCU)
+#define ADV_SPOOL_REC_ALIGNMENT      (4U)
+
+#define ADV_SPOOL_ADV_HDR_SIZE          (20U)
+#define ADV_SPOOL_ADV_PHY_SHIFT         (4U)
+#define ADV_SPOOL_ADV_PHY_MASK          (0x0FU)
+#define ADV_SPOOL_ADV_FLAG_IS_CODED_PHY (0x01U)
+
+#define ADV_SPOOL_NUM_BITS_PER_BYTE (8U)
+#define ADV_SPOOL_BYTE_MASK         (0xFFU)
+
+#define ADV_SPOOL_REC_MAX_PAYLOAD_SIZE (ADV_SPOOL_MAX_ADVS_PER_RECORD * (ADV_SPOOL_ADV_HDR_SIZE + ADV_DATA_MAX_LEN))
+
+#define ADV_SPOOL_MIN_NUM_SECTORS (2U)
+
+typedef struct adv_spool_sector_hdr_t
+{
+    uint32_t magic;
+    uint32_t seq_num; //<! Incremented for every newly opened sector, the ring is restored by the sequence numbers
+    uint32_t crc;     //<! CRC32 of magic and seq_num
+} adv_spool_sector_hdr_t;
+
+typedef struct adv_spool_rec_hdr_t
+{
+    uint16_t len;   //<! Length of the payload or ADV_SPOOL_REC_LEN_FREE
+    uint8_t  state; //<! ADV_SPOOL_REC_STATE_WRITTEN or ADV_SPOOL_REC_STATE_CONSUMED
+    uint8_t  target;
+    uint16_t num_of_advs;
+    uint16_t reserved;
+    uint32_t crc; //<! CRC32 of the payload
+} adv_spool_rec_hdr_t;
+
+_Static_assert(
+    (sizeof(adv_spool_sector_hdr_t) + sizeof(adv_spool_rec_hdr_t) + ADV_SPOOL_REC_MAX_PAYLOAD_SIZE)
+        <= ADV_SPOOL_SECTOR_SIZE,
+    "The maximum record does not fit into a sector");
+
+typedef struct adv_spool_rec_t
+{
+    adv_spool_rec_hdr_t hdr;
+    uint8_t             payload[ADV_SPOOL_REC_MAX_PAYLOAD_SIZE + ADV_SPOOL_REC_ALIGNMENT];
+} adv_spool_rec_t;
+
+typedef struct adv_spool_pos_t
+{
+    uint32_t sector_idx;
+    uint32_t offset;
+} adv_spool_pos_t;
+
+typedef struct adv_spool_t
+{
+    const esp_partition_t* p_partition;
+    uint32_t               num_sectors;
+    uint32_t               write_seq_num; //<! Sequence number of the sector at pos_write
+    adv_spool_pos_t        pos_write;     //<! Position of the next record to write
+    adv_spool_pos_t        pos_read;      //<! Position of the oldest record which has not been consumed
+    adv_spool_stat_t       stat;
+} adv_spool_t;
+
+static const char TAG[] = "ADV_SPOOL";
+
+static adv_spool_t       g_adv_spool;
+static os_mutex_t        g_p_adv_spool_mutex;
+static os_mutex_static_t g_adv_spool_mutex_mem;
+
+static uint32_t
+adv_spool_get_sector_addr(const uint32_t sector_idx)
+{
+    return sector_idx * ADV_SPOOL_SECTOR_SIZE;
+}
+
+static uint32_t
+adv_spool_get_rec_size(const uint32_t payload_len)
+{
+    const uint32_t size = (uint32_t)sizeof(adv_spool_rec_hdr_t) + payload_len;
+    return (size + ADV_SPOOL_REC_ALIGNMENT - 1U) & ~(ADV_SPOOL_REC_ALIGNMENT - 1U);
+}
+
+static bool
+adv_spool_pos_is_equal(const adv_spool_pos_t* const p_pos1, const adv_spool_pos_t* const p_pos2)
+{
+    return (p_pos1->sector_idx == p_pos2->sector_idx) && (p_pos1->offset == p_pos2->offset);
+}
+
+static bool
+adv_spool_is_empty_unsafe(void)
+{
+    return adv_spool_pos_is_equal(&g_adv_spool.pos_read, &g_adv_spool.pos_write);
+}
+
+static uint32_t
+adv_spool_calc_sector_hdr_crc(const adv_spool_sector_hdr_t* const p_hdr)
+{
+    return crc32_le(0, (const uint8_t*)p_hdr, offsetof(adv_spool_sector_hdr_t, crc));
+}
+
+static bool
+adv_spool_read_sector_hdr(const uint32_t sector_idx, adv_spool_sector_hdr_t* const p_hdr)
+{
+    const esp_err_t err = esp_partition_read(
+        g_adv_spool.p_partition,
+        adv_spool_get_sector_addr(sector_idx),
+        p_hdr,
+        sizeof(*p_hdr));
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_partition_read");
+        return false;
+    }
+    return (ADV_SPOOL_SECTOR_MAGIC == p_hdr->magic) && (adv_spool_calc_sector_hdr_crc(p_hdr) == p_hdr->crc);
+}
+
+static bool
+adv_spool_read_rec_hdr(const adv_spool_pos_t* const p_pos, adv_spool_rec_hdr_t* const p_hdr)
+{
+    if ((p_pos->offset + sizeof(*p_hdr)) > ADV_SPOOL_SECTOR_SIZE)
+    {
+        p_hdr->len = ADV_SPOOL_REC_LEN_FREE;
+        return true;
+    }
+    const esp_err_t err = esp_partition_read(
+        g_adv_spool.p_partition,
+        adv_spool_get_sector_addr(p_pos->sector_idx) + p_pos->offset,
+        p_hdr,
+        sizeof(*p_hdr));
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_partition_read");
+        return false;
+    }
+    return true;
+}
+
+static bool
+adv_spool_is_rec_hdr_valid(const adv_spool_pos_t* const p_pos, const adv_spool_rec_hdr_t* const p_hdr)
+{
+    if ((p_hdr->len > ADV_SPOOL_REC_MAX_PAYLOAD_SIZE) || (p_hdr->num_of_advs > ADV_SPOOL_MAX_ADVS_PER_RECORD))
+    {
+        return false;
+    }
+    if ((p_pos->offset + adv_spool_get_rec_size(p_hdr->len)) > ADV_SPOOL_SECTOR_SIZE)
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Get the sequence number of the sector at the read position.
+ * @note The sectors from the read position to the write position have consecutive sequence numbers.
+ */
+static uint32_t
+adv_spool_get_read_seq_num_unsafe(void)
+{
+    const uint32_t num_sectors_ahead = (g_adv_spool.pos_write.sector_idx + g_adv_spool.num_sectors
+                                        - g_adv_spool.pos_read.sector_idx)
+                                       % g_adv_spool.num_sectors;
+    return g_adv_spool.write_seq_num - num_sectors_ahead;
+}
+
+static void
+adv_spool_pos_set_to_next_sector(adv_spool_pos_t* const p_pos)
+{
+    p_pos->sector_idx = (p_pos->sector_idx + 1U) % g_adv_spool.num_sectors;
+    p_pos->offset     = sizeof(adv_spool_sector_hdr_t);
+}
+
+/**
+ * @brief Move the read position over the consumed records to the oldest record which has not been consumed.
+ */
+static void
+adv_spool_skip_consumed_unsafe(void)
+{
+    adv_spool_pos_t* const p_pos = &g_adv_spool.pos_read;
+    while (!adv_spool_is_empty_unsafe())
+    {
+        adv_spool_rec_hdr_t hdr = { 0 };
+        if (!adv_spool_read_rec_hdr(p_pos, &hdr))
+        {
+            *p_pos = g_adv_spool.pos_write;
+            break;
+        }
+        if ((ADV_SPOOL_REC_LEN_FREE == hdr.len) || (!adv_spool_is_rec_hdr_valid(p_pos, &hdr)))
+        {
+            if (p_pos->sector_idx == g_adv_spool.pos_write.sector_idx)
+            {
+                // The sector which is being written is corrupted
+                *p_pos = g_adv_spool.pos_write;
+                break;
+            }
+            adv_spool_pos_set_to_next_sector(p_pos);
+            continue;
+        }
+        if (ADV_SPOOL_REC_STATE_WRITTEN == hdr.state)
+        {
+            break;
+        }
+        p_pos->offset += adv_spool_get_rec_size(hdr.len);
+    }
+}
+
+/**
+ * @brief Count the advertisements in the records which have not been consumed yet in the sector,
+ *        starting from the read position.
+ */
+static uint32_t
+adv_spool_count_unconsumed_advs_in_sector(const adv_spool_pos_t* const p_pos_start)
+{
+    adv_spool_pos_t pos         = *p_pos_start;
+    uint32_t        num_of_advs = 0;
+    for (;;)
+    {
+        adv_spool_rec_hdr_t hdr = { 0 };
+        if ((!adv_spool_read_rec_hdr(&pos, &hdr)) || (ADV_SPOOL_REC_LEN_FREE == hdr.len)
+            || (!adv_spool_is_rec_hdr_valid(&pos, &hdr)))
+        {
+            break;
+        }
+        if (ADV_SPOOL_REC_STATE_WRITTEN == hdr.state)
+        {
+            num_of_advs += hdr.num_of_advs;
+        }
+        pos.offset += adv_spool_get_rec_size(hdr.len);
+    }
+    return num_of_advs;
+}
+
+static bool
+adv_spool_open_sector(const uint32_t sector_idx, const uint32_t seq_num)
+{
+    const uint32_t sector_addr = adv_spool_get_sector_addr(sector_idx);
+
+    esp_err_t err = esp_partition_erase_range(g_adv_spool.p_partition, sector_addr, ADV_SPOOL_SECTOR_SIZE);
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_partition_erase_range");
+        return false;
+    }
+    adv_spool_sector_hdr_t hdr = {
+        .magic   = ADV_SPOOL_SECTOR_MAGIC,
+        .seq_num = seq_num,
+        .crc     = 0,
+    };
+    hdr.crc = adv_spool_calc_sector_hdr_crc(&hdr);
+    err     = esp_partition_write(g_adv_spool.p_partition, sector_addr, &hdr, sizeof(hdr));
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_partition_write");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Erase the next sector and start writing to it.
+ * @note If the ring is full, then the oldest sector is overwritten and its advertisements are dropped.
+ */
+static bool
+adv_spool_open_next_sector_unsafe(void)
+{
+    const bool     flag_empty      = adv_spool_is_empty_unsafe();
+    const uint32_t next_sector_idx = (g_adv_spool.pos_write.sector_idx + 1U) % g_adv_spool.num_sectors;
+    if ((!flag_empty) && (next_sector_idx == g_adv_spool.pos_read.sector_idx))
+    {
+        const uint32_t num_dropped = adv_spool_count_unconsumed_advs_in_sector(&g_adv_spool.pos_read);
+        LOG_WARN("Spool is full, drop the oldest sector with %u advs", (printf_uint_t)num_dropped);
+        g_adv_spool.stat.num_dropped_advs += num_dropped;
+        adv_spool_pos_set_to_next_sector(&g_adv_spool.pos_read);
+    }
+    g_adv_spool.write_seq_num += 1;
+    g_adv_spool.pos_write.sector_idx = next_sector_idx;
+    g_adv_spool.pos_write.offset     = sizeof(adv_spool_sector_hdr_t);
+    if (flag_empty)
+    {
+        g_adv_spool.pos_read = g_adv_spool.pos_write;
+    }
+    if (!adv_spool_open_sector(next_sector_idx, g_adv_spool.write_seq_num))
+    {
+        // Do not write to the sector in unknown state, try the next sector next time.
+        g_adv_spool.pos_write.offset = ADV_SPOOL_SECTOR_SIZE;
+        if (flag_empty)
+        {
+            g_adv_spool.pos_read = g_adv_spool.pos_write;
+        }
+        return false;
+    }
+    adv_spool_skip_consumed_unsafe();
+    return true;
+}
+
+/**
+ * @brief Find the offset of the first free record in the sector.
+ */
+static uint32_t
+adv_spool_find_free_offset_in_sector(const uint32_t sector_idx)
+{
+    adv_spool_pos_t pos = {
+        .sector_idx = sector_idx,
+        .offset     = sizeof(adv_spool_sector_hdr_t),
+    };
+    for (;;)
+    {
+        adv_spool_rec_hdr_t hdr = { 0 };
+        if (!adv_spool_read_rec_hdr(&pos, &hdr))
+        {
+            return ADV_SPOOL_SECTOR_SIZE;
+        }
+        if (ADV_SPOOL_REC_LEN_FREE == hdr.len)
+        {
+            return pos.offset;
+        }
+        if (!adv_spool_is_rec_hdr_valid(&pos, &hdr))
+        {
+            // The header was damaged by a power loss, do not append to this sector anymore.
+            return ADV_SPOOL_SECTOR_SIZE;
+        }
+        pos.offset += adv_spool_get_rec_size(hdr.len);
+    }
+}
+
+/**
+ * @brief Restore the write and read positions by scanning the sector headers.
+ */
+static bool
+adv_spool_mount_unsafe(void)
+{
+    bool     flag_found        = false;
+    uint32_t newest_sector_idx = 0;
+    uint32_t newest_seq_num    = 0;
+    for (uint32_t i = 0; i < g_adv_spool.num_sectors; ++i)
+    {
+        adv_spool_sector_hdr_t hdr = { 0 };
+        if (adv_spool_read_sector_hdr(i, &hdr) && ((!flag_found) || (hdr.seq_num > newest_seq_num)))
+        {
+            flag_found        = true;
+            newest_sector_idx = i;
+            newest_seq_num    = hdr.seq_num;
+        }
+    }
+    if (!flag_found)
+    {
+        LOG_INFO("Spool is empty, format it");
+        g_adv_spool.write_seq_num        = 1;
+        g_adv_spool.pos_write.sector_idx = 0;
+        g_adv_spool.pos_write.offset     = sizeof(adv_spool_sector_hdr_t);
+        g_adv_spool.pos_read             = g_adv_spool.pos_write;
+        return adv_spool_open_sector(0, g_adv_spool.write_seq_num);
+    }
+
+    // Walk backward over the sectors with the consecutive sequence numbers to find the oldest one.
+    uint32_t oldest_sector_idx = newest_sector_idx;
+    uint32_t oldest_seq_num    = newest_seq_num;
+    for (uint32_t i = 1; i < g_adv_spool.num_sectors; ++i)
+    {
+        const uint32_t         prev_sector_idx = (oldest_sector_idx + g_adv_spool.num_sectors - 1U)
+                                         % g_adv_spool.num_sectors;
+        adv_spool_sector_hdr_t hdr             = { 0 };
+        if ((!adv_spool_read_sector_hdr(prev_sector_idx, &hdr)) || ((hdr.seq_num + 1U) != oldest_seq_num))
+        {
+            break;
+        }
+        oldest_sector_idx = prev_sector_idx;
+        oldest_seq_num    = hdr.seq_num;
+    }
+
+    g_adv_spool.write_seq_num        = newest_seq_num;
+    g_adv_spool.pos_write.sector_idx = newest_sector_idx;
+    g_adv_spool.pos_write.offset     = adv_spool_find_free_offset_in_sector(newest_sector_idx);
+    g_adv_spool.pos_read.sector_idx  = oldest_sector_idx;
+    g_adv_spool.pos_read.offset      = sizeof(adv_spool_sector_hdr_t);
+    adv_spool_skip_consumed_unsafe();
+    LOG_INFO(
+        "Spool mounted: sectors %u..%u, seq_num %u",
+        (printf_uint_t)oldest_sector_idx,
+        (printf_uint_t)newest_sector_idx,
+        (printf_uint_t)newest_seq_num);
+    return true;
+}
+
+static uint32_t
+adv_spool_calc_used_bytes_unsafe(void)
+{
+    const adv_spool_pos_t* const p_read  = &g_adv_spool.pos_read;
+    const adv_spool_pos_t* const p_write = &g_adv_spool.pos_write;
+    if (adv_spool_is_empty_unsafe())
+    {
+        return 0;
+    }
+    if ((p_read->sector_idx == p_write->sector_idx) && (p_read->offset <= p_write->offset))
+    {
+        return p_write->offset - p_read->offset;
+    }
+    const uint32_t num_full_sectors = (p_write->sector_idx + g_adv_spool.num_sectors - p_read->sector_idx - 1U)
+                                      % g_adv_spool.num_sectors;
+    return (ADV_SPOOL_SECTOR_SIZE - p_read->offset) + (num_full_sectors * ADV_SPOOL_SECTOR_SIZE) + p_write->offset;
+}
+
+bool
+adv_spool_init(void)
+{
+    if (!ADV_SPOOL_ENABLED)
+    {
+        return false;
+    }
+    if (NULL == g_p_adv_spool_mutex)
+    {
+        g_p_adv_spool_mutex = os_mutex_create_static(&g_adv_spool_mutex_mem);
+    }
+    os_mutex_lock(g_p_adv_spool_mutex);
+    memset(&g_adv_spool, 0, sizeof(g_adv_spool));
+    const esp_partition_t* const p_partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA,
+        ESP_PARTITION_SUBTYPE_ANY,
+        ADV_SPOOL_PARTITION_LABEL);
+    if (NULL == p_partition)
+    {
+        LOG_WARN("Partition '%s' not found, the spool is disabled", ADV_SPOOL_PARTITION_LABEL);
+        os_mutex_unlock(g_p_adv_spool_mutex);
+        return false;
+    }
+    const uint32_t num_sectors = p_partition->size / ADV_SPOOL_SECTOR_SIZE;
+    if (num_sectors < ADV_SPOOL_MIN_NUM_SECTORS)
+    {
+        LOG_ERR("Partition '%s' is too small: %u bytes", ADV_SPOOL_PARTITION_LABEL, (printf_uint_t)p_partition->size);
+        os_mutex_unlock(g_p_adv_spool_mutex);
+        return false;
+    }
+    g_adv_spool.p_partition     = p_partition;
+    g_adv_spool.num_sectors     = num_sectors;
+    g_adv_spool.stat.size_bytes = num_sectors * ADV_SPOOL_SECTOR_SIZE;
+    if (!adv_spool_mount_unsafe())
+    {
+        LOG_ERR("Failed to mount the spool");
+        memset(&g_adv_spool, 0, sizeof(g_adv_spool));
+        os_mutex_unlock(g_p_adv_spool_mutex);
+        return false;
+    }
+    os_mutex_unlock(g_p_adv_spool_mutex);
+    return true;
+}
+
+void
+adv_spool_deinit(void)
+{
+    if (NULL == g_p_adv_spool_mutex)
+    {
+        return;
+    }
+    os_mutex_lock(g_p_adv_spool_mutex);
+    memset(&g_adv_spool, 0, sizeof(g_adv_spool));
+    os_mutex_unlock(g_p_adv_spool_mutex);
+}
+
+bool
+adv_spool_is_enabled(void)
+{
+    if (NULL == g_p_adv_spool_mutex)
+    {
+        return false;
+    }
+    os_mutex_lock(g_p_adv_spool_mutex);
+    const bool flag_enabled = (NULL != g_adv_spool.p_partition) ? true : false;
+    os_mutex_unlock(g_p_adv_spool_mutex);
+    return flag_enabled;
+}
+
+bool
+adv_spool_is_empty(void)
+{
+    if (NULL == g_p_adv_spool_mutex)
+    {
+        return true;
+    }
+    os_mutex_lock(g_p_adv_spool_mutex);
+    const bool flag_empty = (NULL == g_adv_spool.p_partition) || adv_spool_is_empty_unsafe();
+    os_mutex_unlock(g_p_adv_spool_mutex);
+    return flag_empty;
+}
+
+static void
+adv_spool_put_u32(uint8_t* const p_buf, const uint32_t val)
+{
+    for (uint32_t i = 0; i < sizeof(val); ++i)
+    {
+        p_buf[i] = (uint8_t)((val >> (i * ADV_SPOOL_NUM_BITS_PER_BYTE)) & ADV_SPOOL_BYTE_MASK);
+    }
+}
+
+static uint32_t
+adv_spool_get_u32(const uint8_t* const p_buf)
+{
+    uint32_t val = 0;
+    for (uint32_t i = 0; i < sizeof(val); ++i)
+    {
+        val |= (uint32_t)p_buf[i] << (i * ADV_SPOOL_NUM_BITS_PER_BYTE);
+    }
+    return val;
+}
+
+static uint32_t
+adv_spool_encode_adv(uint8_t* const p_buf, const adv_report_t* const p_adv)
+{
+    uint8_t* p_dst = p_buf;
+    adv_spool_put_u32(p_dst, (uint32_t)p_adv->timestamp);
+    p_dst += sizeof(uint32_t);
+    adv_spool_put_u32(p_dst, p_adv->samples_counter);
+    p_dst += sizeof(uint32_t);
+    memcpy(p_dst, p_adv->tag_mac.mac, MAC_ADDRESS_NUM_BYTES);
+    p_dst += MAC_ADDRESS_NUM_BYTES;
+    *p_dst++ = (uint8_t)p_adv->rssi;
+    *p_dst++ = (uint8_t)((p_adv->secondary_phy << ADV_SPOOL_ADV_PHY_SHIFT) | p_adv->primary_phy);
+    *p_dst++ = p_adv->ch_index;
+    *p_dst++ = p_adv->is_coded_phy ? ADV_SPOOL_ADV_FLAG_IS_CODED_PHY : 0U;
+    *p_dst++ = (uint8_t)p_adv->tx_power;
+    *p_dst++ = p_adv->data_len;
+    memcpy(p_dst, p_adv->data_buf, p_adv->data_len);
+    p_dst += p_adv->data_len;
+    return (uint32_t)(p_dst - p_buf);
+}
+
+static bool
+adv_spool_decode_adv(const uint8_t* const p_buf, const uint32_t len, adv_report_t* const p_adv, uint32_t* const p_used)
+{
+    if (len < ADV_SPOOL_ADV_HDR_SIZE)
+    {
+        return false;
+    }
+    const uint8_t* p_src = p_buf;
+    memset(p_adv, 0, sizeof(*p_adv));
+    p_adv->timestamp = (time_t)adv_spool_get_u32(p_src);
+    p_src += sizeof(uint32_t);
+    p_adv->samples_counter = adv_spool_get_u32(p_src);
+    p_src += sizeof(uint32_t);
+    memcpy(p_adv->tag_mac.mac, p_src, MAC_ADDRESS_NUM_BYTES);
+    p_src += MAC_ADDRESS_NUM_BYTES;
+    p_adv->rssi = (wifi_rssi_t)*p_src++;
+    const uint8_t phy    = *p_src++;
+    p_adv->primary_phy   = phy & ADV_SPOOL_ADV_PHY_MASK;
+    p_adv->secondary_phy = (phy >> ADV_SPOOL_ADV_PHY_SHIFT) & ADV_SPOOL_ADV_PHY_MASK;
+    p_adv->ch_index      = *p_src++;
+    p_adv->is_coded_phy  = (0 != (*p_src++ & ADV_SPOOL_ADV_FLAG_IS_CODED_PHY)) ? true : false;
+    p_adv->tx_power      = (int8_t)*p_src++;
+    p_adv->data_len      = *p_src++;
+    if ((p_adv->data_len > ADV_DATA_MAX_LEN) || ((ADV_SPOOL_ADV_HDR_SIZE + p_adv->data_len) > len))
+    {
+        return false;
+    }
+    memcpy(p_adv->data_buf, p_src, p_adv->data_len);
+    *p_used = ADV_SPOOL_ADV_HDR_SIZE + p_adv->data_len;
+    return true;
+}
+
+static bool
+adv_spool_append_record_unsafe(
+    adv_spool_rec_t* const    p_rec,
+    const adv_spool_target_e  target,
+    const adv_report_t* const p_arr_of_advs,
+    const num_of_advs_t       num_of_advs)
+{
+    uint32_t payload_len = 0;
+    for (num_of_advs_t i = 0; i < num_of_advs; ++i)
+    {
+        payload_len += adv_spool_encode_adv(&p_rec->payload[payload_len], &p_arr_of_advs[i]);
+    }
+    const uint32_t rec_size = adv_spool_get_rec_size(payload_len);
+    memset(&p_rec->payload[payload_len], 0xFF, rec_size - sizeof(p_rec->hdr) - payload_len);
+    p_rec->hdr.len         = (uint16_t)payload_len;
+    p_rec->hdr.state       = ADV_SPOOL_REC_STATE_WRITTEN;
+    p_rec->hdr.target      = (uint8_t)target;
+    p_rec->hdr.num_of_advs = (uint16_t)num_of_advs;
+    p_rec->hdr.reserved    = 0xFFFFU;
+    p_rec->hdr.crc         = crc32_le(0, p_rec->payload, payload_len);
+
+    if (((g_adv_spool.pos_write.offset + rec_size) > ADV_SPOOL_SECTOR_SIZE) && (!adv_spool_open_next_sector_unsafe()))
+    {
+        g_adv_spool.stat.num_dropped_advs += num_of_advs;
+        return false;
+    }
+    const esp_err_t err = esp_partition_write(
+        g_adv_spool.p_partition,
+        adv_spool_get_sector_addr(g_adv_spool.pos_write.sector_idx) + g_adv_spool.pos_write.offset,
+        p_rec,
+        rec_size);
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_partition_write");
+        g_adv_spool.stat.num_dropped_advs += num_of_advs;
+        // The record may be partially written, so continue in the next sector.
+        g_adv_spool.pos_write.offset = ADV_SPOOL_SECTOR_SIZE;
+        return false;
+    }
+    g_adv_spool.pos_write.offset += rec_size;
+    g_adv_spool.stat.num_stored_advs += num_of_advs;
+    return true;
+}
+
+bool
+adv_spool_append(
+    const adv_spool_target_e  target,
+    const adv_report_t* const p_arr_of_advs,
+    const num_of_advs_t       num_of_advs)
+{
+    if (!adv_spool_is_enabled())
+    {
+        return false;
+    }
+    adv_spool_rec_t* p_rec = os_malloc(sizeof(*p_rec));
+    if (NULL == p_rec)
+    {
+        LOG_ERR("Can't allocate memory");
+        return false;
+    }
+    bool res = true;
+    os_mutex_lock(g_p_adv_spool_mutex);
+    for (num_of_advs_t idx = 0; (idx < num_of_advs) && (NULL != g_adv_spool.p_partition);)
+    {
+        num_of_advs_t num_in_rec = num_of_advs - idx;
+        if (num_in_rec > ADV_SPOOL_MAX_ADVS_PER_RECORD)
+        {
+            num_in_rec = ADV_SPOOL_MAX_ADVS_PER_RECORD;
+        }
+        if (!adv_spool_append_record_unsafe(p_rec, target, &p_arr_of_advs[idx], num_in_rec))
+        {
+            res = false;
+        }
+        idx += num_in_rec;
+    }
+    os_mutex_unlock(g_p_adv_spool_mutex);
+    os_free(p_rec);
+    return res;
+}
+
+static bool
+adv_spool_decode_record(const adv_spool_rec_t* const p_rec, adv_report_t* const p_arr_of_advs)
+{
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < p_rec->hdr.num_of_advs; ++i)
+    {
+        uint32_t used = 0;
+        if (!adv_spool_decode_adv(&p_rec->payload[offset], p_rec->hdr.len - offset, &p_arr_of_advs[i], &used))
+        {
+            return false;
+        }
+        offset += used;
+    }
+    return offset == p_rec->hdr.len;
+}
+
+static void
+adv_spool_mark_consumed_unsafe(void)
+{
+    const adv_spool_pos_t* const p_pos = &g_adv_spool.pos_read;
+    const uint8_t                state = ADV_SPOOL_REC_STATE_CONSUMED;
+    const esp_err_t              err   = esp_partition_write(
+        g_adv_spool.p_partition,
+        adv_spool_get_sector_addr(p_pos->sector_idx) + p_pos->offset + offsetof(adv_spool_rec_hdr_t, state),
+        &state,
+        sizeof(state));
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_partition_write");
+    }
+}
+
+static num_of_advs_t
+adv_spool_read_unsafe(
+    adv_spool_rec_t* const    p_rec,
+    adv_spool_target_e* const p_target,
+    adv_report_t* const       p_arr_of_advs,
+    adv_spool_rec_id_t* const p_rec_id)
+{
+    for (;;)
+    {
+        // After this call the read position is either at a valid record which has not been consumed or at the end.
+        adv_spool_skip_consumed_unsafe();
+        if (adv_spool_is_empty_unsafe())
+        {
+            break;
+        }
+        const adv_spool_pos_t* const p_pos = &g_adv_spool.pos_read;
+        esp_err_t                    err   = esp_partition_read(
+            g_adv_spool.p_partition,
+            adv_spool_get_sector_addr(p_pos->sector_idx) + p_pos->offset,
+            &p_rec->hdr,
+            sizeof(p_rec->hdr));
+        if (ESP_OK == err)
+        {
+            err = esp_partition_read(
+                g_adv_spool.p_partition,
+                adv_spool_get_sector_addr(p_pos->sector_idx) + p_pos->offset + sizeof(p_rec->hdr),
+                p_rec->payload,
+                p_rec->hdr.len);
+        }
+        if (ESP_OK != err)
+        {
+            LOG_ERR_ESP(err, "%s failed", "esp_partition_read");
+            return 0;
+        }
+        if ((crc32_le(0, p_rec->payload, p_rec->hdr.len) == p_rec->hdr.crc)
+            && (p_rec->hdr.target <= (uint8_t)ADV_SPOOL_TARGET_HTTP_CUSTOM)
+            && adv_spool_decode_record(p_rec, p_arr_of_advs))
+        {
+            *p_target         = (adv_spool_target_e)p_rec->hdr.target;
+            p_rec_id->seq_num = adv_spool_get_read_seq_num_unsafe();
+            p_rec_id->offset  = p_pos->offset;
+            return p_rec->hdr.num_of_advs;
+        }
+        LOG_ERR(
+            "Corrupted record in sector %u at offset %u, drop %u advs",
+            (printf_uint_t)p_pos->sector_idx,
+            (printf_uint_t)p_pos->offset,
+            (printf_uint_t)p_rec->hdr.num_of_advs);
+        g_adv_spool.stat.num_dropped_advs += p_rec->hdr.num_of_advs;
+        adv_spool_mark_consumed_unsafe();
+        g_adv_spool.pos_read.offset += adv_spool_get_rec_size(p_rec->hdr.len);
+    }
+    return 0;
+}
+
+num_of_advs_t
+adv_spool_read(
+    adv_spool_target_e* const p_target,
+    adv_report_t* const       p_arr_of_advs,
+    adv_spool_rec_id_t* const p_rec_id)
+{
+    p_rec_id->seq_num = 0;
+    p_rec_id->offset  = 0;
+    if (adv_spool_is_empty())
+    {
+        return 0;
+    }
+    adv_spool_rec_t* p_rec = os_malloc(sizeof(*p_rec));
+    if (NULL == p_rec)
+    {
+        LOG_ERR("Can't allocate memory");
+        return 0;
+    }
+    os_mutex_lock(g_p_adv_spool_mutex);
+    const num_of_advs_t num_of_advs = (NULL != g_adv_spool.p_partition)
+                                          ? adv_spool_read_unsafe(p_rec, p_target, p_arr_of_advs, p_rec_id)
+                                          : 0;
+    os_mutex_unlock(g_p_adv_spool_mutex);
+    os_free(p_rec);
+    return num_of_advs;
+}
+
+static bool
+adv_spool_is_rec_at_read_pos_unsafe(const adv_spool_rec_id_t* const p_rec_id)
+{
+    return (!adv_spool_is_empty_unsafe()) && (p_rec_id->seq_num == adv_spool_get_read_seq_num_unsafe())
+           && (p_rec_id->offset == g_adv_spool.pos_read.offset);
+}
+
+static bool
+adv_spool_consume_unsafe(const adv_spool_rec_id_t* const p_rec_id, const bool flag_delivered)
+{
+    if (!adv_spool_is_rec_at_read_pos_unsafe(p_rec_id))
+    {
+        LOG_WARN(
+            "Ignore the stale ack of the record in sector with seq_num %u at offset %u",
+            (printf_uint_t)p_rec_id->seq_num,
+            (printf_uint_t)p_rec_id->offset);
+        return false;
+    }
+    adv_spool_rec_hdr_t hdr = { 0 };
+    if (!adv_spool_read_rec_hdr(&g_adv_spool.pos_read, &hdr))
+    {
+        return false;
+    }
+    adv_spool_mark_consumed_unsafe();
+    if (flag_delivered)
+    {
+        g_adv_spool.stat.num_sent_advs += hdr.num_of_advs;
+    }
+    else
+    {
+        g_adv_spool.stat.num_dropped_advs += hdr.num_of_advs;
+    }
+    g_adv_spool.pos_read.offset += adv_spool_get_rec_size(hdr.len);
+    adv_spool_skip_consumed_unsafe();
+    return true;
+}
+
+bool
+adv_spool_consume(const adv_spool_rec_id_t* const p_rec_id, const bool flag_delivered)
+{
+    if (NULL == g_p_adv_spool_mutex)
+    {
+        return false;
+    }
+    os_mutex_lock(g_p_adv_spool_mutex);
+    const bool res = (NULL != g_adv_spool.p_partition) ? adv_spool_consume_unsafe(p_rec_id, flag_delivered) : false;
+    os_mutex_unlock(g_p_adv_spool_mutex);
+    return res;
+}
+
+void
+adv_spool_get_stat(adv_spool_stat_t* const p_stat)
+{
+    memset(p_stat, 0, sizeof(*p_stat));
+    if (NULL == g_p_adv_spool_mutex)
+    {
+        return;
+    }
+    os_mutex_lock(g_p_adv_spool_mutex);
+    if (NULL != g_adv_spool.p_partition)
+    {
+        *p_stat            = g_adv_spool.stat;
+        p_stat->used_bytes = adv_spool_calc_used_bytes_unsafe();
+    }
+    os_mutex_unlock(g_p_adv_spool_mutex);
+}
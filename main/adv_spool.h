@@ -0,0 +1,137 @@
+/**
+ * @file adv_spool.h
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ * @brief Persistent store-and-forward spool of advertisements for network outages.
+ *
+ * While there is no network connection, the batches of advertisements which would have been sent to the HTTP
+ * targets are appended to the spool instead of being overwritten in the retransmission lists. After the connection
+ * is restored, the spool is drained one batch per HTTP POST, the next batch is sent only after the previous one
+ * has been delivered.
+ *
+ * The spool is a log-structured ring of records in the flash partition ADV_SPOOL_PARTITION_LABEL.
+ * Every sector starts with a header with a sequence number, the sectors are written one after another,
+ * so that every sector is erased once per pass of the ring (wear-levelling). Every record contains a packed
+ * batch of advertisements (only data_len bytes of the payload are stored) protected by CRC32.
+ * The delivered records are marked as consumed in place by clearing the bits of their state byte, so the
+ * spool survives a reboot. When the ring is full, the oldest sector is erased and its advertisements are dropped.
+ */
+
+#ifndef RUUVI_GATEWAY_ESP_ADV_SPOOL_H
+#define RUUVI_GATEWAY_ESP_ADV_SPOOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "adv_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Enable the spool, it's configured by RUUVI_ADV_SPOOL in the top-level CMakeLists.txt.
+ */
+#if !defined(ADV_SPOOL_ENABLED)
+#define ADV_SPOOL_ENABLED (0)
+#endif
+
+#define ADV_SPOOL_PARTITION_LABEL "adv_spool"
+
+/**
+ * @brief The maximum number of advertisements in one record (and in one HTTP POST while draining the spool).
+ */
+#define ADV_SPOOL_MAX_ADVS_PER_RECORD (48U)
+
+typedef enum adv_spool_target_e
+{
+    ADV_SPOOL_TARGET_HTTP_RUUVI  = 0,
+    ADV_SPOOL_TARGET_HTTP_CUSTOM = 1,
+} adv_spool_target_e;
+
+/**
+ * @brief Identifier of the record returned by adv_spool_read, it's passed back to adv_spool_consume.
+ * @note The sequence number of the sector is never reused, so the identifier remains unique after the ring wraps.
+ */
+typedef struct adv_spool_rec_id_t
+{
+    uint32_t seq_num; //<! Sequence number of the sector which contains the record, 0 if there is no record
+    uint32_t offset;  //<! Offset of the record in the sector
+} adv_spool_rec_id_t;
+
+typedef struct adv_spool_stat_t
+{
+    uint32_t size_bytes;       //<! Size of the flash partition, 0 if the spool is disabled
+    uint32_t used_bytes;       //<! Number of bytes occupied by the records which have not been consumed yet
+    uint32_t num_stored_advs;  //<! Number of advertisements appended to the spool since boot
+    uint32_t num_sent_advs;    //<! Number of advertisements consumed from the spool since boot
+    uint32_t num_dropped_advs; //<! Number of advertisements dropped since boot because the spool was full or corrupted
+} adv_spool_stat_t;
+
+/**
+ * @brief Find the flash partition and restore the state of the spool from it.
+ * @return false if the spool is disabled at build time or the partition is not found.
+ */
+bool
+adv_spool_init(void);
+
+void
+adv_spool_deinit(void);
+
+bool
+adv_spool_is_enabled(void);
+
+/**
+ * @brief Check if there are records which have not been consumed yet.
+ */
+bool
+adv_spool_is_empty(void);
+
+/**
+ * @brief Append a batch of advertisements to the spool.
+ * @note The batch is split into several records if it contains more than ADV_SPOOL_MAX_ADVS_PER_RECORD advs.
+ * @param target - the HTTP target for which the advertisements are spooled
+ * @param p_arr_of_advs - ptr to the array of advertisements
+ * @param num_of_advs - number of advertisements in the array
+ * @return false if the spool is disabled, there is not enough memory or the flash operation failed.
+ */
+bool
+adv_spool_append(
+    const adv_spool_target_e  target,
+    const adv_report_t* const p_arr_of_advs,
+    const num_of_advs_t       num_of_advs);
+
+/**
+ * @brief Read the oldest record which has not been consumed yet.
+ * @note The result does not change until adv_spool_consume is called
+ *       or the record is dropped because the spool is full.
+ * @param[out] p_target - ptr to the variable to save the target of the record
+ * @param[out] p_arr_of_advs - ptr to the array of at least ADV_SPOOL_MAX_ADVS_PER_RECORD elements
+ * @param[out] p_rec_id - ptr to the variable to save the identifier of the record
+ * @return number of advertisements in the record, 0 if the spool is empty.
+ */
+num_of_advs_t
+adv_spool_read(
+    adv_spool_target_e* const p_target,
+    adv_report_t* const       p_arr_of_advs,
+    adv_spool_rec_id_t* const p_rec_id);
+
+/**
+ * @brief Mark the record as consumed if it's still the oldest one.
+ * @note The ack is ignored if the record has already been consumed or dropped while it was being sent
+ *       (e.g. the oldest sector was overwritten because the spool is full).
+ * @param p_rec_id - ptr to the identifier of the record returned by adv_spool_read
+ * @param flag_delivered - true if the record has been delivered, false if it's discarded (e.g. the target was disabled)
+ * @return false if the ack is stale and nothing was consumed.
+ */
+bool
+adv_spool_consume(const adv_spool_rec_id_t* const p_rec_id, const bool flag_delivered);
+
+void
+adv_spool_get_stat(adv_spool_stat_t* const p_stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_ESP_ADV_SPOOL_H
@@ -8,49 +8,616 @@
 #include "adv_table.h"
 #include <string.h>
 #include <limits.h>
+#include <stdatomic.h>
 #include <esp_attr.h>
+#include <esp_system.h>
 #include "os_mutex.h"
-#include "sys/queue.h"
+#include "os_malloc.h"
+#include "metrics.h"
+#if defined(RUUVI_TESTS) && RUUVI_TESTS
+#define LOG_LOCAL_DISABLED 1
+#define LOG_LOCAL_LEVEL    LOG_LEVEL_NONE
+#else
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#endif
+#include "log.h"
+
+#if ADV_TABLE_HIST_DEPTH > 0
+static const char TAG[] = "ADV_TABLE";
+#endif
 
 #if defined(__XTENSA__)
-#define ADV_REPORT_EXPECTED_SIZE (20U + 48U)
+#define ADV_REPORT_EXPECTED_SIZE (20U + 48U + 4U)
 #elif defined(__linux__) && defined(__x86_64__)
-#define ADV_REPORT_EXPECTED_SIZE (24U + 48U)
+#define ADV_REPORT_EXPECTED_SIZE (24U + 48U + 8U)
 #endif
 
 _Static_assert(sizeof(adv_report_t) == ADV_REPORT_EXPECTED_SIZE, "sizeof(adv_report_t)");
 
-#define ADV_TABLE_HASH_SIZE (101)
+#if (2U * ADV_TABLE_CAPACITY) <= 256U
+#define ADV_TABLE_HASH_SIZE (256U)
+#elif (2U * ADV_TABLE_CAPACITY) <= 512U
+#define ADV_TABLE_HASH_SIZE (512U)
+#elif (2U * ADV_TABLE_CAPACITY) <= 1024U
+#define ADV_TABLE_HASH_SIZE (1024U)
+#elif (2U * ADV_TABLE_CAPACITY) <= 2048U
+#define ADV_TABLE_HASH_SIZE (2048U)
+#elif (2U * ADV_TABLE_CAPACITY) <= 4096U
+#define ADV_TABLE_HASH_SIZE (4096U)
+#elif (2U * ADV_TABLE_CAPACITY) <= 8192U
+#define ADV_TABLE_HASH_SIZE (8192U)
+#else
+#error "ADV_TABLE_CAPACITY is too big"
+#endif
+
+#define ADV_TABLE_HASH_MASK (ADV_TABLE_HASH_SIZE - 1U)
+
+#define ADV_TABLE_IDX_NONE (UINT16_MAX)
+
+_Static_assert(ADV_TABLE_CAPACITY < ADV_TABLE_IDX_NONE, "ADV_TABLE_CAPACITY must fit into adv_table_idx_t");
 
 #define BLE_MAX_REGULAR_ADV_DATA_LEN (31U)
 
-typedef struct adv_reports_list_elem_t adv_reports_list_elem_t;
+typedef uint16_t adv_table_idx_t;
 
-typedef STAILQ_HEAD(adv_report_list_t, adv_reports_list_elem_t) adv_report_list_t;
-typedef TAILQ_HEAD(adv_report_hist_list_t, adv_reports_list_elem_t) adv_report_hist_list_t;
+typedef enum adv_table_retransmission_list_e
+{
+    ADV_TABLE_RETRANSMISSION_LIST1 = 0,
+    ADV_TABLE_RETRANSMISSION_LIST2,
+    ADV_TABLE_RETRANSMISSION_LIST3,
+    ADV_TABLE_NUM_RETRANSMISSION_LISTS,
+} adv_table_retransmission_list_e;
 
-struct adv_reports_list_elem_t
+/**
+ * @brief Singly-linked FIFO list of elements of g_arr_of_adv_reports linked by indices.
+ */
+typedef struct adv_report_list_t
+{
+    adv_table_idx_t first;
+    adv_table_idx_t last;
+    adv_table_idx_t num_of_elems;
+} adv_report_list_t;
+
+/**
+ * @brief Doubly-linked list of elements of g_arr_of_adv_reports linked by indices, from the newest to the oldest.
+ */
+typedef struct adv_report_hist_list_t
+{
+    adv_table_idx_t first;
+    adv_table_idx_t last;
+} adv_report_hist_list_t;
+
+typedef uint32_t adv_table_generation_t;
+
+/**
+ * @brief Compact record of a sample in the per-tag history.
+ */
+typedef struct adv_table_hist_rec_t
 {
-    STAILQ_ENTRY(adv_reports_list_elem_t) hash_table_list;
-    STAILQ_ENTRY(adv_reports_list_elem_t) retransmission_list1;
-    STAILQ_ENTRY(adv_reports_list_elem_t) retransmission_list2;
-    STAILQ_ENTRY(adv_reports_list_elem_t) retransmission_list3;
-    TAILQ_ENTRY(adv_reports_list_elem_t) hist_list;
-    bool         is_in_hash_table;
-    bool         is_in_retransmission_list1;
-    bool         is_in_retransmission_list2;
-    bool         is_in_retransmission_list3;
-    adv_report_t adv_report;
+    uint16_t       timestamp_delta; //<! Difference with the timestamp of the previous sample of the tag
+    wifi_rssi_t    rssi;
+    ble_data_len_t data_len;
+    uint8_t        data_buf[ADV_DATA_MAX_LEN];
+} adv_table_hist_rec_t;
+
+/**
+ * @brief The samples of a tag copied to a snapshot.
+ */
+typedef struct adv_table_snapshot_hist_t
+{
+    time_t        timestamp_first; //<! Timestamp of the first sample (timestamp_delta of the first record is ignored)
+    num_of_advs_t rec_idx;         //<! Index of the first record in p_hist_recs
+    num_of_advs_t num_of_recs;
+} adv_table_snapshot_hist_t;
+
+typedef struct adv_table_cow_copy_t adv_table_cow_copy_t;
+
+typedef struct adv_reports_list_elem_t
+{
+    adv_table_idx_t        retransmission_list_next[ADV_TABLE_NUM_RETRANSMISSION_LISTS];
+    adv_table_idx_t        hist_list_prev;
+    adv_table_idx_t        hist_list_next;
+    adv_table_idx_t        snapshot_ref_cnt; //<! Number of snapshots which contain this element
+    bool                   is_in_hash_table;
+    bool                   is_in_retransmission_list[ADV_TABLE_NUM_RETRANSMISSION_LISTS];
+    adv_table_generation_t generation;   //<! Generation of the table when adv_report was written
+    adv_table_cow_copy_t*  p_cow_copies; //<! The previous contents visible to the snapshots, from newest to oldest
+    adv_report_t           adv_report;
+} adv_reports_list_elem_t;
+
+/**
+ * @brief Snapshot of a retransmission list - the indices of the elements of g_arr_of_adv_reports.
+ * @note The snapshot sees the data of an element which was written at generation less or equal to the generation
+ *       of the snapshot. If the element is modified while it's referenced by a snapshot,
+ *       then its previous content is saved to adv_table_cow_copy_t (copy-on-write).
+ */
+struct adv_table_snapshot_t
+{
+    adv_table_snapshot_t*      p_prev; //<! Prev live snapshot (in order of generation), not used for detached ones
+    adv_table_snapshot_t*      p_next; //<! Next live snapshot (in order of generation), not used for detached ones
+    adv_table_generation_t     generation;
+    uint32_t                   ref_cnt;
+    num_of_advs_t              num_of_advs;
+    adv_report_t*              p_detached_advs; //<! Own copy of the advs for a detached snapshot, NULL otherwise
+    adv_table_snapshot_hist_t* p_hist;          //<! The samples of every tag, NULL if the history is disabled
+    adv_table_hist_rec_t*      p_hist_recs;     //<! The records of the samples of all the tags
+    adv_table_idx_t            idx[];
 };
 
+/**
+ * @brief The previous content of an element of g_arr_of_adv_reports which is visible to the snapshots
+ *        with generation in the range [generation_begin, generation_end).
+ * @note The ranges of the copies of the same element do not overlap, so the number of copies of an element
+ *       does not exceed the number of live snapshots.
+ */
+struct adv_table_cow_copy_t
+{
+    adv_table_cow_copy_t*  p_next;
+    adv_table_generation_t generation_begin;
+    adv_table_generation_t generation_end;
+    adv_report_t           adv_report;
+};
+
+/**
+ * @brief Doubly-linked list of live (not detached) snapshots sorted by generation (from the oldest to the newest).
+ */
+typedef struct adv_table_snapshot_list_t
+{
+    adv_table_snapshot_t* p_first;
+    adv_table_snapshot_t* p_last;
+} adv_table_snapshot_list_t;
+
 static os_mutex_t IRAM_ATTR             gp_adv_reports_mutex;
 static os_mutex_static_t                g_adv_reports_mutex_mem;
-static adv_reports_list_elem_t          g_arr_of_adv_reports[MAX_ADVS_TABLE];
-static adv_report_list_t IRAM_ATTR      g_adv_hash_table[ADV_TABLE_HASH_SIZE];
-static adv_report_list_t IRAM_ATTR      g_adv_reports_retransmission_list1;
-static adv_report_list_t IRAM_ATTR      g_adv_reports_retransmission_list2;
-static adv_report_list_t IRAM_ATTR      g_adv_reports_retransmission_list3;
+static adv_reports_list_elem_t          g_arr_of_adv_reports[ADV_TABLE_CAPACITY];
+static adv_table_idx_t                  g_adv_hash_table[ADV_TABLE_HASH_SIZE];
+static adv_report_list_t IRAM_ATTR      g_adv_reports_retransmission_list[ADV_TABLE_NUM_RETRANSMISSION_LISTS];
 static adv_report_hist_list_t IRAM_ATTR g_adv_reports_hist_list;
+static adv_table_generation_t           g_adv_table_generation;
+static adv_table_snapshot_list_t        g_adv_table_snapshots;
+static atomic_uint                      g_adv_table_no_mem_drop_cnt;
+
+static adv_table_idx_t
+adv_table_get_elem_idx(const adv_reports_list_elem_t* const p_elem)
+{
+    return (adv_table_idx_t)(p_elem - &g_arr_of_adv_reports[0]);
+}
+
+static adv_reports_list_elem_t*
+adv_table_get_elem(const adv_table_idx_t idx)
+{
+    if (ADV_TABLE_IDX_NONE == idx)
+    {
+        return NULL;
+    }
+    return &g_arr_of_adv_reports[idx];
+}
+
+static void
+adv_hist_list_remove(adv_reports_list_elem_t* const p_elem)
+{
+    adv_reports_list_elem_t* const p_prev = adv_table_get_elem(p_elem->hist_list_prev);
+    adv_reports_list_elem_t* const p_next = adv_table_get_elem(p_elem->hist_list_next);
+    if (NULL == p_prev)
+    {
+        g_adv_reports_hist_list.first = p_elem->hist_list_next;
+    }
+    else
+    {
+        p_prev->hist_list_next = p_elem->hist_list_next;
+    }
+    if (NULL == p_next)
+    {
+        g_adv_reports_hist_list.last = p_elem->hist_list_prev;
+    }
+    else
+    {
+        p_next->hist_list_prev = p_elem->hist_list_prev;
+    }
+    p_elem->hist_list_prev = ADV_TABLE_IDX_NONE;
+    p_elem->hist_list_next = ADV_TABLE_IDX_NONE;
+}
+
+static void
+adv_hist_list_insert_head(adv_reports_list_elem_t* const p_elem)
+{
+    const adv_table_idx_t          idx     = adv_table_get_elem_idx(p_elem);
+    adv_reports_list_elem_t* const p_first = adv_table_get_elem(g_adv_reports_hist_list.first);
+    p_elem->hist_list_prev                 = ADV_TABLE_IDX_NONE;
+    p_elem->hist_list_next                 = g_adv_reports_hist_list.first;
+    if (NULL == p_first)
+    {
+        g_adv_reports_hist_list.last = idx;
+    }
+    else
+    {
+        p_first->hist_list_prev = idx;
+    }
+    g_adv_reports_hist_list.first = idx;
+}
+
+static void
+adv_hist_list_insert_tail(adv_reports_list_elem_t* const p_elem)
+{
+    const adv_table_idx_t          idx    = adv_table_get_elem_idx(p_elem);
+    adv_reports_list_elem_t* const p_last = adv_table_get_elem(g_adv_reports_hist_list.last);
+    p_elem->hist_list_prev                = g_adv_reports_hist_list.last;
+    p_elem->hist_list_next                = ADV_TABLE_IDX_NONE;
+    if (NULL == p_last)
+    {
+        g_adv_reports_hist_list.first = idx;
+    }
+    else
+    {
+        p_last->hist_list_next = idx;
+    }
+    g_adv_reports_hist_list.last = idx;
+}
+
+static void
+adv_retransmission_list_init(const adv_table_retransmission_list_e list_id)
+{
+    g_adv_reports_retransmission_list[list_id].first        = ADV_TABLE_IDX_NONE;
+    g_adv_reports_retransmission_list[list_id].last         = ADV_TABLE_IDX_NONE;
+    g_adv_reports_retransmission_list[list_id].num_of_elems = 0;
+}
+
+static void
+adv_retransmission_list_insert_tail(
+    const adv_table_retransmission_list_e list_id,
+    adv_reports_list_elem_t* const        p_elem)
+{
+    if (p_elem->is_in_retransmission_list[list_id])
+    {
+        return;
+    }
+    adv_report_list_t* const       p_list = &g_adv_reports_retransmission_list[list_id];
+    const adv_table_idx_t          idx    = adv_table_get_elem_idx(p_elem);
+    adv_reports_list_elem_t* const p_last = adv_table_get_elem(p_list->last);
+    p_elem->retransmission_list_next[list_id] = ADV_TABLE_IDX_NONE;
+    if (NULL == p_last)
+    {
+        p_list->first = idx;
+    }
+    else
+    {
+        p_last->retransmission_list_next[list_id] = idx;
+    }
+    p_list->last = idx;
+    p_list->num_of_elems += 1;
+    p_elem->is_in_retransmission_list[list_id] = true;
+}
+
+static adv_reports_list_elem_t*
+adv_retransmission_list_remove_head(const adv_table_retransmission_list_e list_id)
+{
+    adv_report_list_t* const       p_list = &g_adv_reports_retransmission_list[list_id];
+    adv_reports_list_elem_t* const p_elem = adv_table_get_elem(p_list->first);
+    if (NULL == p_elem)
+    {
+        return NULL;
+    }
+    p_list->first = p_elem->retransmission_list_next[list_id];
+    p_list->num_of_elems -= 1;
+    if (ADV_TABLE_IDX_NONE == p_list->first)
+    {
+        p_list->last = ADV_TABLE_IDX_NONE;
+    }
+    p_elem->retransmission_list_next[list_id]  = ADV_TABLE_IDX_NONE;
+    p_elem->is_in_retransmission_list[list_id] = false;
+    return p_elem;
+}
+
+static void
+adv_table_cow_copies_free_unsafe(void)
+{
+    for (uint32_t i = 0; i < (sizeof(g_arr_of_adv_reports) / sizeof(g_arr_of_adv_reports[0])); ++i)
+    {
+        adv_reports_list_elem_t* const p_elem = &g_arr_of_adv_reports[i];
+        adv_table_cow_copy_t*          p_copy = p_elem->p_cow_copies;
+        while (NULL != p_copy)
+        {
+            adv_table_cow_copy_t* const p_next = p_copy->p_next;
+            os_free(p_copy);
+            p_copy = p_next;
+        }
+        p_elem->p_cow_copies = NULL;
+    }
+}
+
+/**
+ * @brief Check if there is a live snapshot which can see the copy.
+ */
+static bool
+adv_table_cow_copy_is_visible_unsafe(const adv_table_cow_copy_t* const p_copy)
+{
+    for (const adv_table_snapshot_t* p_snapshot = g_adv_table_snapshots.p_first; NULL != p_snapshot;
+         p_snapshot                             = p_snapshot->p_next)
+    {
+        if (p_snapshot->generation >= p_copy->generation_end)
+        {
+            break; // The snapshots are sorted by generation, so the rest of them are newer than the copy
+        }
+        if (p_snapshot->generation >= p_copy->generation_begin)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Free the copies of the element which are not visible to any live snapshot.
+ */
+static void
+adv_table_cow_copies_gc_unsafe(adv_reports_list_elem_t* const p_elem)
+{
+    adv_table_cow_copy_t** pp_copy = &p_elem->p_cow_copies;
+    while (NULL != *pp_copy)
+    {
+        adv_table_cow_copy_t* p_copy = *pp_copy;
+        if (adv_table_cow_copy_is_visible_unsafe(p_copy))
+        {
+            pp_copy = &p_copy->p_next;
+        }
+        else
+        {
+            *pp_copy = p_copy->p_next;
+            os_free(p_copy);
+        }
+    }
+}
+
+#if ADV_TABLE_HIST_DEPTH > 0
+
+/**
+ * @brief The heap which must remain free after the allocation of the history: every snapshot of the retransmission
+ *        lists for the HTTP targets can contain a copy of all the samples, and the rest of the firmware
+ *        (TLS, HTTP, MQTT) needs at least ADV_TABLE_HIST_HEAP_RESERVE bytes.
+ */
+#define ADV_TABLE_HIST_NUM_SNAPSHOT_COPIES (2U)
+#define ADV_TABLE_HIST_HEAP_RESERVE        (64U * 1024U)
+#define ADV_TABLE_HIST_HEAP_MAX_SIZE       (256U * 1024U)
+
+typedef struct adv_table_hist_ring_t
+{
+    time_t        timestamp_first; //<! Timestamp of the oldest record in the ring
+    time_t        timestamp_last;  //<! Timestamp of the newest record in the ring
+    uint32_t      seq_end;         //<! Sequence number of the next record
+    num_of_advs_t slot_end;        //<! Index of the slot for the next record
+    num_of_advs_t num_of_recs;
+    uint32_t      seq_sent[ADV_TABLE_NUM_RETRANSMISSION_LISTS]; //<! The first record not yet taken to a snapshot
+} adv_table_hist_ring_t;
+
+/**
+ * @brief Pooled arena with the rings of samples for all the elements of g_arr_of_adv_reports.
+ */
+typedef struct adv_table_hist_t
+{
+    adv_table_hist_ring_t rings[ADV_TABLE_CAPACITY];
+    adv_table_hist_rec_t  recs[ADV_TABLE_CAPACITY][ADV_TABLE_HIST_DEPTH];
+} adv_table_hist_t;
+
+_Static_assert(
+    (sizeof(adv_table_hist_t) * (1U + ADV_TABLE_HIST_NUM_SNAPSHOT_COPIES)) + ADV_TABLE_HIST_HEAP_RESERVE
+        <= ADV_TABLE_HIST_HEAP_MAX_SIZE,
+    "ADV_TABLE_HIST_DEPTH is too big, the history of samples does not fit into the heap");
+
+static adv_table_hist_t* g_p_adv_table_hist;
+
+static void
+adv_table_hist_init(void)
+{
+    const size_t   arena_size = sizeof(*g_p_adv_table_hist);
+    const size_t   req_size   = (arena_size * (1U + ADV_TABLE_HIST_NUM_SNAPSHOT_COPIES)) + ADV_TABLE_HIST_HEAP_RESERVE;
+    const uint32_t free_size  = esp_get_free_heap_size();
+    if (req_size > free_size)
+    {
+        LOG_ERR(
+            "History of samples (depth %u) requires %u bytes of heap, but only %u bytes are free, it is disabled",
+            (printf_uint_t)ADV_TABLE_HIST_DEPTH,
+            (printf_uint_t)req_size,
+            (printf_uint_t)free_size);
+        g_p_adv_table_hist = NULL;
+        return;
+    }
+    g_p_adv_table_hist = os_calloc(1, arena_size);
+    if (NULL == g_p_adv_table_hist)
+    {
+        LOG_ERR("Can't allocate memory for history of samples");
+        return;
+    }
+    LOG_INFO("History of samples: depth %u, %u bytes", (printf_uint_t)ADV_TABLE_HIST_DEPTH, (printf_uint_t)arena_size);
+}
+
+static void
+adv_table_hist_deinit(void)
+{
+    if (NULL != g_p_adv_table_hist)
+    {
+        os_free(g_p_adv_table_hist);
+    }
+}
+
+bool
+adv_table_hist_is_enabled(void)
+{
+    return (NULL != g_p_adv_table_hist) ? true : false;
+}
+
+/**
+ * @brief Drop all the samples of the element (e.g. when it's reused for another tag).
+ */
+static void
+adv_table_hist_reset_unsafe(const adv_table_idx_t elem_idx)
+{
+    if (NULL == g_p_adv_table_hist)
+    {
+        return;
+    }
+    adv_table_hist_ring_t* const p_ring = &g_p_adv_table_hist->rings[elem_idx];
+    p_ring->num_of_recs                 = 0;
+    for (uint32_t i = 0; i < ADV_TABLE_NUM_RETRANSMISSION_LISTS; ++i)
+    {
+        p_ring->seq_sent[i] = p_ring->seq_end;
+    }
+}
+
+static void
+adv_table_hist_push_unsafe(const adv_table_idx_t elem_idx, const adv_report_t* const p_adv)
+{
+    if (NULL == g_p_adv_table_hist)
+    {
+        return;
+    }
+    adv_table_hist_ring_t* const p_ring = &g_p_adv_table_hist->rings[elem_idx];
+    adv_table_hist_rec_t* const  p_recs = &g_p_adv_table_hist->recs[elem_idx][0];
+    if ((0 != p_ring->num_of_recs)
+        && ((p_adv->timestamp < p_ring->timestamp_last) || ((p_adv->timestamp - p_ring->timestamp_last) > UINT16_MAX)))
+    {
+        // The time difference does not fit into the compact record, so the older samples are dropped.
+        p_ring->num_of_recs = 0;
+    }
+    uint16_t timestamp_delta = 0;
+    if (0 == p_ring->num_of_recs)
+    {
+        p_ring->timestamp_first = p_adv->timestamp;
+    }
+    else
+    {
+        timestamp_delta = (uint16_t)(p_adv->timestamp - p_ring->timestamp_last);
+    }
+    if (p_ring->num_of_recs < ADV_TABLE_HIST_DEPTH)
+    {
+        p_ring->num_of_recs += 1;
+    }
+    else if (ADV_TABLE_HIST_DEPTH > 1)
+    {
+        // The oldest record is overwritten, so the next one becomes the oldest
+        p_ring->timestamp_first += p_recs[(p_ring->slot_end + 1) % ADV_TABLE_HIST_DEPTH].timestamp_delta;
+    }
+    else
+    {
+        p_ring->timestamp_first = p_adv->timestamp;
+    }
+    adv_table_hist_rec_t* const p_rec = &p_recs[p_ring->slot_end];
+    p_rec->timestamp_delta            = timestamp_delta;
+    p_rec->rssi                       = p_adv->rssi;
+    p_rec->data_len                   = p_adv->data_len;
+    memcpy(p_rec->data_buf, p_adv->data_buf, p_adv->data_len);
+    p_ring->timestamp_last = p_adv->timestamp;
+    p_ring->seq_end += 1;
+    p_ring->slot_end = (p_ring->slot_end + 1) % ADV_TABLE_HIST_DEPTH;
+}
+
+static num_of_advs_t
+adv_table_hist_get_num_of_pending_recs_unsafe(
+    const adv_table_idx_t                 elem_idx,
+    const adv_table_retransmission_list_e list_id)
+{
+    const adv_table_hist_ring_t* const p_ring = &g_p_adv_table_hist->rings[elem_idx];
+    // The difference is correct even if seq_end has wrapped around.
+    const uint32_t num_of_unsent = p_ring->seq_end - p_ring->seq_sent[list_id];
+    return (num_of_unsent < p_ring->num_of_recs) ? num_of_unsent : p_ring->num_of_recs;
+}
+
+/**
+ * @brief Copy the samples which have not yet been taken to a snapshot of the retransmission list.
+ * @param elem_idx - index of the element of g_arr_of_adv_reports
+ * @param list_id - retransmission list
+ * @param[out] p_hist - ptr to the descriptor of the samples of the tag in the snapshot
+ * @param[out] p_dst_recs - ptr to the buffer for the records
+ * @return number of the copied records
+ */
+static num_of_advs_t
+adv_table_hist_take_pending_recs_unsafe(
+    const adv_table_idx_t                 elem_idx,
+    const adv_table_retransmission_list_e list_id,
+    adv_table_snapshot_hist_t* const      p_hist,
+    adv_table_hist_rec_t* const           p_dst_recs)
+{
+    adv_table_hist_ring_t* const      p_ring      = &g_p_adv_table_hist->rings[elem_idx];
+    const adv_table_hist_rec_t* const p_recs      = &g_p_adv_table_hist->recs[elem_idx][0];
+    const num_of_advs_t               num_pending = adv_table_hist_get_num_of_pending_recs_unsafe(elem_idx, list_id);
+    const num_of_advs_t num_skipped = p_ring->num_of_recs - num_pending;
+    const num_of_advs_t slot_first  = (p_ring->slot_end + ADV_TABLE_HIST_DEPTH - p_ring->num_of_recs)
+                                     % ADV_TABLE_HIST_DEPTH;
+
+    p_hist->timestamp_first = p_ring->timestamp_first;
+    p_hist->num_of_recs     = num_pending;
+    for (num_of_advs_t i = 0; i < p_ring->num_of_recs; ++i)
+    {
+        const adv_table_hist_rec_t* const p_rec = &p_recs[(slot_first + i) % ADV_TABLE_HIST_DEPTH];
+        if ((0 != i) && (i <= num_skipped))
+        {
+            p_hist->timestamp_first += p_rec->timestamp_delta;
+        }
+        if (i >= num_skipped)
+        {
+            p_dst_recs[i - num_skipped] = *p_rec;
+        }
+    }
+    p_ring->seq_sent[list_id] = p_ring->seq_end;
+    return num_pending;
+}
+
+#else
+
+static void
+adv_table_hist_init(void)
+{
+}
+
+static void
+adv_table_hist_deinit(void)
+{
+}
+
+bool
+adv_table_hist_is_enabled(void)
+{
+    return false;
+}
+
+static void
+adv_table_hist_reset_unsafe(const adv_table_idx_t elem_idx)
+{
+    (void)elem_idx;
+}
+
+static void
+adv_table_hist_push_unsafe(const adv_table_idx_t elem_idx, const adv_report_t* const p_adv)
+{
+    (void)elem_idx;
+    (void)p_adv;
+}
+
+static num_of_advs_t
+adv_table_hist_get_num_of_pending_recs_unsafe(
+    const adv_table_idx_t                 elem_idx,
+    const adv_table_retransmission_list_e list_id)
+{
+    (void)elem_idx;
+    (void)list_id;
+    return 0;
+}
+
+static num_of_advs_t
+adv_table_hist_take_pending_recs_unsafe(
+    const adv_table_idx_t                 elem_idx,
+    const adv_table_retransmission_list_e list_id,
+    adv_table_snapshot_hist_t* const      p_hist,
+    adv_table_hist_rec_t* const           p_dst_recs)
+{
+    (void)elem_idx;
+    (void)list_id;
+    (void)p_dst_recs;
+    p_hist->timestamp_first = 0;
+    p_hist->num_of_recs     = 0;
+    return 0;
+}
+
+#endif // ADV_TABLE_HIST_DEPTH > 0
 
 void
 adv_table_init(void)
@@ -59,29 +626,45 @@ adv_table_init(void)
 
     for (uint32_t i = 0; i < (sizeof(g_adv_hash_table) / sizeof(g_adv_hash_table[0])); ++i)
     {
-        STAILQ_INIT(&g_adv_hash_table[i]);
+        g_adv_hash_table[i] = ADV_TABLE_IDX_NONE;
     }
-    STAILQ_INIT(&g_adv_reports_retransmission_list1);
-    STAILQ_INIT(&g_adv_reports_retransmission_list2);
-    STAILQ_INIT(&g_adv_reports_retransmission_list3);
-    TAILQ_INIT(&g_adv_reports_hist_list);
+    for (uint32_t i = 0; i < ADV_TABLE_NUM_RETRANSMISSION_LISTS; ++i)
+    {
+        adv_retransmission_list_init((adv_table_retransmission_list_e)i);
+    }
+    g_adv_reports_hist_list.first = ADV_TABLE_IDX_NONE;
+    g_adv_reports_hist_list.last  = ADV_TABLE_IDX_NONE;
+    g_adv_table_generation        = 1;
+    g_adv_table_snapshots.p_first = NULL;
+    g_adv_table_snapshots.p_last  = NULL;
     for (uint32_t i = 0; i < (sizeof(g_arr_of_adv_reports) / sizeof(g_arr_of_adv_reports[0])); ++i)
     {
         adv_reports_list_elem_t* p_elem = &g_arr_of_adv_reports[i];
         memset(p_elem, 0, sizeof(*p_elem));
-        p_elem->is_in_hash_table           = false;
-        p_elem->is_in_retransmission_list1 = false;
-        p_elem->is_in_retransmission_list2 = false;
-        p_elem->is_in_retransmission_list3 = false;
-        p_elem->adv_report.timestamp       = 0;
-        p_elem->adv_report.data_len        = 0; // mark adv_report as free in hist_list
-        TAILQ_INSERT_TAIL(&g_adv_reports_hist_list, p_elem, hist_list);
+        for (uint32_t j = 0; j < ADV_TABLE_NUM_RETRANSMISSION_LISTS; ++j)
+        {
+            p_elem->retransmission_list_next[j]  = ADV_TABLE_IDX_NONE;
+            p_elem->is_in_retransmission_list[j] = false;
+        }
+        p_elem->is_in_hash_table       = false;
+        p_elem->snapshot_ref_cnt       = 0;
+        p_elem->generation             = 0;
+        p_elem->p_cow_copies           = NULL;
+        p_elem->adv_report.timestamp   = 0;
+        p_elem->adv_report.data_len    = 0; // mark adv_report as free in hist_list
+        adv_hist_list_insert_tail(p_elem);
     }
+    atomic_store(&g_adv_table_no_mem_drop_cnt, 0U);
+    adv_table_hist_init();
 }
 
 void
 adv_table_deinit(void)
 {
+    os_mutex_lock(gp_adv_reports_mutex);
+    adv_table_cow_copies_free_unsafe();
+    adv_table_hist_deinit();
+    os_mutex_unlock(gp_adv_reports_mutex);
     os_mutex_delete(&gp_adv_reports_mutex);
 }
 
@@ -95,60 +678,107 @@ mac_address_is_equal(const mac_address_bin_t* const p_mac1, const mac_address_bi
     return false;
 }
 
+/**
+ * @brief Finalization mix of MurmurHash3 - forces all bits of the value to avalanche.
+ */
+static uint32_t
+adv_report_hash_fmix32(uint32_t hash_val)
+{
+    hash_val ^= hash_val >> 16U;
+    hash_val *= 0x85EBCA6BU;
+    hash_val ^= hash_val >> 13U;
+    hash_val *= 0xC2B2AE35U;
+    hash_val ^= hash_val >> 16U;
+    return hash_val;
+}
+
 ADV_TABLE_STATIC
 uint32_t
 adv_report_calc_hash(const mac_address_bin_t* const p_mac)
 {
-    uint32_t     hash_val           = 0;
-    const size_t mac_addr_half_size = sizeof(p_mac->mac) / sizeof(p_mac->mac[0]) / 2;
-    for (uint32_t i = 0; i < mac_addr_half_size; ++i)
-    {
-        hash_val |= ((uint32_t)p_mac->mac[i] ^ (uint32_t)p_mac->mac[i + mac_addr_half_size]) << (i * CHAR_BIT);
-    }
-    return hash_val;
+    const uint32_t mac_hi = ((uint32_t)p_mac->mac[0] << (3U * CHAR_BIT)) | ((uint32_t)p_mac->mac[1] << (2U * CHAR_BIT))
+                            | ((uint32_t)p_mac->mac[2] << (1U * CHAR_BIT)) | (uint32_t)p_mac->mac[3];
+    const uint32_t mac_lo = ((uint32_t)p_mac->mac[4] << (1U * CHAR_BIT)) | (uint32_t)p_mac->mac[5];
+    return adv_report_hash_fmix32(mac_hi ^ adv_report_hash_fmix32(mac_lo + 0x9E3779B9U));
 }
 
 ADV_TABLE_STATIC
-adv_reports_list_elem_t*
-adv_hash_table_search(const mac_address_bin_t* const p_mac)
+uint32_t
+adv_hash_table_calc_home_slot(const mac_address_bin_t* const p_mac)
+{
+    return adv_report_calc_hash(p_mac) & ADV_TABLE_HASH_MASK;
+}
+
+static uint32_t
+adv_hash_table_find_slot(const mac_address_bin_t* const p_mac)
 {
-    const uint32_t           hash_val    = adv_report_calc_hash(p_mac);
-    const uint32_t           hash_idx    = hash_val % ADV_TABLE_HASH_SIZE;
-    adv_reports_list_elem_t* p_hash_elem = NULL;
-    STAILQ_FOREACH(p_hash_elem, &g_adv_hash_table[hash_idx], hash_table_list)
+    uint32_t slot_idx = adv_hash_table_calc_home_slot(p_mac);
+    // The hash table is at most half full, so there is always at least one free slot which terminates the probing.
+    for (;;)
     {
-        if (mac_address_is_equal(p_mac, &p_hash_elem->adv_report.tag_mac))
+        const adv_reports_list_elem_t* const p_hash_elem = adv_table_get_elem(g_adv_hash_table[slot_idx]);
+        if ((NULL == p_hash_elem) || mac_address_is_equal(p_mac, &p_hash_elem->adv_report.tag_mac))
         {
-            return p_hash_elem;
+            return slot_idx;
         }
+        slot_idx = (slot_idx + 1U) & ADV_TABLE_HASH_MASK;
     }
-    return NULL;
 }
 
-ADV_TABLE_STATIC
-void
+static adv_reports_list_elem_t*
+adv_hash_table_search(const mac_address_bin_t* const p_mac)
+{
+    return adv_table_get_elem(g_adv_hash_table[adv_hash_table_find_slot(p_mac)]);
+}
+
+static void
 adv_hash_table_add(adv_reports_list_elem_t* p_elem)
 {
-    const uint32_t hash_val = adv_report_calc_hash(&p_elem->adv_report.tag_mac);
-    const uint32_t hash_idx = hash_val % ADV_TABLE_HASH_SIZE;
+    const uint32_t slot_idx     = adv_hash_table_find_slot(&p_elem->adv_report.tag_mac);
+    g_adv_hash_table[slot_idx] = adv_table_get_elem_idx(p_elem);
+    p_elem->is_in_hash_table   = true;
+}
 
-    STAILQ_INSERT_TAIL(&g_adv_hash_table[hash_idx], p_elem, hash_table_list);
-    p_elem->is_in_hash_table = true;
+static bool
+adv_hash_table_is_slot_in_range(const uint32_t slot_idx, const uint32_t range_begin, const uint32_t range_end)
+{
+    // Check if slot_idx is in the cyclic range (range_begin, range_end]
+    if (range_begin <= range_end)
+    {
+        return (slot_idx > range_begin) && (slot_idx <= range_end);
+    }
+    return (slot_idx > range_begin) || (slot_idx <= range_end);
 }
 
-ADV_TABLE_STATIC
-void
+static void
 adv_hash_table_remove(adv_reports_list_elem_t* p_elem)
 {
     if (!p_elem->is_in_hash_table)
     {
         return;
     }
-    const uint32_t hash_val = adv_report_calc_hash(&p_elem->adv_report.tag_mac);
-    const uint32_t hash_idx = hash_val % ADV_TABLE_HASH_SIZE;
-
-    STAILQ_REMOVE(&g_adv_hash_table[hash_idx], p_elem, adv_reports_list_elem_t, hash_table_list);
-    p_elem->is_in_hash_table = false;
+    uint32_t free_slot_idx = adv_hash_table_find_slot(&p_elem->adv_report.tag_mac);
+    p_elem->is_in_hash_table = false;
+
+    // Backward shift deletion: move the subsequent elements of the probe sequence into the freed slot
+    // if their home slot allows it, so that no tombstones are needed.
+    uint32_t slot_idx = free_slot_idx;
+    for (;;)
+    {
+        slot_idx = (slot_idx + 1U) & ADV_TABLE_HASH_MASK;
+        const adv_reports_list_elem_t* const p_hash_elem = adv_table_get_elem(g_adv_hash_table[slot_idx]);
+        if (NULL == p_hash_elem)
+        {
+            break;
+        }
+        const uint32_t home_slot_idx = adv_hash_table_calc_home_slot(&p_hash_elem->adv_report.tag_mac);
+        if (!adv_hash_table_is_slot_in_range(home_slot_idx, free_slot_idx, slot_idx))
+        {
+            g_adv_hash_table[free_slot_idx] = g_adv_hash_table[slot_idx];
+            free_slot_idx                   = slot_idx;
+        }
+    }
+    g_adv_hash_table[free_slot_idx] = ADV_TABLE_IDX_NONE;
 }
 
 static bool
@@ -173,6 +803,36 @@ adv_table_check_if_adv_must_be_discarded(const adv_report_t* const p_adv, const
     return false;
 }
 
+/**
+ * @brief Prepare the element for modification: if the element is referenced by a snapshot which can see
+ *        its current content, then save a copy of the content for the snapshot.
+ * @return false if there is not enough memory to save the copy, in this case the element must not be modified.
+ */
+static bool
+adv_table_cow_guard_unsafe(adv_reports_list_elem_t* const p_elem)
+{
+    if ((0 == p_elem->snapshot_ref_cnt) || (p_elem->generation == g_adv_table_generation))
+    {
+        // Either no snapshot refers to this element or the current content was written after the latest snapshot
+        p_elem->generation = g_adv_table_generation;
+        return true;
+    }
+    adv_table_cow_copies_gc_unsafe(p_elem);
+    adv_table_cow_copy_t* const p_copy = os_malloc(sizeof(*p_copy));
+    if (NULL == p_copy)
+    {
+        atomic_fetch_add(&g_adv_table_no_mem_drop_cnt, 1U);
+        return false;
+    }
+    p_copy->generation_begin = p_elem->generation;
+    p_copy->generation_end   = g_adv_table_generation;
+    p_copy->adv_report       = p_elem->adv_report;
+    p_copy->p_next           = p_elem->p_cow_copies;
+    p_elem->p_cow_copies     = p_copy;
+    p_elem->generation       = g_adv_table_generation;
+    return true;
+}
+
 static bool
 adv_table_put_unsafe(const adv_report_t* const p_adv)
 {
@@ -181,19 +841,32 @@ adv_table_put_unsafe(const adv_report_t* const p_adv)
     adv_reports_list_elem_t* p_elem = adv_hash_table_search(&p_adv->tag_mac);
     if (NULL == p_elem)
     {
-        // not found in the table, insert if the retransmission list is not full
-        p_elem = TAILQ_LAST(&g_adv_reports_hist_list, adv_report_hist_list_t);
+        // not found in the table, replace the oldest one
+        p_elem = adv_table_get_elem(g_adv_reports_hist_list.last);
+        if (!adv_table_cow_guard_unsafe(p_elem))
+        {
+            return false;
+        }
 
+        if (p_elem->is_in_hash_table)
+        {
+            METRICS_PIPELINE_CNT_INC(METRICS_PIPELINE_CNT_ADV_TABLE_EVICTED);
+        }
         adv_hash_table_remove(p_elem);
 
         p_elem->adv_report = *p_adv;
         adv_hash_table_add(p_elem);
+        adv_table_hist_reset_unsafe(adv_table_get_elem_idx(p_elem));
         flag_updated = true;
     }
     else
     {
         if (!adv_table_check_if_adv_must_be_discarded(p_adv, &p_elem->adv_report))
         {
+            if (!adv_table_cow_guard_unsafe(p_elem))
+            {
+                return false;
+            }
             const adv_counter_t prev_counter   = p_elem->adv_report.samples_counter;
             p_elem->adv_report                 = *p_adv; // Update data
             p_elem->adv_report.samples_counter = prev_counter + 1;
@@ -201,28 +874,23 @@ adv_table_put_unsafe(const adv_report_t* const p_adv)
         }
         else
         {
+            METRICS_PIPELINE_CNT_INC(METRICS_PIPELINE_CNT_ADV_TABLE_DEDUP);
+            if (!adv_table_cow_guard_unsafe(p_elem))
+            {
+                return false;
+            }
             p_elem->adv_report.samples_counter += 1;
         }
     }
     if (flag_updated)
     {
-        if (!p_elem->is_in_retransmission_list1)
-        {
-            STAILQ_INSERT_TAIL(&g_adv_reports_retransmission_list1, p_elem, retransmission_list1);
-            p_elem->is_in_retransmission_list1 = true;
-        }
-        if (!p_elem->is_in_retransmission_list2)
-        {
-            STAILQ_INSERT_TAIL(&g_adv_reports_retransmission_list2, p_elem, retransmission_list2);
-            p_elem->is_in_retransmission_list2 = true;
-        }
-        if (!p_elem->is_in_retransmission_list3)
+        adv_table_hist_push_unsafe(adv_table_get_elem_idx(p_elem), p_adv);
+        for (uint32_t i = 0; i < ADV_TABLE_NUM_RETRANSMISSION_LISTS; ++i)
         {
-            STAILQ_INSERT_TAIL(&g_adv_reports_retransmission_list3, p_elem, retransmission_list3);
-            p_elem->is_in_retransmission_list3 = true;
+            adv_retransmission_list_insert_tail((adv_table_retransmission_list_e)i, p_elem);
         }
-        TAILQ_REMOVE(&g_adv_reports_hist_list, p_elem, hist_list);
-        TAILQ_INSERT_HEAD(&g_adv_reports_hist_list, p_elem, hist_list);
+        adv_hist_list_remove(p_elem);
+        adv_hist_list_insert_head(p_elem);
     }
     return flag_updated;
 }
@@ -236,67 +904,52 @@ adv_table_put(const adv_report_t* const p_adv)
     return flag_updated;
 }
 
-static void
-adv_table_read_retransmission_list1_and_clear_unsafe(adv_report_table_t* const p_reports)
+num_of_advs_t
+adv_table_put_batch(const adv_report_t* const p_arr_of_advs, const num_of_advs_t num_of_advs)
 {
-    p_reports->num_of_advs = 0;
-    for (;;)
+    num_of_advs_t num_of_updated = 0;
+    os_mutex_lock(gp_adv_reports_mutex);
+    for (num_of_advs_t i = 0; i < num_of_advs; ++i)
     {
-        adv_reports_list_elem_t* p_elem = STAILQ_FIRST(&g_adv_reports_retransmission_list1);
-        if (NULL == p_elem)
+        if (adv_table_put_unsafe(&p_arr_of_advs[i]))
         {
-            break;
-        }
-        STAILQ_REMOVE_HEAD(&g_adv_reports_retransmission_list1, retransmission_list1);
-        p_elem->is_in_retransmission_list1 = false;
-        if (p_reports->num_of_advs >= (sizeof(p_reports->table) / sizeof(p_reports->table[0])))
-        {
-            break;
+            num_of_updated += 1;
         }
-        p_reports->table[p_reports->num_of_advs] = p_elem->adv_report;
-        p_reports->num_of_advs += 1;
     }
+    os_mutex_unlock(gp_adv_reports_mutex);
+    return num_of_updated;
 }
 
-static void
-adv_table_read_retransmission_list2_and_clear_unsafe(adv_report_table_t* const p_reports)
+void
+adv_table_get_retransmission_lists_len(adv_table_retransmission_lists_len_t* const p_lists_len)
 {
-    p_reports->num_of_advs = 0;
-    for (;;)
-    {
-        adv_reports_list_elem_t* p_elem = STAILQ_FIRST(&g_adv_reports_retransmission_list2);
-        if (NULL == p_elem)
-        {
-            break;
-        }
-        STAILQ_REMOVE_HEAD(&g_adv_reports_retransmission_list2, retransmission_list2);
-        p_elem->is_in_retransmission_list2 = false;
-        if (p_reports->num_of_advs >= (sizeof(p_reports->table) / sizeof(p_reports->table[0])))
-        {
-            break;
-        }
-        p_reports->table[p_reports->num_of_advs] = p_elem->adv_report;
-        p_reports->num_of_advs += 1;
-    }
+    os_mutex_lock(gp_adv_reports_mutex);
+    p_lists_len->http_ruuvi  = g_adv_reports_retransmission_list[ADV_TABLE_RETRANSMISSION_LIST1].num_of_elems;
+    p_lists_len->http_custom = g_adv_reports_retransmission_list[ADV_TABLE_RETRANSMISSION_LIST2].num_of_elems;
+    p_lists_len->mqtt        = g_adv_reports_retransmission_list[ADV_TABLE_RETRANSMISSION_LIST3].num_of_elems;
+    os_mutex_unlock(gp_adv_reports_mutex);
+}
+
+uint32_t
+adv_table_get_no_mem_drop_cnt(void)
+{
+    return (uint32_t)atomic_load(&g_adv_table_no_mem_drop_cnt);
 }
 
 static void
-adv_table_read_retransmission_list3_and_clear_unsafe(adv_report_table_t* const p_reports)
+adv_table_read_retransmission_list_and_clear_unsafe(
+    const adv_table_retransmission_list_e list_id,
+    adv_report_table_t* const             p_reports)
 {
     p_reports->num_of_advs = 0;
-    for (;;)
+    // The remaining advs are kept in the retransmission list until the next read.
+    while (p_reports->num_of_advs < (sizeof(p_reports->table) / sizeof(p_reports->table[0])))
     {
-        adv_reports_list_elem_t* p_elem = STAILQ_FIRST(&g_adv_reports_retransmission_list3);
+        const adv_reports_list_elem_t* const p_elem = adv_retransmission_list_remove_head(list_id);
         if (NULL == p_elem)
         {
             break;
         }
-        STAILQ_REMOVE_HEAD(&g_adv_reports_retransmission_list3, retransmission_list3);
-        p_elem->is_in_retransmission_list3 = false;
-        if (p_reports->num_of_advs >= (sizeof(p_reports->table) / sizeof(p_reports->table[0])))
-        {
-            break;
-        }
         p_reports->table[p_reports->num_of_advs] = p_elem->adv_report;
         p_reports->num_of_advs += 1;
     }
@@ -306,7 +959,7 @@ void
 adv_table_read_retransmission_list1_and_clear(adv_report_table_t* const p_reports)
 {
     os_mutex_lock(gp_adv_reports_mutex);
-    adv_table_read_retransmission_list1_and_clear_unsafe(p_reports);
+    adv_table_read_retransmission_list_and_clear_unsafe(ADV_TABLE_RETRANSMISSION_LIST1, p_reports);
     os_mutex_unlock(gp_adv_reports_mutex);
 }
 
@@ -314,7 +967,7 @@ void
 adv_table_read_retransmission_list2_and_clear(adv_report_table_t* const p_reports)
 {
     os_mutex_lock(gp_adv_reports_mutex);
-    adv_table_read_retransmission_list2_and_clear_unsafe(p_reports);
+    adv_table_read_retransmission_list_and_clear_unsafe(ADV_TABLE_RETRANSMISSION_LIST2, p_reports);
     os_mutex_unlock(gp_adv_reports_mutex);
 }
 
@@ -322,24 +975,356 @@ void
 adv_table_read_retransmission_list3_and_clear(adv_report_table_t* const p_reports)
 {
     os_mutex_lock(gp_adv_reports_mutex);
-    adv_table_read_retransmission_list3_and_clear_unsafe(p_reports);
+    adv_table_read_retransmission_list_and_clear_unsafe(ADV_TABLE_RETRANSMISSION_LIST3, p_reports);
     os_mutex_unlock(gp_adv_reports_mutex);
 }
 
 static bool
 adv_table_read_retransmission_list3_head_unsafe(adv_report_t* const p_adv_report)
 {
-    adv_reports_list_elem_t* p_elem = STAILQ_FIRST(&g_adv_reports_retransmission_list3);
+    const adv_reports_list_elem_t* const p_elem = adv_retransmission_list_remove_head(ADV_TABLE_RETRANSMISSION_LIST3);
     if (NULL == p_elem)
     {
         return false;
     }
-    STAILQ_REMOVE_HEAD(&g_adv_reports_retransmission_list3, retransmission_list3);
-    p_elem->is_in_retransmission_list3 = false;
-    *p_adv_report                      = p_elem->adv_report;
+    *p_adv_report = p_elem->adv_report;
+    return true;
+}
+
+/**
+ * @brief Allocate the buffers for the samples of the tags in the retransmission list.
+ * @note The samples are copied to the snapshot, because the rings of the tags are overwritten by the new samples
+ *       while the snapshot is alive.
+ * @return false if there is not enough memory.
+ */
+static bool
+adv_table_snapshot_alloc_hist_unsafe(
+    adv_table_snapshot_t* const           p_snapshot,
+    const adv_table_retransmission_list_e list_id)
+{
+    const adv_report_list_t* const p_list = &g_adv_reports_retransmission_list[list_id];
+    if ((!adv_table_hist_is_enabled()) || (0 == p_list->num_of_elems))
+    {
+        return true;
+    }
+    if (ADV_TABLE_RETRANSMISSION_LIST3 == list_id)
+    {
+        // The samples are sent only to the HTTP targets, the advs for MQTT are published one by one.
+        return true;
+    }
+    num_of_advs_t num_of_recs = 0;
+    for (const adv_reports_list_elem_t* p_elem = adv_table_get_elem(p_list->first); NULL != p_elem;
+         p_elem                                = adv_table_get_elem(p_elem->retransmission_list_next[list_id]))
+    {
+        num_of_recs += adv_table_hist_get_num_of_pending_recs_unsafe(adv_table_get_elem_idx(p_elem), list_id);
+    }
+    p_snapshot->p_hist = os_malloc(p_list->num_of_elems * sizeof(p_snapshot->p_hist[0]));
+    if (NULL == p_snapshot->p_hist)
+    {
+        return false;
+    }
+    if (0 != num_of_recs)
+    {
+        p_snapshot->p_hist_recs = os_malloc(num_of_recs * sizeof(p_snapshot->p_hist_recs[0]));
+        if (NULL == p_snapshot->p_hist_recs)
+        {
+            os_free(p_snapshot->p_hist);
+            return false;
+        }
+    }
+    return true;
+}
+
+static adv_table_snapshot_t*
+adv_table_read_retransmission_list_snapshot_and_clear_unsafe(const adv_table_retransmission_list_e list_id)
+{
+    const adv_report_list_t* const p_list = &g_adv_reports_retransmission_list[list_id];
+
+    adv_table_snapshot_t* p_snapshot = os_malloc(
+        sizeof(*p_snapshot) + (p_list->num_of_elems * sizeof(p_snapshot->idx[0])));
+    if (NULL == p_snapshot)
+    {
+        return NULL;
+    }
+    p_snapshot->generation      = g_adv_table_generation;
+    p_snapshot->ref_cnt         = 1;
+    p_snapshot->num_of_advs     = 0;
+    p_snapshot->p_detached_advs = NULL;
+    p_snapshot->p_hist          = NULL;
+    p_snapshot->p_hist_recs     = NULL;
+    if (!adv_table_snapshot_alloc_hist_unsafe(p_snapshot, list_id))
+    {
+        os_free(p_snapshot);
+        return NULL;
+    }
+    num_of_advs_t rec_idx = 0;
+    for (;;)
+    {
+        adv_reports_list_elem_t* const p_elem = adv_retransmission_list_remove_head(list_id);
+        if (NULL == p_elem)
+        {
+            break;
+        }
+        p_elem->snapshot_ref_cnt += 1;
+        if (NULL != p_snapshot->p_hist)
+        {
+            adv_table_snapshot_hist_t* const p_hist = &p_snapshot->p_hist[p_snapshot->num_of_advs];
+            p_hist->rec_idx                         = rec_idx;
+            rec_idx += adv_table_hist_take_pending_recs_unsafe(
+                adv_table_get_elem_idx(p_elem),
+                list_id,
+                p_hist,
+                &p_snapshot->p_hist_recs[rec_idx]);
+        }
+        p_snapshot->idx[p_snapshot->num_of_advs] = adv_table_get_elem_idx(p_elem);
+        p_snapshot->num_of_advs += 1;
+    }
+    // The elements modified after this point must be copied before modification while they are in the snapshot.
+    g_adv_table_generation += 1;
+
+    p_snapshot->p_prev = g_adv_table_snapshots.p_last;
+    p_snapshot->p_next = NULL;
+    if (NULL == g_adv_table_snapshots.p_last)
+    {
+        g_adv_table_snapshots.p_first = p_snapshot;
+    }
+    else
+    {
+        g_adv_table_snapshots.p_last->p_next = p_snapshot;
+    }
+    g_adv_table_snapshots.p_last = p_snapshot;
+    return p_snapshot;
+}
+
+adv_table_snapshot_t*
+adv_table_read_retransmission_list1_snapshot_and_clear(void)
+{
+    os_mutex_lock(gp_adv_reports_mutex);
+    adv_table_snapshot_t* const p_snapshot = adv_table_read_retransmission_list_snapshot_and_clear_unsafe(
+        ADV_TABLE_RETRANSMISSION_LIST1);
+    os_mutex_unlock(gp_adv_reports_mutex);
+    return p_snapshot;
+}
+
+adv_table_snapshot_t*
+adv_table_read_retransmission_list2_snapshot_and_clear(void)
+{
+    os_mutex_lock(gp_adv_reports_mutex);
+    adv_table_snapshot_t* const p_snapshot = adv_table_read_retransmission_list_snapshot_and_clear_unsafe(
+        ADV_TABLE_RETRANSMISSION_LIST2);
+    os_mutex_unlock(gp_adv_reports_mutex);
+    return p_snapshot;
+}
+
+adv_table_snapshot_t*
+adv_table_read_retransmission_list3_snapshot_and_clear(void)
+{
+    os_mutex_lock(gp_adv_reports_mutex);
+    adv_table_snapshot_t* const p_snapshot = adv_table_read_retransmission_list_snapshot_and_clear_unsafe(
+        ADV_TABLE_RETRANSMISSION_LIST3);
+    os_mutex_unlock(gp_adv_reports_mutex);
+    return p_snapshot;
+}
+
+adv_table_snapshot_t*
+adv_table_snapshot_create_detached(adv_report_t* p_arr_of_advs, const num_of_advs_t num_of_advs)
+{
+    adv_table_snapshot_t* const p_snapshot = os_malloc(sizeof(*p_snapshot));
+    if (NULL == p_snapshot)
+    {
+        os_free(p_arr_of_advs);
+        return NULL;
+    }
+    p_snapshot->p_prev          = NULL;
+    p_snapshot->p_next          = NULL;
+    p_snapshot->generation      = 0;
+    p_snapshot->ref_cnt         = 1;
+    p_snapshot->num_of_advs     = num_of_advs;
+    p_snapshot->p_detached_advs = p_arr_of_advs;
+    p_snapshot->p_hist          = NULL;
+    p_snapshot->p_hist_recs     = NULL;
+    return p_snapshot;
+}
+
+num_of_advs_t
+adv_table_snapshot_get_num_of_advs(const adv_table_snapshot_t* const p_snapshot)
+{
+    if (NULL == p_snapshot)
+    {
+        return 0;
+    }
+    return p_snapshot->num_of_advs;
+}
+
+static const adv_report_t*
+adv_table_snapshot_get_adv_unsafe(const adv_table_snapshot_t* const p_snapshot, const num_of_advs_t idx)
+{
+    if (NULL != p_snapshot->p_detached_advs)
+    {
+        return &p_snapshot->p_detached_advs[idx];
+    }
+    const adv_reports_list_elem_t* const p_elem = adv_table_get_elem(p_snapshot->idx[idx]);
+    if (p_elem->generation <= p_snapshot->generation)
+    {
+        return &p_elem->adv_report;
+    }
+    for (const adv_table_cow_copy_t* p_copy = p_elem->p_cow_copies; NULL != p_copy; p_copy = p_copy->p_next)
+    {
+        if ((p_copy->generation_begin <= p_snapshot->generation) && (p_snapshot->generation < p_copy->generation_end))
+        {
+            return &p_copy->adv_report;
+        }
+    }
+    return NULL;
+}
+
+bool
+adv_table_snapshot_get_adv(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    adv_report_t* const               p_adv_report)
+{
+    if ((NULL == p_snapshot) || (idx >= p_snapshot->num_of_advs))
+    {
+        return false;
+    }
+    os_mutex_lock(gp_adv_reports_mutex);
+    const adv_report_t* const p_adv = adv_table_snapshot_get_adv_unsafe(p_snapshot, idx);
+    if (NULL != p_adv)
+    {
+        *p_adv_report = *p_adv;
+    }
+    os_mutex_unlock(gp_adv_reports_mutex);
+    return (NULL != p_adv) ? true : false;
+}
+
+num_of_advs_t
+adv_table_snapshot_get_num_of_samples(const adv_table_snapshot_t* const p_snapshot, const num_of_advs_t idx)
+{
+    if ((NULL == p_snapshot) || (idx >= p_snapshot->num_of_advs) || (NULL == p_snapshot->p_hist))
+    {
+        return 0;
+    }
+    return p_snapshot->p_hist[idx].num_of_recs;
+}
+
+bool
+adv_table_snapshot_get_sample(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    const num_of_advs_t               sample_idx,
+    adv_report_t* const               p_adv_report)
+{
+    if (sample_idx >= adv_table_snapshot_get_num_of_samples(p_snapshot, idx))
+    {
+        return false;
+    }
+    if (!adv_table_snapshot_get_adv(p_snapshot, idx, p_adv_report))
+    {
+        return false;
+    }
+    // The samples are owned by the snapshot and they are immutable, so the mutex is not needed.
+    const adv_table_snapshot_hist_t* const p_hist = &p_snapshot->p_hist[idx];
+    const adv_table_hist_rec_t* const      p_recs = &p_snapshot->p_hist_recs[p_hist->rec_idx];
+    time_t                                 timestamp = p_hist->timestamp_first;
+    for (num_of_advs_t i = 1; i <= sample_idx; ++i)
+    {
+        timestamp += p_recs[i].timestamp_delta;
+    }
+    const adv_table_hist_rec_t* const p_rec = &p_recs[sample_idx];
+    p_adv_report->timestamp                 = timestamp;
+    p_adv_report->rssi                      = p_rec->rssi;
+    p_adv_report->data_len                  = p_rec->data_len;
+    memset(p_adv_report->data_buf, 0, sizeof(p_adv_report->data_buf));
+    memcpy(p_adv_report->data_buf, p_rec->data_buf, p_rec->data_len);
     return true;
 }
 
+adv_table_snapshot_t*
+adv_table_snapshot_ref(adv_table_snapshot_t* const p_snapshot)
+{
+    if (NULL == p_snapshot)
+    {
+        return NULL;
+    }
+    os_mutex_lock(gp_adv_reports_mutex);
+    p_snapshot->ref_cnt += 1;
+    os_mutex_unlock(gp_adv_reports_mutex);
+    return p_snapshot;
+}
+
+static void
+adv_table_snapshot_release_unsafe(adv_table_snapshot_t* p_snapshot)
+{
+    p_snapshot->ref_cnt -= 1;
+    if (0 != p_snapshot->ref_cnt)
+    {
+        return;
+    }
+    if (NULL != p_snapshot->p_detached_advs)
+    {
+        os_free(p_snapshot->p_detached_advs);
+        os_free(p_snapshot);
+        return;
+    }
+    for (num_of_advs_t i = 0; i < p_snapshot->num_of_advs; ++i)
+    {
+        adv_reports_list_elem_t* const p_elem = adv_table_get_elem(p_snapshot->idx[i]);
+        p_elem->snapshot_ref_cnt -= 1;
+    }
+    if (NULL != p_snapshot->p_hist_recs)
+    {
+        os_free(p_snapshot->p_hist_recs);
+    }
+    if (NULL != p_snapshot->p_hist)
+    {
+        os_free(p_snapshot->p_hist);
+    }
+
+    if (NULL == p_snapshot->p_prev)
+    {
+        g_adv_table_snapshots.p_first = p_snapshot->p_next;
+    }
+    else
+    {
+        p_snapshot->p_prev->p_next = p_snapshot->p_next;
+    }
+    if (NULL == p_snapshot->p_next)
+    {
+        g_adv_table_snapshots.p_last = p_snapshot->p_prev;
+    }
+    else
+    {
+        p_snapshot->p_next->p_prev = p_snapshot->p_prev;
+    }
+    os_free(p_snapshot);
+
+    // The copies which were visible only to the released snapshot are not needed anymore,
+    // it's done for all the elements, because the copy is kept for the generation and not for the snapshot.
+    for (uint32_t i = 0; i < (sizeof(g_arr_of_adv_reports) / sizeof(g_arr_of_adv_reports[0])); ++i)
+    {
+        adv_reports_list_elem_t* const p_elem = &g_arr_of_adv_reports[i];
+        if (NULL != p_elem->p_cow_copies)
+        {
+            adv_table_cow_copies_gc_unsafe(p_elem);
+        }
+    }
+}
+
+void
+adv_table_snapshot_release(adv_table_snapshot_t** const p_p_snapshot)
+{
+    adv_table_snapshot_t* const p_snapshot = *p_p_snapshot;
+    if (NULL == p_snapshot)
+    {
+        return;
+    }
+    *p_p_snapshot = NULL;
+    os_mutex_lock(gp_adv_reports_mutex);
+    adv_table_snapshot_release_unsafe(p_snapshot);
+    os_mutex_unlock(gp_adv_reports_mutex);
+}
+
 bool
 adv_table_read_retransmission_list3_head(adv_report_t* const p_adv_report)
 {
@@ -353,7 +1338,8 @@ bool
 adv_table_read_retransmission_list3_is_empty(void)
 {
     os_mutex_lock(gp_adv_reports_mutex);
-    const bool is_empty = (NULL == STAILQ_FIRST(&g_adv_reports_retransmission_list3)) ? true : false;
+    const adv_report_list_t* const p_list = &g_adv_reports_retransmission_list[ADV_TABLE_RETRANSMISSION_LIST3];
+    const bool                     is_empty = (ADV_TABLE_IDX_NONE == p_list->first) ? true : false;
     os_mutex_unlock(gp_adv_reports_mutex);
     return is_empty;
 }
@@ -368,8 +1354,8 @@ adv_table_read_history_unsafe(
 {
     p_reports->num_of_advs = 0;
 
-    adv_reports_list_elem_t* p_elem = NULL;
-    TAILQ_FOREACH(p_elem, &g_adv_reports_hist_list, hist_list)
+    for (const adv_reports_list_elem_t* p_elem = adv_table_get_elem(g_adv_reports_hist_list.first); NULL != p_elem;
+         p_elem                                = adv_table_get_elem(p_elem->hist_list_next))
     {
         if (p_reports->num_of_advs >= (sizeof(p_reports->table) / sizeof(p_reports->table[0])))
         {
@@ -417,8 +1403,8 @@ adv_table_read_statistics_unsafe(adv_report_table_t* const p_reports)
 {
     p_reports->num_of_advs = 0;
 
-    adv_reports_list_elem_t* p_elem = NULL;
-    TAILQ_FOREACH(p_elem, &g_adv_reports_hist_list, hist_list)
+    for (adv_reports_list_elem_t* p_elem = adv_table_get_elem(g_adv_reports_hist_list.first); NULL != p_elem;
+         p_elem                          = adv_table_get_elem(p_elem->hist_list_next))
     {
         if (p_reports->num_of_advs >= (sizeof(p_reports->table) / sizeof(p_reports->table[0])))
         {
@@ -429,7 +1415,12 @@ adv_table_read_statistics_unsafe(adv_report_table_t* const p_reports)
             break;
         }
         p_reports->table[p_reports->num_of_advs] = p_elem->adv_report;
-        p_elem->adv_report.samples_counter       = 0;
+        if (!adv_table_cow_guard_unsafe(p_elem))
+        {
+            // Not enough memory to preserve the content for the snapshots - they will skip this element
+            p_elem->generation = g_adv_table_generation;
+        }
+        p_elem->adv_report.samples_counter = 0;
         p_reports->num_of_advs += 1;
     }
 }
@@ -443,64 +1434,35 @@ adv_table_statistics_read(adv_report_table_t* const p_reports)
 }
 
 static void
-adv_retransmission_list1_clear_unsafe(void)
+adv_retransmission_list_clear_unsafe(const adv_table_retransmission_list_e list_id)
 {
-    while (1)
+    while (NULL != adv_retransmission_list_remove_head(list_id))
     {
-        adv_reports_list_elem_t* p_elem = STAILQ_FIRST(&g_adv_reports_retransmission_list1);
-        if (NULL == p_elem)
-        {
-            break;
-        }
-        STAILQ_REMOVE_HEAD(&g_adv_reports_retransmission_list1, retransmission_list1);
-        p_elem->is_in_retransmission_list1 = false;
+        // Remove all the elements from the list
     }
 }
 
-static void
-adv_retransmission_list2_clear_unsafe(void)
+void
+adv_table_clear(void)
 {
-    while (1)
+    os_mutex_lock(gp_adv_reports_mutex);
+    for (uint32_t i = 0; i < ADV_TABLE_NUM_RETRANSMISSION_LISTS; ++i)
     {
-        adv_reports_list_elem_t* p_elem = STAILQ_FIRST(&g_adv_reports_retransmission_list2);
-        if (NULL == p_elem)
-        {
-            break;
-        }
-        STAILQ_REMOVE_HEAD(&g_adv_reports_retransmission_list2, retransmission_list2);
-        p_elem->is_in_retransmission_list2 = false;
+        adv_retransmission_list_clear_unsafe((adv_table_retransmission_list_e)i);
     }
-}
 
-static void
-adv_retransmission_list3_clear_unsafe(void)
-{
-    while (1)
+    for (adv_reports_list_elem_t* p_elem = adv_table_get_elem(g_adv_reports_hist_list.first); NULL != p_elem;
+         p_elem                          = adv_table_get_elem(p_elem->hist_list_next))
     {
-        adv_reports_list_elem_t* p_elem = STAILQ_FIRST(&g_adv_reports_retransmission_list3);
-        if (NULL == p_elem)
+        if (!adv_table_cow_guard_unsafe(p_elem))
         {
-            break;
+            // Not enough memory to preserve the content for the snapshots - they will skip this element
+            p_elem->generation = g_adv_table_generation;
         }
-        STAILQ_REMOVE_HEAD(&g_adv_reports_retransmission_list3, retransmission_list3);
-        p_elem->is_in_retransmission_list3 = false;
-    }
-}
-
-void
-adv_table_clear(void)
-{
-    os_mutex_lock(gp_adv_reports_mutex);
-    adv_retransmission_list1_clear_unsafe();
-    adv_retransmission_list2_clear_unsafe();
-    adv_retransmission_list3_clear_unsafe();
-
-    adv_reports_list_elem_t* p_elem = NULL;
-    TAILQ_FOREACH(p_elem, &g_adv_reports_hist_list, hist_list)
-    {
         p_elem->adv_report.timestamp       = 0;
         p_elem->adv_report.samples_counter = 0;
         p_elem->adv_report.data_len        = 0; // mark adv_report as free in hist_list
+        adv_table_hist_reset_unsafe(adv_table_get_elem_idx(p_elem));
     }
 
     os_mutex_unlock(gp_adv_reports_mutex);
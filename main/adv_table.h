@@ -29,8 +29,32 @@ extern "C" {
 #define ADV_TABLE_STATIC static
 #endif
 
+/**
+ * @brief The maximum number of tags tracked by adv_table (the size of its storage and hash table),
+ *        it can be overridden at build time (see RUUVI_ADV_TABLE_CAPACITY in the top-level CMakeLists.txt).
+ * @note The least recently updated tag is evicted when a new tag is received and the table is full.
+ */
+#if !defined(ADV_TABLE_CAPACITY)
+#define ADV_TABLE_CAPACITY (GW_CFG_MAX_NUM_SENSORS)
+#endif
+
+/**
+ * @brief The maximum number of tags in adv_report_table_t, it does not depend on ADV_TABLE_CAPACITY,
+ *        if there are more tags in adv_table, then only MAX_ADVS_TABLE of them are read at once.
+ */
 #define MAX_ADVS_TABLE (GW_CFG_MAX_NUM_SENSORS)
 
+/**
+ * @brief The depth of the per-tag history of samples (0 - disabled), it can be overridden at build time
+ *        (see RUUVI_ADV_TABLE_HIST_DEPTH in the top-level CMakeLists.txt).
+ * @note When the history is enabled, up to ADV_TABLE_HIST_DEPTH measurements of every tag received since
+ *       the previous snapshot of a retransmission list are kept and can be read with adv_table_snapshot_get_sample,
+ *       otherwise only the latest measurement is available and the others are counted in samples_counter.
+ */
+#if !defined(ADV_TABLE_HIST_DEPTH)
+#define ADV_TABLE_HIST_DEPTH (0)
+#endif
+
 typedef int8_t   wifi_rssi_t;
 typedef uint8_t  ble_data_len_t;
 typedef uint32_t adv_counter_t;
@@ -48,6 +72,7 @@ typedef struct adv_report_t
     int8_t            tx_power;
     ble_data_len_t    data_len;
     uint8_t           data_buf[ADV_DATA_MAX_LEN];
+    uint32_t          recv_tick; //<! xTaskGetTickCount() when the adv was received from nRF52, 0 - unknown
 } adv_report_t;
 
 typedef uint32_t num_of_advs_t;
@@ -58,15 +83,62 @@ typedef struct adv_report_table_t
     adv_report_t  table[MAX_ADVS_TABLE];
 } adv_report_table_t;
 
+/**
+ * @brief Reference-counted snapshot of a retransmission list.
+ * @note The snapshot contains only the indices of the changed tags in adv_table (2 bytes per tag),
+ *       the content of the tags is read from adv_table on demand by adv_table_snapshot_get_adv.
+ *       The content seen through the snapshot does not change while the snapshot is alive (copy-on-write):
+ *       if a tag is updated after the snapshot was taken, its previous content is preserved for the snapshot,
+ *       so the snapshot can be used as the data source for json_stream_gen which may be run several times.
+ */
+typedef struct adv_table_snapshot_t adv_table_snapshot_t;
+
 void
 adv_table_init(void);
 
 void
 adv_table_deinit(void);
 
+/**
+ * @brief Check if the history of samples is enabled.
+ * @return false if it's disabled at build time or the configured depth does not fit into the heap.
+ */
+bool
+adv_table_hist_is_enabled(void);
+
 bool
 adv_table_put(const adv_report_t* const p_adv);
 
+/**
+ * @brief Put several advertisements to adv_table under a single lock of the table.
+ * @param p_arr_of_advs - ptr to the array of advertisements
+ * @param num_of_advs - number of advertisements in the array
+ * @return number of advertisements which updated the table
+ *         (the others were skipped because the same data is already in the table).
+ */
+num_of_advs_t
+adv_table_put_batch(const adv_report_t* const p_arr_of_advs, const num_of_advs_t num_of_advs);
+
+/**
+ * @brief The number of advertisements waiting in the retransmission lists.
+ */
+typedef struct adv_table_retransmission_lists_len_t
+{
+    num_of_advs_t http_ruuvi;  //<! The list of HTTP POSTs to the Ruuvi cloud
+    num_of_advs_t http_custom; //<! The list of HTTP POSTs to the custom HTTP target
+    num_of_advs_t mqtt;        //<! The list of MQTT publications
+} adv_table_retransmission_lists_len_t;
+
+void
+adv_table_get_retransmission_lists_len(adv_table_retransmission_lists_len_t* const p_lists_len);
+
+/**
+ * @brief Get the number of advertisements dropped since adv_table_init, because there was not enough memory
+ *        to preserve the previous content of the tag for a snapshot (copy-on-write).
+ */
+uint32_t
+adv_table_get_no_mem_drop_cnt(void);
+
 void
 adv_table_read_retransmission_list1_and_clear(adv_report_table_t* const p_reports);
 
@@ -76,6 +148,84 @@ adv_table_read_retransmission_list2_and_clear(adv_report_table_t* const p_report
 void
 adv_table_read_retransmission_list3_and_clear(adv_report_table_t* const p_reports);
 
+/**
+ * @brief Take a snapshot of the retransmission list and clear the list.
+ * @return ptr to the snapshot (with the reference counter set to 1) or NULL if there is not enough memory,
+ *         in this case the retransmission list is not cleared.
+ */
+adv_table_snapshot_t*
+adv_table_read_retransmission_list1_snapshot_and_clear(void);
+
+adv_table_snapshot_t*
+adv_table_read_retransmission_list2_snapshot_and_clear(void);
+
+adv_table_snapshot_t*
+adv_table_read_retransmission_list3_snapshot_and_clear(void);
+
+/**
+ * @brief Create a snapshot which is not linked to adv_table (e.g. for the advs restored from the spool).
+ * @param p_arr_of_advs - ptr to the array allocated with os_malloc, the snapshot takes ownership of it
+ *                        (it's freed by this function if there is not enough memory).
+ * @param num_of_advs - number of advs in the array
+ * @return ptr to the snapshot (with the reference counter set to 1) or NULL if there is not enough memory.
+ */
+adv_table_snapshot_t*
+adv_table_snapshot_create_detached(adv_report_t* p_arr_of_advs, const num_of_advs_t num_of_advs);
+
+num_of_advs_t
+adv_table_snapshot_get_num_of_advs(const adv_table_snapshot_t* const p_snapshot);
+
+/**
+ * @brief Read the content of a tag from the snapshot.
+ * @param p_snapshot - ptr to the snapshot
+ * @param idx - index of the tag in the snapshot
+ * @param[out] p_adv_report - ptr to the buffer for the content of the tag
+ * @return false if idx is out of range or if the content of the tag was lost because of lack of memory.
+ */
+bool
+adv_table_snapshot_get_adv(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    adv_report_t* const               p_adv_report);
+
+/**
+ * @brief Get the number of samples of the tag received since the previous snapshot of the same retransmission list.
+ * @param p_snapshot - ptr to the snapshot
+ * @param idx - index of the tag in the snapshot
+ * @return number of samples, 0 if the history is disabled or idx is out of range.
+ */
+num_of_advs_t
+adv_table_snapshot_get_num_of_samples(const adv_table_snapshot_t* const p_snapshot, const num_of_advs_t idx);
+
+/**
+ * @brief Read a sample of the tag from the snapshot, the samples are ordered from the oldest to the newest.
+ * @param p_snapshot - ptr to the snapshot
+ * @param idx - index of the tag in the snapshot
+ * @param sample_idx - index of the sample
+ * @param[out] p_adv_report - ptr to the buffer for the content of the tag with timestamp, rssi and data of the sample
+ * @return false if idx or sample_idx is out of range or if the content of the tag was lost because of lack of memory.
+ */
+bool
+adv_table_snapshot_get_sample(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    const num_of_advs_t               sample_idx,
+    adv_report_t* const               p_adv_report);
+
+/**
+ * @brief Increment the reference counter of the snapshot.
+ * @return p_snapshot
+ */
+adv_table_snapshot_t*
+adv_table_snapshot_ref(adv_table_snapshot_t* const p_snapshot);
+
+/**
+ * @brief Decrement the reference counter of the snapshot and free it when the counter reaches zero.
+ * @param p_p_snapshot - ptr to the variable with ptr to the snapshot, it's set to NULL.
+ */
+void
+adv_table_snapshot_release(adv_table_snapshot_t** const p_p_snapshot);
+
 bool
 adv_table_read_retransmission_list3_head(adv_report_t* const p_adv_report);
 
@@ -102,6 +252,10 @@ ADV_TABLE_STATIC
 uint32_t
 adv_report_calc_hash(const mac_address_bin_t* const p_mac);
 
+ADV_TABLE_STATIC
+uint32_t
+adv_hash_table_calc_home_slot(const mac_address_bin_t* const p_mac);
+
 #endif /* RUUVI_TESTS_ADV_TABLE */
 
 #ifdef __cplusplus
@@ -0,0 +1,129 @@
+/**
+ * @file boot_seq.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "boot_seq.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "os_task.h"
+
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#include "log.h"
+
+static const char TAG[] = "boot_seq";
+
+#define BOOT_SEQ_STAGE_BIT(stage_) ((EventBits_t)1U << (uint32_t)(stage_))
+
+#define BOOT_SEQ_BIT_ASYNC_STARTED ((EventBits_t)1U << (uint32_t)METRICS_BOOT_STAGE_NUM)
+
+/**
+ * @brief The same priority as the main task (app_main), so the async stages share the CPU with it.
+ */
+#define BOOT_SEQ_ASYNC_TASK_PRIORITY (1)
+
+_Static_assert(METRICS_BOOT_STAGE_NUM < 24, "Event group has only 24 bits");
+
+/**
+ * @brief Dependencies of the boot stages (bit mask of the stages which must be finished before the stage is started).
+ * @note GWUI partition is not needed until Wi-Fi is started, so it can be mounted in parallel with the nRF52 check.
+ */
+static const EventBits_t g_boot_seq_stage_deps[METRICS_BOOT_STAGE_NUM] = {
+    [METRICS_BOOT_STAGE_NVS_INIT]        = 0,
+    [METRICS_BOOT_STAGE_GW_CFG_INIT]     = BOOT_SEQ_STAGE_BIT(METRICS_BOOT_STAGE_NVS_INIT),
+    [METRICS_BOOT_STAGE_GWUI_MOUNT]      = 0,
+    [METRICS_BOOT_STAGE_NRF52_FW_CHECK]  = BOOT_SEQ_STAGE_BIT(METRICS_BOOT_STAGE_GW_CFG_INIT),
+    [METRICS_BOOT_STAGE_ADV_POST_INIT]   = BOOT_SEQ_STAGE_BIT(METRICS_BOOT_STAGE_NRF52_FW_CHECK),
+    [METRICS_BOOT_STAGE_NRF52_DEVICE_ID] = BOOT_SEQ_STAGE_BIT(METRICS_BOOT_STAGE_ADV_POST_INIT),
+    [METRICS_BOOT_STAGE_NETWORK_INIT]    = BOOT_SEQ_STAGE_BIT(METRICS_BOOT_STAGE_NRF52_DEVICE_ID)
+                                        | BOOT_SEQ_STAGE_BIT(METRICS_BOOT_STAGE_GWUI_MOUNT),
+};
+
+static EventGroupHandle_t g_p_boot_seq_ev_grp;
+static StaticEventGroup_t g_boot_seq_ev_grp_mem;
+static bool               g_boot_seq_result[METRICS_BOOT_STAGE_NUM];
+
+// The parameters of the async stage are passed to the new thread via these variables,
+// boot_seq_start_async waits until the thread copies them (BOOT_SEQ_BIT_ASYNC_STARTED).
+static metrics_boot_stage_e g_boot_seq_async_stage;
+static boot_seq_stage_cb_t  g_boot_seq_async_cb;
+
+bool
+boot_seq_init(void)
+{
+    g_p_boot_seq_ev_grp = xEventGroupCreateStatic(&g_boot_seq_ev_grp_mem);
+    if (NULL == g_p_boot_seq_ev_grp)
+    {
+        LOG_ERR("%s failed", "xEventGroupCreateStatic");
+        return false;
+    }
+    for (uint32_t i = 0; i < METRICS_BOOT_STAGE_NUM; ++i)
+    {
+        g_boot_seq_result[i] = false;
+    }
+    return true;
+}
+
+void
+boot_seq_begin(const metrics_boot_stage_e stage)
+{
+    const EventBits_t deps = g_boot_seq_stage_deps[stage];
+    if (deps != (xEventGroupGetBits(g_p_boot_seq_ev_grp) & deps))
+    {
+        LOG_INFO("### Boot stage '%s': wait for dependencies", metrics_boot_stage_get_name(stage));
+        (void)xEventGroupWaitBits(g_p_boot_seq_ev_grp, deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    LOG_INFO("### Boot stage '%s': begin", metrics_boot_stage_get_name(stage));
+    metrics_boot_stage_begin(stage);
+}
+
+void
+boot_seq_end(const metrics_boot_stage_e stage, const bool result)
+{
+    metrics_boot_stage_end(stage);
+    LOG_INFO("### Boot stage '%s': end (%s)", metrics_boot_stage_get_name(stage), result ? "success" : "failure");
+    g_boot_seq_result[stage] = result;
+    (void)xEventGroupSetBits(g_p_boot_seq_ev_grp, BOOT_SEQ_STAGE_BIT(stage));
+}
+
+static void
+boot_seq_async_task(void)
+{
+    const metrics_boot_stage_e stage = g_boot_seq_async_stage;
+    const boot_seq_stage_cb_t  p_cb  = g_boot_seq_async_cb;
+    (void)xEventGroupSetBits(g_p_boot_seq_ev_grp, BOOT_SEQ_BIT_ASYNC_STARTED);
+
+    boot_seq_begin(stage);
+    const bool result = p_cb();
+    boot_seq_end(stage, result);
+}
+
+bool
+boot_seq_start_async(const metrics_boot_stage_e stage, boot_seq_stage_cb_t p_cb, const uint32_t stack_size)
+{
+    (void)xEventGroupClearBits(g_p_boot_seq_ev_grp, BOOT_SEQ_BIT_ASYNC_STARTED);
+    g_boot_seq_async_stage = stage;
+    g_boot_seq_async_cb    = p_cb;
+    if (!os_task_create_finite_without_param(
+            &boot_seq_async_task,
+            "boot_seq",
+            stack_size,
+            BOOT_SEQ_ASYNC_TASK_PRIORITY))
+    {
+        LOG_ERR("Can't create thread for boot stage '%s'", metrics_boot_stage_get_name(stage));
+        boot_seq_begin(stage);
+        boot_seq_end(stage, false);
+        return false;
+    }
+    (void)xEventGroupWaitBits(g_p_boot_seq_ev_grp, BOOT_SEQ_BIT_ASYNC_STARTED, pdTRUE, pdTRUE, portMAX_DELAY);
+    return true;
+}
+
+bool
+boot_seq_wait(const metrics_boot_stage_e stage)
+{
+    (void)xEventGroupWaitBits(g_p_boot_seq_ev_grp, BOOT_SEQ_STAGE_BIT(stage), pdFALSE, pdTRUE, portMAX_DELAY);
+    return g_boot_seq_result[stage];
+}
@@ -0,0 +1,71 @@
+/**
+ * @file boot_seq.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ * @brief Sequencer of the boot stages: dependencies between the stages, asynchronous stages and their timestamps.
+ *
+ * The dependencies of each stage are described by a static table in boot_seq.c, boot_seq_begin waits until all of
+ * them are finished, so the stages which do not depend on each other can be executed in parallel by starting
+ * them with boot_seq_start_async. The timestamps of the stages are saved to metrics (see metrics_boot_stage_begin).
+ */
+
+#ifndef RUUVI_GATEWAY_ESP_BOOT_SEQ_H
+#define RUUVI_GATEWAY_ESP_BOOT_SEQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "metrics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef bool (*boot_seq_stage_cb_t)(void);
+
+/**
+ * @brief Initialize the boot sequencer, it must be called before any other boot_seq function.
+ * @return false if there is not enough memory.
+ */
+bool
+boot_seq_init(void);
+
+/**
+ * @brief Wait until all the dependencies of the stage are finished and save the time when the stage was started.
+ * @param stage - the boot stage
+ */
+void
+boot_seq_begin(const metrics_boot_stage_e stage);
+
+/**
+ * @brief Mark the stage as finished, this unblocks the stages which depend on it.
+ * @param stage - the boot stage
+ * @param result - the result of the stage which is returned by boot_seq_wait
+ */
+void
+boot_seq_end(const metrics_boot_stage_e stage, const bool result);
+
+/**
+ * @brief Execute the stage in a separate thread (boot_seq_begin + p_cb + boot_seq_end).
+ * @note If the thread can't be created, then the stage is marked as finished with the result false.
+ * @param stage - the boot stage
+ * @param p_cb - ptr to the function which implements the stage
+ * @param stack_size - stack size for the thread
+ * @return false if the thread can't be created.
+ */
+bool
+boot_seq_start_async(const metrics_boot_stage_e stage, boot_seq_stage_cb_t p_cb, const uint32_t stack_size);
+
+/**
+ * @brief Wait until the stage is finished.
+ * @param stage - the boot stage
+ * @return the result which was passed to boot_seq_end.
+ */
+bool
+boot_seq_wait(const metrics_boot_stage_e stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_ESP_BOOT_SEQ_H
@@ -7,7 +7,10 @@
 
 #include "event_mgr.h"
 #include <assert.h>
+#include <stdatomic.h>
 #include <esp_attr.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "os_mutex.h"
 #include "os_signal.h"
 #include "sys/queue.h"
@@ -36,6 +39,17 @@ typedef struct event_mgr_queue_of_subscribers_t
     TAILQ_HEAD(event_mgr_queue_of_subscribers_head_t, event_mgr_ev_info_t) head;
 } event_mgr_queue_of_subscribers_t;
 
+/**
+ * @note All fields in this struct must be 32-bit aligned because IRAM_ATTR is used.
+ */
+typedef struct event_mgr_edge_trig_t
+{
+    uint32_t    max_coalescing_period_ticks; //<! 0 - the event is level-triggered
+    atomic_uint flag_pending;                //<! The subscribers have been notified, but not acknowledged yet
+    atomic_uint last_notify_tick;
+    atomic_uint cnt_suppressed;
+} event_mgr_edge_trig_t;
+
 /**
  * @note All fields in this struct must be 32-bit aligned because IRAM_ATTR is used.
  */
@@ -43,6 +57,7 @@ struct event_mgr_t
 {
     os_mutex_t                       h_mutex;
     event_mgr_queue_of_subscribers_t events[EVENT_MGR_EV_LAST];
+    event_mgr_edge_trig_t            edge_trig[EVENT_MGR_EV_LAST];
 };
 
 static const char TAG[] = "event_mgr";
@@ -63,6 +78,11 @@ event_mgr_init(void)
     {
         const event_mgr_ev_e ev = (const event_mgr_ev_e)i;
         TAILQ_INIT(&p_obj->events[ev].head);
+        event_mgr_edge_trig_t* const p_edge_trig = &p_obj->edge_trig[ev];
+        p_edge_trig->max_coalescing_period_ticks = 0;
+        atomic_store(&p_edge_trig->flag_pending, 0U);
+        atomic_store(&p_edge_trig->last_notify_tick, 0U);
+        atomic_store(&p_edge_trig->cnt_suppressed, 0U);
     }
     return true;
 }
@@ -129,6 +149,7 @@ event_mgr_subscribe_sig(const event_mgr_ev_e event, os_signal_t* const p_signal,
     event_mgr_mutex_lock(p_obj);
     event_mgr_queue_of_subscribers_t* const p_queue_of_subscribers = &p_obj->events[event];
     TAILQ_INSERT_TAIL(&p_queue_of_subscribers->head, p_ev_info, list);
+    atomic_store(&p_obj->edge_trig[event].flag_pending, 0U); // The new subscriber must receive the next notification
     event_mgr_mutex_unlock(p_obj);
     return true;
 }
@@ -152,6 +173,7 @@ event_mgr_subscribe_sig_static(
     event_mgr_mutex_lock(p_obj);
     event_mgr_queue_of_subscribers_t* const p_queue_of_subscribers = &p_obj->events[event];
     TAILQ_INSERT_TAIL(&p_queue_of_subscribers->head, p_ev_info, list);
+    atomic_store(&p_obj->edge_trig[event].flag_pending, 0U); // The new subscriber must receive the next notification
     event_mgr_mutex_unlock(p_obj);
 }
 
@@ -211,6 +233,25 @@ event_mgr_unsubscribe_sig_static(event_mgr_ev_info_static_t* const p_ev_info_mem
     event_mgr_mutex_unlock(p_obj);
 }
 
+static bool
+event_mgr_is_notification_suppressed(event_mgr_edge_trig_t* const p_edge_trig)
+{
+    const uint32_t max_coalescing_period_ticks = p_edge_trig->max_coalescing_period_ticks;
+    if (0 == max_coalescing_period_ticks)
+    {
+        return false;
+    }
+    const uint32_t cur_tick = (uint32_t)xTaskGetTickCount();
+    if (atomic_exchange(&p_edge_trig->flag_pending, 1U)
+        && ((cur_tick - (uint32_t)atomic_load(&p_edge_trig->last_notify_tick)) < max_coalescing_period_ticks))
+    {
+        atomic_fetch_add(&p_edge_trig->cnt_suppressed, 1U);
+        return true;
+    }
+    atomic_store(&p_edge_trig->last_notify_tick, cur_tick);
+    return false;
+}
+
 void
 event_mgr_notify(const event_mgr_ev_e event)
 {
@@ -224,6 +265,10 @@ event_mgr_notify(const event_mgr_ev_e event)
             (printf_int_t)(EVENT_MGR_EV_LAST - 1));
         return;
     }
+    if (event_mgr_is_notification_suppressed(&p_obj->edge_trig[event]))
+    {
+        return;
+    }
     event_mgr_queue_of_subscribers_t* const p_queue_of_subscribers = &p_obj->events[event];
     event_mgr_mutex_lock(p_obj);
     event_mgr_ev_info_t* p_ev_info = NULL;
@@ -233,3 +278,34 @@ event_mgr_notify(const event_mgr_ev_e event)
     }
     event_mgr_mutex_unlock(p_obj);
 }
+
+void
+event_mgr_set_edge_triggered(const event_mgr_ev_e event, const uint32_t max_coalescing_period_ms)
+{
+    assert((event > EVENT_MGR_EV_NONE) && (event < EVENT_MGR_EV_LAST));
+    event_mgr_t* const           p_obj       = &g_event_mgr;
+    event_mgr_edge_trig_t* const p_edge_trig = &p_obj->edge_trig[event];
+    event_mgr_mutex_lock(p_obj);
+    uint32_t period_ticks = (uint32_t)pdMS_TO_TICKS(max_coalescing_period_ms);
+    if ((0 != max_coalescing_period_ms) && (0 == period_ticks))
+    {
+        period_ticks = 1; // The period is shorter than one tick
+    }
+    p_edge_trig->max_coalescing_period_ticks = period_ticks;
+    atomic_store(&p_edge_trig->flag_pending, 0U);
+    event_mgr_mutex_unlock(p_obj);
+}
+
+void
+event_mgr_ack(const event_mgr_ev_e event)
+{
+    assert((event > EVENT_MGR_EV_NONE) && (event < EVENT_MGR_EV_LAST));
+    atomic_store(&g_event_mgr.edge_trig[event].flag_pending, 0U);
+}
+
+uint32_t
+event_mgr_get_num_suppressed_notifications(const event_mgr_ev_e event)
+{
+    assert((event > EVENT_MGR_EV_NONE) && (event < EVENT_MGR_EV_LAST));
+    return (uint32_t)atomic_load(&g_event_mgr.edge_trig[event].cnt_suppressed);
+}
@@ -9,6 +9,7 @@
 #define RUUVI_GATEWAY_ESP_EVENT_MGR_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "os_signal.h"
 #include "attribs.h"
 
@@ -87,6 +88,36 @@ event_mgr_unsubscribe_sig_static(event_mgr_ev_info_static_t* const p_ev_info_mem
 void
 event_mgr_notify(const event_mgr_ev_e event);
 
+/**
+ * @brief Make the event edge-triggered.
+ * @note After the subscribers have been notified, all further notifications of an edge-triggered event are coalesced
+ *       (suppressed without taking the mutex) until one of the subscribers calls event_mgr_ack.
+ *       The subscribers must call event_mgr_ack at the beginning of the signal handler before reading the data,
+ *       then no notification is lost, because the suppressed notifications arrive while the signals of all
+ *       subscribers are still pending. If no subscriber acknowledges the event during max_coalescing_period_ms
+ *       (e.g. there were no subscribers), then the next notification is delivered anyway.
+ * @param event - the event
+ * @param max_coalescing_period_ms - the max period of time during which the notifications are coalesced,
+ *                                   0 - make the event level-triggered (default)
+ */
+void
+event_mgr_set_edge_triggered(const event_mgr_ev_e event, const uint32_t max_coalescing_period_ms);
+
+/**
+ * @brief Acknowledge the edge-triggered event, so that the next notification is delivered to the subscribers.
+ * @param event - the event
+ */
+void
+event_mgr_ack(const event_mgr_ev_e event);
+
+/**
+ * @brief Get the number of suppressed notifications of the edge-triggered event.
+ * @param event - the event
+ * @return the number of notifications which were coalesced with the previous ones
+ */
+uint32_t
+event_mgr_get_num_suppressed_notifications(const event_mgr_ev_e event);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,6 +14,7 @@
 #include "esp_err.h"
 #include "esp_vfs_fat.h"
 #include "os_malloc.h"
+#include "os_mutex.h"
 #include "str_buf.h"
 
 #if !defined(RUUVI_TESTS_NRF52FW)
@@ -34,6 +35,36 @@ struct flash_fat_fs_t
     bool        flag_use_raw_flash;
 };
 
+static os_mutex_static_t g_flashfatfs_mutex_mem;
+static os_mutex_t        g_p_flashfatfs_mutex = NULL;
+
+void
+flashfatfs_init_mutex(void)
+{
+    if (NULL == g_p_flashfatfs_mutex)
+    {
+        g_p_flashfatfs_mutex = os_mutex_create_static(&g_flashfatfs_mutex_mem);
+    }
+}
+
+static void
+flashfatfs_lock(void)
+{
+    if (NULL != g_p_flashfatfs_mutex)
+    {
+        os_mutex_lock(g_p_flashfatfs_mutex);
+    }
+}
+
+static void
+flashfatfs_unlock(void)
+{
+    if (NULL != g_p_flashfatfs_mutex)
+    {
+        os_mutex_unlock(g_p_flashfatfs_mutex);
+    }
+}
+
 const flash_fat_fs_t*
 flashfatfs_mount(const char* mount_point, const char* partition_label, const flash_fat_fs_num_files_t max_files)
 {
@@ -63,6 +94,7 @@ flashfatfs_mount(const char* mount_point, const char* partition_label, const fla
         .max_files              = max_files,
         .allocation_unit_size   = 512U,
     };
+    flashfatfs_lock();
     esp_err_t err = esp_vfs_fat_rawflash_mount(p_obj->mount_point, p_obj->partition_label, &mount_config);
     if (ESP_OK != err)
     {
@@ -76,10 +108,12 @@ flashfatfs_mount(const char* mount_point, const char* partition_label, const fla
         if (ESP_OK != err)
         {
             LOG_ERR_ESP(err, "%s failed", "esp_vfs_fat_spiflash_mount");
+            flashfatfs_unlock();
             os_free(p_obj);
             return NULL;
         }
     }
+    flashfatfs_unlock();
     LOG_INFO("Partition '%s' mounted successfully to %s", partition_label, mount_point);
     return p_obj;
 }
@@ -90,6 +124,7 @@ flashfatfs_unmount(const flash_fat_fs_t** pp_ffs)
     const flash_fat_fs_t* p_ffs = *pp_ffs;
     LOG_INFO("Unmount %s", p_ffs->mount_point);
     esp_err_t err = ESP_FAIL;
+    flashfatfs_lock();
     if (p_ffs->flag_use_raw_flash)
     {
         err = esp_vfs_fat_rawflash_unmount(p_ffs->mount_point, p_ffs->partition_label);
@@ -106,6 +141,7 @@ flashfatfs_unmount(const flash_fat_fs_t** pp_ffs)
             LOG_ERR_ESP(err, "%s failed", "esp_vfs_fat_spiflash_unmount");
         }
     }
+    flashfatfs_unlock();
     os_free(p_ffs);
     *pp_ffs = NULL;
     if (ESP_OK != err)
@@ -32,6 +32,14 @@ typedef struct flash_fat_fs_t flash_fat_fs_t;
 
 typedef int flash_fat_fs_num_files_t;
 
+/**
+ * @brief Initialize the mutex which serializes mounting/unmounting of FatFS partitions.
+ * @note It's needed because the partitions can be mounted from different threads during boot
+ *       (VFS and FatFS drive registration is not thread-safe).
+ */
+void
+flashfatfs_init_mutex(void);
+
 const flash_fat_fs_t*
 flashfatfs_mount(const char* mount_point, const char* partition_label, const flash_fat_fs_num_files_t max_files);
 
@@ -92,6 +92,7 @@ typedef struct ruuvi_gw_cfg_mqtt_transport_t
 #define GW_CFG_MQTT_DATA_FORMAT_STR_RUUVI_RAW       "ruuvi_raw"
 #define GW_CFG_MQTT_DATA_FORMAT_STR_RAW_AND_DECODED "ruuvi_raw_and_decoded"
 #define GW_CFG_MQTT_DATA_FORMAT_STR_DECODED         "ruuvi_decoded"
+#define GW_CFG_MQTT_DATA_FORMAT_STR_RAW_BATCH       "ruuvi_raw_batch"
 
 #define GW_CFG_MQTT_DATA_FORMAT_STR_SIZE sizeof(GW_CFG_MQTT_DATA_FORMAT_STR_RAW_AND_DECODED)
 
@@ -100,6 +101,7 @@ typedef enum gw_cfg_mqtt_data_format_e
     GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW = 0,
     GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_AND_DECODED,
     GW_CFG_MQTT_DATA_FORMAT_RUUVI_DECODED,
+    GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_BATCH, //!< Raw data of multiple tags packed into one message on '<prefix>batch'
 } gw_cfg_mqtt_data_format_e;
 
 typedef struct ruuvi_gw_cfg_mqtt_server_t
@@ -231,6 +233,7 @@ typedef struct ruuvi_gw_cfg_remote_t
 #define GW_CFG_HTTP_DATA_FORMAT_STR_RUUVI           "ruuvi"
 #define GW_CFG_HTTP_DATA_FORMAT_STR_RAW_AND_DECODED "ruuvi_raw_and_decoded"
 #define GW_CFG_HTTP_DATA_FORMAT_STR_DECODED         "ruuvi_decoded"
+#define GW_CFG_HTTP_DATA_FORMAT_STR_CBOR            "ruuvi_cbor"
 
 #define GW_CFG_HTTP_DATA_FORMAT_STR_SIZE sizeof(GW_CFG_HTTP_DATA_FORMAT_STR_RAW_AND_DECODED)
 
@@ -239,6 +242,7 @@ typedef enum gw_cfg_http_data_format_e
     GW_CFG_HTTP_DATA_FORMAT_RUUVI = 0,
     GW_CFG_HTTP_DATA_FORMAT_RUUVI_RAW_AND_DECODED,
     GW_CFG_HTTP_DATA_FORMAT_RUUVI_DECODED,
+    GW_CFG_HTTP_DATA_FORMAT_RUUVI_CBOR, //<! Raw data encoded in CBOR (see http_cbor.h)
 } gw_cfg_http_data_format_e;
 
 typedef struct ruuvi_gw_cfg_http_t
@@ -290,6 +290,12 @@ gw_cfg_json_add_items_http_custom_params(
                 return false;
             }
             break;
+        case GW_CFG_HTTP_DATA_FORMAT_RUUVI_CBOR:
+            if (!gw_cfg_json_add_string(p_json_root, "http_data_format", GW_CFG_HTTP_DATA_FORMAT_STR_CBOR))
+            {
+                return false;
+            }
+            break;
     }
     switch (p_cfg_http->auth_type)
     {
@@ -477,6 +483,12 @@ gw_cfg_json_add_items_mqtt(
                 return false;
             }
             break;
+        case GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_BATCH:
+            if (!gw_cfg_json_add_string(p_json_root, "mqtt_data_format", GW_CFG_MQTT_DATA_FORMAT_STR_RAW_BATCH))
+            {
+                return false;
+            }
+            break;
     }
     if (!gw_cfg_json_add_string(p_json_root, "mqtt_server", p_cfg_mqtt->mqtt_server.buf))
     {
@@ -743,6 +755,53 @@ gw_cfg_json_add_items_fw_update(cJSON* const p_json_root, const ruuvi_gw_cfg_fw_
     return true;
 }
 
+static bool
+gw_cfg_json_add_items_section(
+    cJSON* const                p_json_root,
+    const gw_cfg_t* const       p_cfg,
+    const gw_cfg_json_section_e section,
+    const bool                  flag_hide_passwords)
+{
+    switch (section)
+    {
+        case GW_CFG_JSON_SECTION_WIFI:
+            if (!gw_cfg_json_add_items_wifi_sta_config(p_json_root, &p_cfg->wifi_cfg, flag_hide_passwords))
+            {
+                return false;
+            }
+            return gw_cfg_json_add_items_wifi_ap_config(p_json_root, &p_cfg->wifi_cfg, flag_hide_passwords);
+        case GW_CFG_JSON_SECTION_ETH:
+            return gw_cfg_json_add_items_eth(p_json_root, &p_cfg->eth_cfg);
+        case GW_CFG_JSON_SECTION_REMOTE:
+            return gw_cfg_json_add_items_remote(p_json_root, &p_cfg->ruuvi_cfg.remote, flag_hide_passwords);
+        case GW_CFG_JSON_SECTION_HTTP:
+            return gw_cfg_json_add_items_http(p_json_root, &p_cfg->ruuvi_cfg.http, flag_hide_passwords);
+        case GW_CFG_JSON_SECTION_HTTP_STAT:
+            return gw_cfg_json_add_items_http_stat(p_json_root, &p_cfg->ruuvi_cfg.http_stat, flag_hide_passwords);
+        case GW_CFG_JSON_SECTION_MQTT:
+            return gw_cfg_json_add_items_mqtt(p_json_root, &p_cfg->ruuvi_cfg.mqtt, flag_hide_passwords);
+        case GW_CFG_JSON_SECTION_LAN_AUTH:
+            return gw_cfg_json_add_items_lan_auth(p_json_root, &p_cfg->ruuvi_cfg.lan_auth, flag_hide_passwords);
+        case GW_CFG_JSON_SECTION_AUTO_UPDATE:
+            return gw_cfg_json_add_items_auto_update(p_json_root, &p_cfg->ruuvi_cfg.auto_update);
+        case GW_CFG_JSON_SECTION_NTP:
+            return gw_cfg_json_add_items_ntp(p_json_root, &p_cfg->ruuvi_cfg.ntp);
+        case GW_CFG_JSON_SECTION_FILTER:
+            return gw_cfg_json_add_items_filter(p_json_root, &p_cfg->ruuvi_cfg.filter);
+        case GW_CFG_JSON_SECTION_SCAN:
+            return gw_cfg_json_add_items_scan(p_json_root, &p_cfg->ruuvi_cfg.scan);
+        case GW_CFG_JSON_SECTION_SCAN_FILTER:
+            return gw_cfg_json_add_items_scan_filter(p_json_root, &p_cfg->ruuvi_cfg.scan_filter);
+        case GW_CFG_JSON_SECTION_COORDINATES:
+            return gw_cfg_json_add_string(p_json_root, "coordinates", p_cfg->ruuvi_cfg.coordinates.buf);
+        case GW_CFG_JSON_SECTION_FW_UPDATE:
+            return gw_cfg_json_add_items_fw_update(p_json_root, &p_cfg->ruuvi_cfg.fw_update);
+        default:
+            LOG_ERR("Unknown gw_cfg section: %d", (printf_int_t)section);
+            return false;
+    }
+}
+
 static bool
 gw_cfg_json_add_items(
     cJSON* const          p_json_root,
@@ -756,71 +815,16 @@ gw_cfg_json_add_items(
             return false;
         }
     }
-    if (!gw_cfg_json_add_items_wifi_sta_config(p_json_root, &p_cfg->wifi_cfg, flag_hide_passwords_and_add_device_info))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_wifi_ap_config(p_json_root, &p_cfg->wifi_cfg, flag_hide_passwords_and_add_device_info))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_eth(p_json_root, &p_cfg->eth_cfg))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_remote(p_json_root, &p_cfg->ruuvi_cfg.remote, flag_hide_passwords_and_add_device_info))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_http(p_json_root, &p_cfg->ruuvi_cfg.http, flag_hide_passwords_and_add_device_info))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_http_stat(
-            p_json_root,
-            &p_cfg->ruuvi_cfg.http_stat,
-            flag_hide_passwords_and_add_device_info))
+    for (uint32_t i = 0; i < GW_CFG_JSON_SECTION_NUM; ++i)
     {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_mqtt(p_json_root, &p_cfg->ruuvi_cfg.mqtt, flag_hide_passwords_and_add_device_info))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_lan_auth(
-            p_json_root,
-            &p_cfg->ruuvi_cfg.lan_auth,
-            flag_hide_passwords_and_add_device_info))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_auto_update(p_json_root, &p_cfg->ruuvi_cfg.auto_update))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_ntp(p_json_root, &p_cfg->ruuvi_cfg.ntp))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_filter(p_json_root, &p_cfg->ruuvi_cfg.filter))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_scan(p_json_root, &p_cfg->ruuvi_cfg.scan))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_scan_filter(p_json_root, &p_cfg->ruuvi_cfg.scan_filter))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_string(p_json_root, "coordinates", p_cfg->ruuvi_cfg.coordinates.buf))
-    {
-        return false;
-    }
-    if (!gw_cfg_json_add_items_fw_update(p_json_root, &p_cfg->ruuvi_cfg.fw_update))
-    {
-        return false;
+        if (!gw_cfg_json_add_items_section(
+                p_json_root,
+                p_cfg,
+                (gw_cfg_json_section_e)i,
+                flag_hide_passwords_and_add_device_info))
+        {
+            return false;
+        }
     }
     return true;
 }
@@ -867,3 +871,33 @@ gw_cfg_json_generate_for_ui_client(const gw_cfg_t* const p_gw_cfg, cjson_wrap_st
     const bool flag_hide_passwords_and_add_device_info = true;
     return gw_cfg_json_generate(p_gw_cfg, p_json_str, flag_hide_passwords_and_add_device_info);
 }
+
+bool
+gw_cfg_json_generate_section_for_saving(
+    const gw_cfg_t* const       p_gw_cfg,
+    const gw_cfg_json_section_e section,
+    cjson_wrap_str_t* const     p_json_str)
+{
+    p_json_str->p_str = NULL;
+
+    cJSON* p_json_root = cJSON_CreateObject();
+    if (NULL == p_json_root)
+    {
+        LOG_ERR("Can't create json object");
+        return false;
+    }
+    const bool flag_hide_passwords = false;
+    if (!gw_cfg_json_add_items_section(p_json_root, p_gw_cfg, section, flag_hide_passwords))
+    {
+        cjson_wrap_delete(&p_json_root);
+        return false;
+    }
+
+    *p_json_str = cjson_wrap_print_and_delete(&p_json_root);
+    if (NULL == p_json_str->p_str)
+    {
+        LOG_ERR("Can't create json string");
+        return false;
+    }
+    return true;
+}
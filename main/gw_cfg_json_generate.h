@@ -16,12 +16,48 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Independent parts of the configuration which can be saved separately,
+ *        the full configuration JSON is the union of all the sections in this order.
+ */
+typedef enum gw_cfg_json_section_e
+{
+    GW_CFG_JSON_SECTION_WIFI,
+    GW_CFG_JSON_SECTION_ETH,
+    GW_CFG_JSON_SECTION_REMOTE,
+    GW_CFG_JSON_SECTION_HTTP,
+    GW_CFG_JSON_SECTION_HTTP_STAT,
+    GW_CFG_JSON_SECTION_MQTT,
+    GW_CFG_JSON_SECTION_LAN_AUTH,
+    GW_CFG_JSON_SECTION_AUTO_UPDATE,
+    GW_CFG_JSON_SECTION_NTP,
+    GW_CFG_JSON_SECTION_FILTER,
+    GW_CFG_JSON_SECTION_SCAN,
+    GW_CFG_JSON_SECTION_SCAN_FILTER,
+    GW_CFG_JSON_SECTION_COORDINATES,
+    GW_CFG_JSON_SECTION_FW_UPDATE,
+    GW_CFG_JSON_SECTION_NUM,
+} gw_cfg_json_section_e;
+
 bool
 gw_cfg_json_generate_for_saving(const gw_cfg_t* const p_gw_cfg, cjson_wrap_str_t* const p_json_str);
 
 bool
 gw_cfg_json_generate_for_ui_client(const gw_cfg_t* const p_gw_cfg, cjson_wrap_str_t* const p_json_str);
 
+/**
+ * @brief Generate JSON with the items of one section of the configuration (in the same format as for saving).
+ * @param p_gw_cfg - ptr to gw_cfg_t
+ * @param section - the section to generate
+ * @param[out] p_json_str - the generated JSON, it must be freed with cjson_wrap_free_json_str
+ * @return true on success
+ */
+bool
+gw_cfg_json_generate_section_for_saving(
+    const gw_cfg_t* const       p_gw_cfg,
+    const gw_cfg_json_section_e section,
+    cjson_wrap_str_t* const     p_json_str);
+
 #ifdef __cplusplus
 }
 #endif
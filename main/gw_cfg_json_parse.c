@@ -215,3 +215,54 @@ gw_cfg_json_parse(
     cJSON_Delete(p_json_root);
     return true;
 }
+
+bool
+gw_cfg_json_parse_sections(
+    const char* const        p_json_name,
+    const char* const        p_log_title,
+    const char* const* const p_arr_of_json_str,
+    const size_t             num_sections,
+    gw_cfg_t* const          p_gw_cfg)
+{
+    cJSON* p_json_root = cJSON_CreateObject();
+    if (NULL == p_json_root)
+    {
+        LOG_ERR("Can't create json object");
+        return false;
+    }
+    for (size_t i = 0; i < num_sections; ++i)
+    {
+        const char* const p_json_str = p_arr_of_json_str[i];
+        if (NULL == p_json_str)
+        {
+            LOG_WARN("%s: section %u is missing", p_json_name, (printf_uint_t)i);
+            continue;
+        }
+        cJSON* p_json_section = cJSON_Parse(p_json_str);
+        if (NULL == p_json_section)
+        {
+            // A corrupted section is skipped like a missing one, so the default values are used for it
+            LOG_ERR("Failed to parse %s: section %u: %s", p_json_name, (printf_uint_t)i, p_json_str);
+            continue;
+        }
+        while (NULL != p_json_section->child)
+        {
+            cJSON* const p_item = cJSON_DetachItemViaPointer(p_json_section, p_json_section->child);
+            // The item keeps its key, so it can be moved to the root object without copying the key.
+            cJSON_AddItemToArray(p_json_root, p_item);
+        }
+        cJSON_Delete(p_json_section);
+    }
+
+    gw_cfg_json_parse_cjson(
+        p_json_root,
+        p_log_title,
+        NULL,
+        &p_gw_cfg->ruuvi_cfg,
+        &p_gw_cfg->eth_cfg,
+        &p_gw_cfg->wifi_cfg.ap,
+        &p_gw_cfg->wifi_cfg.sta);
+
+    cJSON_Delete(p_json_root);
+    return true;
+}
@@ -9,6 +9,7 @@
 #define RUUVI_GATEWAY_ESP_GW_CFG_JSON_PARSE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "cjson_wrap.h"
 #include "gw_cfg.h"
 
@@ -33,6 +34,23 @@ gw_cfg_json_parse(
     const char* const p_json_str,
     gw_cfg_t* const   p_gw_cfg);
 
+/**
+ * @brief Parse the configuration which is split into JSON sections (see gw_cfg_json_generate_section_for_saving).
+ * @param p_json_name - name of the JSON (for logging)
+ * @param p_log_title - title for logging of the parsed configuration or NULL
+ * @param p_arr_of_json_str - array of JSON strings of the sections, NULL if the section is missing
+ * @param num_sections - number of items in p_arr_of_json_str
+ * @param p_gw_cfg - ptr to gw_cfg_t to update, the missing or unparsable sections are not modified
+ * @return false if there is not enough memory
+ */
+bool
+gw_cfg_json_parse_sections(
+    const char* const        p_json_name,
+    const char* const        p_log_title,
+    const char* const* const p_arr_of_json_str,
+    const size_t             num_sections,
+    gw_cfg_t* const          p_gw_cfg);
+
 void
 gw_cfg_json_parse_cjson(
     const cJSON* const          p_json_root,
@@ -130,6 +130,11 @@ gw_cfg_json_parse_http_data_format(
         *p_data_format = GW_CFG_HTTP_DATA_FORMAT_RUUVI_DECODED;
         return;
     }
+    if (0 == strcmp(GW_CFG_HTTP_DATA_FORMAT_STR_CBOR, data_format_str))
+    {
+        *p_data_format = GW_CFG_HTTP_DATA_FORMAT_RUUVI_CBOR;
+        return;
+    }
     LOG_WARN("Unknown http_data_format='%s', use 'ruuvi'", data_format_str);
     *p_data_format = GW_CFG_HTTP_DATA_FORMAT_RUUVI;
 }
@@ -52,6 +52,10 @@ gw_cfg_json_parse_mqtt_data_format(const cJSON* const p_json_root)
     {
         return GW_CFG_MQTT_DATA_FORMAT_RUUVI_DECODED;
     }
+    if (0 == strcmp(GW_CFG_MQTT_DATA_FORMAT_STR_RAW_BATCH, data_format_str))
+    {
+        return GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_BATCH;
+    }
     LOG_WARN("Unknown mqtt_data_format='%s', use 'ruuvi'", data_format_str);
     return GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW;
 }
@@ -0,0 +1,957 @@
+/**
+ * @file gw_cfg_json_stream.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "gw_cfg_json_stream.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "cJSON.h"
+#include "os_malloc.h"
+#include "gw_cfg_json_parse.h"
+#include "gw_cfg_log.h"
+
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#include "log.h"
+
+#define GW_CFG_JSON_STREAM_MAX_LITERAL_LEN (5U)
+#define GW_CFG_JSON_STREAM_MAX_NUMBER_LEN  (63U)
+#define GW_CFG_JSON_STREAM_UNICODE_LEN     (4U)
+
+#define GW_CFG_JSON_STREAM_UTF16_HIGH_SURROGATE_BEGIN (0xD800U)
+#define GW_CFG_JSON_STREAM_UTF16_LOW_SURROGATE_BEGIN  (0xDC00U)
+#define GW_CFG_JSON_STREAM_UTF16_LOW_SURROGATE_END    (0xDFFFU)
+
+typedef enum gw_cfg_json_stream_state_e
+{
+    GW_CFG_JSON_STREAM_STATE_ROOT,                //<! Waiting for '{' of the root object
+    GW_CFG_JSON_STREAM_STATE_VALUE,               //<! Waiting for a value after ':'
+    GW_CFG_JSON_STREAM_STATE_KEY_OR_OBJ_END,      //<! Waiting for the first key or '}' after '{'
+    GW_CFG_JSON_STREAM_STATE_KEY,                 //<! Waiting for the next key after ','
+    GW_CFG_JSON_STREAM_STATE_COLON,               //<! Waiting for ':' after the key
+    GW_CFG_JSON_STREAM_STATE_VALUE_OR_ARR_END,    //<! Waiting for the first value or ']' after '['
+    GW_CFG_JSON_STREAM_STATE_ARR_VALUE,           //<! Waiting for the next value after ',' in array
+    GW_CFG_JSON_STREAM_STATE_COMMA_OR_END,        //<! Waiting for ',' or the end of the container after a value
+    GW_CFG_JSON_STREAM_STATE_STRING,              //<! Inside a string
+    GW_CFG_JSON_STREAM_STATE_STRING_ESCAPE,       //<! After '\' inside a string
+    GW_CFG_JSON_STREAM_STATE_STRING_UNICODE,      //<! Reading 4 hex digits of the unicode escape
+    GW_CFG_JSON_STREAM_STATE_STRING_SURROGATE,    //<! Waiting for '\' of the low surrogate
+    GW_CFG_JSON_STREAM_STATE_STRING_SURROGATE_U,  //<! Waiting for 'u' of the low surrogate
+    GW_CFG_JSON_STREAM_STATE_LITERAL,             //<! Reading 'true', 'false' or 'null'
+    GW_CFG_JSON_STREAM_STATE_NUMBER,              //<! Reading a number
+    GW_CFG_JSON_STREAM_STATE_DONE,                //<! The root object is closed, the rest of the data is ignored
+    GW_CFG_JSON_STREAM_STATE_ERROR,               //<! Invalid JSON or out of memory
+} gw_cfg_json_stream_state_e;
+
+struct gw_cfg_json_stream_t
+{
+    gw_cfg_json_stream_state_e state;
+    size_t                     offset;     //<! Number of bytes fed so far
+    char                       first_char; //<! The first byte of the document
+    uint32_t                   depth;      //<! Current nesting level, the root object is at level 1
+    uint32_t                   obj_bits;   //<! Bit (depth - 1) is set if the container at this level is an object
+    cJSON*                     p_root;     //<! Collected values of the known keys
+    cJSON*                     containers[GW_CFG_JSON_STREAM_MAX_NESTING]; //<! Kept containers (NULL if skipped)
+    const cJSON*               p_scan_filter_list; //<! The first kept 'scan_filter_list' container (without items)
+    uint32_t                   scan_filter_length;
+    mac_address_bin_t          scan_filter_list[GW_CFG_MAX_NUM_SENSORS]; //<! Items of 'scan_filter_list'
+    bool                       flag_string_is_key;
+    bool                       flag_keep_value;  //<! true if the current string/literal/number value is kept
+    bool                       flag_key_too_long;
+    uint32_t                   unicode_val;
+    uint32_t                   unicode_high_surrogate;
+    uint32_t                   unicode_digits;
+    size_t                     key_len;
+    size_t                     str_len;
+    size_t                     token_len;
+    char                       key[GW_CFG_JSON_STREAM_MAX_KEY_LEN + 1];
+    char                       str[GW_CFG_JSON_STREAM_MAX_STR_LEN + 1];
+    char                       token[GW_CFG_JSON_STREAM_MAX_NUMBER_LEN + 1];
+};
+
+static const char TAG[] = "gw_cfg";
+
+/**
+ * @brief The keys of the root object which are used by gw_cfg_json_parse_cjson, the values of all other keys are
+ *        skipped. It must be kept in sync with gw_cfg_json_parse_*.c
+ */
+static const char* const g_gw_cfg_json_stream_root_keys[] = {
+    "remote_cfg_use",
+    "remote_cfg_url",
+    "remote_cfg_auth_type",
+    "remote_cfg_auth_basic_user",
+    "remote_cfg_auth_basic_pass",
+    "remote_cfg_auth_bearer_token",
+    "remote_cfg_refresh_interval_minutes",
+    "remote_cfg_use_ssl_client_cert",
+    "remote_cfg_use_ssl_server_cert",
+    "use_http_ruuvi",
+    "use_http",
+    "http_data_format",
+    "http_auth",
+    "http_url",
+    "http_user",
+    "http_pass",
+    "http_bearer_token",
+    "http_api_key",
+    "http_period",
+    "http_use_extra_http_path",
+    "http_use_extra_http_query",
+    "http_use_extra_http_headers",
+    "http_use_ssl_client_cert",
+    "http_use_ssl_server_cert",
+    "use_http_stat",
+    "http_stat_url",
+    "http_stat_user",
+    "http_stat_pass",
+    "http_stat_use_ssl_client_cert",
+    "http_stat_use_ssl_server_cert",
+    "use_mqtt",
+    "mqtt_disable_retained_messages",
+    "mqtt_transport",
+    "mqtt_data_format",
+    "mqtt_server",
+    "mqtt_port",
+    "mqtt_sending_interval",
+    "mqtt_prefix",
+    "mqtt_client_id",
+    "mqtt_user",
+    "mqtt_pass",
+    "mqtt_use_ssl_client_cert",
+    "mqtt_use_ssl_server_cert",
+    "lan_auth_type",
+    "lan_auth_user",
+    "lan_auth_pass",
+    "lan_auth_api_key",
+    "lan_auth_api_key_rw",
+    "auto_update_cycle",
+    "auto_update_weekdays_bitmask",
+    "auto_update_interval_from",
+    "auto_update_interval_to",
+    "auto_update_tz_offset_hours",
+    "ntp_use",
+    "ntp_use_dhcp",
+    "ntp_server1",
+    "ntp_server2",
+    "ntp_server3",
+    "ntp_server4",
+    "company_id",
+    "company_use_filtering",
+    "scan_coded_phy",
+    "scan_1mbit_phy",
+    "scan_2mbit_phy",
+    "scan_extended_payload",
+    "scan_channel_37",
+    "scan_channel_38",
+    "scan_channel_39",
+    "scan_default",
+    "scan_filter_allow_listed",
+    "scan_filter_list",
+    "coordinates",
+    "fw_update_url",
+    "use_eth",
+    "eth_dhcp",
+    "eth_static_ip",
+    "eth_netmask",
+    "eth_gw",
+    "eth_dns1",
+    "eth_dns2",
+    "wifi_ap_config",
+    "wifi_sta_config",
+};
+
+/**
+ * @brief The keys of the root object whose nested values (array items or object members) are used.
+ * @note The items of 'scan_filter_list' are not kept in cJSON tree, they are converted to MAC addresses on the fly.
+ */
+static const char* const g_gw_cfg_json_stream_root_keys_with_children[] = {
+    "wifi_ap_config",
+    "wifi_sta_config",
+};
+
+static bool
+gw_cfg_json_stream_is_key_in_list(const char* const p_key, const char* const* const p_list, const size_t list_len)
+{
+    for (size_t i = 0; i < list_len; ++i)
+    {
+        // cJSON_GetObjectItem compares keys case-insensitively
+        if (0 == strcasecmp(p_list[i], p_key))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+gw_cfg_json_stream_reset(gw_cfg_json_stream_t* const p_stream)
+{
+    cJSON_Delete(p_stream->p_root);
+    memset(p_stream, 0, sizeof(*p_stream));
+    p_stream->state = GW_CFG_JSON_STREAM_STATE_ROOT;
+}
+
+gw_cfg_json_stream_t*
+gw_cfg_json_stream_create(void)
+{
+    gw_cfg_json_stream_t* p_stream = os_calloc(1, sizeof(*p_stream));
+    if (NULL == p_stream)
+    {
+        return NULL;
+    }
+    gw_cfg_json_stream_reset(p_stream);
+    return p_stream;
+}
+
+void
+gw_cfg_json_stream_delete(gw_cfg_json_stream_t** const pp_stream)
+{
+    gw_cfg_json_stream_t* const p_stream = *pp_stream;
+    if (NULL == p_stream)
+    {
+        return;
+    }
+    cJSON_Delete(p_stream->p_root);
+    os_free(*pp_stream);
+}
+
+char
+gw_cfg_json_stream_get_first_char(const gw_cfg_json_stream_t* const p_stream)
+{
+    return p_stream->first_char;
+}
+
+static bool
+gw_cfg_json_stream_is_whitespace(const char ch)
+{
+    // cJSON skips all the bytes <= 32 between tokens
+    return ((uint8_t)ch <= (uint8_t)' ') ? true : false;
+}
+
+static bool
+gw_cfg_json_stream_is_inside_obj(const gw_cfg_json_stream_t* const p_stream)
+{
+    return (0 != (p_stream->obj_bits & (1U << (p_stream->depth - 1U)))) ? true : false;
+}
+
+static cJSON*
+gw_cfg_json_stream_get_container(const gw_cfg_json_stream_t* const p_stream)
+{
+    return p_stream->containers[p_stream->depth - 1U];
+}
+
+/**
+ * @brief Check if the value which is started at the current position is an item of 'scan_filter_list'.
+ */
+static bool
+gw_cfg_json_stream_is_scan_filter_item(const gw_cfg_json_stream_t* const p_stream)
+{
+    return ((2U == p_stream->depth) && (NULL != p_stream->p_scan_filter_list)
+            && (gw_cfg_json_stream_get_container(p_stream) == p_stream->p_scan_filter_list))
+               ? true
+               : false;
+}
+
+/**
+ * @brief Convert the item of 'scan_filter_list' in the same way as gw_cfg_json_parse_scan_filter does.
+ * @param p_stream - ptr to gw_cfg_json_stream_t
+ * @param p_str - ptr to the string value or NULL if the item is not a string
+ */
+static void
+gw_cfg_json_stream_add_scan_filter_item(gw_cfg_json_stream_t* const p_stream, const char* const p_str)
+{
+    if (p_stream->scan_filter_length >= GW_CFG_MAX_NUM_SENSORS)
+    {
+        LOG_WARN("Too many MAC addresses in scan_filter_list, ignore: %s", (NULL != p_str) ? p_str : "");
+        return;
+    }
+    if (!mac_addr_from_str(p_str, &p_stream->scan_filter_list[p_stream->scan_filter_length]))
+    {
+        LOG_ERR("Can't parse MAC address in scan_filter_list: %s", p_str);
+    }
+    p_stream->scan_filter_length += 1;
+}
+
+/**
+ * @brief Check if the value which is started at the current position should be kept.
+ */
+static bool
+gw_cfg_json_stream_is_value_kept(const gw_cfg_json_stream_t* const p_stream)
+{
+    if (NULL == gw_cfg_json_stream_get_container(p_stream))
+    {
+        return false;
+    }
+    if (gw_cfg_json_stream_is_inside_obj(p_stream) && p_stream->flag_key_too_long)
+    {
+        return false;
+    }
+    if (1U == p_stream->depth)
+    {
+        return gw_cfg_json_stream_is_key_in_list(
+            p_stream->key,
+            g_gw_cfg_json_stream_root_keys,
+            sizeof(g_gw_cfg_json_stream_root_keys) / sizeof(g_gw_cfg_json_stream_root_keys[0]));
+    }
+    if (2U == p_stream->depth)
+    {
+        if (gw_cfg_json_stream_is_scan_filter_item(p_stream))
+        {
+            return false;
+        }
+        const cJSON* const p_container = gw_cfg_json_stream_get_container(p_stream);
+        return gw_cfg_json_stream_is_key_in_list(
+            p_container->string,
+            g_gw_cfg_json_stream_root_keys_with_children,
+            sizeof(g_gw_cfg_json_stream_root_keys_with_children)
+                / sizeof(g_gw_cfg_json_stream_root_keys_with_children[0]));
+    }
+    return false;
+}
+
+static bool
+gw_cfg_json_stream_add_item(gw_cfg_json_stream_t* const p_stream, cJSON* const p_item)
+{
+    if (NULL == p_item)
+    {
+        LOG_ERR("Can't allocate memory for JSON item");
+        return false;
+    }
+    cJSON* const p_container = gw_cfg_json_stream_get_container(p_stream);
+    if (gw_cfg_json_stream_is_inside_obj(p_stream))
+    {
+        if (!cJSON_AddItemToObject(p_container, p_stream->key, p_item))
+        {
+            cJSON_Delete(p_item);
+            LOG_ERR("Can't allocate memory for JSON item");
+            return false;
+        }
+    }
+    else
+    {
+        if (!cJSON_AddItemToArray(p_container, p_item))
+        {
+            cJSON_Delete(p_item);
+            LOG_ERR("Can't allocate memory for JSON item");
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+gw_cfg_json_stream_on_value_end(gw_cfg_json_stream_t* const p_stream)
+{
+    p_stream->state = GW_CFG_JSON_STREAM_STATE_COMMA_OR_END;
+    return true;
+}
+
+static bool
+gw_cfg_json_stream_on_container_begin(gw_cfg_json_stream_t* const p_stream, const bool is_obj)
+{
+    cJSON* p_container = NULL;
+    if (0 == p_stream->depth)
+    {
+        p_stream->p_root = cJSON_CreateObject();
+        if (NULL == p_stream->p_root)
+        {
+            LOG_ERR("Can't allocate memory for JSON item");
+            return false;
+        }
+        p_container = p_stream->p_root;
+    }
+    else
+    {
+        if (GW_CFG_JSON_STREAM_MAX_NESTING == p_stream->depth)
+        {
+            LOG_ERR("JSON nesting is too deep");
+            return false;
+        }
+        if (gw_cfg_json_stream_is_scan_filter_item(p_stream))
+        {
+            gw_cfg_json_stream_add_scan_filter_item(p_stream, NULL);
+        }
+        if (gw_cfg_json_stream_is_value_kept(p_stream))
+        {
+            // Members of the nested containers are skipped unless they are used by gw_cfg (see
+            // g_gw_cfg_json_stream_root_keys_with_children), but the container itself is kept
+            // to preserve the type of the value.
+            p_container = is_obj ? cJSON_CreateObject() : cJSON_CreateArray();
+            if (!gw_cfg_json_stream_add_item(p_stream, p_container))
+            {
+                return false;
+            }
+            if ((1U == p_stream->depth) && (NULL == p_stream->p_scan_filter_list)
+                && (0 == strcasecmp("scan_filter_list", p_stream->key)))
+            {
+                p_stream->p_scan_filter_list = p_container;
+            }
+        }
+    }
+    p_stream->depth += 1;
+    p_stream->containers[p_stream->depth - 1U] = p_container;
+    if (is_obj)
+    {
+        p_stream->obj_bits |= 1U << (p_stream->depth - 1U);
+        p_stream->state = GW_CFG_JSON_STREAM_STATE_KEY_OR_OBJ_END;
+    }
+    else
+    {
+        p_stream->obj_bits &= ~(1U << (p_stream->depth - 1U));
+        p_stream->state = GW_CFG_JSON_STREAM_STATE_VALUE_OR_ARR_END;
+    }
+    return true;
+}
+
+static bool
+gw_cfg_json_stream_on_container_end(gw_cfg_json_stream_t* const p_stream)
+{
+    p_stream->containers[p_stream->depth - 1U] = NULL;
+    p_stream->depth -= 1;
+    if (0 == p_stream->depth)
+    {
+        p_stream->state = GW_CFG_JSON_STREAM_STATE_DONE;
+        return true;
+    }
+    return gw_cfg_json_stream_on_value_end(p_stream);
+}
+
+static void
+gw_cfg_json_stream_on_string_begin(gw_cfg_json_stream_t* const p_stream, const bool is_key)
+{
+    p_stream->flag_string_is_key = is_key;
+    if (is_key)
+    {
+        p_stream->key_len           = 0;
+        p_stream->key[0]            = '\0';
+        p_stream->flag_key_too_long = false;
+        p_stream->flag_keep_value   = (NULL != gw_cfg_json_stream_get_container(p_stream)) ? true : false;
+    }
+    else
+    {
+        p_stream->flag_keep_value = gw_cfg_json_stream_is_value_kept(p_stream)
+                                    || gw_cfg_json_stream_is_scan_filter_item(p_stream);
+    }
+    p_stream->str_len = 0;
+    p_stream->str[0]  = '\0';
+    p_stream->state   = GW_CFG_JSON_STREAM_STATE_STRING;
+}
+
+static void
+gw_cfg_json_stream_append_char(gw_cfg_json_stream_t* const p_stream, const char ch)
+{
+    if (!p_stream->flag_keep_value)
+    {
+        return;
+    }
+    if (p_stream->flag_string_is_key)
+    {
+        if (p_stream->key_len < GW_CFG_JSON_STREAM_MAX_KEY_LEN)
+        {
+            p_stream->key[p_stream->key_len] = ch;
+            p_stream->key_len += 1;
+            p_stream->key[p_stream->key_len] = '\0';
+        }
+        else
+        {
+            p_stream->flag_key_too_long = true;
+        }
+    }
+    else
+    {
+        // Strings longer than any field of gw_cfg_t are truncated, it does not affect the result of parsing.
+        if (p_stream->str_len < GW_CFG_JSON_STREAM_MAX_STR_LEN)
+        {
+            p_stream->str[p_stream->str_len] = ch;
+            p_stream->str_len += 1;
+            p_stream->str[p_stream->str_len] = '\0';
+        }
+    }
+}
+
+static void
+gw_cfg_json_stream_append_utf8(gw_cfg_json_stream_t* const p_stream, const uint32_t code_point)
+{
+    if (code_point < 0x80U)
+    {
+        gw_cfg_json_stream_append_char(p_stream, (char)code_point);
+    }
+    else if (code_point < 0x800U)
+    {
+        gw_cfg_json_stream_append_char(p_stream, (char)(0xC0U | (code_point >> 6U)));
+        gw_cfg_json_stream_append_char(p_stream, (char)(0x80U | (code_point & 0x3FU)));
+    }
+    else if (code_point < 0x10000U)
+    {
+        gw_cfg_json_stream_append_char(p_stream, (char)(0xE0U | (code_point >> 12U)));
+        gw_cfg_json_stream_append_char(p_stream, (char)(0x80U | ((code_point >> 6U) & 0x3FU)));
+        gw_cfg_json_stream_append_char(p_stream, (char)(0x80U | (code_point & 0x3FU)));
+    }
+    else
+    {
+        gw_cfg_json_stream_append_char(p_stream, (char)(0xF0U | (code_point >> 18U)));
+        gw_cfg_json_stream_append_char(p_stream, (char)(0x80U | ((code_point >> 12U) & 0x3FU)));
+        gw_cfg_json_stream_append_char(p_stream, (char)(0x80U | ((code_point >> 6U) & 0x3FU)));
+        gw_cfg_json_stream_append_char(p_stream, (char)(0x80U | (code_point & 0x3FU)));
+    }
+}
+
+static bool
+gw_cfg_json_stream_on_string_end(gw_cfg_json_stream_t* const p_stream)
+{
+    if (p_stream->flag_string_is_key)
+    {
+        p_stream->state = GW_CFG_JSON_STREAM_STATE_COLON;
+        return true;
+    }
+    if (gw_cfg_json_stream_is_scan_filter_item(p_stream))
+    {
+        gw_cfg_json_stream_add_scan_filter_item(p_stream, p_stream->str);
+    }
+    else if (p_stream->flag_keep_value)
+    {
+        if (!gw_cfg_json_stream_add_item(p_stream, cJSON_CreateString(p_stream->str)))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // MISRA C:2012, 15.7 - All if...else if constructs shall be terminated with an else statement
+    }
+    return gw_cfg_json_stream_on_value_end(p_stream);
+}
+
+static bool
+gw_cfg_json_stream_handle_string_char(gw_cfg_json_stream_t* const p_stream, const char ch)
+{
+    if ('"' == ch)
+    {
+        return gw_cfg_json_stream_on_string_end(p_stream);
+    }
+    if ('\\' == ch)
+    {
+        p_stream->state = GW_CFG_JSON_STREAM_STATE_STRING_ESCAPE;
+        return true;
+    }
+    gw_cfg_json_stream_append_char(p_stream, ch);
+    return true;
+}
+
+static bool
+gw_cfg_json_stream_handle_string_escape(gw_cfg_json_stream_t* const p_stream, const char ch)
+{
+    p_stream->state = GW_CFG_JSON_STREAM_STATE_STRING;
+    switch (ch)
+    {
+        case 'b':
+            gw_cfg_json_stream_append_char(p_stream, '\b');
+            break;
+        case 'f':
+            gw_cfg_json_stream_append_char(p_stream, '\f');
+            break;
+        case 'n':
+            gw_cfg_json_stream_append_char(p_stream, '\n');
+            break;
+        case 'r':
+            gw_cfg_json_stream_append_char(p_stream, '\r');
+            break;
+        case 't':
+            gw_cfg_json_stream_append_char(p_stream, '\t');
+            break;
+        case '"':
+        case '\\':
+        case '/':
+            gw_cfg_json_stream_append_char(p_stream, ch);
+            break;
+        case 'u':
+            p_stream->unicode_val    = 0;
+            p_stream->unicode_digits = 0;
+            p_stream->state          = GW_CFG_JSON_STREAM_STATE_STRING_UNICODE;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+static bool
+gw_cfg_json_stream_handle_unicode_digit(gw_cfg_json_stream_t* const p_stream, const char ch)
+{
+    uint32_t digit = 0;
+    if ((ch >= '0') && (ch <= '9'))
+    {
+        digit = (uint32_t)(ch - '0');
+    }
+    else if ((ch >= 'a') && (ch <= 'f'))
+    {
+        digit = (uint32_t)(ch - 'a') + 10U;
+    }
+    else if ((ch >= 'A') && (ch <= 'F'))
+    {
+        digit = (uint32_t)(ch - 'A') + 10U;
+    }
+    else
+    {
+        return false;
+    }
+    p_stream->unicode_val = (p_stream->unicode_val << 4U) | digit;
+    p_stream->unicode_digits += 1;
+    if (p_stream->unicode_digits < GW_CFG_JSON_STREAM_UNICODE_LEN)
+    {
+        return true;
+    }
+
+    const uint32_t val = p_stream->unicode_val;
+    if (0 != p_stream->unicode_high_surrogate)
+    {
+        if ((val < GW_CFG_JSON_STREAM_UTF16_LOW_SURROGATE_BEGIN) || (val > GW_CFG_JSON_STREAM_UTF16_LOW_SURROGATE_END))
+        {
+            return false;
+        }
+        const uint32_t code_point = 0x10000U
+                                    + (((p_stream->unicode_high_surrogate & 0x3FFU) << 10U)
+                                       | (val & 0x3FFU));
+        p_stream->unicode_high_surrogate = 0;
+        gw_cfg_json_stream_append_utf8(p_stream, code_point);
+        p_stream->state = GW_CFG_JSON_STREAM_STATE_STRING;
+        return true;
+    }
+    if ((val >= GW_CFG_JSON_STREAM_UTF16_LOW_SURROGATE_BEGIN) && (val <= GW_CFG_JSON_STREAM_UTF16_LOW_SURROGATE_END))
+    {
+        return false;
+    }
+    if ((val >= GW_CFG_JSON_STREAM_UTF16_HIGH_SURROGATE_BEGIN) && (val < GW_CFG_JSON_STREAM_UTF16_LOW_SURROGATE_BEGIN))
+    {
+        p_stream->unicode_high_surrogate = val;
+        p_stream->state                  = GW_CFG_JSON_STREAM_STATE_STRING_SURROGATE;
+        return true;
+    }
+    gw_cfg_json_stream_append_utf8(p_stream, val);
+    p_stream->state = GW_CFG_JSON_STREAM_STATE_STRING;
+    return true;
+}
+
+static bool
+gw_cfg_json_stream_on_literal_end(gw_cfg_json_stream_t* const p_stream)
+{
+    cJSON* p_item = NULL;
+    if (0 == strcmp("true", p_stream->token))
+    {
+        p_item = p_stream->flag_keep_value ? cJSON_CreateTrue() : NULL;
+    }
+    else if (0 == strcmp("false", p_stream->token))
+    {
+        p_item = p_stream->flag_keep_value ? cJSON_CreateFalse() : NULL;
+    }
+    else if (0 == strcmp("null", p_stream->token))
+    {
+        p_item = p_stream->flag_keep_value ? cJSON_CreateNull() : NULL;
+    }
+    else
+    {
+        return false;
+    }
+    if (gw_cfg_json_stream_is_scan_filter_item(p_stream))
+    {
+        gw_cfg_json_stream_add_scan_filter_item(p_stream, NULL);
+    }
+    if (p_stream->flag_keep_value && (!gw_cfg_json_stream_add_item(p_stream, p_item)))
+    {
+        return false;
+    }
+    return gw_cfg_json_stream_on_value_end(p_stream);
+}
+
+static bool
+gw_cfg_json_stream_on_number_end(gw_cfg_json_stream_t* const p_stream)
+{
+    char*        p_end = NULL;
+    const double val   = strtod(p_stream->token, &p_end);
+    if ((p_end == p_stream->token) || ('\0' != *p_end))
+    {
+        return false;
+    }
+    if (gw_cfg_json_stream_is_scan_filter_item(p_stream))
+    {
+        gw_cfg_json_stream_add_scan_filter_item(p_stream, NULL);
+    }
+    if (p_stream->flag_keep_value && (!gw_cfg_json_stream_add_item(p_stream, cJSON_CreateNumber(val))))
+    {
+        return false;
+    }
+    return gw_cfg_json_stream_on_value_end(p_stream);
+}
+
+static bool
+gw_cfg_json_stream_is_number_char(const char ch)
+{
+    return (((ch >= '0') && (ch <= '9')) || ('+' == ch) || ('-' == ch) || ('.' == ch) || ('e' == ch) || ('E' == ch))
+               ? true
+               : false;
+}
+
+static bool
+gw_cfg_json_stream_is_literal_char(const char ch)
+{
+    return ((ch >= 'a') && (ch <= 'z')) ? true : false;
+}
+
+static void
+gw_cfg_json_stream_on_token_begin(
+    gw_cfg_json_stream_t* const      p_stream,
+    const gw_cfg_json_stream_state_e state,
+    const char                       ch)
+{
+    p_stream->flag_keep_value = gw_cfg_json_stream_is_value_kept(p_stream);
+    p_stream->token[0]        = ch;
+    p_stream->token[1]        = '\0';
+    p_stream->token_len       = 1;
+    p_stream->state           = state;
+}
+
+static bool
+gw_cfg_json_stream_append_token_char(gw_cfg_json_stream_t* const p_stream, const char ch, const size_t max_len)
+{
+    if (p_stream->token_len >= max_len)
+    {
+        return false;
+    }
+    p_stream->token[p_stream->token_len] = ch;
+    p_stream->token_len += 1;
+    p_stream->token[p_stream->token_len] = '\0';
+    return true;
+}
+
+static bool
+gw_cfg_json_stream_handle_value_begin(gw_cfg_json_stream_t* const p_stream, const char ch)
+{
+    if ('{' == ch)
+    {
+        return gw_cfg_json_stream_on_container_begin(p_stream, true);
+    }
+    if ('[' == ch)
+    {
+        return gw_cfg_json_stream_on_container_begin(p_stream, false);
+    }
+    if ('"' == ch)
+    {
+        gw_cfg_json_stream_on_string_begin(p_stream, false);
+        return true;
+    }
+    if (('-' == ch) || ((ch >= '0') && (ch <= '9')))
+    {
+        gw_cfg_json_stream_on_token_begin(p_stream, GW_CFG_JSON_STREAM_STATE_NUMBER, ch);
+        return true;
+    }
+    if (gw_cfg_json_stream_is_literal_char(ch))
+    {
+        gw_cfg_json_stream_on_token_begin(p_stream, GW_CFG_JSON_STREAM_STATE_LITERAL, ch);
+        return true;
+    }
+    return false;
+}
+
+static bool
+gw_cfg_json_stream_handle_comma_or_end(gw_cfg_json_stream_t* const p_stream, const char ch)
+{
+    const bool is_obj = gw_cfg_json_stream_is_inside_obj(p_stream);
+    if (',' == ch)
+    {
+        p_stream->state = is_obj ? GW_CFG_JSON_STREAM_STATE_KEY : GW_CFG_JSON_STREAM_STATE_ARR_VALUE;
+        return true;
+    }
+    if ((is_obj && ('}' == ch)) || ((!is_obj) && (']' == ch)))
+    {
+        return gw_cfg_json_stream_on_container_end(p_stream);
+    }
+    return false;
+}
+
+/**
+ * @brief Handle the byte which is not a part of a string, a literal or a number.
+ */
+static bool
+gw_cfg_json_stream_handle_structural_char(gw_cfg_json_stream_t* const p_stream, const char ch)
+{
+    if (gw_cfg_json_stream_is_whitespace(ch))
+    {
+        return true;
+    }
+    switch (p_stream->state)
+    {
+        case GW_CFG_JSON_STREAM_STATE_ROOT:
+            return ('{' == ch) ? gw_cfg_json_stream_on_container_begin(p_stream, true) : false;
+        case GW_CFG_JSON_STREAM_STATE_VALUE:
+        case GW_CFG_JSON_STREAM_STATE_ARR_VALUE:
+            return gw_cfg_json_stream_handle_value_begin(p_stream, ch);
+        case GW_CFG_JSON_STREAM_STATE_VALUE_OR_ARR_END:
+            return (']' == ch) ? gw_cfg_json_stream_on_container_end(p_stream)
+                               : gw_cfg_json_stream_handle_value_begin(p_stream, ch);
+        case GW_CFG_JSON_STREAM_STATE_KEY_OR_OBJ_END:
+            if ('}' == ch)
+            {
+                return gw_cfg_json_stream_on_container_end(p_stream);
+            }
+            if ('"' == ch)
+            {
+                gw_cfg_json_stream_on_string_begin(p_stream, true);
+                return true;
+            }
+            return false;
+        case GW_CFG_JSON_STREAM_STATE_KEY:
+            if ('"' == ch)
+            {
+                gw_cfg_json_stream_on_string_begin(p_stream, true);
+                return true;
+            }
+            return false;
+        case GW_CFG_JSON_STREAM_STATE_COLON:
+            if (':' == ch)
+            {
+                p_stream->state = GW_CFG_JSON_STREAM_STATE_VALUE;
+                return true;
+            }
+            return false;
+        case GW_CFG_JSON_STREAM_STATE_COMMA_OR_END:
+            return gw_cfg_json_stream_handle_comma_or_end(p_stream, ch);
+        default:
+            return false;
+    }
+}
+
+static bool
+gw_cfg_json_stream_handle_char(gw_cfg_json_stream_t* const p_stream, const char ch)
+{
+    switch (p_stream->state)
+    {
+        case GW_CFG_JSON_STREAM_STATE_STRING:
+            return gw_cfg_json_stream_handle_string_char(p_stream, ch);
+        case GW_CFG_JSON_STREAM_STATE_STRING_ESCAPE:
+            return gw_cfg_json_stream_handle_string_escape(p_stream, ch);
+        case GW_CFG_JSON_STREAM_STATE_STRING_UNICODE:
+            return gw_cfg_json_stream_handle_unicode_digit(p_stream, ch);
+        case GW_CFG_JSON_STREAM_STATE_STRING_SURROGATE:
+            p_stream->state = GW_CFG_JSON_STREAM_STATE_STRING_SURROGATE_U;
+            return ('\\' == ch) ? true : false;
+        case GW_CFG_JSON_STREAM_STATE_STRING_SURROGATE_U:
+            p_stream->unicode_val    = 0;
+            p_stream->unicode_digits = 0;
+            p_stream->state          = GW_CFG_JSON_STREAM_STATE_STRING_UNICODE;
+            return ('u' == ch) ? true : false;
+        case GW_CFG_JSON_STREAM_STATE_LITERAL:
+            if (gw_cfg_json_stream_is_literal_char(ch))
+            {
+                return gw_cfg_json_stream_append_token_char(p_stream, ch, GW_CFG_JSON_STREAM_MAX_LITERAL_LEN);
+            }
+            return gw_cfg_json_stream_on_literal_end(p_stream)
+                   && gw_cfg_json_stream_handle_structural_char(p_stream, ch);
+        case GW_CFG_JSON_STREAM_STATE_NUMBER:
+            if (gw_cfg_json_stream_is_number_char(ch))
+            {
+                return gw_cfg_json_stream_append_token_char(p_stream, ch, GW_CFG_JSON_STREAM_MAX_NUMBER_LEN);
+            }
+            return gw_cfg_json_stream_on_number_end(p_stream)
+                   && gw_cfg_json_stream_handle_structural_char(p_stream, ch);
+        case GW_CFG_JSON_STREAM_STATE_DONE:
+            // cJSON_Parse ignores the data after the end of the root object
+            return true;
+        case GW_CFG_JSON_STREAM_STATE_ERROR:
+            return false;
+        default:
+            return gw_cfg_json_stream_handle_structural_char(p_stream, ch);
+    }
+}
+
+bool
+gw_cfg_json_stream_feed(gw_cfg_json_stream_t* const p_stream, const char* const p_buf, const size_t len)
+{
+    if (GW_CFG_JSON_STREAM_STATE_ERROR == p_stream->state)
+    {
+        return false;
+    }
+    if ((0 == p_stream->offset) && (0 != len))
+    {
+        p_stream->first_char = p_buf[0];
+    }
+    for (size_t i = 0; i < len; ++i)
+    {
+        if (!gw_cfg_json_stream_handle_char(p_stream, p_buf[i]))
+        {
+            LOG_ERR("Failed to parse JSON at offset %lu", (printf_ulong_t)(p_stream->offset + i));
+            p_stream->state = GW_CFG_JSON_STREAM_STATE_ERROR;
+            cJSON_Delete(p_stream->p_root);
+            p_stream->p_root             = NULL;
+            p_stream->p_scan_filter_list = NULL;
+            p_stream->offset += i;
+            return false;
+        }
+    }
+    p_stream->offset += len;
+    return true;
+}
+
+bool
+gw_cfg_json_stream_parse(
+    const gw_cfg_json_stream_t* const p_stream,
+    const char* const                 p_json_name,
+    const char* const                 p_log_title,
+    gw_cfg_t* const                   p_gw_cfg)
+{
+    if (GW_CFG_JSON_STREAM_STATE_ERROR == p_stream->state)
+    {
+        LOG_ERR("Failed to parse %s: invalid JSON at offset %lu", p_json_name, (printf_ulong_t)p_stream->offset);
+        return false;
+    }
+    if (0 == p_stream->offset)
+    {
+        LOG_WARN("%s is empty", p_json_name);
+        return false;
+    }
+    if (GW_CFG_JSON_STREAM_STATE_DONE != p_stream->state)
+    {
+        LOG_ERR(
+            "Failed to parse %s: unexpected end of data at offset %lu",
+            p_json_name,
+            (printf_ulong_t)p_stream->offset);
+        return false;
+    }
+
+    if (NULL != p_log_title)
+    {
+        LOG_INFO("%s", p_log_title);
+    }
+    // The configuration is logged after the items of 'scan_filter_list' are applied
+    gw_cfg_json_parse_cjson(
+        p_stream->p_root,
+        NULL,
+        NULL,
+        &p_gw_cfg->ruuvi_cfg,
+        &p_gw_cfg->eth_cfg,
+        &p_gw_cfg->wifi_cfg.ap,
+        &p_gw_cfg->wifi_cfg.sta);
+
+    // gw_cfg_json_parse_cjson has found the empty 'scan_filter_list' container and set scan_filter_length to 0,
+    // so the MAC addresses which were converted on the fly should be copied.
+    if ((NULL != p_stream->p_scan_filter_list)
+        && (cJSON_GetObjectItem(p_stream->p_root, "scan_filter_list") == p_stream->p_scan_filter_list))
+    {
+        ruuvi_gw_cfg_scan_filter_t* const p_scan_filter = &p_gw_cfg->ruuvi_cfg.scan_filter;
+        memcpy(
+            &p_scan_filter->scan_filter_list[0],
+            &p_stream->scan_filter_list[0],
+            p_stream->scan_filter_length * sizeof(p_stream->scan_filter_list[0]));
+        p_scan_filter->scan_filter_length = p_stream->scan_filter_length;
+    }
+    if (NULL != p_log_title)
+    {
+        gw_cfg_log_ruuvi_cfg(&p_gw_cfg->ruuvi_cfg, NULL);
+        gw_cfg_log_eth_cfg(&p_gw_cfg->eth_cfg, NULL);
+        gw_cfg_log_wifi_cfg_ap(&p_gw_cfg->wifi_cfg.ap, NULL);
+        gw_cfg_log_wifi_cfg_sta(&p_gw_cfg->wifi_cfg.sta, NULL);
+    }
+    return true;
+}
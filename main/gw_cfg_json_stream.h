@@ -0,0 +1,106 @@
+/**
+ * @file gw_cfg_json_stream.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ * @brief Incremental parser of gw_cfg.json which is fed chunk by chunk (e.g. directly from the HTTP receive callback).
+ *
+ * The JSON is tokenized on the fly without buffering the whole document. The items of 'scan_filter_list' are
+ * converted to MAC addresses as they arrive, other values which are used by gw_cfg_json_parse_cjson are kept
+ * as a compact cJSON tree (strings are truncated to GW_CFG_JSON_STREAM_MAX_STR_LEN), all other values
+ * (including their strings) are validated and dropped immediately. So the memory consumption does not depend
+ * on the size of the document, it's limited by the number of the used keys.
+ * The field mapping itself is done by gw_cfg_json_parse_cjson, so the result is identical to gw_cfg_json_parse.
+ * The tokenizer is a bit stricter than cJSON: the root must be an object, malformed unicode escapes are rejected
+ * and the nesting level is limited by GW_CFG_JSON_STREAM_MAX_NESTING.
+ */
+
+#ifndef RUUVI_GATEWAY_ESP_GW_CFG_JSON_STREAM_H
+#define RUUVI_GATEWAY_ESP_GW_CFG_JSON_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "gw_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The maximum length of the string value which is kept, longer strings are truncated.
+ * @note It's bigger than any string field in gw_cfg_t, so the truncation does not affect the result.
+ */
+#define GW_CFG_JSON_STREAM_MAX_STR_LEN (512U)
+
+/**
+ * @brief The maximum length of the key which is kept, the keys used by gw_cfg are much shorter.
+ */
+#define GW_CFG_JSON_STREAM_MAX_KEY_LEN (64U)
+
+/**
+ * @brief The maximum nesting level of JSON objects and arrays.
+ */
+#define GW_CFG_JSON_STREAM_MAX_NESTING (32U)
+
+typedef struct gw_cfg_json_stream_t gw_cfg_json_stream_t;
+
+/**
+ * @brief Allocate and initialize the incremental parser.
+ * @return ptr to gw_cfg_json_stream_t or NULL if there is not enough memory.
+ */
+gw_cfg_json_stream_t*
+gw_cfg_json_stream_create(void);
+
+/**
+ * @brief Free the parser and the collected values.
+ * @param pp_stream - ptr to the ptr to gw_cfg_json_stream_t, it's set to NULL.
+ */
+void
+gw_cfg_json_stream_delete(gw_cfg_json_stream_t** const pp_stream);
+
+/**
+ * @brief Discard the collected values and prepare the parser for a new document.
+ * @param p_stream - ptr to gw_cfg_json_stream_t
+ */
+void
+gw_cfg_json_stream_reset(gw_cfg_json_stream_t* const p_stream);
+
+/**
+ * @brief Feed the next chunk of the JSON document.
+ * @note After an error all further chunks are ignored until gw_cfg_json_stream_reset is called.
+ * @param p_stream - ptr to gw_cfg_json_stream_t
+ * @param p_buf - ptr to the chunk
+ * @param len - length of the chunk
+ * @return false if the JSON is invalid or there is not enough memory.
+ */
+bool
+gw_cfg_json_stream_feed(gw_cfg_json_stream_t* const p_stream, const char* const p_buf, const size_t len);
+
+/**
+ * @brief Get the first byte of the document.
+ * @param p_stream - ptr to gw_cfg_json_stream_t
+ * @return the first byte or '\0' if nothing was fed.
+ */
+char
+gw_cfg_json_stream_get_first_char(const gw_cfg_json_stream_t* const p_stream);
+
+/**
+ * @brief Apply the collected values to gw_cfg (the same as gw_cfg_json_parse does for the whole JSON string).
+ * @param p_stream - ptr to gw_cfg_json_stream_t
+ * @param p_json_name - name of the JSON file (for logging)
+ * @param p_log_title - title for logging of the parsed configuration or NULL
+ * @param p_gw_cfg - ptr to gw_cfg_t to update
+ * @return false if the document is empty, incomplete or invalid.
+ */
+bool
+gw_cfg_json_stream_parse(
+    const gw_cfg_json_stream_t* const p_stream,
+    const char* const                 p_json_name,
+    const char* const                 p_log_title,
+    gw_cfg_t* const                   p_gw_cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_ESP_GW_CFG_JSON_STREAM_H
@@ -354,6 +354,9 @@ gw_cfg_log_ruuvi_cfg_http(const ruuvi_gw_cfg_http_t* const p_http)
             case GW_CFG_HTTP_DATA_FORMAT_RUUVI_DECODED:
                 LOG_INFO("config: http data format: %s", GW_CFG_HTTP_DATA_FORMAT_STR_DECODED);
                 break;
+            case GW_CFG_HTTP_DATA_FORMAT_RUUVI_CBOR:
+                LOG_INFO("config: http data format: %s", GW_CFG_HTTP_DATA_FORMAT_STR_CBOR);
+                break;
         }
         switch (p_http->auth_type)
         {
@@ -431,6 +434,9 @@ gw_cfg_log_ruuvi_cfg_mqtt(const ruuvi_gw_cfg_mqtt_t* const p_mqtt)
         case GW_CFG_MQTT_DATA_FORMAT_RUUVI_DECODED:
             LOG_INFO("config: mqtt data format: %s", GW_CFG_MQTT_DATA_FORMAT_STR_DECODED);
             break;
+        case GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_BATCH:
+            LOG_INFO("config: mqtt data format: %s", GW_CFG_MQTT_DATA_FORMAT_STR_RAW_BATCH);
+            break;
     }
     LOG_INFO("config: mqtt server: %s", p_mqtt->mqtt_server.buf);
     LOG_INFO("config: mqtt port: %u", p_mqtt->mqtt_port);
@@ -57,16 +57,19 @@ hmac_sha256_set_key_for_stats(const char* const p_key)
 }
 
 static bool
-hmac_sha256_calc(const char* const p_str, const hmac_sha256_key_t* const p_key, hmac_sha256_t* const p_hmac_sha256)
+hmac_sha256_calc_bin(
+    const uint8_t* const           p_msg,
+    const size_t                   msg_len,
+    const hmac_sha256_key_t* const p_key,
+    hmac_sha256_t* const           p_hmac_sha256)
 {
-    const size_t             msg_len   = strlen(p_str);
     const mbedtls_md_info_t* p_md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
     if (0
         != mbedtls_md_hmac(
             p_md_info,
             (const unsigned char*)p_key->key,
             p_key->key_size,
-            (const uint8_t*)p_str,
+            p_msg,
             msg_len,
             &p_hmac_sha256->buf[0]))
     {
@@ -76,11 +79,19 @@ hmac_sha256_calc(const char* const p_str, const hmac_sha256_key_t* const p_key,
     return true;
 }
 
+static bool
+hmac_sha256_calc(const char* const p_str, const hmac_sha256_key_t* const p_key, hmac_sha256_t* const p_hmac_sha256)
+{
+    return hmac_sha256_calc_bin((const uint8_t*)p_str, strlen(p_str), p_key, p_hmac_sha256);
+}
+
 static bool
 hmac_sha256_calc_for_json_gen(
-    json_stream_gen_t* const       p_gen,
-    const hmac_sha256_key_t* const p_key,
-    hmac_sha256_t* const           p_hmac_sha256)
+    json_stream_gen_t* const        p_gen,
+    const hmac_sha256_key_t* const  p_key,
+    hmac_sha256_t* const            p_hmac_sha256,
+    hmac_sha256_cb_on_chunk_t const p_cb_on_chunk,
+    void* const                     p_user_data)
 {
     const mbedtls_md_info_t* p_md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
 
@@ -121,13 +132,20 @@ hmac_sha256_calc_for_json_gen(
         {
             break;
         }
-        ret = mbedtls_md_hmac_update(&ctx, (const unsigned char*)p_chunk, strlen(p_chunk));
+        const size_t chunk_len = strlen(p_chunk);
+        ret                    = mbedtls_md_hmac_update(&ctx, (const unsigned char*)p_chunk, chunk_len);
         if (0 != ret)
         {
             mbedtls_md_free(&ctx);
             json_stream_gen_reset(p_gen);
             return false;
         }
+        if ((NULL != p_cb_on_chunk) && (!p_cb_on_chunk(p_user_data, p_chunk, chunk_len)))
+        {
+            mbedtls_md_free(&ctx);
+            json_stream_gen_reset(p_gen);
+            return false;
+        }
     }
 
     ret = mbedtls_md_hmac_finish(&ctx, &p_hmac_sha256->buf[0]);
@@ -149,10 +167,29 @@ hmac_sha256_calc_for_http_ruuvi(const char* const p_str, hmac_sha256_t* const p_
     return hmac_sha256_calc(p_str, &g_hmac_sha256_key_ruuvi, p_hmac_sha256);
 }
 
+bool
+hmac_sha256_calc_bin_for_http_ruuvi(
+    const uint8_t* const p_msg,
+    const size_t         msg_len,
+    hmac_sha256_t* const p_hmac_sha256)
+{
+    return hmac_sha256_calc_bin(p_msg, msg_len, &g_hmac_sha256_key_ruuvi, p_hmac_sha256);
+}
+
 bool
 hmac_sha256_calc_for_json_gen_http_ruuvi(json_stream_gen_t* const p_gen, hmac_sha256_t* const p_hmac_sha256)
 {
-    return hmac_sha256_calc_for_json_gen(p_gen, &g_hmac_sha256_key_ruuvi, p_hmac_sha256);
+    return hmac_sha256_calc_for_json_gen(p_gen, &g_hmac_sha256_key_ruuvi, p_hmac_sha256, NULL, NULL);
+}
+
+bool
+hmac_sha256_calc_for_json_gen_http_ruuvi_with_cb(
+    json_stream_gen_t* const        p_gen,
+    hmac_sha256_t* const            p_hmac_sha256,
+    hmac_sha256_cb_on_chunk_t const p_cb_on_chunk,
+    void* const                     p_user_data)
+{
+    return hmac_sha256_calc_for_json_gen(p_gen, &g_hmac_sha256_key_ruuvi, p_hmac_sha256, p_cb_on_chunk, p_user_data);
 }
 
 bool
@@ -161,10 +198,29 @@ hmac_sha256_calc_for_http_custom(const char* const p_str, hmac_sha256_t* const p
     return hmac_sha256_calc(p_str, &g_hmac_sha256_key_custom, p_hmac_sha256);
 }
 
+bool
+hmac_sha256_calc_bin_for_http_custom(
+    const uint8_t* const p_msg,
+    const size_t         msg_len,
+    hmac_sha256_t* const p_hmac_sha256)
+{
+    return hmac_sha256_calc_bin(p_msg, msg_len, &g_hmac_sha256_key_custom, p_hmac_sha256);
+}
+
 bool
 hmac_sha256_calc_for_json_gen_http_custom(json_stream_gen_t* const p_gen, hmac_sha256_t* const p_hmac_sha256)
 {
-    return hmac_sha256_calc_for_json_gen(p_gen, &g_hmac_sha256_key_custom, p_hmac_sha256);
+    return hmac_sha256_calc_for_json_gen(p_gen, &g_hmac_sha256_key_custom, p_hmac_sha256, NULL, NULL);
+}
+
+bool
+hmac_sha256_calc_for_json_gen_http_custom_with_cb(
+    json_stream_gen_t* const        p_gen,
+    hmac_sha256_t* const            p_hmac_sha256,
+    hmac_sha256_cb_on_chunk_t const p_cb_on_chunk,
+    void* const                     p_user_data)
+{
+    return hmac_sha256_calc_for_json_gen(p_gen, &g_hmac_sha256_key_custom, p_hmac_sha256, p_cb_on_chunk, p_user_data);
 }
 
 bool
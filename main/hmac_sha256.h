@@ -27,6 +27,15 @@ typedef struct hmac_sha256_t
     uint8_t buf[HMAC_SHA256_SIZE];
 } hmac_sha256_t;
 
+/**
+ * @brief Callback which is called for every chunk of json generated while calculating HMAC_SHA256.
+ * @param p_user_data - ptr to the user data
+ * @param p_chunk - ptr to the chunk of json
+ * @param len - length of the chunk
+ * @return true to continue, false to abort the calculation
+ */
+typedef bool (*hmac_sha256_cb_on_chunk_t)(void* const p_user_data, const char* const p_chunk, const size_t len);
+
 /**
  * @brief Set the secret key for HTTP Ruuvi target.
  * @param p_key - ptr to the string with the secret key
@@ -61,6 +70,19 @@ hmac_sha256_set_key_for_stats(const char* const p_key);
 bool
 hmac_sha256_calc_for_http_ruuvi(const char* const p_str, hmac_sha256_t* const p_hmac_sha256);
 
+/**
+ * @brief Compute HMAC_SHA256 for the binary message (e.g. CBOR) using the stored secret key for the Ruuvi target.
+ * @param p_msg - ptr to the buffer with a message
+ * @param msg_len - length of the message
+ * @param[out] p_hmac_sha256 - ptr to output binary buffer
+ * @return true if successful, false - otherwise
+ */
+bool
+hmac_sha256_calc_bin_for_http_ruuvi(
+    const uint8_t* const p_msg,
+    const size_t         msg_len,
+    hmac_sha256_t* const p_hmac_sha256);
+
 /**
  * @brief Compute HMAC_SHA256 for the message using the stored secret key for the Ruuvi target and return the result as
  * a binary buffer.
@@ -71,6 +93,22 @@ hmac_sha256_calc_for_http_ruuvi(const char* const p_str, hmac_sha256_t* const p_
 bool
 hmac_sha256_calc_for_json_gen_http_ruuvi(json_stream_gen_t* const p_gen, hmac_sha256_t* const p_hmac_sha256);
 
+/**
+ * @brief Compute HMAC_SHA256 for the message using the stored secret key for the Ruuvi target and pass every generated
+ * chunk to the callback, so that the json can be generated only once (for example, to spool it for HTTP POST).
+ * @param p_gen - ptr to json_stream_gen_t object which generates json
+ * @param[out] p_hmac_sha256 - ptr to output binary buffer
+ * @param p_cb_on_chunk - ptr to the callback which is called for every chunk of json
+ * @param p_user_data - ptr to the user data for the callback
+ * @return true if successful, false - otherwise
+ */
+bool
+hmac_sha256_calc_for_json_gen_http_ruuvi_with_cb(
+    json_stream_gen_t* const        p_gen,
+    hmac_sha256_t* const            p_hmac_sha256,
+    hmac_sha256_cb_on_chunk_t const p_cb_on_chunk,
+    void* const                     p_user_data);
+
 /**
  * @brief Compute HMAC_SHA256 for the message using the stored secret key for the custom target and return the result as
  * a binary buffer.
@@ -81,6 +119,19 @@ hmac_sha256_calc_for_json_gen_http_ruuvi(json_stream_gen_t* const p_gen, hmac_sh
 bool
 hmac_sha256_calc_for_http_custom(const char* const p_str, hmac_sha256_t* const p_hmac_sha256);
 
+/**
+ * @brief Compute HMAC_SHA256 for the binary message (e.g. CBOR) using the stored secret key for the custom target.
+ * @param p_msg - ptr to the buffer with a message
+ * @param msg_len - length of the message
+ * @param[out] p_hmac_sha256 - ptr to output binary buffer
+ * @return true if successful, false - otherwise
+ */
+bool
+hmac_sha256_calc_bin_for_http_custom(
+    const uint8_t* const p_msg,
+    const size_t         msg_len,
+    hmac_sha256_t* const p_hmac_sha256);
+
 /**
  * @brief Compute HMAC_SHA256 for the message using the stored secret key for the custom target and return the result as
  * a binary buffer.
@@ -91,6 +142,22 @@ hmac_sha256_calc_for_http_custom(const char* const p_str, hmac_sha256_t* const p
 bool
 hmac_sha256_calc_for_json_gen_http_custom(json_stream_gen_t* const p_gen, hmac_sha256_t* const p_hmac_sha256);
 
+/**
+ * @brief Compute HMAC_SHA256 for the message using the stored secret key for the custom target and pass every
+ * generated chunk to the callback, so that the json can be generated only once.
+ * @param p_gen - ptr to json_stream_gen_t object which generates json
+ * @param[out] p_hmac_sha256 - ptr to output binary buffer
+ * @param p_cb_on_chunk - ptr to the callback which is called for every chunk of json
+ * @param p_user_data - ptr to the user data for the callback
+ * @return true if successful, false - otherwise
+ */
+bool
+hmac_sha256_calc_for_json_gen_http_custom_with_cb(
+    json_stream_gen_t* const        p_gen,
+    hmac_sha256_t* const            p_hmac_sha256,
+    hmac_sha256_cb_on_chunk_t const p_cb_on_chunk,
+    void* const                     p_user_data);
+
 /**
  * @brief Compute HMAC_SHA256 for the message using the stored secret key for the stats and return the result as a
  * binary buffer.
@@ -9,6 +9,7 @@
 #include <string.h>
 #include <errno.h>
 #include <esp_task_wdt.h>
+#include <esp_system.h>
 #include "cjson_wrap.h"
 #include "esp_http_client.h"
 #include "mbedtls/ssl_misc.h"
@@ -17,6 +18,8 @@
 #include "leds.h"
 #include "os_str.h"
 #include "hmac_sha256.h"
+#include "http_cbor.h"
+#include "http_gzip.h"
 #include "adv_post_timers.h"
 #include "str_buf.h"
 #include "reset_info.h"
@@ -28,6 +31,7 @@
 #include "reset_task.h"
 #include "network_timeout.h"
 #include "tls_shared_buf.h"
+#include "metrics.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
 #include "log.h"
@@ -42,20 +46,182 @@ static const char TAG[] = "http";
 typedef int esp_http_client_len_t;
 typedef int esp_http_client_http_status_code_t;
 
-static http_async_info_t g_http_async_info;
+static http_async_info_t g_http_async_slots[HTTP_ASYNC_MAX_SLOTS];
+static uint32_t          g_http_async_poll_idx;
+static uint32_t          g_http_async_keep_alive_generation; //<! Incremented by http_keep_alive_close_all
 
-http_async_info_t*
-http_get_async_info(void)
+static http_async_info_t*
+http_async_slot_get(const uint32_t slot_idx)
 {
-    http_async_info_t* p_http_async_info = &g_http_async_info;
+    http_async_info_t* p_http_async_info = &g_http_async_slots[slot_idx];
     if (NULL == p_http_async_info->p_http_async_sema)
     {
+        p_http_async_info->slot_idx          = slot_idx;
         p_http_async_info->p_http_async_sema = os_sema_create_static(&p_http_async_info->http_async_sema_mem);
         os_sema_signal(p_http_async_info->p_http_async_sema);
     }
     return p_http_async_info;
 }
 
+http_async_info_t*
+http_get_async_info(void)
+{
+    return http_async_slot_get(0);
+}
+
+static bool
+http_async_slot_alloc_tls_buf(http_async_info_t* const p_http_async_info)
+{
+    if (0 == p_http_async_info->slot_idx)
+    {
+        p_http_async_info->p_tls_shared_buf = tls_shared_buf_get_https_post();
+        return true;
+    }
+    // The additional slots are used only if there is enough memory left for the other tasks.
+    const uint32_t free_heap = esp_get_free_heap_size();
+    if (free_heap < (sizeof(*p_http_async_info->p_tls_shared_buf) + HTTP_ASYNC_SLOT_MIN_FREE_HEAP))
+    {
+        LOG_DBG(
+            "Not enough memory for async slot %u: free_heap=%u",
+            (printf_uint_t)p_http_async_info->slot_idx,
+            (printf_uint_t)free_heap);
+        return false;
+    }
+    p_http_async_info->p_tls_shared_buf = tls_shared_buf_alloc_https_post();
+    return (NULL != p_http_async_info->p_tls_shared_buf);
+}
+
+static void
+http_async_slot_close_keep_alive_conn(http_async_info_t* const p_http_async_info);
+
+static bool
+http_async_slot_is_keep_alive_conn_reusable(
+    const http_async_info_t* const p_http_async_info,
+    const http_post_recipient_e    recipient)
+{
+    if ((!p_http_async_info->flag_keep_alive) || (recipient != p_http_async_info->recipient)
+        || (g_http_async_keep_alive_generation != p_http_async_info->keep_alive_generation))
+    {
+        return false;
+    }
+    const uint32_t idle_time_ms = ((uint32_t)xTaskGetTickCount() - p_http_async_info->keep_alive_idle_tick)
+                                  * portTICK_PERIOD_MS;
+    return idle_time_ms < HTTP_KEEP_ALIVE_MAX_IDLE_TIME_MS;
+}
+
+static http_async_info_t*
+http_async_slot_try_acquire(http_async_info_t* const p_http_async_info, const http_post_recipient_e recipient)
+{
+    LOG_DBG("os_sema_wait_immediate: p_http_async_sema[%u]", (printf_uint_t)p_http_async_info->slot_idx);
+    if (!os_sema_wait_immediate(p_http_async_info->p_http_async_sema))
+    {
+        return NULL;
+    }
+    if (p_http_async_info->flag_keep_alive
+        && (!http_async_slot_is_keep_alive_conn_reusable(p_http_async_info, recipient)))
+    {
+        http_async_slot_close_keep_alive_conn(p_http_async_info);
+    }
+    if (!p_http_async_info->flag_keep_alive)
+    {
+        if (!http_async_slot_alloc_tls_buf(p_http_async_info))
+        {
+            os_sema_signal(p_http_async_info->p_http_async_sema);
+            return NULL;
+        }
+        p_http_async_info->keep_alive_generation = g_http_async_keep_alive_generation;
+    }
+    p_http_async_info->p_task                     = os_task_get_cur_task_handle();
+    p_http_async_info->flag_async_req_in_progress = true;
+    return p_http_async_info;
+}
+
+http_async_info_t*
+http_async_slot_acquire(const http_post_recipient_e recipient)
+{
+    // Prefer the idle connection to the same recipient, then the slots without the idle connections,
+    // and only then close the idle connection to another recipient.
+    for (uint32_t slot_idx = 0; slot_idx < HTTP_ASYNC_MAX_SLOTS; ++slot_idx)
+    {
+        http_async_info_t* const p_http_async_info = http_async_slot_get(slot_idx);
+        if (http_async_slot_is_keep_alive_conn_reusable(p_http_async_info, recipient)
+            && (NULL != http_async_slot_try_acquire(p_http_async_info, recipient)))
+        {
+            LOG_DBG("Reuse the keep-alive connection in async slot %u", (printf_uint_t)slot_idx);
+            return p_http_async_info;
+        }
+    }
+    for (uint32_t slot_idx = 0; slot_idx < HTTP_ASYNC_MAX_SLOTS; ++slot_idx)
+    {
+        http_async_info_t* const p_http_async_info = http_async_slot_get(slot_idx);
+        if ((!p_http_async_info->flag_keep_alive)
+            && (NULL != http_async_slot_try_acquire(p_http_async_info, recipient)))
+        {
+            return p_http_async_info;
+        }
+    }
+    for (uint32_t slot_idx = 0; slot_idx < HTTP_ASYNC_MAX_SLOTS; ++slot_idx)
+    {
+        http_async_info_t* const p_http_async_info = http_async_slot_get(slot_idx);
+        if (p_http_async_info->flag_keep_alive && (NULL != http_async_slot_try_acquire(p_http_async_info, recipient)))
+        {
+            return p_http_async_info;
+        }
+    }
+    LOG_DBG("No free async slots");
+    return NULL;
+}
+
+static void
+http_async_slot_release_tls_buf(http_async_info_t* const p_http_async_info)
+{
+    if (NULL == p_http_async_info->p_tls_shared_buf)
+    {
+        return;
+    }
+    if (0 == p_http_async_info->slot_idx)
+    {
+        LOG_DBG("%s: tls_shared_buf_unlock_https_post", __func__);
+        tls_shared_buf_unlock_https_post(&p_http_async_info->p_tls_shared_buf);
+    }
+    else
+    {
+        LOG_DBG("%s: tls_shared_buf_free_https_post", __func__);
+        tls_shared_buf_free_https_post(&p_http_async_info->p_tls_shared_buf);
+    }
+}
+
+void
+http_async_slot_release(http_async_info_t* const p_http_async_info)
+{
+    if (!p_http_async_info->flag_keep_alive)
+    {
+        http_async_slot_release_tls_buf(p_http_async_info);
+    }
+    p_http_async_info->flag_async_req_in_progress = false;
+    LOG_DBG("os_sema_signal: p_http_async_sema[%u]", (printf_uint_t)p_http_async_info->slot_idx);
+    os_sema_signal(p_http_async_info->p_http_async_sema);
+}
+
+const http_async_info_t*
+http_async_info_find_by_handle(const esp_http_client_handle_t p_http_client_handle)
+{
+    if (NULL == p_http_client_handle)
+    {
+        return NULL;
+    }
+    for (uint32_t slot_idx = 0; slot_idx < HTTP_ASYNC_MAX_SLOTS; ++slot_idx)
+    {
+        const http_async_info_t* const p_http_async_info = &g_http_async_slots[slot_idx];
+        if (p_http_async_info->flag_async_req_in_progress
+            && (p_http_async_info->p_http_client_handle == p_http_client_handle))
+        {
+            return p_http_async_info;
+        }
+    }
+    return NULL;
+}
+
 static http_server_resp_t
 http_wait_until_async_req_completed_handle_http_resp(
     esp_http_client_handle_t   p_http_handle,
@@ -187,9 +353,83 @@ cb_on_post_get_chunk(void* p_user_data, const void** p_p_buf, size_t* p_len)
     return true;
 }
 
+static bool
+cb_on_post_get_chunk_from_spool(void* p_user_data, const void** p_p_buf, size_t* p_len)
+{
+    http_post_spool_t* const p_spool = p_user_data;
+    http_post_spool_read_next_block(p_spool, p_p_buf, p_len);
+    if (0 != *p_len)
+    {
+        // Don't print logs on INFO level because it's called from the HTTP event handler
+        LOG_DBG("HTTP POST DATA:\n%.*s", (printf_int_t)*p_len, (const char*)*p_p_buf);
+    }
+    return true;
+}
+
+static bool
+http_send_async_from_spool(http_async_info_t* const p_http_async_info)
+{
+    http_post_spool_t* const p_spool  = &p_http_async_info->post_spool;
+    const size_t             json_len = http_post_spool_get_total_len(p_spool);
+    LOG_INFO("HTTP POST DATA len=%u:", (printf_int_t)json_len);
+    if ((HTTP_CONTENT_TYPE_JSON == p_http_async_info->content_type)
+        && (HTTP_CONTENT_ENCODING_NONE == p_http_async_info->content_encoding)
+        && (json_len < HTTP_POST_MAX_LEN_TO_PRINT_LOG))
+    {
+        http_post_spool_rewind(p_spool);
+        while (true)
+        {
+            const void* p_buf = NULL;
+            size_t      len   = 0;
+            http_post_spool_read_next_block(p_spool, &p_buf, &len);
+            if (0 == len)
+            {
+                break;
+            }
+            LOG_INFO("HTTP POST DATA:\n%.*s", (printf_int_t)len, (const char*)p_buf);
+        }
+    }
+    http_post_spool_rewind(p_spool);
+
+    const esp_err_t err = esp_http_client_set_cb_on_post_get_chunk(
+        p_http_async_info->p_http_client_handle,
+        (esp_http_client_len_t)json_len,
+        &cb_on_post_get_chunk_from_spool,
+        (void*)p_spool);
+    if (0 != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_http_client_set_cb_on_post_get_chunk");
+        return false;
+    }
+    return true;
+}
+
 static bool
 http_send_async_from_json_stream_gen(http_async_info_t* const p_http_async_info)
 {
+    if (http_post_spool_is_complete(&p_http_async_info->post_spool))
+    {
+        return http_send_async_from_spool(p_http_async_info);
+    }
+    const size_t spooled_len = http_post_spool_get_total_len(&p_http_async_info->post_spool);
+    if (0 != spooled_len)
+    {
+        // The json was too large for the spool, but its length is already known,
+        // so there is no need to run the generator once more to calculate the length and to print it to the log.
+        LOG_INFO("HTTP POST DATA len=%u (not spooled)", (printf_int_t)spooled_len);
+        const esp_err_t err = esp_http_client_set_cb_on_post_get_chunk(
+            p_http_async_info->p_http_client_handle,
+            (esp_http_client_len_t)spooled_len,
+            &cb_on_post_get_chunk,
+            (void*)p_http_async_info->select.p_gen);
+        if (0 != err)
+        {
+            LOG_ERR_ESP(err, "%s failed", "esp_http_client_set_cb_on_post_get_chunk");
+            return false;
+        }
+        return true;
+    }
+
     const json_stream_gen_size_t json_len = json_stream_gen_calc_size(p_http_async_info->select.p_gen);
     LOG_INFO("HTTP POST DATA len=%u:", (printf_int_t)json_len);
     while (true)
@@ -271,6 +511,14 @@ http_send_async(http_async_info_t* const p_http_async_info)
     http_post_log_url(p_http_config);
     ruuvi_log_heap_usage();
 
+    if (p_http_async_info->flag_keep_alive)
+    {
+        // Reset the body and the optional headers of the previous request sent over the kept alive connection.
+        (void)esp_http_client_set_cb_on_post_get_chunk(p_http_async_info->p_http_client_handle, 0, NULL, NULL);
+        (void)esp_http_client_delete_header(p_http_async_info->p_http_client_handle, "Content-Encoding");
+        (void)esp_http_client_delete_header(p_http_async_info->p_http_client_handle, "Ruuvi-HMAC-SHA256");
+    }
+
     if (p_http_async_info->use_json_stream_gen)
     {
         if (!http_send_async_from_json_stream_gen(p_http_async_info))
@@ -278,6 +526,14 @@ http_send_async(http_async_info_t* const p_http_async_info)
             return false;
         }
     }
+    else if (http_post_spool_is_complete(&p_http_async_info->post_spool))
+    {
+        // The body was prepared in the spool (e.g. compressed)
+        if (!http_send_async_from_spool(p_http_async_info))
+        {
+            return false;
+        }
+    }
     else
     {
         const char* const p_msg = p_http_async_info->select.cjson_str.p_str;
@@ -293,7 +549,17 @@ http_send_async(http_async_info_t* const p_http_async_info)
         }
     }
 
-    esp_http_client_set_header(p_http_async_info->p_http_client_handle, "Content-Type", "application/json");
+    esp_http_client_set_header(
+        p_http_async_info->p_http_client_handle,
+        "Content-Type",
+        (HTTP_CONTENT_TYPE_CBOR == p_http_async_info->content_type) ? HTTP_CBOR_CONTENT_TYPE : "application/json");
+    if (HTTP_CONTENT_ENCODING_GZIP == p_http_async_info->content_encoding)
+    {
+        esp_http_client_set_header(
+            p_http_async_info->p_http_client_handle,
+            "Content-Encoding",
+            HTTP_GZIP_CONTENT_ENCODING);
+    }
 
     str_buf_t hmac_sha256_str = hmac_sha256_to_str_buf(&p_http_async_info->hmac_sha256);
     if (hmac_sha256_is_str_valid(&hmac_sha256_str))
@@ -302,8 +568,15 @@ http_send_async(http_async_info_t* const p_http_async_info)
     }
     str_buf_free_buf(&hmac_sha256_str);
 
+    if (esp_http_client_is_connection_alive(p_http_async_info->p_http_client_handle))
+    {
+        LOG_INFO("Send HTTP POST over the keep-alive connection");
+        metrics_http_conn_reused_inc();
+    }
+
     LOG_DBG("esp_http_client_perform");
-    const esp_err_t err = esp_http_client_perform(p_http_async_info->p_http_client_handle);
+    p_http_async_info->req_start_tick = (uint32_t)xTaskGetTickCount();
+    const esp_err_t err               = esp_http_client_perform(p_http_async_info->p_http_client_handle);
     if (ESP_ERR_HTTP_EAGAIN != err)
     {
         http_post_err_log(p_http_config, err);
@@ -328,14 +601,13 @@ http_send_async(http_async_info_t* const p_http_async_info)
     return true;
 }
 
-void
-http_async_info_free_data(http_async_info_t* const p_http_async_info)
+/**
+ * @brief Free the data which is used by esp_http_client while the connection is open (TLS buffer, certificates).
+ */
+static void
+http_async_info_free_conn_data(http_async_info_t* const p_http_async_info)
 {
-    if (NULL != p_http_async_info->p_tls_shared_buf)
-    {
-        LOG_DBG("%s: tls_shared_buf_unlock_https_post", __func__);
-        tls_shared_buf_unlock_https_post(&p_http_async_info->p_tls_shared_buf);
-    }
+    http_async_slot_release_tls_buf(p_http_async_info);
     if (NULL != p_http_async_info->http_client_config.esp_http_client_config.cert_pem)
     {
         os_free(p_http_async_info->http_client_config.esp_http_client_config.cert_pem);
@@ -351,6 +623,13 @@ http_async_info_free_data(http_async_info_t* const p_http_async_info)
         os_free(p_http_async_info->http_client_config.esp_http_client_config.client_key_pem);
         p_http_async_info->http_client_config.esp_http_client_config.client_key_pem = NULL;
     }
+}
+
+static void
+http_async_info_free_req_data(http_async_info_t* const p_http_async_info)
+{
+    http_post_spool_free(&p_http_async_info->post_spool);
+    p_http_async_info->p_adv_delta = NULL;
     if (p_http_async_info->use_json_stream_gen)
     {
         if (NULL != p_http_async_info->select.p_gen)
@@ -358,6 +637,7 @@ http_async_info_free_data(http_async_info_t* const p_http_async_info)
             json_stream_gen_delete(&p_http_async_info->select.p_gen);
             p_http_async_info->select.p_gen = NULL;
         }
+        adv_table_snapshot_release(&p_http_async_info->p_adv_table_snapshot);
     }
     else
     {
@@ -366,6 +646,91 @@ http_async_info_free_data(http_async_info_t* const p_http_async_info)
     }
 }
 
+void
+http_async_info_free_data(http_async_info_t* const p_http_async_info)
+{
+    if (p_http_async_info->flag_keep_alive)
+    {
+        // The request over the kept alive connection has failed, so the connection is not reused.
+        if (NULL != p_http_async_info->p_http_client_handle)
+        {
+            LOG_DBG("esp_http_client_cleanup");
+            esp_http_client_cleanup(p_http_async_info->p_http_client_handle);
+            p_http_async_info->p_http_client_handle = NULL;
+        }
+        p_http_async_info->flag_keep_alive = false;
+    }
+    http_async_info_free_conn_data(p_http_async_info);
+    http_async_info_free_req_data(p_http_async_info);
+}
+
+static void
+http_async_slot_close_keep_alive_conn(http_async_info_t* const p_http_async_info)
+{
+    LOG_INFO("Close the keep-alive connection in async slot %u", (printf_uint_t)p_http_async_info->slot_idx);
+    LOG_DBG("esp_http_client_cleanup");
+    esp_http_client_cleanup(p_http_async_info->p_http_client_handle);
+    p_http_async_info->p_http_client_handle = NULL;
+    p_http_async_info->flag_keep_alive      = false;
+    http_async_info_free_conn_data(p_http_async_info);
+}
+
+/**
+ * @brief Keep the connection open after the successful request if the server allows it (HTTP/1.1 keep-alive),
+ *        so that the next request to the same recipient is sent without a new TCP connection and TLS handshake.
+ */
+static bool
+http_async_slot_keep_conn(http_async_info_t* const p_http_async_info, const bool flag_success)
+{
+    if ((0 == HTTP_KEEP_ALIVE_MAX_IDLE_TIME_MS) || (!flag_success)
+        || (g_http_async_keep_alive_generation != p_http_async_info->keep_alive_generation)
+        || (!esp_http_client_is_connection_alive(p_http_async_info->p_http_client_handle)))
+    {
+        return false;
+    }
+    p_http_async_info->flag_keep_alive      = true;
+    p_http_async_info->keep_alive_idle_tick = (uint32_t)xTaskGetTickCount();
+    return true;
+}
+
+void
+http_async_on_connected(const esp_http_client_handle_t p_http_client_handle)
+{
+    const http_async_info_t* const p_http_async_info = http_async_info_find_by_handle(p_http_client_handle);
+    if (NULL == p_http_async_info)
+    {
+        return;
+    }
+    const uint32_t handshake_time_ms = ((uint32_t)xTaskGetTickCount() - p_http_async_info->req_start_tick)
+                                       * portTICK_PERIOD_MS;
+    LOG_DBG(
+        "New connection in async slot %u is established in %u ms",
+        (printf_uint_t)p_http_async_info->slot_idx,
+        (printf_uint_t)handshake_time_ms);
+    metrics_http_conn_handshake_add(handshake_time_ms);
+}
+
+void
+http_keep_alive_close_all(void)
+{
+    // The connections of the requests in progress are closed after the completion because of the new generation.
+    g_http_async_keep_alive_generation += 1;
+    for (uint32_t slot_idx = 0; slot_idx < HTTP_ASYNC_MAX_SLOTS; ++slot_idx)
+    {
+        http_async_info_t* const p_http_async_info = http_async_slot_get(slot_idx);
+        if (!p_http_async_info->flag_keep_alive)
+        {
+            continue;
+        }
+        if (!os_sema_wait_immediate(p_http_async_info->p_http_async_sema))
+        {
+            continue;
+        }
+        http_async_slot_close_keep_alive_conn(p_http_async_info);
+        os_sema_signal(p_http_async_info->p_http_async_sema);
+    }
+}
+
 bool
 http_handle_add_authorization_if_needed(
     esp_http_client_handle_t              http_handle,
@@ -525,11 +890,46 @@ http_async_poll_do_actions_after_completion(const http_async_info_t* const p_htt
     }
 }
 
-bool
-http_async_poll(void)
+/**
+ * @brief Save the delivered advs to the shadow of delta-encoding,
+ *        so that the next POST contains only the fields changed since this one.
+ */
+static void
+http_async_poll_update_adv_delta(const http_async_info_t* const p_http_async_info)
 {
-    http_async_info_t* p_http_async_info = http_get_async_info();
+    if ((NULL == p_http_async_info->p_adv_delta) || (NULL == p_http_async_info->p_adv_table_snapshot))
+    {
+        return;
+    }
+    const num_of_advs_t num_of_advs = adv_table_snapshot_get_num_of_advs(p_http_async_info->p_adv_table_snapshot);
+    for (num_of_advs_t i = 0; i < num_of_advs; ++i)
+    {
+        adv_report_t adv = { 0 };
+        if (adv_table_snapshot_get_adv(p_http_async_info->p_adv_table_snapshot, i, &adv))
+        {
+            adv_delta_commit(p_http_async_info->p_adv_delta, &adv);
+        }
+    }
+}
 
+static metrics_http_target_e
+http_async_recipient_to_metrics_target(const http_post_recipient_e recipient)
+{
+    switch (recipient)
+    {
+        case HTTP_POST_RECIPIENT_STATS:
+            return METRICS_HTTP_TARGET_STATS;
+        case HTTP_POST_RECIPIENT_ADVS1:
+            return METRICS_HTTP_TARGET_RUUVI;
+        case HTTP_POST_RECIPIENT_ADVS2:
+            return METRICS_HTTP_TARGET_CUSTOM;
+    }
+    return METRICS_HTTP_TARGET_STATS;
+}
+
+static bool
+http_async_poll_slot(http_async_info_t* const p_http_async_info)
+{
     if (p_http_async_info->p_task != os_task_get_cur_task_handle())
     {
         LOG_ERR(
@@ -540,13 +940,16 @@ http_async_poll(void)
         assert(p_http_async_info->p_task == os_task_get_cur_task_handle());
     }
 
-    LOG_DBG("esp_http_client_perform");
+    LOG_DBG("esp_http_client_perform: slot %u", (printf_uint_t)p_http_async_info->slot_idx);
     const esp_err_t err = esp_http_client_perform(p_http_async_info->p_http_client_handle);
     if (ESP_ERR_HTTP_EAGAIN == err)
     {
         LOG_DBG("esp_http_client_perform: ESP_ERR_HTTP_EAGAIN");
         return false;
     }
+    metrics_http_post_duration_add(
+        http_async_recipient_to_metrics_target(p_http_async_info->recipient),
+        ((uint32_t)xTaskGetTickCount() - p_http_async_info->req_start_tick) * portTICK_PERIOD_MS);
 
     bool flag_success = false;
     if (ESP_OK == err)
@@ -579,27 +982,60 @@ http_async_poll(void)
         }
     }
 
-    LOG_DBG("esp_http_client_cleanup");
-    esp_http_client_cleanup(p_http_async_info->p_http_client_handle);
-    p_http_async_info->p_http_client_handle = NULL;
-
-    http_async_info_free_data(p_http_async_info);
+    if (flag_success)
+    {
+        http_async_poll_update_adv_delta(p_http_async_info);
+    }
+    if (http_async_slot_keep_conn(p_http_async_info, flag_success))
+    {
+        http_async_info_free_req_data(p_http_async_info);
+    }
+    else
+    {
+        LOG_DBG("esp_http_client_cleanup");
+        esp_http_client_cleanup(p_http_async_info->p_http_client_handle);
+        p_http_async_info->p_http_client_handle = NULL;
+        http_async_info_free_data(p_http_async_info);
+    }
 
     if (flag_success && (HTTP_POST_RECIPIENT_STATS != p_http_async_info->recipient))
     {
+        metrics_boot_first_adv_relayed();
         if (!ruuvi_gw_mark_app_valid_cancel_rollback()) // NOSONAR
         {
             LOG_ERR("%s failed", "fw_update_mark_app_valid_cancel_rollback");
         }
     }
 
+    p_http_async_info->flag_last_req_successful = flag_success;
     http_async_poll_do_actions_after_completion(p_http_async_info, flag_success);
 
-    LOG_DBG("os_sema_signal: p_http_async_sema");
-    os_sema_signal(p_http_async_info->p_http_async_sema);
+    http_async_slot_release(p_http_async_info);
     return true;
 }
 
+http_async_info_t*
+http_async_poll(void)
+{
+    // The slots are polled round-robin starting from the slot next to the last completed one,
+    // so that a slow target does not delay the completion of the others.
+    for (uint32_t i = 0; i < HTTP_ASYNC_MAX_SLOTS; ++i)
+    {
+        const uint32_t           slot_idx          = (g_http_async_poll_idx + i) % HTTP_ASYNC_MAX_SLOTS;
+        http_async_info_t* const p_http_async_info = &g_http_async_slots[slot_idx];
+        if (!p_http_async_info->flag_async_req_in_progress)
+        {
+            continue;
+        }
+        if (http_async_poll_slot(p_http_async_info))
+        {
+            g_http_async_poll_idx = (slot_idx + 1) % HTTP_ASYNC_MAX_SLOTS;
+            return p_http_async_info;
+        }
+    }
+    return NULL;
+}
+
 const char*
 http_client_method_to_str(const esp_http_client_method_t http_method)
 {
@@ -640,11 +1076,10 @@ http_method_to_str(const http_async_info_t* const p_http_async_info)
     return http_client_method_to_str(p_http_async_info->http_client_config.esp_http_client_config.method);
 }
 
-void
-http_abort_any_req_during_processing(void)
+static void
+http_abort_req_in_slot(http_async_info_t* const p_http_async_info)
 {
-    http_async_info_t* p_http_async_info = http_get_async_info();
-    LOG_DBG("os_sema_wait_immediate: p_http_async_sema");
+    LOG_DBG("os_sema_wait_immediate: p_http_async_sema[%u]", (printf_uint_t)p_http_async_info->slot_idx);
     if (!os_sema_wait_immediate(p_http_async_info->p_http_async_sema))
     {
         const esp_http_client_config_t* const p_http_config = &p_http_async_info->http_client_config
@@ -678,6 +1113,25 @@ http_abort_any_req_during_processing(void)
         p_http_async_info->p_http_client_handle = NULL;
         http_async_info_free_data(p_http_async_info);
     }
-    LOG_DBG("os_sema_signal: p_http_async_sema");
+    else if (p_http_async_info->flag_keep_alive)
+    {
+        http_async_slot_close_keep_alive_conn(p_http_async_info);
+    }
+    else
+    {
+        // MISRA C:2012, 15.7 - All if...else if constructs shall be terminated with an else statement
+    }
+    p_http_async_info->flag_async_req_in_progress = false;
+    LOG_DBG("os_sema_signal: p_http_async_sema[%u]", (printf_uint_t)p_http_async_info->slot_idx);
     os_sema_signal(p_http_async_info->p_http_async_sema);
 }
+
+void
+http_abort_any_req_during_processing(void)
+{
+    for (uint32_t slot_idx = 0; slot_idx < HTTP_ASYNC_MAX_SLOTS; ++slot_idx)
+    {
+        http_abort_req_in_slot(http_async_slot_get(slot_idx));
+    }
+    g_http_async_poll_idx = 0;
+}
@@ -19,6 +19,7 @@
 #include "time_units.h"
 #include "gw_cfg.h"
 #include "hmac_sha256.h"
+#include "http_post_spool.h"
 #if !defined(RUUVI_TESTS)
 #include "tls_shared_buf.h"
 #endif
@@ -33,6 +34,41 @@ extern "C" {
 #define HTTP_DOWNLOAD_CHECK_MQTT_TIMEOUT_SECONDS           (30)
 #define HTTP_DOWNLOAD_NETWORK_RECONNECTION_TIMEOUT_SECONDS (15)
 
+#if !defined(HTTP_DELTA_KEYFRAME_INTERVAL)
+/**
+ * @brief Send only the changed decoded fields to the custom HTTP target (see adv_delta.h)
+ *        and all fields in every HTTP_DELTA_KEYFRAME_INTERVAL-th POST for the tag, 0 - delta encoding is disabled.
+ * @note It's configured by RUUVI_HTTP_DELTA_KEYFRAME_INTERVAL in the top-level CMakeLists.txt.
+ */
+#define HTTP_DELTA_KEYFRAME_INTERVAL (0)
+#endif
+
+#if !defined(HTTP_ASYNC_MAX_SLOTS)
+/**
+ * @brief The maximum number of concurrent async HTTP requests (one per target: Ruuvi, custom HTTP, statistics).
+ * @note It's configured by RUUVI_HTTP_ASYNC_MAX_SLOTS in the top-level CMakeLists.txt.
+ */
+#define HTTP_ASYNC_MAX_SLOTS (3U)
+#endif
+
+#if !defined(HTTP_ASYNC_SLOT_MIN_FREE_HEAP)
+/**
+ * @brief The free heap which must remain after allocating the TLS buffer for an additional async HTTP slot.
+ */
+#define HTTP_ASYNC_SLOT_MIN_FREE_HEAP (40U * 1024U)
+#endif
+
+#if !defined(HTTP_KEEP_ALIVE_MAX_IDLE_TIME_MS)
+/**
+ * @brief The maximum idle time of the connection which is kept alive between HTTP POSTs to the same target,
+ *        0 - HTTP keep-alive is disabled and every HTTP POST uses a new connection.
+ * @note It should be less than the keep-alive timeout of the server, otherwise the server closes the connection first
+ *       and the next HTTP POST needs a new connection (the TLS session is resumed from the saved session ticket).
+ * @note It's configured by RUUVI_HTTP_KEEP_ALIVE_MAX_IDLE_TIME_MS in the top-level CMakeLists.txt.
+ */
+#define HTTP_KEEP_ALIVE_MAX_IDLE_TIME_MS (60U * 1000U)
+#endif
+
 #if defined(RUUVI_TESTS) && RUUVI_TESTS
 typedef struct tls_shared_buf_https_post_t tls_shared_buf_https_post_t;
 #endif
@@ -44,6 +80,18 @@ typedef enum http_post_recipient_e
     HTTP_POST_RECIPIENT_ADVS2,
 } http_post_recipient_e;
 
+typedef enum http_content_type_e
+{
+    HTTP_CONTENT_TYPE_JSON = 0,
+    HTTP_CONTENT_TYPE_CBOR, //<! The body is in post_spool, it's binary and must not be printed to the log
+} http_content_type_e;
+
+typedef enum http_content_encoding_e
+{
+    HTTP_CONTENT_ENCODING_NONE = 0,
+    HTTP_CONTENT_ENCODING_GZIP, //<! The compressed body is in post_spool (see http_gzip.h)
+} http_content_encoding_e;
+
 typedef struct http_resp_cb_info_t
 {
     uint32_t content_length;
@@ -63,11 +111,23 @@ typedef struct http_async_info_t
         cjson_wrap_str_t   cjson_str;
         json_stream_gen_t* p_gen;
     } select;
+    http_post_spool_t            post_spool;
+    adv_table_snapshot_t*        p_adv_table_snapshot; //<! Data source for select.p_gen (the reference is held)
+    adv_delta_t*                 p_adv_delta; //<! Shadow to be updated from p_adv_table_snapshot after success
     hmac_sha256_t                hmac_sha256;
+    http_content_type_e          content_type;
+    http_content_encoding_e      content_encoding;
     http_post_recipient_e        recipient;
     os_task_handle_t             p_task;
     http_resp_cb_info_t          http_resp_cb_info;
-    tls_shared_buf_https_post_t* p_tls_shared_buf;
+    tls_shared_buf_https_post_t* p_tls_shared_buf; //<! Shared buffer for slot 0, heap-allocated for other slots
+    bool                         flag_last_req_successful; //<! Result of the last completed async request
+    bool                         flag_async_req_in_progress; //<! The slot is acquired by http_async_slot_acquire
+    uint32_t                     slot_idx;
+    uint32_t                     req_start_tick; //<! Tick count when the request was sent, for the metrics
+    bool                         flag_keep_alive; //<! p_http_client_handle is kept connected for the next request
+    uint32_t                     keep_alive_generation; //<! Generation of the keep-alive connections on opening
+    uint32_t                     keep_alive_idle_tick; //<! Tick count when the kept alive connection became idle
 } http_async_info_t;
 
 typedef struct http_header_item_t
@@ -91,7 +151,8 @@ typedef struct http_check_params_t
 
 bool
 http_post_advs(
-    const adv_report_table_t* const  p_reports,
+    http_async_info_t* const         p_http_async_info,
+    adv_table_snapshot_t* const      p_snapshot,
     const uint32_t                   nonce,
     const bool                       flag_use_timestamps,
     const bool                       flag_post_to_ruuvi,
@@ -103,6 +164,7 @@ http_check_post_advs(const http_check_params_t* const p_params, const TimeUnitsS
 
 bool
 http_post_stat(
+    http_async_info_t* const                 p_http_async_info,
     const http_json_statistics_info_t* const p_stat_info,
     const adv_report_table_t* const          p_reports,
     const ruuvi_gw_cfg_http_stat_t* const    p_cfg_http_stat,
@@ -116,13 +178,60 @@ http_check_post_stat(const http_check_params_t* const p_params, const TimeUnitsS
 http_server_resp_t
 http_check_mqtt(const ruuvi_gw_cfg_mqtt_t* const p_mqtt_cfg, const TimeUnitsSeconds_t timeout_seconds);
 
+/**
+ * @brief Get the async info of slot 0, which is used for the synchronous requests (checks and downloads).
+ */
 http_async_info_t*
 http_get_async_info(void);
 
+/**
+ * @brief Acquire a free slot for an async HTTP POST.
+ * @note Slot 0 uses the shared TLS buffer, the other slots allocate the TLS buffer from the heap
+ *       and are used only if at least HTTP_ASYNC_SLOT_MIN_FREE_HEAP bytes of the heap remain free after that.
+ * @note The slot with the connection kept alive after the previous request to the same recipient is preferred,
+ *       the idle connections to other recipients are closed only if there are no other free slots.
+ * @param recipient - the recipient of the HTTP POST
+ * @return ptr to the slot or NULL if all slots are busy or there is not enough memory.
+ */
+http_async_info_t*
+http_async_slot_acquire(const http_post_recipient_e recipient);
+
+/**
+ * @brief Release the slot acquired by http_async_slot_acquire if the request was not started.
+ */
+void
+http_async_slot_release(http_async_info_t* const p_http_async_info);
+
+/**
+ * @brief Find the slot of the async request by the esp_http_client handle.
+ * @return ptr to the slot or NULL if the handle does not belong to any async request.
+ */
+const http_async_info_t*
+http_async_info_find_by_handle(const esp_http_client_handle_t p_http_client_handle);
+
 void
 http_async_info_free_data(http_async_info_t* const p_http_async_info);
 
-bool
+/**
+ * @brief Update the metrics of the new connection, it's called from the HTTP event handler on HTTP_EVENT_ON_CONNECTED.
+ */
+void
+http_async_on_connected(const esp_http_client_handle_t p_http_client_handle);
+
+/**
+ * @brief Close the idle keep-alive connections and don't keep the connections of the requests in progress.
+ * @note It must be called when the configuration of the HTTP targets is changed or the relaying is disabled
+ *       (the TLS buffers of the idle connections are needed for HTTPS downloads and the checks).
+ */
+void
+http_keep_alive_close_all(void);
+
+/**
+ * @brief Poll the async requests in progress round-robin, one esp_http_client_perform per slot.
+ * @return ptr to the slot of the completed request (it's released and only the result fields are valid)
+ *         or NULL if none of the requests is completed.
+ */
+http_async_info_t*
 http_async_poll(void);
 
 void
@@ -0,0 +1,361 @@
+/**
+ * @file http_cbor.c
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_cbor.h"
+#include <string.h>
+#include "os_malloc.h"
+#include "ruuvi_endpoint_ca_uart.h"
+
+#if defined(RUUVI_TESTS) && RUUVI_TESTS
+#define LOG_LOCAL_DISABLED 1
+#define LOG_LOCAL_LEVEL    LOG_LEVEL_NONE
+#else
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#endif
+#include "log.h"
+static const char TAG[] = "http_cbor";
+
+#define HTTP_CBOR_MAJOR_TYPE_UINT   (0U)
+#define HTTP_CBOR_MAJOR_TYPE_NEGINT (1U)
+#define HTTP_CBOR_MAJOR_TYPE_BYTES  (2U)
+#define HTTP_CBOR_MAJOR_TYPE_TEXT   (3U)
+#define HTTP_CBOR_MAJOR_TYPE_MAP    (5U)
+
+#define HTTP_CBOR_MAJOR_TYPE_SHIFT (5U)
+
+#define HTTP_CBOR_MAX_DIRECT_VAL (23U)
+#define HTTP_CBOR_ADD_INFO_1BYTE (24U)
+#define HTTP_CBOR_ADD_INFO_2BYTE (25U)
+#define HTTP_CBOR_ADD_INFO_4BYTE (26U)
+#define HTTP_CBOR_ADD_INFO_8BYTE (27U)
+
+#define HTTP_CBOR_HEAD_MAX_SIZE (9U)
+
+#define BYTE_MASK      (0xFFU)
+#define BITS_PER_BYTE  (8U)
+#define UINT8_MAX_VAL  (0xFFU)
+#define UINT16_MAX_VAL (0xFFFFU)
+#define UINT32_MAX_VAL (0xFFFFFFFFU)
+
+/**
+ * @brief CBOR writer: if p_buf is NULL, then it only calculates the length of the encoded data.
+ */
+typedef struct http_cbor_writer_t
+{
+    uint8_t* p_buf;
+    size_t   buf_size;
+    size_t   len;
+    bool     flag_overflow;
+} http_cbor_writer_t;
+
+static void
+http_cbor_put_raw(http_cbor_writer_t* const p_wr, const uint8_t* const p_data, const size_t len)
+{
+    if (NULL != p_wr->p_buf)
+    {
+        if ((p_wr->len + len) > p_wr->buf_size)
+        {
+            p_wr->flag_overflow = true;
+            return;
+        }
+        memcpy(&p_wr->p_buf[p_wr->len], p_data, len);
+    }
+    p_wr->len += len;
+}
+
+static void
+http_cbor_put_head(http_cbor_writer_t* const p_wr, const uint8_t major_type, const uint64_t val)
+{
+    uint8_t      head[HTTP_CBOR_HEAD_MAX_SIZE] = { 0 };
+    const size_t initial_byte                  = (size_t)major_type << HTTP_CBOR_MAJOR_TYPE_SHIFT;
+    size_t       num_val_bytes                 = 0;
+    if (val <= HTTP_CBOR_MAX_DIRECT_VAL)
+    {
+        head[0] = (uint8_t)(initial_byte | (size_t)val);
+    }
+    else if (val <= UINT8_MAX_VAL)
+    {
+        head[0]       = (uint8_t)(initial_byte | HTTP_CBOR_ADD_INFO_1BYTE);
+        num_val_bytes = sizeof(uint8_t);
+    }
+    else if (val <= UINT16_MAX_VAL)
+    {
+        head[0]       = (uint8_t)(initial_byte | HTTP_CBOR_ADD_INFO_2BYTE);
+        num_val_bytes = sizeof(uint16_t);
+    }
+    else if (val <= UINT32_MAX_VAL)
+    {
+        head[0]       = (uint8_t)(initial_byte | HTTP_CBOR_ADD_INFO_4BYTE);
+        num_val_bytes = sizeof(uint32_t);
+    }
+    else
+    {
+        head[0]       = (uint8_t)(initial_byte | HTTP_CBOR_ADD_INFO_8BYTE);
+        num_val_bytes = sizeof(uint64_t);
+    }
+    // The argument is stored in network byte order (big-endian)
+    for (size_t i = 0; i < num_val_bytes; ++i)
+    {
+        head[1 + i] = (uint8_t)((val >> ((num_val_bytes - 1 - i) * BITS_PER_BYTE)) & BYTE_MASK);
+    }
+    http_cbor_put_raw(p_wr, head, 1 + num_val_bytes);
+}
+
+static void
+http_cbor_put_uint(http_cbor_writer_t* const p_wr, const uint64_t val)
+{
+    http_cbor_put_head(p_wr, HTTP_CBOR_MAJOR_TYPE_UINT, val);
+}
+
+static void
+http_cbor_put_int(http_cbor_writer_t* const p_wr, const int64_t val)
+{
+    if (val >= 0)
+    {
+        http_cbor_put_head(p_wr, HTTP_CBOR_MAJOR_TYPE_UINT, (uint64_t)val);
+    }
+    else
+    {
+        // Negative integer -1-N is encoded as N
+        http_cbor_put_head(p_wr, HTTP_CBOR_MAJOR_TYPE_NEGINT, (uint64_t)(-(val + 1)));
+    }
+}
+
+static void
+http_cbor_put_bytes(http_cbor_writer_t* const p_wr, const uint8_t* const p_data, const size_t len)
+{
+    http_cbor_put_head(p_wr, HTTP_CBOR_MAJOR_TYPE_BYTES, len);
+    http_cbor_put_raw(p_wr, p_data, len);
+}
+
+static void
+http_cbor_put_text(http_cbor_writer_t* const p_wr, const char* const p_str)
+{
+    const size_t len = strlen(p_str);
+    http_cbor_put_head(p_wr, HTTP_CBOR_MAJOR_TYPE_TEXT, len);
+    http_cbor_put_raw(p_wr, (const uint8_t*)p_str, len);
+}
+
+static void
+http_cbor_put_map(http_cbor_writer_t* const p_wr, const size_t num_pairs)
+{
+    http_cbor_put_head(p_wr, HTTP_CBOR_MAJOR_TYPE_MAP, num_pairs);
+}
+
+static const char*
+http_cbor_get_ble_phy_str(const adv_report_t* const p_adv)
+{
+    switch (p_adv->secondary_phy)
+    {
+        case RE_CA_UART_BLE_PHY_NOT_SET:
+            return "1M";
+        case RE_CA_UART_BLE_PHY_2MBPS:
+            return "2M";
+        case RE_CA_UART_BLE_PHY_CODED:
+            return "Coded";
+        default:
+            break;
+    }
+    return NULL;
+}
+
+static void
+http_cbor_put_adv(
+    http_cbor_writer_t* const                   p_wr,
+    const http_cbor_create_advs_params_t* const p_params,
+    const adv_report_t* const                   p_adv)
+{
+    const char* const p_ble_phy_str     = http_cbor_get_ble_phy_str(p_adv);
+    const bool        flag_tx_power     = RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID != p_adv->tx_power;
+    size_t            num_of_attributes = 4; // rssi, timestamp/counter, ble_chan, data
+    if (NULL != p_ble_phy_str)
+    {
+        num_of_attributes += 1;
+    }
+    if (flag_tx_power)
+    {
+        num_of_attributes += 1;
+    }
+
+    const mac_address_str_t mac_str = mac_address_to_str(&p_adv->tag_mac);
+    http_cbor_put_text(p_wr, mac_str.str_buf);
+    http_cbor_put_map(p_wr, num_of_attributes);
+    http_cbor_put_text(p_wr, "rssi");
+    http_cbor_put_int(p_wr, p_adv->rssi);
+    http_cbor_put_text(p_wr, p_params->flag_use_timestamps ? "timestamp" : "counter");
+    http_cbor_put_uint(p_wr, (uint64_t)p_adv->timestamp);
+    if (NULL != p_ble_phy_str)
+    {
+        http_cbor_put_text(p_wr, "ble_phy");
+        http_cbor_put_text(p_wr, p_ble_phy_str);
+    }
+    http_cbor_put_text(p_wr, "ble_chan");
+    http_cbor_put_uint(p_wr, p_adv->ch_index);
+    if (flag_tx_power)
+    {
+        http_cbor_put_text(p_wr, "ble_tx_power");
+        http_cbor_put_int(p_wr, p_adv->tx_power);
+    }
+    http_cbor_put_text(p_wr, "data");
+    http_cbor_put_bytes(p_wr, p_adv->data_buf, p_adv->data_len);
+}
+
+static num_of_advs_t
+http_cbor_put_advs(
+    http_cbor_writer_t* const                   p_wr,
+    const adv_report_t* const                   p_arr_of_advs,
+    const num_of_advs_t                         num_of_advs,
+    const http_cbor_create_advs_params_t* const p_params)
+{
+    size_t num_of_attributes = 3; // coordinates, gw_mac, tags
+    if (p_params->flag_use_timestamps)
+    {
+        num_of_attributes += 1;
+    }
+    if (p_params->flag_use_nonce)
+    {
+        num_of_attributes += 1;
+    }
+
+    http_cbor_put_map(p_wr, 1);
+    http_cbor_put_text(p_wr, "data");
+    http_cbor_put_map(p_wr, num_of_attributes);
+    http_cbor_put_text(p_wr, "coordinates");
+    http_cbor_put_text(p_wr, (NULL != p_params->coordinates_str_buf.buf) ? p_params->coordinates_str_buf.buf : "");
+    if (p_params->flag_use_timestamps)
+    {
+        http_cbor_put_text(p_wr, "timestamp");
+        http_cbor_put_uint(p_wr, (uint64_t)p_params->cur_time);
+    }
+    if (p_params->flag_use_nonce)
+    {
+        http_cbor_put_text(p_wr, "nonce");
+        http_cbor_put_uint(p_wr, p_params->nonce);
+    }
+    http_cbor_put_text(p_wr, "gw_mac");
+    http_cbor_put_text(p_wr, p_params->p_mac_addr->str_buf);
+
+    http_cbor_put_text(p_wr, "tags");
+    http_cbor_put_map(p_wr, num_of_advs);
+    num_of_advs_t num_of_advs_written = 0;
+    for (num_of_advs_t i = 0; i < num_of_advs; ++i)
+    {
+        http_cbor_put_adv(p_wr, p_params, &p_arr_of_advs[i]);
+        num_of_advs_written += 1;
+    }
+    return num_of_advs_written;
+}
+
+/**
+ * @brief Encode the array of advs to CBOR.
+ * @note The encoding is done in two passes over the same array: the first pass only calculates the size,
+ *       so that the buffer is allocated exactly once, the second one writes the data.
+ *       The array must not be modified between the passes, otherwise the definite length of the map "tags"
+ *       would not match the number of encoded advs.
+ */
+static bool
+http_cbor_create_advs_internal(
+    const adv_report_t* const                   p_arr_of_advs,
+    const num_of_advs_t                         num_of_advs,
+    const http_cbor_create_advs_params_t* const p_params,
+    http_cbor_buf_t* const                      p_cbor_buf)
+{
+    p_cbor_buf->p_buf = NULL;
+    p_cbor_buf->len   = 0;
+
+    http_cbor_writer_t writer = {
+        .p_buf         = NULL,
+        .buf_size      = 0,
+        .len           = 0,
+        .flag_overflow = false,
+    };
+    (void)http_cbor_put_advs(&writer, p_arr_of_advs, num_of_advs, p_params);
+
+    writer.p_buf = os_malloc(writer.len);
+    if (NULL == writer.p_buf)
+    {
+        LOG_ERR("Can't allocate %u bytes", (printf_uint_t)writer.len);
+        return false;
+    }
+    writer.buf_size = writer.len;
+    writer.len      = 0;
+
+    const num_of_advs_t num_of_advs_written = http_cbor_put_advs(&writer, p_arr_of_advs, num_of_advs, p_params);
+    if (writer.flag_overflow || (writer.len != writer.buf_size) || (num_of_advs_written != num_of_advs))
+    {
+        LOG_ERR(
+            "CBOR encoding failed: len=%u, expected_len=%u, num_of_advs=%u, expected_num_of_advs=%u",
+            (printf_uint_t)writer.len,
+            (printf_uint_t)writer.buf_size,
+            (printf_uint_t)num_of_advs_written,
+            (printf_uint_t)num_of_advs);
+        os_free(writer.p_buf);
+        return false;
+    }
+
+    p_cbor_buf->p_buf = writer.p_buf;
+    p_cbor_buf->len   = writer.len;
+    return true;
+}
+
+bool
+http_cbor_create_advs(
+    const adv_report_table_t* const             p_reports,
+    const http_cbor_create_advs_params_t* const p_params,
+    http_cbor_buf_t* const                      p_cbor_buf)
+{
+    if (NULL == p_reports)
+    {
+        return http_cbor_create_advs_internal(NULL, 0, p_params, p_cbor_buf);
+    }
+    return http_cbor_create_advs_internal(p_reports->table, p_reports->num_of_advs, p_params, p_cbor_buf);
+}
+
+bool
+http_cbor_create_advs_from_snapshot(
+    const adv_table_snapshot_t* const           p_snapshot,
+    const http_cbor_create_advs_params_t* const p_params,
+    http_cbor_buf_t* const                      p_cbor_buf)
+{
+    const num_of_advs_t num_of_advs = adv_table_snapshot_get_num_of_advs(p_snapshot);
+    if (0 == num_of_advs)
+    {
+        return http_cbor_create_advs_internal(NULL, 0, p_params, p_cbor_buf);
+    }
+
+    // Each adv is read from the snapshot only once (under the adv_table mutex), so an adv which becomes
+    // unreadable while encoding can't make the number of encoded advs differ from the length of the map "tags".
+    adv_report_t* p_arr_of_advs = os_malloc(sizeof(*p_arr_of_advs) * num_of_advs);
+    if (NULL == p_arr_of_advs)
+    {
+        LOG_ERR("Can't allocate memory for %u advs", (printf_uint_t)num_of_advs);
+        p_cbor_buf->p_buf = NULL;
+        p_cbor_buf->len   = 0;
+        return false;
+    }
+    num_of_advs_t num_of_valid_advs = 0;
+    for (num_of_advs_t i = 0; i < num_of_advs; ++i)
+    {
+        if (adv_table_snapshot_get_adv(p_snapshot, i, &p_arr_of_advs[num_of_valid_advs]))
+        {
+            num_of_valid_advs += 1;
+        }
+    }
+    const bool res = http_cbor_create_advs_internal(p_arr_of_advs, num_of_valid_advs, p_params, p_cbor_buf);
+    os_free(p_arr_of_advs);
+    return res;
+}
+
+void
+http_cbor_buf_free(http_cbor_buf_t* const p_cbor_buf)
+{
+    if (NULL != p_cbor_buf->p_buf)
+    {
+        os_free(p_cbor_buf->p_buf);
+    }
+    p_cbor_buf->len = 0;
+}
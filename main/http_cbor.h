@@ -0,0 +1,104 @@
+/**
+ * @file http_cbor.h
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ * @brief Compact binary (CBOR, RFC 8949) encoding of advs for HTTP POST.
+ *
+ * The structure mirrors the json generated by http_json_create_stream_gen_advs with the following differences:
+ * - all maps have a definite length,
+ * - timestamps, counters, nonce and numeric fields are encoded as CBOR integers,
+ * - the raw data of advs is encoded as a CBOR byte string instead of a hex string,
+ * - decoded fields are not supported.
+ *
+ * {
+ *   "data": {
+ *     "coordinates": text,
+ *     "timestamp": uint,           // if flag_use_timestamps
+ *     "nonce": uint,               // if flag_use_nonce
+ *     "gw_mac": text,
+ *     "tags": {
+ *       "<MAC>": {
+ *         "rssi": int,
+ *         "timestamp" | "counter": uint,
+ *         "ble_phy": text,         // "1M", "2M" or "Coded"
+ *         "ble_chan": uint,
+ *         "ble_tx_power": int,     // if tx_power is valid
+ *         "data": bytes
+ *       }, ...
+ *     }
+ *   }
+ * }
+ */
+
+#ifndef RUUVI_GATEWAY_HTTP_CBOR_H
+#define RUUVI_GATEWAY_HTTP_CBOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include "adv_table.h"
+#include "mac_addr.h"
+#include "str_buf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_CBOR_CONTENT_TYPE "application/cbor"
+
+typedef struct http_cbor_create_advs_params_t
+{
+    const bool                     flag_use_timestamps;
+    const time_t                   cur_time;
+    const bool                     flag_use_nonce;
+    const uint32_t                 nonce;
+    const mac_address_str_t* const p_mac_addr;
+    const str_buf_t                coordinates_str_buf;
+} http_cbor_create_advs_params_t;
+
+typedef struct http_cbor_buf_t
+{
+    uint8_t* p_buf;
+    size_t   len;
+} http_cbor_buf_t;
+
+/**
+ * @brief Encode advs from adv_report_table_t to CBOR.
+ * @param p_reports - ptr to adv_report_table_t (NULL is interpreted as an empty list of advs)
+ * @param p_params - ptr to http_cbor_create_advs_params_t
+ * @param[out] p_cbor_buf - ptr to http_cbor_buf_t to store the allocated buffer with the encoded data
+ * @return true if successful, false if there is not enough memory or the encoding failed
+ */
+bool
+http_cbor_create_advs(
+    const adv_report_table_t* const             p_reports,
+    const http_cbor_create_advs_params_t* const p_params,
+    http_cbor_buf_t* const                      p_cbor_buf);
+
+/**
+ * @brief Encode advs from adv_table_snapshot_t to CBOR.
+ * @param p_snapshot - ptr to the snapshot (NULL is interpreted as an empty list of advs)
+ * @param p_params - ptr to http_cbor_create_advs_params_t
+ * @param[out] p_cbor_buf - ptr to http_cbor_buf_t to store the allocated buffer with the encoded data
+ * @return true if successful, false if there is not enough memory or the encoding failed
+ */
+bool
+http_cbor_create_advs_from_snapshot(
+    const adv_table_snapshot_t* const           p_snapshot,
+    const http_cbor_create_advs_params_t* const p_params,
+    http_cbor_buf_t* const                      p_cbor_buf);
+
+/**
+ * @brief Release the buffer allocated by http_cbor_create_advs*.
+ * @param p_cbor_buf - ptr to http_cbor_buf_t
+ */
+void
+http_cbor_buf_free(http_cbor_buf_t* const p_cbor_buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_HTTP_CBOR_H
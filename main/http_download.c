@@ -821,77 +821,91 @@ cb_on_http_download_json_data(
     return true;
 }
 
-http_server_download_info_t
-http_download_json(const http_download_param_with_auth_t* const p_params)
+/**
+ * @brief Check the HTTP response of the JSON download and take the error message from it if needed.
+ * @return false if the download failed (p_info->is_error is set).
+ */
+static bool
+http_download_json_check_resp(
+    const http_download_param_with_auth_t* const p_params,
+    const http_server_resp_t* const              p_resp,
+    http_server_download_info_t* const           p_info)
 {
-    http_server_download_info_t info = {
-        .is_error       = false,
-        .http_resp_code = HTTP_RESP_CODE_200,
-        .p_json_buf     = NULL,
-        .json_buf_size  = 0,
-    };
-    const TickType_t download_started_at_tick = xTaskGetTickCount();
-
-    const bool         flag_use_big_tls_buf = false;
-    http_server_resp_t resp                 = http_download_with_auth(
-        p_params,
-        &cb_on_http_download_json_data,
-        &info,
-        flag_use_big_tls_buf);
-    if (HTTP_RESP_CODE_200 != resp.http_resp_code)
+    if (HTTP_RESP_CODE_200 != p_resp->http_resp_code)
     {
-        info.is_error       = true;
-        info.http_resp_code = resp.http_resp_code;
+        p_info->is_error       = true;
+        p_info->http_resp_code = p_resp->http_resp_code;
 
         size_t            len    = 0;
-        const char* const p_json = (const char*)http_server_resp_get_content_ptr_if_in_memory(&resp, &len);
+        const char* const p_json = (const char*)http_server_resp_get_content_ptr_if_in_memory(p_resp, &len);
         if (NULL != p_json)
         {
-            if (NULL != info.p_json_buf)
+            if (NULL != p_info->p_json_buf)
             {
-                os_free(info.p_json_buf);
-                info.p_json_buf = NULL;
+                os_free(p_info->p_json_buf);
+                p_info->p_json_buf = NULL;
             }
             LOG_ERR(
                 "http_download failed for URL: %s, resp_code=%d, content: %.*s",
                 p_params->base.p_url,
-                resp.http_resp_code,
+                p_resp->http_resp_code,
                 (printf_int_t)len,
                 p_json);
             const str_buf_t str_buf = str_buf_printf_with_alloc("%.*s", (printf_int_t)len, p_json);
-            info.p_json_buf         = str_buf.buf;
+            p_info->p_json_buf      = str_buf.buf;
         }
         else
         {
-            LOG_ERR("Invalid content location: %d", (printf_int_t)resp.content_location);
+            LOG_ERR("Invalid content location: %d", (printf_int_t)p_resp->content_location);
             LOG_ERR(
                 "http_download failed for URL: %s, resp_code=%d, content: %s",
                 p_params->base.p_url,
-                resp.http_resp_code,
-                (NULL != info.p_json_buf) ? info.p_json_buf : "<NULL>");
+                p_resp->http_resp_code,
+                (NULL != p_info->p_json_buf) ? p_info->p_json_buf : "<NULL>");
         }
+        return false;
     }
-    else if (HTTP_RESP_CODE_200 != info.http_resp_code)
+    if (HTTP_RESP_CODE_200 != p_info->http_resp_code)
     {
-        if (NULL == info.p_json_buf)
+        if (NULL == p_info->p_json_buf)
         {
-            LOG_ERR("http_download failed, HTTP resp code %d", (printf_int_t)info.http_resp_code);
+            LOG_ERR("http_download failed, HTTP resp code %d", (printf_int_t)p_info->http_resp_code);
         }
         else
         {
-            LOG_ERR("http_download failed, HTTP resp code %d: %s", (printf_int_t)info.http_resp_code, info.p_json_buf);
+            LOG_ERR(
+                "http_download failed, HTTP resp code %d: %s",
+                (printf_int_t)p_info->http_resp_code,
+                p_info->p_json_buf);
         }
-        info.is_error = true;
+        p_info->is_error = true;
+        return false;
     }
-    else if (NULL == info.p_json_buf)
+    return true;
+}
+
+http_server_download_info_t
+http_download_json(const http_download_param_with_auth_t* const p_params)
+{
+    http_server_download_info_t info = {
+        .is_error       = false,
+        .http_resp_code = HTTP_RESP_CODE_200,
+        .p_json_buf     = NULL,
+        .json_buf_size  = 0,
+    };
+    const TickType_t download_started_at_tick = xTaskGetTickCount();
+
+    const bool         flag_use_big_tls_buf = false;
+    http_server_resp_t resp                 = http_download_with_auth(
+        p_params,
+        &cb_on_http_download_json_data,
+        &info,
+        flag_use_big_tls_buf);
+    if (http_download_json_check_resp(p_params, &resp, &info) && (NULL == info.p_json_buf))
     {
         LOG_ERR("http_download returned NULL buffer");
         info.is_error = true;
     }
-    else
-    {
-        // MISRA C:2012, 15.7 - All if...else if constructs shall be terminated with an else statement
-    }
     http_server_resp_free(&resp);
     if (info.is_error && (HTTP_RESP_CODE_200 == info.http_resp_code))
     {
@@ -902,6 +916,98 @@ http_download_json(const http_download_param_with_auth_t* const p_params)
     return info;
 }
 
+typedef struct http_download_json_stream_info_t
+{
+    http_server_download_info_t    info;
+    http_download_json_stream_cb_t p_cb_on_json_data;
+    void*                          p_user_data;
+    size_t                         json_len; //!< Number of bytes of the JSON passed to the callback
+} http_download_json_stream_info_t;
+
+static bool
+cb_on_http_download_json_stream_data(
+    const uint8_t* const   p_buf,
+    const size_t           buf_size,
+    const size_t           offset,
+    const size_t           content_length,
+    const http_resp_code_e http_resp_code,
+    const size_t           range_start,
+    void*                  p_user_data)
+{
+    http_download_json_stream_info_t* const p_stream_info = p_user_data;
+    if (HTTP_RESP_CODE_200 != http_resp_code)
+    {
+        // Redirects and errors are handled the same way as in http_download_json,
+        // the body of the error response is buffered to report it.
+        return cb_on_http_download_json_data(
+            p_buf,
+            buf_size,
+            offset,
+            content_length,
+            http_resp_code,
+            range_start,
+            &p_stream_info->info);
+    }
+    LOG_DBG("%s: offset=%lu, buf_size=%lu", __func__, (printf_ulong_t)offset, (printf_ulong_t)buf_size);
+    p_stream_info->info.http_resp_code = http_resp_code;
+    if ((0 != offset) && (offset != p_stream_info->json_len))
+    {
+        p_stream_info->info.is_error = true;
+        LOG_ERR(
+            "Unexpected offset while downloading json file: offset=%lu, expected=%lu",
+            (printf_ulong_t)offset,
+            (printf_ulong_t)p_stream_info->json_len);
+        return false;
+    }
+    p_stream_info->json_len = offset + buf_size;
+    p_stream_info->p_cb_on_json_data((const char*)p_buf, buf_size, offset, p_stream_info->p_user_data);
+    return true;
+}
+
+http_server_download_info_t
+http_download_json_stream(
+    const http_download_param_with_auth_t* const p_params,
+    http_download_json_stream_cb_t const         p_cb_on_json_data,
+    void* const                                  p_user_data)
+{
+    http_download_json_stream_info_t stream_info = {
+        .info = {
+            .is_error       = false,
+            .http_resp_code = HTTP_RESP_CODE_200,
+            .p_json_buf     = NULL,
+            .json_buf_size  = 0,
+        },
+        .p_cb_on_json_data = p_cb_on_json_data,
+        .p_user_data       = p_user_data,
+        .json_len          = 0,
+    };
+    const TickType_t download_started_at_tick = xTaskGetTickCount();
+
+    const bool         flag_use_big_tls_buf = false;
+    http_server_resp_t resp                 = http_download_with_auth(
+        p_params,
+        &cb_on_http_download_json_stream_data,
+        &stream_info,
+        flag_use_big_tls_buf);
+    if (http_download_json_check_resp(p_params, &resp, &stream_info.info) && (0 == stream_info.json_len))
+    {
+        LOG_ERR("http_download returned empty content");
+        stream_info.info.is_error = true;
+    }
+    http_server_resp_free(&resp);
+    if (stream_info.info.is_error && (HTTP_RESP_CODE_200 == stream_info.info.http_resp_code))
+    {
+        stream_info.info.http_resp_code = HTTP_RESP_CODE_400;
+    }
+    const TickType_t download_completed_within_ticks = xTaskGetTickCount() - download_started_at_tick;
+    LOG_INFO(
+        "%s: completed within %u ticks, received %lu bytes",
+        __func__,
+        (printf_uint_t)download_completed_within_ticks,
+        (printf_ulong_t)stream_info.json_len);
+    return stream_info.info;
+}
+
 http_server_download_info_t
 http_download_firmware_update_info(const char* const p_url, const bool flag_free_memory)
 {
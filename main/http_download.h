@@ -37,6 +37,16 @@ typedef bool (*http_download_cb_on_data_t)(
     const size_t           range_start,    //!< Start of the range for the download
     void*                  p_user_data /*!< Pointer to user-defined data */);
 
+/**
+ * @brief Callback which receives the body of a successful (HTTP 200) response chunk by chunk.
+ * @note The offset 0 means that the download was restarted, so the previously received data must be discarded.
+ */
+typedef void (*http_download_json_stream_cb_t)(
+    const char* const p_buf,    //!< Buffer containing the next chunk of the JSON
+    const size_t      buf_size, //!< Size of the chunk
+    const size_t      offset,   //!< Offset of the chunk from the beginning of the JSON
+    void* const       p_user_data /*!< Pointer to user-defined data */);
+
 typedef struct http_download_param_t
 {
     const char*        p_url;       //!< URL to download from
@@ -86,6 +96,20 @@ http_download(
 http_server_download_info_t
 http_download_json(const http_download_param_with_auth_t* const p_params);
 
+/**
+ * @brief Download a JSON file and pass it to the callback chunk by chunk instead of buffering the whole file.
+ * @param p_params - ptr to @c http_download_param_with_auth_t with URL, connection and authentication parameters, etc.
+ * @param p_cb_on_json_data - ptr to a callback function that will be called for each chunk of the JSON
+ * @param p_user_data - ptr to user data that will be passed to the callback function
+ * @return @c http_server_download_info_t, on success p_json_buf is NULL,
+ *         on error p_json_buf contains the error message from the server (if any).
+ */
+http_server_download_info_t
+http_download_json_stream(
+    const http_download_param_with_auth_t* const p_params,
+    http_download_json_stream_cb_t const         p_cb_on_json_data,
+    void* const                                  p_user_data);
+
 http_server_download_info_t
 http_download_firmware_update_info(const char* const p_url, const bool flag_free_memory);
 
@@ -0,0 +1,429 @@
+/**
+ * @file http_gzip.c
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_gzip.h"
+#include <string.h>
+#include "os_malloc.h"
+
+#define HTTP_GZIP_WINDOW_MASK (HTTP_GZIP_WINDOW_SIZE - 1U)
+#define HTTP_GZIP_BUF_SIZE    (2U * HTTP_GZIP_WINDOW_SIZE)
+#define HTTP_GZIP_MAX_DIST    (HTTP_GZIP_WINDOW_SIZE - 1U)
+
+#define HTTP_GZIP_HASH_BITS      (9U)
+#define HTTP_GZIP_HASH_SIZE      (1U << HTTP_GZIP_HASH_BITS)
+#define HTTP_GZIP_HASH_MULT      (2654435761U)
+#define HTTP_GZIP_MAX_CHAIN_LEN  (16U)
+#define HTTP_GZIP_NICE_MATCH_LEN (64U)
+
+#define HTTP_GZIP_MIN_MATCH (3U)
+#define HTTP_GZIP_MAX_MATCH (258U)
+
+#define HTTP_GZIP_OUT_BUF_SIZE (256U)
+
+#define HTTP_GZIP_SYM_END_OF_BLOCK (256U)
+#define HTTP_GZIP_SYM_FIRST_LEN    (257U)
+#define HTTP_GZIP_NUM_LEN_CODES    (29U)
+#define HTTP_GZIP_NUM_DIST_CODES   (30U)
+#define HTTP_GZIP_DIST_CODE_BITS   (5U)
+
+#define HTTP_GZIP_BLOCK_FINAL       (1U)
+#define HTTP_GZIP_BLOCK_TYPE_FIXED  (1U)
+#define HTTP_GZIP_BLOCK_HEADER_BITS (3U)
+
+#define HTTP_GZIP_CRC32_INIT        (0xFFFFFFFFU)
+#define HTTP_GZIP_CRC32_NIBBLE      (4U)
+#define HTTP_GZIP_CRC32_NIBBLE_MASK (0x0FU)
+
+#define BYTE_MASK     (0xFFU)
+#define BITS_PER_BYTE (8U)
+
+struct http_gzip_t
+{
+    http_gzip_cb_on_output_t p_cb_on_output;
+    void*                    p_user_data;
+    bool                     flag_error;
+    uint32_t                 crc32;
+    uint32_t                 input_size;
+    uint32_t                 bit_buf;
+    uint32_t                 bit_cnt;
+    uint32_t                 out_len;
+    uint32_t                 win_len;                          //<! Number of bytes in win
+    uint32_t                 pos;                              //<! Position of the next byte to encode in win
+    uint16_t                 hash_head[HTTP_GZIP_HASH_SIZE];   //<! Last position in win + 1 for the hash (0 - none)
+    uint16_t                 hash_prev[HTTP_GZIP_WINDOW_SIZE]; //<! Previous position + 1 with the same hash
+    uint8_t                  win[HTTP_GZIP_BUF_SIZE];
+    uint8_t                  out_buf[HTTP_GZIP_OUT_BUF_SIZE];
+};
+
+static const uint16_t g_http_gzip_len_base[HTTP_GZIP_NUM_LEN_CODES] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+
+static const uint8_t g_http_gzip_len_extra_bits[HTTP_GZIP_NUM_LEN_CODES] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+
+static const uint16_t g_http_gzip_dist_base[HTTP_GZIP_NUM_DIST_CODES] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+
+static const uint8_t g_http_gzip_dist_extra_bits[HTTP_GZIP_NUM_DIST_CODES] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+static const uint8_t g_http_gzip_header[] = {
+    0x1FU, 0x8BU,               // ID1, ID2
+    0x08U,                      // CM = deflate
+    0x00U,                      // FLG
+    0x00U, 0x00U, 0x00U, 0x00U, // MTIME is not available
+    0x00U,                      // XFL
+    0xFFU,                      // OS = unknown
+};
+
+static uint32_t
+http_gzip_crc32_update(uint32_t crc, const uint8_t* const p_data, const size_t len)
+{
+    // Nibble-wise table: 64 bytes of flash instead of 1 KiB for the byte-wise table.
+    static const uint32_t g_crc32_nibble_table[16] = {
+        0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+        0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+    };
+    for (size_t i = 0; i < len; ++i)
+    {
+        crc ^= p_data[i];
+        crc = (crc >> HTTP_GZIP_CRC32_NIBBLE) ^ g_crc32_nibble_table[crc & HTTP_GZIP_CRC32_NIBBLE_MASK];
+        crc = (crc >> HTTP_GZIP_CRC32_NIBBLE) ^ g_crc32_nibble_table[crc & HTTP_GZIP_CRC32_NIBBLE_MASK];
+    }
+    return crc;
+}
+
+static void
+http_gzip_flush_out_buf(http_gzip_t* const p_gzip)
+{
+    if ((0 != p_gzip->out_len) && (!p_gzip->flag_error))
+    {
+        if (!p_gzip->p_cb_on_output(p_gzip->p_user_data, (const char*)p_gzip->out_buf, p_gzip->out_len))
+        {
+            p_gzip->flag_error = true;
+        }
+    }
+    p_gzip->out_len = 0;
+}
+
+static void
+http_gzip_put_byte(http_gzip_t* const p_gzip, const uint8_t byte)
+{
+    p_gzip->out_buf[p_gzip->out_len] = byte;
+    p_gzip->out_len += 1;
+    if (p_gzip->out_len == HTTP_GZIP_OUT_BUF_SIZE)
+    {
+        http_gzip_flush_out_buf(p_gzip);
+    }
+}
+
+static void
+http_gzip_put_u32_le(http_gzip_t* const p_gzip, const uint32_t val)
+{
+    for (uint32_t i = 0; i < sizeof(val); ++i)
+    {
+        http_gzip_put_byte(p_gzip, (uint8_t)((val >> (i * BITS_PER_BYTE)) & BYTE_MASK));
+    }
+}
+
+/**
+ * @brief Put bits to the output stream, deflate packs them starting from the least significant bit.
+ */
+static void
+http_gzip_put_bits(http_gzip_t* const p_gzip, const uint32_t val, const uint32_t num_bits)
+{
+    p_gzip->bit_buf |= val << p_gzip->bit_cnt;
+    p_gzip->bit_cnt += num_bits;
+    while (p_gzip->bit_cnt >= BITS_PER_BYTE)
+    {
+        http_gzip_put_byte(p_gzip, (uint8_t)(p_gzip->bit_buf & BYTE_MASK));
+        p_gzip->bit_buf >>= BITS_PER_BYTE;
+        p_gzip->bit_cnt -= BITS_PER_BYTE;
+    }
+}
+
+/**
+ * @brief Put Huffman code, unlike other data elements the Huffman codes are packed starting from the MSB.
+ */
+static void
+http_gzip_put_huffman_code(http_gzip_t* const p_gzip, const uint32_t code, const uint32_t num_bits)
+{
+    uint32_t reversed_code = 0;
+    for (uint32_t i = 0; i < num_bits; ++i)
+    {
+        reversed_code |= ((code >> i) & 1U) << (num_bits - 1U - i);
+    }
+    http_gzip_put_bits(p_gzip, reversed_code, num_bits);
+}
+
+/**
+ * @brief Put literal/length symbol using the fixed Huffman code (RFC 1951, 3.2.6).
+ */
+static void
+http_gzip_put_lit_len_sym(http_gzip_t* const p_gzip, const uint32_t sym)
+{
+    if (sym <= 143U)
+    {
+        http_gzip_put_huffman_code(p_gzip, 0x30U + sym, 8U);
+    }
+    else if (sym <= 255U)
+    {
+        http_gzip_put_huffman_code(p_gzip, 0x190U + (sym - 144U), 9U);
+    }
+    else if (sym <= 279U)
+    {
+        http_gzip_put_huffman_code(p_gzip, sym - 256U, 7U);
+    }
+    else
+    {
+        http_gzip_put_huffman_code(p_gzip, 0xC0U + (sym - 280U), 8U);
+    }
+}
+
+static void
+http_gzip_put_match(http_gzip_t* const p_gzip, const uint32_t len, const uint32_t dist)
+{
+    uint32_t len_code = HTTP_GZIP_NUM_LEN_CODES - 1U;
+    while (g_http_gzip_len_base[len_code] > len)
+    {
+        len_code -= 1;
+    }
+    http_gzip_put_lit_len_sym(p_gzip, HTTP_GZIP_SYM_FIRST_LEN + len_code);
+    http_gzip_put_bits(p_gzip, len - g_http_gzip_len_base[len_code], g_http_gzip_len_extra_bits[len_code]);
+
+    uint32_t dist_code = HTTP_GZIP_NUM_DIST_CODES - 1U;
+    while (g_http_gzip_dist_base[dist_code] > dist)
+    {
+        dist_code -= 1;
+    }
+    http_gzip_put_huffman_code(p_gzip, dist_code, HTTP_GZIP_DIST_CODE_BITS);
+    http_gzip_put_bits(p_gzip, dist - g_http_gzip_dist_base[dist_code], g_http_gzip_dist_extra_bits[dist_code]);
+}
+
+static uint32_t
+http_gzip_calc_hash(const uint8_t* const p_data)
+{
+    const uint32_t val = ((uint32_t)p_data[0] << (2U * BITS_PER_BYTE)) | ((uint32_t)p_data[1] << BITS_PER_BYTE)
+                         | (uint32_t)p_data[2];
+    return (val * HTTP_GZIP_HASH_MULT) >> (32U - HTTP_GZIP_HASH_BITS);
+}
+
+static void
+http_gzip_insert_hash(http_gzip_t* const p_gzip, const uint32_t pos)
+{
+    if ((pos + HTTP_GZIP_MIN_MATCH) > p_gzip->win_len)
+    {
+        return;
+    }
+    const uint32_t hash                            = http_gzip_calc_hash(&p_gzip->win[pos]);
+    p_gzip->hash_prev[pos & HTTP_GZIP_WINDOW_MASK] = p_gzip->hash_head[hash];
+    p_gzip->hash_head[hash]                        = (uint16_t)(pos + 1U);
+}
+
+static uint32_t
+http_gzip_find_longest_match(const http_gzip_t* const p_gzip, uint32_t* const p_dist)
+{
+    const uint32_t pos       = p_gzip->pos;
+    const uint32_t avail     = p_gzip->win_len - pos;
+    const uint32_t max_len   = (avail < HTTP_GZIP_MAX_MATCH) ? avail : HTTP_GZIP_MAX_MATCH;
+    uint32_t       best_len  = 0;
+    uint32_t       cand      = p_gzip->hash_head[http_gzip_calc_hash(&p_gzip->win[pos])];
+    uint32_t       chain_len = HTTP_GZIP_MAX_CHAIN_LEN;
+    while ((0 != cand) && (0 != chain_len))
+    {
+        const uint32_t cand_pos = cand - 1U;
+        if ((cand_pos >= pos) || ((pos - cand_pos) > HTTP_GZIP_MAX_DIST))
+        {
+            break;
+        }
+        uint32_t len = 0;
+        while ((len < max_len) && (p_gzip->win[cand_pos + len] == p_gzip->win[pos + len]))
+        {
+            len += 1;
+        }
+        if (len > best_len)
+        {
+            best_len = len;
+            *p_dist  = pos - cand_pos;
+            if (len >= HTTP_GZIP_NICE_MATCH_LEN)
+            {
+                break;
+            }
+        }
+        const uint32_t next_cand = p_gzip->hash_prev[cand_pos & HTTP_GZIP_WINDOW_MASK];
+        if (next_cand >= cand)
+        {
+            // The entry was overwritten by a newer position, so the rest of the chain is outside the window.
+            break;
+        }
+        cand = next_cand;
+        chain_len -= 1;
+    }
+    return best_len;
+}
+
+static void
+http_gzip_encode(http_gzip_t* const p_gzip, const bool flag_finish)
+{
+    while (p_gzip->pos < p_gzip->win_len)
+    {
+        const uint32_t avail = p_gzip->win_len - p_gzip->pos;
+        if ((!flag_finish) && (avail < HTTP_GZIP_MAX_MATCH))
+        {
+            // Wait for more data to be able to find the longest match.
+            break;
+        }
+        uint32_t match_len  = 0;
+        uint32_t match_dist = 0;
+        if (avail >= HTTP_GZIP_MIN_MATCH)
+        {
+            match_len = http_gzip_find_longest_match(p_gzip, &match_dist);
+        }
+        if (match_len >= HTTP_GZIP_MIN_MATCH)
+        {
+            http_gzip_put_match(p_gzip, match_len, match_dist);
+            for (uint32_t i = 0; i < match_len; ++i)
+            {
+                http_gzip_insert_hash(p_gzip, p_gzip->pos);
+                p_gzip->pos += 1;
+            }
+        }
+        else
+        {
+            http_gzip_put_lit_len_sym(p_gzip, p_gzip->win[p_gzip->pos]);
+            http_gzip_insert_hash(p_gzip, p_gzip->pos);
+            p_gzip->pos += 1;
+        }
+    }
+}
+
+static uint16_t
+http_gzip_slide_hash_entry(const uint16_t entry)
+{
+    return (entry > HTTP_GZIP_WINDOW_SIZE) ? (uint16_t)(entry - HTTP_GZIP_WINDOW_SIZE) : 0U;
+}
+
+static void
+http_gzip_slide_window(http_gzip_t* const p_gzip)
+{
+    // The encoder keeps at most HTTP_GZIP_MAX_MATCH bytes of lookahead, so pos >= HTTP_GZIP_WINDOW_SIZE here.
+    memmove(&p_gzip->win[0], &p_gzip->win[HTTP_GZIP_WINDOW_SIZE], p_gzip->win_len - HTTP_GZIP_WINDOW_SIZE);
+    p_gzip->win_len -= HTTP_GZIP_WINDOW_SIZE;
+    p_gzip->pos -= HTTP_GZIP_WINDOW_SIZE;
+    for (uint32_t i = 0; i < HTTP_GZIP_HASH_SIZE; ++i)
+    {
+        p_gzip->hash_head[i] = http_gzip_slide_hash_entry(p_gzip->hash_head[i]);
+    }
+    for (uint32_t i = 0; i < HTTP_GZIP_WINDOW_SIZE; ++i)
+    {
+        p_gzip->hash_prev[i] = http_gzip_slide_hash_entry(p_gzip->hash_prev[i]);
+    }
+}
+
+http_gzip_t*
+http_gzip_create(http_gzip_cb_on_output_t const p_cb_on_output, void* const p_user_data)
+{
+    http_gzip_t* const p_gzip = os_calloc(1, sizeof(*p_gzip));
+    if (NULL == p_gzip)
+    {
+        return NULL;
+    }
+    p_gzip->p_cb_on_output = p_cb_on_output;
+    p_gzip->p_user_data    = p_user_data;
+    p_gzip->crc32          = HTTP_GZIP_CRC32_INIT;
+
+    for (uint32_t i = 0; i < sizeof(g_http_gzip_header); ++i)
+    {
+        http_gzip_put_byte(p_gzip, g_http_gzip_header[i]);
+    }
+    // The whole body is encoded as a single final block with the fixed Huffman codes,
+    // so the block header can be written before the length of the data is known.
+    http_gzip_put_bits(
+        p_gzip,
+        HTTP_GZIP_BLOCK_FINAL | (HTTP_GZIP_BLOCK_TYPE_FIXED << 1U),
+        HTTP_GZIP_BLOCK_HEADER_BITS);
+    return p_gzip;
+}
+
+void
+http_gzip_delete(http_gzip_t** const p_p_gzip)
+{
+    if (NULL != *p_p_gzip)
+    {
+        os_free(*p_p_gzip);
+    }
+}
+
+bool
+http_gzip_write(http_gzip_t* const p_gzip, const uint8_t* const p_data, const size_t len)
+{
+    p_gzip->crc32 = http_gzip_crc32_update(p_gzip->crc32, p_data, len);
+    p_gzip->input_size += (uint32_t)len;
+
+    size_t offset = 0;
+    while ((offset < len) && (!p_gzip->flag_error))
+    {
+        if (p_gzip->win_len == HTTP_GZIP_BUF_SIZE)
+        {
+            http_gzip_slide_window(p_gzip);
+        }
+        const size_t free_space = HTTP_GZIP_BUF_SIZE - p_gzip->win_len;
+        const size_t chunk_len  = ((len - offset) < free_space) ? (len - offset) : free_space;
+        memcpy(&p_gzip->win[p_gzip->win_len], &p_data[offset], chunk_len);
+        p_gzip->win_len += (uint32_t)chunk_len;
+        offset += chunk_len;
+        http_gzip_encode(p_gzip, false);
+    }
+    return !p_gzip->flag_error;
+}
+
+bool
+http_gzip_finish(http_gzip_t* const p_gzip)
+{
+    http_gzip_encode(p_gzip, true);
+    http_gzip_put_lit_len_sym(p_gzip, HTTP_GZIP_SYM_END_OF_BLOCK);
+    if (0 != p_gzip->bit_cnt)
+    {
+        http_gzip_put_bits(p_gzip, 0, BITS_PER_BYTE - p_gzip->bit_cnt);
+    }
+    http_gzip_put_u32_le(p_gzip, p_gzip->crc32 ^ HTTP_GZIP_CRC32_INIT);
+    http_gzip_put_u32_le(p_gzip, p_gzip->input_size);
+    http_gzip_flush_out_buf(p_gzip);
+    return !p_gzip->flag_error;
+}
+
+bool
+http_gzip_cb_on_chunk(void* const p_user_data, const char* const p_chunk, const size_t len)
+{
+    return http_gzip_write((http_gzip_t*)p_user_data, (const uint8_t*)p_chunk, len);
+}
+
+bool
+http_gzip_compress_buf(
+    const uint8_t* const           p_data,
+    const size_t                   len,
+    http_gzip_cb_on_output_t const p_cb_on_output,
+    void* const                    p_user_data)
+{
+    http_gzip_t* p_gzip = http_gzip_create(p_cb_on_output, p_user_data);
+    if (NULL == p_gzip)
+    {
+        return false;
+    }
+    bool res = http_gzip_write(p_gzip, p_data, len);
+    if (res)
+    {
+        res = http_gzip_finish(p_gzip);
+    }
+    http_gzip_delete(&p_gzip);
+    return res;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file http_gzip.h
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ * @brief Streaming gzip (RFC 1952) encoder for the body of HTTP POST requests.
+ *
+ * The encoder uses LZ77 with a small fixed window (HTTP_GZIP_WINDOW_SIZE) and the fixed Huffman codes of deflate
+ * (RFC 1951, BTYPE=01), so it needs about 5 KiB of RAM and no dynamic allocations except the encoder itself.
+ * The output is deterministic: the same input always produces the same compressed data.
+ */
+
+#ifndef RUUVI_GATEWAY_HTTP_GZIP_H
+#define RUUVI_GATEWAY_HTTP_GZIP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(HTTP_GZIP_RUUVI)
+/**
+ * @brief Compress HTTP POST with advs to the Ruuvi cloud, configured by RUUVI_HTTP_GZIP_RUUVI in CMakeLists.txt.
+ */
+#define HTTP_GZIP_RUUVI (0)
+#endif
+
+#if !defined(HTTP_GZIP_CUSTOM)
+/**
+ * @brief Compress HTTP POST with advs to the custom HTTP target, configured by RUUVI_HTTP_GZIP_CUSTOM.
+ */
+#define HTTP_GZIP_CUSTOM (0)
+#endif
+
+#if !defined(HTTP_GZIP_STATS)
+/**
+ * @brief Compress HTTP POST with statistics, configured by RUUVI_HTTP_GZIP_STATS.
+ */
+#define HTTP_GZIP_STATS (0)
+#endif
+
+#define HTTP_GZIP_CONTENT_ENCODING "gzip"
+
+#define HTTP_GZIP_WINDOW_SIZE (1024U)
+
+typedef struct http_gzip_t http_gzip_t;
+
+/**
+ * @brief Callback which is called for every block of the compressed data.
+ * @note The signature is compatible with hmac_sha256_cb_on_chunk_t and http_post_spool_cb_on_chunk.
+ * @param p_user_data - ptr to the user data
+ * @param p_buf - ptr to the compressed data
+ * @param len - length of the compressed data
+ * @return true to continue, false to abort the compression
+ */
+typedef bool (*http_gzip_cb_on_output_t)(void* const p_user_data, const char* const p_buf, const size_t len);
+
+/**
+ * @brief Create the gzip encoder.
+ * @param p_cb_on_output - ptr to the callback for the compressed data
+ * @param p_user_data - ptr to the user data for the callback
+ * @return ptr to http_gzip_t or NULL if there is not enough memory
+ */
+http_gzip_t*
+http_gzip_create(http_gzip_cb_on_output_t const p_cb_on_output, void* const p_user_data);
+
+/**
+ * @brief Delete the gzip encoder.
+ * @param p_p_gzip - ptr to the variable with ptr to http_gzip_t, it's set to NULL
+ */
+void
+http_gzip_delete(http_gzip_t** const p_p_gzip);
+
+/**
+ * @brief Compress the next part of the data.
+ * @param p_gzip - ptr to http_gzip_t
+ * @param p_data - ptr to the data
+ * @param len - length of the data
+ * @return false if the output callback has aborted the compression
+ */
+bool
+http_gzip_write(http_gzip_t* const p_gzip, const uint8_t* const p_data, const size_t len);
+
+/**
+ * @brief Compress the remaining data and write the gzip trailer.
+ * @param p_gzip - ptr to http_gzip_t
+ * @return false if the output callback has aborted the compression
+ */
+bool
+http_gzip_finish(http_gzip_t* const p_gzip);
+
+/**
+ * @brief Callback for hmac_sha256_calc_for_json_gen_http_*_with_cb which compresses every chunk of json.
+ * @param p_user_data - ptr to http_gzip_t
+ * @param p_chunk - ptr to the chunk
+ * @param len - length of the chunk
+ * @return false if the output callback has aborted the compression
+ */
+bool
+http_gzip_cb_on_chunk(void* const p_user_data, const char* const p_chunk, const size_t len);
+
+/**
+ * @brief Compress the buffer in one go.
+ * @param p_data - ptr to the data
+ * @param len - length of the data
+ * @param p_cb_on_output - ptr to the callback for the compressed data
+ * @param p_user_data - ptr to the user data for the callback
+ * @return true if successful, false if there is not enough memory or the compression was aborted
+ */
+bool
+http_gzip_compress_buf(
+    const uint8_t* const           p_data,
+    const size_t                   len,
+    http_gzip_cb_on_output_t const p_cb_on_output,
+    void* const                    p_user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_HTTP_GZIP_H
@@ -39,15 +39,18 @@ http_json_free(void* ptr)
 
 typedef struct http_json_stream_gen_advs_ctx_t
 {
-    bool                       flag_raw_data;
-    bool                       flag_decode;
-    bool                       flag_use_timestamps;
-    bool                       flag_use_nonce;
-    time_t                     timestamp;
-    uint32_t                   nonce;
-    mac_address_str_t          gw_mac;
-    ruuvi_gw_cfg_coordinates_t coordinates;
-    adv_report_table_t         reports;
+    bool                        flag_raw_data;
+    bool                        flag_decode;
+    bool                        flag_use_timestamps;
+    bool                        flag_use_nonce;
+    time_t                      timestamp;
+    uint32_t                    nonce;
+    mac_address_str_t           gw_mac;
+    ruuvi_gw_cfg_coordinates_t  coordinates;
+    const adv_table_snapshot_t* p_snapshot; //<! The source of advs (if not NULL), it must outlive the generator
+    const adv_delta_t*          p_adv_delta; //<! Must not be modified while the generator is alive
+    num_of_advs_t               num_of_advs;
+    adv_report_t                table[]; //<! A copy of advs (if the generator was created from adv_report_table_t)
 } http_json_stream_gen_advs_ctx_t;
 
 static bool
@@ -328,14 +331,69 @@ http_json_create_status_str(
     return true;
 }
 
+static JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
+    cb_json_stream_gen_adv_sample,
+    json_stream_gen_t* const                     p_gen,
+    const http_json_stream_gen_advs_ctx_t* const p_ctx,
+    const adv_report_t* const                    p_sample)
+{
+    JSON_STREAM_GEN_START_OBJECT(p_gen, NULL);
+    if (p_ctx->flag_use_timestamps)
+    {
+        JSON_STREAM_GEN_ADD_UINT32(p_gen, "timestamp", p_sample->timestamp);
+    }
+    else
+    {
+        JSON_STREAM_GEN_ADD_UINT32(p_gen, "counter", p_sample->timestamp);
+    }
+    JSON_STREAM_GEN_ADD_INT32(p_gen, "rssi", p_sample->rssi);
+    if (p_ctx->flag_raw_data)
+    {
+        JSON_STREAM_GEN_ADD_HEX_BUF(p_gen, "data", p_sample->data_buf, p_sample->data_len);
+    }
+    if (p_ctx->flag_decode)
+    {
+        // The samples are always encoded in full, the delta encoding is applied only to the latest measurement.
+        if (re_5_check_format(p_sample->data_buf))
+        {
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_df5_cb_json_stream_gen, p_gen, p_sample, NULL);
+        }
+        if (re_6_check_format(p_sample->data_buf))
+        {
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_df6_cb_json_stream_gen, p_gen, p_sample, NULL);
+        }
+        if (re_f0_check_format(p_sample->data_buf))
+        {
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_dfxf0_cb_json_stream_gen, p_gen, p_sample);
+        }
+        if (re_e0_check_format(p_sample->data_buf))
+        {
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_dfxe0_cb_json_stream_gen, p_gen, p_sample);
+        }
+        if (re_e1_check_format(p_sample->data_buf))
+        {
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_dfxe1_cb_json_stream_gen, p_gen, p_sample, NULL);
+        }
+    }
+    JSON_STREAM_GEN_END_OBJECT(p_gen);
+    JSON_STREAM_GEN_END_GENERATOR_SUB_FUNC();
+}
+
 static JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
     cb_json_stream_gen_adv,
     json_stream_gen_t* const                     p_gen,
     const http_json_stream_gen_advs_ctx_t* const p_ctx,
-    const adv_report_t* const                    p_adv)
+    const adv_report_t* const                    p_adv,
+    const num_of_advs_t                          idx)
 {
 
-    const mac_address_str_t mac_str = mac_address_to_str(&p_adv->tag_mac);
+    const mac_address_str_t mac_str    = mac_address_to_str(&p_adv->tag_mac);
+    adv_report_t            adv_prev   = { 0 };
+    const adv_report_t*     p_adv_prev = NULL;
+    if ((NULL != p_ctx->p_adv_delta) && adv_delta_get_prev(p_ctx->p_adv_delta, &p_adv->tag_mac, &adv_prev))
+    {
+        p_adv_prev = &adv_prev;
+    }
     JSON_STREAM_GEN_START_OBJECT(p_gen, mac_str.str_buf);
     JSON_STREAM_GEN_ADD_INT32(p_gen, "rssi", p_adv->rssi);
 
@@ -374,11 +432,11 @@ static JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
     {
         if (re_5_check_format(p_adv->data_buf))
         {
-            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_df5_cb_json_stream_gen, p_gen, p_adv);
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_df5_cb_json_stream_gen, p_gen, p_adv, p_adv_prev);
         }
         if (re_6_check_format(p_adv->data_buf))
         {
-            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_df6_cb_json_stream_gen, p_gen, p_adv);
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_df6_cb_json_stream_gen, p_gen, p_adv, p_adv_prev);
         }
         if (re_f0_check_format(p_adv->data_buf))
         {
@@ -390,9 +448,25 @@ static JSON_STREAM_GEN_DECL_GENERATOR_SUB_FUNC(
         }
         if (re_e1_check_format(p_adv->data_buf))
         {
-            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_dfxe1_cb_json_stream_gen, p_gen, p_adv);
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_dfxe1_cb_json_stream_gen, p_gen, p_adv, p_adv_prev);
         }
     }
+    const num_of_advs_t num_of_samples = (NULL != p_ctx->p_snapshot)
+                                             ? adv_table_snapshot_get_num_of_samples(p_ctx->p_snapshot, idx)
+                                             : 0;
+    if (0 != num_of_samples)
+    {
+        JSON_STREAM_GEN_START_ARRAY(p_gen, "samples");
+        for (num_of_advs_t sample_idx = 0; sample_idx < num_of_samples; ++sample_idx)
+        {
+            adv_report_t sample = { 0 };
+            if (adv_table_snapshot_get_sample(p_ctx->p_snapshot, idx, sample_idx, &sample))
+            {
+                JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(cb_json_stream_gen_adv_sample, p_gen, p_ctx, &sample);
+            }
+        }
+        JSON_STREAM_GEN_END_ARRAY(p_gen);
+    }
     JSON_STREAM_GEN_END_OBJECT(p_gen);
     JSON_STREAM_GEN_END_GENERATOR_SUB_FUNC();
 }
@@ -416,9 +490,21 @@ cb_json_stream_gen_advs(json_stream_gen_t* const p_gen, const void* const p_user
 
     JSON_STREAM_GEN_START_OBJECT(p_gen, "tags");
 
-    for (num_of_advs_t i = 0; i < p_ctx->reports.num_of_advs; ++i)
+    for (num_of_advs_t i = 0; i < p_ctx->num_of_advs; ++i)
     {
-        JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(cb_json_stream_gen_adv, p_gen, p_ctx, &p_ctx->reports.table[i]);
+        if (NULL == p_ctx->p_snapshot)
+        {
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(cb_json_stream_gen_adv, p_gen, p_ctx, &p_ctx->table[i], i);
+        }
+        else
+        {
+            // The content seen through the snapshot is immutable, so it's safe to re-read it on every pass.
+            adv_report_t adv = { 0 };
+            if (adv_table_snapshot_get_adv(p_ctx->p_snapshot, i, &adv))
+            {
+                JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(cb_json_stream_gen_adv, p_gen, p_ctx, &adv, i);
+            }
+        }
     }
 
     JSON_STREAM_GEN_END_OBJECT(p_gen);
@@ -426,23 +512,25 @@ cb_json_stream_gen_advs(json_stream_gen_t* const p_gen, const void* const p_user
     JSON_STREAM_GEN_END_GENERATOR_FUNC();
 }
 
-json_stream_gen_t*
-http_json_create_stream_gen_advs(
-    const adv_report_table_t* const                        p_reports,
-    const http_json_create_stream_gen_advs_params_t* const p_params)
+static json_stream_gen_t*
+http_json_create_stream_gen_advs_internal(
+    const http_json_create_stream_gen_advs_params_t* const p_params,
+    const num_of_advs_t                                    num_of_advs_to_copy,
+    http_json_stream_gen_advs_ctx_t** const                p_p_ctx)
 {
     const json_stream_gen_cfg_t cfg = {
         .max_chunk_size      = 768U,
-        .flag_formatted_json = true,
+        .flag_formatted_json = (0 != HTTP_JSON_FORMATTED),
         .indentation_mark    = ' ',
         .indentation         = 2,
-        .max_nesting_level   = 4,
+        .max_nesting_level   = 6, // root, data, tags, tag, samples, sample
         .p_malloc            = &http_json_malloc,
         .p_free              = &http_json_free,
         .p_localeconv        = NULL,
     };
-    http_json_stream_gen_advs_ctx_t* p_ctx = NULL;
-    json_stream_gen_t* p_gen = json_stream_gen_create(&cfg, &cb_json_stream_gen_advs, sizeof(*p_ctx), (void**)&p_ctx);
+    http_json_stream_gen_advs_ctx_t* p_ctx    = NULL;
+    const size_t                     ctx_size = sizeof(*p_ctx) + (num_of_advs_to_copy * sizeof(p_ctx->table[0]));
+    json_stream_gen_t* p_gen = json_stream_gen_create(&cfg, &cb_json_stream_gen_advs, ctx_size, (void**)&p_ctx);
     if (NULL == p_gen)
     {
         LOG_ERR("Not enough memory");
@@ -456,13 +544,45 @@ http_json_create_stream_gen_advs(
     p_ctx->nonce               = p_params->nonce;
     p_ctx->gw_mac              = *p_params->p_mac_addr;
     snprintf(p_ctx->coordinates.buf, sizeof(p_ctx->coordinates), "%s", p_params->coordinates_str_buf.buf);
-    if (NULL == p_reports)
+    p_ctx->p_snapshot  = NULL;
+    p_ctx->p_adv_delta = p_params->p_adv_delta;
+    p_ctx->num_of_advs = 0;
+    *p_p_ctx           = p_ctx;
+    return p_gen;
+}
+
+json_stream_gen_t*
+http_json_create_stream_gen_advs(
+    const adv_report_table_t* const                        p_reports,
+    const http_json_create_stream_gen_advs_params_t* const p_params)
+{
+    const num_of_advs_t              num_of_advs = (NULL != p_reports) ? p_reports->num_of_advs : 0;
+    http_json_stream_gen_advs_ctx_t* p_ctx       = NULL;
+    json_stream_gen_t* const p_gen = http_json_create_stream_gen_advs_internal(p_params, num_of_advs, &p_ctx);
+    if (NULL == p_gen)
     {
-        p_ctx->reports.num_of_advs = 0;
+        return NULL;
     }
-    else
+    if (0 != num_of_advs)
+    {
+        memcpy(p_ctx->table, p_reports->table, num_of_advs * sizeof(p_ctx->table[0]));
+    }
+    p_ctx->num_of_advs = num_of_advs;
+    return p_gen;
+}
+
+json_stream_gen_t*
+http_json_create_stream_gen_advs_from_snapshot(
+    const adv_table_snapshot_t* const                      p_snapshot,
+    const http_json_create_stream_gen_advs_params_t* const p_params)
+{
+    http_json_stream_gen_advs_ctx_t* p_ctx = NULL;
+    json_stream_gen_t* const         p_gen = http_json_create_stream_gen_advs_internal(p_params, 0, &p_ctx);
+    if (NULL == p_gen)
     {
-        memcpy(&p_ctx->reports, p_reports, sizeof(*p_reports));
+        return NULL;
     }
+    p_ctx->p_snapshot  = p_snapshot;
+    p_ctx->num_of_advs = adv_table_snapshot_get_num_of_advs(p_snapshot);
     return p_gen;
 }
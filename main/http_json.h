@@ -13,6 +13,7 @@
 #include "adv_table.h"
 #include "cjson_wrap.h"
 #include "nrf52fw.h"
+#include "adv_delta.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,6 +21,14 @@ extern "C" {
 
 #define HTTP_JSON_STATISTICS_RESET_REASON_MAX_LEN (24)
 
+#if !defined(HTTP_JSON_FORMATTED)
+/**
+ * @brief Generate human-readable (indented) json for HTTP POST with advs (1) or compact json without whitespaces (0).
+ * @note It's configured by RUUVI_HTTP_JSON_FORMATTED option in the top-level CMakeLists.txt.
+ */
+#define HTTP_JSON_FORMATTED (1)
+#endif
+
 typedef struct http_json_statistics_reset_reason_buf_t
 {
     char buf[HTTP_JSON_STATISTICS_RESET_REASON_MAX_LEN];
@@ -74,6 +83,7 @@ typedef struct http_json_create_stream_gen_advs_params_t
     const uint32_t                 nonce;
     const mac_address_str_t* const p_mac_addr;
     const str_buf_t                coordinates_str_buf;
+    const adv_delta_t* const       p_adv_delta; //<! Shadow for delta-encoded decoded data (NULL - always keyframes)
 } http_json_create_stream_gen_advs_params_t;
 
 json_stream_gen_t*
@@ -81,6 +91,19 @@ http_json_create_stream_gen_advs(
     const adv_report_table_t* const                        p_reports,
     const http_json_create_stream_gen_advs_params_t* const p_params);
 
+/**
+ * @brief Create json_stream_gen for advs which reads the content of the tags directly from adv_table.
+ * @note The generator does not take a reference to the snapshot,
+ *       so the caller must keep the snapshot alive until the generator is deleted.
+ * @param p_snapshot - ptr to the snapshot (NULL is interpreted as an empty list of advs)
+ * @param p_params - ptr to http_json_create_stream_gen_advs_params_t
+ * @return ptr to json_stream_gen_t or NULL if there is not enough memory
+ */
+json_stream_gen_t*
+http_json_create_stream_gen_advs_from_snapshot(
+    const adv_table_snapshot_t* const                      p_snapshot,
+    const http_json_create_stream_gen_advs_params_t* const p_params);
+
 #ifdef __cplusplus
 }
 #endif
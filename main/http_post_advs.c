@@ -15,10 +15,12 @@
 #include "gw_cfg_storage.h"
 #include "gw_cfg_default.h"
 #include "reset_task.h"
-#include "adv_post_async_comm.h"
 #include "tls_shared_buf.h"
 #include "gw_status.h"
 #include "http_post_helper.h"
+#include "http_cbor.h"
+#include "http_gzip.h"
+#include "metrics.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
 #include "log.h"
@@ -27,6 +29,10 @@ static const char TAG[] = "http";
 #warning Debug log level prints out the passwords as a "plaintext".
 #endif
 
+_Static_assert(
+    HTTP_POST_SPOOL_MAX_NUM_RECORDS >= MAX_ADVS_TABLE,
+    "The spool must be large enough for the body with all the tags from adv_table");
+
 typedef struct http_send_advs_internal_params_t
 {
     const uint32_t nonce;
@@ -39,6 +45,8 @@ typedef struct http_send_advs_internal_params_t
     const bool     use_extra_http_headers;
 } http_send_advs_internal_params_t;
 
+static adv_delta_t* g_p_http_adv_delta; //<! Shadow of the last advs delivered to the custom HTTP target
+
 static bool
 http_client_config_init_for_http_target(
     http_client_config_t* const                   p_http_client_config,
@@ -171,16 +179,31 @@ http_send_advs_log_auth_type(const ruuvi_gw_cfg_http_t* const p_cfg_http)
 }
 #endif
 
+static adv_delta_t*
+http_send_advs_get_adv_delta(const bool flag_decode)
+{
+    if ((0 == HTTP_DELTA_KEYFRAME_INTERVAL) || (!flag_decode))
+    {
+        return NULL;
+    }
+    if (NULL == g_p_http_adv_delta)
+    {
+        g_p_http_adv_delta = adv_delta_create(ADV_TABLE_CAPACITY, HTTP_DELTA_KEYFRAME_INTERVAL);
+        if (NULL == g_p_http_adv_delta)
+        {
+            LOG_WARN("Not enough memory for the shadow of delta-encoding, send all fields");
+        }
+    }
+    return g_p_http_adv_delta;
+}
+
 static bool
-http_send_advs_internal(
+http_send_advs_prepare_json_body(
     http_async_info_t* const                      p_http_async_info,
-    const adv_report_table_t* const               p_reports,
+    adv_table_snapshot_t* const                   p_snapshot,
     const ruuvi_gw_cfg_http_t* const              p_cfg_http,
-    const http_send_advs_internal_params_t* const p_params,
-    void* const                                   p_user_data)
+    const http_send_advs_internal_params_t* const p_params)
 {
-    p_http_async_info->recipient = p_params->flag_post_to_ruuvi ? HTTP_POST_RECIPIENT_ADVS1 : HTTP_POST_RECIPIENT_ADVS2;
-
     bool flag_raw_data = true;
     bool flag_decode   = false;
     if (!p_params->flag_post_to_ruuvi)
@@ -188,6 +211,7 @@ http_send_advs_internal(
         switch (p_cfg_http->data_format)
         {
             case GW_CFG_HTTP_DATA_FORMAT_RUUVI:
+            case GW_CFG_HTTP_DATA_FORMAT_RUUVI_CBOR:
                 flag_raw_data = true;
                 flag_decode   = false;
                 break;
@@ -202,7 +226,7 @@ http_send_advs_internal(
         }
     }
 
-    p_http_async_info->use_json_stream_gen = true;
+    p_http_async_info->p_adv_delta = http_send_advs_get_adv_delta(flag_decode);
 
     str_buf_t coordinates_str_buf = gw_cfg_get_coordinates_str_buf();
 
@@ -215,8 +239,9 @@ http_send_advs_internal(
         .nonce               = p_params->nonce,
         .p_mac_addr          = gw_cfg_get_nrf52_mac_addr(),
         .coordinates_str_buf = coordinates_str_buf,
+        .p_adv_delta         = p_http_async_info->p_adv_delta,
     };
-    p_http_async_info->select.p_gen = http_json_create_stream_gen_advs(p_reports, &params);
+    p_http_async_info->select.p_gen = http_json_create_stream_gen_advs_from_snapshot(p_snapshot, &params);
     str_buf_free_buf(&coordinates_str_buf);
     if (NULL == p_http_async_info->select.p_gen)
     {
@@ -224,57 +249,208 @@ http_send_advs_internal(
         gateway_restart_low_memory();
         return false;
     }
+    p_http_async_info->p_adv_table_snapshot = adv_table_snapshot_ref(p_snapshot);
 
-#if LOG_LOCAL_LEVEL >= LOG_LEVEL_DEBUG
-    http_send_advs_log_auth_type(p_cfg_http);
-#endif
+    // Generate json only once: calculate HMAC_SHA256 and the length of the body and spool the generated chunks,
+    // so that the body can be sent without running the generator again.
+    // If compression is enabled, then the chunks are compressed before spooling,
+    // HMAC_SHA256 is always calculated for the uncompressed json.
+    http_post_spool_free(&p_http_async_info->post_spool);
+    http_gzip_t* p_gzip = NULL;
+    if ((0 != (p_params->flag_post_to_ruuvi ? HTTP_GZIP_RUUVI : HTTP_GZIP_CUSTOM)))
+    {
+        p_gzip = http_gzip_create(&http_post_spool_cb_on_chunk, &p_http_async_info->post_spool);
+        if (NULL == p_gzip)
+        {
+            LOG_WARN("Not enough memory for gzip, send uncompressed data");
+        }
+    }
+    const hmac_sha256_cb_on_chunk_t p_cb_on_chunk = (NULL != p_gzip) ? &http_gzip_cb_on_chunk
+                                                                     : &http_post_spool_cb_on_chunk;
+    void* const p_cb_user_data = (NULL != p_gzip) ? (void*)p_gzip : (void*)&p_http_async_info->post_spool;
+    bool        flag_hmac_calculated = false;
+    METRICS_STAGE_BEGIN(METRICS_STAGE_JSON_GEN_HTTP);
+    if (p_params->flag_post_to_ruuvi)
+    {
+        flag_hmac_calculated = hmac_sha256_calc_for_json_gen_http_ruuvi_with_cb(
+            p_http_async_info->select.p_gen,
+            &p_http_async_info->hmac_sha256,
+            p_cb_on_chunk,
+            p_cb_user_data);
+    }
+    else
+    {
+        flag_hmac_calculated = hmac_sha256_calc_for_json_gen_http_custom_with_cb(
+            p_http_async_info->select.p_gen,
+            &p_http_async_info->hmac_sha256,
+            p_cb_on_chunk,
+            p_cb_user_data);
+    }
+    METRICS_STAGE_END(METRICS_STAGE_JSON_GEN_HTTP);
+    if (NULL != p_gzip)
+    {
+        if (flag_hmac_calculated && http_gzip_finish(p_gzip)
+            && http_post_spool_is_complete(&p_http_async_info->post_spool))
+        {
+            p_http_async_info->content_encoding = HTTP_CONTENT_ENCODING_GZIP;
+        }
+        else
+        {
+            // The compressed body can be sent only from the spool,
+            // so fall back to generating the uncompressed body on the fly.
+            LOG_WARN("Compressed data does not fit into the spool, send uncompressed data");
+            http_post_spool_free(&p_http_async_info->post_spool);
+        }
+        http_gzip_delete(&p_gzip);
+    }
+    if (!flag_hmac_calculated)
+    {
+        // The spooled data may be incomplete, so fall back to generating the body on the fly.
+        http_post_spool_free(&p_http_async_info->post_spool);
+    }
+    else if (http_post_spool_is_complete(&p_http_async_info->post_spool))
+    {
+        // The body is in the spool, so release the generator and the snapshot of advertisements as early as possible.
+        // The snapshot is still needed to update the shadow of delta-encoding after the successful POST.
+        json_stream_gen_delete(&p_http_async_info->select.p_gen);
+        p_http_async_info->select.p_gen = NULL;
+        if (NULL == p_http_async_info->p_adv_delta)
+        {
+            adv_table_snapshot_release(&p_http_async_info->p_adv_table_snapshot);
+        }
+    }
+    else
+    {
+        // MISRA C:2012, 15.7 - All if...else if constructs shall be terminated with an else statement
+    }
+    return true;
+}
 
-    http_client_config_t* const p_http_cli_cfg = &p_http_async_info->http_client_config;
-    if (!http_client_config_init_for_http_target(
-            p_http_cli_cfg,
-            p_cfg_http,
-            p_params,
-            p_user_data,
-            p_http_async_info->p_tls_shared_buf))
+static bool
+http_send_advs_prepare_cbor_body(
+    http_async_info_t* const                      p_http_async_info,
+    const adv_table_snapshot_t* const             p_snapshot,
+    const http_send_advs_internal_params_t* const p_params)
+{
+    str_buf_t coordinates_str_buf = gw_cfg_get_coordinates_str_buf();
+
+    const http_cbor_create_advs_params_t params = {
+        .flag_use_timestamps = p_params->flag_use_timestamps,
+        .cur_time            = time(NULL),
+        .flag_use_nonce      = true,
+        .nonce               = p_params->nonce,
+        .p_mac_addr          = gw_cfg_get_nrf52_mac_addr(),
+        .coordinates_str_buf = coordinates_str_buf,
+    };
+    http_cbor_buf_t cbor_buf = { 0 };
+    const bool      res      = http_cbor_create_advs_from_snapshot(p_snapshot, &params, &cbor_buf);
+    str_buf_free_buf(&coordinates_str_buf);
+    if (!res)
     {
-        http_async_info_free_data(p_http_async_info);
+        LOG_ERR("Not enough memory to create CBOR");
+        gateway_restart_low_memory();
         return false;
     }
 
-    p_http_async_info->p_http_client_handle = esp_http_client_init(&p_http_cli_cfg->esp_http_client_config);
-    if (NULL == p_http_async_info->p_http_client_handle)
+    // CBOR is binary, so it can't be generated on the fly by json_stream_gen - the body is always sent from the spool.
+    p_http_async_info->content_type = HTTP_CONTENT_TYPE_CBOR;
+    p_http_async_info->select.p_gen = NULL;
+    METRICS_STAGE_BEGIN(METRICS_STAGE_HMAC);
+    (void)hmac_sha256_calc_bin_for_http_custom(cbor_buf.p_buf, cbor_buf.len, &p_http_async_info->hmac_sha256);
+    METRICS_STAGE_END(METRICS_STAGE_HMAC);
+    http_post_spool_free(&p_http_async_info->post_spool);
+    if ((0 != HTTP_GZIP_CUSTOM)
+        && http_gzip_compress_buf(
+            cbor_buf.p_buf,
+            cbor_buf.len,
+            &http_post_spool_cb_on_chunk,
+            &p_http_async_info->post_spool)
+        && http_post_spool_is_complete(&p_http_async_info->post_spool))
+    {
+        p_http_async_info->content_encoding = HTTP_CONTENT_ENCODING_GZIP;
+        http_cbor_buf_free(&cbor_buf);
+    }
+    else
     {
-        LOG_ERR("HTTP POST to Base URL=%s: Can't init http client", p_http_cli_cfg->http_url_copy.buf);
-        http_async_info_free_data(p_http_async_info);
-        return false;
+        // The uncompressed CBOR is sent directly from its buffer, so it's not limited by HTTP_POST_SPOOL_MAX_SIZE.
+        LOG_DBG("Send uncompressed CBOR (len=%u)", (printf_uint_t)cbor_buf.len);
+        http_post_spool_attach_buf(&p_http_async_info->post_spool, cbor_buf.p_buf, cbor_buf.len);
+        cbor_buf.p_buf = NULL;
+        cbor_buf.len   = 0;
     }
+    return true;
+}
 
-    if (!p_params->flag_post_to_ruuvi)
+static bool
+http_send_advs_internal(
+    http_async_info_t* const                      p_http_async_info,
+    adv_table_snapshot_t* const                   p_snapshot,
+    const ruuvi_gw_cfg_http_t* const              p_cfg_http,
+    const http_send_advs_internal_params_t* const p_params,
+    void* const                                   p_user_data)
+{
+    p_http_async_info->recipient = p_params->flag_post_to_ruuvi ? HTTP_POST_RECIPIENT_ADVS1 : HTTP_POST_RECIPIENT_ADVS2;
+
+    p_http_async_info->use_json_stream_gen = true;
+    p_http_async_info->content_type        = HTTP_CONTENT_TYPE_JSON;
+    p_http_async_info->content_encoding    = HTTP_CONTENT_ENCODING_NONE;
+    p_http_async_info->p_adv_delta         = NULL;
+
+    if ((!p_params->flag_post_to_ruuvi) && (GW_CFG_HTTP_DATA_FORMAT_RUUVI_CBOR == p_cfg_http->data_format))
     {
-        if (!http_handle_add_authorization_if_needed( // NOSONAR
-                p_http_async_info->p_http_client_handle,
-                p_cfg_http->auth_type,
-                &p_cfg_http->auth))
+        if (!http_send_advs_prepare_cbor_body(p_http_async_info, p_snapshot, p_params))
         {
             http_async_info_free_data(p_http_async_info);
             return false;
         }
     }
-
-    if (p_params->flag_post_to_ruuvi)
-    {
-        (void)hmac_sha256_calc_for_json_gen_http_ruuvi(
-            p_http_async_info->select.p_gen,
-            &p_http_async_info->hmac_sha256);
-    }
     else
     {
-        (void)hmac_sha256_calc_for_json_gen_http_custom(
-            p_http_async_info->select.p_gen,
-            &p_http_async_info->hmac_sha256);
+        if (!http_send_advs_prepare_json_body(p_http_async_info, p_snapshot, p_cfg_http, p_params))
+        {
+            return false;
+        }
     }
 
-    adv_post_set_adv_post_http_action(p_params->flag_post_to_ruuvi);
+#if LOG_LOCAL_LEVEL >= LOG_LEVEL_DEBUG
+    http_send_advs_log_auth_type(p_cfg_http);
+#endif
+
+    if (NULL == p_http_async_info->p_http_client_handle)
+    {
+        // Otherwise, the request is sent over the connection kept alive after the previous request to the same target.
+        http_client_config_t* const p_http_cli_cfg = &p_http_async_info->http_client_config;
+        if (!http_client_config_init_for_http_target(
+                p_http_cli_cfg,
+                p_cfg_http,
+                p_params,
+                p_user_data,
+                p_http_async_info->p_tls_shared_buf))
+        {
+            http_async_info_free_data(p_http_async_info);
+            return false;
+        }
+
+        p_http_async_info->p_http_client_handle = esp_http_client_init(&p_http_cli_cfg->esp_http_client_config);
+        if (NULL == p_http_async_info->p_http_client_handle)
+        {
+            LOG_ERR("HTTP POST to Base URL=%s: Can't init http client", p_http_cli_cfg->http_url_copy.buf);
+            http_async_info_free_data(p_http_async_info);
+            return false;
+        }
+
+        if (!p_params->flag_post_to_ruuvi)
+        {
+            if (!http_handle_add_authorization_if_needed( // NOSONAR
+                    p_http_async_info->p_http_client_handle,
+                    p_cfg_http->auth_type,
+                    &p_cfg_http->auth))
+            {
+                http_async_info_free_data(p_http_async_info);
+                return false;
+            }
+        }
+    }
 
     if (!http_send_async(p_http_async_info))
     {
@@ -289,27 +465,14 @@ http_send_advs_internal(
 
 bool
 http_post_advs(
-    const adv_report_table_t* const  p_reports,
+    http_async_info_t* const         p_http_async_info,
+    adv_table_snapshot_t* const      p_snapshot,
     const uint32_t                   nonce,
     const bool                       flag_use_timestamps,
     const bool                       flag_post_to_ruuvi,
     const ruuvi_gw_cfg_http_t* const p_cfg_http,
     void* const                      p_user_data)
 {
-    http_async_info_t* p_http_async_info = http_get_async_info();
-    LOG_DBG("os_sema_wait_immediate: p_http_async_sema");
-    if (!os_sema_wait_immediate(p_http_async_info->p_http_async_sema))
-    {
-        /* Because the amount of memory is limited and may not be sufficient for two simultaneous queries,
-         * this function should only be called from a single thread. */
-        LOG_ERR("This function is called twice from two different threads, which can lead to memory shortages");
-        assert(0);
-    }
-    p_http_async_info->p_task = xTaskGetCurrentTaskHandle();
-
-    LOG_DBG("tls_shared_buf_get_https_post");
-    p_http_async_info->p_tls_shared_buf = tls_shared_buf_get_https_post();
-
     const bool use_ssl_client_cert = (!flag_post_to_ruuvi) && p_cfg_http->http_use_ssl_client_cert;
     const bool use_ssl_server_cert = (!flag_post_to_ruuvi) && p_cfg_http->http_use_ssl_server_cert;
 
@@ -328,13 +491,8 @@ http_post_advs(
         .use_extra_http_headers = use_extra_http_headers,
     };
 
-    if (!http_send_advs_internal(p_http_async_info, p_reports, p_cfg_http, &params, p_user_data))
-    {
-        LOG_DBG("os_sema_signal: p_http_async_sema");
-        os_sema_signal(p_http_async_info->p_http_async_sema);
-        return false;
-    }
-    return true;
+    // On failure the slot is released by the caller (see http_async_slot_release).
+    return http_send_advs_internal(p_http_async_info, p_snapshot, p_cfg_http, &params, p_user_data);
 }
 
 static bool
@@ -22,6 +22,29 @@ static const char TAG[] = "http";
 
 #define BASE_10 (10U)
 
+/**
+ * @brief Find the target of the async HTTP POST to which the response belongs (several requests can be in progress).
+ */
+static adv_post_action_e
+http_post_event_handler_get_action(const esp_http_client_handle_t p_http_client_handle)
+{
+    const http_async_info_t* const p_http_async_info = http_async_info_find_by_handle(p_http_client_handle);
+    if (NULL == p_http_async_info)
+    {
+        return ADV_POST_ACTION_NONE;
+    }
+    switch (p_http_async_info->recipient)
+    {
+        case HTTP_POST_RECIPIENT_STATS:
+            return ADV_POST_ACTION_POST_STATS;
+        case HTTP_POST_RECIPIENT_ADVS1:
+            return ADV_POST_ACTION_POST_ADVS_TO_RUUVI;
+        case HTTP_POST_RECIPIENT_ADVS2:
+            return ADV_POST_ACTION_POST_ADVS_TO_CUSTOM;
+    }
+    return ADV_POST_ACTION_NONE;
+}
+
 static void
 http_post_event_handler_on_header(const esp_http_client_event_t* const p_evt)
 {
@@ -32,7 +55,7 @@ http_post_event_handler_on_header(const esp_http_client_event_t* const p_evt)
         p_evt->user_data);
     if (0 == strcasecmp("Ruuvi-HMAC-KEY", p_evt->header_key))
     {
-        if (!adv_post_set_hmac_sha256_key(p_evt->header_value))
+        if (!adv_post_set_hmac_sha256_key(http_post_event_handler_get_action(p_evt->client), p_evt->header_value))
         {
             LOG_ERR("Failed to update Ruuvi-HMAC-KEY");
         }
@@ -45,7 +68,9 @@ http_post_event_handler_on_header(const esp_http_client_event_t* const p_evt)
             LOG_WARN("X-Ruuvi-Gateway-Rate: Got incorrect value: %s", p_evt->header_value);
             period_seconds = ADV_POST_DEFAULT_INTERVAL_SECONDS;
         }
-        adv_post_set_default_period(period_seconds * TIME_UNITS_MS_PER_SECOND);
+        adv_post_set_default_period(
+            http_post_event_handler_get_action(p_evt->client),
+            period_seconds * TIME_UNITS_MS_PER_SECOND);
     }
     else if ((0 == strcasecmp("Content-Length", p_evt->header_key)) && (NULL != p_evt->user_data))
     {
@@ -97,6 +122,7 @@ http_post_event_handler(esp_http_client_event_t* p_evt) // NOSONAR
 
         case HTTP_EVENT_ON_CONNECTED:
             LOG_DBG("HTTP_EVENT_ON_CONNECTED");
+            http_async_on_connected(p_evt->client);
             break;
 
         case HTTP_EVENT_HEADERS_SENT:
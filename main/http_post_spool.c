@@ -0,0 +1,199 @@
+/**
+ * @file http_post_spool.c
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_post_spool.h"
+#include <string.h>
+#include "os_malloc.h"
+
+struct http_post_spool_block_t
+{
+    http_post_spool_block_t* p_next;
+    size_t                   len;
+    char                     buf[HTTP_POST_SPOOL_BLOCK_SIZE];
+};
+
+void
+http_post_spool_init(http_post_spool_t* const p_spool)
+{
+    p_spool->p_first       = NULL;
+    p_spool->p_last        = NULL;
+    p_spool->p_rd_block        = NULL;
+    p_spool->p_ext_buf         = NULL;
+    p_spool->flag_ext_buf_read = false;
+    p_spool->total_len         = 0;
+    p_spool->flag_overflow     = false;
+}
+
+static void
+http_post_spool_free_blocks(http_post_spool_t* const p_spool)
+{
+    http_post_spool_block_t* p_block = p_spool->p_first;
+    while (NULL != p_block)
+    {
+        http_post_spool_block_t* const p_next = p_block->p_next;
+        os_free(p_block);
+        p_block = p_next;
+    }
+    p_spool->p_first    = NULL;
+    p_spool->p_last     = NULL;
+    p_spool->p_rd_block = NULL;
+    if (NULL != p_spool->p_ext_buf)
+    {
+        os_free(p_spool->p_ext_buf);
+        p_spool->p_ext_buf = NULL;
+    }
+}
+
+void
+http_post_spool_free(http_post_spool_t* const p_spool)
+{
+    http_post_spool_free_blocks(p_spool);
+    http_post_spool_init(p_spool);
+}
+
+static void
+http_post_spool_set_overflow(http_post_spool_t* const p_spool)
+{
+    http_post_spool_free_blocks(p_spool);
+    p_spool->flag_overflow = true;
+}
+
+static http_post_spool_block_t*
+http_post_spool_add_block(http_post_spool_t* const p_spool)
+{
+    http_post_spool_block_t* const p_block = os_malloc(sizeof(*p_block));
+    if (NULL == p_block)
+    {
+        return NULL;
+    }
+    p_block->p_next = NULL;
+    p_block->len    = 0;
+    if (NULL == p_spool->p_last)
+    {
+        p_spool->p_first = p_block;
+    }
+    else
+    {
+        p_spool->p_last->p_next = p_block;
+    }
+    p_spool->p_last = p_block;
+    return p_block;
+}
+
+void
+http_post_spool_append(http_post_spool_t* const p_spool, const char* const p_buf, const size_t len)
+{
+    p_spool->total_len += len;
+    if (p_spool->flag_overflow)
+    {
+        return;
+    }
+    if (p_spool->total_len > HTTP_POST_SPOOL_MAX_SIZE)
+    {
+        http_post_spool_set_overflow(p_spool);
+        return;
+    }
+    size_t offset = 0;
+    while (offset < len)
+    {
+        http_post_spool_block_t* p_block = p_spool->p_last;
+        if ((NULL == p_block) || (p_block->len >= sizeof(p_block->buf)))
+        {
+            p_block = http_post_spool_add_block(p_spool);
+            if (NULL == p_block)
+            {
+                http_post_spool_set_overflow(p_spool);
+                return;
+            }
+        }
+        size_t chunk_len = sizeof(p_block->buf) - p_block->len;
+        if (chunk_len > (len - offset))
+        {
+            chunk_len = len - offset;
+        }
+        memcpy(&p_block->buf[p_block->len], &p_buf[offset], chunk_len);
+        p_block->len += chunk_len;
+        offset += chunk_len;
+    }
+}
+
+void
+http_post_spool_attach_buf(http_post_spool_t* const p_spool, void* const p_buf, const size_t len)
+{
+    http_post_spool_free(p_spool);
+    p_spool->p_ext_buf = p_buf;
+    p_spool->total_len = len;
+}
+
+bool
+http_post_spool_cb_on_chunk(void* const p_user_data, const char* const p_chunk, const size_t len)
+{
+    http_post_spool_append((http_post_spool_t*)p_user_data, p_chunk, len);
+    return true;
+}
+
+bool
+http_post_spool_is_complete(const http_post_spool_t* const p_spool)
+{
+    if (p_spool->flag_overflow)
+    {
+        return false;
+    }
+    if (NULL != p_spool->p_ext_buf)
+    {
+        return true;
+    }
+    if (NULL == p_spool->p_first)
+    {
+        return false;
+    }
+    return true;
+}
+
+size_t
+http_post_spool_get_total_len(const http_post_spool_t* const p_spool)
+{
+    return p_spool->total_len;
+}
+
+void
+http_post_spool_rewind(http_post_spool_t* const p_spool)
+{
+    p_spool->p_rd_block        = NULL;
+    p_spool->flag_ext_buf_read = false;
+}
+
+void
+http_post_spool_read_next_block(http_post_spool_t* const p_spool, const void** const p_p_buf, size_t* const p_len)
+{
+    if (NULL != p_spool->p_ext_buf)
+    {
+        // The attached buffer is returned as a single block
+        *p_p_buf                   = p_spool->flag_ext_buf_read ? "" : p_spool->p_ext_buf;
+        *p_len                     = p_spool->flag_ext_buf_read ? 0 : p_spool->total_len;
+        p_spool->flag_ext_buf_read = true;
+        return;
+    }
+    if (NULL == p_spool->p_rd_block)
+    {
+        p_spool->p_rd_block = p_spool->p_first;
+    }
+    else
+    {
+        p_spool->p_rd_block = p_spool->p_rd_block->p_next;
+    }
+    if (NULL == p_spool->p_rd_block)
+    {
+        // Stay at the end of the spool until http_post_spool_rewind is called
+        p_spool->p_rd_block = p_spool->p_last;
+        *p_p_buf            = "";
+        *p_len              = 0;
+        return;
+    }
+    *p_p_buf = p_spool->p_rd_block->buf;
+    *p_len   = p_spool->p_rd_block->len;
+}
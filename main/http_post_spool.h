@@ -0,0 +1,156 @@
+/**
+ * @file http_post_spool.h
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ * @brief Spool buffer for the body of HTTP POST requests.
+ *
+ * The spool keeps the output of json_stream_gen in a list of small fixed-size blocks,
+ * so that the generator is run only once per HTTP POST: the same pass is used to calculate
+ * the length of the body (for Content-Length) and HMAC_SHA256 (for Ruuvi-HMAC-SHA256 header),
+ * and then the body is sent from the spool.
+ * The total size of the spool is limited by HTTP_POST_SPOOL_MAX_SIZE - if the body does not fit,
+ * the spool is released and marked as overflowed, but the length of the body is still counted.
+ * A body which is already completely in memory (e.g. CBOR) can be attached to the spool without copying,
+ * in this case HTTP_POST_SPOOL_MAX_SIZE is not applied.
+ */
+
+#ifndef RUUVI_GATEWAY_HTTP_POST_SPOOL_H
+#define RUUVI_GATEWAY_HTTP_POST_SPOOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_POST_SPOOL_BLOCK_SIZE (1024U)
+
+/**
+ * @brief The upper bound of the length of one tag in the indented json body with raw data
+ *        (all the optional fields are present and have the longest values, 48 bytes of raw data).
+ */
+#define HTTP_POST_SPOOL_MAX_RECORD_SIZE (320U)
+
+/**
+ * @brief The upper bound of the length of the json body without the tags.
+ */
+#define HTTP_POST_SPOOL_MAX_HEADER_SIZE (512U)
+
+/**
+ * @brief The maximum number of tags in the body, it must be not less than MAX_ADVS_TABLE.
+ */
+#if !defined(HTTP_POST_SPOOL_MAX_NUM_RECORDS)
+#define HTTP_POST_SPOOL_MAX_NUM_RECORDS (100U)
+#endif
+
+/**
+ * @brief The maximum size of the spool, by default the body with raw data of all the tags fits into it,
+ *        it can be overridden at build time (see RUUVI_HTTP_POST_SPOOL_MAX_SIZE in the top-level CMakeLists.txt).
+ * @note The body with decoded data or with samples may not fit, then it's generated on the fly.
+ */
+#if !defined(HTTP_POST_SPOOL_MAX_SIZE) || (0 == HTTP_POST_SPOOL_MAX_SIZE)
+#undef HTTP_POST_SPOOL_MAX_SIZE
+#define HTTP_POST_SPOOL_MAX_SIZE \
+    (HTTP_POST_SPOOL_MAX_HEADER_SIZE + (HTTP_POST_SPOOL_MAX_NUM_RECORDS * HTTP_POST_SPOOL_MAX_RECORD_SIZE))
+#endif
+
+typedef struct http_post_spool_block_t http_post_spool_block_t;
+
+typedef struct http_post_spool_t
+{
+    http_post_spool_block_t* p_first;
+    http_post_spool_block_t* p_last;
+    http_post_spool_block_t* p_rd_block;
+    void*                    p_ext_buf; //<! Buffer attached by http_post_spool_attach_buf instead of the blocks
+    bool                     flag_ext_buf_read;
+    size_t                   total_len;
+    bool                     flag_overflow;
+} http_post_spool_t;
+
+/**
+ * @brief Initialize an empty spool.
+ * @param p_spool - ptr to http_post_spool_t
+ */
+void
+http_post_spool_init(http_post_spool_t* const p_spool);
+
+/**
+ * @brief Release all the blocks of the spool and re-initialize it.
+ * @param p_spool - ptr to http_post_spool_t
+ */
+void
+http_post_spool_free(http_post_spool_t* const p_spool);
+
+/**
+ * @brief Append data to the spool.
+ * @note If the data does not fit into HTTP_POST_SPOOL_MAX_SIZE or if there is not enough memory,
+ *       then all the blocks are released and the spool is marked as overflowed,
+ *       the subsequent calls only update the total length.
+ * @param p_spool - ptr to http_post_spool_t
+ * @param p_buf - ptr to the data
+ * @param len - length of the data
+ */
+void
+http_post_spool_append(http_post_spool_t* const p_spool, const char* const p_buf, const size_t len);
+
+/**
+ * @brief Replace the content of the spool with the buffer allocated by os_malloc.
+ * @note The spool takes ownership of the buffer, it's released by http_post_spool_free.
+ *       Data must not be appended to the spool after attaching the buffer.
+ * @param p_spool - ptr to http_post_spool_t
+ * @param p_buf - ptr to the buffer
+ * @param len - length of the data in the buffer
+ */
+void
+http_post_spool_attach_buf(http_post_spool_t* const p_spool, void* const p_buf, const size_t len);
+
+/**
+ * @brief Callback for hmac_sha256_calc_for_json_gen_http_*_with_cb which appends every chunk to the spool.
+ * @param p_user_data - ptr to http_post_spool_t
+ * @param p_chunk - ptr to the chunk
+ * @param len - length of the chunk
+ * @return always true (overflow of the spool does not interrupt the calculation of HMAC_SHA256)
+ */
+bool
+http_post_spool_cb_on_chunk(void* const p_user_data, const char* const p_chunk, const size_t len);
+
+/**
+ * @brief Check if the spool contains the complete body of HTTP POST.
+ * @param p_spool - ptr to http_post_spool_t
+ * @return true if the spool is not empty and was not overflowed.
+ */
+bool
+http_post_spool_is_complete(const http_post_spool_t* const p_spool);
+
+/**
+ * @brief Get the total length of the data appended to the spool (including the data dropped on overflow).
+ * @param p_spool - ptr to http_post_spool_t
+ * @return total length in bytes
+ */
+size_t
+http_post_spool_get_total_len(const http_post_spool_t* const p_spool);
+
+/**
+ * @brief Reset the read position to the first block of the spool.
+ * @param p_spool - ptr to http_post_spool_t
+ */
+void
+http_post_spool_rewind(http_post_spool_t* const p_spool);
+
+/**
+ * @brief Get the next block of the spool.
+ * @param p_spool - ptr to http_post_spool_t
+ * @param[out] p_p_buf - ptr to a variable to store ptr to the data of the block
+ * @param[out] p_len - ptr to a variable to store the length of the block, it's set to 0 at the end of the spool
+ */
+void
+http_post_spool_read_next_block(http_post_spool_t* const p_spool, const void** const p_p_buf, size_t* const p_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_GATEWAY_HTTP_POST_SPOOL_H
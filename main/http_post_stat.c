@@ -17,6 +17,8 @@
 #include "tls_shared_buf.h"
 #include "gw_status.h"
 #include "http_post_helper.h"
+#include "http_gzip.h"
+#include "metrics.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
 #include "log.h"
@@ -36,65 +38,96 @@ http_send_statistics_internal(
     const bool                               use_ssl_server_cert)
 {
     p_http_async_info->recipient           = HTTP_POST_RECIPIENT_STATS;
+    p_http_async_info->content_type        = HTTP_CONTENT_TYPE_JSON;
+    p_http_async_info->content_encoding    = HTTP_CONTENT_ENCODING_NONE;
     p_http_async_info->use_json_stream_gen = false;
+    p_http_async_info->p_adv_delta         = NULL;
     p_http_async_info->select.cjson_str    = cjson_wrap_str_null();
-    if (!http_json_create_status_str(p_stat_info, p_reports, &p_http_async_info->select.cjson_str))
+    METRICS_STAGE_BEGIN(METRICS_STAGE_JSON_GEN_HTTP);
+    const bool flag_json_created = http_json_create_status_str(
+        p_stat_info,
+        p_reports,
+        &p_http_async_info->select.cjson_str);
+    METRICS_STAGE_END(METRICS_STAGE_JSON_GEN_HTTP);
+    if (!flag_json_created)
     {
         LOG_ERR("Not enough memory to generate status json");
         return false;
     }
 
-    p_http_async_info->http_client_config.http_url_copy = p_cfg_http_stat->http_stat_url;
-    p_http_async_info->http_client_config.http_user     = p_cfg_http_stat->http_stat_user;
-    p_http_async_info->http_client_config.http_pass     = p_cfg_http_stat->http_stat_pass;
-
-    str_buf_t str_buf_server_cert_stat = str_buf_init_null();
-    str_buf_t str_buf_client_cert      = str_buf_init_null();
-    str_buf_t str_buf_client_key       = str_buf_init_null();
-    if (use_ssl_client_cert)
-    {
-        str_buf_client_cert = gw_cfg_storage_read_file_as_string(GW_CFG_STORAGE_SSL_STAT_CLI_CERT);
-        str_buf_client_key  = gw_cfg_storage_read_file_as_string(GW_CFG_STORAGE_SSL_STAT_CLI_KEY);
-    }
-    if (use_ssl_server_cert)
+    if (NULL == p_http_async_info->p_http_client_handle)
     {
-        str_buf_server_cert_stat = gw_cfg_storage_read_file_as_string(GW_CFG_STORAGE_SSL_STAT_SRV_CERT);
-    }
+        // Otherwise, the request is sent over the connection kept alive after the previous statistics.
+        p_http_async_info->http_client_config.http_url_copy = p_cfg_http_stat->http_stat_url;
+        p_http_async_info->http_client_config.http_user     = p_cfg_http_stat->http_stat_user;
+        p_http_async_info->http_client_config.http_pass     = p_cfg_http_stat->http_stat_pass;
 
-    const http_client_config_init_params_t http_cli_cfg_params = {
-        .p_url         = &p_cfg_http_stat->http_stat_url,
-        .p_user        = &p_cfg_http_stat->http_stat_user,
-        .p_password    = &p_cfg_http_stat->http_stat_pass,
-        .p_server_cert = str_buf_server_cert_stat.buf,
-        .p_client_cert = str_buf_client_cert.buf,
-        .p_client_key  = str_buf_client_key.buf,
+        str_buf_t str_buf_server_cert_stat = str_buf_init_null();
+        str_buf_t str_buf_client_cert      = str_buf_init_null();
+        str_buf_t str_buf_client_key       = str_buf_init_null();
+        if (use_ssl_client_cert)
+        {
+            str_buf_client_cert = gw_cfg_storage_read_file_as_string(GW_CFG_STORAGE_SSL_STAT_CLI_CERT);
+            str_buf_client_key  = gw_cfg_storage_read_file_as_string(GW_CFG_STORAGE_SSL_STAT_CLI_KEY);
+        }
+        if (use_ssl_server_cert)
+        {
+            str_buf_server_cert_stat = gw_cfg_storage_read_file_as_string(GW_CFG_STORAGE_SSL_STAT_SRV_CERT);
+        }
 
-        .ssl_buf_cfg.p_ssl_in_buf        = p_http_async_info->p_tls_shared_buf->in_buf,
-        .ssl_buf_cfg.ssl_in_buf_len      = sizeof(p_http_async_info->p_tls_shared_buf->in_buf),
-        .ssl_buf_cfg.ssl_in_content_len  = RUUVI_HTTPS_POST_TLS_IN_CONTENT_LEN,
-        .ssl_buf_cfg.p_ssl_out_buf       = p_http_async_info->p_tls_shared_buf->out_buf,
-        .ssl_buf_cfg.ssl_out_buf_len     = sizeof(p_http_async_info->p_tls_shared_buf->out_buf),
-        .ssl_buf_cfg.ssl_out_content_len = RUUVI_HTTPS_POST_TLS_OUT_CONTENT_LEN,
-    };
+        const http_client_config_init_params_t http_cli_cfg_params = {
+            .p_url         = &p_cfg_http_stat->http_stat_url,
+            .p_user        = &p_cfg_http_stat->http_stat_user,
+            .p_password    = &p_cfg_http_stat->http_stat_pass,
+            .p_server_cert = str_buf_server_cert_stat.buf,
+            .p_client_cert = str_buf_client_cert.buf,
+            .p_client_key  = str_buf_client_key.buf,
 
-    if (!http_client_config_init(&p_http_async_info->http_client_config, &http_cli_cfg_params, p_user_data))
-    {
-        http_async_info_free_data(p_http_async_info);
-        return false;
-    }
+            .ssl_buf_cfg.p_ssl_in_buf        = p_http_async_info->p_tls_shared_buf->in_buf,
+            .ssl_buf_cfg.ssl_in_buf_len      = sizeof(p_http_async_info->p_tls_shared_buf->in_buf),
+            .ssl_buf_cfg.ssl_in_content_len  = RUUVI_HTTPS_POST_TLS_IN_CONTENT_LEN,
+            .ssl_buf_cfg.p_ssl_out_buf       = p_http_async_info->p_tls_shared_buf->out_buf,
+            .ssl_buf_cfg.ssl_out_buf_len     = sizeof(p_http_async_info->p_tls_shared_buf->out_buf),
+            .ssl_buf_cfg.ssl_out_content_len = RUUVI_HTTPS_POST_TLS_OUT_CONTENT_LEN,
+        };
 
-    p_http_async_info->p_http_client_handle = esp_http_client_init(
-        &p_http_async_info->http_client_config.esp_http_client_config);
-    if (NULL == p_http_async_info->p_http_client_handle)
-    {
-        LOG_ERR(
-            "HTTP POST to Base URL=%s: Can't init http client",
-            p_http_async_info->http_client_config.http_url_copy.buf);
-        http_async_info_free_data(p_http_async_info);
-        return false;
+        if (!http_client_config_init(&p_http_async_info->http_client_config, &http_cli_cfg_params, p_user_data))
+        {
+            http_async_info_free_data(p_http_async_info);
+            return false;
+        }
+
+        p_http_async_info->p_http_client_handle = esp_http_client_init(
+            &p_http_async_info->http_client_config.esp_http_client_config);
+        if (NULL == p_http_async_info->p_http_client_handle)
+        {
+            LOG_ERR(
+                "HTTP POST to Base URL=%s: Can't init http client",
+                p_http_async_info->http_client_config.http_url_copy.buf);
+            http_async_info_free_data(p_http_async_info);
+            return false;
+        }
     }
 
+    METRICS_STAGE_BEGIN(METRICS_STAGE_HMAC);
     (void)hmac_sha256_calc_for_stats(p_http_async_info->select.cjson_str.p_str, &p_http_async_info->hmac_sha256);
+    METRICS_STAGE_END(METRICS_STAGE_HMAC);
+
+    http_post_spool_free(&p_http_async_info->post_spool);
+    if ((0 != HTTP_GZIP_STATS)
+        && http_gzip_compress_buf(
+            (const uint8_t*)p_http_async_info->select.cjson_str.p_str,
+            strlen(p_http_async_info->select.cjson_str.p_str),
+            &http_post_spool_cb_on_chunk,
+            &p_http_async_info->post_spool)
+        && http_post_spool_is_complete(&p_http_async_info->post_spool))
+    {
+        p_http_async_info->content_encoding = HTTP_CONTENT_ENCODING_GZIP;
+    }
+    else
+    {
+        http_post_spool_free(&p_http_async_info->post_spool);
+    }
 
     if (!http_send_async(p_http_async_info))
     {
@@ -109,6 +142,7 @@ http_send_statistics_internal(
 
 bool
 http_post_stat(
+    http_async_info_t* const                 p_http_async_info,
     const http_json_statistics_info_t* const p_stat_info,
     const adv_report_table_t* const          p_reports,
     const ruuvi_gw_cfg_http_stat_t* const    p_cfg_http_stat,
@@ -116,34 +150,15 @@ http_post_stat(
     const bool                               use_ssl_client_cert,
     const bool                               use_ssl_server_cert)
 {
-    http_async_info_t* p_http_async_info = http_get_async_info();
-    LOG_DBG("os_sema_wait_immediate: p_http_async_sema");
-    if (!os_sema_wait_immediate(p_http_async_info->p_http_async_sema))
-    {
-        /* Because the amount of memory is limited and may not be sufficient for two simultaneous queries,
-         * this function should only be called from a single thread. */
-        LOG_ERR("This function is called twice from two different threads, which can lead to memory shortages");
-        assert(0);
-    }
-    p_http_async_info->p_task = xTaskGetCurrentTaskHandle();
-
-    LOG_DBG("tls_shared_buf_get_https_post");
-    p_http_async_info->p_tls_shared_buf = tls_shared_buf_get_https_post();
-
-    if (!http_send_statistics_internal(
-            p_http_async_info,
-            p_stat_info,
-            p_reports,
-            p_cfg_http_stat,
-            p_user_data,
-            use_ssl_client_cert,
-            use_ssl_server_cert))
-    {
-        LOG_DBG("os_sema_signal: p_http_async_sema");
-        os_sema_signal(p_http_async_info->p_http_async_sema);
-        return false;
-    }
-    return true;
+    // On failure the slot is released by the caller (see http_async_slot_release).
+    return http_send_statistics_internal(
+        p_http_async_info,
+        p_stat_info,
+        p_reports,
+        p_cfg_http_stat,
+        p_user_data,
+        use_ssl_client_cert,
+        use_ssl_server_cert);
 }
 
 static bool
@@ -18,7 +18,7 @@
 #include "os_time.h"
 #include "reset_task.h"
 #include "gw_cfg.h"
-#include "gw_cfg_json_parse.h"
+#include "gw_cfg_json_stream.h"
 #include "gw_status.h"
 #include "url_encode.h"
 #include "gw_cfg_storage.h"
@@ -54,6 +54,11 @@ http_server_cb_init(const char* const p_fatfs_gwui_partition_name)
     const char*                    mount_point   = "/fs_gwui";
     const flash_fat_fs_num_files_t max_num_files = 4U;
 
+    if (NULL != gp_ffs_gwui)
+    {
+        // The partition could be already mounted in advance (in parallel with the other boot stages)
+        return true;
+    }
     gp_ffs_gwui = flashfatfs_mount(mount_point, p_fatfs_gwui_partition_name, max_num_files);
     if (NULL == gp_ffs_gwui)
     {
@@ -326,8 +331,25 @@ typedef struct http_server_download_gw_cfg_params_t
     const str_buf_t* const             p_str_buf_server_cert_remote;
     const str_buf_t* const             p_str_buf_client_cert;
     const str_buf_t* const             p_str_buf_client_key;
+    gw_cfg_json_stream_t* const        p_json_stream;
 } http_server_download_gw_cfg_params_t;
 
+static void
+http_server_cb_on_gw_cfg_json_data(
+    const char* const p_buf,
+    const size_t      buf_size,
+    const size_t      offset,
+    void* const       p_user_data)
+{
+    gw_cfg_json_stream_t* const p_json_stream = p_user_data;
+    if (0 == offset)
+    {
+        gw_cfg_json_stream_reset(p_json_stream);
+    }
+    // The parsing error is latched in p_json_stream and reported after the download is completed
+    (void)gw_cfg_json_stream_feed(p_json_stream, p_buf, buf_size);
+}
+
 ATTR_PRINTF(2, 3)
 static http_server_download_info_t
 http_server_download_gw_cfg_by_url(
@@ -363,7 +385,11 @@ http_server_download_gw_cfg_by_url(
         .p_extra_header_item = p_params->p_extra_header_item,
     };
 
-    const http_server_download_info_t download_info = http_download_json(&params);
+    gw_cfg_json_stream_reset(p_params->p_json_stream);
+    const http_server_download_info_t download_info = http_download_json_stream(
+        &params,
+        &http_server_cb_on_gw_cfg_json_data,
+        p_params->p_json_stream);
 
     str_buf_free_buf(&url);
     va_end(args);
@@ -428,7 +454,10 @@ http_server_download_gw_cfg_internal(const http_server_download_gw_cfg_params_t*
 }
 
 static http_server_download_info_t
-http_server_download_gw_cfg(const ruuvi_gw_cfg_remote_t* const p_remote, const bool flag_free_memory)
+http_server_download_gw_cfg(
+    const ruuvi_gw_cfg_remote_t* const p_remote,
+    const bool                         flag_free_memory,
+    gw_cfg_json_stream_t* const        p_json_stream)
 {
     const mac_address_str_t* const p_nrf52_mac_addr = gw_cfg_get_nrf52_mac_addr();
 
@@ -458,6 +487,7 @@ http_server_download_gw_cfg(const ruuvi_gw_cfg_remote_t* const p_remote, const b
         .p_str_buf_server_cert_remote = &str_buf_server_cert_remote,
         .p_str_buf_client_cert        = &str_buf_client_cert,
         .p_str_buf_client_key         = &str_buf_client_key,
+        .p_json_stream                = p_json_stream,
     };
 
     const http_server_download_info_t download_info = http_server_download_gw_cfg_internal(&params);
@@ -476,7 +506,21 @@ http_server_gw_cfg_download_and_parse(
     gw_cfg_t**                         p_p_gw_cfg_tmp,
     str_buf_t* const                   p_err_msg)
 {
-    http_server_download_info_t download_info = http_server_download_gw_cfg(p_remote_cfg, flag_free_memory);
+    gw_cfg_json_stream_t* p_json_stream = gw_cfg_json_stream_create();
+    if (NULL == p_json_stream)
+    {
+        LOG_ERR("Failed to allocate memory for gw_cfg.json parser");
+        if (NULL != p_err_msg)
+        {
+            *p_err_msg = str_buf_printf_with_alloc("Failed to allocate memory for gw_cfg.json parser");
+        }
+        return HTTP_RESP_CODE_502;
+    }
+
+    http_server_download_info_t download_info = http_server_download_gw_cfg(
+        p_remote_cfg,
+        flag_free_memory,
+        p_json_stream);
 
     if (download_info.is_error)
     {
@@ -495,25 +539,23 @@ http_server_gw_cfg_download_and_parse(
         {
             os_free(download_info.p_json_buf);
         }
+        gw_cfg_json_stream_delete(&p_json_stream);
         return download_info.http_resp_code;
     }
     LOG_INFO("Download gw_cfg: successfully completed");
-    LOG_DBG("gw_cfg.json: %s", download_info.p_json_buf);
 
-    if ('{' != download_info.p_json_buf[0])
+    const char first_char = gw_cfg_json_stream_get_first_char(p_json_stream);
+    if ('{' != first_char)
     {
-        LOG_ERR(
-            "Invalid first byte of json, expected '{', actual '%c' (%d)",
-            download_info.p_json_buf[0],
-            (printf_int_t)download_info.p_json_buf[0]);
+        LOG_ERR("Invalid first byte of json, expected '{', actual '%c' (%d)", first_char, (printf_int_t)first_char);
         if (NULL != p_err_msg)
         {
             *p_err_msg = str_buf_printf_with_alloc(
                 "Invalid first byte of json, expected '{', actual '%c' (%d)",
-                download_info.p_json_buf[0],
-                (printf_int_t)download_info.p_json_buf[0]);
+                first_char,
+                (printf_int_t)first_char);
         }
-        os_free(download_info.p_json_buf);
+        gw_cfg_json_stream_delete(&p_json_stream);
         return HTTP_RESP_CODE_502;
     }
 
@@ -525,16 +567,16 @@ http_server_gw_cfg_download_and_parse(
         {
             *p_err_msg = str_buf_printf_with_alloc("Failed to allocate memory for gw_cfg");
         }
-        os_free(download_info.p_json_buf);
+        gw_cfg_json_stream_delete(&p_json_stream);
         return HTTP_RESP_CODE_502;
     }
     gw_cfg_get_copy(p_gw_cfg_tmp);
     p_gw_cfg_tmp->ruuvi_cfg.remote.use_remote_cfg = false;
 
-    if (!gw_cfg_json_parse(
+    if (!gw_cfg_json_stream_parse(
+            p_json_stream,
             "gw_cfg.json",
             "Read Gateway SETTINGS from remote server:",
-            download_info.p_json_buf,
             p_gw_cfg_tmp))
     {
         LOG_ERR("Failed to parse gw_cfg.json or no memory");
@@ -543,10 +585,10 @@ http_server_gw_cfg_download_and_parse(
             *p_err_msg = str_buf_printf_with_alloc("Failed to parse gw_cfg.json or no memory");
         }
         os_free(p_gw_cfg_tmp);
-        os_free(download_info.p_json_buf);
+        gw_cfg_json_stream_delete(&p_json_stream);
         return HTTP_RESP_CODE_502;
     }
-    os_free(download_info.p_json_buf);
+    gw_cfg_json_stream_delete(&p_json_stream);
 
     if (!p_gw_cfg_tmp->ruuvi_cfg.remote.use_remote_cfg)
     {
@@ -29,6 +29,11 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Mount the FatFS partition with GWUI, it does nothing if the partition is already mounted.
+ * @param p_fatfs_gwui_partition_name - the name of the partition
+ * @return false if the partition can't be mounted.
+ */
 bool
 http_server_cb_init(const char* const p_fatfs_gwui_partition_name);
 
@@ -490,6 +490,7 @@ leds_task_handle_sig_on_ev_http_poll_timeout(void)
 static void
 leds_task_handle_sig_on_ev_recv_adv(void)
 {
+    event_mgr_ack(EVENT_MGR_EV_RECV_ADV);
     const bool flag_is_in_substate = leds_ctrl_is_in_substate();
     LOG_DBG("LEDS_TASK_SIG_ON_EV_RECV_ADV (ready=%d)", flag_is_in_substate);
     if (flag_is_in_substate)
@@ -42,6 +42,12 @@ static const char TAG[] = "ruuvi_gateway";
 #define MAIN_TASK_LOG_RUNTIME_STAT_PERIOD_MS     (30 * TIME_UNITS_MS_PER_SECOND)
 #define MAIN_TASK_WATCHDOG_FEED_PERIOD_MS        (1 * TIME_UNITS_MS_PER_SECOND)
 
+/**
+ * @brief mDNS is not needed for relaying advertisements, so it's started with a delay after connecting to the network
+ *        to avoid competing with the first HTTP POST / MQTT connection.
+ */
+#define MAIN_TASK_START_MDNS_DELAY_MS (3 * TIME_UNITS_MS_PER_SECOND)
+
 #define RUUVI_NUM_BYTES_IN_1KB (1024U)
 
 typedef enum main_task_sig_e
@@ -66,10 +72,11 @@ typedef enum main_task_sig_e
     MAIN_TASK_SIG_RELAYING_MODE_CHANGED               = OS_SIGNAL_NUM_17,
     MAIN_TASK_SIG_LOG_RUNTIME_STAT                    = OS_SIGNAL_NUM_18,
     MAIN_TASK_SIG_TASK_WATCHDOG_FEED                  = OS_SIGNAL_NUM_19,
+    MAIN_TASK_SIG_START_MDNS                          = OS_SIGNAL_NUM_20,
 } main_task_sig_e;
 
 #define MAIN_TASK_SIG_FIRST (MAIN_TASK_SIG_LOG_HEAP_USAGE)
-#define MAIN_TASK_SIG_LAST  (MAIN_TASK_SIG_TASK_WATCHDOG_FEED)
+#define MAIN_TASK_SIG_LAST  (MAIN_TASK_SIG_START_MDNS)
 
 static os_signal_t* IRAM_ATTR             g_p_signal_main_task;
 static os_signal_static_t                 g_signal_main_task_mem;
@@ -89,6 +96,8 @@ static os_timer_sig_periodic_t* IRAM_ATTR g_p_timer_sig_task_watchdog_feed;
 static os_timer_sig_periodic_static_t     g_timer_sig_task_watchdog_feed_mem;
 static os_timer_sig_one_shot_t* IRAM_ATTR g_p_timer_sig_deferred_ethernet_activation;
 static os_timer_sig_one_shot_static_t     g_timer_sig_deferred_ethernet_activation_mem;
+static os_timer_sig_one_shot_t* IRAM_ATTR g_p_timer_sig_start_mdns;
+static os_timer_sig_one_shot_static_t     g_timer_sig_start_mdns_mem;
 
 static event_mgr_ev_info_static_t g_main_loop_ev_info_mem_wifi_connected;
 static event_mgr_ev_info_static_t g_main_loop_ev_info_mem_eth_connected;
@@ -532,7 +541,9 @@ main_task_handle_sig_network_connected(void)
         settings_write_flag_force_start_wifi_hotspot(FORCE_START_WIFI_HOTSPOT_DISABLED);
     }
 
-    start_mdns();
+    LOG_INFO("Start timer to start mDNS");
+    os_timer_sig_one_shot_stop(g_p_timer_sig_start_mdns);
+    os_timer_sig_one_shot_start(g_p_timer_sig_start_mdns);
 
     gw_cfg_remote_refresh_interval_minutes_t remote_cfg_refresh_interval_minutes = 0;
     const bool  flag_use_remote_cfg = gw_cfg_get_remote_cfg_use(&remote_cfg_refresh_interval_minutes);
@@ -549,6 +560,7 @@ static void
 main_task_handle_sig_network_disconnected(void)
 {
     LOG_INFO("### Handle event: NETWORK_DISCONNECTED");
+    os_timer_sig_one_shot_stop(g_p_timer_sig_start_mdns);
     stop_mdns();
 }
 
@@ -725,6 +737,9 @@ main_task_handle_sig(const main_task_sig_e main_task_sig)
         case MAIN_TASK_SIG_TASK_WATCHDOG_FEED:
             main_task_handle_sig_task_watchdog_feed();
             break;
+        case MAIN_TASK_SIG_START_MDNS:
+            start_mdns();
+            break;
     }
 }
 
@@ -851,6 +866,7 @@ main_task_init_signals(void)
     os_signal_add(g_p_signal_main_task, main_task_conv_to_sig_num(MAIN_TASK_SIG_RELAYING_MODE_CHANGED));
     os_signal_add(g_p_signal_main_task, main_task_conv_to_sig_num(MAIN_TASK_SIG_LOG_RUNTIME_STAT));
     os_signal_add(g_p_signal_main_task, main_task_conv_to_sig_num(MAIN_TASK_SIG_TASK_WATCHDOG_FEED));
+    os_signal_add(g_p_signal_main_task, main_task_conv_to_sig_num(MAIN_TASK_SIG_START_MDNS));
 }
 
 void
@@ -905,6 +921,13 @@ main_task_init_timers(void)
         pdMS_TO_TICKS(
             pdMS_TO_TICKS(RUUVI_DELAY_BEFORE_ETHERNET_ACTIVATION_ON_FIRST_BOOT_SEC * TIME_UNITS_MS_PER_SECOND)));
 
+    g_p_timer_sig_start_mdns = os_timer_sig_one_shot_create_static(
+        &g_timer_sig_start_mdns_mem,
+        "start_mdns",
+        g_p_signal_main_task,
+        main_task_conv_to_sig_num(MAIN_TASK_SIG_START_MDNS),
+        pdMS_TO_TICKS(MAIN_TASK_START_MDNS_DELAY_MS));
+
     g_p_timer_sig_task_watchdog_feed = os_timer_sig_periodic_create_static(
         &g_timer_sig_task_watchdog_feed_mem,
         "main_wgod",
@@ -8,6 +8,7 @@
 #include "metrics.h"
 #include <inttypes.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <esp_attr.h>
 #include "esp_heap_caps.h"
 #include "esp32/rom/crc.h"
@@ -21,6 +22,10 @@
 #include "fw_ver.h"
 #include "cjson_wrap.h"
 #include "gw_cfg_ruuvi_json.h"
+#include "adv_ring.h"
+#include "adv_spool.h"
+#include "adv_table.h"
+#include "event_mgr.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
 
@@ -90,6 +95,43 @@ typedef struct metrics_sha256_str_t
     char buf[(METRICS_SHA256_SIZE * 2) + 1];
 } metrics_sha256_str_t;
 
+#define METRICS_LATENCY_NUM_BUCKETS (12)
+
+/**
+ * @brief Histogram of latencies (MQTT publication, HTTP POST duration, pipeline stages).
+ */
+typedef struct metrics_latency_hist_t
+{
+    uint32_t bucket_cnt[METRICS_LATENCY_NUM_BUCKETS + 1]; //<! Non-cumulative counters, the last is +Inf
+    uint64_t sum;                                         //<! Sum in the units of the bucket bounds (ms or us)
+    uint32_t count;
+} metrics_latency_hist_t;
+
+/**
+ * @brief Statistics of the connections of the async HTTP POSTs (see HTTP_KEEP_ALIVE_MAX_IDLE_TIME_MS).
+ */
+typedef struct metrics_http_conn_stat_t
+{
+    uint32_t handshake_cnt;         //<! Number of new connections
+    uint32_t reused_cnt;            //<! Number of requests sent over the kept alive connections
+    uint64_t handshake_time_sum_ms; //<! Total time of establishing the new connections
+} metrics_http_conn_stat_t;
+
+/**
+ * @brief Timestamps (since boot) of the boot stage, both are zero if the stage has not been started yet.
+ */
+typedef struct metrics_boot_stage_time_t
+{
+    int64_t begin_us;
+    int64_t end_us;
+} metrics_boot_stage_time_t;
+
+typedef struct metrics_boot_info_t
+{
+    metrics_boot_stage_time_t stage[METRICS_BOOT_STAGE_NUM];
+    int64_t                   first_adv_relayed_us;
+} metrics_boot_info_t;
+
 typedef struct metrics_info_t
 {
     uint64_t                    received_advertisements;
@@ -99,6 +141,20 @@ typedef struct metrics_info_t
     uint32_t                    nrf_self_reboot_cnt;
     uint32_t                    nrf_ext_hw_reset_cnt;
     uint64_t                    nrf_lost_ack_cnt;
+    uint32_t                    adv_ring_high_water_mark;
+    uint32_t                    adv_ring_overflow_cnt;
+    uint32_t                    adv_table_no_mem_drop_cnt;
+    uint32_t                    recv_adv_suppressed_notify_cnt;
+    adv_spool_stat_t            adv_spool;
+    metrics_latency_hist_t      mqtt_publish_latency[METRICS_MQTT_PUBLISH_MODE_NUM];
+    metrics_latency_hist_t      http_post_duration[METRICS_HTTP_TARGET_NUM];
+    metrics_http_conn_stat_t    http_conn;
+    metrics_boot_info_t         boot;
+#if METRICS_PIPELINE_ENABLED
+    metrics_latency_hist_t               stage_time[METRICS_STAGE_NUM];
+    uint32_t                             pipeline_cnt[METRICS_PIPELINE_CNT_NUM];
+    adv_table_retransmission_lists_len_t retransmission_lists_len;
+#endif
     metrics_total_free_info_t   total_free_bytes;
     metrics_largest_free_info_t largest_free_block;
     mac_address_str_t           mac_addr_str;
@@ -110,12 +166,18 @@ typedef struct metrics_info_t
     metrics_sha256_str_t        ruuvi_json_sha256;
 } metrics_info_t;
 
+typedef struct metrics_gw_cfg_hash_t
+{
+    bool                 flag_valid; //<! false until the hashes are calculated for the current gw_cfg
+    metrics_crc32_str_t  gw_cfg_crc32;
+    metrics_sha256_str_t gw_cfg_sha256;
+    metrics_crc32_str_t  ruuvi_json_crc32;
+    metrics_sha256_str_t ruuvi_json_sha256;
+} metrics_gw_cfg_hash_t;
+
 typedef struct metrics_tmp_buf_t
 {
-    metrics_crc32_str_t    gw_cfg_crc32_str;
-    metrics_sha256_str_t   gw_cfg_sha256_str;
-    metrics_crc32_str_t    ruuvi_json_crc32_str;
-    metrics_sha256_str_t   ruuvi_json_sha256_str;
+    metrics_gw_cfg_hash_t  hash;
     metrics_sha256_t       tmp_sha256;
     mbedtls_sha256_context tmp_sha256_ctx;
 } metrics_tmp_buf_t;
@@ -131,6 +193,61 @@ static uint32_t IRAM_ATTR   g_nrf_ext_hw_reset_cnt;
 static os_mutex_t IRAM_ATTR g_p_metrics_mutex;
 static os_mutex_static_t    g_metrics_mutex_mem;
 
+static metrics_latency_hist_t   g_mqtt_publish_latency[METRICS_MQTT_PUBLISH_MODE_NUM];
+static metrics_latency_hist_t   g_http_post_duration[METRICS_HTTP_TARGET_NUM];
+static metrics_http_conn_stat_t g_http_conn_stat;
+static metrics_gw_cfg_hash_t    g_metrics_gw_cfg_hash;
+static metrics_boot_info_t      g_metrics_boot_info;
+#if METRICS_PIPELINE_ENABLED
+static metrics_latency_hist_t g_metrics_stage_time[METRICS_STAGE_NUM];
+static atomic_uint            g_metrics_pipeline_cnt[METRICS_PIPELINE_CNT_NUM];
+#endif
+
+static const uint32_t g_metrics_latency_buckets_ms[METRICS_LATENCY_NUM_BUCKETS] = {
+    10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000, 60000,
+};
+
+#if METRICS_PIPELINE_ENABLED
+static const uint32_t g_metrics_stage_time_buckets_us[METRICS_LATENCY_NUM_BUCKETS] = {
+    10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 100000,
+};
+
+static const char* const g_metrics_stage_names[METRICS_STAGE_NUM] = {
+    [METRICS_STAGE_UART_PARSE]    = "uart_parse",
+    [METRICS_STAGE_JSON_GEN_HTTP] = "json_gen_http",
+    [METRICS_STAGE_JSON_GEN_MQTT] = "json_gen_mqtt",
+    [METRICS_STAGE_HMAC]          = "hmac",
+};
+
+static const char* const g_metrics_pipeline_cnt_names[METRICS_PIPELINE_CNT_NUM] = {
+    [METRICS_PIPELINE_CNT_UART_PARSE_ERR]    = "uart_parse_err_cnt",
+    [METRICS_PIPELINE_CNT_FILTER_DROPPED]    = "filter_dropped_cnt",
+    [METRICS_PIPELINE_CNT_ADV_TABLE_DEDUP]   = "adv_table_dedup_cnt",
+    [METRICS_PIPELINE_CNT_ADV_TABLE_EVICTED] = "adv_table_evicted_cnt",
+};
+#endif
+
+static const char* const g_metrics_boot_stage_names[METRICS_BOOT_STAGE_NUM] = {
+    [METRICS_BOOT_STAGE_NVS_INIT]        = "nvs_init",
+    [METRICS_BOOT_STAGE_GW_CFG_INIT]     = "gw_cfg_init",
+    [METRICS_BOOT_STAGE_GWUI_MOUNT]      = "gwui_mount",
+    [METRICS_BOOT_STAGE_NRF52_FW_CHECK]  = "nrf52_fw_check",
+    [METRICS_BOOT_STAGE_ADV_POST_INIT]   = "adv_post_init",
+    [METRICS_BOOT_STAGE_NRF52_DEVICE_ID] = "nrf52_device_id",
+    [METRICS_BOOT_STAGE_NETWORK_INIT]    = "network_init",
+};
+
+static const char* const g_mqtt_publish_mode_names[METRICS_MQTT_PUBLISH_MODE_NUM] = {
+    [METRICS_MQTT_PUBLISH_MODE_INSTANT]  = "instant",
+    [METRICS_MQTT_PUBLISH_MODE_PERIODIC] = "periodic",
+};
+
+static const char* const g_http_target_names[METRICS_HTTP_TARGET_NUM] = {
+    [METRICS_HTTP_TARGET_RUUVI]  = "ruuvi",
+    [METRICS_HTTP_TARGET_CUSTOM] = "custom",
+    [METRICS_HTTP_TARGET_STATS]  = "stats",
+};
+
 void
 metrics_init(void)
 {
@@ -140,7 +257,19 @@ metrics_init(void)
     g_nrf_lost_ack_cnt              = 0;
     g_nrf_self_reboot_cnt           = 0;
     g_nrf_ext_hw_reset_cnt          = 0;
-    g_p_metrics_mutex               = os_mutex_create_static(&g_metrics_mutex_mem);
+    memset(g_mqtt_publish_latency, 0, sizeof(g_mqtt_publish_latency));
+    memset(g_http_post_duration, 0, sizeof(g_http_post_duration));
+    memset(&g_http_conn_stat, 0, sizeof(g_http_conn_stat));
+    memset(&g_metrics_gw_cfg_hash, 0, sizeof(g_metrics_gw_cfg_hash));
+    memset(&g_metrics_boot_info, 0, sizeof(g_metrics_boot_info));
+#if METRICS_PIPELINE_ENABLED
+    memset(g_metrics_stage_time, 0, sizeof(g_metrics_stage_time));
+    for (uint32_t i = 0; i < METRICS_PIPELINE_CNT_NUM; ++i)
+    {
+        atomic_store(&g_metrics_pipeline_cnt[i], 0U);
+    }
+#endif
+    g_p_metrics_mutex = os_mutex_create_static(&g_metrics_mutex_mem);
 }
 
 void
@@ -301,6 +430,153 @@ metrics_malloc_cap_to_caps(const metrics_malloc_cap_e malloc_cap)
     return 0; // Should not happen
 }
 
+static void
+metrics_latency_hist_add(
+    metrics_latency_hist_t* const p_hist,
+    const uint32_t* const         p_buckets,
+    const uint32_t                latency)
+{
+    uint32_t bucket_idx = 0;
+    while ((bucket_idx < METRICS_LATENCY_NUM_BUCKETS) && (latency > p_buckets[bucket_idx]))
+    {
+        bucket_idx += 1;
+    }
+    metrics_lock();
+    p_hist->bucket_cnt[bucket_idx] += 1;
+    p_hist->sum += latency;
+    p_hist->count += 1;
+    metrics_unlock();
+}
+
+void
+metrics_mqtt_publish_latency_add(const metrics_mqtt_publish_mode_e mode, const uint32_t latency_ms)
+{
+    if ((uint32_t)mode >= METRICS_MQTT_PUBLISH_MODE_NUM)
+    {
+        return;
+    }
+    metrics_latency_hist_add(&g_mqtt_publish_latency[mode], g_metrics_latency_buckets_ms, latency_ms);
+}
+
+void
+metrics_http_post_duration_add(const metrics_http_target_e target, const uint32_t duration_ms)
+{
+    if ((uint32_t)target >= METRICS_HTTP_TARGET_NUM)
+    {
+        return;
+    }
+    metrics_latency_hist_add(&g_http_post_duration[target], g_metrics_latency_buckets_ms, duration_ms);
+}
+
+void
+metrics_http_conn_handshake_add(const uint32_t handshake_time_ms)
+{
+    metrics_lock();
+    g_http_conn_stat.handshake_cnt += 1;
+    g_http_conn_stat.handshake_time_sum_ms += handshake_time_ms;
+    metrics_unlock();
+}
+
+void
+metrics_http_conn_reused_inc(void)
+{
+    metrics_lock();
+    g_http_conn_stat.reused_cnt += 1;
+    metrics_unlock();
+}
+
+const char*
+metrics_boot_stage_get_name(const metrics_boot_stage_e stage)
+{
+    if ((uint32_t)stage >= METRICS_BOOT_STAGE_NUM)
+    {
+        return "unknown";
+    }
+    return g_metrics_boot_stage_names[stage];
+}
+
+void
+metrics_boot_stage_begin(const metrics_boot_stage_e stage)
+{
+    if ((uint32_t)stage >= METRICS_BOOT_STAGE_NUM)
+    {
+        return;
+    }
+    const int64_t cur_time_us = esp_timer_get_time();
+    metrics_lock();
+    g_metrics_boot_info.stage[stage].begin_us = cur_time_us;
+    g_metrics_boot_info.stage[stage].end_us   = 0;
+    metrics_unlock();
+}
+
+void
+metrics_boot_stage_end(const metrics_boot_stage_e stage)
+{
+    if ((uint32_t)stage >= METRICS_BOOT_STAGE_NUM)
+    {
+        return;
+    }
+    const int64_t cur_time_us = esp_timer_get_time();
+    metrics_lock();
+    g_metrics_boot_info.stage[stage].end_us = cur_time_us;
+    metrics_unlock();
+}
+
+void
+metrics_boot_first_adv_relayed(void)
+{
+    const int64_t cur_time_us = esp_timer_get_time();
+    metrics_lock();
+    if (0 == g_metrics_boot_info.first_adv_relayed_us)
+    {
+        g_metrics_boot_info.first_adv_relayed_us = cur_time_us;
+    }
+    metrics_unlock();
+}
+
+#if METRICS_PIPELINE_ENABLED
+void
+metrics_stage_time_add(const metrics_stage_e stage, const uint32_t time_us)
+{
+    if ((uint32_t)stage >= METRICS_STAGE_NUM)
+    {
+        return;
+    }
+    metrics_latency_hist_add(&g_metrics_stage_time[stage], g_metrics_stage_time_buckets_us, time_us);
+}
+
+void
+metrics_pipeline_cnt_inc(const metrics_pipeline_cnt_e cnt)
+{
+    if ((uint32_t)cnt >= METRICS_PIPELINE_CNT_NUM)
+    {
+        return;
+    }
+    atomic_fetch_add(&g_metrics_pipeline_cnt[cnt], 1U);
+}
+#endif
+
+static void
+metrics_latency_hist_get(metrics_info_t* const p_metrics)
+{
+    metrics_lock();
+    memcpy(p_metrics->mqtt_publish_latency, g_mqtt_publish_latency, sizeof(g_mqtt_publish_latency));
+    memcpy(p_metrics->http_post_duration, g_http_post_duration, sizeof(g_http_post_duration));
+    p_metrics->http_conn = g_http_conn_stat;
+    p_metrics->boot      = g_metrics_boot_info;
+#if METRICS_PIPELINE_ENABLED
+    memcpy(p_metrics->stage_time, g_metrics_stage_time, sizeof(g_metrics_stage_time));
+#endif
+    metrics_unlock();
+#if METRICS_PIPELINE_ENABLED
+    for (uint32_t i = 0; i < METRICS_PIPELINE_CNT_NUM; ++i)
+    {
+        p_metrics->pipeline_cnt[i] = (uint32_t)atomic_load(&g_metrics_pipeline_cnt[i]);
+    }
+    adv_table_get_retransmission_lists_len(&p_metrics->retransmission_lists_len);
+#endif
+}
+
 uint32_t
 metrics_get_total_free_bytes(const metrics_malloc_cap_e malloc_cap)
 {
@@ -347,7 +623,7 @@ metrics_calc_gw_cfg_hash(
     }
 }
 
-static void
+static bool
 metrics_calc_ruuvi_json_hash(
     metrics_crc32_str_t* const    p_crc32,
     metrics_sha256_str_t* const   p_sha256,
@@ -362,7 +638,7 @@ metrics_calc_ruuvi_json_hash(
     if (!gw_cfg_ruuvi_json_generate(p_gw_cfg, &json_str))
     {
         gw_cfg_unlock_ro(&p_gw_cfg);
-        return;
+        return false;
     }
     gw_cfg_unlock_ro(&p_gw_cfg);
 
@@ -384,40 +660,91 @@ metrics_calc_ruuvi_json_hash(
     {
         str_buf_printf(&str_buf, "%02x", p_tmp_sha256->buf[i]);
     }
+    return true;
 }
 
-static metrics_info_t*
-gen_metrics(void)
+void
+metrics_gw_cfg_hash_update(void)
 {
+    // gw_cfg is kept locked until the hashes are saved to make sure that the cache is not overwritten
+    // by the hashes of the previous configuration (the gw_cfg mutex is recursive, so it's safe to call this function
+    // from the gw_cfg change callback).
+    const gw_cfg_t* p_gw_cfg = gw_cfg_lock_ro();
+
     metrics_tmp_buf_t* p_tmp_buf = os_calloc(1, sizeof(*p_tmp_buf));
     if (NULL == p_tmp_buf)
     {
-        return NULL;
-    }
-    metrics_info_t* p_metrics = os_calloc(1, sizeof(*p_metrics));
-    if (NULL == p_metrics)
-    {
-        os_free(p_tmp_buf);
-        return NULL;
+        LOG_ERR("Can't allocate memory");
+        metrics_lock();
+        g_metrics_gw_cfg_hash.flag_valid = false;
+        metrics_unlock();
+        gw_cfg_unlock_ro(&p_gw_cfg);
+        return;
     }
 
     metrics_calc_gw_cfg_hash(
-        &p_tmp_buf->gw_cfg_crc32_str,
-        &p_tmp_buf->gw_cfg_sha256_str,
+        &p_tmp_buf->hash.gw_cfg_crc32,
+        &p_tmp_buf->hash.gw_cfg_sha256,
         &p_tmp_buf->tmp_sha256,
         &p_tmp_buf->tmp_sha256_ctx);
-    metrics_calc_ruuvi_json_hash(
-        &p_tmp_buf->ruuvi_json_crc32_str,
-        &p_tmp_buf->ruuvi_json_sha256_str,
+    // If ruuvi.json can't be generated (out of memory), then the hashes will be recalculated on the next request.
+    p_tmp_buf->hash.flag_valid = metrics_calc_ruuvi_json_hash(
+        &p_tmp_buf->hash.ruuvi_json_crc32,
+        &p_tmp_buf->hash.ruuvi_json_sha256,
         &p_tmp_buf->tmp_sha256,
         &p_tmp_buf->tmp_sha256_ctx);
 
+    metrics_lock();
+    g_metrics_gw_cfg_hash = p_tmp_buf->hash;
+    metrics_unlock();
+
+    gw_cfg_unlock_ro(&p_gw_cfg);
+
+    os_free(p_tmp_buf);
+}
+
+static void
+metrics_gw_cfg_hash_get(metrics_info_t* const p_metrics)
+{
+    metrics_lock();
+    bool flag_valid = g_metrics_gw_cfg_hash.flag_valid;
+    metrics_unlock();
+
+    if (!flag_valid)
+    {
+        // The hashes have not been calculated yet (gw_cfg change callback is not registered or not called yet).
+        metrics_gw_cfg_hash_update();
+    }
+
+    metrics_lock();
+    p_metrics->gw_cfg_crc32      = g_metrics_gw_cfg_hash.gw_cfg_crc32;
+    p_metrics->gw_cfg_sha256     = g_metrics_gw_cfg_hash.gw_cfg_sha256;
+    p_metrics->ruuvi_json_crc32  = g_metrics_gw_cfg_hash.ruuvi_json_crc32;
+    p_metrics->ruuvi_json_sha256 = g_metrics_gw_cfg_hash.ruuvi_json_sha256;
+    metrics_unlock();
+}
+
+static metrics_info_t*
+gen_metrics(void)
+{
+    metrics_info_t* p_metrics = os_calloc(1, sizeof(*p_metrics));
+    if (NULL == p_metrics)
+    {
+        return NULL;
+    }
+
     p_metrics->received_advertisements        = metrics_received_advs_get();
     p_metrics->received_ext_advertisements    = metrics_received_ext_advs_get();
     p_metrics->received_coded_advertisements  = metrics_received_coded_advs_get();
     p_metrics->nrf_self_reboot_cnt            = metrics_nrf_self_reboot_cnt_get();
     p_metrics->nrf_ext_hw_reset_cnt           = metrics_nrf_ext_hw_reset_cnt_get();
     p_metrics->nrf_lost_ack_cnt               = metrics_nrf_lost_ack_cnt_get();
+    p_metrics->adv_ring_high_water_mark       = adv_ring_get_high_water_mark();
+    p_metrics->adv_ring_overflow_cnt          = adv_ring_get_overflow_cnt();
+    p_metrics->adv_table_no_mem_drop_cnt      = adv_table_get_no_mem_drop_cnt();
+    p_metrics->recv_adv_suppressed_notify_cnt = event_mgr_get_num_suppressed_notifications(EVENT_MGR_EV_RECV_ADV);
+    adv_spool_get_stat(&p_metrics->adv_spool);
+    metrics_latency_hist_get(p_metrics);
     p_metrics->uptime_us                      = esp_timer_get_time();
     p_metrics->total_free_bytes.size_exec     = (ulong_t)metrics_get_total_free_bytes(METRICS_MALLOC_CAP_EXEC);
     p_metrics->total_free_bytes.size_32bit    = (ulong_t)metrics_get_total_free_bytes(METRICS_MALLOC_CAP_32BIT);
@@ -449,16 +776,180 @@ gen_metrics(void)
     p_metrics->mac_addr_str                     = *gw_cfg_get_nrf52_mac_addr();
     p_metrics->esp_fw                           = *gw_cfg_get_esp32_fw_ver();
     p_metrics->nrf_fw                           = *gw_cfg_get_nrf52_fw_ver();
-    p_metrics->gw_cfg_crc32                     = p_tmp_buf->gw_cfg_crc32_str;
-    p_metrics->gw_cfg_sha256                    = p_tmp_buf->gw_cfg_sha256_str;
-    p_metrics->ruuvi_json_crc32                 = p_tmp_buf->ruuvi_json_crc32_str;
-    p_metrics->ruuvi_json_sha256                = p_tmp_buf->ruuvi_json_sha256_str;
-
-    os_free(p_tmp_buf);
+    metrics_gw_cfg_hash_get(p_metrics);
 
     return p_metrics;
 }
 
+static void
+metrics_print_adv_spool(str_buf_t* p_str_buf, const metrics_info_t* p_metrics)
+{
+    str_buf_printf(p_str_buf, METRICS_PREFIX "adv_spool_size_bytes %" PRIu32 "\n", p_metrics->adv_spool.size_bytes);
+    str_buf_printf(p_str_buf, METRICS_PREFIX "adv_spool_used_bytes %" PRIu32 "\n", p_metrics->adv_spool.used_bytes);
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "adv_spool_stored_advs %" PRIu32 "\n",
+        p_metrics->adv_spool.num_stored_advs);
+    str_buf_printf(p_str_buf, METRICS_PREFIX "adv_spool_sent_advs %" PRIu32 "\n", p_metrics->adv_spool.num_sent_advs);
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "adv_spool_dropped_advs %" PRIu32 "\n",
+        p_metrics->adv_spool.num_dropped_advs);
+}
+
+/**
+ * @brief Print the histogram in Prometheus format, p_label is the label of the time series, e.g. mode="instant".
+ */
+static void
+metrics_print_latency_hist(
+    str_buf_t*                          p_str_buf,
+    const char* const                   p_name,
+    const char* const                   p_label,
+    const uint32_t* const               p_buckets,
+    const metrics_latency_hist_t* const p_hist)
+{
+    uint32_t cumulative = 0;
+    for (uint32_t i = 0; i < METRICS_LATENCY_NUM_BUCKETS; ++i)
+    {
+        cumulative += p_hist->bucket_cnt[i];
+        str_buf_printf(
+            p_str_buf,
+            METRICS_PREFIX "%s_bucket{%s,le=\"%" PRIu32 "\"} %" PRIu32 "\n",
+            p_name,
+            p_label,
+            p_buckets[i],
+            cumulative);
+    }
+    cumulative += p_hist->bucket_cnt[METRICS_LATENCY_NUM_BUCKETS];
+    str_buf_printf(p_str_buf, METRICS_PREFIX "%s_bucket{%s,le=\"+Inf\"} %" PRIu32 "\n", p_name, p_label, cumulative);
+    str_buf_printf(p_str_buf, METRICS_PREFIX "%s_sum{%s} %" PRIu64 "\n", p_name, p_label, p_hist->sum);
+    str_buf_printf(p_str_buf, METRICS_PREFIX "%s_count{%s} %" PRIu32 "\n", p_name, p_label, p_hist->count);
+}
+
+static void
+metrics_print_mqtt_publish_latency(str_buf_t* p_str_buf, const metrics_info_t* p_metrics)
+{
+    for (uint32_t mode = 0; mode < METRICS_MQTT_PUBLISH_MODE_NUM; ++mode)
+    {
+        char label[32];
+        (void)snprintf(label, sizeof(label), "mode=\"%s\"", g_mqtt_publish_mode_names[mode]);
+        metrics_print_latency_hist(
+            p_str_buf,
+            "mqtt_publish_latency_ms",
+            label,
+            g_metrics_latency_buckets_ms,
+            &p_metrics->mqtt_publish_latency[mode]);
+    }
+}
+
+static void
+metrics_print_http_post_duration(str_buf_t* p_str_buf, const metrics_info_t* p_metrics)
+{
+    for (uint32_t target = 0; target < METRICS_HTTP_TARGET_NUM; ++target)
+    {
+        char label[32];
+        (void)snprintf(label, sizeof(label), "target=\"%s\"", g_http_target_names[target]);
+        metrics_print_latency_hist(
+            p_str_buf,
+            "http_post_duration_ms",
+            label,
+            g_metrics_latency_buckets_ms,
+            &p_metrics->http_post_duration[target]);
+    }
+}
+
+static void
+metrics_print_http_conn(str_buf_t* p_str_buf, const metrics_info_t* p_metrics)
+{
+    const metrics_http_conn_stat_t* const p_stat = &p_metrics->http_conn;
+
+    const uint32_t num_req               = p_stat->handshake_cnt + p_stat->reused_cnt;
+    uint32_t       reuse_ratio_milli     = 0;
+    uint32_t       handshake_time_avg_ms = 0;
+    if (0 != num_req)
+    {
+        reuse_ratio_milli = (uint32_t)(((uint64_t)p_stat->reused_cnt * 1000U) / num_req);
+    }
+    if (0 != p_stat->handshake_cnt)
+    {
+        handshake_time_avg_ms = (uint32_t)(p_stat->handshake_time_sum_ms / p_stat->handshake_cnt);
+    }
+    str_buf_printf(p_str_buf, METRICS_PREFIX "http_conn_handshake_cnt %" PRIu32 "\n", p_stat->handshake_cnt);
+    str_buf_printf(p_str_buf, METRICS_PREFIX "http_conn_reused_cnt %" PRIu32 "\n", p_stat->reused_cnt);
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "http_conn_reuse_ratio %" PRIu32 ".%03" PRIu32 "\n",
+        reuse_ratio_milli / 1000U,
+        reuse_ratio_milli % 1000U);
+    str_buf_printf(p_str_buf, METRICS_PREFIX "http_conn_handshake_time_ms_avg %" PRIu32 "\n", handshake_time_avg_ms);
+}
+
+static void
+metrics_print_boot_stages(str_buf_t* p_str_buf, const metrics_info_t* p_metrics)
+{
+    for (uint32_t stage = 0; stage < METRICS_BOOT_STAGE_NUM; ++stage)
+    {
+        const metrics_boot_stage_time_t* const p_stage_time = &p_metrics->boot.stage[stage];
+
+        const int64_t duration_us = (p_stage_time->end_us >= p_stage_time->begin_us)
+                                        ? (p_stage_time->end_us - p_stage_time->begin_us)
+                                        : 0;
+        str_buf_printf(
+            p_str_buf,
+            METRICS_PREFIX "boot_stage_begin_us{stage=\"%s\"} %lld\n",
+            g_metrics_boot_stage_names[stage],
+            (printf_long_long_t)p_stage_time->begin_us);
+        str_buf_printf(
+            p_str_buf,
+            METRICS_PREFIX "boot_stage_duration_us{stage=\"%s\"} %lld\n",
+            g_metrics_boot_stage_names[stage],
+            (printf_long_long_t)duration_us);
+    }
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "boot_first_adv_relayed_us %lld\n",
+        (printf_long_long_t)p_metrics->boot.first_adv_relayed_us);
+}
+
+#if METRICS_PIPELINE_ENABLED
+static void
+metrics_print_pipeline(str_buf_t* p_str_buf, const metrics_info_t* p_metrics)
+{
+    for (uint32_t stage = 0; stage < METRICS_STAGE_NUM; ++stage)
+    {
+        char label[32];
+        (void)snprintf(label, sizeof(label), "stage=\"%s\"", g_metrics_stage_names[stage]);
+        metrics_print_latency_hist(
+            p_str_buf,
+            "pipeline_stage_time_us",
+            label,
+            g_metrics_stage_time_buckets_us,
+            &p_metrics->stage_time[stage]);
+    }
+    for (uint32_t cnt = 0; cnt < METRICS_PIPELINE_CNT_NUM; ++cnt)
+    {
+        str_buf_printf(
+            p_str_buf,
+            METRICS_PREFIX "pipeline_%s %" PRIu32 "\n",
+            g_metrics_pipeline_cnt_names[cnt],
+            p_metrics->pipeline_cnt[cnt]);
+    }
+    const adv_table_retransmission_lists_len_t* const p_lists_len = &p_metrics->retransmission_lists_len;
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "pipeline_queue_depth{list=\"http_ruuvi\"} %" PRIu32 "\n",
+        (uint32_t)p_lists_len->http_ruuvi);
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "pipeline_queue_depth{list=\"http_custom\"} %" PRIu32 "\n",
+        (uint32_t)p_lists_len->http_custom);
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "pipeline_queue_depth{list=\"mqtt\"} %" PRIu32 "\n",
+        (uint32_t)p_lists_len->mqtt);
+}
+#endif
+
 static void
 metrics_print_total_free_bytes(str_buf_t* p_str_buf, const metrics_info_t* p_metrics)
 {
@@ -615,6 +1106,27 @@ metrics_print(str_buf_t* p_str_buf, const metrics_info_t* p_metrics)
     str_buf_printf(p_str_buf, METRICS_PREFIX "nrf_self_reboot_cnt %" PRIu32 "\n", p_metrics->nrf_self_reboot_cnt);
     str_buf_printf(p_str_buf, METRICS_PREFIX "nrf_ext_hw_reset_cnt %" PRIu32 "\n", p_metrics->nrf_ext_hw_reset_cnt);
     str_buf_printf(p_str_buf, METRICS_PREFIX "nrf_lost_ack_cnt %" PRIu64 "\n", p_metrics->nrf_lost_ack_cnt);
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "adv_ring_high_water_mark %" PRIu32 "\n",
+        p_metrics->adv_ring_high_water_mark);
+    str_buf_printf(p_str_buf, METRICS_PREFIX "adv_ring_overflow_cnt %" PRIu32 "\n", p_metrics->adv_ring_overflow_cnt);
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "adv_table_no_mem_drop_cnt %" PRIu32 "\n",
+        p_metrics->adv_table_no_mem_drop_cnt);
+    str_buf_printf(
+        p_str_buf,
+        METRICS_PREFIX "recv_adv_suppressed_notify_cnt %" PRIu32 "\n",
+        p_metrics->recv_adv_suppressed_notify_cnt);
+    metrics_print_adv_spool(p_str_buf, p_metrics);
+    metrics_print_mqtt_publish_latency(p_str_buf, p_metrics);
+    metrics_print_http_post_duration(p_str_buf, p_metrics);
+    metrics_print_http_conn(p_str_buf, p_metrics);
+    metrics_print_boot_stages(p_str_buf, p_metrics);
+#if METRICS_PIPELINE_ENABLED
+    metrics_print_pipeline(p_str_buf, p_metrics);
+#endif
     metrics_print_total_free_bytes(p_str_buf, p_metrics);
     metrics_print_largest_free_blk(p_str_buf, p_metrics);
     metrics_print_gwinfo(p_str_buf, p_metrics);
@@ -632,6 +1144,7 @@ metrics_generate(void)
     if (!str_buf_init_with_alloc(&str_buf))
     {
         LOG_ERR("Can't allocate memory");
+        os_free(p_metrics_info);
         return NULL;
     }
     metrics_print(&str_buf, p_metrics_info);
@@ -46,6 +46,154 @@ metrics_nrf_lost_ack_cnt_get(void);
 void
 metrics_nrf_lost_ack_cnt_inc(void);
 
+typedef enum metrics_mqtt_publish_mode_e
+{
+    METRICS_MQTT_PUBLISH_MODE_INSTANT,
+    METRICS_MQTT_PUBLISH_MODE_PERIODIC,
+} metrics_mqtt_publish_mode_e;
+
+#define METRICS_MQTT_PUBLISH_MODE_NUM (2)
+
+/**
+ * @brief Add the latency between receiving the advertisement from nRF52 and its MQTT publication to the histogram.
+ * @param mode - the MQTT publication mode
+ * @param latency_ms - the latency in milliseconds
+ */
+void
+metrics_mqtt_publish_latency_add(const metrics_mqtt_publish_mode_e mode, const uint32_t latency_ms);
+
+typedef enum metrics_http_target_e
+{
+    METRICS_HTTP_TARGET_RUUVI,
+    METRICS_HTTP_TARGET_CUSTOM,
+    METRICS_HTTP_TARGET_STATS,
+} metrics_http_target_e;
+
+#define METRICS_HTTP_TARGET_NUM (3)
+
+/**
+ * @brief Add the duration of the async HTTP POST (from sending the request to receiving the response) to the histogram.
+ * @param target - the HTTP target
+ * @param duration_ms - the duration in milliseconds
+ */
+void
+metrics_http_post_duration_add(const metrics_http_target_e target, const uint32_t duration_ms);
+
+/**
+ * @brief Count a new connection of the async HTTP POST (DNS lookup, TCP connection and TLS handshake for HTTPS).
+ * @param handshake_time_ms - the time from sending the request to establishing the connection in milliseconds
+ */
+void
+metrics_http_conn_handshake_add(const uint32_t handshake_time_ms);
+
+/**
+ * @brief Count the async HTTP POST which is sent over the connection kept alive after the previous request.
+ */
+void
+metrics_http_conn_reused_inc(void);
+
+typedef enum metrics_boot_stage_e
+{
+    METRICS_BOOT_STAGE_NVS_INIT,        //<! Initializing NVS and checking the settings in it
+    METRICS_BOOT_STAGE_GW_CFG_INIT,     //<! Reading gw_cfg from NVS before nRF52 is started
+    METRICS_BOOT_STAGE_GWUI_MOUNT,      //<! Mounting FatFS partition with GWUI (runs in parallel with nRF52 check)
+    METRICS_BOOT_STAGE_NRF52_FW_CHECK,  //<! Checking (and updating if necessary) the firmware on nRF52
+    METRICS_BOOT_STAGE_ADV_POST_INIT,   //<! Starting adv_post and waiting until nRF52 leaves hw_reset state
+    METRICS_BOOT_STAGE_NRF52_DEVICE_ID, //<! Requesting DEVICE ID from nRF52 and re-initializing gw_cfg with it
+    METRICS_BOOT_STAGE_NETWORK_INIT,    //<! Starting Wi-Fi, Ethernet and HTTP server
+} metrics_boot_stage_e;
+
+#define METRICS_BOOT_STAGE_NUM (7)
+
+/**
+ * @brief Get the name of the boot stage which is used as the label in /metrics.
+ * @param stage - the boot stage
+ * @return ptr to the name.
+ */
+const char*
+metrics_boot_stage_get_name(const metrics_boot_stage_e stage);
+
+/**
+ * @brief Save the time (since boot) when the boot stage was started.
+ * @param stage - the boot stage
+ */
+void
+metrics_boot_stage_begin(const metrics_boot_stage_e stage);
+
+/**
+ * @brief Save the time (since boot) when the boot stage was finished.
+ * @param stage - the boot stage
+ */
+void
+metrics_boot_stage_end(const metrics_boot_stage_e stage);
+
+/**
+ * @brief Save the time (since boot) when the first advertisement was relayed (only the first call is taken).
+ */
+void
+metrics_boot_first_adv_relayed(void);
+
+#if !defined(METRICS_PIPELINE_ENABLED)
+/**
+ * @brief Enable the per-stage time histograms and the counters of the adv processing pipeline in /metrics.
+ * @note If it's disabled, then the instrumentation is compiled out completely.
+ * @note It's configured by RUUVI_METRICS_PIPELINE in the top-level CMakeLists.txt.
+ */
+#define METRICS_PIPELINE_ENABLED (0)
+#endif
+
+typedef enum metrics_stage_e
+{
+    METRICS_STAGE_UART_PARSE,    //<! Parsing the advertisement received from nRF52 via UART
+    METRICS_STAGE_JSON_GEN_HTTP, //<! Generating JSON for HTTP POST (with HMAC and gzip calculated on the fly)
+    METRICS_STAGE_JSON_GEN_MQTT, //<! Generating JSON for MQTT publication
+    METRICS_STAGE_HMAC,          //<! Calculating HMAC of the already generated body of HTTP POST
+} metrics_stage_e;
+
+#define METRICS_STAGE_NUM (4)
+
+typedef enum metrics_pipeline_cnt_e
+{
+    METRICS_PIPELINE_CNT_UART_PARSE_ERR,    //<! Advertisements dropped because of the parsing errors
+    METRICS_PIPELINE_CNT_FILTER_DROPPED,    //<! Advertisements dropped by the MAC filter
+    METRICS_PIPELINE_CNT_ADV_TABLE_DEDUP,   //<! Advertisements discarded by adv_table as duplicates
+    METRICS_PIPELINE_CNT_ADV_TABLE_EVICTED, //<! Tags evicted from adv_table to make room for new tags
+} metrics_pipeline_cnt_e;
+
+#define METRICS_PIPELINE_CNT_NUM (4)
+
+#if METRICS_PIPELINE_ENABLED
+
+#include "esp_timer.h"
+
+/**
+ * @brief Add the time of the pipeline stage to the histogram.
+ * @param stage - the pipeline stage
+ * @param time_us - the time in microseconds
+ */
+void
+metrics_stage_time_add(const metrics_stage_e stage, const uint32_t time_us);
+
+/**
+ * @brief Increment the pipeline counter, it's lock-free and can be called with any mutex held.
+ * @param cnt - the pipeline counter
+ */
+void
+metrics_pipeline_cnt_inc(const metrics_pipeline_cnt_e cnt);
+
+#define METRICS_STAGE_BEGIN(stage_) const int64_t metrics_stage_begin_us_##stage_ = esp_timer_get_time()
+#define METRICS_STAGE_END(stage_) \
+    metrics_stage_time_add((stage_), (uint32_t)(esp_timer_get_time() - metrics_stage_begin_us_##stage_))
+#define METRICS_PIPELINE_CNT_INC(cnt_) metrics_pipeline_cnt_inc(cnt_)
+
+#else
+
+#define METRICS_STAGE_BEGIN(stage_)
+#define METRICS_STAGE_END(stage_)
+#define METRICS_PIPELINE_CNT_INC(cnt_)
+
+#endif // METRICS_PIPELINE_ENABLED
+
 typedef enum metrics_malloc_cap_e
 {
     METRICS_MALLOC_CAP_EXEC,
@@ -70,6 +218,15 @@ metrics_get_total_free_bytes(const metrics_malloc_cap_e malloc_cap);
 uint32_t
 metrics_get_largest_free_block(const metrics_malloc_cap_e malloc_cap);
 
+/**
+ * @brief Calculate CRC32 and SHA256 of gw_cfg and ruuvi.json and save them to the cache which is used by
+ *        metrics_generate.
+ * @note This function should be called from the gw_cfg change callback, so the full ruuvi.json is not generated
+ *       on every request of /metrics.
+ */
+void
+metrics_gw_cfg_hash_update(void);
+
 char*
 metrics_generate(void);
 
@@ -26,6 +26,8 @@
 #include "event_mgr.h"
 #include "tls_shared_buf.h"
 #include "reset_task.h"
+#include "adv_delta.h"
+#include "metrics.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
 #include "log.h"
@@ -38,6 +40,8 @@
 
 #define TOPIC_LEN 512
 
+#define MQTT_TOPIC_BATCH "batch"
+
 /**
  * @brief Represents the MQTT network timeout duration in milliseconds.
  *
@@ -65,17 +69,31 @@ typedef struct mqtt_topic_buf_t
 
 #define MQTT_PROTECTED_DATA_ERR_MSG_SIZE 120
 
+/**
+ * @brief The memory for one in-flight message (the payload and the JSON generator).
+ * @note It's allocated on the first publish after the start of the MQTT client and it's freed in mqtt_app_stop,
+ *       so that the publishing does not allocate and free memory for every message and does not fragment the heap.
+ */
+typedef struct mqtt_publish_arena_t
+{
+    char     payload_buf[CONFIG_MQTT_BUFFER_SIZE];
+    uint64_t json_gen_mem[(CONFIG_MQTT_BUFFER_SIZE + MQTT_JSON_GEN_ARENA_OVERHEAD) / sizeof(uint64_t)];
+} mqtt_publish_arena_t;
+
 typedef struct mqtt_protected_data_t
 {
     esp_mqtt_client_handle_t   p_mqtt_client;
     mqtt_topic_buf_t           mqtt_topic;
+    mqtt_publish_arena_t*      p_publish_arena;
     ruuvi_gw_cfg_mqtt_prefix_t mqtt_prefix;
+    size_t                     mqtt_prefix_len;
     bool                       mqtt_disable_retained_messages;
     char                       err_msg[MQTT_PROTECTED_DATA_ERR_MSG_SIZE];
     str_buf_t                  str_buf_server_cert_mqtt;
     str_buf_t                  str_buf_client_cert;
     str_buf_t                  str_buf_client_key;
     tls_shared_buf_mqtts_t*    p_tls_shared_buf_mqtts;
+    adv_delta_t*               p_adv_delta; //<! Shadow of the published advs for delta-encoding
 } mqtt_protected_data_t;
 
 static bool                  g_mqtt_mutex_initialized = false;
@@ -126,6 +144,38 @@ mqtt_create_full_topic(
     }
 }
 
+_Static_assert(
+    (GW_CFG_MAX_MQTT_PREFIX_LEN + sizeof(mac_address_str_t)) <= TOPIC_LEN,
+    "The per-tag topic (prefix + MAC address) does not fit into mqtt_topic_buf_t");
+
+/**
+ * @brief Create the per-tag topic from the cached prefix and the MAC address of the tag (without snprintf).
+ * @return the length of the topic.
+ */
+static size_t
+mqtt_create_tag_topic(mqtt_protected_data_t* const p_mqtt_data, const mac_address_bin_t* const p_tag_mac)
+{
+    const mac_address_str_t tag_mac_str = mac_address_to_str(p_tag_mac);
+    const size_t            mac_str_len = strlen(tag_mac_str.str_buf);
+    memcpy(p_mqtt_data->mqtt_topic.buf, p_mqtt_data->mqtt_prefix.buf, p_mqtt_data->mqtt_prefix_len);
+    memcpy(&p_mqtt_data->mqtt_topic.buf[p_mqtt_data->mqtt_prefix_len], tag_mac_str.str_buf, mac_str_len + 1U);
+    return p_mqtt_data->mqtt_prefix_len + mac_str_len;
+}
+
+static mqtt_publish_arena_t*
+mqtt_get_publish_arena(mqtt_protected_data_t* const p_mqtt_data)
+{
+    if (NULL == p_mqtt_data->p_publish_arena)
+    {
+        p_mqtt_data->p_publish_arena = os_malloc(sizeof(*p_mqtt_data->p_publish_arena));
+        if (NULL == p_mqtt_data->p_publish_arena)
+        {
+            LOG_ERR("Can't allocate memory for the publish arena");
+        }
+    }
+    return p_mqtt_data->p_publish_arena;
+}
+
 bool
 mqtt_is_buffer_available_for_publish(void)
 {
@@ -140,51 +190,215 @@ mqtt_is_buffer_available_for_publish(void)
     return is_ready;
 }
 
-bool
-mqtt_publish_adv(const adv_report_t* const p_adv, const bool flag_use_timestamps, const time_t timestamp)
+void
+mqtt_publish_ctx_init(mqtt_publish_ctx_t* const p_ctx, const bool flag_use_timestamps, const time_t timestamp)
 {
-    const gw_cfg_t*              p_gw_cfg       = gw_cfg_lock_ro();
-    const json_stream_gen_size_t max_chunk_size = 1024U;
+    const gw_cfg_t* p_gw_cfg = gw_cfg_lock_ro();
+    p_ctx->mqtt_data_format  = p_gw_cfg->ruuvi_cfg.mqtt.mqtt_data_format;
+    p_ctx->coordinates       = p_gw_cfg->ruuvi_cfg.coordinates;
+    gw_cfg_unlock_ro(&p_gw_cfg);
+    p_ctx->flag_use_timestamps = flag_use_timestamps;
+    p_ctx->timestamp           = timestamp;
+}
 
-    str_buf_t str_buf_json = mqtt_create_json_str(
-        p_adv,
-        flag_use_timestamps,
-        timestamp,
+static num_of_advs_t
+mqtt_publish_advs_batch(
+    const mqtt_publish_ctx_t* const p_ctx,
+    const adv_report_t* const       p_advs,
+    const num_of_advs_t             num_of_advs)
+{
+    mqtt_protected_data_t* p_mqtt_data = mqtt_mutex_lock();
+    if (NULL == p_mqtt_data->p_mqtt_client)
+    {
+        LOG_ERR("Can't send advs - MQTT was stopped");
+        mqtt_mutex_unlock(&p_mqtt_data);
+        return 0;
+    }
+    mqtt_publish_arena_t* const p_arena = mqtt_get_publish_arena(p_mqtt_data);
+    if (NULL == p_arena)
+    {
+        mqtt_mutex_unlock(&p_mqtt_data);
+        return 0;
+    }
+    mqtt_create_full_topic(&p_mqtt_data->mqtt_topic, p_mqtt_data->mqtt_prefix.buf, MQTT_TOPIC_BATCH);
+
+    // The JSON is generated directly into the publish arena protected by the mutex,
+    // its size is limited so that the whole MQTT message (topic + payload + headers) fits into CONFIG_MQTT_BUFFER_SIZE.
+    const size_t msg_overhead = strlen(p_mqtt_data->mqtt_topic.buf) + 2U + 2U + 2U;
+    if (msg_overhead >= CONFIG_MQTT_BUFFER_SIZE)
+    {
+        LOG_ERR(
+            "MQTT topic len is %u bytes which is too big for buffer size %u",
+            msg_overhead,
+            CONFIG_MQTT_BUFFER_SIZE);
+        mqtt_mutex_unlock(&p_mqtt_data);
+        return 0;
+    }
+    str_buf_t str_buf_json = STR_BUF_INIT(p_arena->payload_buf, sizeof(p_arena->payload_buf) - msg_overhead + 1U);
+
+    METRICS_STAGE_BEGIN(METRICS_STAGE_JSON_GEN_MQTT);
+    const num_of_advs_t num_packed = mqtt_create_json_batch(
+        &str_buf_json,
+        p_advs,
+        num_of_advs,
+        p_ctx->flag_use_timestamps,
+        p_ctx->timestamp,
         gw_cfg_get_nrf52_mac_addr(),
-        p_gw_cfg->ruuvi_cfg.coordinates.buf,
-        p_gw_cfg->ruuvi_cfg.mqtt.mqtt_data_format,
-        max_chunk_size);
-    gw_cfg_unlock_ro(&p_gw_cfg);
+        p_ctx->coordinates.buf);
+    METRICS_STAGE_END(METRICS_STAGE_JSON_GEN_MQTT);
+    if (0 == num_packed)
+    {
+        LOG_ERR("Failed to create MQTT message JSON string, insufficient buffer size (%u bytes)", str_buf_json.size);
+        mqtt_mutex_unlock(&p_mqtt_data);
+        return 0;
+    }
+
+    LOG_DBG(
+        "publish batch of %u advs with len=%u: topic: %s, data: %s",
+        (printf_uint_t)num_packed,
+        (printf_uint_t)(msg_overhead + str_buf_json.idx),
+        p_mqtt_data->mqtt_topic.buf,
+        str_buf_json.buf);
+    const int32_t mqtt_flag_retain = 0;
 
-    if (NULL == str_buf_json.buf)
+    const mqtt_message_id_t message_id = esp_mqtt_client_publish(
+        p_mqtt_data->p_mqtt_client,
+        p_mqtt_data->mqtt_topic.buf,
+        str_buf_json.buf,
+        (esp_mqtt_client_data_len_t)str_buf_json.idx,
+        MQTT_QOS,
+        mqtt_flag_retain);
+    mqtt_mutex_unlock(&p_mqtt_data);
+
+    if (message_id < 0)
+    {
+        return 0;
+    }
+    return num_packed;
+}
+
+num_of_advs_t
+mqtt_publish_advs(
+    const mqtt_publish_ctx_t* const p_ctx,
+    const adv_report_t* const       p_advs,
+    const num_of_advs_t             num_of_advs)
+{
+    if (0 == num_of_advs)
+    {
+        return 0;
+    }
+    if (GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_BATCH == p_ctx->mqtt_data_format)
+    {
+        return mqtt_publish_advs_batch(p_ctx, p_advs, num_of_advs);
+    }
+    return mqtt_publish_adv(p_ctx, &p_advs[0]) ? 1 : 0;
+}
+
+/**
+ * @brief Get the previously published advertisement of the tag if the delta-encoding is enabled.
+ * @note The shadow of delta-encoding is created on the first use and it's protected by the MQTT mutex.
+ * @return true if only the changed decoded fields should be published, false if all fields should be published.
+ */
+static bool
+mqtt_get_adv_prev_for_delta(
+    const gw_cfg_mqtt_data_format_e mqtt_data_format,
+    const adv_report_t* const       p_adv,
+    adv_report_t* const             p_adv_prev)
+{
+    if ((0 == MQTT_DELTA_KEYFRAME_INTERVAL)
+        || ((GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_AND_DECODED != mqtt_data_format)
+            && (GW_CFG_MQTT_DATA_FORMAT_RUUVI_DECODED != mqtt_data_format)))
     {
-        LOG_ERR("Failed to create MQTT message JSON string, insufficient buffer size (%u bytes)", max_chunk_size);
         return false;
     }
+    mqtt_protected_data_t* p_mqtt_data = mqtt_mutex_lock();
+    if (NULL == p_mqtt_data->p_adv_delta)
+    {
+        p_mqtt_data->p_adv_delta = adv_delta_create(ADV_TABLE_CAPACITY, MQTT_DELTA_KEYFRAME_INTERVAL);
+        if (NULL == p_mqtt_data->p_adv_delta)
+        {
+            LOG_WARN("Not enough memory for the shadow of delta-encoding, publish all fields");
+        }
+    }
+    const bool flag_delta = (NULL != p_mqtt_data->p_adv_delta)
+                            && adv_delta_get_prev(p_mqtt_data->p_adv_delta, &p_adv->tag_mac, p_adv_prev);
+    mqtt_mutex_unlock(&p_mqtt_data);
+    return flag_delta;
+}
+
+bool
+mqtt_publish_adv(const mqtt_publish_ctx_t* const p_ctx, const adv_report_t* const p_adv)
+{
+    const gw_cfg_mqtt_data_format_e mqtt_data_format = p_ctx->mqtt_data_format;
+    if (GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_BATCH == mqtt_data_format)
+    {
+        return (1 == mqtt_publish_advs_batch(p_ctx, p_adv, 1)) ? true : false;
+    }
 
-    const mac_address_str_t tag_mac_str = mac_address_to_str(&p_adv->tag_mac);
+    adv_report_t        adv_prev   = { 0 };
+    const adv_report_t* p_adv_prev = NULL;
+    if (mqtt_get_adv_prev_for_delta(mqtt_data_format, p_adv, &adv_prev))
+    {
+        p_adv_prev = &adv_prev;
+    }
 
     mqtt_protected_data_t* p_mqtt_data = mqtt_mutex_lock();
     if (NULL == p_mqtt_data->p_mqtt_client)
     {
         LOG_ERR("Can't send advs - MQTT was stopped");
         mqtt_mutex_unlock(&p_mqtt_data);
-        str_buf_free_buf(&str_buf_json);
         return false;
     }
-    mqtt_create_full_topic(&p_mqtt_data->mqtt_topic, p_mqtt_data->mqtt_prefix.buf, tag_mac_str.str_buf);
+    mqtt_publish_arena_t* const p_arena = mqtt_get_publish_arena(p_mqtt_data);
+    if (NULL == p_arena)
+    {
+        mqtt_mutex_unlock(&p_mqtt_data);
+        return false;
+    }
+    const size_t topic_len = mqtt_create_tag_topic(p_mqtt_data, &p_adv->tag_mac);
 
-    const size_t msg_len = strlen(p_mqtt_data->mqtt_topic.buf) + 2U + 2U + strlen(str_buf_json.buf) + 2U;
-    if (msg_len > CONFIG_MQTT_BUFFER_SIZE)
+    // The JSON is generated directly into the publish arena, its size is limited
+    // so that the whole MQTT message (topic + payload + headers) fits into CONFIG_MQTT_BUFFER_SIZE.
+    const size_t msg_overhead = topic_len + 2U + 2U + 2U;
+    if (msg_overhead >= CONFIG_MQTT_BUFFER_SIZE)
     {
-        LOG_ERR("MQTT message len is %u bytes which is bigger than buffer size %u", msg_len, CONFIG_MQTT_BUFFER_SIZE);
+        LOG_ERR(
+            "MQTT topic len is %u bytes which is too big for buffer size %u",
+            msg_overhead,
+            CONFIG_MQTT_BUFFER_SIZE);
+        mqtt_mutex_unlock(&p_mqtt_data);
+        return false;
+    }
+    str_buf_t str_buf_json = STR_BUF_INIT(p_arena->payload_buf, sizeof(p_arena->payload_buf) - msg_overhead + 1U);
+    mqtt_json_gen_arena_t json_gen_arena = {
+        .p_mem = (uint8_t*)p_arena->json_gen_mem,
+        .size  = sizeof(p_arena->json_gen_mem),
+        .used  = 0,
+    };
+    METRICS_STAGE_BEGIN(METRICS_STAGE_JSON_GEN_MQTT);
+    const bool flag_json_created = mqtt_create_json_str_in_buf(
+        &str_buf_json,
+        &json_gen_arena,
+        p_adv,
+        p_adv_prev,
+        p_ctx->flag_use_timestamps,
+        p_ctx->timestamp,
+        gw_cfg_get_nrf52_mac_addr(),
+        p_ctx->coordinates.buf,
+        mqtt_data_format);
+    METRICS_STAGE_END(METRICS_STAGE_JSON_GEN_MQTT);
+    if (!flag_json_created)
+    {
+        LOG_ERR("Failed to create MQTT message JSON string, insufficient buffer size (%u bytes)", str_buf_json.size);
         mqtt_mutex_unlock(&p_mqtt_data);
-        str_buf_free_buf(&str_buf_json);
         return false;
     }
 
-    LOG_DBG("publish msg with len=%u: topic: %s, data: %s", msg_len, p_mqtt_data->mqtt_topic.buf, str_buf_json.buf);
-    const int32_t mqtt_len              = 0;
+    LOG_DBG(
+        "publish msg with len=%u: topic: %s, data: %s",
+        (printf_uint_t)(msg_overhead + str_buf_json.idx),
+        p_mqtt_data->mqtt_topic.buf,
+        str_buf_json.buf);
     const int32_t mqtt_flag_retain      = 0;
     bool          is_publish_successful = false;
 
@@ -192,16 +406,18 @@ mqtt_publish_adv(const adv_report_t* const p_adv, const bool flag_use_timestamps
             p_mqtt_data->p_mqtt_client,
             p_mqtt_data->mqtt_topic.buf,
             str_buf_json.buf,
-            mqtt_len,
+            (esp_mqtt_client_data_len_t)str_buf_json.idx,
             MQTT_QOS,
             mqtt_flag_retain)
         >= 0)
     {
         is_publish_successful = true;
+        if (NULL != p_mqtt_data->p_adv_delta)
+        {
+            adv_delta_commit(p_mqtt_data->p_adv_delta, p_adv);
+        }
     }
     mqtt_mutex_unlock(&p_mqtt_data);
-
-    str_buf_free_buf(&str_buf_json);
     return is_publish_successful;
 }
 
@@ -211,6 +427,11 @@ mqtt_publish_connect(void)
     char* p_message = "{\"state\": \"online\"}";
 
     mqtt_protected_data_t* p_mqtt_data = mqtt_mutex_lock();
+    if (NULL != p_mqtt_data->p_adv_delta)
+    {
+        // The subscribers could miss the messages while the connection was lost, so start with keyframes.
+        adv_delta_reset(p_mqtt_data->p_adv_delta);
+    }
     mqtt_create_full_topic(&p_mqtt_data->mqtt_topic, p_mqtt_data->mqtt_prefix.buf, "gw_status");
     LOG_INFO("esp_mqtt_client_publish: topic:'%s', message:'%s'", p_mqtt_data->mqtt_topic.buf, p_message);
     const int32_t mqtt_flag_retain = !p_mqtt_data->mqtt_disable_retained_messages;
@@ -539,6 +760,7 @@ mqtt_create_client_config(mqtt_protected_data_t* p_mqtt_data, const ruuvi_gw_cfg
     }
     mqtt_create_full_topic(&p_mqtt_data->mqtt_topic, p_mqtt_cfg->mqtt_prefix.buf, "gw_status");
     p_mqtt_data->mqtt_prefix                    = p_mqtt_cfg->mqtt_prefix;
+    p_mqtt_data->mqtt_prefix_len                = strlen(p_mqtt_data->mqtt_prefix.buf);
     p_mqtt_data->mqtt_disable_retained_messages = p_mqtt_cfg->mqtt_disable_retained_messages;
     const char* const p_lwt_message             = "{\"state\": \"offline\"}";
 
@@ -797,6 +1019,8 @@ mqtt_app_stop(void)
     str_buf_free_buf(&p_mqtt_data->str_buf_server_cert_mqtt);
     str_buf_free_buf(&p_mqtt_data->str_buf_client_cert);
     str_buf_free_buf(&p_mqtt_data->str_buf_client_key);
+    adv_delta_delete(&p_mqtt_data->p_adv_delta);
+    os_free(p_mqtt_data->p_publish_arena);
     mqtt_mutex_unlock(&p_mqtt_data);
 }
 
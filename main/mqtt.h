@@ -16,6 +16,15 @@
 extern "C" {
 #endif
 
+#if !defined(MQTT_DELTA_KEYFRAME_INTERVAL)
+/**
+ * @brief Publish only the changed decoded fields (see adv_delta.h)
+ *        and all fields in every MQTT_DELTA_KEYFRAME_INTERVAL-th message for the tag, 0 - delta encoding is disabled.
+ * @note It's configured by RUUVI_MQTT_DELTA_KEYFRAME_INTERVAL in the top-level CMakeLists.txt.
+ */
+#define MQTT_DELTA_KEYFRAME_INTERVAL (0)
+#endif
+
 void
 mqtt_app_start(const ruuvi_gw_cfg_mqtt_t* const p_mqtt);
 
@@ -31,8 +40,51 @@ mqtt_app_is_working(void);
 bool
 mqtt_is_buffer_available_for_publish(void);
 
+/**
+ * @brief The snapshot of the configuration which is needed to publish advertisements.
+ * @note It's taken once per burst of publications to avoid locking gw_cfg for every advertisement.
+ */
+typedef struct mqtt_publish_ctx_t
+{
+    gw_cfg_mqtt_data_format_e  mqtt_data_format;    //<! MQTT data format
+    ruuvi_gw_cfg_coordinates_t coordinates;         //<! Coordinates of the gateway
+    bool                       flag_use_timestamps; //<! true if timestamps are used, false if counters are used
+    time_t                     timestamp;           //<! Gateway timestamp
+} mqtt_publish_ctx_t;
+
+/**
+ * @brief Init the publication context from the current gw_cfg.
+ * @param p_ctx - ptr to the publication context
+ * @param flag_use_timestamps - true if timestamps are used, false if counters are used
+ * @param timestamp - gateway timestamp
+ */
+void
+mqtt_publish_ctx_init(mqtt_publish_ctx_t* const p_ctx, const bool flag_use_timestamps, const time_t timestamp);
+
+/**
+ * @brief Publish the advertisement on the per-tag topic (or on '<prefix>batch' for RAW_BATCH data format).
+ * @param p_ctx - ptr to the publication context (see mqtt_publish_ctx_init)
+ * @param p_adv - ptr to the advertisement
+ * @return true on success.
+ */
 bool
-mqtt_publish_adv(const adv_report_t* const p_adv, const bool flag_use_timestamps, const time_t timestamp);
+mqtt_publish_adv(const mqtt_publish_ctx_t* const p_ctx, const adv_report_t* const p_adv);
+
+/**
+ * @brief Publish as many advertisements from the array as possible in one MQTT message.
+ * @note With GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_BATCH the advertisements are packed into one message on topic
+ *       '<prefix>batch' (up to CONFIG_MQTT_BUFFER_SIZE bytes), with the other data formats only the first
+ *       advertisement is published on the per-tag topic.
+ * @param p_ctx - ptr to the publication context (see mqtt_publish_ctx_init)
+ * @param p_advs - ptr to the array of advertisements
+ * @param num_of_advs - number of advertisements in the array
+ * @return the number of published advertisements, 0 on error.
+ */
+num_of_advs_t
+mqtt_publish_advs(
+    const mqtt_publish_ctx_t* const p_ctx,
+    const adv_report_t* const       p_advs,
+    const num_of_advs_t             num_of_advs);
 
 void
 mqtt_publish_connect(void);
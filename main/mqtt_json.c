@@ -6,6 +6,7 @@
  */
 
 #include "mqtt_json.h"
+#include <string.h>
 #include "os_malloc.h"
 #include "ruuvi_endpoint_5.h"
 #include "ruuvi_endpoint_6.h"
@@ -23,6 +24,7 @@ static const char TAG[] = "mqtt";
 typedef struct mqtt_json_stream_gen_adv_ctx_t
 {
     const adv_report_t*       p_adv;
+    const adv_report_t*       p_adv_prev;
     bool                      flag_use_timestamps;
     time_t                    timestamp;
     const mac_address_str_t*  p_mac_addr;
@@ -59,15 +61,27 @@ mqtt_cb_json_stream_gen_adv(json_stream_gen_t* const p_gen, const void* const p_
     {
         if (re_5_check_format(p_ctx->p_adv->data_buf))
         {
-            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_df5_cb_json_stream_gen, p_gen, p_ctx->p_adv);
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(
+                adv_decode_df5_cb_json_stream_gen,
+                p_gen,
+                p_ctx->p_adv,
+                p_ctx->p_adv_prev);
         }
         if (re_6_check_format(p_ctx->p_adv->data_buf))
         {
-            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_df6_cb_json_stream_gen, p_gen, p_ctx->p_adv);
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(
+                adv_decode_df6_cb_json_stream_gen,
+                p_gen,
+                p_ctx->p_adv,
+                p_ctx->p_adv_prev);
         }
         if (re_e1_check_format(p_ctx->p_adv->data_buf))
         {
-            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(adv_decode_dfxe1_cb_json_stream_gen, p_gen, p_ctx->p_adv);
+            JSON_STREAM_GEN_CALL_GENERATOR_SUB_FUNC(
+                adv_decode_dfxe1_cb_json_stream_gen,
+                p_gen,
+                p_ctx->p_adv,
+                p_ctx->p_adv_prev);
         }
     }
 
@@ -76,9 +90,36 @@ mqtt_cb_json_stream_gen_adv(json_stream_gen_t* const p_gen, const void* const p_
     JSON_STREAM_GEN_END_GENERATOR_FUNC();
 }
 
+static void
+mqtt_json_rollback(str_buf_t* const p_str_buf, const size_t idx)
+{
+    p_str_buf->idx      = idx;
+    p_str_buf->buf[idx] = '\0';
+}
+
+static json_stream_gen_t*
+mqtt_json_stream_gen_adv_create(
+    const json_stream_gen_cfg_t* const          p_cfg,
+    const mqtt_json_stream_gen_adv_ctx_t* const p_ctx_src)
+{
+    mqtt_json_stream_gen_adv_ctx_t* p_ctx = NULL;
+    json_stream_gen_t*              p_gen = json_stream_gen_create(
+        p_cfg,
+        &mqtt_cb_json_stream_gen_adv,
+        sizeof(*p_ctx),
+        (void**)&p_ctx);
+    if (NULL == p_gen)
+    {
+        return NULL;
+    }
+    *p_ctx = *p_ctx_src;
+    return p_gen;
+}
+
 str_buf_t
 mqtt_create_json_str(
     const adv_report_t* const       p_adv,
+    const adv_report_t* const       p_adv_prev,
     const bool                      flag_use_timestamps,
     const time_t                    timestamp,
     const mac_address_str_t* const  p_mac_addr,
@@ -96,23 +137,21 @@ mqtt_create_json_str(
         .p_free              = &os_free_internal,
         .p_localeconv        = NULL,
     };
-    mqtt_json_stream_gen_adv_ctx_t* p_ctx = NULL;
-    json_stream_gen_t*              p_gen = json_stream_gen_create(
-        &cfg,
-        &mqtt_cb_json_stream_gen_adv,
-        sizeof(*p_ctx),
-        (void**)&p_ctx);
+    const mqtt_json_stream_gen_adv_ctx_t ctx = {
+        .p_adv               = p_adv,
+        .p_adv_prev          = p_adv_prev,
+        .flag_use_timestamps = flag_use_timestamps,
+        .timestamp           = timestamp,
+        .p_mac_addr          = p_mac_addr,
+        .p_coordinates_str   = p_coordinates_str,
+        .mqtt_data_format    = mqtt_data_format,
+    };
+    json_stream_gen_t* p_gen = mqtt_json_stream_gen_adv_create(&cfg, &ctx);
     if (NULL == p_gen)
     {
         LOG_ERR("Not enough memory");
         return str_buf_init_null();
     }
-    p_ctx->p_adv               = p_adv;
-    p_ctx->flag_use_timestamps = flag_use_timestamps;
-    p_ctx->timestamp           = timestamp;
-    p_ctx->p_mac_addr          = p_mac_addr;
-    p_ctx->p_coordinates_str   = p_coordinates_str;
-    p_ctx->mqtt_data_format    = mqtt_data_format;
 
     const char* p_chunk = json_stream_gen_get_next_chunk(p_gen);
     if (NULL == p_chunk) // Check if there is any errors
@@ -149,3 +188,221 @@ mqtt_create_json_str(
     }
     return str_buf;
 }
+
+/**
+ * @brief The arena which is used by mqtt_json_arena_malloc, it's set only while mqtt_create_json_str_in_buf runs.
+ */
+static mqtt_json_gen_arena_t* g_p_mqtt_json_gen_arena;
+
+static void*
+mqtt_json_arena_malloc(size_t size)
+{
+    mqtt_json_gen_arena_t* const p_arena      = g_p_mqtt_json_gen_arena;
+    const size_t                 aligned_size = (size + (sizeof(uint64_t) - 1U)) & ~(sizeof(uint64_t) - 1U);
+    if ((NULL == p_arena) || (aligned_size > (p_arena->size - p_arena->used)))
+    {
+        return NULL;
+    }
+    void* const p_mem = &p_arena->p_mem[p_arena->used];
+    p_arena->used += aligned_size;
+    return p_mem;
+}
+
+static void
+mqtt_json_arena_free(void* p_mem)
+{
+    // The arena is rewound as a whole at the beginning of mqtt_create_json_str_in_buf.
+    (void)p_mem;
+}
+
+/**
+ * @brief Copy the JSON to p_str_buf, the whole JSON is expected to fit into one chunk.
+ */
+static bool
+mqtt_json_copy_single_chunk(json_stream_gen_t* const p_gen, str_buf_t* const p_str_buf)
+{
+    const char* p_chunk = json_stream_gen_get_next_chunk(p_gen);
+    if (NULL == p_chunk)
+    {
+        LOG_ERR("Error while json generation (exceeding the nesting level, etc.)");
+        return false;
+    }
+    // The chunk is located in the arena and it's overwritten by the next call of json_stream_gen_get_next_chunk.
+    const size_t json_len = strlen(p_chunk);
+    if (json_len >= p_str_buf->size)
+    {
+        LOG_ERR(
+            "Json length %u exceeds the buffer size %u",
+            (printf_uint_t)json_len,
+            (printf_uint_t)p_str_buf->size);
+        return false;
+    }
+    memcpy(p_str_buf->buf, p_chunk, json_len + 1U);
+    p_str_buf->idx = json_len;
+
+    p_chunk = json_stream_gen_get_next_chunk(p_gen);
+    if (NULL == p_chunk)
+    {
+        LOG_ERR("Error while json generation (exceeding the nesting level, etc.)");
+        return false;
+    }
+    if ('\0' != *p_chunk)
+    {
+        LOG_ERR("Json length exceeds the maximum chunk size %u", (printf_uint_t)(p_str_buf->size - 1U));
+        return false;
+    }
+    return true;
+}
+
+bool
+mqtt_create_json_str_in_buf(
+    str_buf_t* const                p_str_buf,
+    mqtt_json_gen_arena_t* const    p_arena,
+    const adv_report_t* const       p_adv,
+    const adv_report_t* const       p_adv_prev,
+    const bool                      flag_use_timestamps,
+    const time_t                    timestamp,
+    const mac_address_str_t* const  p_mac_addr,
+    const char* const               p_coordinates_str,
+    const gw_cfg_mqtt_data_format_e mqtt_data_format)
+{
+    const json_stream_gen_cfg_t cfg = {
+        .max_chunk_size      = (json_stream_gen_size_t)(p_str_buf->size - 1U),
+        .flag_formatted_json = false,
+        .indentation_mark    = ' ',
+        .indentation         = 0,
+        .max_nesting_level   = 2,
+        .p_malloc            = &mqtt_json_arena_malloc,
+        .p_free              = &mqtt_json_arena_free,
+        .p_localeconv        = NULL,
+    };
+    const mqtt_json_stream_gen_adv_ctx_t ctx = {
+        .p_adv               = p_adv,
+        .p_adv_prev          = p_adv_prev,
+        .flag_use_timestamps = flag_use_timestamps,
+        .timestamp           = timestamp,
+        .p_mac_addr          = p_mac_addr,
+        .p_coordinates_str   = p_coordinates_str,
+        .mqtt_data_format    = mqtt_data_format,
+    };
+    p_arena->used           = 0;
+    g_p_mqtt_json_gen_arena = p_arena;
+    mqtt_json_rollback(p_str_buf, 0);
+
+    json_stream_gen_t* p_gen = mqtt_json_stream_gen_adv_create(&cfg, &ctx);
+    if (NULL == p_gen)
+    {
+        g_p_mqtt_json_gen_arena = NULL;
+        LOG_ERR("Arena size %u is not enough for the JSON generator", (printf_uint_t)p_arena->size);
+        return false;
+    }
+
+    const bool is_success = mqtt_json_copy_single_chunk(p_gen, p_str_buf);
+    json_stream_gen_delete(&p_gen);
+    g_p_mqtt_json_gen_arena = NULL;
+    if (!is_success)
+    {
+        mqtt_json_rollback(p_str_buf, 0);
+    }
+    return is_success;
+}
+
+static void
+mqtt_json_batch_print_str(str_buf_t* const p_str_buf, const char* const p_str)
+{
+    str_buf_printf(p_str_buf, "\"");
+    for (const char* p_ch = p_str; '\0' != *p_ch; ++p_ch)
+    {
+        const uint8_t ch = (uint8_t)*p_ch;
+        if (('"' == ch) || ('\\' == ch))
+        {
+            str_buf_printf(p_str_buf, "\\%c", (char)ch);
+        }
+        else if (ch < (uint8_t)' ')
+        {
+            str_buf_printf(p_str_buf, "\\u%04x", (printf_uint_t)ch);
+        }
+        else
+        {
+            str_buf_printf(p_str_buf, "%c", (char)ch);
+        }
+    }
+    str_buf_printf(p_str_buf, "\"");
+}
+
+static bool
+mqtt_json_batch_print_adv(
+    str_buf_t* const          p_str_buf,
+    const adv_report_t* const p_adv,
+    const bool                flag_use_timestamps,
+    const bool                flag_first)
+{
+    const mac_address_str_t tag_mac_str = mac_address_to_str(&p_adv->tag_mac);
+    str_buf_printf(
+        p_str_buf,
+        "%s\"%s\":{\"rssi\":%d,\"%s\":%lu,\"data\":\"",
+        flag_first ? "" : ",",
+        tag_mac_str.str_buf,
+        (printf_int_t)p_adv->rssi,
+        flag_use_timestamps ? "ts" : "cnt",
+        (printf_ulong_t)p_adv->timestamp);
+    for (uint32_t i = 0; i < p_adv->data_len; ++i)
+    {
+        str_buf_printf(p_str_buf, "%02X", (printf_uint_t)p_adv->data_buf[i]);
+    }
+    str_buf_printf(p_str_buf, "\"}");
+    return !str_buf_is_overflow(p_str_buf);
+}
+
+num_of_advs_t
+mqtt_create_json_batch(
+    str_buf_t* const               p_str_buf,
+    const adv_report_t* const      p_advs,
+    const num_of_advs_t            num_of_advs,
+    const bool                     flag_use_timestamps,
+    const time_t                   timestamp,
+    const mac_address_str_t* const p_mac_addr,
+    const char* const              p_coordinates_str)
+{
+    static const char json_tail[] = "}}";
+
+    mqtt_json_rollback(p_str_buf, 0);
+    str_buf_printf(p_str_buf, "{\"gw_mac\":\"%s\",", p_mac_addr->str_buf);
+    if (flag_use_timestamps)
+    {
+        str_buf_printf(p_str_buf, "\"gwts\":%lu,", (printf_ulong_t)timestamp);
+    }
+    str_buf_printf(p_str_buf, "\"coords\":");
+    mqtt_json_batch_print_str(p_str_buf, p_coordinates_str);
+    str_buf_printf(p_str_buf, ",\"tags\":{");
+    if (str_buf_is_overflow(p_str_buf) || ((p_str_buf->size - p_str_buf->idx) <= (sizeof(json_tail) - 1)))
+    {
+        LOG_ERR("Buffer size %u is not enough for the JSON header", (printf_uint_t)p_str_buf->size);
+        mqtt_json_rollback(p_str_buf, 0);
+        return 0;
+    }
+
+    // Reserve space for the closing brackets, so that the JSON can always be completed.
+    p_str_buf->size -= sizeof(json_tail) - 1;
+    num_of_advs_t num_packed = 0;
+    while (num_packed < num_of_advs)
+    {
+        const size_t idx = p_str_buf->idx;
+        if (!mqtt_json_batch_print_adv(p_str_buf, &p_advs[num_packed], flag_use_timestamps, 0 == num_packed))
+        {
+            mqtt_json_rollback(p_str_buf, idx);
+            break;
+        }
+        num_packed += 1;
+    }
+    p_str_buf->size += sizeof(json_tail) - 1;
+
+    if (0 == num_packed)
+    {
+        LOG_ERR("Buffer size %u is not enough for the JSON with one advertisement", (printf_uint_t)p_str_buf->size);
+        mqtt_json_rollback(p_str_buf, 0);
+        return 0;
+    }
+    str_buf_printf(p_str_buf, "%s", json_tail);
+    return num_packed;
+}
@@ -9,6 +9,7 @@
 #define RUUVI_GATEWAY_ESP_MQTT_JSON_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "adv_table.h"
 #include "str_buf.h"
 
@@ -16,9 +17,23 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Generate JSON for the advertisement which is published on the per-tag topic.
+ * @param p_adv - ptr to the advertisement
+ * @param p_adv_prev - ptr to the previously published advertisement of the tag to generate only the changed
+ *                     decoded fields (see adv_delta.h) or NULL to generate all fields
+ * @param flag_use_timestamps - true if timestamps are used, false if counters are used
+ * @param timestamp - gateway timestamp
+ * @param p_mac_addr - MAC address of the gateway
+ * @param p_coordinates_str - coordinates of the gateway
+ * @param mqtt_data_format - MQTT data format
+ * @param max_chunk_size - the maximum length of JSON
+ * @return str_buf_t with JSON or str_buf_t with NULL ptr on error.
+ */
 str_buf_t
 mqtt_create_json_str(
     const adv_report_t* const       p_adv,
+    const adv_report_t* const       p_adv_prev,
     const bool                      flag_use_timestamps,
     const time_t                    timestamp,
     const mac_address_str_t* const  p_mac_addr,
@@ -26,6 +41,73 @@ mqtt_create_json_str(
     const gw_cfg_mqtt_data_format_e mqtt_data_format,
     const json_stream_gen_size_t    max_chunk_size);
 
+/**
+ * @brief The memory required by the JSON generator of mqtt_create_json_str_in_buf in addition to the JSON buffer size.
+ */
+#define MQTT_JSON_GEN_ARENA_OVERHEAD (512U)
+
+/**
+ * @brief Caller-provided memory for the JSON generator which is used instead of the heap.
+ * @note The arena is rewound on every call of mqtt_create_json_str_in_buf, so it can be reused for every message.
+ */
+typedef struct mqtt_json_gen_arena_t
+{
+    uint8_t* p_mem; //<! Ptr to the memory, it must be aligned to 8 bytes
+    size_t   size;  //<! Size of the memory, it should be at least json_buf_size + MQTT_JSON_GEN_ARENA_OVERHEAD
+    size_t   used;  //<! Number of bytes allocated by the JSON generator during the last call
+} mqtt_json_gen_arena_t;
+
+/**
+ * @brief Generate JSON for the advertisement which is published on the per-tag topic without heap allocations.
+ * @note The JSON generator is allocated in the arena, the calls must be serialized by the caller
+ *       (the arena is not thread-safe).
+ * @param p_str_buf - ptr to str_buf_t with pre-allocated buffer, it's rewritten from the beginning,
+ *                    the size of the buffer limits the maximum length of JSON
+ * @param p_arena - ptr to the arena for the JSON generator
+ * @param p_adv - ptr to the advertisement
+ * @param p_adv_prev - ptr to the previously published advertisement of the tag or NULL (see mqtt_create_json_str)
+ * @param flag_use_timestamps - true if timestamps are used, false if counters are used
+ * @param timestamp - gateway timestamp
+ * @param p_mac_addr - MAC address of the gateway
+ * @param p_coordinates_str - coordinates of the gateway
+ * @param mqtt_data_format - MQTT data format
+ * @return true on success, false if the arena or the buffer is too small.
+ */
+bool
+mqtt_create_json_str_in_buf(
+    str_buf_t* const                p_str_buf,
+    mqtt_json_gen_arena_t* const    p_arena,
+    const adv_report_t* const       p_adv,
+    const adv_report_t* const       p_adv_prev,
+    const bool                      flag_use_timestamps,
+    const time_t                    timestamp,
+    const mac_address_str_t* const  p_mac_addr,
+    const char* const               p_coordinates_str,
+    const gw_cfg_mqtt_data_format_e mqtt_data_format);
+
+/**
+ * @brief Generate JSON for GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW_BATCH directly into a caller-provided buffer.
+ * @note The advertisements are packed one by one while they fit into the buffer,
+ *       the JSON is always complete (it's closed even if not all the advertisements were packed).
+ * @param p_str_buf - ptr to str_buf_t with pre-allocated buffer, it's rewritten from the beginning
+ * @param p_advs - ptr to the array of advertisements
+ * @param num_of_advs - number of advertisements in the array
+ * @param flag_use_timestamps - true if timestamps are used, false if counters are used
+ * @param timestamp - gateway timestamp
+ * @param p_mac_addr - MAC address of the gateway
+ * @param p_coordinates_str - coordinates of the gateway
+ * @return the number of packed advertisements, 0 if the buffer is too small even for one advertisement.
+ */
+num_of_advs_t
+mqtt_create_json_batch(
+    str_buf_t* const               p_str_buf,
+    const adv_report_t* const      p_advs,
+    const num_of_advs_t            num_of_advs,
+    const bool                     flag_use_timestamps,
+    const time_t                   timestamp,
+    const mac_address_str_t* const p_mac_addr,
+    const char* const              p_coordinates_str);
+
 #ifdef __cplusplus
 }
 #endif
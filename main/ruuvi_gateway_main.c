@@ -42,6 +42,7 @@
 #include "reset_info.h"
 #include "network_subsystem.h"
 #include "gw_cfg_storage.h"
+#include "metrics.h"
 #include "esp_transport_ssl.h"
 #include "tls_shared_buf.h"
 
@@ -49,6 +50,8 @@
 #include "http_parser.h"
 #include "log.h"
 #include "partition_table.h"
+#include "flashfatfs.h"
+#include "boot_seq.h"
 
 static const char TAG[] = "ruuvi_gateway";
 
@@ -65,6 +68,8 @@ static const char TAG[] = "ruuvi_gateway";
 #define RUUVI_GATEWAY_SSL_SAVED_SESSION_TICKET_IDX_RUUVI  (0U)
 #define RUUVI_GATEWAY_SSL_SAVED_SESSION_TICKET_IDX_CUSTOM (1U)
 
+#define RUUVI_GATEWAY_GWUI_MOUNT_TASK_STACK_SIZE (3U * 1024U)
+
 volatile uint32_t IRAM_ATTR g_network_disconnect_cnt;
 volatile uint32_t IRAM_ATTR g_wifi_cnt_mic_failure;
 
@@ -298,6 +303,8 @@ cb_before_nrf52_fw_updating(void)
 
     const wifiman_config_t* const p_wifi_cfg             = wifi_manager_default_config_init(p_wifi_ap_ssid, &hostinfo);
     const bool                    flag_connect_sta_false = false;
+    // wifi_init mounts GWUI partition if it's not mounted yet, so wait until the async mounting is finished.
+    (void)boot_seq_wait(METRICS_BOOT_STAGE_GWUI_MOUNT);
     if (!wifi_init(flag_connect_sta_false, p_wifi_cfg, fw_update_get_current_fatfs_gwui_partition_name()))
     {
         LOG_ERR("%s failed", "wifi_init");
@@ -454,6 +461,8 @@ ruuvi_cb_on_change_cfg(const gw_cfg_t* const p_gw_cfg)
         os_free(p_hostname);
     }
 
+    metrics_gw_cfg_hash_update();
+
     if (gw_status_is_waiting_auto_cfg_by_wps())
     {
         main_task_send_sig_deactivate_cfg_mode();
@@ -467,6 +476,14 @@ main_task_initial_initialization(void)
     fw_update_init();
     cjson_wrap_init();
     partition_table_update_init_mutex();
+    flashfatfs_init_mutex();
+    metrics_init(); // Boot stages are saved to metrics from several threads, so it can't be initialized lazily.
+
+    if (!boot_seq_init())
+    {
+        LOG_ERR("%s failed", "boot_seq_init");
+        return false; // app_main() will roll back the firmware.
+    }
 
     g_http_server_mutex_incoming_connection = os_mutex_create_static(&g_http_server_mutex_incoming_connection_mem);
 
@@ -499,6 +516,12 @@ main_task_initial_initialization(void)
     return true;
 }
 
+static bool
+main_task_mount_gwui(void)
+{
+    return http_server_cb_init(fw_update_get_current_fatfs_gwui_partition_name());
+}
+
 static bool
 main_task_init(void)
 {
@@ -509,6 +532,12 @@ main_task_init(void)
         return false; // app_main() will roll back the firmware.
     }
 
+    // GWUI partition is needed only when Wi-Fi/HTTP server is started, so mount it while nRF52 is being checked.
+    (void)boot_seq_start_async(
+        METRICS_BOOT_STAGE_GWUI_MOUNT,
+        &main_task_mount_gwui,
+        RUUVI_GATEWAY_GWUI_MOUNT_TASK_STACK_SIZE);
+
     const bool is_configure_button_pressed = (0 == gpio_get_level(RB_BUTTON_RESET_PIN)) ? true : false;
     nrf52fw_hw_reset_nrf52(true);
     leds_init(is_configure_button_pressed);
@@ -519,6 +548,7 @@ main_task_init(void)
         return false; // app_main() will roll back the firmware.
     }
 
+    boot_seq_begin(METRICS_BOOT_STAGE_NVS_INIT);
     ruuvi_nvs_init();
     ruuvi_nvs_init_gw_cfg_storage();
 
@@ -538,19 +568,24 @@ main_task_init(void)
         ruuvi_nvs_erase();
         ruuvi_nvs_init();
     }
+    boot_seq_end(METRICS_BOOT_STAGE_NVS_INIT, true);
 
     tls_shared_buf_init();
     esp_tls_set_mode_mandatory_pre_allocated_in_out_buf();
     esp_transport_ssl_init_saved_tickets_storage();
 
+    boot_seq_begin(METRICS_BOOT_STAGE_GW_CFG_INIT);
     if (!ruuvi_init_gw_cfg(NULL, NULL))
     {
         LOG_ERR("%s failed", "ruuvi_init_gw_cfg");
+        boot_seq_end(METRICS_BOOT_STAGE_GW_CFG_INIT, false);
         return false; // app_main() will roll back the firmware.
     }
+    boot_seq_end(METRICS_BOOT_STAGE_GW_CFG_INIT, true);
 
     main_task_init_timers();
 
+    boot_seq_begin(METRICS_BOOT_STAGE_NRF52_FW_CHECK);
     leds_notify_nrf52_fw_check();
     vTaskDelay(pdMS_TO_TICKS(750)); // give time for leds_task to turn off the red LED
     ruuvi_nrf52_fw_ver_t                nrf52_fw_ver        = { 0 };
@@ -569,19 +604,25 @@ main_task_init(void)
         LOG_ERR("%s failed", "nrf52fw_update_fw_if_necessary");
         gw_status_clear_nrf_status();
         leds_notify_nrf52_failure();
+        boot_seq_end(METRICS_BOOT_STAGE_NRF52_FW_CHECK, false);
         return false; // app_main() will roll back the firmware.
     }
     gw_status_set_nrf_status();
     leds_notify_nrf52_ready();
+    boot_seq_end(METRICS_BOOT_STAGE_NRF52_FW_CHECK, true);
 
+    boot_seq_begin(METRICS_BOOT_STAGE_ADV_POST_INIT);
     adv_mqtt_init();
     adv_post_init();
+    boot_seq_end(METRICS_BOOT_STAGE_ADV_POST_INIT, true);
 
+    boot_seq_begin(METRICS_BOOT_STAGE_NRF52_DEVICE_ID);
     const nrf52_device_info_t nrf52_device_info = ruuvi_device_id_request_and_wait();
 
     ruuvi_deinit_gw_cfg();
     ruuvi_init_gw_cfg(&nrf52_fw_ver, &nrf52_device_info);
     LOG_INFO("### Config is empty: %s", gw_cfg_is_empty() ? "true" : "false");
+    boot_seq_end(METRICS_BOOT_STAGE_NRF52_DEVICE_ID, true);
 
     hmac_sha256_set_key_for_http_ruuvi(gw_cfg_get_nrf52_device_id()->str_buf);  // set default encryption key
     hmac_sha256_set_key_for_http_custom(gw_cfg_get_nrf52_device_id()->str_buf); // set default encryption key
@@ -593,14 +634,18 @@ main_task_init(void)
 
     const force_start_wifi_hotspot_e force_start_wifi_hotspot = settings_read_flag_force_start_wifi_hotspot();
 
+    // It also waits until GWUI partition is mounted.
+    boot_seq_begin(METRICS_BOOT_STAGE_NETWORK_INIT);
     const gw_cfg_t* p_gw_cfg = gw_cfg_lock_ro();
     if (!network_subsystem_init(force_start_wifi_hotspot, p_gw_cfg))
     {
         LOG_ERR("%s failed", "network_subsystem_init");
         gw_cfg_unlock_ro(&p_gw_cfg);
+        boot_seq_end(METRICS_BOOT_STAGE_NETWORK_INIT, false);
         return false; // app_main() will roll back the firmware.
     }
     gw_cfg_unlock_ro(&p_gw_cfg);
+    boot_seq_end(METRICS_BOOT_STAGE_NETWORK_INIT, true);
 
     return true;
 }
@@ -19,6 +19,7 @@
 #include "os_malloc.h"
 #include "wifi_manager.h"
 #include "ruuvi_nvs.h"
+#include "esp32/rom/crc.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
 #include "log.h"
@@ -31,6 +32,9 @@
 #define RUUVI_GATEWAY_NVS_CFG_JSON_KEY "ruuvi_cfg_json"
 #define RUUVI_GATEWAY_NVS_MAC_ADDR_KEY "ruuvi_mac_addr"
 
+#define RUUVI_GATEWAY_NVS_CFG_SECT_FMT_KEY     "ruuvi_cfg_sect"
+#define RUUVI_GATEWAY_NVS_CFG_SECT_FMT_VERSION (1U)
+
 #define RUUVI_GATEWAY_NVS_FLAG_REBOOTING_AFTER_AUTO_UPDATE_KEY   "ruuvi_auto_udp"
 #define RUUVI_GATEWAY_NVS_FLAG_REBOOTING_AFTER_AUTO_UPDATE_VALUE (0xAACC5533U)
 
@@ -41,6 +45,31 @@
 
 static const char TAG[] = "settings";
 
+/**
+ * @brief Header of the NVS BLOB with a section of the configuration, it's followed by the NUL-terminated JSON string.
+ */
+typedef struct settings_cfg_sect_hdr_t
+{
+    uint32_t crc; //!< CRC32 of the JSON string (without the terminating NUL)
+} settings_cfg_sect_hdr_t;
+
+static const char* const g_settings_cfg_sect_keys[GW_CFG_JSON_SECTION_NUM] = {
+    [GW_CFG_JSON_SECTION_WIFI]        = "cfg_wifi",
+    [GW_CFG_JSON_SECTION_ETH]         = "cfg_eth",
+    [GW_CFG_JSON_SECTION_REMOTE]      = "cfg_remote",
+    [GW_CFG_JSON_SECTION_HTTP]        = "cfg_http",
+    [GW_CFG_JSON_SECTION_HTTP_STAT]   = "cfg_http_stat",
+    [GW_CFG_JSON_SECTION_MQTT]        = "cfg_mqtt",
+    [GW_CFG_JSON_SECTION_LAN_AUTH]    = "cfg_lan_auth",
+    [GW_CFG_JSON_SECTION_AUTO_UPDATE] = "cfg_auto_update",
+    [GW_CFG_JSON_SECTION_NTP]         = "cfg_ntp",
+    [GW_CFG_JSON_SECTION_FILTER]      = "cfg_filter",
+    [GW_CFG_JSON_SECTION_SCAN]        = "cfg_scan",
+    [GW_CFG_JSON_SECTION_SCAN_FILTER] = "cfg_scan_filter",
+    [GW_CFG_JSON_SECTION_COORDINATES] = "cfg_coordinates",
+    [GW_CFG_JSON_SECTION_FW_UPDATE]   = "cfg_fw_update",
+};
+
 bool
 settings_check_in_flash(void)
 {
@@ -81,6 +110,196 @@ settings_read_gw_cfg_json_from_nvs(nvs_handle handle)
     return p_cfg_json;
 }
 
+static bool
+settings_is_gw_cfg_sections_in_nvs(nvs_handle handle)
+{
+    uint8_t         fmt_version = 0;
+    const esp_err_t esp_err     = nvs_get_u8(handle, RUUVI_GATEWAY_NVS_CFG_SECT_FMT_KEY, &fmt_version);
+    if (ESP_OK != esp_err)
+    {
+        return false;
+    }
+    if (RUUVI_GATEWAY_NVS_CFG_SECT_FMT_VERSION != fmt_version)
+    {
+        LOG_WARN("Unsupported format version of config sections: %u", (printf_uint_t)fmt_version);
+        return false;
+    }
+    return true;
+}
+
+static void
+settings_erase_nvs_key_if_exist(nvs_handle handle, const char* const p_key)
+{
+    const esp_err_t esp_err = nvs_erase_key(handle, p_key);
+    if ((ESP_OK != esp_err) && (ESP_ERR_NVS_NOT_FOUND != esp_err))
+    {
+        LOG_ERR_ESP(esp_err, "Failed to erase key '%s'", p_key);
+    }
+}
+
+static void
+settings_erase_gw_cfg_sections(nvs_handle handle)
+{
+    if (!settings_is_gw_cfg_sections_in_nvs(handle))
+    {
+        return;
+    }
+    LOG_INFO("Erase config sections");
+    // Erase the format key first, so that partially erased sections are never used
+    settings_erase_nvs_key_if_exist(handle, RUUVI_GATEWAY_NVS_CFG_SECT_FMT_KEY);
+    for (uint32_t i = 0; i < GW_CFG_JSON_SECTION_NUM; ++i)
+    {
+        settings_erase_nvs_key_if_exist(handle, g_settings_cfg_sect_keys[i]);
+    }
+}
+
+static char*
+settings_read_gw_cfg_section_from_nvs(nvs_handle handle, const gw_cfg_json_section_e section)
+{
+    const char* const p_key     = g_settings_cfg_sect_keys[section];
+    size_t            blob_size = 0;
+    esp_err_t         esp_err   = nvs_get_blob(handle, p_key, NULL, &blob_size);
+    if (ESP_OK != esp_err)
+    {
+        LOG_ERR_ESP(esp_err, "Can't find config key '%s' in flash", p_key);
+        return NULL;
+    }
+    if (blob_size <= sizeof(settings_cfg_sect_hdr_t))
+    {
+        LOG_ERR("Invalid size of config section '%s': %lu", p_key, (printf_ulong_t)blob_size);
+        return NULL;
+    }
+
+    uint8_t* p_blob = os_malloc(blob_size);
+    if (NULL == p_blob)
+    {
+        LOG_ERR("Can't allocate %lu bytes for config section '%s'", (printf_ulong_t)blob_size, p_key);
+        return NULL;
+    }
+    esp_err = nvs_get_blob(handle, p_key, p_blob, &blob_size);
+    if (ESP_OK != esp_err)
+    {
+        LOG_ERR_ESP(esp_err, "Can't read config section from flash by key '%s'", p_key);
+        os_free(p_blob);
+        return NULL;
+    }
+
+    settings_cfg_sect_hdr_t hdr = { 0 };
+    memcpy(&hdr, p_blob, sizeof(hdr));
+    char* const  p_json_str = (char*)&p_blob[sizeof(hdr)];
+    const size_t json_len   = blob_size - sizeof(hdr) - 1;
+    if (('\0' != p_json_str[json_len]) || (json_len != strlen(p_json_str))
+        || (hdr.crc != crc32_le(0, (const uint8_t*)p_json_str, json_len)))
+    {
+        LOG_ERR("Config section '%s' is corrupted", p_key);
+        os_free(p_blob);
+        return NULL;
+    }
+    memmove(p_blob, p_json_str, json_len + 1);
+    return (char*)p_blob;
+}
+
+static bool
+settings_is_nvs_blob_equal(nvs_handle handle, const char* const p_key, const uint8_t* const p_blob, const size_t size)
+{
+    size_t    prev_size = 0;
+    esp_err_t esp_err   = nvs_get_blob(handle, p_key, NULL, &prev_size);
+    if ((ESP_OK != esp_err) || (prev_size != size))
+    {
+        return false;
+    }
+    uint8_t* p_prev_blob = os_malloc(prev_size);
+    if (NULL == p_prev_blob)
+    {
+        return false;
+    }
+    esp_err             = nvs_get_blob(handle, p_key, p_prev_blob, &prev_size);
+    const bool is_equal = ((ESP_OK == esp_err) && (prev_size == size) && (0 == memcmp(p_prev_blob, p_blob, size)))
+                              ? true
+                              : false;
+    os_free(p_prev_blob);
+    return is_equal;
+}
+
+static esp_err_t
+settings_write_gw_cfg_section_to_nvs_if_changed(
+    nvs_handle                  handle,
+    const gw_cfg_json_section_e section,
+    const char* const           p_json_str,
+    bool* const                 p_flag_updated)
+{
+    const char* const p_key     = g_settings_cfg_sect_keys[section];
+    const size_t      json_len  = strlen(p_json_str);
+    const size_t      blob_size = sizeof(settings_cfg_sect_hdr_t) + json_len + 1;
+
+    *p_flag_updated = false;
+
+    uint8_t* p_blob = os_malloc(blob_size);
+    if (NULL == p_blob)
+    {
+        LOG_ERR("Can't allocate %lu bytes for config section '%s'", (printf_ulong_t)blob_size, p_key);
+        return ESP_ERR_NO_MEM;
+    }
+    const settings_cfg_sect_hdr_t hdr = {
+        .crc = crc32_le(0, (const uint8_t*)p_json_str, json_len),
+    };
+    memcpy(p_blob, &hdr, sizeof(hdr));
+    memcpy(&p_blob[sizeof(hdr)], p_json_str, json_len + 1);
+
+    if (settings_is_nvs_blob_equal(handle, p_key, p_blob, blob_size))
+    {
+        os_free(p_blob);
+        return ESP_OK;
+    }
+    const esp_err_t err = nvs_set_blob(handle, p_key, p_blob, blob_size);
+    os_free(p_blob);
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed for key '%s'", "nvs_set_blob", p_key);
+        return err;
+    }
+    *p_flag_updated = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief Write the configuration to the legacy JSON key while switching to the sectioned format.
+ * @note The legacy key is written only once (if it differs from the saved one) and is not updated after that,
+ *       so the previous firmware (e.g. after the rollback of OTA) still finds a valid configuration,
+ *       but the regular saving writes only the modified sections.
+ */
+static esp_err_t
+settings_migrate_gw_cfg_json_in_nvs(nvs_handle handle, const gw_cfg_t* const p_gw_cfg)
+{
+    cjson_wrap_str_t json_str = cjson_wrap_str_null();
+    if (!gw_cfg_json_generate_for_saving(p_gw_cfg, &json_str))
+    {
+        LOG_ERR("%s failed", "gw_cfg_json_generate_for_saving");
+        return ESP_ERR_NO_MEM;
+    }
+
+    char* p_gw_cfg_prev = settings_read_gw_cfg_json_from_nvs(handle);
+    if (NULL != p_gw_cfg_prev)
+    {
+        const bool flag_is_cfg_equal = (0 == strcmp(p_gw_cfg_prev, json_str.p_str)) ? true : false;
+        os_free(p_gw_cfg_prev);
+        if (flag_is_cfg_equal)
+        {
+            cjson_wrap_free_json_str(&json_str);
+            return ESP_OK;
+        }
+    }
+    const esp_err_t err = nvs_set_str(handle, RUUVI_GATEWAY_NVS_CFG_JSON_KEY, json_str.p_str);
+    cjson_wrap_free_json_str(&json_str);
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "nvs_set_str");
+        return err;
+    }
+    LOG_INFO("Save config to NVS: legacy key '%s' updated", RUUVI_GATEWAY_NVS_CFG_JSON_KEY);
+    return ESP_OK;
+}
+
 static esp_err_t
 settings_save_to_flash_cjson_ret_err(const char* const p_json_str)
 {
@@ -93,6 +312,9 @@ settings_save_to_flash_cjson_ret_err(const char* const p_json_str)
         return ESP_FAIL;
     }
 
+    // The sectioned configuration takes precedence over the JSON key, so it must be removed
+    settings_erase_gw_cfg_sections(handle);
+
     char* p_gw_cfg_prev = settings_read_gw_cfg_json_from_nvs(handle);
     if (NULL == p_gw_cfg_prev)
     {
@@ -151,6 +373,97 @@ settings_save_to_flash_cjson(const char* const p_json_str)
     return true;
 }
 
+/**
+ * @brief Save the configuration as a set of independent sections, only the modified sections are rewritten.
+ * @note The sections are written before the format key, so if the power is lost during the first saving,
+ *       the previous configuration (the JSON key) is still used.
+ * @note The legacy JSON key is never erased here, it's written only once while switching to the sectioned format
+ *       and stays frozen after that, so the firmware which does not support the sections reads the configuration
+ *       which was actual at the moment of migration after a rollback.
+ */
+static esp_err_t
+settings_save_gw_cfg_sections_to_flash_ret_err(const gw_cfg_t* const p_gw_cfg)
+{
+    nvs_handle handle = 0;
+    if (!ruuvi_nvs_open(NVS_READWRITE, &handle))
+    {
+        LOG_ERR("Failed to open NVS for writing");
+        return ESP_FAIL;
+    }
+
+    uint32_t num_updated_sections = 0;
+    for (uint32_t i = 0; i < GW_CFG_JSON_SECTION_NUM; ++i)
+    {
+        const gw_cfg_json_section_e section  = (gw_cfg_json_section_e)i;
+        cjson_wrap_str_t            json_str = cjson_wrap_str_null();
+        if (!gw_cfg_json_generate_section_for_saving(p_gw_cfg, section, &json_str))
+        {
+            LOG_ERR("%s failed", "gw_cfg_json_generate_section_for_saving");
+            nvs_close(handle);
+            return ESP_ERR_NO_MEM;
+        }
+        LOG_DBG("Save config section '%s' to NVS: %s", g_settings_cfg_sect_keys[i], json_str.p_str);
+
+        bool            flag_updated = false;
+        const esp_err_t err = settings_write_gw_cfg_section_to_nvs_if_changed(
+            handle,
+            section,
+            json_str.p_str,
+            &flag_updated);
+        cjson_wrap_free_json_str(&json_str);
+        if (ESP_OK != err)
+        {
+            nvs_close(handle);
+            return err;
+        }
+        if (flag_updated)
+        {
+            LOG_INFO("Save config to NVS: section '%s' updated", g_settings_cfg_sect_keys[i]);
+            num_updated_sections += 1;
+        }
+    }
+
+    if (!settings_is_gw_cfg_sections_in_nvs(handle))
+    {
+        LOG_INFO("Switch config in NVS to the sectioned format");
+        esp_err_t err = settings_migrate_gw_cfg_json_in_nvs(handle, p_gw_cfg);
+        if (ESP_OK != err)
+        {
+            nvs_close(handle);
+            return err;
+        }
+        err = nvs_set_u8(handle, RUUVI_GATEWAY_NVS_CFG_SECT_FMT_KEY, RUUVI_GATEWAY_NVS_CFG_SECT_FMT_VERSION);
+        if (ESP_OK != err)
+        {
+            LOG_ERR_ESP(err, "%s failed", "nvs_set_u8");
+            nvs_close(handle);
+            return err;
+        }
+    }
+
+    const esp_err_t err = nvs_commit(handle);
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "nvs_commit");
+        nvs_close(handle);
+        return err;
+    }
+    nvs_close(handle);
+
+    if (0 == num_updated_sections)
+    {
+        LOG_INFO("### Save config to NVS: not needed (gw_cfg was not modified)");
+    }
+    else
+    {
+        LOG_INFO(
+            "### Save config to NVS: successfully updated %u of %u sections",
+            (printf_uint_t)num_updated_sections,
+            (printf_uint_t)GW_CFG_JSON_SECTION_NUM);
+    }
+    return ESP_OK;
+}
+
 void
 settings_save_to_flash(const gw_cfg_t* const p_gw_cfg)
 {
@@ -159,15 +472,50 @@ settings_save_to_flash(const gw_cfg_t* const p_gw_cfg)
         settings_save_to_flash_cjson("");
         return;
     }
-    cjson_wrap_str_t cjson_str = { 0 };
-    if (!gw_cfg_json_generate_for_saving(p_gw_cfg, &cjson_str))
+    esp_err_t err = settings_save_gw_cfg_sections_to_flash_ret_err(p_gw_cfg);
+    if (ESP_ERR_NVS_NOT_ENOUGH_SPACE == err)
     {
-        LOG_ERR("%s failed", "gw_cfg_json_generate_for_saving");
-        return;
+        LOG_ERR("There is not enough space in the NVS, possibly due to an update of too old firmware");
+        LOG_WARN("Try to erase NVS and write configuration again");
+        ruuvi_nvs_deinit();
+        ruuvi_nvs_erase();
+        ruuvi_nvs_init();
+        err = settings_save_gw_cfg_sections_to_flash_ret_err(p_gw_cfg);
+    }
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "Failed to save config to NVS");
     }
-    settings_save_to_flash_cjson(cjson_str.p_str);
+}
 
-    cjson_wrap_free_json_str(&cjson_str);
+static settings_in_nvs_status_e
+settings_get_gw_cfg_sections_from_nvs(nvs_handle handle, gw_cfg_t* const p_gw_cfg)
+{
+    char* arr_of_json_str[GW_CFG_JSON_SECTION_NUM] = { 0 };
+    for (uint32_t i = 0; i < GW_CFG_JSON_SECTION_NUM; ++i)
+    {
+        // A missing or corrupted section is replaced with the default values and rewritten on the next saving
+        arr_of_json_str[i] = settings_read_gw_cfg_section_from_nvs(handle, (gw_cfg_json_section_e)i);
+    }
+    const bool res = gw_cfg_json_parse_sections(
+        "NVS",
+        "Read config from NVS:",
+        (const char* const*)arr_of_json_str,
+        GW_CFG_JSON_SECTION_NUM,
+        p_gw_cfg);
+    for (uint32_t i = 0; i < GW_CFG_JSON_SECTION_NUM; ++i)
+    {
+        if (NULL != arr_of_json_str[i])
+        {
+            os_free(arr_of_json_str[i]);
+        }
+    }
+    if (!res)
+    {
+        LOG_ERR("Failed to parse config-json or no memory");
+        return SETTINGS_IN_NVS_STATUS_NOT_EXIST;
+    }
+    return SETTINGS_IN_NVS_STATUS_OK;
 }
 
 static settings_in_nvs_status_e
@@ -175,6 +523,11 @@ settings_get_gw_cfg_from_nvs(nvs_handle handle, gw_cfg_t* const p_gw_cfg)
 {
     gw_cfg_default_get(p_gw_cfg);
 
+    if (settings_is_gw_cfg_sections_in_nvs(handle))
+    {
+        return settings_get_gw_cfg_sections_from_nvs(handle, p_gw_cfg);
+    }
+
     char* p_cfg_json = settings_read_gw_cfg_json_from_nvs(handle);
     if (NULL == p_cfg_json)
     {
@@ -6,6 +6,7 @@
 #include <assert.h>
 #include <esp_attr.h>
 #include "os_mutex.h"
+#include "os_malloc.h"
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
 #include "log.h"
 static const char TAG[] = "tls_shared_buf";
@@ -71,6 +72,26 @@ tls_shared_buf_unlock_https_post(tls_shared_buf_https_post_t** p_p_buf)
     os_mutex_unlock(g_p_tls_shared_buf_mutex_https_post);
 }
 
+tls_shared_buf_https_post_t*
+tls_shared_buf_alloc_https_post(void)
+{
+    tls_shared_buf_https_post_t* p_buf = os_malloc(sizeof(*p_buf));
+    if (NULL == p_buf)
+    {
+        LOG_ERR("Can't allocate memory for https_post buffer");
+        return NULL;
+    }
+    return p_buf;
+}
+
+void
+tls_shared_buf_free_https_post(tls_shared_buf_https_post_t** p_p_buf)
+{
+    assert(NULL != p_p_buf);
+    assert(*p_p_buf != &g_tls_shared_buf.shared1.https_post);
+    os_free(*p_p_buf);
+}
+
 tls_shared_buf_mqtts_t*
 tls_shared_buf_get_mqtts(void)
 {
@@ -23,6 +23,9 @@
  *
  * Before starting an HTTPS download, @c gw_status_suspend_relaying must be called
  * to suspend HTTPS POST and MQTT tasks.
+ *
+ * Concurrent HTTPS POSTs to different targets (see http_async_slot_acquire) use the shared
+ * HTTPS POST buffer for the first request and heap-allocated buffers of the same size for the others.
  */
 
 #ifndef RUUVI_GATEWAY_ESP_TLS_SHARED_BUF_H
@@ -82,6 +85,24 @@ tls_shared_buf_get_https_post(void);
 void
 tls_shared_buf_unlock_https_post(tls_shared_buf_https_post_t** p_p_buf);
 
+/**
+ * @brief Allocate a private HTTPS POST TLS buffer from the heap.
+ *
+ * It's used for the additional concurrent HTTPS POST requests when the shared buffer is already in use.
+ *
+ * @return A pointer to the allocated buffer or NULL if there is not enough memory.
+ */
+tls_shared_buf_https_post_t*
+tls_shared_buf_alloc_https_post(void);
+
+/**
+ * @brief Free the HTTPS POST TLS buffer allocated by @c tls_shared_buf_alloc_https_post.
+ *
+ * @param[in,out] p_p_buf Pointer to the buffer pointer. It will be set to NULL after freeing.
+ */
+void
+tls_shared_buf_free_https_post(tls_shared_buf_https_post_t** p_p_buf);
+
 /**
  * @brief Get access to the MQTT TLS shared buffer.
  *
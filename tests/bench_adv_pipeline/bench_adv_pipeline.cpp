@@ -0,0 +1,619 @@
+/**
+ * @file bench_adv_pipeline.cpp
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Host-side throughput benchmark of the path which every received advertisement goes through:
+ * nRF52 UART callback -> adv_ring -> adv_table -> JSON generation for HTTP POST -> HMAC_SHA256 of the body.
+ *
+ * Usage: ruuvi_gateway_esp-bench-adv_pipeline [--num-tags N] [--rate ADVS_PER_SEC] [--duration SEC]
+ *                                              [--post-period SEC] [--drain-every N] [--decode] [--output FILE]
+ *
+ * The time is virtual: advertisements are fed as fast as possible, --rate and --post-period only define
+ * how many advertisements are accumulated in adv_table between two HTTP POSTs.
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "os_malloc.h"
+#include "os_mutex.h"
+#include "str_buf.h"
+#include "mac_addr.h"
+#include "json_stream_gen.h"
+#include "ruuvi_endpoint_ca_uart.h"
+#include "adv_post_recv.h"
+#include "adv_post_cfg_cache.h"
+#include "adv_post_nrf52.h"
+#include "adv_post_signals.h"
+#include "adv_post_timers.h"
+#include "adv_ring.h"
+#include "adv_table.h"
+#include "event_mgr.h"
+#include "gw_cfg.h"
+#include "hmac_sha256.h"
+#include "http_json.h"
+#include "metrics.h"
+#include "runtime_stat.h"
+#include "time_task.h"
+
+using namespace std;
+
+typedef struct bench_cfg_t
+{
+    uint32_t    num_tags;
+    uint32_t    rate;
+    uint32_t    duration;
+    uint32_t    post_period;
+    uint32_t    drain_every;
+    bool        flag_decode;
+    const char* p_output;
+} bench_cfg_t;
+
+typedef struct bench_stage_t
+{
+    const char* p_name;
+    uint64_t    total_ns;
+} bench_stage_t;
+
+typedef enum bench_stage_e
+{
+    BENCH_STAGE_INGEST,
+    BENCH_STAGE_ADV_TABLE,
+    BENCH_STAGE_JSON_GEN,
+    BENCH_STAGE_HMAC,
+    BENCH_STAGE_NUM,
+} bench_stage_e;
+
+typedef struct bench_mem_stat_t
+{
+    uint64_t malloc_cnt;
+    uint64_t bytes_allocated;
+    uint64_t cur_heap;
+    uint64_t peak_heap;
+} bench_mem_stat_t;
+
+static bench_mem_stat_t g_mem_stat;
+static bool             g_flag_sig_recv_adv;
+static uint64_t         g_received_advs_cnt;
+static uint32_t         g_event_recv_adv_cnt;
+
+/*** Mocks
+ * ***************************************************************************************************************/
+
+extern "C" {
+
+// Every allocated block is prefixed with a header which keeps the size of the block,
+// so that the current and the peak heap usage can be tracked.
+typedef union bench_mem_hdr_t
+{
+    size_t      size;
+    max_align_t align;
+} bench_mem_hdr_t;
+
+static void*
+bench_mem_alloc(const size_t size, const bool flag_clear)
+{
+    bench_mem_hdr_t* const p_hdr = static_cast<bench_mem_hdr_t*>(
+        flag_clear ? calloc(1, sizeof(bench_mem_hdr_t) + size) : malloc(sizeof(bench_mem_hdr_t) + size));
+    if (nullptr == p_hdr)
+    {
+        return nullptr;
+    }
+    p_hdr->size = size;
+    g_mem_stat.malloc_cnt += 1;
+    g_mem_stat.bytes_allocated += size;
+    g_mem_stat.cur_heap += size;
+    if (g_mem_stat.cur_heap > g_mem_stat.peak_heap)
+    {
+        g_mem_stat.peak_heap = g_mem_stat.cur_heap;
+    }
+    return p_hdr + 1;
+}
+
+void*
+os_malloc(const size_t size)
+{
+    return bench_mem_alloc(size, false);
+}
+
+void*
+os_calloc(const size_t nmemb, const size_t size)
+{
+    return bench_mem_alloc(nmemb * size, true);
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    if (nullptr == p_mem)
+    {
+        return;
+    }
+    bench_mem_hdr_t* const p_hdr = static_cast<bench_mem_hdr_t*>(p_mem) - 1;
+    g_mem_stat.cur_heap -= p_hdr->size;
+    free(p_hdr);
+}
+
+// The benchmark is single-threaded, so the mutexes are not needed.
+os_mutex_t
+os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
+{
+    return reinterpret_cast<os_mutex_t>(p_mutex_static);
+}
+
+void
+os_mutex_delete(os_mutex_t* const ph_mutex)
+{
+    *ph_mutex = nullptr;
+}
+
+void
+os_mutex_lock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
+bool
+os_mutex_try_lock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+    return true;
+}
+
+void
+os_mutex_unlock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
+bool
+adv_post_nrf52_is_configured(void)
+{
+    return true;
+}
+
+bool
+gw_cfg_is_initialized(void)
+{
+    return true;
+}
+
+bool
+time_is_synchronized(void)
+{
+    return true;
+}
+
+TickType_t
+xTaskGetTickCount(void)
+{
+    return 0;
+}
+
+void
+adv_post_signals_send_sig(const adv_post_sig_e adv_post_sig)
+{
+    if (ADV_POST_SIG_RECV_ADV == adv_post_sig)
+    {
+        g_flag_sig_recv_adv = true;
+    }
+}
+
+void
+adv_post_timers_relaunch_timer_sig_recv_adv_timeout(void)
+{
+}
+
+void
+event_mgr_notify(const event_mgr_ev_e event)
+{
+    if (EVENT_MGR_EV_RECV_ADV == event)
+    {
+        g_event_recv_adv_cnt += 1;
+    }
+}
+
+void
+event_mgr_set_edge_triggered(const event_mgr_ev_e event, const uint32_t max_coalescing_period_ms)
+{
+}
+
+uint64_t
+metrics_received_advs_get(void)
+{
+    return g_received_advs_cnt;
+}
+
+void
+metrics_received_advs_increment(const re_ca_uart_ble_phy_e secondary_phy)
+{
+    (void)secondary_phy;
+    g_received_advs_cnt += 1;
+}
+
+bool
+runtime_stat_for_each_accumulated_info(runtime_stat_cb_t p_cb, void* p_userdata)
+{
+    (void)p_cb;
+    (void)p_userdata;
+    return true;
+}
+
+} // extern "C"
+
+/*** Benchmark
+ * ***********************************************************************************************************/
+
+static uint64_t
+bench_get_time_ns(void)
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+static bool
+bench_parse_u32(const char* const p_str, uint32_t* const p_val)
+{
+    char*               p_end = nullptr;
+    const unsigned long val   = strtoul(p_str, &p_end, 10);
+    if ((p_end == p_str) || ('\0' != *p_end) || (0 == val) || (val > UINT32_MAX))
+    {
+        return false;
+    }
+    *p_val = static_cast<uint32_t>(val);
+    return true;
+}
+
+static bool
+bench_parse_args(const int argc, char** const argv, bench_cfg_t* const p_cfg)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* const p_arg = argv[i];
+        const char* const p_val = ((i + 1) < argc) ? argv[i + 1] : nullptr;
+        uint32_t*         p_u32 = nullptr;
+        if (0 == strcmp(p_arg, "--decode"))
+        {
+            p_cfg->flag_decode = true;
+            continue;
+        }
+        if (nullptr == p_val)
+        {
+            fprintf(stderr, "Missing value for %s\n", p_arg);
+            return false;
+        }
+        i += 1;
+        if (0 == strcmp(p_arg, "--output"))
+        {
+            p_cfg->p_output = p_val;
+            continue;
+        }
+        if (0 == strcmp(p_arg, "--num-tags"))
+        {
+            p_u32 = &p_cfg->num_tags;
+        }
+        else if (0 == strcmp(p_arg, "--rate"))
+        {
+            p_u32 = &p_cfg->rate;
+        }
+        else if (0 == strcmp(p_arg, "--duration"))
+        {
+            p_u32 = &p_cfg->duration;
+        }
+        else if (0 == strcmp(p_arg, "--post-period"))
+        {
+            p_u32 = &p_cfg->post_period;
+        }
+        else if (0 == strcmp(p_arg, "--drain-every"))
+        {
+            p_u32 = &p_cfg->drain_every;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option: %s\n", p_arg);
+            return false;
+        }
+        if (!bench_parse_u32(p_val, p_u32))
+        {
+            fprintf(stderr, "Invalid value for %s: %s\n", p_arg, p_val);
+            return false;
+        }
+    }
+    if (p_cfg->num_tags > ADV_TABLE_CAPACITY)
+    {
+        fprintf(stderr, "--num-tags must not exceed %u\n", (unsigned)ADV_TABLE_CAPACITY);
+        return false;
+    }
+    if (p_cfg->drain_every > ADV_RING_SIZE)
+    {
+        fprintf(stderr, "--drain-every must not exceed %u\n", (unsigned)ADV_RING_SIZE);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Generate the advertisement in Ruuvi data format 5 (RAWv2) as it's received from nRF52.
+ * @param tag_idx - index of the tag (it defines the MAC address)
+ * @param seq_num - sequence number of the advertisement (it's written to the measurement sequence number field,
+ *                  so that every advertisement from the same tag has different data)
+ * @param[out] p_payload - ptr to the output buffer
+ */
+static void
+bench_gen_uart_payload(const uint32_t tag_idx, const uint32_t seq_num, re_ca_uart_payload_t* const p_payload)
+{
+    static const uint8_t g_adv_template[] = {
+        0x02U, 0x01U, 0x06U, 0x1BU, 0xFFU, 0x99U, 0x04U, 0x05U, 0x15U, 0x71U, 0x4DU, 0x9FU, 0xC5U, 0x6DU, 0xFFU, 0xF0U,
+        0xFFU, 0xF8U, 0x03U, 0xE4U, 0xB5U, 0x16U, 0xE8U, 0x4DU, 0x7EU, 0xF4U, 0x1FU, 0x0CU, 0x28U, 0xCBU, 0xD6U,
+    };
+    const size_t measurement_seq_num_offset = 23U;
+
+    memset(p_payload, 0, sizeof(*p_payload));
+    p_payload->cmd                       = RE_CA_UART_ADV_RPRT2;
+    re_ca_uart_ble_adv_t* const p_report = &p_payload->params.adv;
+    p_report->mac[0]                     = 0xC0U;
+    p_report->mac[1]                     = 0xFFU;
+    p_report->mac[2]                     = 0xEEU;
+    p_report->mac[3]                     = static_cast<uint8_t>((tag_idx >> 16U) & 0xFFU);
+    p_report->mac[4]                     = static_cast<uint8_t>((tag_idx >> 8U) & 0xFFU);
+    p_report->mac[5]                     = static_cast<uint8_t>(tag_idx & 0xFFU);
+    p_report->rssi_db                    = static_cast<int8_t>(-40 - static_cast<int32_t>(tag_idx % 50U));
+    p_report->primary_phy                = RE_CA_UART_BLE_PHY_1MBPS;
+    p_report->secondary_phy              = RE_CA_UART_BLE_PHY_NOT_SET;
+    p_report->ch_index                   = static_cast<uint8_t>(37U + (seq_num % 3U));
+    p_report->is_coded_phy               = false;
+    p_report->tx_power                   = RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID;
+    p_report->adv_len                    = sizeof(g_adv_template);
+    memcpy(p_report->adv, g_adv_template, sizeof(g_adv_template));
+    p_report->adv[measurement_seq_num_offset]      = static_cast<uint8_t>((seq_num >> 8U) & 0xFFU);
+    p_report->adv[measurement_seq_num_offset + 1U] = static_cast<uint8_t>(seq_num & 0xFFU);
+}
+
+static void
+bench_drain_ring(bench_stage_t* const p_stages)
+{
+    if (!g_flag_sig_recv_adv)
+    {
+        return;
+    }
+    g_flag_sig_recv_adv = false;
+
+    const uint64_t t0 = bench_get_time_ns();
+    adv_post_on_recv_advs();
+    p_stages[BENCH_STAGE_ADV_TABLE].total_ns += bench_get_time_ns() - t0;
+}
+
+static bool
+bench_post_advs(
+    const bench_cfg_t* const p_cfg,
+    const uint32_t           nonce,
+    bench_stage_t* const     p_stages,
+    uint64_t* const          p_json_bytes,
+    uint64_t* const          p_num_advs_posted)
+{
+    static const mac_address_str_t g_gw_mac_addr = { "C8:25:2D:8E:9C:2C" };
+
+    const uint64_t t0 = bench_get_time_ns();
+
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    if (nullptr == p_snapshot)
+    {
+        fprintf(stderr, "Not enough memory for adv_table snapshot\n");
+        return false;
+    }
+    *p_num_advs_posted += adv_table_snapshot_get_num_of_advs(p_snapshot);
+
+    str_buf_t coordinates_str_buf = str_buf_printf_with_alloc("%s", "");
+
+    const http_json_create_stream_gen_advs_params_t params = {
+        .flag_raw_data       = true,
+        .flag_decode         = p_cfg->flag_decode,
+        .flag_use_timestamps = true,
+        .cur_time            = time(nullptr),
+        .flag_use_nonce      = true,
+        .nonce               = nonce,
+        .p_mac_addr          = &g_gw_mac_addr,
+        .coordinates_str_buf = coordinates_str_buf,
+    };
+    json_stream_gen_t* p_gen = http_json_create_stream_gen_advs_from_snapshot(p_snapshot, &params);
+    str_buf_free_buf(&coordinates_str_buf);
+    if (nullptr == p_gen)
+    {
+        fprintf(stderr, "Not enough memory for json_stream_gen\n");
+        adv_table_snapshot_release(&p_snapshot);
+        return false;
+    }
+
+    string json_str;
+    while (true)
+    {
+        const char* const p_chunk = json_stream_gen_get_next_chunk(p_gen);
+        if (nullptr == p_chunk)
+        {
+            fprintf(stderr, "json_stream_gen_get_next_chunk failed\n");
+            json_stream_gen_delete(&p_gen);
+            adv_table_snapshot_release(&p_snapshot);
+            return false;
+        }
+        if ('\0' == *p_chunk)
+        {
+            break;
+        }
+        json_str += p_chunk;
+    }
+    json_stream_gen_delete(&p_gen);
+    adv_table_snapshot_release(&p_snapshot);
+    *p_json_bytes += json_str.size();
+
+    const uint64_t t1 = bench_get_time_ns();
+    p_stages[BENCH_STAGE_JSON_GEN].total_ns += t1 - t0;
+
+    hmac_sha256_t hmac_sha256 = {};
+    if (!hmac_sha256_calc_for_http_ruuvi(json_str.c_str(), &hmac_sha256))
+    {
+        fprintf(stderr, "hmac_sha256_calc_for_http_ruuvi failed\n");
+        return false;
+    }
+    p_stages[BENCH_STAGE_HMAC].total_ns += bench_get_time_ns() - t1;
+    return true;
+}
+
+static void
+bench_write_report(
+    FILE* const                p_file,
+    const bench_cfg_t* const   p_cfg,
+    const bench_stage_t* const p_stages,
+    const uint64_t             num_advs,
+    const uint64_t             num_advs_posted,
+    const uint32_t             num_posts,
+    const uint64_t             json_bytes)
+{
+    uint64_t total_ns = 0;
+    for (uint32_t i = 0; i < BENCH_STAGE_NUM; ++i)
+    {
+        total_ns += p_stages[i].total_ns;
+    }
+    const double advs_per_sec = (0 != total_ns) ? ((double)num_advs * 1e9 / (double)total_ns) : 0.0;
+
+    fprintf(p_file, "{\n");
+    fprintf(p_file, "  \"benchmark\": \"adv_pipeline\",\n");
+    fprintf(p_file, "  \"config\": {\n");
+    fprintf(p_file, "    \"num_tags\": %" PRIu32 ",\n", p_cfg->num_tags);
+    fprintf(p_file, "    \"rate\": %" PRIu32 ",\n", p_cfg->rate);
+    fprintf(p_file, "    \"duration\": %" PRIu32 ",\n", p_cfg->duration);
+    fprintf(p_file, "    \"post_period\": %" PRIu32 ",\n", p_cfg->post_period);
+    fprintf(p_file, "    \"drain_every\": %" PRIu32 ",\n", p_cfg->drain_every);
+    fprintf(p_file, "    \"decode\": %s\n", p_cfg->flag_decode ? "true" : "false");
+    fprintf(p_file, "  },\n");
+    fprintf(p_file, "  \"num_advs\": %" PRIu64 ",\n", num_advs);
+    fprintf(p_file, "  \"num_advs_posted\": %" PRIu64 ",\n", num_advs_posted);
+    fprintf(p_file, "  \"num_posts\": %" PRIu32 ",\n", num_posts);
+    fprintf(p_file, "  \"json_bytes\": %" PRIu64 ",\n", json_bytes);
+    fprintf(p_file, "  \"total_ns\": %" PRIu64 ",\n", total_ns);
+    fprintf(p_file, "  \"advs_per_sec\": %.1f,\n", advs_per_sec);
+    fprintf(p_file, "  \"stages\": {\n");
+    for (uint32_t i = 0; i < BENCH_STAGE_NUM; ++i)
+    {
+        fprintf(
+            p_file,
+            "    \"%s\": {\"total_ns\": %" PRIu64 ", \"ns_per_adv\": %.1f}%s\n",
+            p_stages[i].p_name,
+            p_stages[i].total_ns,
+            (0 != num_advs) ? ((double)p_stages[i].total_ns / (double)num_advs) : 0.0,
+            ((i + 1) < BENCH_STAGE_NUM) ? "," : "");
+    }
+    fprintf(p_file, "  },\n");
+    fprintf(p_file, "  \"memory\": {\n");
+    fprintf(p_file, "    \"malloc_cnt\": %" PRIu64 ",\n", g_mem_stat.malloc_cnt);
+    fprintf(p_file, "    \"bytes_allocated\": %" PRIu64 ",\n", g_mem_stat.bytes_allocated);
+    fprintf(p_file, "    \"peak_heap\": %" PRIu64 "\n", g_mem_stat.peak_heap);
+    fprintf(p_file, "  }\n");
+    fprintf(p_file, "}\n");
+}
+
+int
+main(int argc, char** argv)
+{
+    bench_cfg_t cfg = {
+        .num_tags    = 100,
+        .rate        = 200,
+        .duration    = 600,
+        .post_period = 10,
+        .drain_every = 16,
+        .flag_decode = false,
+        .p_output    = "bench_adv_pipeline.json",
+    };
+    if (!bench_parse_args(argc, argv, &cfg))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // The order must match bench_stage_e
+    bench_stage_t stages[BENCH_STAGE_NUM] = {
+        { "ingest", 0 },
+        { "adv_table", 0 },
+        { "json_gen", 0 },
+        { "hmac", 0 },
+    };
+
+    adv_table_init();
+    adv_post_cfg_cache_init();
+    adv_post_recv_init();
+    {
+        adv_post_cfg_cache_t* p_cfg_cache = adv_post_cfg_cache_mutex_lock();
+        p_cfg_cache->flag_use_ntp         = true;
+        adv_post_cfg_cache_mutex_unlock(&p_cfg_cache);
+    }
+    if (!hmac_sha256_set_key_for_http_ruuvi("C8:25:2D:8E:9C:2C"))
+    {
+        fprintf(stderr, "hmac_sha256_set_key_for_http_ruuvi failed\n");
+        return EXIT_FAILURE;
+    }
+
+    const uint64_t num_advs_per_post = (uint64_t)cfg.rate * cfg.post_period;
+    const uint32_t num_posts         = (cfg.duration + cfg.post_period - 1) / cfg.post_period;
+
+    re_ca_uart_payload_t payload         = {};
+    uint64_t             num_advs        = 0;
+    uint64_t             num_advs_posted = 0;
+    uint64_t             json_bytes      = 0;
+    for (uint32_t post_idx = 0; post_idx < num_posts; ++post_idx)
+    {
+        for (uint64_t i = 0; i < num_advs_per_post; ++i)
+        {
+            bench_gen_uart_payload(
+                static_cast<uint32_t>(num_advs % cfg.num_tags),
+                static_cast<uint32_t>(num_advs / cfg.num_tags),
+                &payload);
+            num_advs += 1;
+
+            const uint64_t t0 = bench_get_time_ns();
+            adv_post_recv_nrf52_cb_on_recv_adv(&payload);
+            stages[BENCH_STAGE_INGEST].total_ns += bench_get_time_ns() - t0;
+
+            // adv_post_task is woken up by the first advertisement, but while it's waiting for CPU,
+            // the UART task continues to push advertisements to the ring, so they are handled in batches.
+            if (0 == (num_advs % cfg.drain_every))
+            {
+                bench_drain_ring(stages);
+            }
+        }
+        bench_drain_ring(stages);
+        if (!bench_post_advs(&cfg, post_idx, stages, &json_bytes, &num_advs_posted))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    adv_table_deinit();
+
+    bench_write_report(stdout, &cfg, stages, num_advs, num_advs_posted, num_posts, json_bytes);
+    fprintf(
+        stderr,
+        "adv_ring: high water mark=%" PRIu32 ", overflow=%" PRIu32 "; EVENT_MGR_EV_RECV_ADV notifications: %" PRIu32
+        "\n",
+        adv_ring_get_high_water_mark(),
+        adv_ring_get_overflow_cnt(),
+        g_event_recv_adv_cnt);
+
+    FILE* const p_file = fopen(cfg.p_output, "w");
+    if (nullptr == p_file)
+    {
+        fprintf(stderr, "Can't open file: %s\n", cfg.p_output);
+        return EXIT_FAILURE;
+    }
+    bench_write_report(p_file, &cfg, stages, num_advs, num_advs_posted, num_posts, json_bytes);
+    fclose(p_file);
+
+    if (0 != adv_ring_get_overflow_cnt())
+    {
+        fprintf(stderr, "adv_ring overflow: some advertisements were lost\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
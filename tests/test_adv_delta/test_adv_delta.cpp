@@ -0,0 +1,242 @@
+/**
+ * @file test_adv_delta.cpp
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "adv_delta.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include "os_malloc.h"
+
+using namespace std;
+
+class TestAdvDelta;
+
+static TestAdvDelta* g_pTestClass;
+
+/*** Google-test class implementation
+ * *********************************************************************************/
+
+class TestAdvDelta : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        this->m_malloc_cnt         = 0;
+        this->m_malloc_fail_on_cnt = 0;
+        this->m_num_allocated      = 0;
+        g_pTestClass               = this;
+    }
+
+    void
+    TearDown() override
+    {
+        g_pTestClass = nullptr;
+    }
+
+public:
+    TestAdvDelta();
+
+    ~TestAdvDelta() override;
+
+    uint32_t m_malloc_cnt {};
+    uint32_t m_malloc_fail_on_cnt {};
+    uint32_t m_num_allocated {};
+};
+
+TestAdvDelta::TestAdvDelta()
+    : Test()
+{
+}
+
+TestAdvDelta::~TestAdvDelta() = default;
+
+extern "C" {
+
+void*
+os_calloc(const size_t nmemb, const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    g_pTestClass->m_num_allocated += 1;
+    return calloc(nmemb, size);
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    assert(nullptr != g_pTestClass);
+    assert(0 != g_pTestClass->m_num_allocated);
+    g_pTestClass->m_num_allocated -= 1;
+    free(p_mem);
+}
+
+} // extern "C"
+
+static adv_report_t
+gen_adv(const uint8_t mac_lo, const uint8_t data)
+{
+    adv_report_t adv = {
+        .timestamp = 1612358929,
+        .tag_mac   = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, mac_lo },
+        .rssi      = -70,
+        .data_len  = 1,
+    };
+    adv.data_buf[0] = data;
+    return adv;
+}
+
+/*** Unit-Tests
+ * *******************************************************************************************************/
+
+TEST_F(TestAdvDelta, test_create_invalid_params) // NOLINT
+{
+    ASSERT_EQ(nullptr, adv_delta_create(0, 10));
+    ASSERT_EQ(nullptr, adv_delta_create(10, 0));
+    ASSERT_EQ(0, this->m_malloc_cnt);
+}
+
+TEST_F(TestAdvDelta, test_create_malloc_failed) // NOLINT
+{
+    this->m_malloc_fail_on_cnt = 1;
+    ASSERT_EQ(nullptr, adv_delta_create(10, 10));
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvDelta, test_keyframe_interval) // NOLINT
+{
+    adv_delta_t* p_delta = adv_delta_create(10, 3);
+    ASSERT_NE(nullptr, p_delta);
+    ASSERT_EQ(1, this->m_num_allocated);
+
+    adv_report_t adv_prev = {};
+
+    // The first message is a keyframe
+    const adv_report_t adv1 = gen_adv(0x01, 0x10);
+    ASSERT_FALSE(adv_delta_get_prev(p_delta, &adv1.tag_mac, &adv_prev));
+    adv_delta_commit(p_delta, &adv1);
+    ASSERT_EQ(1, adv_delta_get_num_of_tags(p_delta));
+
+    // The second and the third messages are deltas against the previously published ones
+    const adv_report_t adv2 = gen_adv(0x01, 0x11);
+    ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv2.tag_mac, &adv_prev));
+    ASSERT_EQ(0x10, adv_prev.data_buf[0]);
+    ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv2.tag_mac, &adv_prev)); // The result is stable until commit
+    ASSERT_EQ(0x10, adv_prev.data_buf[0]);
+    adv_delta_commit(p_delta, &adv2);
+
+    const adv_report_t adv3 = gen_adv(0x01, 0x12);
+    ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv3.tag_mac, &adv_prev));
+    ASSERT_EQ(0x11, adv_prev.data_buf[0]);
+    adv_delta_commit(p_delta, &adv3);
+
+    // The fourth message is a keyframe again
+    const adv_report_t adv4 = gen_adv(0x01, 0x13);
+    ASSERT_FALSE(adv_delta_get_prev(p_delta, &adv4.tag_mac, &adv_prev));
+    adv_delta_commit(p_delta, &adv4);
+
+    const adv_report_t adv5 = gen_adv(0x01, 0x14);
+    ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv5.tag_mac, &adv_prev));
+    ASSERT_EQ(0x13, adv_prev.data_buf[0]);
+
+    // Another tag starts with a keyframe
+    const adv_report_t adv_other = gen_adv(0x02, 0x20);
+    ASSERT_FALSE(adv_delta_get_prev(p_delta, &adv_other.tag_mac, &adv_prev));
+
+    adv_delta_delete(&p_delta);
+    ASSERT_EQ(nullptr, p_delta);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvDelta, test_keyframe_interval_1) // NOLINT
+{
+    adv_delta_t* p_delta = adv_delta_create(10, 1);
+    ASSERT_NE(nullptr, p_delta);
+
+    adv_report_t adv_prev = {};
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        const adv_report_t adv = gen_adv(0x01, i);
+        ASSERT_FALSE(adv_delta_get_prev(p_delta, &adv.tag_mac, &adv_prev));
+        adv_delta_commit(p_delta, &adv);
+    }
+    adv_delta_delete(&p_delta);
+}
+
+TEST_F(TestAdvDelta, test_sorted_lookup) // NOLINT
+{
+    adv_delta_t* p_delta = adv_delta_create(100, 100);
+    ASSERT_NE(nullptr, p_delta);
+
+    // Insert tags in a shuffled order
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        const auto         mac_lo = static_cast<uint8_t>((i * 37U) % 100U);
+        const adv_report_t adv    = gen_adv(mac_lo, mac_lo);
+        adv_delta_commit(p_delta, &adv);
+    }
+    ASSERT_EQ(100, adv_delta_get_num_of_tags(p_delta));
+    for (uint8_t mac_lo = 0; mac_lo < 100; ++mac_lo)
+    {
+        const adv_report_t adv      = gen_adv(mac_lo, 0);
+        adv_report_t       adv_prev = {};
+        ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv.tag_mac, &adv_prev));
+        ASSERT_EQ(mac_lo, adv_prev.data_buf[0]);
+        ASSERT_EQ(0, memcmp(&adv.tag_mac, &adv_prev.tag_mac, sizeof(adv.tag_mac)));
+    }
+    adv_delta_delete(&p_delta);
+}
+
+TEST_F(TestAdvDelta, test_evict_least_recently_committed) // NOLINT
+{
+    adv_delta_t* p_delta = adv_delta_create(3, 100);
+    ASSERT_NE(nullptr, p_delta);
+
+    adv_report_t       adv_prev = {};
+    const adv_report_t adv1     = gen_adv(0x01, 0x10);
+    const adv_report_t adv2     = gen_adv(0x02, 0x20);
+    const adv_report_t adv3     = gen_adv(0x03, 0x30);
+    const adv_report_t adv4     = gen_adv(0x04, 0x40);
+    adv_delta_commit(p_delta, &adv2);
+    adv_delta_commit(p_delta, &adv1);
+    adv_delta_commit(p_delta, &adv3);
+    adv_delta_commit(p_delta, &adv2); // adv1 becomes the least recently committed
+
+    adv_delta_commit(p_delta, &adv4);
+    ASSERT_EQ(3, adv_delta_get_num_of_tags(p_delta));
+    ASSERT_FALSE(adv_delta_get_prev(p_delta, &adv1.tag_mac, &adv_prev));
+    ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv2.tag_mac, &adv_prev));
+    ASSERT_EQ(0x20, adv_prev.data_buf[0]);
+    ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv3.tag_mac, &adv_prev));
+    ASSERT_EQ(0x30, adv_prev.data_buf[0]);
+    // adv4 was just inserted, so its next message is a delta
+    ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv4.tag_mac, &adv_prev));
+    ASSERT_EQ(0x40, adv_prev.data_buf[0]);
+
+    adv_delta_delete(&p_delta);
+}
+
+TEST_F(TestAdvDelta, test_reset) // NOLINT
+{
+    adv_delta_t* p_delta = adv_delta_create(10, 100);
+    ASSERT_NE(nullptr, p_delta);
+
+    adv_report_t       adv_prev = {};
+    const adv_report_t adv1     = gen_adv(0x01, 0x10);
+    adv_delta_commit(p_delta, &adv1);
+    ASSERT_TRUE(adv_delta_get_prev(p_delta, &adv1.tag_mac, &adv_prev));
+
+    adv_delta_reset(p_delta);
+    ASSERT_EQ(0, adv_delta_get_num_of_tags(p_delta));
+    ASSERT_FALSE(adv_delta_get_prev(p_delta, &adv1.tag_mac, &adv_prev));
+
+    adv_delta_delete(&p_delta);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
@@ -13,6 +13,8 @@
 #include "adv_mqtt_cfg_cache.h"
 #include "event_mgr.h"
 #include "gw_cfg_default.h"
+#include "mqtt.h"
+#include "metrics.h"
 
 using namespace std;
 
@@ -35,7 +37,11 @@ enum event_type_e
     EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK,
     EVENT_HISTORY_ADV_MQTT_TIMER_SIG_RETRY_SENDING_ADVS,
     EVENT_HISTORY_MQTT_PUBLISH_CONNECT,
+    EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT,
     EVENT_HISTORY_MQTT_PUBLISH_ADV,
+    EVENT_HISTORY_MQTT_PUBLISH_ADVS,
+    EVENT_HISTORY_ADV_TABLE_SNAPSHOT_RELEASE,
+    EVENT_HISTORY_GATEWAY_RESTART_LOW_MEMORY,
     EVENT_HISTORY_EVENT_MGR_NOTIFY,
     EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP,
     EVENT_HISTORY_GW_CFG_LOCK,
@@ -59,6 +65,15 @@ typedef struct event_info_t
         {
             event_mgr_ev_e event;
         } event_mgr_notify;
+        struct
+        {
+            bool   flag_use_timestamps;
+            time_t timestamp;
+        } mqtt_publish_ctx_init;
+        struct
+        {
+            num_of_advs_t num_of_advs;
+        } mqtt_publish_advs;
     };
 } event_info_t;
 
@@ -146,11 +161,17 @@ protected:
         this->m_gw_status_is_relaying_via_mqtt_enabled         = true;
         this->m_time_is_synchronized                           = true;
         this->m_metrics_received_advs                          = 0;
-        this->adv_table_read_retransmission_list3_head_res     = true;
-        this->adv_table_read_retransmission_list3_is_empty_res = true;
+        this->m_list3_num_advs                                 = 0;
         this->m_adv_report                                     = {};
+        this->m_snapshot_num_advs                              = 0;
+        this->m_snapshot_is_allocated                          = false;
+        this->m_snapshot_fail                                  = false;
         this->mqtt_is_buffer_available_for_publish_res         = true;
+        this->mqtt_is_buffer_available_for_publish_max_cnt     = UINT32_MAX;
         this->mqtt_publish_adv_res                             = true;
+        this->mqtt_publish_advs_max_num                        = UINT32_MAX;
+        this->m_tick_count                                     = 0;
+        this->m_latency_history.clear();
         this->m_network_timeout_check_res                      = false;
         this->m_adv_mqtt_cfg_cache                             = {};
         this->m_gw_cfg                                         = {};
@@ -180,11 +201,18 @@ public:
 
     bool                      m_time_is_synchronized { true };
     uint64_t                  m_metrics_received_advs { 0 };
-    bool                      adv_table_read_retransmission_list3_head_res { true };
-    bool                      adv_table_read_retransmission_list3_is_empty_res { true };
+    num_of_advs_t             m_list3_num_advs { 0 };
     adv_report_t              m_adv_report {};
+    num_of_advs_t             m_snapshot_num_advs { 0 };
+    bool                      m_snapshot_is_allocated { false };
+    bool                      m_snapshot_fail { false };
+    adv_table_snapshot_t*     m_p_snapshot { reinterpret_cast<adv_table_snapshot_t*>(&m_snapshot_num_advs) };
     bool                      mqtt_publish_adv_res { true };
+    num_of_advs_t             mqtt_publish_advs_max_num { UINT32_MAX };
     bool                      mqtt_is_buffer_available_for_publish_res { true };
+    uint32_t                  mqtt_is_buffer_available_for_publish_max_cnt { UINT32_MAX };
+    TickType_t                m_tick_count { 0 };
+    std::vector<uint32_t>     m_latency_history {};
     bool                      m_network_timeout_check_res { false };
     adv_mqtt_cfg_cache_t      m_adv_mqtt_cfg_cache {};
     std::vector<event_info_t> m_events_history {};
@@ -393,14 +421,82 @@ metrics_received_advs_get(void)
 bool
 adv_table_read_retransmission_list3_head(adv_report_t* const p_adv_report)
 {
+    if (0 == g_pTestClass->m_list3_num_advs)
+    {
+        return false;
+    }
+    g_pTestClass->m_list3_num_advs -= 1;
     *p_adv_report = g_pTestClass->m_adv_report;
-    return g_pTestClass->adv_table_read_retransmission_list3_head_res;
+    return true;
 }
 
 bool
 adv_table_read_retransmission_list3_is_empty(void)
 {
-    return g_pTestClass->adv_table_read_retransmission_list3_is_empty_res;
+    return 0 == g_pTestClass->m_list3_num_advs;
+}
+
+adv_table_snapshot_t*
+adv_table_read_retransmission_list3_snapshot_and_clear(void)
+{
+    if (g_pTestClass->m_snapshot_fail)
+    {
+        return nullptr;
+    }
+    assert(!g_pTestClass->m_snapshot_is_allocated);
+    g_pTestClass->m_snapshot_is_allocated = true;
+    g_pTestClass->m_snapshot_num_advs     = g_pTestClass->m_list3_num_advs;
+    g_pTestClass->m_list3_num_advs        = 0;
+    return g_pTestClass->m_p_snapshot;
+}
+
+num_of_advs_t
+adv_table_snapshot_get_num_of_advs(const adv_table_snapshot_t* const p_snapshot)
+{
+    assert(p_snapshot == g_pTestClass->m_p_snapshot);
+    return g_pTestClass->m_snapshot_num_advs;
+}
+
+bool
+adv_table_snapshot_get_adv(const adv_table_snapshot_t* const p_snapshot, const num_of_advs_t idx, adv_report_t* p_adv)
+{
+    assert(p_snapshot == g_pTestClass->m_p_snapshot);
+    assert(idx < g_pTestClass->m_snapshot_num_advs);
+    *p_adv = g_pTestClass->m_adv_report;
+    return true;
+}
+
+void
+adv_table_snapshot_release(adv_table_snapshot_t** const p_p_snapshot)
+{
+    assert(*p_p_snapshot == g_pTestClass->m_p_snapshot);
+    assert(g_pTestClass->m_snapshot_is_allocated);
+    g_pTestClass->m_events_history.push_back({ .event_type = EVENT_HISTORY_ADV_TABLE_SNAPSHOT_RELEASE });
+    g_pTestClass->m_snapshot_is_allocated = false;
+    *p_p_snapshot                         = nullptr;
+}
+
+void
+gateway_restart_low_memory(void)
+{
+    g_pTestClass->m_events_history.push_back({ .event_type = EVENT_HISTORY_GATEWAY_RESTART_LOW_MEMORY });
+}
+
+TickType_t
+xTaskGetTickCount(void)
+{
+    return g_pTestClass->m_tick_count;
+}
+
+void
+metrics_mqtt_publish_latency_add(const metrics_mqtt_publish_mode_e mode, const uint32_t latency_ms)
+{
+    g_pTestClass->m_latency_history.push_back(((uint32_t)mode << 24U) | latency_ms);
+}
+
+void
+metrics_boot_first_adv_relayed(void)
+{
 }
 
 void
@@ -412,6 +508,11 @@ adv_mqtt_timers_start_timer_sig_retry_sending_advs(void)
 bool
 mqtt_is_buffer_available_for_publish(void)
 {
+    if (0 == g_pTestClass->mqtt_is_buffer_available_for_publish_max_cnt)
+    {
+        return false;
+    }
+    g_pTestClass->mqtt_is_buffer_available_for_publish_max_cnt -= 1;
     return g_pTestClass->mqtt_is_buffer_available_for_publish_res;
 }
 
@@ -421,13 +522,35 @@ mqtt_publish_connect(void)
     g_pTestClass->m_events_history.push_back({ .event_type = EVENT_HISTORY_MQTT_PUBLISH_CONNECT });
 }
 
+void
+mqtt_publish_ctx_init(mqtt_publish_ctx_t* const p_ctx, const bool flag_use_timestamps, const time_t timestamp)
+{
+    g_pTestClass->m_events_history.push_back(
+        { .event_type            = EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT,
+          .mqtt_publish_ctx_init = { .flag_use_timestamps = flag_use_timestamps, .timestamp = timestamp } });
+    p_ctx->flag_use_timestamps = flag_use_timestamps;
+    p_ctx->timestamp           = timestamp;
+}
+
 bool
-mqtt_publish_adv(const adv_report_t* const p_adv, const bool flag_use_timestamps, const time_t timestamp)
+mqtt_publish_adv(const mqtt_publish_ctx_t* const p_ctx, const adv_report_t* const p_adv)
 {
     g_pTestClass->m_events_history.push_back({ .event_type = EVENT_HISTORY_MQTT_PUBLISH_ADV });
     return g_pTestClass->mqtt_publish_adv_res;
 }
 
+num_of_advs_t
+mqtt_publish_advs(
+    const mqtt_publish_ctx_t* const p_ctx,
+    const adv_report_t* const       p_advs,
+    const num_of_advs_t             num_of_advs)
+{
+    g_pTestClass->m_events_history.push_back(
+        { .event_type = EVENT_HISTORY_MQTT_PUBLISH_ADVS, .mqtt_publish_advs = { .num_of_advs = num_of_advs } });
+    return (num_of_advs < g_pTestClass->mqtt_publish_advs_max_num) ? num_of_advs
+                                                                   : g_pTestClass->mqtt_publish_advs_max_num;
+}
+
 void
 network_timeout_update_timestamp(void)
 {
@@ -468,6 +591,11 @@ event_mgr_notify(const event_mgr_ev_e event)
         { .event_type = EVENT_HISTORY_EVENT_MGR_NOTIFY, .event_mgr_notify = { .event = event } });
 }
 
+void
+event_mgr_ack(const event_mgr_ev_e event)
+{
+}
+
 } // extern "C"
 
 /*** Unit-Tests
@@ -499,6 +627,8 @@ TEST_F(TestAdvMqttSignals, test_adv_mqtt_signals_init_deinit) // NOLINT
           .os_signal_add = { .sig_num = adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_CFG_MODE_ACTIVATED) } },
         { .event_type    = EVENT_HISTORY_OS_SIGNAL_ADD,
           .os_signal_add = { .sig_num = adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_CFG_MODE_DEACTIVATED) } },
+        { .event_type    = EVENT_HISTORY_OS_SIGNAL_ADD,
+          .os_signal_add = { .sig_num = adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_PUBLISH_PERIODIC) } },
         { .event_type = EVENT_HISTORY_OS_SIGNAL_UNREGISTER_CUR_THREAD },
         { .event_type = EVENT_HISTORY_OS_SIGNAL_DELETE },
     };
@@ -545,6 +675,7 @@ TEST_F(TestAdvMqttSignals, test_adv_mqtt_conv_to_sig_num) // NOLINT
     ASSERT_EQ(OS_SIGNAL_NUM_6, adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_RELAYING_MODE_CHANGED));
     ASSERT_EQ(OS_SIGNAL_NUM_7, adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_CFG_MODE_ACTIVATED));
     ASSERT_EQ(OS_SIGNAL_NUM_8, adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_CFG_MODE_DEACTIVATED));
+    ASSERT_EQ(OS_SIGNAL_NUM_9, adv_mqtt_conv_to_sig_num(ADV_MQTT_SIG_PUBLISH_PERIODIC));
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -560,6 +691,7 @@ TEST_F(TestAdvMqttSignals, test_adv_mqtt_conv_from_sig_num) // NOLINT
     ASSERT_EQ(ADV_MQTT_SIG_RELAYING_MODE_CHANGED, adv_mqtt_conv_from_sig_num(OS_SIGNAL_NUM_6));
     ASSERT_EQ(ADV_MQTT_SIG_CFG_MODE_ACTIVATED, adv_mqtt_conv_from_sig_num(OS_SIGNAL_NUM_7));
     ASSERT_EQ(ADV_MQTT_SIG_CFG_MODE_DEACTIVATED, adv_mqtt_conv_from_sig_num(OS_SIGNAL_NUM_8));
+    ASSERT_EQ(ADV_MQTT_SIG_PUBLISH_PERIODIC, adv_mqtt_conv_from_sig_num(OS_SIGNAL_NUM_9));
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -961,10 +1093,9 @@ TEST_F(TestAdvMqttSignals, test_adv_mqtt_handle_sig_on_recv_adv) // NOLINT
     this->m_adv_mqtt_cfg_cache.flag_use_ntp                  = true;
     this->m_adv_mqtt_cfg_cache.flag_mqtt_instant_mode_active = true;
 
-    this->adv_table_read_retransmission_list3_head_res     = true;
-    this->adv_table_read_retransmission_list3_is_empty_res = false;
-    this->m_time_is_synchronized                           = true;
-    this->m_metrics_received_advs                          = 123;
+    this->m_list3_num_advs        = 2;
+    this->m_time_is_synchronized  = true;
+    this->m_metrics_received_advs = 123;
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
     ASSERT_FALSE(adv_mqtt_state.flag_stop);
@@ -987,103 +1118,293 @@ TEST_F(TestAdvMqttSignals, test_adv_mqtt_handle_sig_on_recv_adv) // NOLINT
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
     ASSERT_FALSE(adv_mqtt_state.flag_stop);
-    ASSERT_EQ(5, this->m_events_history.size());
+    ASSERT_EQ(6, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
-    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[1].event_type);
-    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[2].event_type);
-    ASSERT_EQ(EVENT_HISTORY_OS_SIGNAL_SEND, this->m_events_history[3].event_type);
-    ASSERT_EQ(ADV_MQTT_SIG_ON_RECV_ADV, this->m_events_history[3].os_signal_send.sig_num);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[1].event_type);
+    ASSERT_TRUE(this->m_events_history[1].mqtt_publish_ctx_init.flag_use_timestamps);
+    ASSERT_NE(0, this->m_events_history[1].mqtt_publish_ctx_init.timestamp);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[3].event_type);
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[4].event_type);
+    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[5].event_type);
+    ASSERT_EQ(0, this->m_list3_num_advs);
     this->m_events_history.clear();
 
-    this->adv_table_read_retransmission_list3_is_empty_res = true;
+    this->m_list3_num_advs       = 1;
+    this->m_time_is_synchronized = false;
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
     ASSERT_FALSE(adv_mqtt_state.flag_stop);
-    ASSERT_EQ(4, this->m_events_history.size());
+    ASSERT_EQ(5, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
-    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[1].event_type);
-    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[1].event_type);
+    ASSERT_TRUE(this->m_events_history[1].mqtt_publish_ctx_init.flag_use_timestamps);
+    ASSERT_EQ(0, this->m_events_history[1].mqtt_publish_ctx_init.timestamp);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[2].event_type);
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[3].event_type);
+    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[4].event_type);
     this->m_events_history.clear();
 
-    this->m_time_is_synchronized = false;
+    this->m_list3_num_advs                  = 1;
+    this->m_adv_mqtt_cfg_cache.flag_use_ntp = false;
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
     ASSERT_FALSE(adv_mqtt_state.flag_stop);
-    ASSERT_EQ(4, this->m_events_history.size());
+    ASSERT_EQ(5, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
-    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[1].event_type);
-    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[1].event_type);
+    ASSERT_FALSE(this->m_events_history[1].mqtt_publish_ctx_init.flag_use_timestamps);
+    ASSERT_EQ(123, this->m_events_history[1].mqtt_publish_ctx_init.timestamp);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[2].event_type);
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[3].event_type);
+    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[4].event_type);
     this->m_events_history.clear();
 
-    this->m_adv_mqtt_cfg_cache.flag_use_ntp = false;
+    this->m_adv_mqtt_cfg_cache.flag_use_ntp = true;
+    this->m_time_is_synchronized            = true;
 
+    // list3 is empty
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
     ASSERT_FALSE(adv_mqtt_state.flag_stop);
-    ASSERT_EQ(4, this->m_events_history.size());
+    ASSERT_EQ(2, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
-    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[1].event_type);
-    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[2].event_type);
-    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[3].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[1].event_type);
     this->m_events_history.clear();
 
-    this->m_time_is_synchronized = true;
+    this->m_list3_num_advs     = 2;
+    this->mqtt_publish_adv_res = false;
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
     ASSERT_FALSE(adv_mqtt_state.flag_stop);
     ASSERT_EQ(4, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
-    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[1].event_type);
-    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[1].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[2].event_type);
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[3].event_type);
+    ASSERT_EQ(1, this->m_list3_num_advs);
     this->m_events_history.clear();
 
-    this->m_adv_mqtt_cfg_cache.flag_use_ntp = true;
+    this->mqtt_publish_adv_res                     = true;
+    this->mqtt_is_buffer_available_for_publish_res = false;
 
-    this->adv_table_read_retransmission_list3_head_res = false;
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
+    ASSERT_FALSE(adv_mqtt_state.flag_stop);
+    ASSERT_EQ(3, this->m_events_history.size());
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_TIMER_SIG_RETRY_SENDING_ADVS, this->m_events_history[1].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[2].event_type);
+    ASSERT_EQ(1, this->m_list3_num_advs);
+    this->m_events_history.clear();
+
+    this->mqtt_is_buffer_available_for_publish_res = true;
+
+    this->m_adv_mqtt_cfg_cache.flag_mqtt_instant_mode_active = false;
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
     ASSERT_FALSE(adv_mqtt_state.flag_stop);
     ASSERT_EQ(2, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
-    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[3].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[1].event_type);
     this->m_events_history.clear();
 
-    this->adv_table_read_retransmission_list3_head_res = true;
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
 
-    this->mqtt_publish_adv_res = false;
+TEST_F(TestAdvMqttSignals, test_adv_mqtt_handle_sig_on_recv_adv_burst_limit) // NOLINT
+{
+    adv_mqtt_signals_init();
+    this->m_events_history.clear();
+
+    adv_mqtt_state_t adv_mqtt_state = {
+        .flag_stop = false,
+    };
+
+    this->m_gw_status_is_mqtt_connected                      = true;
+    this->m_gw_status_is_relaying_via_mqtt_enabled           = true;
+    this->m_adv_mqtt_cfg_cache.flag_use_ntp                  = true;
+    this->m_adv_mqtt_cfg_cache.flag_mqtt_instant_mode_active = true;
+    this->m_adv_report.recv_tick                             = 100;
+    this->m_tick_count                                       = 150;
+
+    // ADV_MQTT_BURST_MAX_ADVS is set to 4 for this test, the rest of advs are published after other signals
+    this->m_list3_num_advs = ADV_MQTT_BURST_MAX_ADVS + 1;
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
-    ASSERT_FALSE(adv_mqtt_state.flag_stop);
-    ASSERT_EQ(3, this->m_events_history.size());
+    ASSERT_EQ(9, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
-    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[1].event_type);
-    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[1].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[3].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[4].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[5].event_type);
+    ASSERT_EQ(EVENT_HISTORY_OS_SIGNAL_SEND, this->m_events_history[6].event_type);
+    ASSERT_EQ(ADV_MQTT_SIG_ON_RECV_ADV, this->m_events_history[6].os_signal_send.sig_num);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[7].event_type);
+    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[8].event_type);
+    ASSERT_EQ(1, this->m_list3_num_advs);
     this->m_events_history.clear();
 
-    this->mqtt_publish_adv_res                     = true;
-    this->mqtt_is_buffer_available_for_publish_res = false;
+    ASSERT_EQ(ADV_MQTT_BURST_MAX_ADVS, this->m_latency_history.size());
+    for (const uint32_t latency : this->m_latency_history)
+    {
+        ASSERT_EQ(((uint32_t)METRICS_MQTT_PUBLISH_MODE_INSTANT << 24U) | (50U * portTICK_PERIOD_MS), latency);
+    }
+    this->m_latency_history.clear();
+
+    // The MQTT buffer becomes full in the middle of the burst
+    this->m_list3_num_advs                             = 3;
+    this->mqtt_is_buffer_available_for_publish_max_cnt = 2;
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
-    ASSERT_FALSE(adv_mqtt_state.flag_stop);
-    ASSERT_EQ(3, this->m_events_history.size());
+    ASSERT_EQ(7, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
-    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_TIMER_SIG_RETRY_SENDING_ADVS, this->m_events_history[1].event_type);
-    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[1].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADV, this->m_events_history[3].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_TIMER_SIG_RETRY_SENDING_ADVS, this->m_events_history[4].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[5].event_type);
+    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[6].event_type);
+    ASSERT_EQ(1, this->m_list3_num_advs);
     this->m_events_history.clear();
 
-    this->mqtt_is_buffer_available_for_publish_res = true;
+    // The advs without the receive tick are not added to the latency histogram
+    this->m_adv_report.recv_tick                       = 0;
+    this->mqtt_is_buffer_available_for_publish_max_cnt = UINT32_MAX;
+    this->m_latency_history.clear();
+
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
+    ASSERT_EQ(5, this->m_events_history.size());
+    ASSERT_EQ(0, this->m_list3_num_advs);
+    ASSERT_EQ(0, this->m_latency_history.size());
+
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvMqttSignals, test_adv_mqtt_handle_sig_publish_periodic) // NOLINT
+{
+    adv_mqtt_signals_init();
+    this->m_events_history.clear();
+
+    adv_mqtt_state_t adv_mqtt_state = {
+        .flag_stop           = false,
+        .p_snapshot_periodic = nullptr,
+        .snapshot_idx        = 0,
+        .snapshot_timestamp  = 0,
+    };
 
+    this->m_gw_status_is_mqtt_connected                      = true;
+    this->m_gw_status_is_relaying_via_mqtt_enabled           = true;
+    this->m_adv_mqtt_cfg_cache.flag_use_ntp                  = true;
     this->m_adv_mqtt_cfg_cache.flag_mqtt_instant_mode_active = false;
+    this->m_adv_report.recv_tick                             = 1;
+    this->m_tick_count                                       = 11;
+    this->m_list3_num_advs                                   = 10;
+
+    // The first burst publishes 8 advs (the size of the buffer for the batch), which exceeds the burst limit
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC, &adv_mqtt_state));
+    ASSERT_NE(nullptr, adv_mqtt_state.p_snapshot_periodic);
+    ASSERT_EQ(8, adv_mqtt_state.snapshot_idx);
+    ASSERT_NE(0, adv_mqtt_state.snapshot_timestamp);
+    ASSERT_EQ(0, this->m_list3_num_advs);
+    ASSERT_EQ(8, this->m_events_history.size());
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[1].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[3].event_type);
+    ASSERT_TRUE(this->m_events_history[3].mqtt_publish_ctx_init.flag_use_timestamps);
+    ASSERT_EQ(adv_mqtt_state.snapshot_timestamp, this->m_events_history[3].mqtt_publish_ctx_init.timestamp);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADVS, this->m_events_history[4].event_type);
+    ASSERT_EQ(8, this->m_events_history[4].mqtt_publish_advs.num_of_advs);
+    ASSERT_EQ(EVENT_HISTORY_OS_SIGNAL_SEND, this->m_events_history[5].event_type);
+    ASSERT_EQ(ADV_MQTT_SIG_ON_RECV_ADV, this->m_events_history[5].os_signal_send.sig_num);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[6].event_type);
+    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[7].event_type);
+    this->m_events_history.clear();
+
+    // The next period is skipped while the previous publication is in progress
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC, &adv_mqtt_state));
+    ASSERT_EQ(0, this->m_events_history.size());
 
     ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
-    ASSERT_FALSE(adv_mqtt_state.flag_stop);
+    ASSERT_EQ(nullptr, adv_mqtt_state.p_snapshot_periodic);
+    ASSERT_EQ(6, this->m_events_history.size());
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[1].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADVS, this->m_events_history[2].event_type);
+    ASSERT_EQ(2, this->m_events_history[2].mqtt_publish_advs.num_of_advs);
+    ASSERT_EQ(EVENT_HISTORY_ADV_TABLE_SNAPSHOT_RELEASE, this->m_events_history[3].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[4].event_type);
+    ASSERT_EQ(EVENT_HISTORY_NETWORK_TIMEOUT_UPDATE_TIMESTAMP, this->m_events_history[5].event_type);
+    this->m_events_history.clear();
+
+    ASSERT_EQ(10, this->m_latency_history.size());
+    for (const uint32_t latency : this->m_latency_history)
+    {
+        ASSERT_EQ(((uint32_t)METRICS_MQTT_PUBLISH_MODE_PERIODIC << 24U) | (10U * portTICK_PERIOD_MS), latency);
+    }
+
+    // Publication failed - the rest of advs are discarded
+    this->m_list3_num_advs          = 10;
+    this->mqtt_publish_advs_max_num = 0;
+
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC, &adv_mqtt_state));
+    ASSERT_EQ(nullptr, adv_mqtt_state.p_snapshot_periodic);
+    ASSERT_EQ(7, this->m_events_history.size());
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[1].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[2].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_CTX_INIT, this->m_events_history[3].event_type);
+    ASSERT_EQ(EVENT_HISTORY_MQTT_PUBLISH_ADVS, this->m_events_history[4].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_TABLE_SNAPSHOT_RELEASE, this->m_events_history[5].event_type);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[6].event_type);
+    this->m_events_history.clear();
+
+    // MQTT was disconnected during the publication - the rest of advs are discarded
+    this->m_list3_num_advs          = 10;
+    this->mqtt_publish_advs_max_num = 1;
+
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC, &adv_mqtt_state));
+    ASSERT_NE(nullptr, adv_mqtt_state.p_snapshot_periodic);
+    ASSERT_EQ(ADV_MQTT_BURST_MAX_ADVS, adv_mqtt_state.snapshot_idx);
+    this->m_events_history.clear();
+
+    this->m_gw_status_is_mqtt_connected = false;
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_ON_RECV_ADV, &adv_mqtt_state));
+    ASSERT_EQ(nullptr, adv_mqtt_state.p_snapshot_periodic);
+    ASSERT_EQ(1, this->m_events_history.size());
+    ASSERT_EQ(EVENT_HISTORY_ADV_TABLE_SNAPSHOT_RELEASE, this->m_events_history[0].event_type);
+    this->m_events_history.clear();
+
+    // MQTT is not connected
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC, &adv_mqtt_state));
+    ASSERT_EQ(0, this->m_events_history.size());
+    this->m_gw_status_is_mqtt_connected = true;
+
+    // The time is not yet synchronized
+    this->m_time_is_synchronized = false;
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC, &adv_mqtt_state));
+    ASSERT_EQ(nullptr, adv_mqtt_state.p_snapshot_periodic);
     ASSERT_EQ(2, this->m_events_history.size());
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_LOCK, this->m_events_history[0].event_type);
     ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_CFG_CACHE_MUTEX_UNLOCK, this->m_events_history[1].event_type);
     this->m_events_history.clear();
+    this->m_time_is_synchronized = true;
+
+    // There are no advs in list3
+    this->m_list3_num_advs = 0;
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC, &adv_mqtt_state));
+    ASSERT_EQ(nullptr, adv_mqtt_state.p_snapshot_periodic);
+    ASSERT_EQ(3, this->m_events_history.size());
+    ASSERT_EQ(EVENT_HISTORY_ADV_TABLE_SNAPSHOT_RELEASE, this->m_events_history[2].event_type);
+    this->m_events_history.clear();
+
+    // Not enough memory for the snapshot
+    this->m_snapshot_fail = true;
+    ASSERT_FALSE(adv_mqtt_handle_sig(ADV_MQTT_SIG_PUBLISH_PERIODIC, &adv_mqtt_state));
+    ASSERT_EQ(nullptr, adv_mqtt_state.p_snapshot_periodic);
+    ASSERT_EQ(3, this->m_events_history.size());
+    ASSERT_EQ(EVENT_HISTORY_GATEWAY_RESTART_LOW_MEMORY, this->m_events_history[2].event_type);
+    this->m_events_history.clear();
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -9,10 +9,17 @@
 #include "gtest/gtest.h"
 #include "gw_cfg.h"
 #include "adv_table.h"
+#include "adv_spool.h"
 #include "adv_post_signals.h"
 #include "reset_task.h"
 #include "ruuvi_gateway.h"
+#include "http.h"
+#include <algorithm>
+#include <array>
+#include <deque>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -90,12 +97,6 @@ protected:
         this->m_adv_post_statistics_do_send_call_cnt    = 0;
         this->m_gw_status_is_mqtt_connected_res         = false;
 
-        this->m_mqtt_publish_adv_res                     = false;
-        this->m_mqtt_publish_adv_call_cnt                = 0;
-        this->m_mqtt_publish_adv_arg_adv                 = {};
-        this->m_mqtt_publish_adv_arg_flag_use_timestamps = false;
-        this->m_mqtt_publish_adv_arg_timestamp           = 0;
-
         this->m_http_async_poll_res                           = false;
         this->m_esp_get_free_heap_size_res                    = 0;
         this->m_default_period_for_http_ruuvi                 = 60 * 1000;
@@ -112,6 +113,16 @@ protected:
 
         this->m_flag_gateway_restart_low_memory = false;
 
+        this->m_adv_spool_enabled = false;
+        this->m_adv_spool.clear();
+        this->m_adv_spool_consume_history.clear();
+        this->m_adv_spool_num_removed = 0;
+        this->m_http_async_is_last_req_successful_res = true;
+        this->m_gw_cfg_get_http_use_http_ruuvi_res    = true;
+        this->m_gw_cfg_get_http_use_http_res          = true;
+        this->m_http_async_slots                      = {};
+        this->m_http_async_num_slots                  = 1;
+
         adv_post_async_comm_init();
     }
 
@@ -146,11 +157,6 @@ public:
     bool                m_adv_post_statistics_do_send_res { true };
     uint32_t            m_adv_post_statistics_do_send_call_cnt { 0 };
     bool                m_gw_status_is_mqtt_connected_res { true };
-    bool                m_mqtt_publish_adv_res { true };
-    uint32_t            m_mqtt_publish_adv_call_cnt { 0 };
-    adv_report_t        m_mqtt_publish_adv_arg_adv {};
-    bool                m_mqtt_publish_adv_arg_flag_use_timestamps { false };
-    time_t              m_mqtt_publish_adv_arg_timestamp {};
     bool                m_http_async_poll_res { true };
     uint32_t            m_esp_get_free_heap_size_res { 0 };
     adv_post_sig_e      m_adv_post_signals_send_sig {};
@@ -176,6 +182,17 @@ public:
     uint32_t m_send_sig_restart_services { 0 };
 
     bool m_flag_gateway_restart_low_memory { false };
+
+    bool                                                   m_adv_spool_enabled { false };
+    deque<pair<adv_spool_target_e, vector<adv_report_t>>> m_adv_spool {};
+    vector<bool>                                           m_adv_spool_consume_history {};
+    uint32_t                                               m_adv_spool_num_removed { 0 };
+    bool                                                   m_http_async_is_last_req_successful_res { true };
+    bool                                                   m_gw_cfg_get_http_use_http_ruuvi_res { true };
+    bool                                                   m_gw_cfg_get_http_use_http_res { true };
+
+    std::array<http_async_info_t, HTTP_ASYNC_MAX_SLOTS> m_http_async_slots {};
+    uint32_t                                            m_http_async_num_slots { 1 };
 };
 
 TestAdvPostAsyncComm::TestAdvPostAsyncComm()
@@ -261,14 +278,18 @@ gw_cfg_get_mqtt_use_mqtt(void)
 
 bool
 http_post_advs(
-    const adv_report_table_t* const  p_reports,
+    http_async_info_t* const         p_http_async_info,
+    adv_table_snapshot_t* const      p_snapshot,
     const uint32_t                   nonce,
     const bool                       flag_use_timestamps,
     const bool                       flag_post_to_ruuvi,
     const ruuvi_gw_cfg_http_t* const p_cfg_http,
     void* const                      p_user_data)
 {
-    g_pTestClass->m_http_post_advs_arg_reports             = *p_reports;
+    assert(p_http_async_info->flag_async_req_in_progress);
+    p_http_async_info->recipient = flag_post_to_ruuvi ? HTTP_POST_RECIPIENT_ADVS1 : HTTP_POST_RECIPIENT_ADVS2;
+
+    g_pTestClass->m_http_post_advs_arg_reports             = *reinterpret_cast<const adv_report_table_t*>(p_snapshot);
     g_pTestClass->m_http_post_advs_arg_nonce               = nonce;
     g_pTestClass->m_http_post_advs_arg_flag_use_timestamps = flag_use_timestamps;
     g_pTestClass->m_http_post_advs_arg_flag_post_to_ruuvi  = flag_post_to_ruuvi;
@@ -280,22 +301,63 @@ http_post_advs(
     return g_pTestClass->m_http_post_advs_res;
 }
 
-void
-adv_table_read_retransmission_list1_and_clear(adv_report_table_t* const p_reports)
+static adv_table_snapshot_t*
+test_adv_table_snapshot_create(void)
 {
+    auto* const p_reports = static_cast<adv_report_table_t*>(os_malloc(sizeof(adv_report_table_t)));
+    if (nullptr == p_reports)
+    {
+        return nullptr;
+    }
     *p_reports = g_pTestClass->m_reports;
+    return reinterpret_cast<adv_table_snapshot_t*>(p_reports);
 }
 
-void
-adv_table_read_retransmission_list2_and_clear(adv_report_table_t* const p_reports)
+adv_table_snapshot_t*
+adv_table_read_retransmission_list1_snapshot_and_clear(void)
 {
-    *p_reports = g_pTestClass->m_reports;
+    return test_adv_table_snapshot_create();
+}
+
+adv_table_snapshot_t*
+adv_table_read_retransmission_list2_snapshot_and_clear(void)
+{
+    return test_adv_table_snapshot_create();
+}
+
+num_of_advs_t
+adv_table_snapshot_get_num_of_advs(const adv_table_snapshot_t* const p_snapshot)
+{
+    if (nullptr == p_snapshot)
+    {
+        return 0;
+    }
+    return reinterpret_cast<const adv_report_table_t*>(p_snapshot)->num_of_advs;
+}
+
+bool
+adv_table_snapshot_get_adv(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    adv_report_t* const               p_adv_report)
+{
+    const auto* const p_reports = reinterpret_cast<const adv_report_table_t*>(p_snapshot);
+    if ((nullptr == p_reports) || (idx >= p_reports->num_of_advs))
+    {
+        return false;
+    }
+    *p_adv_report = p_reports->table[idx];
+    return true;
 }
 
 void
-adv_table_read_retransmission_list3_and_clear(adv_report_table_t* const p_reports)
+adv_table_snapshot_release(adv_table_snapshot_t** const p_p_snapshot)
 {
-    *p_reports = g_pTestClass->m_reports;
+    if (nullptr != *p_p_snapshot)
+    {
+        os_free(*p_p_snapshot);
+        *p_p_snapshot = nullptr;
+    }
 }
 
 void
@@ -356,8 +418,10 @@ hmac_sha256_set_key_for_stats(const char* const p_key)
 }
 
 bool
-adv_post_statistics_do_send(void)
+adv_post_statistics_do_send(http_async_info_t* const p_http_async_info)
 {
+    assert(p_http_async_info->flag_async_req_in_progress);
+    p_http_async_info->recipient = HTTP_POST_RECIPIENT_STATS;
     g_pTestClass->m_adv_post_statistics_do_send_call_cnt += 1;
     return g_pTestClass->m_adv_post_statistics_do_send_res;
 }
@@ -374,26 +438,53 @@ adv_post_signals_send_sig(const adv_post_sig_e adv_post_sig)
     g_pTestClass->m_adv_post_signals_send_sig = adv_post_sig;
 }
 
-bool
-mqtt_publish_adv(const adv_report_t* const p_adv, const bool flag_use_timestamps, const time_t timestamp)
+void
+adv_post_timers_start_timer_sig_do_async_comm(void)
+{
+    g_pTestClass->m_adv_post_timers_start_timer_sig_do_async_comm = true;
+}
+
+http_async_info_t*
+http_async_slot_acquire(const http_post_recipient_e recipient)
 {
-    g_pTestClass->m_mqtt_publish_adv_arg_adv                 = *p_adv;
-    g_pTestClass->m_mqtt_publish_adv_arg_flag_use_timestamps = flag_use_timestamps;
-    g_pTestClass->m_mqtt_publish_adv_arg_timestamp           = timestamp;
-    g_pTestClass->m_mqtt_publish_adv_call_cnt += 1;
-    return g_pTestClass->m_mqtt_publish_adv_res;
+    for (uint32_t i = 0; i < g_pTestClass->m_http_async_num_slots; ++i)
+    {
+        http_async_info_t* const p_http_async_info = &g_pTestClass->m_http_async_slots[i];
+        if (!p_http_async_info->flag_async_req_in_progress)
+        {
+            p_http_async_info->slot_idx                   = i;
+            p_http_async_info->recipient                  = recipient;
+            p_http_async_info->flag_async_req_in_progress = true;
+            return p_http_async_info;
+        }
+    }
+    return nullptr;
 }
 
 void
-adv_post_timers_start_timer_sig_do_async_comm(void)
+http_async_slot_release(http_async_info_t* const p_http_async_info)
 {
-    g_pTestClass->m_adv_post_timers_start_timer_sig_do_async_comm = true;
+    assert(p_http_async_info->flag_async_req_in_progress);
+    p_http_async_info->flag_async_req_in_progress = false;
 }
 
-bool
+http_async_info_t*
 http_async_poll(void)
 {
-    return g_pTestClass->m_http_async_poll_res;
+    if (!g_pTestClass->m_http_async_poll_res)
+    {
+        return nullptr;
+    }
+    for (auto& http_async_info : g_pTestClass->m_http_async_slots)
+    {
+        if (http_async_info.flag_async_req_in_progress)
+        {
+            http_async_info.flag_async_req_in_progress = false;
+            http_async_info.flag_last_req_successful   = g_pTestClass->m_http_async_is_last_req_successful_res;
+            return &http_async_info;
+        }
+    }
+    return nullptr;
 }
 
 uint32_t
@@ -431,6 +522,88 @@ gateway_restart_low_memory(void)
     g_pTestClass->m_flag_gateway_restart_low_memory = true;
 }
 
+bool
+gw_cfg_get_http_use_http_ruuvi(void)
+{
+    return g_pTestClass->m_gw_cfg_get_http_use_http_ruuvi_res;
+}
+
+bool
+gw_cfg_get_http_use_http(void)
+{
+    return g_pTestClass->m_gw_cfg_get_http_use_http_res;
+}
+
+adv_table_snapshot_t*
+adv_table_snapshot_create_detached(adv_report_t* p_arr_of_advs, const num_of_advs_t num_of_advs)
+{
+    auto* const p_reports = static_cast<adv_report_table_t*>(os_malloc(sizeof(adv_report_table_t)));
+    if (nullptr != p_reports)
+    {
+        p_reports->num_of_advs = num_of_advs;
+        std::copy(&p_arr_of_advs[0], &p_arr_of_advs[num_of_advs], &p_reports->table[0]);
+    }
+    os_free(p_arr_of_advs);
+    return reinterpret_cast<adv_table_snapshot_t*>(p_reports);
+}
+
+bool
+adv_spool_is_enabled(void)
+{
+    return g_pTestClass->m_adv_spool_enabled;
+}
+
+bool
+adv_spool_is_empty(void)
+{
+    return g_pTestClass->m_adv_spool.empty();
+}
+
+bool
+adv_spool_append(
+    const adv_spool_target_e  target,
+    const adv_report_t* const p_arr_of_advs,
+    const num_of_advs_t       num_of_advs)
+{
+    assert(g_pTestClass->m_adv_spool_enabled);
+    assert(num_of_advs <= ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    g_pTestClass->m_adv_spool.emplace_back(
+        target,
+        vector<adv_report_t>(&p_arr_of_advs[0], &p_arr_of_advs[num_of_advs]));
+    return true;
+}
+
+num_of_advs_t
+adv_spool_read(
+    adv_spool_target_e* const p_target,
+    adv_report_t* const       p_arr_of_advs,
+    adv_spool_rec_id_t* const p_rec_id)
+{
+    if (g_pTestClass->m_adv_spool.empty())
+    {
+        return 0;
+    }
+    const auto& rec   = g_pTestClass->m_adv_spool.front();
+    *p_target         = rec.first;
+    p_rec_id->seq_num = g_pTestClass->m_adv_spool_num_removed + 1;
+    p_rec_id->offset  = 0;
+    std::copy(rec.second.begin(), rec.second.end(), p_arr_of_advs);
+    return rec.second.size();
+}
+
+bool
+adv_spool_consume(const adv_spool_rec_id_t* const p_rec_id, const bool flag_delivered)
+{
+    if (g_pTestClass->m_adv_spool.empty() || (p_rec_id->seq_num != (g_pTestClass->m_adv_spool_num_removed + 1)))
+    {
+        return false;
+    }
+    g_pTestClass->m_adv_spool.pop_front();
+    g_pTestClass->m_adv_spool_num_removed += 1;
+    g_pTestClass->m_adv_spool_consume_history.push_back(flag_delivered);
+    return true;
+}
+
 } // extern "C"
 
 /*** Unit-Tests
@@ -448,16 +621,15 @@ TEST_F(TestAdvPostAsyncComm, test_regular_sequence) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -494,16 +666,15 @@ TEST_F(TestAdvPostAsyncComm, test_regular_sequence) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, adv_post_get_adv_post_action());
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
 
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = true;
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str123"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, "key_str123"));
     ASSERT_EQ(string("key_str123"), this->m_hmac_sha256_set_key_for_http_ruuvi_key);
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = false;
-    adv_post_set_default_period(15 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, 15 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
 
     this->m_http_async_poll_res = true;
@@ -514,9 +685,8 @@ TEST_F(TestAdvPostAsyncComm, test_regular_sequence) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
-    ASSERT_EQ(ADV_POST_ACTION_NONE, adv_post_get_adv_post_action());
+    ASSERT_FALSE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
 
     adv_post_state.flag_need_to_send_advs1          = false;
     adv_post_state.flag_need_to_send_advs2          = true;
@@ -528,11 +698,10 @@ TEST_F(TestAdvPostAsyncComm, test_regular_sequence) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str124"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, "key_str124"));
     ASSERT_EQ(string("key_str124"), this->m_hmac_sha256_set_key_for_http_custom_key);
     this->m_hmac_sha256_set_key_for_http_custom_res = false;
-    adv_post_set_default_period(25 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, 25 * 1000);
     ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
 
     this->m_http_async_poll_res = true;
@@ -543,7 +712,6 @@ TEST_F(TestAdvPostAsyncComm, test_regular_sequence) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs2      = false;
@@ -556,11 +724,10 @@ TEST_F(TestAdvPostAsyncComm, test_regular_sequence) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str125"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_STATS, "key_str125"));
     ASSERT_EQ(string("key_str125"), this->m_hmac_sha256_set_key_for_stats_key);
     this->m_hmac_sha256_set_key_for_stats_res = false;
-    adv_post_set_default_period(35 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_STATS, 35 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
     ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
 
@@ -572,123 +739,108 @@ TEST_F(TestAdvPostAsyncComm, test_regular_sequence) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvPostAsyncComm, test_concurrent_targets) // NOLINT
+{
+    this->m_flag_time_is_synchronized              = true;
+    this->m_http_server_mutex_try_lock_res         = true;
+    this->m_http_post_advs_res                     = true;
+    this->m_gw_cfg_get_http_stat_use_http_stat_res = true;
+    this->m_gw_cfg_get_ntp_use_res                 = true;
+    this->m_adv_post_statistics_do_send_res        = true;
+    this->m_http_async_num_slots                   = 3;
+
+    adv_post_state_t adv_post_state = {
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = true,
+        .flag_need_to_send_statistics   = true,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
+    };
+    this->m_reports = {
+        .num_of_advs = 1,
+        .table = {
+            [0] = {
+                .timestamp = 100500,
+                .samples_counter = 301,
+                .tag_mac = { 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,},
+                .rssi = -49,
+                .data_len = 24,
+                .data_buf = {
+                    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+                    0x30, 0x31, 0x32, 0x33, 0x34, 0x35,
+                }
+            },
+        }
+    };
+
+    // All the targets are sent at once, each one in its own slot
     adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
+    ASSERT_TRUE(adv_post_state.flag_async_comm_in_progress);
+    ASSERT_TRUE(this->m_http_server_mutex_locked);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(ADV_POST_SIG_DO_ASYNC_COMM, this->m_adv_post_signals_send_sig);
+    ASSERT_FALSE(adv_post_state.flag_need_to_send_advs1);
+    ASSERT_FALSE(adv_post_state.flag_need_to_send_advs2);
+    ASSERT_FALSE(adv_post_state.flag_need_to_send_statistics);
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM));
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_STATS));
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
 
+    // The HTTP POST to Ruuvi Cloud is completed, the other targets are still in progress
     this->m_http_async_poll_res = true;
     adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(1, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    this->m_http_async_poll_res                           = false;
+    ASSERT_TRUE(adv_post_state.flag_async_comm_in_progress);
+    ASSERT_TRUE(this->m_http_server_mutex_locked);
+    ASSERT_FALSE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM));
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_STATS));
 
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[0];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
+    // The next period of Ruuvi Cloud is not blocked by the slow custom HTTP server
+    this->m_http_async_poll_res            = false;
+    adv_post_state.flag_need_to_send_advs1 = true;
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_EQ(3, this->m_http_post_advs_call_cnt);
+    ASSERT_TRUE(this->m_http_post_advs_arg_flag_post_to_ruuvi);
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
 
-    this->m_mqtt_publish_adv_arg_timestamp = 0;
-    this->m_http_async_poll_res            = true;
+    // The same target is not sent again while its previous HTTP POST is in progress
+    adv_post_state.flag_need_to_send_advs2 = true;
     adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
+    ASSERT_EQ(3, this->m_http_post_advs_call_cnt);
+    ASSERT_TRUE(adv_post_state.flag_need_to_send_advs2);
+
+    this->m_http_async_poll_res = true;
+    adv_post_do_async_comm(&adv_post_state); // advs1 completed
+    ASSERT_TRUE(this->m_http_server_mutex_locked);
+    ASSERT_FALSE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
+    adv_post_state.flag_need_to_send_advs2 = false;
+    adv_post_do_async_comm(&adv_post_state); // advs2 completed
+    ASSERT_TRUE(this->m_http_server_mutex_locked);
+    ASSERT_FALSE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM));
+    ASSERT_TRUE(adv_post_state.flag_async_comm_in_progress);
+    adv_post_do_async_comm(&adv_post_state); // statistics completed
     ASSERT_FALSE(this->m_http_server_mutex_locked);
+    ASSERT_FALSE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_STATS));
+    ASSERT_FALSE(adv_post_state.flag_async_comm_in_progress);
+    ASSERT_EQ(3, this->m_http_post_advs_call_cnt);
+    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
     ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(2, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_http_async_poll_res = false;
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
 
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[1];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
-TEST_F(TestAdvPostAsyncComm, test_adv_post_set_adv_post_http_action) // NOLINT
-{
-    ASSERT_EQ(ADV_POST_ACTION_NONE, adv_post_get_adv_post_action());
-    adv_post_set_adv_post_http_action(true);
-    ASSERT_EQ(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, adv_post_get_adv_post_action());
-    adv_post_set_adv_post_http_action(false);
-    ASSERT_EQ(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, adv_post_get_adv_post_action());
-}
-
 TEST_F(TestAdvPostAsyncComm, test_no_timestamps) // NOLINT
 {
     this->m_flag_time_is_synchronized              = true;
@@ -701,16 +853,15 @@ TEST_F(TestAdvPostAsyncComm, test_no_timestamps) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = false,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = false,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -747,15 +898,14 @@ TEST_F(TestAdvPostAsyncComm, test_no_timestamps) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = true;
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str123"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, "key_str123"));
     ASSERT_EQ(string("key_str123"), this->m_hmac_sha256_set_key_for_http_ruuvi_key);
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = false;
-    adv_post_set_default_period(15 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, 15 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
 
     this->m_http_async_poll_res = true;
@@ -766,7 +916,6 @@ TEST_F(TestAdvPostAsyncComm, test_no_timestamps) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs1          = false;
@@ -779,11 +928,10 @@ TEST_F(TestAdvPostAsyncComm, test_no_timestamps) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str124"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, "key_str124"));
     ASSERT_EQ(string("key_str124"), this->m_hmac_sha256_set_key_for_http_custom_key);
     this->m_hmac_sha256_set_key_for_http_custom_res = false;
-    adv_post_set_default_period(25 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, 25 * 1000);
     ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
 
     this->m_http_async_poll_res = true;
@@ -794,7 +942,6 @@ TEST_F(TestAdvPostAsyncComm, test_no_timestamps) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs2      = false;
@@ -807,11 +954,10 @@ TEST_F(TestAdvPostAsyncComm, test_no_timestamps) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str125"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_STATS, "key_str125"));
     ASSERT_EQ(string("key_str125"), this->m_hmac_sha256_set_key_for_stats_key);
     this->m_hmac_sha256_set_key_for_stats_res = false;
-    adv_post_set_default_period(35 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_STATS, 35 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
     ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
 
@@ -823,111 +969,8 @@ TEST_F(TestAdvPostAsyncComm, test_no_timestamps) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    this->m_http_async_poll_res = false;
-
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(ADV_POST_SIG_DO_ASYNC_COMM, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(1, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    this->m_http_async_poll_res                           = false;
-
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[0];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
-
-    this->m_mqtt_publish_adv_arg_timestamp = 0;
-    this->m_http_async_poll_res            = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(2, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_http_async_poll_res = false;
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
 
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[1];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
@@ -943,16 +986,15 @@ TEST_F(TestAdvPostAsyncComm, test_no_time_sync) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -989,15 +1031,14 @@ TEST_F(TestAdvPostAsyncComm, test_no_time_sync) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = true;
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str123"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, "key_str123"));
     ASSERT_EQ(string("key_str123"), this->m_hmac_sha256_set_key_for_http_ruuvi_key);
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = false;
-    adv_post_set_default_period(15 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, 15 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
 
     this->m_http_async_poll_res = true;
@@ -1008,7 +1049,6 @@ TEST_F(TestAdvPostAsyncComm, test_no_time_sync) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs1          = false;
@@ -1021,11 +1061,10 @@ TEST_F(TestAdvPostAsyncComm, test_no_time_sync) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str124"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, "key_str124"));
     ASSERT_EQ(string("key_str124"), this->m_hmac_sha256_set_key_for_http_custom_key);
     this->m_hmac_sha256_set_key_for_http_custom_res = false;
-    adv_post_set_default_period(25 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, 25 * 1000);
     ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
 
     this->m_http_async_poll_res = true;
@@ -1036,7 +1075,6 @@ TEST_F(TestAdvPostAsyncComm, test_no_time_sync) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs2      = false;
@@ -1049,11 +1087,10 @@ TEST_F(TestAdvPostAsyncComm, test_no_time_sync) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str125"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_STATS, "key_str125"));
     ASSERT_EQ(string("key_str125"), this->m_hmac_sha256_set_key_for_stats_key);
     this->m_hmac_sha256_set_key_for_stats_res = false;
-    adv_post_set_default_period(35 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_STATS, 35 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
     ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
 
@@ -1065,111 +1102,8 @@ TEST_F(TestAdvPostAsyncComm, test_no_time_sync) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    this->m_http_async_poll_res = false;
-
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(ADV_POST_SIG_DO_ASYNC_COMM, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(1, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    this->m_http_async_poll_res                           = false;
-
-    ASSERT_FALSE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[0];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
-
-    this->m_mqtt_publish_adv_arg_timestamp = 0;
-    this->m_http_async_poll_res            = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(2, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_http_async_poll_res = false;
-    ASSERT_FALSE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
 
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[1];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
@@ -1185,16 +1119,15 @@ TEST_F(TestAdvPostAsyncComm, test_time_not_synchronized) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -1231,7 +1164,6 @@ TEST_F(TestAdvPostAsyncComm, test_time_not_synchronized) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
 
     adv_post_state.flag_need_to_send_advs1 = false;
@@ -1244,7 +1176,6 @@ TEST_F(TestAdvPostAsyncComm, test_time_not_synchronized) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
 
     adv_post_state.flag_need_to_send_advs2      = false;
@@ -1257,24 +1188,10 @@ TEST_F(TestAdvPostAsyncComm, test_time_not_synchronized) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
 
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-
-    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
-}
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
 
 TEST_F(TestAdvPostAsyncComm, test_no_network_connection) // NOLINT
 {
@@ -1288,16 +1205,15 @@ TEST_F(TestAdvPostAsyncComm, test_no_network_connection) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = false,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = false,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -1334,7 +1250,6 @@ TEST_F(TestAdvPostAsyncComm, test_no_network_connection) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
 
     adv_post_state.flag_need_to_send_advs1 = false;
@@ -1347,7 +1262,6 @@ TEST_F(TestAdvPostAsyncComm, test_no_network_connection) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
 
     adv_post_state.flag_need_to_send_advs2      = false;
@@ -1360,20 +1274,6 @@ TEST_F(TestAdvPostAsyncComm, test_no_network_connection) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
@@ -1391,16 +1291,15 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_1) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -1440,7 +1339,6 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_1) // NOLINT
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_FALSE(this->m_http_server_mutex_locked);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
@@ -1459,16 +1357,15 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_2) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -1507,7 +1404,6 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_2) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
@@ -1526,16 +1422,15 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_3) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -1574,15 +1469,14 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_3) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = true;
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str123"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, "key_str123"));
     ASSERT_EQ(string("key_str123"), this->m_hmac_sha256_set_key_for_http_ruuvi_key);
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = false;
-    adv_post_set_default_period(15 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, 15 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
 
     this->m_http_async_poll_res = true;
@@ -1593,7 +1487,6 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_3) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs1          = false;
@@ -1606,7 +1499,6 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_3) // NOLINT
     ASSERT_TRUE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -1623,16 +1515,15 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_4) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -1671,15 +1562,14 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_4) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = true;
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str123"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, "key_str123"));
     ASSERT_EQ(string("key_str123"), this->m_hmac_sha256_set_key_for_http_ruuvi_key);
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = false;
-    adv_post_set_default_period(15 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, 15 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
 
     this->m_http_async_poll_res = true;
@@ -1690,7 +1580,6 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_4) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs1          = false;
@@ -1703,7 +1592,6 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_4) // NOLINT
     ASSERT_TRUE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -1720,16 +1608,15 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_5) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -1768,15 +1655,14 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_5) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = true;
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str123"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, "key_str123"));
     ASSERT_EQ(string("key_str123"), this->m_hmac_sha256_set_key_for_http_ruuvi_key);
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = false;
-    adv_post_set_default_period(15 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, 15 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
 
     this->m_http_async_poll_res = true;
@@ -1787,7 +1673,6 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_5) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs1          = false;
@@ -1800,11 +1685,10 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_5) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str124"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, "key_str124"));
     ASSERT_EQ(string("key_str124"), this->m_hmac_sha256_set_key_for_http_custom_key);
     this->m_hmac_sha256_set_key_for_http_custom_res = false;
-    adv_post_set_default_period(25 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, 25 * 1000);
     ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
 
     this->m_http_async_poll_res = true;
@@ -1815,7 +1699,6 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_5) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs2      = false;
@@ -1828,11 +1711,10 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_5) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str125"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_STATS, "key_str125"));
     ASSERT_EQ(string("key_str125"), this->m_hmac_sha256_set_key_for_stats_key);
     this->m_hmac_sha256_set_key_for_stats_res = false;
-    adv_post_set_default_period(35 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_STATS, 35 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
     ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
 
@@ -1844,357 +1726,8 @@ TEST_F(TestAdvPostAsyncComm, test_malloc_failed_5) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    ASSERT_EQ(0, this->m_send_sig_restart_services);
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_TRUE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_EQ(1, this->m_send_sig_restart_services);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(0, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
-}
-
-TEST_F(TestAdvPostAsyncComm, test_malloc_failed_6) // NOLINT
-{
-    this->m_flag_time_is_synchronized              = true;
-    this->m_http_server_mutex_try_lock_res         = true;
-    this->m_http_post_advs_res                     = true;
-    this->m_gw_cfg_get_http_stat_use_http_stat_res = true;
-    this->m_gw_cfg_get_mqtt_use_mqtt_res           = true;
-    this->m_gw_cfg_get_ntp_use_res                 = true;
-    this->m_adv_post_statistics_do_send_res        = true;
-    this->m_gw_status_is_mqtt_connected_res        = true;
-
-    adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
-    };
-    this->m_reports = {
-        .num_of_advs = 2,
-        .table = {
-            [0] = {
-                .timestamp = 100500,
-                .samples_counter = 301,
-                .tag_mac = { 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,},
-                .rssi = -49,
-                .data_len = 24,
-                .data_buf = {
-                    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
-                    0x30, 0x31, 0x32, 0x33, 0x34, 0x35,
-                }
-            },
-            [1] = {
-                .timestamp = 100501,
-                .samples_counter = 302,
-                .tag_mac = { 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,},
-                .rssi = -48,
-                .data_len = 24,
-                .data_buf = {
-                    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
-                    0x50, 0x51, 0x52, 0x53, 0x54, 0x55,
-                }
-            },
-        }
-    };
-
-    this->m_malloc_fail_on_cnt = 6;
-
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_TRUE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-
-    this->m_hmac_sha256_set_key_for_http_ruuvi_res = true;
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str123"));
-    ASSERT_EQ(string("key_str123"), this->m_hmac_sha256_set_key_for_http_ruuvi_key);
-    this->m_hmac_sha256_set_key_for_http_ruuvi_res = false;
-    adv_post_set_default_period(15 * 1000);
-    ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    this->m_http_async_poll_res = false;
-
-    adv_post_state.flag_need_to_send_advs1          = false;
-    adv_post_state.flag_need_to_send_advs2          = true;
-    this->m_hmac_sha256_set_key_for_http_custom_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_TRUE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str124"));
-    ASSERT_EQ(string("key_str124"), this->m_hmac_sha256_set_key_for_http_custom_key);
-    this->m_hmac_sha256_set_key_for_http_custom_res = false;
-    adv_post_set_default_period(25 * 1000);
-    ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    this->m_http_async_poll_res = false;
-
-    adv_post_state.flag_need_to_send_advs2      = false;
-    adv_post_state.flag_need_to_send_statistics = true;
-    this->m_hmac_sha256_set_key_for_stats_res   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_TRUE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str125"));
-    ASSERT_EQ(string("key_str125"), this->m_hmac_sha256_set_key_for_stats_key);
-    this->m_hmac_sha256_set_key_for_stats_res = false;
-    adv_post_set_default_period(35 * 1000);
-    ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
-    ASSERT_EQ(25 * 1000, this->m_default_period_for_http_custom);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    this->m_http_async_poll_res = false;
-
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(ADV_POST_SIG_DO_ASYNC_COMM, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(1, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    this->m_http_async_poll_res                           = false;
-
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[0];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
-
-    this->m_mqtt_publish_adv_arg_timestamp = 0;
-    this->m_http_async_poll_res            = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(2, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_http_async_poll_res = false;
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[1];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
-    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
-}
-
-TEST_F(TestAdvPostAsyncComm, test_mqtt_interrupted_periodical_sending) // NOLINT
-{
-    this->m_flag_time_is_synchronized              = true;
-    this->m_http_server_mutex_try_lock_res         = true;
-    this->m_http_post_advs_res                     = true;
-    this->m_gw_cfg_get_http_stat_use_http_stat_res = true;
-    this->m_gw_cfg_get_mqtt_use_mqtt_res           = true;
-    this->m_gw_cfg_get_ntp_use_res                 = true;
-    this->m_adv_post_statistics_do_send_res        = true;
-    this->m_gw_status_is_mqtt_connected_res        = true;
-
-    adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = true,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
-    };
-    this->m_reports = {
-        .num_of_advs = 2,
-        .table = {
-            [0] = {
-                .timestamp = 100500,
-                .samples_counter = 301,
-                .tag_mac = { 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,},
-                .rssi = -49,
-                .data_len = 24,
-                .data_buf = {
-                    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
-                    0x30, 0x31, 0x32, 0x33, 0x34, 0x35,
-                }
-            },
-            [1] = {
-                .timestamp = 100501,
-                .samples_counter = 302,
-                .tag_mac = { 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,},
-                .rssi = -48,
-                .data_len = 24,
-                .data_buf = {
-                    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
-                    0x50, 0x51, 0x52, 0x53, 0x54, 0x55,
-                }
-            },
-        }
-    };
-
-    this->m_mqtt_publish_adv_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(ADV_POST_SIG_DO_ASYNC_COMM, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    adv_post_state.flag_network_connected = false;
-    this->m_mqtt_publish_adv_res          = false;
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(1, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    this->m_http_async_poll_res                           = false;
-
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
@@ -2210,16 +1743,15 @@ TEST_F(TestAdvPostAsyncComm, test_relaying_disabled) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = false,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = false,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -2256,7 +1788,6 @@ TEST_F(TestAdvPostAsyncComm, test_relaying_disabled) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
@@ -2268,7 +1799,6 @@ TEST_F(TestAdvPostAsyncComm, test_relaying_disabled) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs1          = false;
@@ -2281,7 +1811,6 @@ TEST_F(TestAdvPostAsyncComm, test_relaying_disabled) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     this->m_http_async_poll_res = true;
     adv_post_do_async_comm(&adv_post_state);
@@ -2291,7 +1820,6 @@ TEST_F(TestAdvPostAsyncComm, test_relaying_disabled) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs2      = false;
@@ -2304,7 +1832,6 @@ TEST_F(TestAdvPostAsyncComm, test_relaying_disabled) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     this->m_http_async_poll_res = true;
     adv_post_do_async_comm(&adv_post_state);
@@ -2314,39 +1841,8 @@ TEST_F(TestAdvPostAsyncComm, test_relaying_disabled) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(0, this->m_adv_post_signals_send_sig);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    this->m_http_async_poll_res                           = false;
-
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
@@ -2362,16 +1858,15 @@ TEST_F(TestAdvPostAsyncComm, test_http_post_advs_failed) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -2409,14 +1904,12 @@ TEST_F(TestAdvPostAsyncComm, test_http_post_advs_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
     ASSERT_FALSE(adv_post_state.flag_need_to_send_advs1);
     ASSERT_FALSE(adv_post_state.flag_need_to_send_advs2);
     ASSERT_FALSE(adv_post_state.flag_need_to_send_statistics);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_mqtt_periodic);
 
     adv_post_state.flag_need_to_send_advs1          = false;
     adv_post_state.flag_need_to_send_advs2          = true;
@@ -2429,12 +1922,10 @@ TEST_F(TestAdvPostAsyncComm, test_http_post_advs_failed) // NOLINT
     this->m_leds_notify_http2_data_sent_fail = false;
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     ASSERT_FALSE(adv_post_state.flag_need_to_send_advs1);
     ASSERT_FALSE(adv_post_state.flag_need_to_send_advs2);
     ASSERT_FALSE(adv_post_state.flag_need_to_send_statistics);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_mqtt_periodic);
 
     adv_post_state.flag_need_to_send_advs2      = false;
     adv_post_state.flag_need_to_send_statistics = true;
@@ -2446,120 +1937,11 @@ TEST_F(TestAdvPostAsyncComm, test_http_post_advs_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     ASSERT_FALSE(adv_post_state.flag_need_to_send_advs1);
     ASSERT_FALSE(adv_post_state.flag_need_to_send_advs2);
     ASSERT_FALSE(adv_post_state.flag_need_to_send_statistics);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_mqtt_periodic);
 
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_advs1);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_advs2);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_statistics);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_mqtt_periodic);
-
-    ASSERT_EQ(ADV_POST_SIG_DO_ASYNC_COMM, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(1, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    this->m_http_async_poll_res                           = false;
-
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[0];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
-
-    this->m_mqtt_publish_adv_arg_timestamp = 0;
-    this->m_http_async_poll_res            = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(2, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_http_async_poll_res = false;
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
-
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[1];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
@@ -2575,16 +1957,15 @@ TEST_F(TestAdvPostAsyncComm, test_http_server_mutex_try_lock_false) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -2621,7 +2002,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_server_mutex_try_lock_false) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
@@ -2633,7 +2013,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_server_mutex_try_lock_false) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs1          = false;
@@ -2646,7 +2025,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_server_mutex_try_lock_false) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     this->m_http_async_poll_res = true;
     adv_post_do_async_comm(&adv_post_state);
@@ -2656,7 +2034,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_server_mutex_try_lock_false) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
     adv_post_state.flag_need_to_send_advs2      = false;
@@ -2669,35 +2046,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_server_mutex_try_lock_false) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    this->m_http_async_poll_res = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    this->m_http_async_poll_res = false;
-
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(ADV_POST_SIG_DO_ASYNC_COMM, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
 
     this->m_http_async_poll_res = true;
     adv_post_do_async_comm(&adv_post_state);
@@ -2707,83 +2055,8 @@ TEST_F(TestAdvPostAsyncComm, test_http_server_mutex_try_lock_false) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(1, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    this->m_http_async_poll_res                           = false;
-
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[0];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
-
-    this->m_mqtt_publish_adv_arg_timestamp = 0;
-    this->m_http_async_poll_res            = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(2, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_FALSE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_http_async_poll_res = false;
-    ASSERT_TRUE(this->m_mqtt_publish_adv_arg_flag_use_timestamps);
-    ASSERT_NE(0, this->m_mqtt_publish_adv_arg_timestamp);
 
-    {
-        const adv_report_t* const p_adv = &this->m_reports.table[1];
-        ASSERT_EQ(p_adv->timestamp, this->m_mqtt_publish_adv_arg_adv.timestamp);
-        ASSERT_EQ(p_adv->samples_counter, this->m_mqtt_publish_adv_arg_adv.samples_counter);
-        ASSERT_EQ(p_adv->rssi, this->m_mqtt_publish_adv_arg_adv.rssi);
-        ASSERT_EQ(p_adv->data_len, this->m_mqtt_publish_adv_arg_adv.data_len);
-        {
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac;
-            const mac_address_bin_t* const             p_mac = &this->m_mqtt_publish_adv_arg_adv.tag_mac;
-            std::copy(std::begin(p_mac->mac), std::end(p_mac->mac), tag_mac.begin());
-            std::array<uint8_t, MAC_ADDRESS_NUM_BYTES> tag_mac_expected;
-            const mac_address_bin_t* const             p_mac_expected = &p_adv->tag_mac;
-            std::copy(std::begin(p_mac_expected->mac), std::end(p_mac_expected->mac), tag_mac_expected.begin());
-            ASSERT_EQ(tag_mac_expected, tag_mac);
-        }
-        {
-            const size_t            len = p_adv->data_len;
-            std::array<uint8_t, 24> data_buf;
-            std::copy(
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[0],
-                &this->m_mqtt_publish_adv_arg_adv.data_buf[len],
-                data_buf.begin());
-            std::array<uint8_t, 24> data_buf_expected;
-            std::copy(&p_adv->data_buf[0], &p_adv->data_buf[len], data_buf_expected.begin());
-            ASSERT_EQ(data_buf_expected, data_buf);
-        }
-    }
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
@@ -2799,16 +2072,15 @@ TEST_F(TestAdvPostAsyncComm, test_http_async_poll_failed) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -2845,15 +2117,14 @@ TEST_F(TestAdvPostAsyncComm, test_http_async_poll_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
     this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
 
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = true;
-    ASSERT_TRUE(adv_post_set_hmac_sha256_key("key_str123"));
+    ASSERT_TRUE(adv_post_set_hmac_sha256_key(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, "key_str123"));
     ASSERT_EQ(string("key_str123"), this->m_hmac_sha256_set_key_for_http_ruuvi_key);
     this->m_hmac_sha256_set_key_for_http_ruuvi_res = false;
-    adv_post_set_default_period(15 * 1000);
+    adv_post_set_default_period(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, 15 * 1000);
     ASSERT_EQ(15 * 1000, this->m_default_period_for_http_ruuvi);
 
     this->m_http_async_poll_res = false;
@@ -2864,7 +2135,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_async_poll_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     adv_post_state.flag_need_to_send_advs1          = false;
     adv_post_state.flag_need_to_send_advs2          = true;
@@ -2876,7 +2146,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_async_poll_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     this->m_http_async_poll_res = false;
     adv_post_do_async_comm(&adv_post_state);
@@ -2886,7 +2155,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_async_poll_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     adv_post_state.flag_need_to_send_advs2      = false;
     adv_post_state.flag_need_to_send_statistics = true;
@@ -2898,34 +2166,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_async_poll_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    this->m_http_async_poll_res = false;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_TRUE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_TRUE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(0, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
 
     this->m_http_async_poll_res = false;
     adv_post_do_async_comm(&adv_post_state);
@@ -2935,22 +2175,6 @@ TEST_F(TestAdvPostAsyncComm, test_http_async_poll_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-
-    this->m_mqtt_publish_adv_arg_timestamp = 0;
-    this->m_http_async_poll_res            = false;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_TRUE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -2967,16 +2191,15 @@ TEST_F(TestAdvPostAsyncComm, test_disable_sending_statistics) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = true,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = true,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -3013,7 +2236,6 @@ TEST_F(TestAdvPostAsyncComm, test_disable_sending_statistics) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     this->m_http_async_poll_res = true;
     adv_post_do_async_comm(&adv_post_state);
@@ -3023,26 +2245,8 @@ TEST_F(TestAdvPostAsyncComm, test_disable_sending_statistics) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
-    adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
-    ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
-    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(0, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
-
-    ASSERT_EQ(0, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
-
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
@@ -3058,16 +2262,15 @@ TEST_F(TestAdvPostAsyncComm, test_adv_post_statistics_do_send_failed) // NOLINT
     this->m_gw_status_is_mqtt_connected_res        = true;
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = true,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = true,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     this->m_reports = {
         .num_of_advs = 2,
@@ -3104,7 +2307,6 @@ TEST_F(TestAdvPostAsyncComm, test_adv_post_statistics_do_send_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
 
     this->m_http_async_poll_res = true;
     adv_post_do_async_comm(&adv_post_state);
@@ -3114,25 +2316,199 @@ TEST_F(TestAdvPostAsyncComm, test_adv_post_statistics_do_send_failed) // NOLINT
     ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
     ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
     this->m_http_async_poll_res = false;
 
-    adv_post_state.flag_need_to_send_statistics    = false;
-    adv_post_state.flag_need_to_send_mqtt_periodic = true;
-    this->m_mqtt_publish_adv_res                   = true;
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+TEST_F(TestAdvPostAsyncComm, test_no_network_connection_spool_and_drain) // NOLINT
+{
+    this->m_flag_time_is_synchronized      = true;
+    this->m_http_server_mutex_try_lock_res = true;
+    this->m_http_post_advs_res             = true;
+    this->m_adv_spool_enabled              = true;
+
+    adv_post_state_t adv_post_state = {
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = false,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
+    };
+    this->m_reports = {
+        .num_of_advs = 2,
+        .table = {
+            [0] = {
+                .timestamp = 100500,
+                .samples_counter = 301,
+                .tag_mac = { 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,},
+                .rssi = -49,
+                .data_len = 3,
+                .data_buf = { 0x21, 0x22, 0x23, },
+            },
+            [1] = {
+                .timestamp = 100501,
+                .samples_counter = 302,
+                .tag_mac = { 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,},
+                .rssi = -48,
+                .data_len = 3,
+                .data_buf = { 0x51, 0x52, 0x53, },
+            },
+        }
+    };
+
+    // No network connection - the advs are moved to the spool
     adv_post_do_async_comm(&adv_post_state);
-    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
+    ASSERT_FALSE(adv_post_state.flag_need_to_send_advs1);
+    ASSERT_FALSE(adv_post_state.flag_async_comm_in_progress);
     ASSERT_FALSE(this->m_http_server_mutex_locked);
-    ASSERT_FALSE(this->m_leds_notify_http1_data_sent_fail);
-    ASSERT_FALSE(this->m_leds_notify_http2_data_sent_fail);
     ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
-    ASSERT_EQ(1, this->m_adv_post_statistics_do_send_call_cnt);
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_call_cnt);
+    ASSERT_EQ(1U, this->m_adv_spool.size());
+    ASSERT_EQ(ADV_SPOOL_TARGET_HTTP_RUUVI, this->m_adv_spool[0].first);
+    ASSERT_EQ(2U, this->m_adv_spool[0].second.size());
+    ASSERT_EQ(100501, this->m_adv_spool[0].second[1].timestamp);
 
-    ASSERT_EQ(0, this->m_adv_post_signals_send_sig);
-    ASSERT_TRUE(this->m_adv_post_timers_start_timer_sig_do_async_comm);
-    this->m_adv_post_timers_start_timer_sig_do_async_comm = false;
-    ASSERT_EQ(0, this->m_mqtt_publish_adv_arg_timestamp);
+    adv_post_state.flag_need_to_send_advs2 = true;
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_FALSE(adv_post_state.flag_need_to_send_advs2);
+    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
+    ASSERT_EQ(2U, this->m_adv_spool.size());
+    ASSERT_EQ(ADV_SPOOL_TARGET_HTTP_CUSTOM, this->m_adv_spool[1].first);
+
+    // The network connection is restored - the spool is drained one record per HTTP POST
+    adv_post_state.flag_network_connected = true;
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_TRUE(adv_post_state.flag_async_comm_in_progress);
+    ASSERT_TRUE(this->m_http_server_mutex_locked);
+    ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
+    ASSERT_TRUE(this->m_http_post_advs_arg_flag_post_to_ruuvi);
+    ASSERT_EQ(2, this->m_http_post_advs_arg_reports.num_of_advs);
+    ASSERT_EQ(100500, this->m_http_post_advs_arg_reports.table[0].timestamp);
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
+    ASSERT_EQ(2U, this->m_adv_spool.size());
+
+    // The HTTP POST failed - the record is kept and draining is paused
+    this->m_http_async_poll_res                   = true;
+    this->m_http_async_is_last_req_successful_res = false;
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_FALSE(adv_post_state.flag_async_comm_in_progress);
+    ASSERT_FALSE(this->m_http_server_mutex_locked);
+    ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
+    ASSERT_EQ(2U, this->m_adv_spool.size());
+    ASSERT_TRUE(this->m_adv_spool_consume_history.empty());
+
+    // A successful regular HTTP POST resumes draining
+    this->m_http_async_poll_res                   = false;
+    this->m_http_async_is_last_req_successful_res = true;
+    adv_post_state.flag_need_to_send_advs1        = true;
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
+    this->m_http_async_poll_res = true;
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_FALSE(adv_post_state.flag_need_to_send_advs1);
+    ASSERT_EQ(3, this->m_http_post_advs_call_cnt);
+    ASSERT_TRUE(this->m_http_post_advs_arg_flag_post_to_ruuvi);
+    ASSERT_TRUE(adv_post_state.flag_async_comm_in_progress);
+
+    // The record is consumed after it has been delivered, then the next record is sent
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_EQ((vector<bool> { true }), this->m_adv_spool_consume_history);
+    ASSERT_EQ(4, this->m_http_post_advs_call_cnt);
+    ASSERT_FALSE(this->m_http_post_advs_arg_flag_post_to_ruuvi);
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM));
+    ASSERT_FALSE(adv_post_state.flag_need_to_send_advs2);
 
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_EQ((vector<bool> { true, true }), this->m_adv_spool_consume_history);
+    ASSERT_TRUE(this->m_adv_spool.empty());
+    ASSERT_FALSE(adv_post_state.flag_async_comm_in_progress);
+    ASSERT_FALSE(this->m_http_server_mutex_locked);
+    ASSERT_EQ(4, this->m_http_post_advs_call_cnt);
+    ASSERT_FALSE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
+    ASSERT_FALSE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM));
+
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvPostAsyncComm, test_drain_spool_target_disabled) // NOLINT
+{
+    this->m_flag_time_is_synchronized           = true;
+    this->m_http_server_mutex_try_lock_res      = true;
+    this->m_http_post_advs_res                  = true;
+    this->m_adv_spool_enabled                   = true;
+    this->m_gw_cfg_get_http_use_http_ruuvi_res  = false;
+    adv_report_t adv                            = {};
+    adv.timestamp                               = 100500;
+    this->m_adv_spool.emplace_back(ADV_SPOOL_TARGET_HTTP_RUUVI, vector<adv_report_t> { adv });
+
+    adv_post_state_t adv_post_state = {
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
+    };
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_EQ(0, this->m_http_post_advs_call_cnt);
+    ASSERT_FALSE(adv_post_state.flag_async_comm_in_progress);
+    ASSERT_FALSE(this->m_http_server_mutex_locked);
+    ASSERT_TRUE(this->m_adv_spool.empty());
+    ASSERT_EQ((vector<bool> { false }), this->m_adv_spool_consume_history);
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
-}
\ No newline at end of file
+}
+
+TEST_F(TestAdvPostAsyncComm, test_drain_spool_stale_ack_is_ignored) // NOLINT
+{
+    this->m_flag_time_is_synchronized      = true;
+    this->m_http_server_mutex_try_lock_res = true;
+    this->m_http_post_advs_res             = true;
+    this->m_adv_spool_enabled              = true;
+    adv_report_t adv                       = {};
+    adv.timestamp                          = 100500;
+    this->m_adv_spool.emplace_back(ADV_SPOOL_TARGET_HTTP_RUUVI, vector<adv_report_t> { adv });
+    adv.timestamp = 100501;
+    this->m_adv_spool.emplace_back(ADV_SPOOL_TARGET_HTTP_RUUVI, vector<adv_report_t> { adv });
+
+    adv_post_state_t adv_post_state = {
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
+    };
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_EQ(1, this->m_http_post_advs_call_cnt);
+    ASSERT_EQ(100500, this->m_http_post_advs_arg_reports.table[0].timestamp);
+    ASSERT_TRUE(adv_post_is_action_in_progress(ADV_POST_ACTION_POST_ADVS_TO_RUUVI));
+
+    // The record being sent is dropped because the spool has overflowed
+    this->m_adv_spool.pop_front();
+    this->m_adv_spool_num_removed += 1;
+
+    // The ack of the dropped record does not consume the next one, which is sent after that
+    this->m_http_async_poll_res = true;
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_TRUE(this->m_adv_spool_consume_history.empty());
+    ASSERT_EQ(1U, this->m_adv_spool.size());
+    ASSERT_EQ(2, this->m_http_post_advs_call_cnt);
+    ASSERT_EQ(100501, this->m_http_post_advs_arg_reports.table[0].timestamp);
+    ASSERT_TRUE(adv_post_state.flag_async_comm_in_progress);
+
+    adv_post_do_async_comm(&adv_post_state);
+    ASSERT_EQ((vector<bool> { true }), this->m_adv_spool_consume_history);
+    ASSERT_TRUE(this->m_adv_spool.empty());
+    ASSERT_FALSE(adv_post_state.flag_async_comm_in_progress);
+    ASSERT_FALSE(this->m_http_server_mutex_locked);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
@@ -7,8 +7,12 @@
 
 #include "adv_post_cfg_cache.h"
 #include "gtest/gtest.h"
+#include <chrono>
+#include <cstring>
 #include <string>
+#include <vector>
 #include "os_mutex.h"
+#include "os_malloc.h"
 
 using namespace std;
 
@@ -26,8 +30,11 @@ protected:
     void
     SetUp() override
     {
-        this->m_is_mutex_busy = false;
-        g_pTestClass          = this;
+        this->m_is_mutex_busy      = false;
+        this->m_malloc_cnt         = 0;
+        this->m_malloc_fail_on_cnt = 0;
+        this->m_num_allocated      = 0;
+        g_pTestClass               = this;
     }
 
     void
@@ -44,6 +51,9 @@ public:
 
     bool       m_is_mutex_busy = false;
     os_mutex_t p_mutex;
+    uint32_t   m_malloc_cnt {};
+    uint32_t   m_malloc_fail_on_cnt {};
+    uint32_t   m_num_allocated {};
 };
 
 TestAdvPostCfgCache::TestAdvPostCfgCache()
@@ -103,8 +113,65 @@ os_mutex_unlock(os_mutex_t const h_mutex)
     g_pTestClass->m_is_mutex_busy = false;
 }
 
+void*
+os_calloc(const size_t nmemb, const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    g_pTestClass->m_num_allocated += 1;
+    return calloc(nmemb, size);
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    assert(nullptr != g_pTestClass);
+    assert(0 != g_pTestClass->m_num_allocated);
+    g_pTestClass->m_num_allocated -= 1;
+    free(p_mem);
+}
+
 } // extern "C"
 
+static mac_address_bin_t
+conv_u64_to_mac(const uint64_t mac_addr)
+{
+    const mac_address_bin_t mac = { {
+        static_cast<uint8_t>((mac_addr >> 40U) & 0xFFU),
+        static_cast<uint8_t>((mac_addr >> 32U) & 0xFFU),
+        static_cast<uint8_t>((mac_addr >> 24U) & 0xFFU),
+        static_cast<uint8_t>((mac_addr >> 16U) & 0xFFU),
+        static_cast<uint8_t>((mac_addr >> 8U) & 0xFFU),
+        static_cast<uint8_t>((mac_addr >> 0U) & 0xFFU),
+    } };
+    return mac;
+}
+
+// This is the implementation of the scan filter check which was used before the scan filter was sorted,
+// it's used as a reference in the benchmark.
+static bool
+check_if_mac_filtered_out_linear(
+    const bool                            flag_allow_listed,
+    const std::vector<mac_address_bin_t>& arr_of_mac,
+    const mac_address_bin_t* const        p_mac_addr)
+{
+    if (arr_of_mac.empty())
+    {
+        return false;
+    }
+    for (const auto& mac : arr_of_mac)
+    {
+        if (0 == memcmp(p_mac_addr, &mac, sizeof(*p_mac_addr)))
+        {
+            return !flag_allow_listed;
+        }
+    }
+    return flag_allow_listed;
+}
+
 /*** Unit-Tests
  * *******************************************************************************************************/
 
@@ -238,3 +305,144 @@ TEST_F(TestAdvPostCfgCache, test_initialized_lock) // NOLINT
 
     adv_post_cfg_cache_deinit();
 }
+
+TEST_F(TestAdvPostCfgCache, test_conv_mac) // NOLINT
+{
+    const mac_address_bin_t mac = { { 0xAAU, 0xBBU, 0xCCU, 0x11U, 0x22U, 0x33U } };
+    ASSERT_EQ(0xAABBCC112233ULL, adv_post_cfg_cache_conv_mac(&mac));
+}
+
+TEST_F(TestAdvPostCfgCache, test_scan_filter_empty) // NOLINT
+{
+    adv_post_cfg_cache_t cfg_cache = {};
+
+    ASSERT_TRUE(adv_post_cfg_cache_scan_filter_set(&cfg_cache, true, nullptr, 0));
+    ASSERT_TRUE(cfg_cache.scan_filter_allow_listed);
+    ASSERT_EQ(0, cfg_cache.scan_filter_length);
+    ASSERT_EQ(nullptr, cfg_cache.p_arr_of_scan_filter_mac);
+
+    const mac_address_bin_t mac = conv_u64_to_mac(0xAABBCC112233ULL);
+    ASSERT_FALSE(adv_post_cfg_cache_scan_filter_contains(&cfg_cache, &mac));
+    ASSERT_FALSE(adv_post_cfg_cache_is_mac_filtered_out(&cfg_cache, &mac));
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvPostCfgCache, test_scan_filter_sorted_without_duplicates) // NOLINT
+{
+    adv_post_cfg_cache_t    cfg_cache    = {};
+    const mac_address_bin_t arr_of_mac[] = {
+        conv_u64_to_mac(0xAABBCC000003ULL), conv_u64_to_mac(0x112233445566ULL), conv_u64_to_mac(0xAABBCC000001ULL),
+        conv_u64_to_mac(0x112233445566ULL), conv_u64_to_mac(0xFFFFFFFFFFFFULL), conv_u64_to_mac(0x000000000000ULL),
+    };
+    ASSERT_TRUE(
+        adv_post_cfg_cache_scan_filter_set(&cfg_cache, false, arr_of_mac, sizeof(arr_of_mac) / sizeof(arr_of_mac[0])));
+    ASSERT_FALSE(cfg_cache.scan_filter_allow_listed);
+    ASSERT_EQ(5, cfg_cache.scan_filter_length);
+    ASSERT_EQ(0x000000000000ULL, cfg_cache.p_arr_of_scan_filter_mac[0]);
+    ASSERT_EQ(0x112233445566ULL, cfg_cache.p_arr_of_scan_filter_mac[1]);
+    ASSERT_EQ(0xAABBCC000001ULL, cfg_cache.p_arr_of_scan_filter_mac[2]);
+    ASSERT_EQ(0xAABBCC000003ULL, cfg_cache.p_arr_of_scan_filter_mac[3]);
+    ASSERT_EQ(0xFFFFFFFFFFFFULL, cfg_cache.p_arr_of_scan_filter_mac[4]);
+
+    for (const auto& mac : arr_of_mac)
+    {
+        ASSERT_TRUE(adv_post_cfg_cache_scan_filter_contains(&cfg_cache, &mac));
+        ASSERT_TRUE(adv_post_cfg_cache_is_mac_filtered_out(&cfg_cache, &mac));
+    }
+    const mac_address_bin_t mac_not_in_list[] = {
+        conv_u64_to_mac(0x000000000001ULL),
+        conv_u64_to_mac(0xAABBCC000002ULL),
+        conv_u64_to_mac(0xFFFFFFFFFFFEULL),
+    };
+    for (const auto& mac : mac_not_in_list)
+    {
+        ASSERT_FALSE(adv_post_cfg_cache_scan_filter_contains(&cfg_cache, &mac));
+        ASSERT_FALSE(adv_post_cfg_cache_is_mac_filtered_out(&cfg_cache, &mac));
+    }
+
+    ASSERT_TRUE(adv_post_cfg_cache_scan_filter_set(&cfg_cache, true, arr_of_mac, 2));
+    ASSERT_TRUE(cfg_cache.scan_filter_allow_listed);
+    ASSERT_EQ(2, cfg_cache.scan_filter_length);
+    ASSERT_FALSE(adv_post_cfg_cache_is_mac_filtered_out(&cfg_cache, &arr_of_mac[0]));
+    ASSERT_FALSE(adv_post_cfg_cache_is_mac_filtered_out(&cfg_cache, &arr_of_mac[1]));
+    ASSERT_TRUE(adv_post_cfg_cache_is_mac_filtered_out(&cfg_cache, &arr_of_mac[2]));
+    ASSERT_EQ(1, this->m_num_allocated);
+
+    adv_post_cfg_cache_scan_filter_clear(&cfg_cache);
+    ASSERT_EQ(0, cfg_cache.scan_filter_length);
+    ASSERT_EQ(nullptr, cfg_cache.p_arr_of_scan_filter_mac);
+    ASSERT_FALSE(adv_post_cfg_cache_is_mac_filtered_out(&cfg_cache, &arr_of_mac[2]));
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvPostCfgCache, test_scan_filter_malloc_failed) // NOLINT
+{
+    adv_post_cfg_cache_t    cfg_cache    = {};
+    const mac_address_bin_t arr_of_mac[] = {
+        conv_u64_to_mac(0xAABBCC000003ULL),
+        conv_u64_to_mac(0x112233445566ULL),
+    };
+    ASSERT_TRUE(adv_post_cfg_cache_scan_filter_set(&cfg_cache, true, arr_of_mac, 2));
+    ASSERT_EQ(2, cfg_cache.scan_filter_length);
+
+    this->m_malloc_fail_on_cnt = 2;
+    ASSERT_FALSE(adv_post_cfg_cache_scan_filter_set(&cfg_cache, true, arr_of_mac, 1));
+    ASSERT_EQ(0, cfg_cache.scan_filter_length);
+    ASSERT_EQ(nullptr, cfg_cache.p_arr_of_scan_filter_mac);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvPostCfgCache, test_scan_filter_benchmark) // NOLINT
+{
+    const uint32_t num_of_macs_in_filter = 100;
+    const uint32_t num_of_advs           = 200000;
+
+    std::vector<mac_address_bin_t> arr_of_mac;
+    for (uint32_t i = 0; i < num_of_macs_in_filter; ++i)
+    {
+        arr_of_mac.push_back(conv_u64_to_mac(0xC00000000000ULL + (i * 7919U)));
+    }
+    adv_post_cfg_cache_t cfg_cache = {};
+    ASSERT_TRUE(adv_post_cfg_cache_scan_filter_set(&cfg_cache, true, arr_of_mac.data(), arr_of_mac.size()));
+
+    // Half of the advertisements are from the allowed MACs, the other half - from unknown MACs
+    // (the worst case for the linear search).
+    std::vector<mac_address_bin_t> arr_of_adv_mac;
+    for (uint32_t i = 0; i < num_of_advs; ++i)
+    {
+        arr_of_adv_mac.push_back(
+            (0 == (i % 2)) ? arr_of_mac[(i / 2) % num_of_macs_in_filter] : conv_u64_to_mac(0xD00000000000ULL + i));
+    }
+
+    uint32_t   num_filtered_out_linear = 0;
+    const auto time_linear_start       = std::chrono::steady_clock::now();
+    for (const auto& mac : arr_of_adv_mac)
+    {
+        num_filtered_out_linear += check_if_mac_filtered_out_linear(true, arr_of_mac, &mac) ? 1 : 0;
+    }
+    const auto time_linear_end = std::chrono::steady_clock::now();
+
+    uint32_t   num_filtered_out_sorted = 0;
+    const auto time_sorted_start       = std::chrono::steady_clock::now();
+    for (const auto& mac : arr_of_adv_mac)
+    {
+        num_filtered_out_sorted += adv_post_cfg_cache_is_mac_filtered_out(&cfg_cache, &mac) ? 1 : 0;
+    }
+    const auto time_sorted_end = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(num_of_advs / 2, num_filtered_out_linear);
+    ASSERT_EQ(num_filtered_out_linear, num_filtered_out_sorted);
+
+    const double ns_per_adv_linear
+        = std::chrono::duration<double, std::nano>(time_linear_end - time_linear_start).count() / num_of_advs;
+    const double ns_per_adv_sorted
+        = std::chrono::duration<double, std::nano>(time_sorted_end - time_sorted_start).count() / num_of_advs;
+    printf(
+        "Scan filter with %u MACs: linear search: %.1f ns/adv, binary search: %.1f ns/adv\n",
+        (unsigned)num_of_macs_in_filter,
+        ns_per_adv_linear,
+        ns_per_adv_sorted);
+
+    adv_post_cfg_cache_scan_filter_clear(&cfg_cache);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
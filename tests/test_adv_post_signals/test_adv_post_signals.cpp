@@ -62,10 +62,12 @@ enum event_type_e
     EVENT_HISTORY_ADV_POST_CFG_CACHE_MUTEX_LOCK,
     EVENT_HISTORY_ADV_POST_CFG_CACHE_MUTEX_UNLOCK,
     EVENT_HISTORY_ADV_POST_ON_GREEN_LED_UPDATE,
+    EVENT_HISTORY_ADV_POST_ON_RECV_ADVS,
     EVENT_HISTORY_EVENT_MGR_NOTIFY,
     EVENT_HISTORY_ADV_POST_TIMERS_POSTPONE_SENDING_STATISTICS,
     EVENT_HISTORY_NETWORK_WATCHDOG_TIMER_START,
     EVENT_HISTORY_NETWORK_WATCHDOG_TIMER_STOP,
+    EVENT_HISTORY_ADV_MQTT_PUBLISH_PERIODIC,
 };
 
 typedef struct event_info_t
@@ -181,8 +183,8 @@ protected:
         this->adv_table_read_retransmission_list3_head_res     = true;
         this->adv_table_read_retransmission_list3_is_empty_res = true;
         this->m_adv_report                                     = {};
-        this->mqtt_publish_adv_res                             = true;
         this->m_network_timeout_check_res                      = false;
+        this->m_http_keep_alive_close_all_cnt                  = 0;
         this->m_adv_post_cfg_cache                             = {};
         this->m_gw_cfg                                         = {};
     }
@@ -215,8 +217,8 @@ public:
     bool                      adv_table_read_retransmission_list3_head_res { true };
     bool                      adv_table_read_retransmission_list3_is_empty_res { true };
     adv_report_t              m_adv_report {};
-    bool                      mqtt_publish_adv_res { true };
     bool                      m_network_timeout_check_res { false };
+    uint32_t                  m_http_keep_alive_close_all_cnt { 0 };
     adv_post_cfg_cache_t      m_adv_post_cfg_cache {};
     std::vector<event_info_t> m_events_history {};
 };
@@ -501,10 +503,10 @@ adv_table_read_retransmission_list3_is_empty(void)
     return g_pTestClass->adv_table_read_retransmission_list3_is_empty_res;
 }
 
-bool
-mqtt_publish_adv(const adv_report_t* const p_adv, const bool flag_use_timestamps, const time_t timestamp)
+void
+adv_mqtt_publish_periodic(void)
 {
-    return g_pTestClass->mqtt_publish_adv_res;
+    g_pTestClass->m_events_history.push_back({ .event_type = EVENT_HISTORY_ADV_MQTT_PUBLISH_PERIODIC });
 }
 
 void
@@ -531,6 +533,12 @@ http_abort_any_req_during_processing(void)
     g_pTestClass->m_events_history.push_back({ .event_type = EVENT_HISTORY_HTTP_ABORT_ANY_REQ_DURING_PROCESSING });
 }
 
+void
+http_keep_alive_close_all(void)
+{
+    g_pTestClass->m_http_keep_alive_close_all_cnt += 1;
+}
+
 void
 http_server_mutex_activate(void)
 {
@@ -594,6 +602,48 @@ adv_post_cfg_cache_mutex_unlock(adv_post_cfg_cache_t** p_p_cfg_cache)
     *p_p_cfg_cache = nullptr;
 }
 
+void
+adv_post_cfg_cache_scan_filter_clear(adv_post_cfg_cache_t* const p_cfg_cache)
+{
+    p_cfg_cache->scan_filter_length = 0;
+    if (nullptr != p_cfg_cache->p_arr_of_scan_filter_mac)
+    {
+        os_free(p_cfg_cache->p_arr_of_scan_filter_mac);
+    }
+}
+
+bool
+adv_post_cfg_cache_scan_filter_set(
+    adv_post_cfg_cache_t* const    p_cfg_cache,
+    const bool                     flag_allow_listed,
+    const mac_address_bin_t* const p_arr_of_mac,
+    const uint32_t                 num_of_macs)
+{
+    adv_post_cfg_cache_scan_filter_clear(p_cfg_cache);
+    p_cfg_cache->scan_filter_allow_listed = flag_allow_listed;
+    if (0 == num_of_macs)
+    {
+        return true;
+    }
+    p_cfg_cache->p_arr_of_scan_filter_mac = static_cast<adv_post_cfg_cache_mac_t*>(
+        os_calloc(num_of_macs, sizeof(*p_cfg_cache->p_arr_of_scan_filter_mac)));
+    if (nullptr == p_cfg_cache->p_arr_of_scan_filter_mac)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < num_of_macs; ++i)
+    {
+        adv_post_cfg_cache_mac_t mac = 0;
+        for (uint32_t j = 0; j < MAC_ADDRESS_NUM_BYTES; ++j)
+        {
+            mac = (mac << 8U) | p_arr_of_mac[i].mac[j];
+        }
+        p_cfg_cache->p_arr_of_scan_filter_mac[i] = mac;
+    }
+    p_cfg_cache->scan_filter_length = num_of_macs;
+    return true;
+}
+
 void
 adv1_post_timer_restart_from_current_moment(void)
 {
@@ -671,6 +721,12 @@ adv_post_on_green_led_update(const adv_post_green_led_cmd_e cmd)
         { .event_type = EVENT_HISTORY_ADV_POST_ON_GREEN_LED_UPDATE, .green_led_update = { .cmd = cmd } });
 }
 
+void
+adv_post_on_recv_advs(void)
+{
+    g_pTestClass->m_events_history.push_back({ .event_type = EVENT_HISTORY_ADV_POST_ON_RECV_ADVS });
+}
+
 void
 event_mgr_notify(const event_mgr_ev_e event)
 {
@@ -828,6 +884,8 @@ TEST_F(TestAdvPostSignals, test_adv_post_signals_init_deinit) // NOLINT
           .os_signal_add = { .sig_num = adv_post_conv_to_sig_num(ADV_POST_SIG_GREEN_LED_UPDATE) } },
         { .event_type    = EVENT_HISTORY_OS_SIGNAL_ADD,
           .os_signal_add = { .sig_num = adv_post_conv_to_sig_num(ADV_POST_SIG_RECV_ADV_TIMEOUT) } },
+        { .event_type    = EVENT_HISTORY_OS_SIGNAL_ADD,
+          .os_signal_add = { .sig_num = adv_post_conv_to_sig_num(ADV_POST_SIG_RECV_ADV) } },
         { .event_type = EVENT_HISTORY_OS_SIGNAL_UNREGISTER_CUR_THREAD },
         { .event_type = EVENT_HISTORY_OS_SIGNAL_DELETE },
     };
@@ -893,6 +951,7 @@ TEST_F(TestAdvPostSignals, test_adv_post_conv_to_sig_num) // NOLINT
     ASSERT_EQ(OS_SIGNAL_NUM_25, adv_post_conv_to_sig_num(ADV_POST_SIG_GREEN_LED_STATE_CHANGED));
     ASSERT_EQ(OS_SIGNAL_NUM_26, adv_post_conv_to_sig_num(ADV_POST_SIG_GREEN_LED_UPDATE));
     ASSERT_EQ(OS_SIGNAL_NUM_27, adv_post_conv_to_sig_num(ADV_POST_SIG_RECV_ADV_TIMEOUT));
+    ASSERT_EQ(OS_SIGNAL_NUM_28, adv_post_conv_to_sig_num(ADV_POST_SIG_RECV_ADV));
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -927,6 +986,7 @@ TEST_F(TestAdvPostSignals, test_adv_post_conv_from_sig_num) // NOLINT
     ASSERT_EQ(ADV_POST_SIG_GREEN_LED_STATE_CHANGED, adv_post_conv_from_sig_num(OS_SIGNAL_NUM_25));
     ASSERT_EQ(ADV_POST_SIG_GREEN_LED_UPDATE, adv_post_conv_from_sig_num(OS_SIGNAL_NUM_26));
     ASSERT_EQ(ADV_POST_SIG_RECV_ADV_TIMEOUT, adv_post_conv_from_sig_num(OS_SIGNAL_NUM_27));
+    ASSERT_EQ(ADV_POST_SIG_RECV_ADV, adv_post_conv_from_sig_num(OS_SIGNAL_NUM_28));
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -994,20 +1054,20 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_network_disconnected) // NOL
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_NETWORK_DISCONNECTED, &adv_post_state));
     ASSERT_FALSE(adv_post_state.flag_stop);
     ASSERT_FALSE(adv_post_state.flag_network_connected);
+    ASSERT_EQ(1, this->m_http_keep_alive_close_all_cnt);
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -1018,16 +1078,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_network_connected_no_pending
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = false,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = false,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_NETWORK_CONNECTED, &adv_post_state));
     ASSERT_FALSE(adv_post_state.flag_stop);
@@ -1044,16 +1103,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_network_connected_with_pendi
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = false,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = true,
-        .flag_need_to_send_advs2         = true,
-        .flag_need_to_send_statistics    = true,
-        .flag_need_to_send_mqtt_periodic = true,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = false,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = true,
+        .flag_need_to_send_advs2        = true,
+        .flag_need_to_send_statistics   = true,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_NETWORK_CONNECTED, &adv_post_state));
     ASSERT_FALSE(adv_post_state.flag_stop);
@@ -1083,16 +1141,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_time_synchronized) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = false,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = false,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     m_gw_cfg.ruuvi_cfg.http_stat.use_http_stat = false;
@@ -1148,16 +1205,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_retransmit) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = false,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = false,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     adv_post_state.flag_relaying_enabled         = false;
@@ -1199,16 +1255,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_retransmit2) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = false,
-        .flag_network_connected          = false,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = false,
+        .flag_network_connected         = false,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     adv_post_state.flag_relaying_enabled   = false;
@@ -1250,47 +1305,42 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_retransmit_mqtt) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     adv_post_state.flag_relaying_enabled   = false;
     this->m_gw_cfg.ruuvi_cfg.mqtt.use_mqtt = false;
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RETRANSMIT_MQTT, &adv_post_state));
     ASSERT_FALSE(adv_post_state.flag_stop);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_mqtt_periodic);
     ASSERT_EQ(0, this->m_events_history.size());
 
     adv_post_state.flag_relaying_enabled   = true;
     this->m_gw_cfg.ruuvi_cfg.mqtt.use_mqtt = false;
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RETRANSMIT_MQTT, &adv_post_state));
     ASSERT_FALSE(adv_post_state.flag_stop);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_mqtt_periodic);
     ASSERT_EQ(0, this->m_events_history.size());
 
     adv_post_state.flag_relaying_enabled   = false;
     this->m_gw_cfg.ruuvi_cfg.mqtt.use_mqtt = true;
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RETRANSMIT_MQTT, &adv_post_state));
     ASSERT_FALSE(adv_post_state.flag_stop);
-    ASSERT_FALSE(adv_post_state.flag_need_to_send_mqtt_periodic);
     ASSERT_EQ(0, this->m_events_history.size());
 
     adv_post_state.flag_relaying_enabled   = true;
     this->m_gw_cfg.ruuvi_cfg.mqtt.use_mqtt = true;
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RETRANSMIT_MQTT, &adv_post_state));
     ASSERT_FALSE(adv_post_state.flag_stop);
-    ASSERT_TRUE(adv_post_state.flag_need_to_send_mqtt_periodic);
+    ASSERT_FALSE(adv_post_state.flag_async_comm_in_progress);
     ASSERT_EQ(1, this->m_events_history.size());
-    ASSERT_EQ(EVENT_HISTORY_OS_SIGNAL_SEND, this->m_events_history[0].event_type);
-    ASSERT_EQ(adv_post_conv_to_sig_num(ADV_POST_SIG_DO_ASYNC_COMM), this->m_events_history[0].os_signal_send.sig_num);
+    ASSERT_EQ(EVENT_HISTORY_ADV_MQTT_PUBLISH_PERIODIC, this->m_events_history[0].event_type);
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
@@ -1301,16 +1351,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_send_statistics) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     adv_post_state.flag_relaying_enabled             = false;
@@ -1352,16 +1401,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_do_async_comm) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_DO_ASYNC_COMM, &adv_post_state));
@@ -1379,16 +1427,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -1399,9 +1446,11 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
         ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RELAYING_MODE_CHANGED, &adv_post_state));
         ASSERT_FALSE(adv_post_state.flag_stop);
         ASSERT_FALSE(adv_post_state.flag_relaying_enabled);
+        ASSERT_EQ(1, this->m_http_keep_alive_close_all_cnt);
         ASSERT_EQ(1, this->m_events_history.size());
         ASSERT_EQ(EVENT_HISTORY_GW_STATUS_CLEAR_HTTP_RELAYING_CMD, this->m_events_history[0].event_type);
         this->m_events_history.clear();
+        this->m_http_keep_alive_close_all_cnt = 0;
     }
     {
         this->m_gw_status_is_relaying_via_http_enabled = true;
@@ -1411,9 +1460,11 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
         ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RELAYING_MODE_CHANGED, &adv_post_state));
         ASSERT_FALSE(adv_post_state.flag_stop);
         ASSERT_TRUE(adv_post_state.flag_relaying_enabled);
+        ASSERT_EQ(0, this->m_http_keep_alive_close_all_cnt);
         ASSERT_EQ(1, this->m_events_history.size());
         ASSERT_EQ(EVENT_HISTORY_GW_STATUS_CLEAR_HTTP_RELAYING_CMD, this->m_events_history[0].event_type);
         this->m_events_history.clear();
+        this->m_http_keep_alive_close_all_cnt = 0;
     }
     {
         this->m_gw_status_is_relaying_via_http_enabled = false;
@@ -1423,9 +1474,11 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
         ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RELAYING_MODE_CHANGED, &adv_post_state));
         ASSERT_FALSE(adv_post_state.flag_stop);
         ASSERT_FALSE(adv_post_state.flag_relaying_enabled);
+        ASSERT_EQ(1, this->m_http_keep_alive_close_all_cnt);
         ASSERT_EQ(1, this->m_events_history.size());
         ASSERT_EQ(EVENT_HISTORY_GW_STATUS_CLEAR_HTTP_RELAYING_CMD, this->m_events_history[0].event_type);
         this->m_events_history.clear();
+        this->m_http_keep_alive_close_all_cnt = 0;
     }
     {
         this->m_gw_status_is_relaying_via_http_enabled = true;
@@ -1435,9 +1488,11 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
         ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RELAYING_MODE_CHANGED, &adv_post_state));
         ASSERT_FALSE(adv_post_state.flag_stop);
         ASSERT_TRUE(adv_post_state.flag_relaying_enabled);
+        ASSERT_EQ(0, this->m_http_keep_alive_close_all_cnt);
         ASSERT_EQ(1, this->m_events_history.size());
         ASSERT_EQ(EVENT_HISTORY_GW_STATUS_CLEAR_HTTP_RELAYING_CMD, this->m_events_history[0].event_type);
         this->m_events_history.clear();
+        this->m_http_keep_alive_close_all_cnt = 0;
     }
     {
         this->m_gw_status_is_relaying_via_http_enabled = false;
@@ -1447,9 +1502,11 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
         ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RELAYING_MODE_CHANGED, &adv_post_state));
         ASSERT_FALSE(adv_post_state.flag_stop);
         ASSERT_FALSE(adv_post_state.flag_relaying_enabled);
+        ASSERT_EQ(1, this->m_http_keep_alive_close_all_cnt);
         ASSERT_EQ(1, this->m_events_history.size());
         ASSERT_EQ(EVENT_HISTORY_GW_STATUS_CLEAR_HTTP_RELAYING_CMD, this->m_events_history[0].event_type);
         this->m_events_history.clear();
+        this->m_http_keep_alive_close_all_cnt = 0;
     }
     {
         this->m_gw_status_is_relaying_via_http_enabled = true;
@@ -1459,9 +1516,11 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
         ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RELAYING_MODE_CHANGED, &adv_post_state));
         ASSERT_FALSE(adv_post_state.flag_stop);
         ASSERT_TRUE(adv_post_state.flag_relaying_enabled);
+        ASSERT_EQ(0, this->m_http_keep_alive_close_all_cnt);
         ASSERT_EQ(1, this->m_events_history.size());
         ASSERT_EQ(EVENT_HISTORY_GW_STATUS_CLEAR_HTTP_RELAYING_CMD, this->m_events_history[0].event_type);
         this->m_events_history.clear();
+        this->m_http_keep_alive_close_all_cnt = 0;
     }
     {
         this->m_gw_status_is_relaying_via_http_enabled = false;
@@ -1471,6 +1530,7 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
         ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RELAYING_MODE_CHANGED, &adv_post_state));
         ASSERT_FALSE(adv_post_state.flag_stop);
         ASSERT_FALSE(adv_post_state.flag_relaying_enabled);
+        ASSERT_EQ(1, this->m_http_keep_alive_close_all_cnt);
         ASSERT_FALSE(adv_post_state.flag_async_comm_in_progress);
         ASSERT_EQ(4, this->m_events_history.size());
         ASSERT_EQ(EVENT_HISTORY_STOP_TIMER_SIG_DO_ASYNC_COMM, this->m_events_history[0].event_type);
@@ -1478,6 +1538,7 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_relaying_mode_changed) // NO
         ASSERT_EQ(EVENT_HISTORY_HTTP_SERVER_MUTEX_UNLOCK, this->m_events_history[2].event_type);
         ASSERT_EQ(EVENT_HISTORY_GW_STATUS_CLEAR_HTTP_RELAYING_CMD, this->m_events_history[3].event_type);
         this->m_events_history.clear();
+        this->m_http_keep_alive_close_all_cnt = 0;
     }
 
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
@@ -1489,16 +1550,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_network_watchdog) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     this->m_network_timeout_check_res = false;
@@ -1521,16 +1581,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_task_watchdog_feed) // NOLIN
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_TASK_WATCHDOG_FEED, &adv_post_state));
@@ -1547,16 +1606,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_gw_cfg_ready) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -1814,16 +1872,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_gw_cfg_changed_ruuvi) // NOL
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -2189,12 +2246,8 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_gw_cfg_changed_ruuvi) // NOL
         ASSERT_EQ(EVENT_HISTORY_HTTP_SERVER_MUTEX_DEACTIVATE, this->m_events_history[8].event_type);
         ASSERT_EQ(2, this->m_adv_post_cfg_cache.scan_filter_length);
         ASSERT_EQ(false, this->m_adv_post_cfg_cache.scan_filter_allow_listed);
-        ASSERT_EQ(
-            0,
-            memcmp(
-                this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac,
-                this->m_gw_cfg.ruuvi_cfg.scan_filter.scan_filter_list,
-                sizeof(mac_address_bin_t) * this->m_adv_post_cfg_cache.scan_filter_length));
+        ASSERT_EQ(0x111213141516ULL, this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac[0]);
+        ASSERT_EQ(0x111213141517ULL, this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac[1]);
         this->m_events_history.clear();
     }
     {
@@ -2225,12 +2278,7 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_gw_cfg_changed_ruuvi) // NOL
         ASSERT_EQ(EVENT_HISTORY_HTTP_SERVER_MUTEX_DEACTIVATE, this->m_events_history[8].event_type);
         ASSERT_EQ(1, this->m_adv_post_cfg_cache.scan_filter_length);
         ASSERT_EQ(true, this->m_adv_post_cfg_cache.scan_filter_allow_listed);
-        ASSERT_EQ(
-            0,
-            memcmp(
-                this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac,
-                this->m_gw_cfg.ruuvi_cfg.scan_filter.scan_filter_list,
-                sizeof(mac_address_bin_t) * this->m_adv_post_cfg_cache.scan_filter_length));
+        ASSERT_EQ(0x111213141518ULL, this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac[0]);
         this->m_events_history.clear();
     }
     {
@@ -2301,16 +2349,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_ble_scan_changed) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -2329,16 +2376,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_activate_cfg_mode) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -2381,12 +2427,8 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_activate_cfg_mode) // NOLINT
         ASSERT_EQ(EVENT_HISTORY_HTTP_SERVER_MUTEX_DEACTIVATE, this->m_events_history[8].event_type);
         ASSERT_EQ(2, this->m_adv_post_cfg_cache.scan_filter_length);
         ASSERT_EQ(false, this->m_adv_post_cfg_cache.scan_filter_allow_listed);
-        ASSERT_EQ(
-            0,
-            memcmp(
-                this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac,
-                this->m_gw_cfg.ruuvi_cfg.scan_filter.scan_filter_list,
-                sizeof(mac_address_bin_t) * this->m_adv_post_cfg_cache.scan_filter_length));
+        ASSERT_EQ(0x111213141516ULL, this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac[0]);
+        ASSERT_EQ(0x111213141517ULL, this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac[1]);
         this->m_events_history.clear();
     }
     {
@@ -2408,16 +2450,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_deactivate_cfg_mode) // NOLI
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -2536,12 +2577,8 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_deactivate_cfg_mode) // NOLI
         ASSERT_EQ(EVENT_HISTORY_START_TIMER_SIG_DO_ASYNC_COMM, this->m_events_history[8].event_type);
         ASSERT_EQ(2, this->m_adv_post_cfg_cache.scan_filter_length);
         ASSERT_EQ(false, this->m_adv_post_cfg_cache.scan_filter_allow_listed);
-        ASSERT_EQ(
-            0,
-            memcmp(
-                this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac,
-                this->m_gw_cfg.ruuvi_cfg.scan_filter.scan_filter_list,
-                sizeof(mac_address_bin_t) * this->m_adv_post_cfg_cache.scan_filter_length));
+        ASSERT_EQ(0x111213141516ULL, this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac[0]);
+        ASSERT_EQ(0x111213141517ULL, this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac[1]);
         this->m_events_history.clear();
     }
     {
@@ -2572,12 +2609,7 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_deactivate_cfg_mode) // NOLI
         ASSERT_EQ(EVENT_HISTORY_START_TIMER_SIG_DO_ASYNC_COMM, this->m_events_history[8].event_type);
         ASSERT_EQ(1, this->m_adv_post_cfg_cache.scan_filter_length);
         ASSERT_EQ(true, this->m_adv_post_cfg_cache.scan_filter_allow_listed);
-        ASSERT_EQ(
-            0,
-            memcmp(
-                this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac,
-                this->m_gw_cfg.ruuvi_cfg.scan_filter.scan_filter_list,
-                sizeof(mac_address_bin_t) * this->m_adv_post_cfg_cache.scan_filter_length));
+        ASSERT_EQ(0x111213141518ULL, this->m_adv_post_cfg_cache.p_arr_of_scan_filter_mac[0]);
         this->m_events_history.clear();
     }
     {
@@ -2647,16 +2679,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_green_led_turn_on) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -2677,16 +2708,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_green_led_turn_off) // NOLIN
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -2707,16 +2737,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_green_led_update) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -2736,16 +2765,15 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_recv_adv_timeout) // NOLINT
     this->m_events_history.clear();
 
     adv_post_state_t adv_post_state = {
-        .flag_primary_time_sync_is_done  = true,
-        .flag_network_connected          = true,
-        .flag_async_comm_in_progress     = false,
-        .flag_need_to_send_advs1         = false,
-        .flag_need_to_send_advs2         = false,
-        .flag_need_to_send_statistics    = false,
-        .flag_need_to_send_mqtt_periodic = false,
-        .flag_relaying_enabled           = true,
-        .flag_use_timestamps             = true,
-        .flag_stop                       = false,
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
     };
 
     {
@@ -2758,3 +2786,30 @@ TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_recv_adv_timeout) // NOLINT
     }
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
+
+TEST_F(TestAdvPostSignals, test_adv_post_handle_sig_recv_adv) // NOLINT
+{
+    adv_post_signals_init();
+    this->m_events_history.clear();
+
+    adv_post_state_t adv_post_state = {
+        .flag_primary_time_sync_is_done = true,
+        .flag_network_connected         = true,
+        .flag_async_comm_in_progress    = false,
+        .flag_need_to_send_advs1        = false,
+        .flag_need_to_send_advs2        = false,
+        .flag_need_to_send_statistics   = false,
+        .flag_relaying_enabled          = true,
+        .flag_use_timestamps            = true,
+        .flag_stop                      = false,
+    };
+
+    {
+        ASSERT_FALSE(adv_post_handle_sig(ADV_POST_SIG_RECV_ADV, &adv_post_state));
+        ASSERT_FALSE(adv_post_state.flag_stop);
+        ASSERT_EQ(1, this->m_events_history.size());
+        ASSERT_EQ(EVENT_HISTORY_ADV_POST_ON_RECV_ADVS, this->m_events_history[0].event_type);
+        this->m_events_history.clear();
+    }
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
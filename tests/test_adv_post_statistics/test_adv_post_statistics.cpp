@@ -115,6 +115,8 @@ public:
     bool                     m_http_post_stat_res {};
     adv_report_table_t       m_adv_report_table {};
 
+    http_async_info_t           m_http_async_info {};
+    http_async_info_t*          m_http_post_stat_arg_http_async_info;
     http_json_statistics_info_t m_http_post_stat_arg_stat_info;
     string                      m_http_post_stat_arg_stat_info_reset_info_str;
     adv_report_table_t          m_http_post_stat_arg_reports;
@@ -249,6 +251,7 @@ gw_cfg_get_http_stat_copy(void)
 
 bool
 http_post_stat(
+    http_async_info_t* const                 p_http_async_info,
     const http_json_statistics_info_t* const p_stat_info,
     const adv_report_table_t* const          p_reports,
     const ruuvi_gw_cfg_http_stat_t* const    p_cfg_http_stat,
@@ -256,6 +259,7 @@ http_post_stat(
     const bool                               use_ssl_client_cert,
     const bool                               use_ssl_server_cert)
 {
+    g_pTestClass->m_http_post_stat_arg_http_async_info          = p_http_async_info;
     g_pTestClass->m_http_post_stat_arg_stat_info                = *p_stat_info;
     g_pTestClass->m_http_post_stat_arg_stat_info_reset_info_str = string(p_stat_info->p_reset_info);
     g_pTestClass->m_http_post_stat_arg_reports                  = *p_reports;
@@ -539,7 +543,8 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send) // NOLINT
         };
         this->m_http_post_stat_res = true;
 
-        ASSERT_TRUE(adv_post_statistics_do_send());
+        ASSERT_TRUE(adv_post_statistics_do_send(&this->m_http_async_info));
+        ASSERT_EQ(&this->m_http_async_info, this->m_http_post_stat_arg_http_async_info);
 
         ASSERT_EQ(this->m_cfg_http_stat.use_http_stat, g_pTestClass->m_http_post_stat_arg_cfg_http_stat.use_http_stat);
         ASSERT_EQ(
@@ -619,7 +624,7 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send) // NOLINT
         };
         this->m_http_post_stat_res = true;
 
-        ASSERT_TRUE(adv_post_statistics_do_send());
+        ASSERT_TRUE(adv_post_statistics_do_send(&this->m_http_async_info));
 
         ASSERT_EQ(this->m_cfg_http_stat.use_http_stat, g_pTestClass->m_http_post_stat_arg_cfg_http_stat.use_http_stat);
         ASSERT_EQ(
@@ -728,7 +733,7 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send) // NOLINT
         };
         this->m_http_post_stat_res = true;
 
-        ASSERT_TRUE(adv_post_statistics_do_send());
+        ASSERT_TRUE(adv_post_statistics_do_send(&this->m_http_async_info));
 
         ASSERT_EQ(this->m_cfg_http_stat.use_http_stat, g_pTestClass->m_http_post_stat_arg_cfg_http_stat.use_http_stat);
         ASSERT_EQ(
@@ -856,7 +861,7 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send_malloc_failed_1) // NO
 
         this->m_malloc_fail_on_cnt = 1;
 
-        ASSERT_FALSE(adv_post_statistics_do_send());
+        ASSERT_FALSE(adv_post_statistics_do_send(&this->m_http_async_info));
 
         ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
     }
@@ -899,7 +904,7 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send_malloc_failed_2) // NO
 
         this->m_malloc_fail_on_cnt = 2;
 
-        ASSERT_FALSE(adv_post_statistics_do_send());
+        ASSERT_FALSE(adv_post_statistics_do_send(&this->m_http_async_info));
 
         ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
     }
@@ -942,7 +947,7 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send_malloc_failed_3) // NO
 
         this->m_malloc_fail_on_cnt = 3;
 
-        ASSERT_FALSE(adv_post_statistics_do_send());
+        ASSERT_FALSE(adv_post_statistics_do_send(&this->m_http_async_info));
 
         ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
     }
@@ -985,7 +990,7 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send_malloc_failed_4) // NO
 
         this->m_malloc_fail_on_cnt = 4;
 
-        ASSERT_FALSE(adv_post_statistics_do_send());
+        ASSERT_FALSE(adv_post_statistics_do_send(&this->m_http_async_info));
 
         ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
     }
@@ -1028,7 +1033,7 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send_malloc_failed_5_succes
 
         this->m_malloc_fail_on_cnt = 5;
 
-        ASSERT_TRUE(adv_post_statistics_do_send());
+        ASSERT_TRUE(adv_post_statistics_do_send(&this->m_http_async_info));
 
         ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
     }
@@ -1070,7 +1075,7 @@ TEST_F(TestAdvPostStatistics, adv_post_statistics_do_send_http_post_stat_failed)
 
         this->m_http_post_stat_res = false;
 
-        ASSERT_FALSE(adv_post_statistics_do_send());
+        ASSERT_FALSE(adv_post_statistics_do_send(&this->m_http_async_info));
 
         ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
     }
@@ -0,0 +1,279 @@
+/**
+ * @file test_adv_ring.cpp
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "adv_ring.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/*** Google-test class implementation
+ * *********************************************************************************/
+
+class TestAdvRing : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        adv_ring_init();
+    }
+
+    void
+    TearDown() override
+    {
+    }
+
+public:
+    TestAdvRing();
+
+    ~TestAdvRing() override;
+};
+
+TestAdvRing::TestAdvRing()
+    : Test()
+{
+}
+
+TestAdvRing::~TestAdvRing() = default;
+
+static adv_report_t
+make_adv(const uint32_t seq_num)
+{
+    adv_report_t adv = {
+        .timestamp = static_cast<time_t>(seq_num),
+        .tag_mac   = { 0xAAU, 0xBBU, 0xCCU, 0xDDU, 0xEEU, static_cast<uint8_t>(seq_num & 0xFFU) },
+        .rssi      = -50,
+        .data_len  = 2,
+        .data_buf  = { 0xA0U, static_cast<uint8_t>(seq_num & 0xFFU) },
+    };
+    return adv;
+}
+
+/*** Unit-Tests
+ * *******************************************************************************************************/
+
+TEST_F(TestAdvRing, test_empty) // NOLINT
+{
+    adv_report_t arr_of_advs[ADV_RING_SIZE] = {};
+    ASSERT_EQ(0, adv_ring_pop_batch(arr_of_advs, ADV_RING_SIZE));
+    ASSERT_EQ(0, adv_ring_get_high_water_mark());
+    ASSERT_EQ(0, adv_ring_get_overflow_cnt());
+}
+
+TEST_F(TestAdvRing, test_push_pop) // NOLINT
+{
+    bool flag_notify_consumer = false;
+
+    const adv_report_t adv1 = make_adv(1);
+    ASSERT_TRUE(adv_ring_push(&adv1, &flag_notify_consumer));
+    ASSERT_TRUE(flag_notify_consumer);
+
+    // The consumer has not yet acknowledged the notification, so there is no need to notify it again.
+    const adv_report_t adv2 = make_adv(2);
+    ASSERT_TRUE(adv_ring_push(&adv2, &flag_notify_consumer));
+    ASSERT_FALSE(flag_notify_consumer);
+
+    adv_ring_on_consumer_wakeup();
+
+    adv_report_t arr_of_advs[ADV_RING_SIZE] = {};
+    ASSERT_EQ(2, adv_ring_pop_batch(arr_of_advs, ADV_RING_SIZE));
+    ASSERT_EQ(1, arr_of_advs[0].timestamp);
+    ASSERT_EQ(2, arr_of_advs[1].timestamp);
+    ASSERT_EQ(0, adv_ring_pop_batch(arr_of_advs, ADV_RING_SIZE));
+
+    const adv_report_t adv3 = make_adv(3);
+    ASSERT_TRUE(adv_ring_push(&adv3, &flag_notify_consumer));
+    ASSERT_TRUE(flag_notify_consumer);
+
+    ASSERT_EQ(2, adv_ring_get_high_water_mark());
+    ASSERT_EQ(0, adv_ring_get_overflow_cnt());
+}
+
+TEST_F(TestAdvRing, test_pop_batch_limited_by_max_num) // NOLINT
+{
+    bool flag_notify_consumer = false;
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        const adv_report_t adv = make_adv(i);
+        ASSERT_TRUE(adv_ring_push(&adv, &flag_notify_consumer));
+    }
+    adv_report_t arr_of_advs[2] = {};
+    ASSERT_EQ(2, adv_ring_pop_batch(arr_of_advs, 2));
+    ASSERT_EQ(0, arr_of_advs[0].timestamp);
+    ASSERT_EQ(1, arr_of_advs[1].timestamp);
+    ASSERT_EQ(2, adv_ring_pop_batch(arr_of_advs, 2));
+    ASSERT_EQ(2, arr_of_advs[0].timestamp);
+    ASSERT_EQ(3, arr_of_advs[1].timestamp);
+    ASSERT_EQ(1, adv_ring_pop_batch(arr_of_advs, 2));
+    ASSERT_EQ(4, arr_of_advs[0].timestamp);
+    ASSERT_EQ(0, adv_ring_pop_batch(arr_of_advs, 2));
+    ASSERT_EQ(5, adv_ring_get_high_water_mark());
+}
+
+TEST_F(TestAdvRing, test_overflow) // NOLINT
+{
+    bool flag_notify_consumer = false;
+    for (uint32_t i = 0; i < ADV_RING_SIZE; ++i)
+    {
+        const adv_report_t adv = make_adv(i);
+        ASSERT_TRUE(adv_ring_push(&adv, &flag_notify_consumer));
+    }
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        const adv_report_t adv = make_adv(ADV_RING_SIZE + i);
+        ASSERT_FALSE(adv_ring_push(&adv, &flag_notify_consumer));
+        ASSERT_FALSE(flag_notify_consumer);
+    }
+    ASSERT_EQ(ADV_RING_SIZE, adv_ring_get_high_water_mark());
+    ASSERT_EQ(3, adv_ring_get_overflow_cnt());
+
+    adv_report_t arr_of_advs[ADV_RING_SIZE + 1] = {};
+    ASSERT_EQ(ADV_RING_SIZE, adv_ring_pop_batch(arr_of_advs, ADV_RING_SIZE + 1));
+    for (uint32_t i = 0; i < ADV_RING_SIZE; ++i)
+    {
+        ASSERT_EQ(i, arr_of_advs[i].timestamp);
+    }
+
+    adv_ring_init();
+    ASSERT_EQ(0, adv_ring_get_high_water_mark());
+    ASSERT_EQ(0, adv_ring_get_overflow_cnt());
+}
+
+TEST_F(TestAdvRing, test_overflow_while_consumer_is_busy) // NOLINT
+{
+    // The consumer is busy (e.g. generating HTTP POST) and doesn't drain the ring twice,
+    // the dropped advertisements are counted for every such period.
+    const uint32_t num_of_advs_while_consumer_busy = ADV_RING_SIZE + 5;
+    bool           flag_notify_consumer            = false;
+    adv_report_t   arr_of_advs[ADV_RING_SIZE]      = {};
+    uint32_t       seq_num                         = 0;
+    uint32_t       exp_overflow_cnt                = 0;
+    for (uint32_t period = 0; period < 2; ++period)
+    {
+        for (uint32_t i = 0; i < num_of_advs_while_consumer_busy; ++i)
+        {
+            const adv_report_t adv = make_adv(seq_num);
+            seq_num += 1;
+            const bool flag_pushed = adv_ring_push(&adv, &flag_notify_consumer);
+            ASSERT_EQ(i < ADV_RING_SIZE, flag_pushed);
+            ASSERT_EQ(0 == i, flag_notify_consumer);
+        }
+        exp_overflow_cnt += num_of_advs_while_consumer_busy - ADV_RING_SIZE;
+        ASSERT_EQ(exp_overflow_cnt, adv_ring_get_overflow_cnt());
+
+        adv_ring_on_consumer_wakeup();
+        ASSERT_EQ(ADV_RING_SIZE, adv_ring_pop_batch(arr_of_advs, ADV_RING_SIZE));
+        const uint32_t first_seq_num = seq_num - num_of_advs_while_consumer_busy;
+        ASSERT_EQ(first_seq_num, arr_of_advs[0].timestamp);
+        ASSERT_EQ(first_seq_num + ADV_RING_SIZE - 1, arr_of_advs[ADV_RING_SIZE - 1].timestamp);
+    }
+    ASSERT_EQ(ADV_RING_SIZE, adv_ring_get_high_water_mark());
+
+    // The overflow counter is not changed when there is free space in the ring
+    const adv_report_t adv = make_adv(seq_num);
+    ASSERT_TRUE(adv_ring_push(&adv, &flag_notify_consumer));
+    ASSERT_TRUE(flag_notify_consumer);
+    ASSERT_EQ(exp_overflow_cnt, adv_ring_get_overflow_cnt());
+}
+
+TEST_F(TestAdvRing, test_wrap_around) // NOLINT
+{
+    bool         flag_notify_consumer = false;
+    adv_report_t arr_of_advs[3]       = {};
+    uint32_t     seq_num_pushed       = 0;
+    uint32_t     seq_num_popped       = 0;
+    for (uint32_t i = 0; i < (ADV_RING_SIZE * 5); ++i)
+    {
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            const adv_report_t adv = make_adv(seq_num_pushed);
+            ASSERT_TRUE(adv_ring_push(&adv, &flag_notify_consumer));
+            seq_num_pushed += 1;
+        }
+        ASSERT_EQ(3, adv_ring_pop_batch(arr_of_advs, 3));
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            ASSERT_EQ(seq_num_popped, arr_of_advs[j].timestamp);
+            ASSERT_EQ(seq_num_popped & 0xFFU, arr_of_advs[j].data_buf[1]);
+            seq_num_popped += 1;
+        }
+    }
+    ASSERT_EQ(3, adv_ring_get_high_water_mark());
+    ASSERT_EQ(0, adv_ring_get_overflow_cnt());
+}
+
+TEST_F(TestAdvRing, test_producer_and_consumer_in_separate_threads) // NOLINT
+{
+    const uint32_t num_of_advs = 200000;
+
+    // The producer counts the notifications, the consumer drains the ring only after a notification
+    // (like adv_post_task), so every pushed advertisement must be either popped or counted as dropped.
+    std::atomic<uint32_t> num_notifications { 0 };
+    std::atomic<bool>     flag_producer_finished { false };
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < num_of_advs; ++i)
+        {
+            const adv_report_t adv                  = make_adv(i);
+            bool               flag_notify_consumer = false;
+            if (adv_ring_push(&adv, &flag_notify_consumer) && flag_notify_consumer)
+            {
+                num_notifications.fetch_add(1);
+            }
+        }
+        flag_producer_finished.store(true);
+    });
+
+    uint32_t     num_of_popped     = 0;
+    uint32_t     num_of_handled    = 0;
+    time_t       prev_timestamp    = -1;
+    adv_report_t arr_of_advs[5]    = {};
+    bool         flag_out_of_order = false;
+    while (true)
+    {
+        const bool flag_finished = flag_producer_finished.load();
+        if (num_of_handled == num_notifications.load())
+        {
+            if (flag_finished)
+            {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        num_of_handled += 1;
+        adv_ring_on_consumer_wakeup();
+        for (;;)
+        {
+            const uint32_t num = adv_ring_pop_batch(arr_of_advs, sizeof(arr_of_advs) / sizeof(arr_of_advs[0]));
+            if (0 == num)
+            {
+                break;
+            }
+            for (uint32_t i = 0; i < num; ++i)
+            {
+                if (arr_of_advs[i].timestamp <= prev_timestamp)
+                {
+                    flag_out_of_order = true;
+                }
+                prev_timestamp = arr_of_advs[i].timestamp;
+            }
+            num_of_popped += num;
+        }
+    }
+    producer.join();
+
+    ASSERT_FALSE(flag_out_of_order);
+    ASSERT_EQ(num_of_advs, num_of_popped + adv_ring_get_overflow_cnt());
+    ASSERT_LE(adv_ring_get_high_water_mark(), ADV_RING_SIZE);
+    adv_report_t adv = {};
+    ASSERT_EQ(0, adv_ring_pop_batch(&adv, 1));
+}
@@ -0,0 +1,572 @@
+/**
+ * @file test_adv_spool.cpp
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "adv_spool.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "esp_partition.h"
+#include "os_malloc.h"
+#include "os_mutex.h"
+
+using namespace std;
+
+#define TEST_SECTOR_SIZE (4096U)
+
+class TestAdvSpool;
+
+static TestAdvSpool* g_pTestClass;
+
+/*** Google-test class implementation
+ * *********************************************************************************/
+
+class TestAdvSpool : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        this->m_malloc_cnt           = 0;
+        this->m_malloc_fail_on_cnt   = 0;
+        this->m_num_allocated        = 0;
+        this->m_flag_partition_found = true;
+        this->m_num_erases           = 0;
+        this->m_rec_id               = {};
+        this->m_partition            = {};
+        this->m_partition.type       = ESP_PARTITION_TYPE_DATA;
+        this->m_partition.address    = 0;
+        this->m_partition.size       = 16 * TEST_SECTOR_SIZE;
+        snprintf(this->m_partition.label, sizeof(this->m_partition.label), "%s", ADV_SPOOL_PARTITION_LABEL);
+        // The partition is backed by a temporary file to check that the spool survives a reboot.
+        this->m_p_file = tmpfile();
+        ASSERT_NE(nullptr, this->m_p_file);
+        const vector<uint8_t> erased(this->m_partition.size, 0xFFU);
+        ASSERT_EQ(erased.size(), fwrite(erased.data(), 1, erased.size(), this->m_p_file));
+        g_pTestClass = this;
+    }
+
+    void
+    TearDown() override
+    {
+        adv_spool_deinit();
+        fclose(this->m_p_file);
+        this->m_p_file = nullptr;
+        g_pTestClass   = nullptr;
+    }
+
+public:
+    TestAdvSpool();
+
+    ~TestAdvSpool() override;
+
+    void
+    set_partition_size(const uint32_t size)
+    {
+        this->m_partition.size = size;
+        ASSERT_EQ(0, fseek(this->m_p_file, 0, SEEK_SET));
+        const vector<uint8_t> erased(size, 0xFFU);
+        ASSERT_EQ(erased.size(), fwrite(erased.data(), 1, erased.size(), this->m_p_file));
+    }
+
+    void
+    file_read(const size_t offset, void* const p_buf, const size_t size) const
+    {
+        ASSERT_EQ(0, fseek(this->m_p_file, (long)offset, SEEK_SET));
+        ASSERT_EQ(size, fread(p_buf, 1, size, this->m_p_file));
+    }
+
+    void
+    file_write(const size_t offset, const void* const p_buf, const size_t size) const
+    {
+        ASSERT_EQ(0, fseek(this->m_p_file, (long)offset, SEEK_SET));
+        ASSERT_EQ(size, fwrite(p_buf, 1, size, this->m_p_file));
+    }
+
+    uint32_t           m_malloc_cnt {};
+    uint32_t           m_malloc_fail_on_cnt {};
+    uint32_t           m_num_allocated {};
+    bool               m_flag_partition_found {};
+    uint32_t           m_num_erases {};
+    adv_spool_rec_id_t m_rec_id {}; //<! Identifier of the last record read by CHECK_READ
+    esp_partition_t    m_partition {};
+    FILE*              m_p_file {};
+};
+
+TestAdvSpool::TestAdvSpool()
+    : Test()
+{
+}
+
+TestAdvSpool::~TestAdvSpool() = default;
+
+extern "C" {
+
+void*
+os_malloc(const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    g_pTestClass->m_num_allocated += 1;
+    return malloc(size);
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    assert(nullptr != g_pTestClass);
+    assert(0 != g_pTestClass->m_num_allocated);
+    g_pTestClass->m_num_allocated -= 1;
+    free(p_mem);
+}
+
+os_mutex_t
+os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
+{
+    return reinterpret_cast<os_mutex_t>(p_mutex_static);
+}
+
+void
+os_mutex_lock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
+void
+os_mutex_unlock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
+const esp_partition_t*
+esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label)
+{
+    assert(nullptr != g_pTestClass);
+    if ((!g_pTestClass->m_flag_partition_found) || (ESP_PARTITION_TYPE_DATA != type)
+        || (ESP_PARTITION_SUBTYPE_ANY != subtype) || (0 != strcmp(ADV_SPOOL_PARTITION_LABEL, label)))
+    {
+        return nullptr;
+    }
+    return &g_pTestClass->m_partition;
+}
+
+esp_err_t
+esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    assert(&g_pTestClass->m_partition == partition);
+    if ((src_offset + size) > partition->size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    g_pTestClass->file_read(src_offset, dst, size);
+    return ESP_OK;
+}
+
+esp_err_t
+esp_partition_write(const esp_partition_t* partition, size_t dst_offset, const void* src, size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    assert(&g_pTestClass->m_partition == partition);
+    if ((dst_offset + size) > partition->size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // NOR flash can only clear bits, so emulate it to check that the spool never rewrites programmed bits.
+    vector<uint8_t> buf(size);
+    g_pTestClass->file_read(dst_offset, buf.data(), size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        const uint8_t new_val = static_cast<const uint8_t*>(src)[i];
+        assert(new_val == (buf[i] & new_val));
+        buf[i] &= new_val;
+    }
+    g_pTestClass->file_write(dst_offset, buf.data(), size);
+    return ESP_OK;
+}
+
+esp_err_t
+esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    assert(&g_pTestClass->m_partition == partition);
+    if (((offset % TEST_SECTOR_SIZE) != 0) || ((size % TEST_SECTOR_SIZE) != 0) || ((offset + size) > partition->size))
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    g_pTestClass->m_num_erases += 1;
+    const vector<uint8_t> erased(size, 0xFFU);
+    g_pTestClass->file_write(offset, erased.data(), size);
+    return ESP_OK;
+}
+
+} // extern "C"
+
+static adv_report_t
+gen_adv(const uint32_t idx, const uint8_t data_len)
+{
+    adv_report_t adv = {
+        .timestamp       = (time_t)(1612358929 + idx),
+        .samples_counter = idx * 3U,
+        .tag_mac         = { 0xaa, 0xbb, 0xcc, 0x01, (uint8_t)(idx >> 8U), (uint8_t)idx },
+        .rssi            = (wifi_rssi_t)(-40 - (int)(idx % 50U)),
+        .primary_phy     = 1,
+        .secondary_phy   = (uint8_t)(idx % 3U),
+        .ch_index        = (uint8_t)(idx % 40U),
+        .is_coded_phy    = (0 != (idx % 2U)),
+        .tx_power        = (int8_t)(idx % 20U),
+        .data_len        = data_len,
+    };
+    for (uint32_t i = 0; i < data_len; ++i)
+    {
+        adv.data_buf[i] = (uint8_t)(idx + i);
+    }
+    return adv;
+}
+
+static vector<adv_report_t>
+gen_advs(const uint32_t first_idx, const uint32_t num, const uint8_t data_len = 24)
+{
+    vector<adv_report_t> advs;
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        advs.push_back(gen_adv(first_idx + i, data_len));
+    }
+    return advs;
+}
+
+#define CHECK_ADV(adv_exp_, adv_) \
+    do \
+    { \
+        ASSERT_EQ((adv_exp_).timestamp, (adv_).timestamp); \
+        ASSERT_EQ((adv_exp_).samples_counter, (adv_).samples_counter); \
+        ASSERT_EQ(0, memcmp(&(adv_exp_).tag_mac, &(adv_).tag_mac, sizeof((adv_).tag_mac))); \
+        ASSERT_EQ((adv_exp_).rssi, (adv_).rssi); \
+        ASSERT_EQ((adv_exp_).primary_phy, (adv_).primary_phy); \
+        ASSERT_EQ((adv_exp_).secondary_phy, (adv_).secondary_phy); \
+        ASSERT_EQ((adv_exp_).ch_index, (adv_).ch_index); \
+        ASSERT_EQ((adv_exp_).is_coded_phy, (adv_).is_coded_phy); \
+        ASSERT_EQ((adv_exp_).tx_power, (adv_).tx_power); \
+        ASSERT_EQ((adv_exp_).data_len, (adv_).data_len); \
+        ASSERT_EQ(0, memcmp((adv_exp_).data_buf, (adv_).data_buf, (adv_).data_len)); \
+    } while (0)
+
+#define CHECK_READ(target_exp_, advs_exp_, first_, num_) \
+    do \
+    { \
+        adv_report_t       arr_[ADV_SPOOL_MAX_ADVS_PER_RECORD] = {}; \
+        adv_spool_target_e target_                             = ADV_SPOOL_TARGET_HTTP_RUUVI; \
+        ASSERT_EQ(num_, adv_spool_read(&target_, arr_, &this->m_rec_id)); \
+        ASSERT_EQ(target_exp_, target_); \
+        for (uint32_t i_ = 0; i_ < (num_); ++i_) \
+        { \
+            CHECK_ADV((advs_exp_)[(first_) + i_], arr_[i_]); \
+        } \
+    } while (0)
+
+/*** Unit-Tests
+ * *******************************************************************************************************/
+
+TEST_F(TestAdvSpool, test_partition_not_found) // NOLINT
+{
+    this->m_flag_partition_found = false;
+    ASSERT_FALSE(adv_spool_init());
+    ASSERT_FALSE(adv_spool_is_enabled());
+    ASSERT_TRUE(adv_spool_is_empty());
+
+    const vector<adv_report_t> advs = gen_advs(0, 1);
+    ASSERT_FALSE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, advs.data(), advs.size()));
+
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(0, stat.size_bytes);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvSpool, test_partition_too_small) // NOLINT
+{
+    this->set_partition_size(TEST_SECTOR_SIZE);
+    ASSERT_FALSE(adv_spool_init());
+    ASSERT_FALSE(adv_spool_is_enabled());
+}
+
+TEST_F(TestAdvSpool, test_format_empty_partition) // NOLINT
+{
+    ASSERT_TRUE(adv_spool_init());
+    ASSERT_TRUE(adv_spool_is_enabled());
+    ASSERT_TRUE(adv_spool_is_empty());
+    ASSERT_EQ(1, this->m_num_erases);
+
+    adv_report_t       arr[ADV_SPOOL_MAX_ADVS_PER_RECORD] = {};
+    adv_spool_target_e target                             = ADV_SPOOL_TARGET_HTTP_RUUVI;
+    ASSERT_EQ(0, adv_spool_read(&target, arr, &this->m_rec_id));
+    ASSERT_EQ(0, this->m_rec_id.seq_num);
+
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(16 * TEST_SECTOR_SIZE, stat.size_bytes);
+    ASSERT_EQ(0, stat.used_bytes);
+    ASSERT_EQ(0, stat.num_stored_advs);
+
+    // The formatted partition is mounted without erasing
+    adv_spool_deinit();
+    ASSERT_TRUE(adv_spool_init());
+    ASSERT_TRUE(adv_spool_is_empty());
+    ASSERT_EQ(1, this->m_num_erases);
+}
+
+TEST_F(TestAdvSpool, test_append_read_consume) // NOLINT
+{
+    ASSERT_TRUE(adv_spool_init());
+
+    vector<adv_report_t> advs = gen_advs(0, 3);
+    advs[1].data_len          = 0;
+    advs[2]                   = gen_adv(2, ADV_DATA_MAX_LEN);
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_CUSTOM, advs.data(), advs.size()));
+    ASSERT_FALSE(adv_spool_is_empty());
+
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_CUSTOM, advs, 0, 3);
+    // The result does not change until the record is consumed
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_CUSTOM, advs, 0, 3);
+
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(3, stat.num_stored_advs);
+    ASSERT_EQ(0, stat.num_sent_advs);
+    ASSERT_GT(stat.used_bytes, 0);
+
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    ASSERT_TRUE(adv_spool_is_empty());
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(3, stat.num_sent_advs);
+    ASSERT_EQ(0, stat.used_bytes);
+    ASSERT_EQ(0, stat.num_dropped_advs);
+
+    // Consuming an empty spool or the same record twice does nothing
+    ASSERT_FALSE(adv_spool_consume(&this->m_rec_id, true));
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(3, stat.num_sent_advs);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvSpool, test_discard_record) // NOLINT
+{
+    ASSERT_TRUE(adv_spool_init());
+
+    const vector<adv_report_t> advs = gen_advs(0, 5);
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_CUSTOM, advs.data(), advs.size()));
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_CUSTOM, advs, 0, 5);
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, false));
+    ASSERT_TRUE(adv_spool_is_empty());
+
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(5, stat.num_stored_advs);
+    ASSERT_EQ(0, stat.num_sent_advs);
+    ASSERT_EQ(5, stat.num_dropped_advs);
+}
+
+TEST_F(TestAdvSpool, test_split_batch_into_records) // NOLINT
+{
+    ASSERT_TRUE(adv_spool_init());
+
+    const vector<adv_report_t> advs = gen_advs(0, 100);
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, advs.data(), advs.size()));
+
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 0, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, ADV_SPOOL_MAX_ADVS_PER_RECORD, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 2 * ADV_SPOOL_MAX_ADVS_PER_RECORD, 4);
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    ASSERT_TRUE(adv_spool_is_empty());
+}
+
+TEST_F(TestAdvSpool, test_persistence_after_reboot) // NOLINT
+{
+    ASSERT_TRUE(adv_spool_init());
+
+    const vector<adv_report_t> advs = gen_advs(0, 30);
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, &advs[0], 10));
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_CUSTOM, &advs[10], 10));
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 0, 10);
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+
+    // The consumed record is not returned after reboot
+    adv_spool_deinit();
+    ASSERT_FALSE(adv_spool_is_enabled());
+    ASSERT_TRUE(adv_spool_init());
+    ASSERT_FALSE(adv_spool_is_empty());
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_CUSTOM, advs, 10, 10);
+
+    // New records are appended after the existing ones
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, &advs[20], 10));
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 20, 10);
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    ASSERT_TRUE(adv_spool_is_empty());
+
+    adv_spool_deinit();
+    ASSERT_TRUE(adv_spool_init());
+    ASSERT_TRUE(adv_spool_is_empty());
+}
+
+TEST_F(TestAdvSpool, test_records_in_several_sectors) // NOLINT
+{
+    ASSERT_TRUE(adv_spool_init());
+
+    // Every record of 48 advs with 24 bytes of data takes more than a half of the sector
+    const vector<adv_report_t> advs = gen_advs(0, 5 * ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, advs.data(), advs.size()));
+    ASSERT_EQ(5, this->m_num_erases);
+
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_GT(stat.used_bytes, 4 * TEST_SECTOR_SIZE);
+    ASSERT_LT(stat.used_bytes, 5 * TEST_SECTOR_SIZE);
+
+    adv_spool_deinit();
+    ASSERT_TRUE(adv_spool_init());
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, i * ADV_SPOOL_MAX_ADVS_PER_RECORD, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+        ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    }
+    ASSERT_TRUE(adv_spool_is_empty());
+}
+
+TEST_F(TestAdvSpool, test_wrap_around_drops_oldest_sector) // NOLINT
+{
+    this->set_partition_size(4 * TEST_SECTOR_SIZE);
+    ASSERT_TRUE(adv_spool_init());
+
+    const vector<adv_report_t> advs = gen_advs(0, 6 * ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, advs.data(), advs.size()));
+
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(6 * ADV_SPOOL_MAX_ADVS_PER_RECORD, stat.num_stored_advs);
+    ASSERT_EQ(2 * ADV_SPOOL_MAX_ADVS_PER_RECORD, stat.num_dropped_advs);
+
+    // The ring is restored by the sequence numbers of the sectors after reboot
+    adv_spool_deinit();
+    ASSERT_TRUE(adv_spool_init());
+    for (uint32_t i = 2; i < 6; ++i)
+    {
+        CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, i * ADV_SPOOL_MAX_ADVS_PER_RECORD, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+        ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    }
+    ASSERT_TRUE(adv_spool_is_empty());
+}
+
+TEST_F(TestAdvSpool, test_consumed_sectors_are_reused_without_drops) // NOLINT
+{
+    this->set_partition_size(3 * TEST_SECTOR_SIZE);
+    ASSERT_TRUE(adv_spool_init());
+
+    const vector<adv_report_t> advs = gen_advs(0, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_CUSTOM, advs.data(), advs.size()));
+        CHECK_READ(ADV_SPOOL_TARGET_HTTP_CUSTOM, advs, 0, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+        ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+        ASSERT_TRUE(adv_spool_is_empty());
+    }
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(0, stat.num_dropped_advs);
+    ASSERT_EQ(10 * ADV_SPOOL_MAX_ADVS_PER_RECORD, stat.num_sent_advs);
+
+    adv_spool_deinit();
+    ASSERT_TRUE(adv_spool_init());
+    ASSERT_TRUE(adv_spool_is_empty());
+}
+
+TEST_F(TestAdvSpool, test_stale_ack_is_ignored) // NOLINT
+{
+    this->set_partition_size(4 * TEST_SECTOR_SIZE);
+    ASSERT_TRUE(adv_spool_init());
+
+    // Every record takes its own sector
+    const vector<adv_report_t> advs = gen_advs(0, 8 * ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, &advs[0], ADV_SPOOL_MAX_ADVS_PER_RECORD));
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 0, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    const adv_spool_rec_id_t rec_id_stale = this->m_rec_id;
+
+    // While the record is being sent, the spool overflows and the ring wraps around, so that the oldest record
+    // is now at the same position in the same sector, but the sector has been rewritten.
+    ASSERT_TRUE(adv_spool_append(
+        ADV_SPOOL_TARGET_HTTP_RUUVI,
+        &advs[ADV_SPOOL_MAX_ADVS_PER_RECORD],
+        7 * ADV_SPOOL_MAX_ADVS_PER_RECORD));
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(4 * ADV_SPOOL_MAX_ADVS_PER_RECORD, stat.num_dropped_advs);
+
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 4 * ADV_SPOOL_MAX_ADVS_PER_RECORD, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+    ASSERT_EQ(rec_id_stale.offset, this->m_rec_id.offset);
+    ASSERT_NE(rec_id_stale.seq_num, this->m_rec_id.seq_num);
+
+    // The ack of the dropped record does not consume the oldest one
+    ASSERT_FALSE(adv_spool_consume(&rec_id_stale, true));
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(0, stat.num_sent_advs);
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 4 * ADV_SPOOL_MAX_ADVS_PER_RECORD, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+
+    for (uint32_t i = 4; i < 8; ++i)
+    {
+        CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, i * ADV_SPOOL_MAX_ADVS_PER_RECORD, ADV_SPOOL_MAX_ADVS_PER_RECORD);
+        ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    }
+    ASSERT_TRUE(adv_spool_is_empty());
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(4 * ADV_SPOOL_MAX_ADVS_PER_RECORD, stat.num_sent_advs);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvSpool, test_corrupted_record_is_dropped) // NOLINT
+{
+    ASSERT_TRUE(adv_spool_init());
+
+    const vector<adv_report_t> advs = gen_advs(0, 20);
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, &advs[0], 10));
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, &advs[10], 10));
+
+    // Damage the payload of the first record: sector header (12 bytes) + record header (12 bytes) + offset
+    const uint8_t zero = 0;
+    this->file_write(12 + 12 + 0, &zero, sizeof(zero));
+
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 10, 10);
+    adv_spool_stat_t stat = {};
+    adv_spool_get_stat(&stat);
+    ASSERT_EQ(10, stat.num_dropped_advs);
+    ASSERT_TRUE(adv_spool_consume(&this->m_rec_id, true));
+    ASSERT_TRUE(adv_spool_is_empty());
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvSpool, test_malloc_failed) // NOLINT
+{
+    ASSERT_TRUE(adv_spool_init());
+
+    const vector<adv_report_t> advs = gen_advs(0, 10);
+    this->m_malloc_fail_on_cnt      = this->m_malloc_cnt + 1;
+    ASSERT_FALSE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, advs.data(), advs.size()));
+    ASSERT_TRUE(adv_spool_is_empty());
+
+    ASSERT_TRUE(adv_spool_append(ADV_SPOOL_TARGET_HTTP_RUUVI, advs.data(), advs.size()));
+    adv_report_t       arr[ADV_SPOOL_MAX_ADVS_PER_RECORD] = {};
+    adv_spool_target_e target                             = ADV_SPOOL_TARGET_HTTP_RUUVI;
+    this->m_malloc_fail_on_cnt                            = this->m_malloc_cnt + 1;
+    ASSERT_EQ(0, adv_spool_read(&target, arr, &this->m_rec_id));
+    CHECK_READ(ADV_SPOOL_TARGET_HTTP_RUUVI, advs, 0, 10);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
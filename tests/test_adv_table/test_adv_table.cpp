@@ -8,13 +8,64 @@
 #include "adv_table.h"
 #include "gtest/gtest.h"
 #include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
 #include "os_mutex.h"
+#include "os_malloc.h"
 
 using namespace std;
 
 /*** Google-test class implementation
  * *********************************************************************************/
 
+class TestAdvTable;
+static TestAdvTable* g_pTestClass;
+
+class MemAllocTrace
+{
+    vector<void*> allocated_mem;
+
+    std::vector<void*>::iterator
+    find(void* p_mem)
+    {
+        for (auto iter = this->allocated_mem.begin(); iter != this->allocated_mem.end(); ++iter)
+        {
+            if (*iter == p_mem)
+            {
+                return iter;
+            }
+        }
+        return this->allocated_mem.end();
+    }
+
+public:
+    void
+    add(void* p_mem)
+    {
+        auto iter = find(p_mem);
+        assert(iter == this->allocated_mem.end()); // p_mem was found in the list of allocated memory blocks
+        this->allocated_mem.push_back(p_mem);
+    }
+    void
+    remove(void* p_mem)
+    {
+        auto iter = find(p_mem);
+        assert(iter != this->allocated_mem.end()); // p_mem was not found in the list of allocated memory blocks
+        this->allocated_mem.erase(iter);
+    }
+    bool
+    is_empty()
+    {
+        return this->allocated_mem.empty();
+    }
+    size_t
+    size()
+    {
+        return this->allocated_mem.size();
+    }
+};
+
 class TestAdvTable : public ::testing::Test
 {
 private:
@@ -22,6 +73,9 @@ protected:
     void
     SetUp() override
     {
+        g_pTestClass               = this;
+        this->m_malloc_cnt         = 0;
+        this->m_malloc_fail_on_cnt = 0;
         adv_table_init();
     }
 
@@ -29,12 +83,18 @@ protected:
     TearDown() override
     {
         adv_table_deinit();
+        ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+        g_pTestClass = nullptr;
     }
 
 public:
     TestAdvTable();
 
     ~TestAdvTable() override;
+
+    MemAllocTrace m_mem_alloc_trace;
+    uint32_t      m_malloc_cnt {};
+    uint32_t      m_malloc_fail_on_cnt {};
 };
 
 TestAdvTable::TestAdvTable()
@@ -46,6 +106,42 @@ TestAdvTable::~TestAdvTable() = default;
 
 extern "C" {
 
+void*
+os_malloc(const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    void* p_mem = malloc(size);
+    assert(nullptr != p_mem);
+    g_pTestClass->m_mem_alloc_trace.add(p_mem);
+    return p_mem;
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    assert(nullptr != g_pTestClass);
+    g_pTestClass->m_mem_alloc_trace.remove(p_mem);
+    free(p_mem);
+}
+
+void*
+os_calloc(const size_t nmemb, const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    void* p_mem = calloc(nmemb, size);
+    assert(nullptr != p_mem);
+    g_pTestClass->m_mem_alloc_trace.add(p_mem);
+    return p_mem;
+}
+
 os_mutex_t
 os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
 {
@@ -78,12 +174,12 @@ os_mutex_unlock(os_mutex_t const h_mutex)
     auto               data_var_name_ = make_array<uint8_t>(__VA_ARGS__); \
     const adv_report_t adv_var_name_  = { \
          .timestamp = timestamp_, \
-         .tag_mac   = { ((mac_addr_) >> 5U * 8U) & 0xFFU, \
-                        ((mac_addr_) >> 4U * 8U) & 0xFFU, \
-                        ((mac_addr_) >> 3U * 8U) & 0xFFU, \
-                        ((mac_addr_) >> 2U * 8U) & 0xFFU, \
-                        ((mac_addr_) >> 1U * 8U) & 0xFFU, \
-                        ((mac_addr_) >> 0U * 8U) & 0xFFU }, \
+         .tag_mac   = { static_cast<uint8_t>(((mac_addr_) >> 5U * 8U) & 0xFFU), \
+                        static_cast<uint8_t>(((mac_addr_) >> 4U * 8U) & 0xFFU), \
+                        static_cast<uint8_t>(((mac_addr_) >> 3U * 8U) & 0xFFU), \
+                        static_cast<uint8_t>(((mac_addr_) >> 2U * 8U) & 0xFFU), \
+                        static_cast<uint8_t>(((mac_addr_) >> 1U * 8U) & 0xFFU), \
+                        static_cast<uint8_t>(((mac_addr_) >> 0U * 8U) & 0xFFU) }, \
          .rssi      = rssi_, \
          .data_len  = data_var_name_.size(), \
          .data_buf  = { __VA_ARGS__ }, \
@@ -109,6 +205,57 @@ make_array(T&&... values) -> std::array<V, sizeof...(T)>
     return std::array<V, sizeof...(T)> { std::forward<V>(values)... };
 }
 
+static mac_address_bin_t
+conv_u64_to_mac(const uint64_t mac_addr)
+{
+    mac_address_bin_t mac = {};
+    for (uint32_t i = 0; i < MAC_ADDRESS_NUM_BYTES; ++i)
+    {
+        mac.mac[i] = (mac_addr >> ((MAC_ADDRESS_NUM_BYTES - 1 - i) * 8U)) & 0xFFU;
+    }
+    return mac;
+}
+
+static uint32_t
+calc_home_slot(const uint64_t mac_addr)
+{
+    const mac_address_bin_t mac = conv_u64_to_mac(mac_addr);
+    return adv_hash_table_calc_home_slot(&mac);
+}
+
+static std::vector<uint64_t>
+find_macs_with_home_slot(const uint32_t home_slot, const uint64_t mac_base, const size_t num_macs)
+{
+    std::vector<uint64_t> macs;
+    for (uint64_t delta = 0; macs.size() < num_macs; ++delta)
+    {
+        if (calc_home_slot(mac_base + delta) == home_slot)
+        {
+            macs.push_back(mac_base + delta);
+        }
+    }
+    return macs;
+}
+
+static adv_report_t
+make_adv_report(const uint64_t mac_addr, const time_t timestamp, const uint8_t data_byte)
+{
+    adv_report_t adv = {
+        .timestamp = timestamp,
+        .tag_mac   = conv_u64_to_mac(mac_addr),
+        .rssi      = -50,
+        .data_len  = 2,
+        .data_buf  = { 0xA0U, data_byte },
+    };
+    return adv;
+}
+
+static bool
+adv_table_put_wrapper(const adv_report_t& adv)
+{
+    return adv_table_put(&adv);
+}
+
 /*** Unit-Tests
  * *******************************************************************************************************/
 
@@ -225,6 +372,41 @@ TEST_F(TestAdvTable, test_2) // NOLINT
     }
 }
 
+TEST_F(TestAdvTable, test_put_batch) // NOLINT
+{
+    const uint64_t    mac_addr       = 0x112233445566LLU;
+    const time_t      base_timestamp = 1611154440;
+    const wifi_rssi_t rssi           = 50;
+    DECL_ADV_REPORT(adv1, mac_addr + 0, base_timestamp + 0, rssi + 0, data1, 0xA1U, 0xB1U);
+    DECL_ADV_REPORT(adv2, mac_addr + 1, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
+    DECL_ADV_REPORT(adv3, mac_addr + 0, base_timestamp + 2, rssi + 2, data3, 0xA3U, 0xB3U);
+
+    ASSERT_TRUE(adv_table_put(&adv1));
+    {
+        adv_report_table_t reports = {};
+        adv_table_read_retransmission_list1_and_clear(&reports);
+        ASSERT_EQ(1, reports.num_of_advs);
+    }
+
+    // adv1 is skipped because the same data is already in the table, adv3 replaces adv1.
+    const adv_report_t arr_of_advs[] = { adv1, adv2, adv3 };
+    ASSERT_EQ(2, adv_table_put_batch(arr_of_advs, sizeof(arr_of_advs) / sizeof(arr_of_advs[0])));
+    {
+        adv_report_table_t reports = {};
+        adv_table_read_retransmission_list1_and_clear(&reports);
+        ASSERT_EQ(2, reports.num_of_advs);
+        CHECK_ADV_REPORT(adv2, data2, &reports.table[0]);
+        CHECK_ADV_REPORT(adv3, data3, &reports.table[1]);
+    }
+
+    ASSERT_EQ(0, adv_table_put_batch(arr_of_advs, 0));
+    {
+        adv_report_table_t reports = {};
+        adv_table_read_retransmission_list1_and_clear(&reports);
+        ASSERT_EQ(0, reports.num_of_advs);
+    }
+}
+
 TEST_F(TestAdvTable, test_2_filter_by_timestamp) // NOLINT
 {
     const uint64_t    mac_addr       = 0x112233445566LLU;
@@ -395,10 +577,11 @@ TEST_F(TestAdvTable, test_2_with_the_same_hash) // NOLINT
     const uint64_t    mac_addr       = 0x112233445566LLU;
     const time_t      base_timestamp = 1611154440;
     const wifi_rssi_t rssi           = 50;
+    const uint64_t    mac_collision  = find_macs_with_home_slot(calc_home_slot(mac_addr), mac_addr + 1, 1).at(0);
     DECL_ADV_REPORT(adv1, mac_addr ^ 0x000000000000LLU, base_timestamp + 0, rssi + 0, data1, 0xA1U, 0xB1U);
-    DECL_ADV_REPORT(adv2, mac_addr ^ 0x000001000001LLU, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
+    DECL_ADV_REPORT(adv2, mac_collision, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
 
-    ASSERT_EQ(adv_report_calc_hash(&adv1.tag_mac), adv_report_calc_hash(&adv2.tag_mac));
+    ASSERT_EQ(adv_hash_table_calc_home_slot(&adv1.tag_mac), adv_hash_table_calc_home_slot(&adv2.tag_mac));
 
     ASSERT_TRUE(adv_table_put(&adv1));
     ASSERT_TRUE(adv_table_put(&adv2));
@@ -440,6 +623,7 @@ TEST_F(TestAdvTable, test_2_with_the_same_hash_with_clear) // NOLINT
     const uint64_t    mac_addr       = 0x112233445566LLU;
     const time_t      base_timestamp = 1611154440;
     const wifi_rssi_t rssi           = 50;
+    const uint64_t    mac_collision  = find_macs_with_home_slot(calc_home_slot(mac_addr), mac_addr + 1, 1).at(0);
     DECL_ADV_REPORT(adv1, mac_addr ^ 0x000000000000LLU, base_timestamp + 0, rssi + 0, data1, 0xA1U, 0xB1U);
 
     ASSERT_TRUE(adv_table_put(&adv1));
@@ -451,9 +635,9 @@ TEST_F(TestAdvTable, test_2_with_the_same_hash_with_clear) // NOLINT
         CHECK_ADV_REPORT(adv1, data1, &reports.table[0]);
     }
 
-    DECL_ADV_REPORT(adv2, mac_addr ^ 0x000001000001LLU, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
+    DECL_ADV_REPORT(adv2, mac_collision, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
 
-    ASSERT_EQ(adv_report_calc_hash(&adv1.tag_mac), adv_report_calc_hash(&adv2.tag_mac));
+    ASSERT_EQ(adv_hash_table_calc_home_slot(&adv1.tag_mac), adv_hash_table_calc_home_slot(&adv2.tag_mac));
 
     ASSERT_TRUE(adv_table_put(&adv2));
 
@@ -598,8 +782,9 @@ TEST_F(TestAdvTable, test_3_with_the_same_hash_overwrite_1) // NOLINT
     const uint64_t    mac            = 0x112233445566LLU;
     const time_t      base_timestamp = 1611154440;
     const wifi_rssi_t rssi           = 50;
+    const uint64_t    mac_collision  = find_macs_with_home_slot(calc_home_slot(mac), mac + 1, 1).at(0);
     DECL_ADV_REPORT(adv1, mac ^ 0x000000000000LLU, base_timestamp + 0, rssi + 0, data1, 0xA1U, 0xB1U);
-    DECL_ADV_REPORT(adv2, mac ^ 0x000001000001LLU, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
+    DECL_ADV_REPORT(adv2, mac_collision, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
     DECL_ADV_REPORT(adv3, mac ^ 0x000000000000LLU, base_timestamp + 2, rssi + 2, data3, 0xA3U, 0xB3U, 0xC3U, 0xD3U);
 
     ASSERT_TRUE(adv_table_put(&adv1));
@@ -651,11 +836,12 @@ TEST_F(TestAdvTable, test_3_with_the_same_hash_overwrite_2) // NOLINT
     const uint64_t    mac            = 0x112233445566LLU;
     const time_t      base_timestamp = 1611154440;
     const wifi_rssi_t rssi           = 50;
+    const uint64_t    mac_collision  = find_macs_with_home_slot(calc_home_slot(mac), mac + 1, 1).at(0);
     DECL_ADV_REPORT(adv1, mac ^ 0x000000000000LLU, base_timestamp + 0, rssi + 0, data1, 0xA1U, 0xB1U);
-    DECL_ADV_REPORT(adv2, mac ^ 0x000001000001LLU, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
-    DECL_ADV_REPORT(adv3, mac ^ 0x000001000001LLU, base_timestamp + 2, rssi + 2, data3, 0xA3U, 0xB3U, 0xC3U, 0xD3U);
+    DECL_ADV_REPORT(adv2, mac_collision, base_timestamp + 1, rssi + 1, data2, 0xA2U, 0xB2U, 0xC2);
+    DECL_ADV_REPORT(adv3, mac_collision, base_timestamp + 2, rssi + 2, data3, 0xA3U, 0xB3U, 0xC3U, 0xD3U);
 
-    ASSERT_EQ(adv_report_calc_hash(&adv1.tag_mac), adv_report_calc_hash(&adv2.tag_mac));
+    ASSERT_EQ(adv_hash_table_calc_home_slot(&adv1.tag_mac), adv_hash_table_calc_home_slot(&adv2.tag_mac));
 
     ASSERT_TRUE(adv_table_put(&adv1));
     ASSERT_TRUE(adv_table_put(&adv2));
@@ -699,3 +885,554 @@ TEST_F(TestAdvTable, test_3_with_the_same_hash_overwrite_2) // NOLINT
         ASSERT_EQ(0, reports.num_of_advs);
     }
 }
+
+TEST_F(TestAdvTable, test_hash_distribution) // NOLINT
+{
+    // Sequential MAC addresses (typical for tags from the same production batch) must be spread evenly over the slots
+    const uint64_t         mac_base  = 0xC80000000000LLU;
+    const uint32_t         num_macs  = ADV_TABLE_CAPACITY;
+    std::vector<uint32_t>  slot_cnt;
+    for (uint32_t i = 0; i < num_macs; ++i)
+    {
+        const uint32_t slot = calc_home_slot(mac_base + i);
+        if (slot >= slot_cnt.size())
+        {
+            slot_cnt.resize(slot + 1);
+        }
+        slot_cnt[slot] += 1;
+    }
+    const uint32_t max_cnt = *std::max_element(slot_cnt.begin(), slot_cnt.end());
+    ASSERT_LE(max_cnt, 6);
+}
+
+TEST_F(TestAdvTable, test_more_macs_than_capacity_eviction_order) // NOLINT
+{
+    const uint64_t mac_base       = 0xC8AABBCC0000LLU;
+    const time_t   base_timestamp = 1611154440;
+    const uint32_t num_macs       = ADV_TABLE_CAPACITY + (ADV_TABLE_CAPACITY / 2);
+    ASSERT_GE(num_macs, 1000);
+
+    for (uint32_t i = 0; i < num_macs; ++i)
+    {
+        const adv_report_t adv = make_adv_report(mac_base + i, base_timestamp + i, 0x01U);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+
+    // Only the most recent ADV_TABLE_CAPACITY tags are kept, sorted from the newest to the oldest,
+    // the history contains only MAX_ADVS_TABLE of the newest ones.
+    ASSERT_LT(MAX_ADVS_TABLE, ADV_TABLE_CAPACITY);
+    {
+        auto p_reports = std::make_unique<adv_report_table_t>();
+        adv_table_history_read(p_reports.get(), base_timestamp + num_macs, true, 0, false);
+        ASSERT_EQ(MAX_ADVS_TABLE, p_reports->num_of_advs);
+        for (uint32_t i = 0; i < MAX_ADVS_TABLE; ++i)
+        {
+            const uint32_t     adv_idx = num_macs - 1 - i;
+            const adv_report_t exp_adv = make_adv_report(mac_base + adv_idx, base_timestamp + adv_idx, 0x01U);
+            ASSERT_EQ(0, memcmp(exp_adv.tag_mac.mac, p_reports->table[i].tag_mac.mac, sizeof(exp_adv.tag_mac.mac)));
+            ASSERT_EQ(exp_adv.timestamp, p_reports->table[i].timestamp);
+        }
+    }
+
+    // All the kept tags can be found in the hash table (the same data is discarded)
+    for (uint32_t i = num_macs - ADV_TABLE_CAPACITY; i < num_macs; ++i)
+    {
+        const adv_report_t adv = make_adv_report(mac_base + i, base_timestamp + num_macs, 0x01U);
+        ASSERT_FALSE(adv_table_put(&adv));
+    }
+
+    // The evicted tag is added as a new one and replaces the least recently updated tag
+    {
+        const adv_report_t adv = make_adv_report(mac_base + 0, base_timestamp + num_macs, 0x02U);
+        ASSERT_TRUE(adv_table_put(&adv));
+        ASSERT_FALSE(adv_table_put(&adv));
+    }
+    {
+        auto p_reports = std::make_unique<adv_report_table_t>();
+        adv_table_history_read(p_reports.get(), base_timestamp + num_macs, true, 0, false);
+        ASSERT_EQ(MAX_ADVS_TABLE, p_reports->num_of_advs);
+        const mac_address_bin_t mac_first = conv_u64_to_mac(mac_base + 0);
+        ASSERT_EQ(0, memcmp(mac_first.mac, p_reports->table[0].tag_mac.mac, sizeof(mac_first.mac)));
+    }
+    {
+        // The next tag after the evicted one is still in the table
+        const uint64_t     mac = mac_base + num_macs - ADV_TABLE_CAPACITY + 1;
+        const adv_report_t adv = make_adv_report(mac, base_timestamp + num_macs, 0x01U);
+        ASSERT_FALSE(adv_table_put(&adv));
+    }
+    {
+        // The least recently updated tag was evicted, so it's added as a new one
+        const uint64_t     mac = mac_base + num_macs - ADV_TABLE_CAPACITY;
+        const adv_report_t adv = make_adv_report(mac, base_timestamp + num_macs, 0x01U);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+}
+
+TEST_F(TestAdvTable, test_read_retransmission_list_more_advs_than_max_advs_table) // NOLINT
+{
+    const uint64_t mac_base       = 0xC8AABBCC0000LLU;
+    const time_t   base_timestamp = 1611154440;
+    const uint32_t num_macs       = MAX_ADVS_TABLE + 5;
+    ASSERT_LE(num_macs, ADV_TABLE_CAPACITY);
+
+    for (uint32_t i = 0; i < num_macs; ++i)
+    {
+        const adv_report_t adv = make_adv_report(mac_base + i, base_timestamp + i, 0x01U);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+
+    // The advs which do not fit into adv_report_table_t are not lost, they are read next time
+    auto p_reports = std::make_unique<adv_report_table_t>();
+    adv_table_read_retransmission_list2_and_clear(p_reports.get());
+    ASSERT_EQ(MAX_ADVS_TABLE, p_reports->num_of_advs);
+    adv_table_read_retransmission_list2_and_clear(p_reports.get());
+    ASSERT_EQ(num_macs - MAX_ADVS_TABLE, p_reports->num_of_advs);
+    adv_table_read_retransmission_list2_and_clear(p_reports.get());
+    ASSERT_EQ(0, p_reports->num_of_advs);
+}
+
+TEST_F(TestAdvTable, test_collision_chain_eviction) // NOLINT
+{
+    const uint64_t              mac_base       = 0x112233440000LLU;
+    const time_t                base_timestamp = 1611154440;
+    const std::vector<uint64_t> chain = find_macs_with_home_slot(calc_home_slot(mac_base), mac_base, 4);
+
+    for (uint32_t i = 0; i < chain.size(); ++i)
+    {
+        const adv_report_t adv = make_adv_report(chain[i], base_timestamp + i, 0x01U);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+    // Fill the rest of the table with the other tags
+    const uint64_t other_mac_base = 0xC80000000000LLU;
+    for (uint32_t i = 0; i < (ADV_TABLE_CAPACITY - chain.size()); ++i)
+    {
+        const adv_report_t adv = make_adv_report(other_mac_base + i, base_timestamp + 10 + i, 0x01U);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+
+    // Evict the first two tags of the collision chain, the rest of the chain must be still accessible
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        const uint64_t     mac = other_mac_base + ADV_TABLE_CAPACITY + i;
+        const adv_report_t adv = make_adv_report(mac, base_timestamp + 20000, 0x01U);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+    for (uint32_t i = 2; i < chain.size(); ++i)
+    {
+        const adv_report_t adv = make_adv_report(chain[i], base_timestamp + i, 0x01U);
+        ASSERT_FALSE(adv_table_put(&adv));
+    }
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        const adv_report_t adv = make_adv_report(chain[i], base_timestamp + 30000, 0x01U);
+        ASSERT_TRUE(adv_table_put(&adv));
+        ASSERT_FALSE(adv_table_put(&adv));
+    }
+}
+
+TEST_F(TestAdvTable, test_collision_chain_wraparound) // NOLINT
+{
+    // Find the last slot of the hash table to check the wraparound of the probing sequence
+    uint32_t last_slot = 0;
+    for (uint64_t mac = 0x112233440000LLU; mac < (0x112233440000LLU + (64U * ADV_TABLE_CAPACITY)); ++mac)
+    {
+        last_slot = std::max(last_slot, calc_home_slot(mac));
+    }
+    const time_t                base_timestamp = 1611154440;
+    const std::vector<uint64_t> chain1 = find_macs_with_home_slot(last_slot, 0x112233440000LLU, 3);
+    const std::vector<uint64_t> chain2 = find_macs_with_home_slot(0, 0x112233440000LLU, 2);
+
+    ASSERT_TRUE(adv_table_put_wrapper(make_adv_report(chain1[0], base_timestamp + 0, 0x01U)));
+    ASSERT_TRUE(adv_table_put_wrapper(make_adv_report(chain1[1], base_timestamp + 1, 0x01U)));
+    ASSERT_TRUE(adv_table_put_wrapper(make_adv_report(chain2[0], base_timestamp + 2, 0x01U)));
+    ASSERT_TRUE(adv_table_put_wrapper(make_adv_report(chain1[2], base_timestamp + 3, 0x01U)));
+    ASSERT_TRUE(adv_table_put_wrapper(make_adv_report(chain2[1], base_timestamp + 4, 0x01U)));
+
+    // Evict chain1[0] and chain1[1] by filling the table with the other tags
+    const uint64_t other_mac_base = 0xC80000000000LLU;
+    for (uint32_t i = 0; i < (ADV_TABLE_CAPACITY - 3); ++i)
+    {
+        ASSERT_TRUE(adv_table_put_wrapper(make_adv_report(other_mac_base + i, base_timestamp + 10 + i, 0x01U)));
+    }
+    ASSERT_FALSE(adv_table_put_wrapper(make_adv_report(chain2[0], base_timestamp + 2, 0x01U)));
+    ASSERT_FALSE(adv_table_put_wrapper(make_adv_report(chain1[2], base_timestamp + 3, 0x01U)));
+    ASSERT_FALSE(adv_table_put_wrapper(make_adv_report(chain2[1], base_timestamp + 4, 0x01U)));
+
+    ASSERT_TRUE(adv_table_put_wrapper(make_adv_report(chain1[0], base_timestamp + 30000, 0x01U)));
+    ASSERT_TRUE(adv_table_put_wrapper(make_adv_report(chain1[1], base_timestamp + 30001, 0x01U)));
+    ASSERT_FALSE(adv_table_put_wrapper(make_adv_report(chain1[0], base_timestamp + 30000, 0x01U)));
+    ASSERT_FALSE(adv_table_put_wrapper(make_adv_report(chain1[1], base_timestamp + 30001, 0x01U)));
+}
+
+TEST_F(TestAdvTable, test_snapshot) // NOLINT
+{
+    const uint64_t mac_addr1      = 0x112233445566LLU;
+    const uint64_t mac_addr2      = 0x112233445567LLU;
+    const time_t   base_timestamp = 1611154440;
+    DECL_ADV_REPORT(adv1, mac_addr1, base_timestamp, 50, data1, 0xAAU, 0xBBU);
+    DECL_ADV_REPORT(adv2, mac_addr2, base_timestamp + 1, 51, data2, 0xCCU, 0xDDU, 0xEEU);
+
+    ASSERT_TRUE(adv_table_put(&adv1));
+    ASSERT_TRUE(adv_table_put(&adv2));
+
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+    ASSERT_EQ(1, this->m_mem_alloc_trace.size());
+    ASSERT_EQ(2, adv_table_snapshot_get_num_of_advs(p_snapshot));
+    {
+        adv_report_t adv = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+        CHECK_ADV_REPORT(adv1, data1, &adv);
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 1, &adv));
+        CHECK_ADV_REPORT(adv2, data2, &adv);
+        ASSERT_FALSE(adv_table_snapshot_get_adv(p_snapshot, 2, &adv));
+    }
+
+    // The retransmission list1 is cleared, but the other lists are not affected
+    {
+        adv_report_table_t reports = {};
+        adv_table_read_retransmission_list1_and_clear(&reports);
+        ASSERT_EQ(0, reports.num_of_advs);
+        adv_table_read_retransmission_list2_and_clear(&reports);
+        ASSERT_EQ(2, reports.num_of_advs);
+    }
+
+    // The snapshot is freed when the last reference is released
+    ASSERT_EQ(p_snapshot, adv_table_snapshot_ref(p_snapshot));
+    adv_table_snapshot_t* p_snapshot2 = p_snapshot;
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_EQ(nullptr, p_snapshot);
+    ASSERT_EQ(1, this->m_mem_alloc_trace.size());
+    ASSERT_EQ(2, adv_table_snapshot_get_num_of_advs(p_snapshot2));
+    adv_table_snapshot_release(&p_snapshot2);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+
+    ASSERT_EQ(0, adv_table_snapshot_get_num_of_advs(nullptr));
+    adv_table_snapshot_release(&p_snapshot2);
+}
+
+TEST_F(TestAdvTable, test_snapshot_copy_on_write) // NOLINT
+{
+    const uint64_t mac_addr       = 0x112233445566LLU;
+    const time_t   base_timestamp = 1611154440;
+    DECL_ADV_REPORT(adv1, mac_addr, base_timestamp, 50, data1, 0xAAU, 0xBBU);
+    DECL_ADV_REPORT(adv2, mac_addr, base_timestamp + 1, 51, data2, 0xCCU, 0xDDU);
+    DECL_ADV_REPORT(adv3, mac_addr, base_timestamp + 2, 52, data3, 0xEEU, 0xFFU);
+
+    ASSERT_TRUE(adv_table_put(&adv1));
+    adv_table_snapshot_t* p_snapshot1 = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot1);
+
+    // The tag is updated twice after the snapshot was taken - its previous content is copied only once
+    ASSERT_TRUE(adv_table_put(&adv2));
+    ASSERT_EQ(2, this->m_mem_alloc_trace.size());
+    ASSERT_TRUE(adv_table_put(&adv3));
+    ASSERT_EQ(2, this->m_mem_alloc_trace.size());
+
+    adv_table_snapshot_t* p_snapshot2 = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot2);
+    ASSERT_EQ(1, adv_table_snapshot_get_num_of_advs(p_snapshot2));
+
+    DECL_ADV_REPORT(adv4, mac_addr, base_timestamp + 3, 53, data4, 0x11U, 0x22U);
+    ASSERT_TRUE(adv_table_put(&adv4));
+    ASSERT_EQ(4, this->m_mem_alloc_trace.size());
+
+    {
+        adv_report_t adv = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot1, 0, &adv));
+        CHECK_ADV_REPORT(adv1, data1, &adv);
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot2, 0, &adv));
+        CHECK_ADV_REPORT(adv3, data3, &adv);
+    }
+    {
+        adv_report_table_t reports = {};
+        adv_table_read_retransmission_list2_and_clear(&reports);
+        ASSERT_EQ(1, reports.num_of_advs);
+        CHECK_ADV_REPORT(adv4, data4, &reports.table[0]);
+    }
+
+    // The copy which is visible only to the released snapshot is freed together with it
+    adv_table_snapshot_release(&p_snapshot1);
+    ASSERT_EQ(2, this->m_mem_alloc_trace.size());
+    adv_table_snapshot_release(&p_snapshot2);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+
+    // Without snapshots the tag is updated in place
+    DECL_ADV_REPORT(adv5, mac_addr, base_timestamp + 4, 54, data5, 0x33U, 0x44U);
+    ASSERT_TRUE(adv_table_put(&adv5));
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvTable, test_snapshot_copy_on_write_on_eviction) // NOLINT
+{
+    const uint64_t mac_base       = 0xC8AABBCC0000LLU;
+    const time_t   base_timestamp = 1611154440;
+
+    const adv_report_t adv_first = make_adv_report(mac_base, base_timestamp, 0x01U);
+    ASSERT_TRUE(adv_table_put(&adv_first));
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+
+    // Fill the table with new tags, so that the tag from the snapshot is evicted
+    for (uint32_t i = 1; i <= ADV_TABLE_CAPACITY; ++i)
+    {
+        const adv_report_t adv = make_adv_report(mac_base + i, base_timestamp + i, 0x01U);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+    ASSERT_EQ(2, this->m_mem_alloc_trace.size());
+
+    adv_report_t adv = {};
+    ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+    ASSERT_EQ(0, memcmp(adv_first.tag_mac.mac, adv.tag_mac.mac, sizeof(adv.tag_mac.mac)));
+    ASSERT_EQ(adv_first.timestamp, adv.timestamp);
+
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvTable, test_snapshot_copy_on_write_malloc_failed) // NOLINT
+{
+    const uint64_t mac_addr       = 0x112233445566LLU;
+    const time_t   base_timestamp = 1611154440;
+    DECL_ADV_REPORT(adv1, mac_addr, base_timestamp, 50, data1, 0xAAU, 0xBBU);
+    DECL_ADV_REPORT(adv2, mac_addr, base_timestamp + 1, 51, data2, 0xCCU, 0xDDU);
+
+    ASSERT_TRUE(adv_table_put(&adv1));
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+
+    // The update is discarded if the content of the tag can't be preserved for the snapshot
+    this->m_malloc_fail_on_cnt = 2;
+    ASSERT_EQ(0, adv_table_get_no_mem_drop_cnt());
+    ASSERT_FALSE(adv_table_put(&adv2));
+    ASSERT_EQ(1, adv_table_get_no_mem_drop_cnt());
+    {
+        adv_report_t adv = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+        CHECK_ADV_REPORT(adv1, data1, &adv);
+    }
+    {
+        adv_report_table_t reports = {};
+        adv_table_history_read(&reports, base_timestamp, true, 0, false);
+        ASSERT_EQ(1, reports.num_of_advs);
+        CHECK_ADV_REPORT(adv1, data1, &reports.table[0]);
+    }
+
+    ASSERT_TRUE(adv_table_put(&adv2));
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvTable, test_snapshot_copy_on_write_on_duplicate) // NOLINT
+{
+    const uint64_t mac_addr       = 0x112233445566LLU;
+    const time_t   base_timestamp = 1611154440;
+    DECL_ADV_REPORT(adv1, mac_addr, base_timestamp, 50, data1, 0xAAU, 0xBBU);
+
+    ASSERT_TRUE(adv_table_put(&adv1));
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+    ASSERT_EQ(1, this->m_mem_alloc_trace.size());
+
+    // The duplicate increments samples_counter, the snapshot keeps seeing the previous value
+    ASSERT_FALSE(adv_table_put(&adv1));
+    ASSERT_EQ(2, this->m_mem_alloc_trace.size());
+    ASSERT_FALSE(adv_table_put(&adv1));
+    ASSERT_EQ(2, this->m_mem_alloc_trace.size());
+    {
+        adv_report_t adv = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+        CHECK_ADV_REPORT(adv1, data1, &adv);
+        ASSERT_EQ(0, adv.samples_counter);
+    }
+    {
+        adv_report_table_t reports = {};
+        adv_table_statistics_read(&reports);
+        ASSERT_EQ(1, reports.num_of_advs);
+        ASSERT_EQ(2, reports.table[0].samples_counter);
+    }
+
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+
+    // The duplicate is not counted if the content of the tag can't be preserved for the snapshot
+    DECL_ADV_REPORT(adv2, mac_addr, base_timestamp + 1, 51, data2, 0xCCU, 0xDDU);
+    ASSERT_TRUE(adv_table_put(&adv2));
+    p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+    this->m_malloc_fail_on_cnt = 4;
+    ASSERT_EQ(0, adv_table_get_no_mem_drop_cnt());
+    ASSERT_FALSE(adv_table_put(&adv2));
+    ASSERT_EQ(1, adv_table_get_no_mem_drop_cnt());
+    {
+        adv_report_t adv = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+        CHECK_ADV_REPORT(adv2, data2, &adv);
+        ASSERT_EQ(1, adv.samples_counter);
+    }
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvTable, test_snapshot_copy_on_write_on_statistics_read) // NOLINT
+{
+    const uint64_t mac_addr       = 0x112233445566LLU;
+    const time_t   base_timestamp = 1611154440;
+    DECL_ADV_REPORT(adv1, mac_addr, base_timestamp, 50, data1, 0xAAU, 0xBBU);
+
+    ASSERT_TRUE(adv_table_put(&adv1));
+    ASSERT_FALSE(adv_table_put(&adv1));
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+    ASSERT_EQ(1, this->m_mem_alloc_trace.size());
+
+    // Reading of the statistics resets samples_counter, the snapshot keeps seeing the previous value
+    {
+        adv_report_table_t reports = {};
+        adv_table_statistics_read(&reports);
+        ASSERT_EQ(1, reports.num_of_advs);
+        ASSERT_EQ(1, reports.table[0].samples_counter);
+    }
+    ASSERT_EQ(2, this->m_mem_alloc_trace.size());
+    {
+        adv_report_t adv = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+        CHECK_ADV_REPORT(adv1, data1, &adv);
+        ASSERT_EQ(1, adv.samples_counter);
+    }
+    {
+        adv_report_table_t reports = {};
+        adv_table_statistics_read(&reports);
+        ASSERT_EQ(1, reports.num_of_advs);
+        ASSERT_EQ(0, reports.table[0].samples_counter);
+    }
+    ASSERT_EQ(2, this->m_mem_alloc_trace.size());
+
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvTable, test_snapshot_copy_on_write_overlapping_snapshots) // NOLINT
+{
+    const uint64_t mac_addr       = 0x112233445566LLU;
+    const time_t   base_timestamp = 1611154440;
+
+    const adv_report_t adv_first = make_adv_report(mac_addr, base_timestamp, 0x00U);
+    ASSERT_TRUE(adv_table_put(&adv_first));
+    adv_table_snapshot_t* p_snapshot_prev = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot_prev);
+    time_t timestamp_prev = base_timestamp;
+
+    // There is always one more snapshot than the previous one, so the copies must not accumulate
+    for (uint32_t i = 1; i <= 100; ++i)
+    {
+        const adv_report_t adv = make_adv_report(mac_addr, base_timestamp + (2 * i), (uint8_t)(2U * i));
+        ASSERT_TRUE(adv_table_put(&adv));
+        adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+        ASSERT_NE(nullptr, p_snapshot);
+
+        // The new value is put while both snapshots are alive
+        const adv_report_t adv_next = make_adv_report(mac_addr, base_timestamp + (2 * i) + 1, (uint8_t)((2U * i) + 1U));
+        ASSERT_TRUE(adv_table_put(&adv_next));
+
+        adv_report_t adv_from_snapshot = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot_prev, 0, &adv_from_snapshot));
+        ASSERT_EQ(timestamp_prev, adv_from_snapshot.timestamp);
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv_from_snapshot));
+        ASSERT_EQ(adv.timestamp, adv_from_snapshot.timestamp);
+        ASSERT_EQ(0, memcmp(adv.data_buf, adv_from_snapshot.data_buf, adv.data_len));
+
+        adv_table_snapshot_release(&p_snapshot_prev);
+        p_snapshot_prev = p_snapshot;
+        timestamp_prev  = adv.timestamp;
+
+        // One snapshot and one copy of the element visible to it
+        ASSERT_LE(this->m_mem_alloc_trace.size(), 2);
+    }
+    adv_table_snapshot_release(&p_snapshot_prev);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+    ASSERT_EQ(0, adv_table_get_no_mem_drop_cnt());
+}
+
+TEST_F(TestAdvTable, test_snapshot_after_clear) // NOLINT
+{
+    const uint64_t mac_addr       = 0x112233445566LLU;
+    const time_t   base_timestamp = 1611154440;
+    DECL_ADV_REPORT(adv1, mac_addr, base_timestamp, 50, data1, 0xAAU, 0xBBU);
+
+    ASSERT_TRUE(adv_table_put(&adv1));
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+
+    adv_table_clear();
+    {
+        adv_report_t adv = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+        CHECK_ADV_REPORT(adv1, data1, &adv);
+    }
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvTable, test_snapshot_malloc_failed) // NOLINT
+{
+    const uint64_t mac_addr       = 0x112233445566LLU;
+    const time_t   base_timestamp = 1611154440;
+    DECL_ADV_REPORT(adv1, mac_addr, base_timestamp, 50, data1, 0xAAU, 0xBBU);
+
+    ASSERT_TRUE(adv_table_put(&adv1));
+
+    // The retransmission list is not cleared if there is not enough memory for the snapshot
+    this->m_malloc_fail_on_cnt = 1;
+    ASSERT_EQ(nullptr, adv_table_read_retransmission_list3_snapshot_and_clear());
+
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list3_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+    ASSERT_EQ(1, adv_table_snapshot_get_num_of_advs(p_snapshot));
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_TRUE(adv_table_read_retransmission_list3_is_empty());
+}
+
+TEST_F(TestAdvTable, test_snapshot_detached) // NOLINT
+{
+    const uint64_t mac_addr       = 0x112233445566LLU;
+    const time_t   base_timestamp = 1611154440;
+    DECL_ADV_REPORT(adv1, mac_addr, base_timestamp, 50, data1, 0xAAU, 0xBBU);
+    DECL_ADV_REPORT(adv2, mac_addr + 1, base_timestamp + 1, 51, data2, 0xCCU, 0xDDU);
+
+    auto* const p_arr = static_cast<adv_report_t*>(os_malloc(2 * sizeof(adv_report_t)));
+    ASSERT_NE(nullptr, p_arr);
+    p_arr[0] = adv1;
+    p_arr[1] = adv2;
+
+    adv_table_snapshot_t* p_snapshot = adv_table_snapshot_create_detached(p_arr, 2);
+    ASSERT_NE(nullptr, p_snapshot);
+    ASSERT_EQ(2, adv_table_snapshot_get_num_of_advs(p_snapshot));
+
+    // The detached snapshot does not depend on adv_table
+    ASSERT_TRUE(adv_table_put(&adv1));
+    adv_table_clear();
+    {
+        adv_report_t adv = {};
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+        CHECK_ADV_REPORT(adv1, data1, &adv);
+        ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 1, &adv));
+        CHECK_ADV_REPORT(adv2, data2, &adv);
+        ASSERT_FALSE(adv_table_snapshot_get_adv(p_snapshot, 2, &adv));
+    }
+    ASSERT_EQ(p_snapshot, adv_table_snapshot_ref(p_snapshot));
+    adv_table_snapshot_t* p_snapshot2 = p_snapshot;
+    adv_table_snapshot_release(&p_snapshot);
+    ASSERT_FALSE(this->m_mem_alloc_trace.is_empty());
+    adv_table_snapshot_release(&p_snapshot2);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestAdvTable, test_snapshot_detached_malloc_failed) // NOLINT
+{
+    auto* const p_arr = static_cast<adv_report_t*>(os_malloc(sizeof(adv_report_t)));
+    ASSERT_NE(nullptr, p_arr);
+    this->m_malloc_fail_on_cnt = this->m_malloc_cnt + 1;
+    ASSERT_EQ(nullptr, adv_table_snapshot_create_detached(p_arr, 1));
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
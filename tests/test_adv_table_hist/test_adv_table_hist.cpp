@@ -0,0 +1,384 @@
+/**
+ * @file test_adv_table_hist.cpp
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "adv_table.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+#include "esp_system.h"
+#include "os_mutex.h"
+#include "os_malloc.h"
+
+using namespace std;
+
+/*** Google-test class implementation
+ * *********************************************************************************/
+
+class TestAdvTableHist;
+static TestAdvTableHist* g_pTestClass;
+
+class TestAdvTableHist : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        g_pTestClass               = this;
+        this->m_malloc_cnt         = 0;
+        this->m_malloc_fail_on_cnt = 0;
+        this->m_num_allocated      = 0;
+        this->m_free_heap_size     = 200U * 1024U;
+    }
+
+    void
+    TearDown() override
+    {
+        adv_table_deinit();
+        ASSERT_EQ(0, this->m_num_allocated);
+        g_pTestClass = nullptr;
+    }
+
+public:
+    TestAdvTableHist();
+
+    ~TestAdvTableHist() override;
+
+    uint32_t m_malloc_cnt {};
+    uint32_t m_malloc_fail_on_cnt {};
+    uint32_t m_num_allocated {};
+    uint32_t m_free_heap_size {};
+};
+
+TestAdvTableHist::TestAdvTableHist()
+    : Test()
+{
+}
+
+TestAdvTableHist::~TestAdvTableHist() = default;
+
+extern "C" {
+
+void*
+os_malloc(const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    g_pTestClass->m_num_allocated += 1;
+    return malloc(size);
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    assert(nullptr != g_pTestClass);
+    assert(0 != g_pTestClass->m_num_allocated);
+    g_pTestClass->m_num_allocated -= 1;
+    free(p_mem);
+}
+
+void*
+os_calloc(const size_t nmemb, const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    g_pTestClass->m_num_allocated += 1;
+    return calloc(nmemb, size);
+}
+
+uint32_t
+esp_get_free_heap_size(void)
+{
+    return g_pTestClass->m_free_heap_size;
+}
+
+os_mutex_t
+os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
+{
+    return reinterpret_cast<os_mutex_t>(p_mutex_static);
+}
+
+void
+os_mutex_delete(os_mutex_t* const ph_mutex)
+{
+    (void)ph_mutex;
+}
+
+void
+os_mutex_lock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
+void
+os_mutex_unlock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
+} // extern "C"
+
+static adv_report_t
+make_adv_report(const uint8_t mac_lo, const time_t timestamp, const wifi_rssi_t rssi, const uint8_t data_byte)
+{
+    adv_report_t adv = {
+        .timestamp = timestamp,
+        .tag_mac   = { 0xAAU, 0xBBU, 0xCCU, 0x01U, 0x02U, mac_lo },
+        .rssi      = rssi,
+        .data_len  = 2,
+        .data_buf  = { 0xA0U, data_byte },
+    };
+    return adv;
+}
+
+static vector<adv_report_t>
+read_samples(const adv_table_snapshot_t* const p_snapshot, const num_of_advs_t idx)
+{
+    vector<adv_report_t> samples;
+    for (num_of_advs_t i = 0; i < adv_table_snapshot_get_num_of_samples(p_snapshot, idx); ++i)
+    {
+        adv_report_t adv = {};
+        if (adv_table_snapshot_get_sample(p_snapshot, idx, i, &adv))
+        {
+            samples.push_back(adv);
+        }
+    }
+    return samples;
+}
+
+/*** Unit-Tests
+ * *******************************************************************************************************/
+
+TEST_F(TestAdvTableHist, test_refused_if_not_enough_heap) // NOLINT
+{
+    this->m_free_heap_size = 64U * 1024U;
+    adv_table_init();
+    ASSERT_FALSE(adv_table_hist_is_enabled());
+    ASSERT_EQ(0, this->m_num_allocated);
+
+    const adv_report_t adv1 = make_adv_report(0x01, 1000, -50, 0x01);
+    const adv_report_t adv2 = make_adv_report(0x01, 1001, -51, 0x02);
+    ASSERT_TRUE(adv_table_put(&adv1));
+    ASSERT_TRUE(adv_table_put(&adv2));
+
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+    ASSERT_EQ(1, adv_table_snapshot_get_num_of_advs(p_snapshot));
+    ASSERT_EQ(0, adv_table_snapshot_get_num_of_samples(p_snapshot, 0));
+    adv_report_t adv = {};
+    ASSERT_FALSE(adv_table_snapshot_get_sample(p_snapshot, 0, 0, &adv));
+    ASSERT_TRUE(adv_table_snapshot_get_adv(p_snapshot, 0, &adv));
+    ASSERT_EQ(1001, adv.timestamp);
+    ASSERT_EQ(1, adv.samples_counter);
+    adv_table_snapshot_release(&p_snapshot);
+}
+
+TEST_F(TestAdvTableHist, test_arena_malloc_failed) // NOLINT
+{
+    this->m_malloc_fail_on_cnt = 1;
+    adv_table_init();
+    ASSERT_FALSE(adv_table_hist_is_enabled());
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestAdvTableHist, test_samples_between_snapshots) // NOLINT
+{
+    adv_table_init();
+    ASSERT_TRUE(adv_table_hist_is_enabled());
+    ASSERT_EQ(1, this->m_num_allocated);
+
+    const adv_report_t adv1 = make_adv_report(0x01, 1000, -50, 0x01);
+    const adv_report_t adv2 = make_adv_report(0x01, 1001, -51, 0x02);
+    const adv_report_t adv3 = make_adv_report(0x01, 1003, -52, 0x03);
+    const adv_report_t adv4 = make_adv_report(0x02, 1002, -60, 0x11);
+    ASSERT_TRUE(adv_table_put(&adv1));
+    ASSERT_TRUE(adv_table_put(&adv2));
+    ASSERT_FALSE(adv_table_put(&adv2)); // The duplicated data is not a new sample
+    ASSERT_TRUE(adv_table_put(&adv4));
+    ASSERT_TRUE(adv_table_put(&adv3));
+
+    adv_table_snapshot_t* p_snapshot1 = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot1);
+    ASSERT_EQ(2, adv_table_snapshot_get_num_of_advs(p_snapshot1));
+    ASSERT_EQ(3, adv_table_snapshot_get_num_of_samples(p_snapshot1, 0));
+    ASSERT_EQ(1, adv_table_snapshot_get_num_of_samples(p_snapshot1, 1));
+    ASSERT_EQ(0, adv_table_snapshot_get_num_of_samples(p_snapshot1, 2));
+
+    // New samples do not change the samples seen through the snapshot
+    const adv_report_t adv5 = make_adv_report(0x01, 1004, -53, 0x04);
+    ASSERT_TRUE(adv_table_put(&adv5));
+
+    const vector<adv_report_t> samples = read_samples(p_snapshot1, 0);
+    ASSERT_EQ(3, samples.size());
+    ASSERT_EQ(1000, samples[0].timestamp);
+    ASSERT_EQ(-50, samples[0].rssi);
+    ASSERT_EQ(0x01, samples[0].data_buf[1]);
+    ASSERT_EQ(1001, samples[1].timestamp);
+    ASSERT_EQ(-51, samples[1].rssi);
+    ASSERT_EQ(0x02, samples[1].data_buf[1]);
+    ASSERT_EQ(1003, samples[2].timestamp);
+    ASSERT_EQ(-52, samples[2].rssi);
+    ASSERT_EQ(0x03, samples[2].data_buf[1]);
+    ASSERT_EQ(2, samples[2].data_len);
+    ASSERT_EQ(0, memcmp(adv1.tag_mac.mac, samples[2].tag_mac.mac, sizeof(adv1.tag_mac.mac)));
+
+    const vector<adv_report_t> samples2 = read_samples(p_snapshot1, 1);
+    ASSERT_EQ(1, samples2.size());
+    ASSERT_EQ(1002, samples2[0].timestamp);
+    ASSERT_EQ(0x11, samples2[0].data_buf[1]);
+
+    // The snapshot of the other retransmission list contains all the samples which were not sent to it
+    adv_table_snapshot_t* p_snapshot2 = adv_table_read_retransmission_list2_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot2);
+    ASSERT_EQ(4, adv_table_snapshot_get_num_of_samples(p_snapshot2, 0));
+
+    // The next snapshot of the first list contains only the new sample
+    adv_table_snapshot_t* p_snapshot3 = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot3);
+    ASSERT_EQ(1, adv_table_snapshot_get_num_of_advs(p_snapshot3));
+    const vector<adv_report_t> samples3 = read_samples(p_snapshot3, 0);
+    ASSERT_EQ(1, samples3.size());
+    ASSERT_EQ(1004, samples3[0].timestamp);
+    ASSERT_EQ(-53, samples3[0].rssi);
+
+    // The samples are not copied to the snapshots for MQTT
+    adv_table_snapshot_t* p_snapshot4 = adv_table_read_retransmission_list3_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot4);
+    ASSERT_EQ(2, adv_table_snapshot_get_num_of_advs(p_snapshot4));
+    ASSERT_EQ(0, adv_table_snapshot_get_num_of_samples(p_snapshot4, 0));
+
+    adv_table_snapshot_release(&p_snapshot1);
+    adv_table_snapshot_release(&p_snapshot2);
+    adv_table_snapshot_release(&p_snapshot3);
+    adv_table_snapshot_release(&p_snapshot4);
+    ASSERT_EQ(1, this->m_num_allocated);
+}
+
+TEST_F(TestAdvTableHist, test_ring_overflow_keeps_newest_samples) // NOLINT
+{
+    adv_table_init();
+    for (uint8_t i = 0; i < (ADV_TABLE_HIST_DEPTH + 2); ++i)
+    {
+        const adv_report_t adv = make_adv_report(0x01, 1000 + (i * 10), static_cast<wifi_rssi_t>(-50 - i), i);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+    const vector<adv_report_t> samples = read_samples(p_snapshot, 0);
+    ASSERT_EQ(ADV_TABLE_HIST_DEPTH, samples.size());
+    for (uint32_t i = 0; i < ADV_TABLE_HIST_DEPTH; ++i)
+    {
+        ASSERT_EQ(1020 + (i * 10), samples[i].timestamp);
+        ASSERT_EQ(-52 - static_cast<int32_t>(i), samples[i].rssi);
+        ASSERT_EQ(2 + i, samples[i].data_buf[1]);
+    }
+    adv_table_snapshot_release(&p_snapshot);
+}
+
+TEST_F(TestAdvTableHist, test_partially_sent_ring) // NOLINT
+{
+    adv_table_init();
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        const adv_report_t adv = make_adv_report(0x01, 1000 + i, -50, i);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+    adv_table_snapshot_t* p_snapshot1 = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_EQ(3, adv_table_snapshot_get_num_of_samples(p_snapshot1, 0));
+    adv_table_snapshot_release(&p_snapshot1);
+
+    // Two old samples remain in the ring, but only the new ones are taken to the snapshot
+    for (uint8_t i = 3; i < 5; ++i)
+    {
+        const adv_report_t adv = make_adv_report(0x01, 1000 + (i * 100), -50, i);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+    adv_table_snapshot_t* p_snapshot2 = adv_table_read_retransmission_list1_snapshot_and_clear();
+    const vector<adv_report_t> samples = read_samples(p_snapshot2, 0);
+    ASSERT_EQ(2, samples.size());
+    ASSERT_EQ(1300, samples[0].timestamp);
+    ASSERT_EQ(3, samples[0].data_buf[1]);
+    ASSERT_EQ(1400, samples[1].timestamp);
+    ASSERT_EQ(4, samples[1].data_buf[1]);
+    adv_table_snapshot_release(&p_snapshot2);
+}
+
+TEST_F(TestAdvTableHist, test_large_time_gap_drops_older_samples) // NOLINT
+{
+    adv_table_init();
+    const adv_report_t adv1 = make_adv_report(0x01, 1000, -50, 0x01);
+    const adv_report_t adv2 = make_adv_report(0x01, 1000 + UINT16_MAX + 1, -51, 0x02);
+    const adv_report_t adv3 = make_adv_report(0x01, 1000 + UINT16_MAX + 2, -52, 0x03);
+    ASSERT_TRUE(adv_table_put(&adv1));
+    ASSERT_TRUE(adv_table_put(&adv2));
+    ASSERT_TRUE(adv_table_put(&adv3));
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    const vector<adv_report_t> samples = read_samples(p_snapshot, 0);
+    ASSERT_EQ(2, samples.size());
+    ASSERT_EQ(adv2.timestamp, samples[0].timestamp);
+    ASSERT_EQ(adv3.timestamp, samples[1].timestamp);
+    adv_table_snapshot_release(&p_snapshot);
+}
+
+TEST_F(TestAdvTableHist, test_evicted_tag_and_clear) // NOLINT
+{
+    adv_table_init();
+    for (uint8_t i = 0; i < ADV_TABLE_CAPACITY; ++i)
+    {
+        const adv_report_t adv = make_adv_report(i, 1000, -50, i);
+        ASSERT_TRUE(adv_table_put(&adv));
+    }
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_EQ(ADV_TABLE_CAPACITY, adv_table_snapshot_get_num_of_advs(p_snapshot));
+    adv_table_snapshot_release(&p_snapshot);
+
+    // The new tag replaces the oldest one, the samples of the evicted tag are dropped
+    const adv_report_t adv_new = make_adv_report(0xF0, 2000, -40, 0xF0);
+    ASSERT_TRUE(adv_table_put(&adv_new));
+    p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_EQ(1, adv_table_snapshot_get_num_of_advs(p_snapshot));
+    const vector<adv_report_t> samples = read_samples(p_snapshot, 0);
+    ASSERT_EQ(1, samples.size());
+    ASSERT_EQ(2000, samples[0].timestamp);
+    ASSERT_EQ(0xF0, samples[0].data_buf[1]);
+    adv_table_snapshot_release(&p_snapshot);
+
+    const adv_report_t adv_new2 = make_adv_report(0xF0, 2001, -41, 0xF1);
+    ASSERT_TRUE(adv_table_put(&adv_new2));
+    adv_table_clear();
+    const adv_report_t adv_new3 = make_adv_report(0xF0, 2002, -42, 0xF2);
+    ASSERT_TRUE(adv_table_put(&adv_new3));
+    p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_EQ(1, adv_table_snapshot_get_num_of_samples(p_snapshot, 0));
+    adv_table_snapshot_release(&p_snapshot);
+}
+
+TEST_F(TestAdvTableHist, test_snapshot_malloc_failed) // NOLINT
+{
+    adv_table_init();
+    const adv_report_t adv1 = make_adv_report(0x01, 1000, -50, 0x01);
+    ASSERT_TRUE(adv_table_put(&adv1));
+
+    for (uint32_t i = 1; i <= 3; ++i)
+    {
+        this->m_malloc_fail_on_cnt = this->m_malloc_cnt + i;
+        ASSERT_EQ(nullptr, adv_table_read_retransmission_list1_snapshot_and_clear());
+        ASSERT_EQ(1, this->m_num_allocated);
+    }
+    // The retransmission list and the samples are not cleared if there is not enough memory
+    this->m_malloc_fail_on_cnt     = 0;
+    adv_table_snapshot_t* p_snapshot = adv_table_read_retransmission_list1_snapshot_and_clear();
+    ASSERT_NE(nullptr, p_snapshot);
+    ASSERT_EQ(1, adv_table_snapshot_get_num_of_samples(p_snapshot, 0));
+    adv_table_snapshot_release(&p_snapshot);
+}
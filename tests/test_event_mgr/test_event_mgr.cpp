@@ -28,6 +28,8 @@ typedef enum MainTaskCmd_Tag
     MainTaskCmd_EventMgrNotifyWiFiDisconnected,
     MainTaskCmd_EventMgrNotifyEthConnected,
     MainTaskCmd_EventMgrNotifyEthDisconnected,
+    MainTaskCmd_EventMgrSetEdgeTriggeredWiFiConnected,
+    MainTaskCmd_EventMgrAckWiFiConnected,
     MainTaskCmd_RunSignalHandlerTask1,
     MainTaskCmd_RunSignalHandlerTask2,
     MainTaskCmd_SendToTask1Signal0,
@@ -397,6 +399,12 @@ cmdHandlerTask(void* p_param)
             case MainTaskCmd_EventMgrNotifyEthDisconnected:
                 event_mgr_notify(EVENT_MGR_EV_ETH_DISCONNECTED);
                 break;
+            case MainTaskCmd_EventMgrSetEdgeTriggeredWiFiConnected:
+                event_mgr_set_edge_triggered(EVENT_MGR_EV_WIFI_CONNECTED, 60 * 1000);
+                break;
+            case MainTaskCmd_EventMgrAckWiFiConnected:
+                event_mgr_ack(EVENT_MGR_EV_WIFI_CONNECTED);
+                break;
 
             case MainTaskCmd_RunSignalHandlerTask1:
             {
@@ -569,3 +577,64 @@ TEST_F(TestEventMgr, test1) // NOLINT
 
     cmdQueue.push_and_wait(MainTaskCmd_EventMgrDeinit);
 }
+
+TEST_F(TestEventMgr, test_edge_triggered) // NOLINT
+{
+    this->result_event_mgr_init = false;
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrInit);
+    ASSERT_TRUE(this->result_event_mgr_init);
+
+    this->result_run_signal_handler_task = false;
+    cmdQueue.push_and_wait(MainTaskCmd_RunSignalHandlerTask1);
+    ASSERT_TRUE(this->result_run_signal_handler_task);
+    ASSERT_TRUE(wait_until_thread1_registered(1000));
+
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrSetEdgeTriggeredWiFiConnected);
+    ASSERT_EQ(0, event_mgr_get_num_suppressed_notifications(EVENT_MGR_EV_WIFI_CONNECTED));
+
+    // Repeated notifications are coalesced until the event is acknowledged
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrNotifyWiFiConnected);
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrNotifyWiFiConnected);
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrNotifyWiFiConnected);
+    ASSERT_TRUE(wait_until_new_events_pushed(1, 1000));
+    ASSERT_FALSE(wait_until_new_events_pushed(2, 1000));
+    {
+        auto* pBaseEv = testEvents[0];
+        ASSERT_EQ(TestEventType_Signal, pBaseEv->eventType);
+        auto* pEv = reinterpret_cast<TestEventSignal*>(pBaseEv);
+        ASSERT_EQ(TEST_EVENT_THREAD_NUM_1, pEv->thread_num);
+        ASSERT_EQ(OS_SIGNAL_NUM_0, pEv->sig_num);
+    }
+    testEvents.clear();
+    ASSERT_EQ(2, event_mgr_get_num_suppressed_notifications(EVENT_MGR_EV_WIFI_CONNECTED));
+
+    // The level-triggered events are not affected
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrNotifyWiFiDisconnected);
+    ASSERT_TRUE(wait_until_new_events_pushed(1, 1000));
+    {
+        auto* pBaseEv = testEvents[0];
+        ASSERT_EQ(TestEventType_Signal, pBaseEv->eventType);
+        auto* pEv = reinterpret_cast<TestEventSignal*>(pBaseEv);
+        ASSERT_EQ(OS_SIGNAL_NUM_1, pEv->sig_num);
+    }
+    testEvents.clear();
+
+    // After the acknowledgement the next notification is delivered
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrAckWiFiConnected);
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrNotifyWiFiConnected);
+    ASSERT_TRUE(wait_until_new_events_pushed(1, 1000));
+    {
+        auto* pBaseEv = testEvents[0];
+        ASSERT_EQ(TestEventType_Signal, pBaseEv->eventType);
+        auto* pEv = reinterpret_cast<TestEventSignal*>(pBaseEv);
+        ASSERT_EQ(OS_SIGNAL_NUM_0, pEv->sig_num);
+    }
+    testEvents.clear();
+    ASSERT_EQ(2, event_mgr_get_num_suppressed_notifications(EVENT_MGR_EV_WIFI_CONNECTED));
+
+    cmdQueue.push_and_wait(MainTaskCmd_SendToTask1Signal2);
+    ASSERT_TRUE(wait_until_new_events_pushed(2, 1000));
+    testEvents.clear();
+
+    cmdQueue.push_and_wait(MainTaskCmd_EventMgrDeinit);
+}
@@ -14,6 +14,7 @@
 #include "esp_err.h"
 #include "esp_vfs_fat.h"
 #include "os_task.h"
+#include "os_mutex.h"
 
 using namespace std;
 
@@ -190,6 +191,24 @@ TestFlashFatFs::~TestFlashFatFs() = default;
 
 extern "C" {
 
+os_mutex_t
+os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
+{
+    return reinterpret_cast<os_mutex_t>(p_mutex_static);
+}
+
+void
+os_mutex_lock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
+void
+os_mutex_unlock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
 const char*
 os_task_get_name(void)
 {
@@ -7,12 +7,16 @@
 
 #include "json_ruuvi.h"
 #include <cstring>
+#include <algorithm>
+#include <random>
+#include <vector>
 #include "gtest/gtest.h"
 #include "gw_cfg.h"
 #include "gw_cfg_default.h"
 #include "gw_cfg_json_parse.h"
 #include "gw_cfg_json_parse_internal.h"
 #include "gw_cfg_json_generate.h"
+#include "gw_cfg_json_stream.h"
 #include "esp_log_wrapper.hpp"
 #include "os_mutex_recursive.h"
 #include "os_mutex.h"
@@ -2926,6 +2930,113 @@ TEST_F(TestGwCfgJson, gw_cfg_json_generate_http_enabled_data_format_ruuvi_decode
     ASSERT_TRUE(0 == memcmp(&gw_cfg, &gw_cfg2, sizeof(gw_cfg)));
 }
 
+TEST_F(TestGwCfgJson, gw_cfg_json_generate_http_enabled_data_format_ruuvi_cbor) // NOLINT
+{
+    gw_cfg_t         gw_cfg   = get_gateway_config_default();
+    cjson_wrap_str_t json_str = cjson_wrap_str_null();
+
+    gw_cfg.ruuvi_cfg.http.use_http    = true;
+    gw_cfg.ruuvi_cfg.http.data_format = GW_CFG_HTTP_DATA_FORMAT_RUUVI_CBOR;
+    snprintf(
+        gw_cfg.ruuvi_cfg.http.http_url.buf,
+        sizeof(gw_cfg.ruuvi_cfg.http.http_url.buf),
+        "https://my_url1.com/status");
+    ASSERT_TRUE(gw_cfg_json_generate_for_saving(&gw_cfg, &json_str));
+    ASSERT_NE(nullptr, json_str.p_str);
+    ASSERT_EQ(
+        string("{\n"
+               "\t\"wifi_sta_config\":\t{\n"
+               "\t\t\"ssid\":\t\"\",\n"
+               "\t\t\"password\":\t\"\"\n"
+               "\t},\n"
+               "\t\"wifi_ap_config\":\t{\n"
+               "\t\t\"password\":\t\"\",\n"
+               "\t\t\"channel\":\t1\n"
+               "\t},\n"
+               "\t\"use_eth\":\ttrue,\n"
+               "\t\"eth_dhcp\":\ttrue,\n"
+               "\t\"eth_static_ip\":\t\"\",\n"
+               "\t\"eth_netmask\":\t\"\",\n"
+               "\t\"eth_gw\":\t\"\",\n"
+               "\t\"eth_dns1\":\t\"\",\n"
+               "\t\"eth_dns2\":\t\"\",\n"
+               "\t\"remote_cfg_use\":\tfalse,\n"
+               "\t\"remote_cfg_url\":\t\"\",\n"
+               "\t\"remote_cfg_auth_type\":\t\"none\",\n"
+               "\t\"remote_cfg_use_ssl_client_cert\":\tfalse,\n"
+               "\t\"remote_cfg_use_ssl_server_cert\":\tfalse,\n"
+               "\t\"remote_cfg_refresh_interval_minutes\":\t0,\n"
+               "\t\"use_http_ruuvi\":\ttrue,\n"
+               "\t\"use_http\":\ttrue,\n"
+               "\t\"http_url\":\t\""
+               "https://my_url1.com/status"
+               "\",\n"
+               "\t\"http_period\":\t10,\n"
+               "\t\"http_data_format\":\t\"ruuvi_cbor\",\n"
+               "\t\"http_auth\":\t\"none\",\n"
+               "\t\"http_use_ssl_client_cert\":\tfalse,\n"
+               "\t\"http_use_ssl_server_cert\":\tfalse,\n"
+               "\t\"http_use_extra_http_path\":\tfalse,\n"
+               "\t\"http_use_extra_http_query\":\tfalse,\n"
+               "\t\"http_use_extra_http_headers\":\tfalse,\n"
+               "\t\"use_http_stat\":\ttrue,\n"
+               "\t\"http_stat_url\":\t\"" RUUVI_GATEWAY_HTTP_STATUS_URL "\",\n"
+               "\t\"http_stat_user\":\t\"\",\n"
+               "\t\"http_stat_pass\":\t\"\",\n"
+               "\t\"http_stat_use_ssl_client_cert\":\tfalse,\n"
+               "\t\"http_stat_use_ssl_server_cert\":\tfalse,\n"
+               "\t\"use_mqtt\":\tfalse,\n"
+               "\t\"mqtt_disable_retained_messages\":\tfalse,\n"
+               "\t\"mqtt_transport\":\t\"TCP\",\n"
+               "\t\"mqtt_data_format\":\t\"ruuvi_raw\",\n"
+               "\t\"mqtt_server\":\t\"test.mosquitto.org\",\n"
+               "\t\"mqtt_port\":\t1883,\n"
+               "\t\"mqtt_sending_interval\":\t0,\n"
+               "\t\"mqtt_prefix\":\t\"ruuvi/AA:BB:CC:DD:EE:FF/\",\n"
+               "\t\"mqtt_client_id\":\t\"AA:BB:CC:DD:EE:FF\",\n"
+               "\t\"mqtt_user\":\t\"\",\n"
+               "\t\"mqtt_pass\":\t\"\",\n"
+               "\t\"mqtt_use_ssl_client_cert\":\tfalse,\n"
+               "\t\"mqtt_use_ssl_server_cert\":\tfalse,\n"
+               "\t\"lan_auth_type\":\t\"lan_auth_default\",\n"
+               "\t\"lan_auth_user\":\t\"Admin\",\n"
+               "\t\"lan_auth_api_key\":\t\"\",\n"
+               "\t\"lan_auth_api_key_rw\":\t\"\",\n"
+               "\t\"auto_update_cycle\":\t\"regular\",\n"
+               "\t\"auto_update_weekdays_bitmask\":\t127,\n"
+               "\t\"auto_update_interval_from\":\t0,\n"
+               "\t\"auto_update_interval_to\":\t24,\n"
+               "\t\"auto_update_tz_offset_hours\":\t3,\n"
+               "\t\"ntp_use\":\ttrue,\n"
+               "\t\"ntp_use_dhcp\":\tfalse,\n"
+               "\t\"ntp_server1\":\t\"time.google.com\",\n"
+               "\t\"ntp_server2\":\t\"time.cloudflare.com\",\n"
+               "\t\"ntp_server3\":\t\"pool.ntp.org\",\n"
+               "\t\"ntp_server4\":\t\"time.ruuvi.com\",\n"
+               "\t\"company_id\":\t1177,\n"
+               "\t\"company_use_filtering\":\ttrue,\n"
+               "\t\"scan_coded_phy\":\tfalse,\n"
+               "\t\"scan_1mbit_phy\":\ttrue,\n"
+               "\t\"scan_2mbit_phy\":\ttrue,\n"
+               "\t\"scan_channel_37\":\ttrue,\n"
+               "\t\"scan_channel_38\":\ttrue,\n"
+               "\t\"scan_channel_39\":\ttrue,\n"
+               "\t\"scan_default\":\ttrue,\n"
+               "\t\"scan_filter_allow_listed\":\tfalse,\n"
+               "\t\"scan_filter_list\":\t[],\n"
+               "\t\"coordinates\":\t\"\",\n"
+               "\t\"fw_update_url\":\t\"https://network.ruuvi.com/firmwareupdate\"\n"
+               "}"),
+        string(json_str.p_str));
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+
+    gw_cfg_t gw_cfg2 = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, json_str.p_str, &gw_cfg2));
+    cjson_wrap_free_json_str(&json_str);
+
+    ASSERT_TRUE(0 == memcmp(&gw_cfg, &gw_cfg2, sizeof(gw_cfg)));
+}
+
 TEST_F(TestGwCfgJson, gw_cfg_json_generate_http_enabled_auth_none) // NOLINT
 {
     gw_cfg_t         gw_cfg   = get_gateway_config_default();
@@ -10005,3 +10116,514 @@ TEST_F(TestGwCfgJson, gw_cfg_json_parse_http_legacy_patch_silences_post_patch_wa
         ASSERT_NE(msg, string("Can't find key 'http_use_ssl_server_cert' in config-json"));
     }
 }
+
+static const char g_gw_cfg_json_stream_test_json[]
+    = "{\n"
+      "\t\"fw_ver\":\t\"v1.15.0\",\n"
+      "\t\"storage\":\t{\n"
+      "\t\t\"storage_ready\":\ttrue,\n"
+      "\t\t\"nested\":\t[[1, 2, {\"a\": null}], {\"b\": [true, false]}]\n"
+      "\t},\n"
+      "\t\"wifi_sta_config\":\t{\n"
+      "\t\t\"ssid\":\t\"my_wifi\",\n"
+      "\t\t\"password\":\t\"my_wifi_pass\",\n"
+      "\t\t\"unknown\":\t{\"x\": [1, 2, 3]}\n"
+      "\t},\n"
+      "\t\"wifi_ap_config\":\t{\n"
+      "\t\t\"password\":\t\"my_ap_pass\",\n"
+      "\t\t\"channel\":\t7\n"
+      "\t},\n"
+      "\t\"use_eth\":\ttrue,\n"
+      "\t\"eth_dhcp\":\tfalse,\n"
+      "\t\"eth_static_ip\":\t\"192.168.1.10\",\n"
+      "\t\"eth_netmask\":\t\"255.255.255.0\",\n"
+      "\t\"eth_gw\":\t\"192.168.1.1\",\n"
+      "\t\"eth_dns1\":\t\"8.8.8.8\",\n"
+      "\t\"eth_dns2\":\t\"4.4.4.4\",\n"
+      "\t\"remote_cfg_use\":\ttrue,\n"
+      "\t\"remote_cfg_url\":\t\"https://my_server.com/gw_cfg\",\n"
+      "\t\"remote_cfg_auth_type\":\t\"basic\",\n"
+      "\t\"remote_cfg_auth_basic_user\":\t\"remote_user\",\n"
+      "\t\"remote_cfg_auth_basic_pass\":\t\"remote_pass\",\n"
+      "\t\"remote_cfg_use_ssl_client_cert\":\tfalse,\n"
+      "\t\"remote_cfg_use_ssl_server_cert\":\ttrue,\n"
+      "\t\"remote_cfg_refresh_interval_minutes\":\t15,\n"
+      "\t\"use_http_ruuvi\":\tfalse,\n"
+      "\t\"use_http\":\ttrue,\n"
+      "\t\"http_url\":\t\"https://my_server.com/record\",\n"
+      "\t\"http_period\":\t30,\n"
+      "\t\"http_data_format\":\t\"ruuvi_raw_and_decoded\",\n"
+      "\t\"http_auth\":\t\"basic\",\n"
+      "\t\"http_user\":\t\"http_user1\",\n"
+      "\t\"http_pass\":\t\"http_pass1\",\n"
+      "\t\"http_use_ssl_client_cert\":\tfalse,\n"
+      "\t\"http_use_ssl_server_cert\":\ttrue,\n"
+      "\t\"http_use_extra_http_path\":\tfalse,\n"
+      "\t\"http_use_extra_http_query\":\tfalse,\n"
+      "\t\"http_use_extra_http_headers\":\tfalse,\n"
+      "\t\"use_http_stat\":\ttrue,\n"
+      "\t\"http_stat_url\":\t\"https://my_server.com/status\",\n"
+      "\t\"http_stat_user\":\t\"stat_user\",\n"
+      "\t\"http_stat_pass\":\t\"stat_pass\",\n"
+      "\t\"http_stat_use_ssl_client_cert\":\tfalse,\n"
+      "\t\"http_stat_use_ssl_server_cert\":\tfalse,\n"
+      "\t\"use_mqtt\":\ttrue,\n"
+      "\t\"mqtt_disable_retained_messages\":\ttrue,\n"
+      "\t\"mqtt_transport\":\t\"SSL\",\n"
+      "\t\"mqtt_data_format\":\t\"ruuvi_decoded\",\n"
+      "\t\"mqtt_server\":\t\"mqtt.my_server.com\",\n"
+      "\t\"MQTT_PORT\":\t8883,\n"
+      "\t\"mqtt_sending_interval\":\t12,\n"
+      "\t\"mqtt_prefix\":\t\"my_prefix/\",\n"
+      "\t\"mqtt_client_id\":\t\"my_client\",\n"
+      "\t\"mqtt_user\":\t\"mqtt_user1\",\n"
+      "\t\"mqtt_pass\":\t\"mqtt_pass1\",\n"
+      "\t\"mqtt_use_ssl_client_cert\":\tfalse,\n"
+      "\t\"mqtt_use_ssl_server_cert\":\tfalse,\n"
+      "\t\"lan_auth_type\":\t\"lan_auth_ruuvi\",\n"
+      "\t\"lan_auth_user\":\t\"Admin\",\n"
+      "\t\"lan_auth_pass\":\t\"non_default_pass\",\n"
+      "\t\"lan_auth_api_key\":\t\"api_key_ro\",\n"
+      "\t\"lan_auth_api_key_rw\":\t\"api_key_rw\",\n"
+      "\t\"auto_update_cycle\":\t\"beta\",\n"
+      "\t\"auto_update_weekdays_bitmask\":\t63,\n"
+      "\t\"auto_update_interval_from\":\t2,\n"
+      "\t\"auto_update_interval_to\":\t20,\n"
+      "\t\"auto_update_tz_offset_hours\":\t-5,\n"
+      "\t\"ntp_use\":\ttrue,\n"
+      "\t\"ntp_use_dhcp\":\tfalse,\n"
+      "\t\"ntp_server1\":\t\"ntp1.my_server.com\",\n"
+      "\t\"ntp_server1\":\t\"duplicated_key_is_ignored\",\n"
+      "\t\"ntp_server2\":\t\"ntp2.my_server.com\",\n"
+      "\t\"ntp_server3\":\t\"\",\n"
+      "\t\"ntp_server4\":\t\"\",\n"
+      "\t\"company_id\":\t1280,\n"
+      "\t\"company_use_filtering\":\tfalse,\n"
+      "\t\"scan_coded_phy\":\ttrue,\n"
+      "\t\"scan_1mbit_phy\":\ttrue,\n"
+      "\t\"scan_2mbit_phy\":\tfalse,\n"
+      "\t\"scan_channel_37\":\ttrue,\n"
+      "\t\"scan_channel_38\":\tfalse,\n"
+      "\t\"scan_channel_39\":\ttrue,\n"
+      "\t\"scan_default\":\tfalse,\n"
+      "\t\"scan_filter_allow_listed\":\ttrue,\n"
+      "\t\"scan_filter_list\":\t[\"AA:BB:CC:11:22:33\", \"AA:BB:CC:44:55:66\"],\n"
+      "\t\"coordinates\":\t\"60.1699, 24.9384\",\n"
+      "\t\"fw_update_url\":\t\"https://my_server.com/firmwareupdate\",\n"
+      "\t\"unknown_number\":\t-1.25e+3,\n"
+      "\t\"unknown_null\":\tnull\n"
+      "}\n";
+
+static bool
+gw_cfg_json_stream_parse_by_chunks(const string& json, const size_t chunk_size, gw_cfg_t* const p_gw_cfg)
+{
+    gw_cfg_json_stream_t* p_stream = gw_cfg_json_stream_create();
+    assert(nullptr != p_stream);
+    for (size_t offset = 0; offset < json.size(); offset += chunk_size)
+    {
+        (void)gw_cfg_json_stream_feed(p_stream, &json[offset], std::min(chunk_size, json.size() - offset));
+    }
+    const bool res = gw_cfg_json_stream_parse(p_stream, "my.json", nullptr, p_gw_cfg);
+    gw_cfg_json_stream_delete(&p_stream);
+    assert(nullptr == p_stream);
+    return res;
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_stream_parse_equal_to_gw_cfg_json_parse) // NOLINT
+{
+    const string   json(g_gw_cfg_json_stream_test_json);
+    const gw_cfg_t gw_cfg_base = get_gateway_config_default();
+
+    gw_cfg_t gw_cfg1;
+    memcpy(&gw_cfg1, &gw_cfg_base, sizeof(gw_cfg1));
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, json.c_str(), &gw_cfg1));
+    ASSERT_EQ(string("mqtt.my_server.com"), gw_cfg1.ruuvi_cfg.mqtt.mqtt_server.buf);
+    ASSERT_EQ(8883, gw_cfg1.ruuvi_cfg.mqtt.mqtt_port);
+    ASSERT_EQ(string("ntp1.my_server.com"), gw_cfg1.ruuvi_cfg.ntp.ntp_server1.buf);
+    ASSERT_EQ(2U, gw_cfg1.ruuvi_cfg.scan_filter.scan_filter_length);
+    ASSERT_EQ(string("my_wifi"), string((const char*)gw_cfg1.wifi_cfg.sta.wifi_config_sta.ssid));
+    ASSERT_EQ(7, gw_cfg1.wifi_cfg.ap.wifi_config_ap.channel);
+
+    for (const size_t chunk_size : { 1U, 2U, 7U, 64U, 1000U, 100000U })
+    {
+        gw_cfg_t gw_cfg2;
+        memcpy(&gw_cfg2, &gw_cfg_base, sizeof(gw_cfg2));
+        ASSERT_TRUE(gw_cfg_json_stream_parse_by_chunks(json, chunk_size, &gw_cfg2)) << "chunk_size=" << chunk_size;
+        ASSERT_EQ(0, memcmp(&gw_cfg1, &gw_cfg2, sizeof(gw_cfg1))) << "chunk_size=" << chunk_size;
+    }
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_stream_parse_drops_unknown_values) // NOLINT
+{
+    const string big_str(100000, 'x');
+    const string json = string("{\"unknown_big_str\": \"") + big_str + "\", \"unknown_big_obj\": {\"" + big_str
+                        + "\": [\"" + big_str + "\"]}, \"remote_cfg_use\": true, \"mqtt_server\": \"" + big_str
+                        + "\", \"coordinates\": \"\\u00b0\\ud83d\\ude00\\n\\\"\"}";
+
+    const gw_cfg_t gw_cfg_base = get_gateway_config_default();
+    gw_cfg_t       gw_cfg1;
+    memcpy(&gw_cfg1, &gw_cfg_base, sizeof(gw_cfg1));
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, json.c_str(), &gw_cfg1));
+    ASSERT_TRUE(gw_cfg1.ruuvi_cfg.remote.use_remote_cfg);
+    ASSERT_EQ(string("\xc2\xb0\xf0\x9f\x98\x80\n\""), gw_cfg1.ruuvi_cfg.coordinates.buf);
+
+    gw_cfg_t gw_cfg2;
+    memcpy(&gw_cfg2, &gw_cfg_base, sizeof(gw_cfg2));
+    ASSERT_TRUE(gw_cfg_json_stream_parse_by_chunks(json, 1500, &gw_cfg2));
+    ASSERT_EQ(0, memcmp(&gw_cfg1, &gw_cfg2, sizeof(gw_cfg1)));
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+static string
+gw_cfg_json_stream_gen_json_with_scan_filter_list(const uint32_t num_macs)
+{
+    string json = "{\"scan_filter_allow_listed\": true, \"scan_filter_list\": [";
+    for (uint32_t i = 0; i < num_macs; ++i)
+    {
+        char mac_str[32];
+        (void)snprintf(
+            mac_str,
+            sizeof(mac_str),
+            "%s\"AA:BB:CC:DD:%02X:%02X\"",
+            (0 != i) ? ", " : "",
+            (unsigned)(i >> 8U),
+            (unsigned)(i & 0xFFU));
+        json += mac_str;
+    }
+    json += "], \"use_mqtt\": true}";
+    return json;
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_stream_parse_scan_filter_list) // NOLINT
+{
+    cJSON_Hooks hooks = {
+        .malloc_fn = &os_malloc,
+        .free_fn   = &os_free_internal,
+    };
+    cJSON_InitHooks(&hooks);
+
+    const gw_cfg_t gw_cfg_base = get_gateway_config_default();
+    const string   json        = gw_cfg_json_stream_gen_json_with_scan_filter_list(GW_CFG_MAX_NUM_SENSORS);
+
+    gw_cfg_t gw_cfg1;
+    memcpy(&gw_cfg1, &gw_cfg_base, sizeof(gw_cfg1));
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, json.c_str(), &gw_cfg1));
+    ASSERT_EQ(GW_CFG_MAX_NUM_SENSORS, gw_cfg1.ruuvi_cfg.scan_filter.scan_filter_length);
+    esp_log_wrapper_clear();
+
+    for (const size_t chunk_size : { 1U, 5U, 64U, 100000U })
+    {
+        gw_cfg_t gw_cfg2;
+        memcpy(&gw_cfg2, &gw_cfg_base, sizeof(gw_cfg2));
+        ASSERT_TRUE(gw_cfg_json_stream_parse_by_chunks(json, chunk_size, &gw_cfg2)) << "chunk_size=" << chunk_size;
+        ASSERT_EQ(0, memcmp(&gw_cfg1, &gw_cfg2, sizeof(gw_cfg1))) << "chunk_size=" << chunk_size;
+        esp_log_wrapper_clear();
+    }
+
+    // The items of 'scan_filter_list' are converted on the fly, so the number of allocations does not depend on them
+    gw_cfg_t gw_cfg3;
+    memcpy(&gw_cfg3, &gw_cfg_base, sizeof(gw_cfg3));
+    this->m_malloc_cnt = 0;
+    const string json_with_one_mac = gw_cfg_json_stream_gen_json_with_scan_filter_list(1);
+    ASSERT_TRUE(gw_cfg_json_stream_parse_by_chunks(json_with_one_mac, 64, &gw_cfg3));
+    const uint32_t malloc_cnt_with_one_mac = this->m_malloc_cnt;
+    this->m_malloc_cnt                     = 0;
+    ASSERT_TRUE(gw_cfg_json_stream_parse_by_chunks(json, 64, &gw_cfg3));
+    ASSERT_EQ(malloc_cnt_with_one_mac, this->m_malloc_cnt);
+    esp_log_wrapper_clear();
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_stream_parse_scan_filter_list_invalid_items) // NOLINT
+{
+    const gw_cfg_t gw_cfg_base = get_gateway_config_default();
+    const string   json("{\"scan_filter_list\": [\"AA:BB:CC:11:22:33\", \"invalid\", 123, {\"a\": 1}, "
+                      "\"AA:BB:CC:44:55:66\"], \"scan_filter_list\": [\"AA:BB:CC:77:88:99\"]}");
+
+    gw_cfg_t gw_cfg1;
+    memcpy(&gw_cfg1, &gw_cfg_base, sizeof(gw_cfg1));
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, json.c_str(), &gw_cfg1));
+    ASSERT_EQ(5U, gw_cfg1.ruuvi_cfg.scan_filter.scan_filter_length);
+    esp_log_wrapper_clear();
+
+    gw_cfg_t gw_cfg2;
+    memcpy(&gw_cfg2, &gw_cfg_base, sizeof(gw_cfg2));
+    ASSERT_TRUE(gw_cfg_json_stream_parse_by_chunks(json, 3, &gw_cfg2));
+    ASSERT_EQ(0, memcmp(&gw_cfg1, &gw_cfg2, sizeof(gw_cfg1)));
+    esp_log_wrapper_clear();
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_stream_parse_invalid) // NOLINT
+{
+    const gw_cfg_t gw_cfg_base = get_gateway_config_default();
+    gw_cfg_t       gw_cfg;
+    memcpy(&gw_cfg, &gw_cfg_base, sizeof(gw_cfg));
+
+    ASSERT_FALSE(gw_cfg_json_stream_parse_by_chunks(string(""), 1, &gw_cfg));
+    TEST_CHECK_LOG_RECORD(ESP_LOG_WARN, "my.json is empty");
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+
+    ASSERT_FALSE(gw_cfg_json_stream_parse_by_chunks(string("{\"use_mqtt\": true"), 1, &gw_cfg));
+    TEST_CHECK_LOG_RECORD(ESP_LOG_ERROR, "Failed to parse my.json: unexpected end of data at offset 17");
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+
+    ASSERT_FALSE(gw_cfg_json_stream_parse_by_chunks(string("{\"use_mqtt\": tru}"), 4, &gw_cfg));
+    TEST_CHECK_LOG_RECORD(ESP_LOG_ERROR, "Failed to parse JSON at offset 16");
+    TEST_CHECK_LOG_RECORD(ESP_LOG_ERROR, "Failed to parse my.json: invalid JSON at offset 16");
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+
+    ASSERT_FALSE(gw_cfg_json_stream_parse_by_chunks(string("[{\"use_mqtt\": true}]"), 4, &gw_cfg));
+    TEST_CHECK_LOG_RECORD(ESP_LOG_ERROR, "Failed to parse JSON at offset 0");
+    TEST_CHECK_LOG_RECORD(ESP_LOG_ERROR, "Failed to parse my.json: invalid JSON at offset 0");
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+
+    ASSERT_EQ(0, memcmp(&gw_cfg_base, &gw_cfg, sizeof(gw_cfg)));
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+
+    gw_cfg_json_stream_t* p_stream = gw_cfg_json_stream_create();
+    ASSERT_NE(nullptr, p_stream);
+    ASSERT_EQ('\0', gw_cfg_json_stream_get_first_char(p_stream));
+    ASSERT_FALSE(gw_cfg_json_stream_feed(p_stream, "<html>", 6));
+    ASSERT_EQ('<', gw_cfg_json_stream_get_first_char(p_stream));
+    ASSERT_FALSE(gw_cfg_json_stream_feed(p_stream, "{}", 2));
+    TEST_CHECK_LOG_RECORD(ESP_LOG_ERROR, "Failed to parse JSON at offset 0");
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+    gw_cfg_json_stream_reset(p_stream);
+    ASSERT_EQ('\0', gw_cfg_json_stream_get_first_char(p_stream));
+    ASSERT_TRUE(gw_cfg_json_stream_feed(p_stream, "{}", 2));
+    ASSERT_EQ('{', gw_cfg_json_stream_get_first_char(p_stream));
+    gw_cfg_json_stream_delete(&p_stream);
+    ASSERT_EQ(nullptr, p_stream);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_stream_parse_malloc_failed) // NOLINT
+{
+    cJSON_Hooks hooks = {
+        .malloc_fn = &os_malloc,
+        .free_fn   = &os_free_internal,
+    };
+    cJSON_InitHooks(&hooks);
+
+    const string json(g_gw_cfg_json_stream_test_json);
+    bool         flag_success = false;
+    for (uint32_t i = 0; (i < 1000) && (!flag_success); ++i)
+    {
+        this->m_malloc_cnt             = 0;
+        this->m_malloc_fail_on_cnt     = i + 1;
+        gw_cfg_json_stream_t* p_stream = gw_cfg_json_stream_create();
+        if (nullptr != p_stream)
+        {
+            const bool res_feed = gw_cfg_json_stream_feed(p_stream, json.c_str(), json.size());
+            gw_cfg_t   gw_cfg2  = get_gateway_config_default();
+            flag_success        = gw_cfg_json_stream_parse(p_stream, "my.json", nullptr, &gw_cfg2);
+            ASSERT_EQ(res_feed, flag_success) << "Failed at cycle number: " << i;
+            gw_cfg_json_stream_delete(&p_stream);
+        }
+        ASSERT_TRUE(g_pTestClass->m_mem_alloc_trace.is_empty()) << "Failed at cycle number: " << i;
+        esp_log_wrapper_clear();
+    }
+    ASSERT_TRUE(flag_success);
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_stream_parse_fuzz) // NOLINT
+{
+    const string   json_orig(g_gw_cfg_json_stream_test_json);
+    const gw_cfg_t gw_cfg_base = get_gateway_config_default();
+    const string   alphabet("{}[]\":,0123456789-+.eEtrufalsn \t\\");
+    std::mt19937   rnd(0x5EED); // NOLINT - deterministic sequence is required for reproducibility
+    uint32_t       cnt_valid = 0;
+
+    for (uint32_t i = 0; i < 3000; ++i)
+    {
+        string         json          = json_orig;
+        const uint32_t num_mutations = 1 + (rnd() % 3);
+        for (uint32_t j = 0; j < num_mutations; ++j)
+        {
+            // Keep the first '{', the tokenizer requires the root to be an object, cJSON does not
+            const size_t pos = 1 + (rnd() % (json.size() - 1));
+            const char   ch  = alphabet[rnd() % alphabet.size()];
+            switch (rnd() % 3)
+            {
+                case 0:
+                    json[pos] = ch;
+                    break;
+                case 1:
+                    json.insert(pos, 1, ch);
+                    break;
+                default:
+                    json.erase(pos, 1);
+                    break;
+            }
+        }
+        gw_cfg_t gw_cfg1;
+        memcpy(&gw_cfg1, &gw_cfg_base, sizeof(gw_cfg1));
+        gw_cfg_t gw_cfg2;
+        memcpy(&gw_cfg2, &gw_cfg_base, sizeof(gw_cfg2));
+
+        const bool res1 = gw_cfg_json_parse("my.json", nullptr, json.c_str(), &gw_cfg1);
+        const bool res2 = gw_cfg_json_stream_parse_by_chunks(json, 1 + (rnd() % 64), &gw_cfg2);
+        if (res2)
+        {
+            ASSERT_TRUE(res1) << json;
+            ASSERT_EQ(0, memcmp(&gw_cfg1, &gw_cfg2, sizeof(gw_cfg1))) << json;
+            cnt_valid += 1;
+        }
+        else if (string::npos == json.find('\\'))
+        {
+            // Malformed unicode escapes are accepted by cJSON, but rejected by the tokenizer
+            ASSERT_FALSE(res1) << json;
+        }
+        else
+        {
+            // MISRA C:2012, 15.7 - All if...else if constructs shall be terminated with an else statement
+        }
+        esp_log_wrapper_clear();
+        ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+    }
+    ASSERT_NE(0, cnt_valid);
+}
+
+static std::vector<string>
+gw_cfg_json_generate_all_sections(const gw_cfg_t* const p_gw_cfg)
+{
+    std::vector<string> sections;
+    for (uint32_t i = 0; i < GW_CFG_JSON_SECTION_NUM; ++i)
+    {
+        cjson_wrap_str_t json_str = cjson_wrap_str_null();
+        assert(gw_cfg_json_generate_section_for_saving(p_gw_cfg, (gw_cfg_json_section_e)i, &json_str));
+        sections.emplace_back(json_str.p_str);
+        cjson_wrap_free_json_str(&json_str);
+    }
+    return sections;
+}
+
+static bool
+gw_cfg_json_parse_all_sections(const std::vector<string>& sections, gw_cfg_t* const p_gw_cfg)
+{
+    std::vector<const char*> arr_of_json_str;
+    for (const auto& section : sections)
+    {
+        arr_of_json_str.push_back(section.empty() ? nullptr : section.c_str());
+    }
+    return gw_cfg_json_parse_sections("NVS", nullptr, arr_of_json_str.data(), arr_of_json_str.size(), p_gw_cfg);
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_sections_equal_to_gw_cfg_json_parse) // NOLINT
+{
+    const gw_cfg_t gw_cfg_base = get_gateway_config_default();
+
+    gw_cfg_t gw_cfg1;
+    memcpy(&gw_cfg1, &gw_cfg_base, sizeof(gw_cfg1));
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, g_gw_cfg_json_stream_test_json, &gw_cfg1));
+
+    cjson_wrap_str_t json_str = cjson_wrap_str_null();
+    ASSERT_TRUE(gw_cfg_json_generate_for_saving(&gw_cfg1, &json_str));
+    gw_cfg_t gw_cfg2;
+    memcpy(&gw_cfg2, &gw_cfg_base, sizeof(gw_cfg2));
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, json_str.p_str, &gw_cfg2));
+    cjson_wrap_free_json_str(&json_str);
+
+    const std::vector<string> sections = gw_cfg_json_generate_all_sections(&gw_cfg1);
+    ASSERT_EQ(static_cast<size_t>(GW_CFG_JSON_SECTION_NUM), sections.size());
+    gw_cfg_t gw_cfg3;
+    memcpy(&gw_cfg3, &gw_cfg_base, sizeof(gw_cfg3));
+    ASSERT_TRUE(gw_cfg_json_parse_all_sections(sections, &gw_cfg3));
+
+    ASSERT_EQ(0, memcmp(&gw_cfg2, &gw_cfg3, sizeof(gw_cfg2)));
+    esp_log_wrapper_clear();
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_sections_only_modified_section_is_changed) // NOLINT
+{
+    gw_cfg_t gw_cfg1 = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, g_gw_cfg_json_stream_test_json, &gw_cfg1));
+    const std::vector<string> sections1 = gw_cfg_json_generate_all_sections(&gw_cfg1);
+
+    gw_cfg_t gw_cfg2;
+    memcpy(&gw_cfg2, &gw_cfg1, sizeof(gw_cfg2));
+    gw_cfg2.ruuvi_cfg.scan.scan_channel_38 = !gw_cfg2.ruuvi_cfg.scan.scan_channel_38;
+    const std::vector<string> sections2 = gw_cfg_json_generate_all_sections(&gw_cfg2);
+
+    for (uint32_t i = 0; i < GW_CFG_JSON_SECTION_NUM; ++i)
+    {
+        if (GW_CFG_JSON_SECTION_SCAN == i)
+        {
+            ASSERT_NE(sections1[i], sections2[i]);
+        }
+        else
+        {
+            ASSERT_EQ(sections1[i], sections2[i]) << "section: " << i;
+        }
+    }
+    esp_log_wrapper_clear();
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_sections_missing_section_keeps_default) // NOLINT
+{
+    const gw_cfg_t gw_cfg_default = get_gateway_config_default();
+    gw_cfg_t       gw_cfg1        = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, g_gw_cfg_json_stream_test_json, &gw_cfg1));
+    ASSERT_NE(string(gw_cfg_default.ruuvi_cfg.mqtt.mqtt_server.buf), string(gw_cfg1.ruuvi_cfg.mqtt.mqtt_server.buf));
+
+    std::vector<string> sections       = gw_cfg_json_generate_all_sections(&gw_cfg1);
+    sections[GW_CFG_JSON_SECTION_MQTT] = string();
+    gw_cfg_t gw_cfg2                   = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse_all_sections(sections, &gw_cfg2));
+
+    ASSERT_EQ(0, memcmp(&gw_cfg_default.ruuvi_cfg.mqtt, &gw_cfg2.ruuvi_cfg.mqtt, sizeof(gw_cfg2.ruuvi_cfg.mqtt)));
+    ASSERT_EQ(0, memcmp(&gw_cfg1.ruuvi_cfg.ntp, &gw_cfg2.ruuvi_cfg.ntp, sizeof(gw_cfg2.ruuvi_cfg.ntp)));
+    ASSERT_EQ(0, memcmp(&gw_cfg1.ruuvi_cfg.scan, &gw_cfg2.ruuvi_cfg.scan, sizeof(gw_cfg2.ruuvi_cfg.scan)));
+
+    esp_log_wrapper_clear();
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_sections_corrupted_section_keeps_default) // NOLINT
+{
+    const gw_cfg_t gw_cfg_default = get_gateway_config_default();
+    gw_cfg_t       gw_cfg1        = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, g_gw_cfg_json_stream_test_json, &gw_cfg1));
+
+    std::vector<string> sections       = gw_cfg_json_generate_all_sections(&gw_cfg1);
+    sections[GW_CFG_JSON_SECTION_MQTT] = string("{\"mqtt_server\": ");
+    gw_cfg_t gw_cfg2                   = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse_all_sections(sections, &gw_cfg2));
+
+    ASSERT_EQ(0, memcmp(&gw_cfg_default.ruuvi_cfg.mqtt, &gw_cfg2.ruuvi_cfg.mqtt, sizeof(gw_cfg2.ruuvi_cfg.mqtt)));
+    ASSERT_EQ(0, memcmp(&gw_cfg1.ruuvi_cfg.ntp, &gw_cfg2.ruuvi_cfg.ntp, sizeof(gw_cfg2.ruuvi_cfg.ntp)));
+    ASSERT_EQ(0, memcmp(&gw_cfg1.ruuvi_cfg.scan, &gw_cfg2.ruuvi_cfg.scan, sizeof(gw_cfg2.ruuvi_cfg.scan)));
+    ASSERT_EQ(0, memcmp(&gw_cfg1.eth_cfg, &gw_cfg2.eth_cfg, sizeof(gw_cfg2.eth_cfg)));
+    esp_log_wrapper_clear();
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestGwCfgJson, gw_cfg_json_sections_legacy_json_read_after_sectioned_save) // NOLINT
+{
+    // settings_save_to_flash writes the sections and keeps the legacy JSON key up to date,
+    // the firmware without the sections support reads the legacy key with gw_cfg_json_parse.
+    gw_cfg_t gw_cfg1 = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse("my.json", nullptr, g_gw_cfg_json_stream_test_json, &gw_cfg1));
+    gw_cfg1.ruuvi_cfg.scan.scan_channel_38 = !gw_cfg1.ruuvi_cfg.scan.scan_channel_38;
+
+    const std::vector<string> sections        = gw_cfg_json_generate_all_sections(&gw_cfg1);
+    gw_cfg_t                  gw_cfg_sections = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse_all_sections(sections, &gw_cfg_sections));
+
+    cjson_wrap_str_t json_str = cjson_wrap_str_null();
+    ASSERT_TRUE(gw_cfg_json_generate_for_saving(&gw_cfg1, &json_str));
+    gw_cfg_t gw_cfg_legacy = get_gateway_config_default();
+    ASSERT_TRUE(gw_cfg_json_parse("NVS", nullptr, json_str.p_str, &gw_cfg_legacy));
+    cjson_wrap_free_json_str(&json_str);
+
+    ASSERT_EQ(gw_cfg1.ruuvi_cfg.scan.scan_channel_38, gw_cfg_legacy.ruuvi_cfg.scan.scan_channel_38);
+    ASSERT_EQ(0, memcmp(&gw_cfg1.wifi_cfg.sta, &gw_cfg_legacy.wifi_cfg.sta, sizeof(gw_cfg_legacy.wifi_cfg.sta)));
+    ASSERT_EQ(0, memcmp(&gw_cfg1.eth_cfg, &gw_cfg_legacy.eth_cfg, sizeof(gw_cfg_legacy.eth_cfg)));
+    ASSERT_EQ(0, memcmp(&gw_cfg_sections, &gw_cfg_legacy, sizeof(gw_cfg_legacy)));
+    esp_log_wrapper_clear();
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
@@ -135,6 +135,33 @@ TEST_F(TestHMAC_SHA256, test_hmac_sha256_in_bin_buf) // NOLINT
     str_buf_free_buf(&hmac_sha256_str);
 }
 
+TEST_F(TestHMAC_SHA256, test_hmac_sha256_bin_msg) // NOLINT
+{
+    ASSERT_TRUE(hmac_sha256_set_key_for_http_ruuvi("key"));
+    ASSERT_TRUE(hmac_sha256_set_key_for_http_custom("key"));
+    const string msg = "The quick brown fox jumps over the lazy dog";
+
+    hmac_sha256_t hmac_sha256_ruuvi = { 0 };
+    ASSERT_TRUE(hmac_sha256_calc_bin_for_http_ruuvi(
+        reinterpret_cast<const uint8_t*>(msg.c_str()),
+        msg.length(),
+        &hmac_sha256_ruuvi));
+    const std::vector<uint8_t> exp_hmac_sha256 = {
+        0xf7, 0xbc, 0x83, 0xf4, 0x30, 0x53, 0x84, 0x24, 0xb1, 0x32, 0x98, 0xe6, 0xaa, 0x6f, 0xb1, 0x43,
+        0xef, 0x4d, 0x59, 0xa1, 0x49, 0x46, 0x17, 0x59, 0x97, 0x47, 0x9d, 0xbc, 0x2d, 0x1a, 0x3c, 0xd8,
+    };
+    ASSERT_EQ(exp_hmac_sha256, std::vector<uint8_t>(&hmac_sha256_ruuvi.buf[0], &hmac_sha256_ruuvi.buf[32]));
+
+    // The message may contain '\0'
+    const uint8_t msg_bin[] = { 0xA1U, 0x00U, 0x42U, 0x00U, 0xFFU };
+
+    hmac_sha256_t hmac_sha256_custom1 = { 0 };
+    ASSERT_TRUE(hmac_sha256_calc_bin_for_http_custom(msg_bin, sizeof(msg_bin), &hmac_sha256_custom1));
+    hmac_sha256_t hmac_sha256_custom2 = { 0 };
+    ASSERT_TRUE(hmac_sha256_calc_bin_for_http_custom(msg_bin, 2, &hmac_sha256_custom2));
+    ASSERT_NE(0, memcmp(hmac_sha256_custom1.buf, hmac_sha256_custom2.buf, sizeof(hmac_sha256_custom1.buf)));
+}
+
 TEST_F(TestHMAC_SHA256, test1_hmac_sha256_with_device_id_as_encryption_key) // NOLINT
 {
     const nrf52_device_id_str_t hmac_key = { "40:98:A7:78:58:1A:E1:38" };
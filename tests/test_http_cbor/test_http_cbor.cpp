@@ -0,0 +1,468 @@
+/**
+ * @file test_http_cbor.cpp
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_cbor.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+#include <vector>
+#include "os_malloc.h"
+#include "ruuvi_endpoint_ca_uart.h"
+
+using namespace std;
+
+class TestHttpCbor;
+
+static TestHttpCbor* g_pTestClass;
+
+struct adv_table_snapshot_t
+{
+    vector<adv_report_t> advs;
+    vector<bool>         is_valid;
+    bool                 flag_invalidate_after_read;
+};
+
+/*** Google-test class implementation
+ * *********************************************************************************/
+
+class TestHttpCbor : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        this->m_malloc_cnt         = 0;
+        this->m_malloc_fail_on_cnt = 0;
+        this->m_num_allocated      = 0;
+        this->m_snapshot_get_adv_cnt.clear();
+        g_pTestClass = this;
+    }
+
+    void
+    TearDown() override
+    {
+        g_pTestClass = nullptr;
+    }
+
+public:
+    TestHttpCbor();
+
+    ~TestHttpCbor() override;
+
+    uint32_t m_malloc_cnt {};
+    uint32_t m_malloc_fail_on_cnt {};
+    uint32_t m_num_allocated {};
+
+    vector<uint32_t> m_snapshot_get_adv_cnt {};
+};
+
+TestHttpCbor::TestHttpCbor()
+    : Test()
+{
+}
+
+TestHttpCbor::~TestHttpCbor() = default;
+
+extern "C" {
+
+void*
+os_malloc(const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    g_pTestClass->m_num_allocated += 1;
+    return malloc(size);
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    assert(nullptr != g_pTestClass);
+    assert(0 != g_pTestClass->m_num_allocated);
+    g_pTestClass->m_num_allocated -= 1;
+    free(p_mem);
+}
+
+num_of_advs_t
+adv_table_snapshot_get_num_of_advs(const adv_table_snapshot_t* const p_snapshot)
+{
+    if (nullptr == p_snapshot)
+    {
+        return 0;
+    }
+    return static_cast<num_of_advs_t>(p_snapshot->advs.size());
+}
+
+bool
+adv_table_snapshot_get_adv(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    adv_report_t* const               p_adv)
+{
+    assert(nullptr != g_pTestClass);
+    if (g_pTestClass->m_snapshot_get_adv_cnt.size() <= idx)
+    {
+        g_pTestClass->m_snapshot_get_adv_cnt.resize(idx + 1);
+    }
+    g_pTestClass->m_snapshot_get_adv_cnt[idx] += 1;
+    if (!p_snapshot->is_valid.at(idx))
+    {
+        return false;
+    }
+    if (p_snapshot->flag_invalidate_after_read)
+    {
+        // Simulate adv_table_clear: the adv becomes unreadable after it has been read once
+        const_cast<adv_table_snapshot_t*>(p_snapshot)->is_valid.at(idx) = false;
+    }
+    *p_adv = p_snapshot->advs.at(idx);
+    return true;
+}
+
+} // extern "C"
+
+/**
+ * @brief Convert CBOR to the diagnostic notation (RFC 8949, section 8) - only the subset used by http_cbor.
+ */
+static string
+cbor_to_diag(const uint8_t* const p_buf, const size_t len, size_t* const p_offset)
+{
+    if (*p_offset >= len)
+    {
+        return "<EOF>";
+    }
+    const uint8_t initial_byte = p_buf[*p_offset];
+    *p_offset += 1;
+    const uint8_t major_type = initial_byte >> 5U;
+    const uint8_t add_info   = initial_byte & 0x1FU;
+    uint64_t      val        = add_info;
+    if (add_info >= 24U)
+    {
+        const size_t num_bytes = 1U << (add_info - 24U);
+        val                    = 0;
+        for (size_t i = 0; i < num_bytes; ++i)
+        {
+            val = (val << 8U) | p_buf[*p_offset];
+            *p_offset += 1;
+        }
+    }
+    string res;
+    switch (major_type)
+    {
+        case 0:
+            return to_string(val);
+        case 1:
+            return string("-") + to_string(val + 1);
+        case 2:
+            res = "h'";
+            for (uint64_t i = 0; i < val; ++i)
+            {
+                char tmp[3];
+                snprintf(tmp, sizeof(tmp), "%02X", p_buf[*p_offset]);
+                res += tmp;
+                *p_offset += 1;
+            }
+            return res + "'";
+        case 3:
+            res = string("\"") + string(reinterpret_cast<const char*>(&p_buf[*p_offset]), val) + "\"";
+            *p_offset += val;
+            return res;
+        case 5:
+            res = "{";
+            for (uint64_t i = 0; i < val; ++i)
+            {
+                if (0 != i)
+                {
+                    res += ", ";
+                }
+                res += cbor_to_diag(p_buf, len, p_offset);
+                res += ": ";
+                res += cbor_to_diag(p_buf, len, p_offset);
+            }
+            return res + "}";
+        default:
+            break;
+    }
+    return "<unsupported>";
+}
+
+static string
+cbor_buf_to_diag(const http_cbor_buf_t* const p_cbor_buf)
+{
+    size_t       offset = 0;
+    const string res    = cbor_to_diag(p_cbor_buf->p_buf, p_cbor_buf->len, &offset);
+    if (offset != p_cbor_buf->len)
+    {
+        return res + " <extra data>";
+    }
+    return res;
+}
+
+static adv_report_t
+make_adv(const uint8_t mac_last_byte, const time_t timestamp)
+{
+    adv_report_t adv = {
+        .timestamp       = timestamp,
+        .samples_counter = 0,
+        .tag_mac         = { 0xAAU, 0xBBU, 0xCCU, 0xDDU, 0xEEU, mac_last_byte },
+        .rssi            = -70,
+        .primary_phy     = RE_CA_UART_BLE_PHY_1MBPS,
+        .secondary_phy   = RE_CA_UART_BLE_PHY_NOT_SET,
+        .ch_index        = 37,
+        .is_coded_phy    = false,
+        .tx_power        = RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID,
+        .data_len        = 3,
+        .data_buf        = { 0x02U, 0x01U, mac_last_byte },
+    };
+    return adv;
+}
+
+/*** Unit-Tests
+ * *******************************************************************************************************/
+
+TEST_F(TestHttpCbor, test_empty) // NOLINT
+{
+    const mac_address_str_t              gw_mac   = { "AA:CC:EE:00:11:22" };
+    char                                 coords[] = "170.252609, 59.436962";
+    const http_cbor_create_advs_params_t params   = {
+          .flag_use_timestamps = true,
+          .cur_time            = 1612358920,
+          .flag_use_nonce      = true,
+          .nonce               = 2,
+          .p_mac_addr          = &gw_mac,
+          .coordinates_str_buf = str_buf_init(coords, sizeof(coords)),
+    };
+    http_cbor_buf_t cbor_buf = {};
+    ASSERT_TRUE(http_cbor_create_advs(nullptr, &params, &cbor_buf));
+    ASSERT_EQ(
+        string("{\"data\": {"
+               "\"coordinates\": \"170.252609, 59.436962\", "
+               "\"timestamp\": 1612358920, "
+               "\"nonce\": 2, "
+               "\"gw_mac\": \"AA:CC:EE:00:11:22\", "
+               "\"tags\": {}}}"),
+        cbor_buf_to_diag(&cbor_buf));
+    // Check the exact encoding of the header: map(1), text(4) "data", map(5), ...
+    ASSERT_EQ(0xA1U, cbor_buf.p_buf[0]);
+    ASSERT_EQ(0x64U, cbor_buf.p_buf[1]);
+    ASSERT_EQ(0xA5U, cbor_buf.p_buf[6]);
+    // The last item is an empty map of tags
+    ASSERT_EQ(0xA0U, cbor_buf.p_buf[cbor_buf.len - 1]);
+    ASSERT_EQ(1, this->m_num_allocated);
+    http_cbor_buf_free(&cbor_buf);
+    ASSERT_EQ(nullptr, cbor_buf.p_buf);
+    ASSERT_EQ(0, cbor_buf.len);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestHttpCbor, test_counters_without_nonce) // NOLINT
+{
+    adv_report_table_t reports     = {};
+    reports.num_of_advs            = 2;
+    reports.table[0]               = make_adv(0x01U, 5);
+    reports.table[1]               = make_adv(0x02U, 70000);
+    reports.table[1].rssi          = 10;
+    reports.table[1].tx_power      = -4;
+    reports.table[1].ch_index      = 12;
+    reports.table[1].data_len      = 0;
+    reports.table[1].secondary_phy = RE_CA_UART_BLE_PHY_CODED;
+
+    const mac_address_str_t              gw_mac = { "AA:CC:EE:00:11:22" };
+    const http_cbor_create_advs_params_t params = {
+        .flag_use_timestamps = false,
+        .cur_time            = 1612358920,
+        .flag_use_nonce      = false,
+        .nonce               = 0,
+        .p_mac_addr          = &gw_mac,
+        .coordinates_str_buf = str_buf_init_null(),
+    };
+    http_cbor_buf_t cbor_buf = {};
+    ASSERT_TRUE(http_cbor_create_advs(&reports, &params, &cbor_buf));
+    ASSERT_EQ(
+        string("{\"data\": {"
+               "\"coordinates\": \"\", "
+               "\"gw_mac\": \"AA:CC:EE:00:11:22\", "
+               "\"tags\": {"
+               "\"AA:BB:CC:DD:EE:01\": {\"rssi\": -70, \"counter\": 5, \"ble_phy\": \"1M\", \"ble_chan\": 37, "
+               "\"data\": h'020101'}, "
+               "\"AA:BB:CC:DD:EE:02\": {\"rssi\": 10, \"counter\": 70000, \"ble_phy\": \"Coded\", \"ble_chan\": 12, "
+               "\"ble_tx_power\": -4, \"data\": h''}"
+               "}}}"),
+        cbor_buf_to_diag(&cbor_buf));
+    http_cbor_buf_free(&cbor_buf);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestHttpCbor, test_snapshot_skips_invalid_advs) // NOLINT
+{
+    adv_table_snapshot_t snapshot = {};
+    snapshot.advs.push_back(make_adv(0x01U, 1612358900));
+    snapshot.is_valid.push_back(true);
+    snapshot.advs.push_back(make_adv(0x02U, 1612358901));
+    snapshot.is_valid.push_back(false);
+    snapshot.advs.push_back(make_adv(0x03U, 1612358902));
+    snapshot.is_valid.push_back(true);
+    snapshot.advs[2].secondary_phy = RE_CA_UART_BLE_PHY_2MBPS;
+
+    const mac_address_str_t              gw_mac   = { "AA:CC:EE:00:11:22" };
+    char                                 coords[] = "";
+    const http_cbor_create_advs_params_t params   = {
+          .flag_use_timestamps = true,
+          .cur_time            = 1612358920,
+          .flag_use_nonce      = true,
+          .nonce               = 0x12345678,
+          .p_mac_addr          = &gw_mac,
+          .coordinates_str_buf = str_buf_init(coords, sizeof(coords)),
+    };
+    http_cbor_buf_t cbor_buf = {};
+    ASSERT_TRUE(http_cbor_create_advs_from_snapshot(&snapshot, &params, &cbor_buf));
+    ASSERT_EQ(
+        string("{\"data\": {"
+               "\"coordinates\": \"\", "
+               "\"timestamp\": 1612358920, "
+               "\"nonce\": 305419896, "
+               "\"gw_mac\": \"AA:CC:EE:00:11:22\", "
+               "\"tags\": {"
+               "\"AA:BB:CC:DD:EE:01\": {\"rssi\": -70, \"timestamp\": 1612358900, \"ble_phy\": \"1M\", "
+               "\"ble_chan\": 37, \"data\": h'020101'}, "
+               "\"AA:BB:CC:DD:EE:03\": {\"rssi\": -70, \"timestamp\": 1612358902, \"ble_phy\": \"2M\", "
+               "\"ble_chan\": 37, \"data\": h'020103'}"
+               "}}}"),
+        cbor_buf_to_diag(&cbor_buf));
+    ASSERT_EQ(vector<uint32_t>({ 1, 1, 1 }), this->m_snapshot_get_adv_cnt);
+    http_cbor_buf_free(&cbor_buf);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestHttpCbor, test_snapshot_adv_becomes_unreadable_while_encoding) // NOLINT
+{
+    adv_table_snapshot_t snapshot = {};
+    snapshot.advs.push_back(make_adv(0x01U, 1612358900));
+    snapshot.is_valid.push_back(true);
+    snapshot.advs.push_back(make_adv(0x02U, 1612358901));
+    snapshot.is_valid.push_back(true);
+    snapshot.flag_invalidate_after_read = true;
+
+    const mac_address_str_t              gw_mac = { "AA:CC:EE:00:11:22" };
+    const http_cbor_create_advs_params_t params = {
+        .flag_use_timestamps = false,
+        .cur_time            = 0,
+        .flag_use_nonce      = false,
+        .nonce               = 0,
+        .p_mac_addr          = &gw_mac,
+        .coordinates_str_buf = str_buf_init_null(),
+    };
+    http_cbor_buf_t cbor_buf = {};
+    ASSERT_TRUE(http_cbor_create_advs_from_snapshot(&snapshot, &params, &cbor_buf));
+    ASSERT_EQ(
+        string("{\"data\": {"
+               "\"coordinates\": \"\", "
+               "\"gw_mac\": \"AA:CC:EE:00:11:22\", "
+               "\"tags\": {"
+               "\"AA:BB:CC:DD:EE:01\": {\"rssi\": -70, \"counter\": 1612358900, \"ble_phy\": \"1M\", "
+               "\"ble_chan\": 37, \"data\": h'020101'}, "
+               "\"AA:BB:CC:DD:EE:02\": {\"rssi\": -70, \"counter\": 1612358901, \"ble_phy\": \"1M\", "
+               "\"ble_chan\": 37, \"data\": h'020102'}"
+               "}}}"),
+        cbor_buf_to_diag(&cbor_buf));
+    ASSERT_EQ(vector<uint32_t>({ 1, 1 }), this->m_snapshot_get_adv_cnt);
+    http_cbor_buf_free(&cbor_buf);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestHttpCbor, test_integer_encoding) // NOLINT
+{
+    adv_report_table_t reports = {};
+    reports.num_of_advs        = 1;
+    reports.table[0]           = make_adv(0x01U, 23);
+    reports.table[0].ch_index  = 24;
+    reports.table[0].rssi      = -24;
+    reports.table[0].tx_power  = -25;
+
+    const mac_address_str_t              gw_mac = { "AA:CC:EE:00:11:22" };
+    const http_cbor_create_advs_params_t params = {
+        .flag_use_timestamps = false,
+        .cur_time            = 0,
+        .flag_use_nonce      = true,
+        .nonce               = 0xFFFFFFFFU,
+        .p_mac_addr          = &gw_mac,
+        .coordinates_str_buf = str_buf_init_null(),
+    };
+    http_cbor_buf_t cbor_buf = {};
+    ASSERT_TRUE(http_cbor_create_advs(&reports, &params, &cbor_buf));
+    const vector<uint8_t> data(cbor_buf.p_buf, cbor_buf.p_buf + cbor_buf.len);
+
+    const auto find_after_key = [&data](const string& key) -> vector<uint8_t> {
+        vector<uint8_t> encoded_key;
+        encoded_key.push_back(static_cast<uint8_t>(0x60U + key.size()));
+        encoded_key.insert(encoded_key.end(), key.begin(), key.end());
+        const auto it = search(data.begin(), data.end(), encoded_key.begin(), encoded_key.end());
+        if (it == data.end())
+        {
+            return {};
+        }
+        const auto it_val = it + static_cast<ptrdiff_t>(encoded_key.size());
+        return vector<uint8_t>(it_val, min(it_val + 5, data.end()));
+    };
+    ASSERT_EQ(vector<uint8_t>({ 0x1AU, 0xFFU, 0xFFU, 0xFFU, 0xFFU }), find_after_key("nonce"));
+    ASSERT_EQ(0x17U, find_after_key("counter").at(0));
+    const vector<uint8_t> ble_chan = find_after_key("ble_chan");
+    ASSERT_EQ(vector<uint8_t>({ 0x18U, 0x18U }), vector<uint8_t>(ble_chan.begin(), ble_chan.begin() + 2));
+    ASSERT_EQ(0x37U, find_after_key("rssi").at(0));
+    const vector<uint8_t> tx_power = find_after_key("ble_tx_power");
+    ASSERT_EQ(vector<uint8_t>({ 0x38U, 0x18U }), vector<uint8_t>(tx_power.begin(), tx_power.begin() + 2));
+    http_cbor_buf_free(&cbor_buf);
+}
+
+TEST_F(TestHttpCbor, test_malloc_failed) // NOLINT
+{
+    const mac_address_str_t              gw_mac = { "AA:CC:EE:00:11:22" };
+    const http_cbor_create_advs_params_t params = {
+        .flag_use_timestamps = true,
+        .cur_time            = 1612358920,
+        .flag_use_nonce      = true,
+        .nonce               = 2,
+        .p_mac_addr          = &gw_mac,
+        .coordinates_str_buf = str_buf_init_null(),
+    };
+    this->m_malloc_fail_on_cnt = 1;
+    http_cbor_buf_t cbor_buf   = {};
+    ASSERT_FALSE(http_cbor_create_advs(nullptr, &params, &cbor_buf));
+    ASSERT_EQ(nullptr, cbor_buf.p_buf);
+    ASSERT_EQ(0, cbor_buf.len);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestHttpCbor, test_snapshot_malloc_failed) // NOLINT
+{
+    adv_table_snapshot_t snapshot = {};
+    snapshot.advs.push_back(make_adv(0x01U, 1612358900));
+    snapshot.is_valid.push_back(true);
+
+    const mac_address_str_t              gw_mac = { "AA:CC:EE:00:11:22" };
+    const http_cbor_create_advs_params_t params = {
+        .flag_use_timestamps = true,
+        .cur_time            = 1612358920,
+        .flag_use_nonce      = true,
+        .nonce               = 2,
+        .p_mac_addr          = &gw_mac,
+        .coordinates_str_buf = str_buf_init_null(),
+    };
+    for (uint32_t i = 1; i <= 2; ++i)
+    {
+        this->m_malloc_cnt         = 0;
+        this->m_malloc_fail_on_cnt = i;
+        http_cbor_buf_t cbor_buf   = {};
+        ASSERT_FALSE(http_cbor_create_advs_from_snapshot(&snapshot, &params, &cbor_buf));
+        ASSERT_EQ(nullptr, cbor_buf.p_buf);
+        ASSERT_EQ(0, cbor_buf.len);
+        ASSERT_EQ(0, this->m_num_allocated);
+    }
+}
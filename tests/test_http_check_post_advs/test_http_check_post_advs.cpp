@@ -9,6 +9,8 @@
 #include "http_client_config.h"
 #include "http_stream_reader_nvs.h"
 #include "http_post_event_handler.h"
+#include "http_cbor.h"
+#include "tls_shared_buf.h"
 #include <cstring>
 #include <cstdarg>
 #include <cstdio>
@@ -82,6 +84,7 @@ protected:
         this->m_mock_esp_http_client_config_set_from_url_result = true;
         this->m_mock_http_handle_add_auth_result                = true;
         this->m_mock_json_stream_gen                            = reinterpret_cast<json_stream_gen_t*>(0xDEADBEEF);
+        this->m_mock_cbor.clear();
 
         this->m_mock_http_handle_add_auth_called = false;
         this->m_captured_auth_type               = GW_CFG_HTTP_AUTH_TYPE_NONE;
@@ -126,6 +129,7 @@ public:
     bool                     m_mock_esp_http_client_config_set_from_url_result;
     bool                     m_mock_http_handle_add_auth_result;
     json_stream_gen_t*       m_mock_json_stream_gen;
+    vector<uint8_t>          m_mock_cbor;
 
     bool                     m_mock_http_handle_add_auth_called;
     gw_cfg_http_auth_type_e  m_captured_auth_type;
@@ -498,14 +502,9 @@ ruuvi_gw_mark_app_valid_cancel_rollback(void)
     return true;
 }
 
-void
-adv_post_set_adv_post_http_action(const bool flag_post_to_ruuvi)
-{
-}
-
 json_stream_gen_t*
-http_json_create_stream_gen_advs(
-    const adv_report_table_t* const                        p_reports,
+http_json_create_stream_gen_advs_from_snapshot(
+    const adv_table_snapshot_t* const                      p_snapshot,
     const http_json_create_stream_gen_advs_params_t* const p_params)
 {
     if (nullptr != g_pTestClass)
@@ -515,6 +514,51 @@ http_json_create_stream_gen_advs(
     return nullptr;
 }
 
+bool
+http_cbor_create_advs_from_snapshot(
+    const adv_table_snapshot_t* const           p_snapshot,
+    const http_cbor_create_advs_params_t* const p_params,
+    http_cbor_buf_t* const                      p_cbor_buf)
+{
+    p_cbor_buf->p_buf = nullptr;
+    p_cbor_buf->len   = 0;
+    if ((nullptr == g_pTestClass) || g_pTestClass->m_mock_cbor.empty())
+    {
+        return false;
+    }
+    p_cbor_buf->p_buf = static_cast<uint8_t*>(os_malloc(g_pTestClass->m_mock_cbor.size()));
+    if (nullptr == p_cbor_buf->p_buf)
+    {
+        return false;
+    }
+    memcpy(p_cbor_buf->p_buf, g_pTestClass->m_mock_cbor.data(), g_pTestClass->m_mock_cbor.size());
+    p_cbor_buf->len = g_pTestClass->m_mock_cbor.size();
+    return true;
+}
+
+void
+http_cbor_buf_free(http_cbor_buf_t* const p_cbor_buf)
+{
+    if (nullptr != p_cbor_buf->p_buf)
+    {
+        os_free(p_cbor_buf->p_buf);
+    }
+    p_cbor_buf->p_buf = nullptr;
+    p_cbor_buf->len   = 0;
+}
+
+adv_table_snapshot_t*
+adv_table_snapshot_ref(adv_table_snapshot_t* const p_snapshot)
+{
+    return p_snapshot;
+}
+
+void
+adv_table_snapshot_release(adv_table_snapshot_t** const p_p_snapshot)
+{
+    *p_p_snapshot = nullptr;
+}
+
 static http_async_info_t g_test_http_async_info;
 
 http_async_info_t*
@@ -705,7 +749,11 @@ http_server_resp_free(http_server_resp_t* const p_resp)
 }
 
 bool
-hmac_sha256_calc_for_json_gen_http_ruuvi(json_stream_gen_t* const p_gen, hmac_sha256_t* const p_hmac_sha256)
+hmac_sha256_calc_for_json_gen_http_ruuvi_with_cb(
+    json_stream_gen_t* const        p_gen,
+    hmac_sha256_t* const            p_hmac_sha256,
+    hmac_sha256_cb_on_chunk_t const p_cb_on_chunk,
+    void* const                     p_user_data)
 {
     if (NULL != p_hmac_sha256)
     {
@@ -725,7 +773,24 @@ hmac_sha256_calc_for_http_custom(const char* const p_str, hmac_sha256_t* const p
 }
 
 bool
-hmac_sha256_calc_for_json_gen_http_custom(json_stream_gen_t* const p_gen, hmac_sha256_t* const p_hmac_sha256)
+hmac_sha256_calc_bin_for_http_custom(
+    const uint8_t* const p_msg,
+    const size_t         msg_len,
+    hmac_sha256_t* const p_hmac_sha256)
+{
+    if (NULL != p_hmac_sha256)
+    {
+        memset(p_hmac_sha256, 0, sizeof(*p_hmac_sha256));
+    }
+    return true;
+}
+
+bool
+hmac_sha256_calc_for_json_gen_http_custom_with_cb(
+    json_stream_gen_t* const        p_gen,
+    hmac_sha256_t* const            p_hmac_sha256,
+    hmac_sha256_cb_on_chunk_t const p_cb_on_chunk,
+    void* const                     p_user_data)
 {
     if (NULL != p_hmac_sha256)
     {
@@ -1716,3 +1781,48 @@ TEST_F(TestHttpCheckPostAdvs, test_http_client_config_init_url_parse_fail_with_s
         esp_log_wrapper_get_logs());
     ASSERT_EQ(0, this->m_alloc_free_call_count);
 }
+
+TEST_F(TestHttpCheckPostAdvs, test_post_advs_cbor_larger_than_spool)
+{
+    ruuvi_gw_cfg_http_t cfg_http = {};
+    cfg_http.use_http            = true;
+    cfg_http.data_format         = GW_CFG_HTTP_DATA_FORMAT_RUUVI_CBOR;
+    cfg_http.auth_type           = GW_CFG_HTTP_AUTH_TYPE_NONE;
+    (void)snprintf(cfg_http.http_url.buf, sizeof(cfg_http.http_url.buf), "%s", "https://myserver.com/api");
+
+    for (uint32_t i = 0; i < (2 * HTTP_POST_SPOOL_MAX_SIZE + 1); ++i)
+    {
+        this->m_mock_cbor.push_back(static_cast<uint8_t>(i & 0xFFU));
+    }
+
+    // The CBOR body which does not fit into the spool is sent from its own buffer
+    http_async_info_t* const p_http_async_info = http_get_async_info();
+    p_http_async_info->p_http_client_handle    = nullptr;
+    p_http_async_info->p_tls_shared_buf        = tls_shared_buf_get_https_post();
+    ASSERT_TRUE(http_post_advs(p_http_async_info, nullptr, 0x12345678, true, false, &cfg_http, nullptr));
+    ASSERT_FALSE(this->m_flag_gateway_restart_low_memory);
+    ASSERT_EQ(HTTP_CONTENT_TYPE_CBOR, p_http_async_info->content_type);
+    ASSERT_EQ(HTTP_CONTENT_ENCODING_NONE, p_http_async_info->content_encoding);
+    ASSERT_TRUE(http_post_spool_is_complete(&p_http_async_info->post_spool));
+    ASSERT_EQ(this->m_mock_cbor.size(), http_post_spool_get_total_len(&p_http_async_info->post_spool));
+
+    vector<uint8_t> body;
+    http_post_spool_rewind(&p_http_async_info->post_spool);
+    while (true)
+    {
+        const void* p_buf = nullptr;
+        size_t      len   = 0;
+        http_post_spool_read_next_block(&p_http_async_info->post_spool, &p_buf, &len);
+        if (0 == len)
+        {
+            break;
+        }
+        body.insert(body.end(), static_cast<const uint8_t*>(p_buf), static_cast<const uint8_t*>(p_buf) + len);
+    }
+    ASSERT_EQ(this->m_mock_cbor, body);
+
+    http_post_spool_free(&p_http_async_info->post_spool);
+    http_async_info_free_data(p_http_async_info);
+    p_http_async_info->p_http_client_handle = nullptr;
+    ASSERT_EQ(0, this->m_alloc_free_call_count);
+}
@@ -0,0 +1,280 @@
+/**
+ * @file test_http_gzip.cpp
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_gzip.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "os_malloc.h"
+
+using namespace std;
+
+class TestHttpGzip;
+
+static TestHttpGzip* g_pTestClass;
+
+/*** Google-test class implementation
+ * *********************************************************************************/
+
+class TestHttpGzip : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        this->m_malloc_cnt         = 0;
+        this->m_malloc_fail_on_cnt = 0;
+        this->m_num_allocated      = 0;
+        this->m_output.clear();
+        this->m_num_output_calls    = 0;
+        this->m_output_fail_on_call = 0;
+        g_pTestClass                = this;
+    }
+
+    void
+    TearDown() override
+    {
+        g_pTestClass = nullptr;
+    }
+
+public:
+    TestHttpGzip();
+
+    ~TestHttpGzip() override;
+
+    uint32_t        m_malloc_cnt {};
+    uint32_t        m_malloc_fail_on_cnt {};
+    uint32_t        m_num_allocated {};
+    vector<uint8_t> m_output {};
+    uint32_t        m_num_output_calls {};
+    uint32_t        m_output_fail_on_call {};
+};
+
+TestHttpGzip::TestHttpGzip()
+    : Test()
+{
+}
+
+TestHttpGzip::~TestHttpGzip() = default;
+
+extern "C" {
+
+void*
+os_calloc(const size_t nmemb, const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    g_pTestClass->m_num_allocated += 1;
+    return calloc(nmemb, size);
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    assert(nullptr != g_pTestClass);
+    assert(0 != g_pTestClass->m_num_allocated);
+    g_pTestClass->m_num_allocated -= 1;
+    free(p_mem);
+}
+
+} // extern "C"
+
+static bool
+cb_on_output(void* const p_user_data, const char* const p_buf, const size_t len)
+{
+    auto* const p_test = static_cast<TestHttpGzip*>(p_user_data);
+    p_test->m_num_output_calls += 1;
+    if (p_test->m_num_output_calls == p_test->m_output_fail_on_call)
+    {
+        return false;
+    }
+    p_test->m_output.insert(p_test->m_output.end(), p_buf, p_buf + len);
+    return true;
+}
+
+static string
+gunzip(const vector<uint8_t>& compressed)
+{
+    z_stream strm = {};
+    if (Z_OK != inflateInit2(&strm, 16 + MAX_WBITS)) // 16 - decode gzip format only
+    {
+        return "<inflateInit2 failed>";
+    }
+    strm.next_in  = const_cast<Bytef*>(compressed.data());
+    strm.avail_in = static_cast<uInt>(compressed.size());
+    string result;
+    int    ret = Z_OK;
+    while (Z_OK == ret)
+    {
+        char buf[1024];
+        strm.next_out  = reinterpret_cast<Bytef*>(buf);
+        strm.avail_out = sizeof(buf);
+        ret            = inflate(&strm, Z_NO_FLUSH);
+        result.append(buf, sizeof(buf) - strm.avail_out);
+    }
+    const bool flag_all_input_consumed = (0 == strm.avail_in);
+    inflateEnd(&strm);
+    if (Z_STREAM_END != ret)
+    {
+        return string("<inflate failed: ") + to_string(ret) + ">";
+    }
+    if (!flag_all_input_consumed)
+    {
+        return "<extra data after gzip trailer>";
+    }
+    return result;
+}
+
+static string
+gen_json_advs(const uint32_t num_tags)
+{
+    string json = "{\"data\":{\"coordinates\":\"\",\"timestamp\":1612358920,\"nonce\":2,"
+                  "\"gw_mac\":\"AA:CC:EE:00:11:22\",\"tags\":{";
+    for (uint32_t i = 0; i < num_tags; ++i)
+    {
+        char buf[256];
+        snprintf(
+            buf,
+            sizeof(buf),
+            "%s\"C8:25:2D:8E:%02X:%02X\":{\"rssi\":-%u,\"timestamp\":%u,\"ble_phy\":\"1M\",\"ble_chan\":37,"
+            "\"data\":\"0201061BFF99040512FC5394C37C0004FFFC040CAC364200CDCBB8334C%02X%02X\"}",
+            (0 != i) ? "," : "",
+            (i >> 8U) & 0xFFU,
+            i & 0xFFU,
+            40 + (i % 50),
+            1612358900 + i,
+            (i * 7U) & 0xFFU,
+            (i * 13U) & 0xFFU);
+        json += buf;
+    }
+    json += "}}}";
+    return json;
+}
+
+/*** Unit-Tests
+ * *******************************************************************************************************/
+
+TEST_F(TestHttpGzip, test_empty) // NOLINT
+{
+    ASSERT_TRUE(http_gzip_compress_buf(nullptr, 0, &cb_on_output, this));
+    ASSERT_EQ(string(""), gunzip(this->m_output));
+    ASSERT_EQ(0x1FU, this->m_output.at(0));
+    ASSERT_EQ(0x8BU, this->m_output.at(1));
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestHttpGzip, test_short_string) // NOLINT
+{
+    const string msg = "The quick brown fox jumps over the lazy dog";
+    ASSERT_TRUE(
+        http_gzip_compress_buf(reinterpret_cast<const uint8_t*>(msg.c_str()), msg.size(), &cb_on_output, this));
+    ASSERT_EQ(msg, gunzip(this->m_output));
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestHttpGzip, test_long_match_and_repetitions) // NOLINT
+{
+    const string msg = string(5000, 'a') + "b" + string(300, 'a') + "abcabcabcabcabc";
+    ASSERT_TRUE(
+        http_gzip_compress_buf(reinterpret_cast<const uint8_t*>(msg.c_str()), msg.size(), &cb_on_output, this));
+    ASSERT_EQ(msg, gunzip(this->m_output));
+    ASSERT_LT(this->m_output.size(), 100);
+}
+
+TEST_F(TestHttpGzip, test_json_advs_streaming) // NOLINT
+{
+    const string json = gen_json_advs(100);
+
+    http_gzip_t* p_gzip = http_gzip_create(&cb_on_output, this);
+    ASSERT_NE(nullptr, p_gzip);
+    ASSERT_EQ(1, this->m_num_allocated);
+    // Feed the json in chunks of different sizes like json_stream_gen does.
+    size_t offset = 0;
+    size_t chunk  = 1;
+    while (offset < json.size())
+    {
+        const size_t len = min(chunk, json.size() - offset);
+        ASSERT_TRUE(http_gzip_write(p_gzip, reinterpret_cast<const uint8_t*>(&json[offset]), len));
+        offset += len;
+        chunk = (chunk * 3U) % 769U + 1U;
+    }
+    ASSERT_TRUE(http_gzip_finish(p_gzip));
+    http_gzip_delete(&p_gzip);
+    ASSERT_EQ(nullptr, p_gzip);
+    ASSERT_EQ(0, this->m_num_allocated);
+
+    ASSERT_EQ(json, gunzip(this->m_output));
+    printf(
+        "json: %u bytes, gzip: %u bytes, ratio: %.1f\n",
+        (unsigned)json.size(),
+        (unsigned)this->m_output.size(),
+        (double)json.size() / (double)this->m_output.size());
+    ASSERT_LT(this->m_output.size() * 3, json.size());
+}
+
+TEST_F(TestHttpGzip, test_deterministic_output) // NOLINT
+{
+    const string json = gen_json_advs(20);
+
+    ASSERT_TRUE(
+        http_gzip_compress_buf(reinterpret_cast<const uint8_t*>(json.c_str()), json.size(), &cb_on_output, this));
+    const vector<uint8_t> output1 = this->m_output;
+    this->m_output.clear();
+
+    http_gzip_t* p_gzip = http_gzip_create(&cb_on_output, this);
+    ASSERT_NE(nullptr, p_gzip);
+    for (const char ch : json)
+    {
+        ASSERT_TRUE(http_gzip_cb_on_chunk(p_gzip, &ch, 1));
+    }
+    ASSERT_TRUE(http_gzip_finish(p_gzip));
+    http_gzip_delete(&p_gzip);
+
+    ASSERT_EQ(output1, this->m_output);
+}
+
+TEST_F(TestHttpGzip, test_random_data) // NOLINT
+{
+    std::mt19937    gen(12345);
+    vector<uint8_t> data(20000);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        // Mix of incompressible data and repetitions
+        data[i] = ((i / 1000) % 2 == 0) ? static_cast<uint8_t>(gen()) : data[i - 997];
+    }
+    ASSERT_TRUE(http_gzip_compress_buf(data.data(), data.size(), &cb_on_output, this));
+    const string res = gunzip(this->m_output);
+    ASSERT_EQ(string(data.begin(), data.end()), res);
+}
+
+TEST_F(TestHttpGzip, test_malloc_failed) // NOLINT
+{
+    this->m_malloc_fail_on_cnt = 1;
+    ASSERT_EQ(nullptr, http_gzip_create(&cb_on_output, this));
+    const string msg           = "abc";
+    this->m_malloc_fail_on_cnt = 2;
+    ASSERT_FALSE(
+        http_gzip_compress_buf(reinterpret_cast<const uint8_t*>(msg.c_str()), msg.size(), &cb_on_output, this));
+    ASSERT_EQ(0, this->m_num_allocated);
+}
+
+TEST_F(TestHttpGzip, test_output_aborted) // NOLINT
+{
+    const string json           = gen_json_advs(100);
+    this->m_output_fail_on_call = 2;
+    ASSERT_FALSE(
+        http_gzip_compress_buf(reinterpret_cast<const uint8_t*>(json.c_str()), json.size(), &cb_on_output, this));
+    ASSERT_EQ(2, this->m_num_output_calls);
+    ASSERT_EQ(0, this->m_num_allocated);
+}
@@ -6,6 +6,7 @@
  */
 
 #include "http_json.h"
+#include "http_post_spool.h"
 #include <cstring>
 #include "gtest/gtest.h"
 #include "os_malloc.h"
@@ -71,6 +72,7 @@ protected:
 
         this->m_malloc_cnt         = 0;
         this->m_malloc_fail_on_cnt = 0;
+        this->m_samples.clear();
     }
 
     void
@@ -89,12 +91,15 @@ public:
     uint32_t         m_malloc_cnt;
     uint32_t         m_malloc_fail_on_cnt;
     cjson_wrap_str_t m_json_str;
+
+    std::vector<std::vector<adv_report_t>> m_samples; //<! The samples of every tag in the snapshot
 };
 
 TestHttpJson::TestHttpJson()
     : m_malloc_cnt(0)
     , m_malloc_fail_on_cnt(0)
     , m_json_str()
+    , m_samples()
     , Test()
 {
 }
@@ -155,6 +160,63 @@ runtime_stat_for_each_accumulated_info(
     return true;
 }
 
+num_of_advs_t
+adv_table_snapshot_get_num_of_advs(const adv_table_snapshot_t* const p_snapshot)
+{
+    if (nullptr == p_snapshot)
+    {
+        return 0;
+    }
+    return reinterpret_cast<const adv_report_table_t*>(p_snapshot)->num_of_advs;
+}
+
+bool
+adv_table_snapshot_get_adv(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    adv_report_t* const               p_adv_report)
+{
+    const auto* const p_reports = reinterpret_cast<const adv_report_table_t*>(p_snapshot);
+    if ((nullptr == p_reports) || (idx >= p_reports->num_of_advs))
+    {
+        return false;
+    }
+    if (0 == p_reports->table[idx].data_len)
+    {
+        // Simulate the tag which content was lost because of lack of memory
+        return false;
+    }
+    *p_adv_report = p_reports->table[idx];
+    return true;
+}
+
+num_of_advs_t
+adv_table_snapshot_get_num_of_samples(const adv_table_snapshot_t* const p_snapshot, const num_of_advs_t idx)
+{
+    (void)p_snapshot;
+    if (idx >= g_pTestClass->m_samples.size())
+    {
+        return 0;
+    }
+    return static_cast<num_of_advs_t>(g_pTestClass->m_samples[idx].size());
+}
+
+bool
+adv_table_snapshot_get_sample(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    const num_of_advs_t               sample_idx,
+    adv_report_t* const               p_adv_report)
+{
+    (void)p_snapshot;
+    if ((idx >= g_pTestClass->m_samples.size()) || (sample_idx >= g_pTestClass->m_samples[idx].size()))
+    {
+        return false;
+    }
+    *p_adv_report = g_pTestClass->m_samples[idx][sample_idx];
+    return true;
+}
+
 } // extern "C"
 
 TestHttpJson::~TestHttpJson() = default;
@@ -1360,6 +1422,338 @@ TEST_F(TestHttpJson, test_2) // NOLINT
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
+TEST_F(TestHttpJson, test_2_from_snapshot) // NOLINT
+{
+    const time_t                     timestamp   = 1612358920;
+    const mac_address_str_t          gw_mac_addr = { "AA:CC:EE:00:11:22" };
+    const ruuvi_gw_cfg_coordinates_t coordinates = { "170.112233,59.445566" };
+    const std::array<uint8_t, 1>     data1       = { 0xAAU };
+    const std::array<uint8_t, 1>     data2       = { 0xBBU };
+    const std::array<uint8_t, 1>     data3       = { 0xCCU };
+
+    adv_report_table_t adv_table = {
+        .num_of_advs = 3,
+        .table = {
+            {
+                .timestamp = 1612358929,
+                .tag_mac = {0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x03},
+                .rssi = -70,
+                .primary_phy = RE_CA_UART_BLE_PHY_1MBPS,
+                .secondary_phy = RE_CA_UART_BLE_PHY_NOT_SET,
+                .ch_index = 37,
+                .is_coded_phy = false,
+                .tx_power = RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID,
+                .data_len = data1.size(),
+            },
+            {
+                .timestamp = 1612358930,
+                .tag_mac = {0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x04},
+                .rssi = -71,
+                .primary_phy = RE_CA_UART_BLE_PHY_1MBPS,
+                .secondary_phy = RE_CA_UART_BLE_PHY_NOT_SET,
+                .ch_index = 38,
+                .is_coded_phy = false,
+                .tx_power = RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID,
+                .data_len = data2.size(),
+            },
+            {
+                .timestamp = 1612358931,
+                .tag_mac = {0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x05},
+                .rssi = -72,
+                .primary_phy = RE_CA_UART_BLE_PHY_1MBPS,
+                .secondary_phy = RE_CA_UART_BLE_PHY_NOT_SET,
+                .ch_index = 39,
+                .is_coded_phy = false,
+                .tx_power = RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID,
+                .data_len = data3.size(),
+            },
+        },
+    };
+    memcpy(adv_table.table[0].data_buf, data1.data(), data1.size());
+    memcpy(adv_table.table[1].data_buf, data2.data(), data2.size());
+    memcpy(adv_table.table[2].data_buf, data3.data(), data3.size());
+    adv_table.table[1].data_len = 0; // The content of this tag was lost, it must be skipped
+
+    const bool     flag_raw_data       = true;
+    const bool     flag_decode         = false;
+    const bool     flag_use_timestamps = true;
+    const bool     flag_use_nonce      = true;
+    const uint32_t nonce               = 12345678;
+
+    str_buf_t coordinates_str_buf = str_buf_printf_with_alloc("%s", coordinates.buf);
+    assert(nullptr != coordinates_str_buf.buf);
+    const http_json_create_stream_gen_advs_params_t params = {
+        .flag_raw_data       = flag_raw_data,
+        .flag_decode         = flag_decode,
+        .flag_use_timestamps = flag_use_timestamps,
+        .cur_time            = timestamp,
+        .flag_use_nonce      = flag_use_nonce,
+        .nonce               = nonce,
+        .p_mac_addr          = &gw_mac_addr,
+        .coordinates_str_buf = coordinates_str_buf,
+    };
+
+    json_stream_gen_t* p_gen = http_json_create_stream_gen_advs_from_snapshot(
+        reinterpret_cast<const adv_table_snapshot_t*>(&adv_table),
+        &params);
+    str_buf_free_buf(&coordinates_str_buf);
+    ASSERT_NE(nullptr, p_gen);
+
+    string json_str("");
+    while (true)
+    {
+        const char* p_chunk = json_stream_gen_get_next_chunk(p_gen);
+        if (nullptr == p_chunk)
+        {
+            ASSERT_FALSE(nullptr == p_chunk);
+        }
+
+        if ('\0' == p_chunk[0])
+        {
+            break;
+        }
+        json_str += string(p_chunk);
+    }
+
+    ASSERT_EQ(
+        string("{\n"
+               "  \"data\": {\n"
+               "    \"coordinates\": \"170.112233,59.445566\",\n"
+               "    \"timestamp\": 1612358920,\n"
+               "    \"nonce\": 12345678,\n"
+               "    \"gw_mac\": \"AA:CC:EE:00:11:22\",\n"
+               "    \"tags\": {\n"
+               "      \"AA:BB:CC:01:02:03\": {\n"
+               "        \"rssi\": -70,\n"
+               "        \"timestamp\": 1612358929,\n"
+               "        \"ble_phy\": \"1M\",\n"
+               "        \"ble_chan\": 37,\n"
+               "        \"data\": \"AA\"\n"
+               "      },\n"
+               "      \"AA:BB:CC:01:02:05\": {\n"
+               "        \"rssi\": -72,\n"
+               "        \"timestamp\": 1612358931,\n"
+               "        \"ble_phy\": \"1M\",\n"
+               "        \"ble_chan\": 39,\n"
+               "        \"data\": \"CC\"\n"
+               "      }\n"
+               "    }\n"
+               "  }\n"
+               "}"),
+        json_str);
+    json_stream_gen_delete(&p_gen);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestHttpJson, test_max_num_of_tags_fit_into_post_spool) // NOLINT
+{
+    const time_t                     timestamp   = 1612358920;
+    const mac_address_str_t          gw_mac_addr = { "AA:CC:EE:00:11:22" };
+    const ruuvi_gw_cfg_coordinates_t coordinates = { "170.112233,59.445566" };
+
+    // All the optional fields are present and have the longest values
+    static adv_report_table_t adv_table = {};
+    adv_table.num_of_advs               = MAX_ADVS_TABLE;
+    for (uint32_t i = 0; i < MAX_ADVS_TABLE; ++i)
+    {
+        adv_report_t* const p_adv = &adv_table.table[i];
+        p_adv->timestamp          = 1612358929 + i;
+        p_adv->tag_mac            = { 0xaa, 0xbb, 0xcc, 0x01, static_cast<uint8_t>(i >> 8U), static_cast<uint8_t>(i) };
+        p_adv->rssi               = -100;
+        p_adv->primary_phy        = RE_CA_UART_BLE_PHY_CODED;
+        p_adv->secondary_phy      = RE_CA_UART_BLE_PHY_CODED;
+        p_adv->ch_index           = 39;
+        p_adv->is_coded_phy       = true;
+        p_adv->tx_power           = -40;
+        p_adv->data_len           = ADV_DATA_MAX_LEN;
+        memset(p_adv->data_buf, 0xA5, ADV_DATA_MAX_LEN);
+    }
+
+    str_buf_t coordinates_str_buf = str_buf_printf_with_alloc("%s", coordinates.buf);
+    assert(nullptr != coordinates_str_buf.buf);
+    const http_json_create_stream_gen_advs_params_t params = {
+        .flag_raw_data       = true,
+        .flag_decode         = false,
+        .flag_use_timestamps = true,
+        .cur_time            = timestamp,
+        .flag_use_nonce      = true,
+        .nonce               = 12345678,
+        .p_mac_addr          = &gw_mac_addr,
+        .coordinates_str_buf = coordinates_str_buf,
+    };
+
+    json_stream_gen_t* p_gen = http_json_create_stream_gen_advs(&adv_table, &params);
+    str_buf_free_buf(&coordinates_str_buf);
+    ASSERT_NE(nullptr, p_gen);
+
+    // The body is generated only once - every chunk is spooled, so it can be sent without regenerating
+    http_post_spool_t spool = {};
+    http_post_spool_init(&spool);
+    string json_str("");
+    while (true)
+    {
+        const char* p_chunk = json_stream_gen_get_next_chunk(p_gen);
+        ASSERT_NE(nullptr, p_chunk);
+        if ('\0' == p_chunk[0])
+        {
+            break;
+        }
+        ASSERT_TRUE(http_post_spool_cb_on_chunk(&spool, p_chunk, strlen(p_chunk)));
+        json_str += string(p_chunk);
+    }
+    json_stream_gen_delete(&p_gen);
+
+    ASSERT_TRUE(http_post_spool_is_complete(&spool));
+    ASSERT_EQ(json_str.size(), http_post_spool_get_total_len(&spool));
+    ASSERT_LE(json_str.size(), HTTP_POST_SPOOL_MAX_SIZE);
+
+    string spooled_str("");
+    http_post_spool_rewind(&spool);
+    while (true)
+    {
+        const void* p_buf = nullptr;
+        size_t      len   = 0;
+        http_post_spool_read_next_block(&spool, &p_buf, &len);
+        if (0 == len)
+        {
+            break;
+        }
+        spooled_str += string(static_cast<const char*>(p_buf), len);
+    }
+    ASSERT_EQ(json_str, spooled_str);
+
+    http_post_spool_free(&spool);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestHttpJson, test_from_snapshot_with_samples) // NOLINT
+{
+    const time_t                     timestamp   = 1612358920;
+    const mac_address_str_t          gw_mac_addr = { "AA:CC:EE:00:11:22" };
+    const ruuvi_gw_cfg_coordinates_t coordinates = { "170.112233,59.445566" };
+    const std::array<uint8_t, 1>     data1       = { 0xAAU };
+    const std::array<uint8_t, 1>     data2       = { 0xBBU };
+
+    adv_report_table_t adv_table = {
+        .num_of_advs = 2,
+        .table = {
+            {
+                .timestamp = 1612358929,
+                .tag_mac = {0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x03},
+                .rssi = -70,
+                .primary_phy = RE_CA_UART_BLE_PHY_1MBPS,
+                .secondary_phy = RE_CA_UART_BLE_PHY_NOT_SET,
+                .ch_index = 37,
+                .is_coded_phy = false,
+                .tx_power = RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID,
+                .data_len = data1.size(),
+            },
+            {
+                .timestamp = 1612358930,
+                .tag_mac = {0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x04},
+                .rssi = -71,
+                .primary_phy = RE_CA_UART_BLE_PHY_1MBPS,
+                .secondary_phy = RE_CA_UART_BLE_PHY_NOT_SET,
+                .ch_index = 38,
+                .is_coded_phy = false,
+                .tx_power = RE_CA_UART_BLE_GAP_POWER_LEVEL_INVALID,
+                .data_len = data2.size(),
+            },
+        },
+    };
+    memcpy(adv_table.table[0].data_buf, data1.data(), data1.size());
+    memcpy(adv_table.table[1].data_buf, data2.data(), data2.size());
+
+    adv_report_t sample1 = adv_table.table[0];
+    sample1.timestamp    = 1612358927;
+    sample1.rssi         = -68;
+    sample1.data_buf[0]  = 0xA8U;
+    adv_report_t sample2 = adv_table.table[0];
+    sample2.timestamp    = 1612358928;
+    sample2.rssi         = -69;
+    sample2.data_buf[0]  = 0xA9U;
+    this->m_samples      = {
+        { sample1, sample2, adv_table.table[0] },
+        {}, // The history of this tag is empty, the samples are not emitted
+    };
+
+    str_buf_t coordinates_str_buf = str_buf_printf_with_alloc("%s", coordinates.buf);
+    assert(nullptr != coordinates_str_buf.buf);
+    const http_json_create_stream_gen_advs_params_t params = {
+        .flag_raw_data       = true,
+        .flag_decode         = false,
+        .flag_use_timestamps = true,
+        .cur_time            = timestamp,
+        .flag_use_nonce      = false,
+        .nonce               = 0,
+        .p_mac_addr          = &gw_mac_addr,
+        .coordinates_str_buf = coordinates_str_buf,
+    };
+
+    json_stream_gen_t* p_gen = http_json_create_stream_gen_advs_from_snapshot(
+        reinterpret_cast<const adv_table_snapshot_t*>(&adv_table),
+        &params);
+    str_buf_free_buf(&coordinates_str_buf);
+    ASSERT_NE(nullptr, p_gen);
+
+    string json_str("");
+    while (true)
+    {
+        const char* p_chunk = json_stream_gen_get_next_chunk(p_gen);
+        ASSERT_NE(nullptr, p_chunk);
+        if ('\0' == p_chunk[0])
+        {
+            break;
+        }
+        json_str += string(p_chunk);
+    }
+
+    ASSERT_EQ(
+        string("{\n"
+               "  \"data\": {\n"
+               "    \"coordinates\": \"170.112233,59.445566\",\n"
+               "    \"timestamp\": 1612358920,\n"
+               "    \"gw_mac\": \"AA:CC:EE:00:11:22\",\n"
+               "    \"tags\": {\n"
+               "      \"AA:BB:CC:01:02:03\": {\n"
+               "        \"rssi\": -70,\n"
+               "        \"timestamp\": 1612358929,\n"
+               "        \"ble_phy\": \"1M\",\n"
+               "        \"ble_chan\": 37,\n"
+               "        \"data\": \"AA\",\n"
+               "        \"samples\": [\n"
+               "          {\n"
+               "            \"timestamp\": 1612358927,\n"
+               "            \"rssi\": -68,\n"
+               "            \"data\": \"A8\"\n"
+               "          },\n"
+               "          {\n"
+               "            \"timestamp\": 1612358928,\n"
+               "            \"rssi\": -69,\n"
+               "            \"data\": \"A9\"\n"
+               "          },\n"
+               "          {\n"
+               "            \"timestamp\": 1612358929,\n"
+               "            \"rssi\": -70,\n"
+               "            \"data\": \"AA\"\n"
+               "          }\n"
+               "        ]\n"
+               "      },\n"
+               "      \"AA:BB:CC:01:02:04\": {\n"
+               "        \"rssi\": -71,\n"
+               "        \"timestamp\": 1612358930,\n"
+               "        \"ble_phy\": \"1M\",\n"
+               "        \"ble_chan\": 38,\n"
+               "        \"data\": \"BB\"\n"
+               "      }\n"
+               "    }\n"
+               "  }\n"
+               "}"),
+        json_str);
+    json_stream_gen_delete(&p_gen);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
 TEST_F(TestHttpJson, test_create_status_json_str_connection_wifi) // NOLINT
 {
     const mac_address_str_t      nrf52_mac_addr         = { .str_buf = "AA:CC:EE:00:11:22" };
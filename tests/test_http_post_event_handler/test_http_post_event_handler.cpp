@@ -7,6 +7,7 @@
 
 #include "http_post_event_handler.h"
 #include "http.h"
+#include "adv_post_async_comm.h"
 #include <cstring>
 #include <string>
 #include "gtest/gtest.h"
@@ -46,9 +47,13 @@ protected:
 
         this->m_hmac_key_set_called           = false;
         this->m_hmac_key_value                = "";
+        this->m_hmac_key_action               = ADV_POST_ACTION_NONE;
         this->m_mock_adv_post_set_hmac_result = true;
         this->m_default_period_set_called     = false;
         this->m_default_period_ms             = 0;
+        this->m_default_period_action         = ADV_POST_ACTION_NONE;
+        this->m_p_http_async_info_found       = nullptr;
+        this->m_p_http_client_connected       = nullptr;
 
         esp_log_wrapper_clear();
     }
@@ -73,11 +78,15 @@ public:
     bool m_flag_alloc_counting_enabled;
     int  m_alloc_free_call_count;
 
-    bool     m_hmac_key_set_called;
-    string   m_hmac_key_value;
-    bool     m_mock_adv_post_set_hmac_result;
-    bool     m_default_period_set_called;
-    uint32_t m_default_period_ms;
+    bool                     m_hmac_key_set_called;
+    string                   m_hmac_key_value;
+    adv_post_action_e        m_hmac_key_action;
+    bool                     m_mock_adv_post_set_hmac_result;
+    bool                     m_default_period_set_called;
+    uint32_t                 m_default_period_ms;
+    adv_post_action_e        m_default_period_action;
+    const http_async_info_t* m_p_http_async_info_found;
+    esp_http_client_handle_t m_p_http_client_connected;
 };
 
 TestHttpPostEventHandler::TestHttpPostEventHandler()
@@ -86,9 +95,13 @@ TestHttpPostEventHandler::TestHttpPostEventHandler()
     , m_flag_alloc_counting_enabled(false)
     , m_alloc_free_call_count(0)
     , m_hmac_key_set_called(false)
+    , m_hmac_key_action(ADV_POST_ACTION_NONE)
     , m_mock_adv_post_set_hmac_result(true)
     , m_default_period_set_called(false)
     , m_default_period_ms(0)
+    , m_default_period_action(ADV_POST_ACTION_NONE)
+    , m_p_http_async_info_found(nullptr)
+    , m_p_http_client_connected(nullptr)
     , Test()
 {
 }
@@ -219,25 +232,50 @@ os_mutex_unlock(os_mutex_t const h_mutex)
     (void)h_mutex;
 }
 
+const http_async_info_t*
+http_async_info_find_by_handle(const esp_http_client_handle_t p_http_client_handle)
+{
+    if ((nullptr == g_pTestClass) || (nullptr == g_pTestClass->m_p_http_async_info_found))
+    {
+        return nullptr;
+    }
+    if (p_http_client_handle != g_pTestClass->m_p_http_async_info_found->p_http_client_handle)
+    {
+        return nullptr;
+    }
+    return g_pTestClass->m_p_http_async_info_found;
+}
+
+void
+http_async_on_connected(const esp_http_client_handle_t p_http_client_handle)
+{
+    if (nullptr != g_pTestClass)
+    {
+        g_pTestClass->m_p_http_client_connected = p_http_client_handle;
+    }
+}
+
 bool
-adv_post_set_hmac_sha256_key(const char* const p_key_str)
+adv_post_set_hmac_sha256_key(const adv_post_action_e action, const char* const p_key_str)
 {
     if (nullptr != g_pTestClass)
     {
         g_pTestClass->m_hmac_key_set_called = true;
         g_pTestClass->m_hmac_key_value      = (nullptr != p_key_str) ? p_key_str : "";
+        g_pTestClass->m_hmac_key_action     = action;
         return g_pTestClass->m_mock_adv_post_set_hmac_result;
     }
     return false;
 }
 
 void
-adv_post_set_default_period(const uint32_t period_ms)
+adv_post_set_default_period(const adv_post_action_e action, const uint32_t period_ms)
 {
     if (nullptr != g_pTestClass)
     {
         g_pTestClass->m_default_period_set_called = true;
         g_pTestClass->m_default_period_ms         = period_ms;
+        g_pTestClass->m_default_period_action     = action;
     }
 }
 
@@ -257,9 +295,11 @@ TEST_F(TestHttpPostEventHandler, test_event_handler_on_connected) // NOLINT
 {
     esp_http_client_event_t evt = {};
     evt.event_id                = HTTP_EVENT_ON_CONNECTED;
+    evt.client                  = reinterpret_cast<esp_http_client_handle_t>(0x12345678);
     ASSERT_EQ(ESP_OK, http_post_event_handler(&evt));
     // LOG_DBG is not emitted at LOG_LOCAL_LEVEL = LOG_LEVEL_INFO
     ASSERT_EQ("", esp_log_wrapper_get_logs());
+    ASSERT_EQ(evt.client, this->m_p_http_client_connected);
 }
 
 TEST_F(TestHttpPostEventHandler, test_event_handler_headers_sent) // NOLINT
@@ -306,6 +346,7 @@ TEST_F(TestHttpPostEventHandler, test_event_handler_on_header_ruuvi_hmac_key_ok)
     ASSERT_EQ(ESP_OK, http_post_event_handler(&evt));
     ASSERT_TRUE(this->m_hmac_key_set_called);
     ASSERT_EQ("my_hmac_key_123", this->m_hmac_key_value);
+    ASSERT_EQ(ADV_POST_ACTION_NONE, this->m_hmac_key_action);
     ASSERT_EQ("", esp_log_wrapper_get_logs());
 }
 
@@ -354,6 +395,48 @@ TEST_F(TestHttpPostEventHandler, test_event_handler_on_header_x_ruuvi_gateway_ra
     ASSERT_EQ("", esp_log_wrapper_get_logs());
 }
 
+TEST_F(TestHttpPostEventHandler, test_event_handler_on_header_ruuvi_hmac_key_for_async_slot) // NOLINT
+{
+    http_async_info_t http_async_info    = {};
+    http_async_info.p_http_client_handle = reinterpret_cast<esp_http_client_handle_t>(0x1234);
+    http_async_info.recipient            = HTTP_POST_RECIPIENT_ADVS2;
+    this->m_p_http_async_info_found      = &http_async_info;
+    esp_http_client_event_t evt          = {};
+    evt.event_id                         = HTTP_EVENT_ON_HEADER;
+    evt.client                           = http_async_info.p_http_client_handle;
+    char header_key[]                    = "Ruuvi-HMAC-KEY";
+    char header_value[]                  = "custom_key";
+    evt.header_key                       = header_key;
+    evt.header_value                     = header_value;
+    evt.user_data                        = nullptr;
+    ASSERT_EQ(ESP_OK, http_post_event_handler(&evt));
+    ASSERT_TRUE(this->m_hmac_key_set_called);
+    ASSERT_EQ("custom_key", this->m_hmac_key_value);
+    ASSERT_EQ(ADV_POST_ACTION_POST_ADVS_TO_CUSTOM, this->m_hmac_key_action);
+    ASSERT_EQ("", esp_log_wrapper_get_logs());
+}
+
+TEST_F(TestHttpPostEventHandler, test_event_handler_on_header_x_ruuvi_gateway_rate_for_async_slot) // NOLINT
+{
+    http_async_info_t http_async_info    = {};
+    http_async_info.p_http_client_handle = reinterpret_cast<esp_http_client_handle_t>(0x1234);
+    http_async_info.recipient            = HTTP_POST_RECIPIENT_ADVS1;
+    this->m_p_http_async_info_found      = &http_async_info;
+    esp_http_client_event_t evt          = {};
+    evt.event_id                         = HTTP_EVENT_ON_HEADER;
+    evt.client                           = http_async_info.p_http_client_handle;
+    char header_key[]                    = "X-Ruuvi-Gateway-Rate";
+    char header_value[]                  = "20";
+    evt.header_key                       = header_key;
+    evt.header_value                     = header_value;
+    evt.user_data                        = nullptr;
+    ASSERT_EQ(ESP_OK, http_post_event_handler(&evt));
+    ASSERT_TRUE(this->m_default_period_set_called);
+    ASSERT_EQ(20U * 1000U, this->m_default_period_ms);
+    ASSERT_EQ(ADV_POST_ACTION_POST_ADVS_TO_RUUVI, this->m_default_period_action);
+    ASSERT_EQ("", esp_log_wrapper_get_logs());
+}
+
 TEST_F(TestHttpPostEventHandler, test_event_handler_on_header_x_ruuvi_gateway_rate_1_second) // NOLINT
 {
     esp_http_client_event_t evt = {};
@@ -0,0 +1,268 @@
+/**
+ * @file test_http_post_spool.cpp
+ * @author TheSomeMan
+ * @date 2026-10-16
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_post_spool.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+#include <vector>
+#include "os_malloc.h"
+
+using namespace std;
+
+/*** Google-test class implementation
+ * *********************************************************************************/
+
+class TestHttpPostSpool;
+static TestHttpPostSpool* g_pTestClass;
+
+class MemAllocTrace
+{
+    vector<void*> allocated_mem;
+
+    std::vector<void*>::iterator
+    find(void* p_mem)
+    {
+        for (auto iter = this->allocated_mem.begin(); iter != this->allocated_mem.end(); ++iter)
+        {
+            if (*iter == p_mem)
+            {
+                return iter;
+            }
+        }
+        return this->allocated_mem.end();
+    }
+
+public:
+    void
+    add(void* p_mem)
+    {
+        auto iter = find(p_mem);
+        assert(iter == this->allocated_mem.end()); // p_mem was found in the list of allocated memory blocks
+        this->allocated_mem.push_back(p_mem);
+    }
+    void
+    remove(void* p_mem)
+    {
+        auto iter = find(p_mem);
+        assert(iter != this->allocated_mem.end()); // p_mem was not found in the list of allocated memory blocks
+        this->allocated_mem.erase(iter);
+    }
+    bool
+    is_empty()
+    {
+        return this->allocated_mem.empty();
+    }
+    size_t
+    size()
+    {
+        return this->allocated_mem.size();
+    }
+};
+
+class TestHttpPostSpool : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        g_pTestClass               = this;
+        this->m_malloc_cnt         = 0;
+        this->m_malloc_fail_on_cnt = 0;
+        http_post_spool_init(&this->m_spool);
+    }
+
+    void
+    TearDown() override
+    {
+        http_post_spool_free(&this->m_spool);
+        ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+        g_pTestClass = nullptr;
+    }
+
+public:
+    TestHttpPostSpool();
+
+    ~TestHttpPostSpool() override;
+
+    MemAllocTrace     m_mem_alloc_trace;
+    uint32_t          m_malloc_cnt {};
+    uint32_t          m_malloc_fail_on_cnt {};
+    http_post_spool_t m_spool {};
+
+    string
+    read_all()
+    {
+        string result;
+        http_post_spool_rewind(&this->m_spool);
+        while (true)
+        {
+            const void* p_buf = nullptr;
+            size_t      len   = 0;
+            http_post_spool_read_next_block(&this->m_spool, &p_buf, &len);
+            if (0 == len)
+            {
+                break;
+            }
+            result += string(static_cast<const char*>(p_buf), len);
+        }
+        return result;
+    }
+};
+
+TestHttpPostSpool::TestHttpPostSpool()
+    : Test()
+{
+}
+
+TestHttpPostSpool::~TestHttpPostSpool() = default;
+
+extern "C" {
+
+void*
+os_malloc(const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    void* p_mem = malloc(size);
+    assert(nullptr != p_mem);
+    g_pTestClass->m_mem_alloc_trace.add(p_mem);
+    return p_mem;
+}
+
+void
+os_free_internal(void* p_mem)
+{
+    assert(nullptr != g_pTestClass);
+    g_pTestClass->m_mem_alloc_trace.remove(p_mem);
+    free(p_mem);
+}
+
+void*
+os_calloc(const size_t nmemb, const size_t size)
+{
+    assert(nullptr != g_pTestClass);
+    if (++g_pTestClass->m_malloc_cnt == g_pTestClass->m_malloc_fail_on_cnt)
+    {
+        return nullptr;
+    }
+    void* p_mem = calloc(nmemb, size);
+    assert(nullptr != p_mem);
+    g_pTestClass->m_mem_alloc_trace.add(p_mem);
+    return p_mem;
+}
+
+} // extern "C"
+
+/*** Unit-Tests
+ * *******************************************************************************************************/
+
+TEST_F(TestHttpPostSpool, test_empty) // NOLINT
+{
+    ASSERT_FALSE(http_post_spool_is_complete(&this->m_spool));
+    ASSERT_EQ(0, http_post_spool_get_total_len(&this->m_spool));
+    ASSERT_EQ(string(""), this->read_all());
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestHttpPostSpool, test_small_chunks) // NOLINT
+{
+    ASSERT_TRUE(http_post_spool_cb_on_chunk(&this->m_spool, "{\n", 2));
+    ASSERT_TRUE(http_post_spool_cb_on_chunk(&this->m_spool, "  \"data\": {}\n", 13));
+    ASSERT_TRUE(http_post_spool_cb_on_chunk(&this->m_spool, "}", 1));
+    ASSERT_TRUE(http_post_spool_is_complete(&this->m_spool));
+    ASSERT_EQ(16, http_post_spool_get_total_len(&this->m_spool));
+    ASSERT_EQ(1, this->m_mem_alloc_trace.size());
+    ASSERT_EQ(string("{\n  \"data\": {}\n}"), this->read_all());
+    // The spool can be read again after rewinding (e.g. when HTTP POST is retried).
+    ASSERT_EQ(string("{\n  \"data\": {}\n}"), this->read_all());
+}
+
+TEST_F(TestHttpPostSpool, test_chunks_crossing_block_boundary) // NOLINT
+{
+    string exp_data;
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        const string chunk = string(300, static_cast<char>('a' + i));
+        http_post_spool_append(&this->m_spool, chunk.c_str(), chunk.size());
+        exp_data += chunk;
+    }
+    ASSERT_TRUE(http_post_spool_is_complete(&this->m_spool));
+    ASSERT_EQ(exp_data.size(), http_post_spool_get_total_len(&this->m_spool));
+    ASSERT_EQ((exp_data.size() + HTTP_POST_SPOOL_BLOCK_SIZE - 1) / HTTP_POST_SPOOL_BLOCK_SIZE,
+              this->m_mem_alloc_trace.size());
+    ASSERT_EQ(exp_data, this->read_all());
+}
+
+TEST_F(TestHttpPostSpool, test_overflow) // NOLINT
+{
+    const string chunk = string(HTTP_POST_SPOOL_BLOCK_SIZE / 2, 'x');
+    size_t       total = 0;
+    while (total <= HTTP_POST_SPOOL_MAX_SIZE)
+    {
+        http_post_spool_append(&this->m_spool, chunk.c_str(), chunk.size());
+        total += chunk.size();
+    }
+    ASSERT_FALSE(http_post_spool_is_complete(&this->m_spool));
+    ASSERT_EQ(total, http_post_spool_get_total_len(&this->m_spool));
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+
+    http_post_spool_append(&this->m_spool, chunk.c_str(), chunk.size());
+    ASSERT_EQ(total + chunk.size(), http_post_spool_get_total_len(&this->m_spool));
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+    ASSERT_EQ(string(""), this->read_all());
+}
+
+TEST_F(TestHttpPostSpool, test_malloc_failed) // NOLINT
+{
+    const string chunk = string(HTTP_POST_SPOOL_BLOCK_SIZE, 'y');
+    this->m_malloc_fail_on_cnt = 2;
+    http_post_spool_append(&this->m_spool, chunk.c_str(), chunk.size());
+    ASSERT_TRUE(http_post_spool_is_complete(&this->m_spool));
+    http_post_spool_append(&this->m_spool, chunk.c_str(), chunk.size());
+    ASSERT_FALSE(http_post_spool_is_complete(&this->m_spool));
+    ASSERT_EQ(2 * chunk.size(), http_post_spool_get_total_len(&this->m_spool));
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestHttpPostSpool, test_free_and_reuse) // NOLINT
+{
+    http_post_spool_append(&this->m_spool, "abc", 3);
+    http_post_spool_free(&this->m_spool);
+    ASSERT_FALSE(http_post_spool_is_complete(&this->m_spool));
+    ASSERT_EQ(0, http_post_spool_get_total_len(&this->m_spool));
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+
+    http_post_spool_append(&this->m_spool, "def", 3);
+    ASSERT_TRUE(http_post_spool_is_complete(&this->m_spool));
+    ASSERT_EQ(string("def"), this->read_all());
+}
+
+TEST_F(TestHttpPostSpool, test_attach_buf) // NOLINT
+{
+    http_post_spool_append(&this->m_spool, "abc", 3);
+    ASSERT_EQ(1, this->m_mem_alloc_trace.size());
+
+    // The attached buffer replaces the spooled data and it's not limited by HTTP_POST_SPOOL_MAX_SIZE
+    const string data  = string(HTTP_POST_SPOOL_MAX_SIZE + 1, 'z');
+    char* const  p_buf = static_cast<char*>(os_malloc(data.size()));
+    memcpy(p_buf, data.c_str(), data.size());
+    http_post_spool_attach_buf(&this->m_spool, p_buf, data.size());
+    ASSERT_EQ(1, this->m_mem_alloc_trace.size());
+    ASSERT_TRUE(http_post_spool_is_complete(&this->m_spool));
+    ASSERT_EQ(data.size(), http_post_spool_get_total_len(&this->m_spool));
+    ASSERT_EQ(data, this->read_all());
+    ASSERT_EQ(data, this->read_all());
+
+    http_post_spool_free(&this->m_spool);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+    ASSERT_FALSE(http_post_spool_is_complete(&this->m_spool));
+}
@@ -837,6 +837,47 @@ adv_table_history_read(
     }
 }
 
+num_of_advs_t
+adv_table_snapshot_get_num_of_advs(const adv_table_snapshot_t* const p_snapshot)
+{
+    (void)p_snapshot;
+    return 0;
+}
+
+bool
+adv_table_snapshot_get_adv(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    adv_report_t* const               p_adv_report)
+{
+    (void)p_snapshot;
+    (void)idx;
+    (void)p_adv_report;
+    return false;
+}
+
+num_of_advs_t
+adv_table_snapshot_get_num_of_samples(const adv_table_snapshot_t* const p_snapshot, const num_of_advs_t idx)
+{
+    (void)p_snapshot;
+    (void)idx;
+    return 0;
+}
+
+bool
+adv_table_snapshot_get_sample(
+    const adv_table_snapshot_t* const p_snapshot,
+    const num_of_advs_t               idx,
+    const num_of_advs_t               sample_idx,
+    adv_report_t* const               p_adv_report)
+{
+    (void)p_snapshot;
+    (void)idx;
+    (void)sample_idx;
+    (void)p_adv_report;
+    return false;
+}
+
 void
 settings_save_to_flash(const gw_cfg_t* const p_gw_cfg)
 {
@@ -1082,6 +1123,23 @@ TEST_F(TestHttpServerCb, http_server_cb_init_ok_deinit_ok) // NOLINT
     ASSERT_EQ(0, this->m_alloc_free_call_count);
 }
 
+TEST_F(TestHttpServerCb, http_server_cb_init_twice) // NOLINT
+{
+    ASSERT_FALSE(g_pTestClass->m_is_fatfs_mounted);
+    ASSERT_TRUE(http_server_cb_init(GW_GWUI_PARTITION));
+    ASSERT_TRUE(g_pTestClass->m_is_fatfs_mounted);
+    ASSERT_TRUE(http_server_cb_init(GW_GWUI_PARTITION));
+    ASSERT_TRUE(g_pTestClass->m_is_fatfs_mounted);
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+    http_server_cb_deinit();
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+    ASSERT_FALSE(g_pTestClass->m_is_fatfs_mounted);
+    os_malloc_trace_dump();
+    ESP_LOG_WRAPPER_TEST_CHECK_LOG_RECORD("MEM_TRACE", ESP_LOG_INFO, "Num blocks allocated: 0");
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+    ASSERT_EQ(0, this->m_alloc_free_call_count);
+}
+
 TEST_F(TestHttpServerCb, http_server_cb_gen_resp_ok) // NOLINT
 {
     esp_log_wrapper_clear();
@@ -276,6 +276,11 @@ nrf52fw_hw_reset_nrf52(const bool flag_reset)
 {
 }
 
+void
+event_mgr_ack(const event_mgr_ev_e event)
+{
+}
+
 void
 event_mgr_subscribe_sig_static(
     event_mgr_ev_info_static_t* const p_ev_info_mem,
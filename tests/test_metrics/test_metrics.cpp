@@ -8,6 +8,7 @@
 #include "metrics.h"
 #include "gtest/gtest.h"
 #include <string>
+#include <cstring>
 #include "multi_heap.h"
 #include "esp_heap_caps.h"
 #include "os_malloc.h"
@@ -15,6 +16,7 @@
 #include "os_mutex_recursive.h"
 #include "os_task.h"
 #include "mac_addr.h"
+#include "adv_spool.h"
 #include "gw_mac.h"
 #include "nrf52fw.h"
 #include "fw_ver.h"
@@ -93,6 +95,7 @@ protected:
         this->m_mem_alloc_trace.clear();
         this->m_malloc_cnt         = 0;
         this->m_malloc_fail_on_cnt = 0;
+        this->m_crc32              = 0xAABBCCDD;
 
         cJSON_Hooks hooks = {
             .malloc_fn = &os_malloc,
@@ -126,10 +129,17 @@ protected:
     }
 
 public:
-    int64_t       m_uptime;
-    MemAllocTrace m_mem_alloc_trace;
-    uint32_t      m_malloc_cnt {};
-    uint32_t      m_malloc_fail_on_cnt {};
+    int64_t                              m_uptime;
+    MemAllocTrace                        m_mem_alloc_trace;
+    uint32_t                             m_malloc_cnt {};
+    uint32_t                             m_malloc_fail_on_cnt {};
+    uint32_t                             m_adv_ring_high_water_mark {};
+    uint32_t                             m_adv_ring_overflow_cnt {};
+    uint32_t                             m_adv_table_no_mem_drop_cnt {};
+    uint32_t                             m_recv_adv_suppressed_notify_cnt {};
+    adv_spool_stat_t                     m_adv_spool_stat {};
+    adv_table_retransmission_lists_len_t m_retransmission_lists_len {};
+    uint32_t                             m_crc32 {};
 
     TestMetrics();
 
@@ -352,7 +362,44 @@ heap_caps_get_largest_free_block(uint32_t caps)
 uint32_t
 crc32_le(uint32_t crc, uint8_t const* buf, uint32_t len)
 {
-    return 0xAABBCCDD;
+    return g_pTestClass->m_crc32;
+}
+
+uint32_t
+adv_ring_get_high_water_mark(void)
+{
+    return g_pTestClass->m_adv_ring_high_water_mark;
+}
+
+uint32_t
+adv_ring_get_overflow_cnt(void)
+{
+    return g_pTestClass->m_adv_ring_overflow_cnt;
+}
+
+uint32_t
+adv_table_get_no_mem_drop_cnt(void)
+{
+    return g_pTestClass->m_adv_table_no_mem_drop_cnt;
+}
+
+uint32_t
+event_mgr_get_num_suppressed_notifications(const event_mgr_ev_e event)
+{
+    assert(EVENT_MGR_EV_RECV_ADV == event);
+    return g_pTestClass->m_recv_adv_suppressed_notify_cnt;
+}
+
+void
+adv_spool_get_stat(adv_spool_stat_t* const p_stat)
+{
+    *p_stat = g_pTestClass->m_adv_spool_stat;
+}
+
+void
+adv_table_get_retransmission_lists_len(adv_table_retransmission_lists_len_t* const p_lists_len)
+{
+    *p_lists_len = g_pTestClass->m_retransmission_lists_len;
 }
 
 bool
@@ -417,6 +464,176 @@ TEST_F(TestMetrics, test_metrics_generate) // NOLINT
                "ruuvigw_nrf_self_reboot_cnt 2\n"
                "ruuvigw_nrf_ext_hw_reset_cnt 3\n"
                "ruuvigw_nrf_lost_ack_cnt 5\n"
+               "ruuvigw_adv_ring_high_water_mark 0\n"
+               "ruuvigw_adv_ring_overflow_cnt 0\n"
+               "ruuvigw_adv_table_no_mem_drop_cnt 0\n"
+               "ruuvigw_recv_adv_suppressed_notify_cnt 0\n"
+               "ruuvigw_adv_spool_size_bytes 0\n"
+               "ruuvigw_adv_spool_used_bytes 0\n"
+               "ruuvigw_adv_spool_stored_advs 0\n"
+               "ruuvigw_adv_spool_sent_advs 0\n"
+               "ruuvigw_adv_spool_dropped_advs 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"10\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"25\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"50\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"100\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"250\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"1000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"2500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"5000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"10000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"30000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"60000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"+Inf\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_sum{mode=\"instant\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_count{mode=\"instant\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"10\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"25\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"50\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"100\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"250\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"1000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"2500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"5000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"10000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"30000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"60000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"+Inf\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_sum{mode=\"periodic\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_count{mode=\"periodic\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"10000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"30000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"60000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"+Inf\"} 0\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"ruuvi\"} 0\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"ruuvi\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"10000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"30000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"60000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"+Inf\"} 0\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"custom\"} 0\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"custom\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"10000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"30000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"60000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"+Inf\"} 0\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"stats\"} 0\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"stats\"} 0\n"
+               "ruuvigw_http_conn_handshake_cnt 0\n"
+               "ruuvigw_http_conn_reused_cnt 0\n"
+               "ruuvigw_http_conn_reuse_ratio 0.000\n"
+               "ruuvigw_http_conn_handshake_time_ms_avg 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nvs_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nvs_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"gw_cfg_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"gw_cfg_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"gwui_mount\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"gwui_mount\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nrf52_fw_check\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nrf52_fw_check\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"adv_post_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"adv_post_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nrf52_device_id\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nrf52_device_id\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"network_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"network_init\"} 0\n"
+               "ruuvigw_boot_first_adv_relayed_us 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"2500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"5000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"10000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"25000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"100000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"+Inf\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"uart_parse\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"uart_parse\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"2500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"5000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"10000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"25000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"100000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"+Inf\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"json_gen_http\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"json_gen_http\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"2500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"5000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"10000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"25000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"100000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"+Inf\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"json_gen_mqtt\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"json_gen_mqtt\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"2500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"5000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"10000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"25000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"100000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"+Inf\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"hmac\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"hmac\"} 0\n"
+               "ruuvigw_pipeline_uart_parse_err_cnt 0\n"
+               "ruuvigw_pipeline_filter_dropped_cnt 0\n"
+               "ruuvigw_pipeline_adv_table_dedup_cnt 0\n"
+               "ruuvigw_pipeline_adv_table_evicted_cnt 0\n"
+               "ruuvigw_pipeline_queue_depth{list=\"http_ruuvi\"} 0\n"
+               "ruuvigw_pipeline_queue_depth{list=\"http_custom\"} 0\n"
+               "ruuvigw_pipeline_queue_depth{list=\"mqtt\"} 0\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_EXEC\"} 194796\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_32BIT\"} 201116\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_8BIT\"} 134284\n"
@@ -449,8 +666,53 @@ TEST_F(TestMetrics, test_metrics_generate) // NOLINT
         string(p_metrics_str));
     os_free(p_metrics_str);
 
+    this->m_uptime = 120000;
+    metrics_boot_stage_begin(METRICS_BOOT_STAGE_NVS_INIT);
+    this->m_uptime = 150000;
+    metrics_boot_stage_end(METRICS_BOOT_STAGE_NVS_INIT);
+    metrics_boot_stage_begin(METRICS_BOOT_STAGE_GWUI_MOUNT);
+    this->m_uptime = 2500000;
+    metrics_boot_stage_end(METRICS_BOOT_STAGE_GWUI_MOUNT);
+    metrics_boot_stage_begin(METRICS_BOOT_STAGE_NETWORK_INIT);
+    metrics_boot_first_adv_relayed();
+    this->m_uptime = 3000000;
+    metrics_boot_first_adv_relayed();
+
     metrics_received_advs_increment(RE_CA_UART_BLE_PHY_NOT_SET);
-    this->m_uptime = 15317668797;
+    this->m_uptime                         = 15317668797;
+    this->m_adv_ring_high_water_mark       = 17;
+    this->m_adv_ring_overflow_cnt          = 2;
+    this->m_adv_table_no_mem_drop_cnt      = 3;
+    this->m_recv_adv_suppressed_notify_cnt = 345;
+    this->m_adv_spool_stat.size_bytes       = 1048576;
+    this->m_adv_spool_stat.used_bytes       = 4608;
+    this->m_adv_spool_stat.num_stored_advs  = 120;
+    this->m_adv_spool_stat.num_sent_advs    = 80;
+    this->m_adv_spool_stat.num_dropped_advs = 5;
+    metrics_mqtt_publish_latency_add(METRICS_MQTT_PUBLISH_MODE_INSTANT, 3);
+    metrics_mqtt_publish_latency_add(METRICS_MQTT_PUBLISH_MODE_INSTANT, 40);
+    metrics_mqtt_publish_latency_add(METRICS_MQTT_PUBLISH_MODE_INSTANT, 70000);
+    metrics_mqtt_publish_latency_add(METRICS_MQTT_PUBLISH_MODE_PERIODIC, 12000);
+    metrics_http_post_duration_add(METRICS_HTTP_TARGET_RUUVI, 180);
+    metrics_http_post_duration_add(METRICS_HTTP_TARGET_CUSTOM, 5200);
+    metrics_http_conn_handshake_add(400);
+    metrics_http_conn_handshake_add(200);
+    metrics_http_conn_reused_inc();
+    metrics_http_conn_reused_inc();
+    metrics_stage_time_add(METRICS_STAGE_UART_PARSE, 8);
+    metrics_stage_time_add(METRICS_STAGE_UART_PARSE, 30);
+    metrics_stage_time_add(METRICS_STAGE_JSON_GEN_HTTP, 1200);
+    metrics_stage_time_add(METRICS_STAGE_JSON_GEN_MQTT, 200000);
+    metrics_stage_time_add(METRICS_STAGE_HMAC, 300);
+    metrics_pipeline_cnt_inc(METRICS_PIPELINE_CNT_UART_PARSE_ERR);
+    metrics_pipeline_cnt_inc(METRICS_PIPELINE_CNT_FILTER_DROPPED);
+    metrics_pipeline_cnt_inc(METRICS_PIPELINE_CNT_FILTER_DROPPED);
+    for (int i = 0; i < 3; ++i)
+    {
+        metrics_pipeline_cnt_inc(METRICS_PIPELINE_CNT_ADV_TABLE_DEDUP);
+    }
+    this->m_retransmission_lists_len.http_ruuvi  = 5;
+    this->m_retransmission_lists_len.http_custom = 7;
 
     metrics_nrf_lost_ack_cnt_inc();
     metrics_nrf_self_reboot_cnt_inc();
@@ -464,6 +726,176 @@ TEST_F(TestMetrics, test_metrics_generate) // NOLINT
                "ruuvigw_nrf_self_reboot_cnt 3\n"
                "ruuvigw_nrf_ext_hw_reset_cnt 4\n"
                "ruuvigw_nrf_lost_ack_cnt 6\n"
+               "ruuvigw_adv_ring_high_water_mark 17\n"
+               "ruuvigw_adv_ring_overflow_cnt 2\n"
+               "ruuvigw_adv_table_no_mem_drop_cnt 3\n"
+               "ruuvigw_recv_adv_suppressed_notify_cnt 345\n"
+               "ruuvigw_adv_spool_size_bytes 1048576\n"
+               "ruuvigw_adv_spool_used_bytes 4608\n"
+               "ruuvigw_adv_spool_stored_advs 120\n"
+               "ruuvigw_adv_spool_sent_advs 80\n"
+               "ruuvigw_adv_spool_dropped_advs 5\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"10\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"25\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"50\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"100\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"250\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"500\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"1000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"2500\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"5000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"10000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"30000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"60000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"+Inf\"} 3\n"
+               "ruuvigw_mqtt_publish_latency_ms_sum{mode=\"instant\"} 70043\n"
+               "ruuvigw_mqtt_publish_latency_ms_count{mode=\"instant\"} 3\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"10\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"25\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"50\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"100\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"250\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"1000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"2500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"5000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"10000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"30000\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"60000\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"+Inf\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_sum{mode=\"periodic\"} 12000\n"
+               "ruuvigw_mqtt_publish_latency_ms_count{mode=\"periodic\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"250\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"500\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"1000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"2500\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"5000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"10000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"30000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"60000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"+Inf\"} 1\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"ruuvi\"} 180\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"ruuvi\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"10000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"30000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"60000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"+Inf\"} 1\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"custom\"} 5200\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"custom\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"10000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"30000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"60000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"+Inf\"} 0\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"stats\"} 0\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"stats\"} 0\n"
+               "ruuvigw_http_conn_handshake_cnt 2\n"
+               "ruuvigw_http_conn_reused_cnt 2\n"
+               "ruuvigw_http_conn_reuse_ratio 0.500\n"
+               "ruuvigw_http_conn_handshake_time_ms_avg 300\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nvs_init\"} 120000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nvs_init\"} 30000\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"gw_cfg_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"gw_cfg_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"gwui_mount\"} 150000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"gwui_mount\"} 2350000\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nrf52_fw_check\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nrf52_fw_check\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"adv_post_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"adv_post_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nrf52_device_id\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nrf52_device_id\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"network_init\"} 2500000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"network_init\"} 0\n"
+               "ruuvigw_boot_first_adv_relayed_us 2500000\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"10\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"25\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"50\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"100\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"250\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"500\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"1000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"2500\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"5000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"10000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"25000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"100000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"+Inf\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"uart_parse\"} 38\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"uart_parse\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"2500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"5000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"10000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"25000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"100000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"json_gen_http\"} 1200\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"json_gen_http\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"2500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"5000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"10000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"25000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"100000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"json_gen_mqtt\"} 200000\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"json_gen_mqtt\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"1000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"2500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"5000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"10000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"25000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"100000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"hmac\"} 300\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"hmac\"} 1\n"
+               "ruuvigw_pipeline_uart_parse_err_cnt 1\n"
+               "ruuvigw_pipeline_filter_dropped_cnt 2\n"
+               "ruuvigw_pipeline_adv_table_dedup_cnt 3\n"
+               "ruuvigw_pipeline_adv_table_evicted_cnt 0\n"
+               "ruuvigw_pipeline_queue_depth{list=\"http_ruuvi\"} 5\n"
+               "ruuvigw_pipeline_queue_depth{list=\"http_custom\"} 7\n"
+               "ruuvigw_pipeline_queue_depth{list=\"mqtt\"} 0\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_EXEC\"} 194796\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_32BIT\"} 201116\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_8BIT\"} 134284\n"
@@ -508,6 +940,176 @@ TEST_F(TestMetrics, test_metrics_generate) // NOLINT
                "ruuvigw_nrf_self_reboot_cnt 3\n"
                "ruuvigw_nrf_ext_hw_reset_cnt 4\n"
                "ruuvigw_nrf_lost_ack_cnt 6\n"
+               "ruuvigw_adv_ring_high_water_mark 17\n"
+               "ruuvigw_adv_ring_overflow_cnt 2\n"
+               "ruuvigw_adv_table_no_mem_drop_cnt 3\n"
+               "ruuvigw_recv_adv_suppressed_notify_cnt 345\n"
+               "ruuvigw_adv_spool_size_bytes 1048576\n"
+               "ruuvigw_adv_spool_used_bytes 4608\n"
+               "ruuvigw_adv_spool_stored_advs 120\n"
+               "ruuvigw_adv_spool_sent_advs 80\n"
+               "ruuvigw_adv_spool_dropped_advs 5\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"10\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"25\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"50\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"100\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"250\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"500\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"1000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"2500\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"5000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"10000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"30000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"60000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"+Inf\"} 3\n"
+               "ruuvigw_mqtt_publish_latency_ms_sum{mode=\"instant\"} 70043\n"
+               "ruuvigw_mqtt_publish_latency_ms_count{mode=\"instant\"} 3\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"10\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"25\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"50\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"100\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"250\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"1000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"2500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"5000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"10000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"30000\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"60000\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"+Inf\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_sum{mode=\"periodic\"} 12000\n"
+               "ruuvigw_mqtt_publish_latency_ms_count{mode=\"periodic\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"250\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"500\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"1000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"2500\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"5000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"10000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"30000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"60000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"+Inf\"} 1\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"ruuvi\"} 180\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"ruuvi\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"10000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"30000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"60000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"+Inf\"} 1\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"custom\"} 5200\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"custom\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"10000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"30000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"60000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"+Inf\"} 0\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"stats\"} 0\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"stats\"} 0\n"
+               "ruuvigw_http_conn_handshake_cnt 2\n"
+               "ruuvigw_http_conn_reused_cnt 2\n"
+               "ruuvigw_http_conn_reuse_ratio 0.500\n"
+               "ruuvigw_http_conn_handshake_time_ms_avg 300\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nvs_init\"} 120000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nvs_init\"} 30000\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"gw_cfg_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"gw_cfg_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"gwui_mount\"} 150000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"gwui_mount\"} 2350000\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nrf52_fw_check\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nrf52_fw_check\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"adv_post_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"adv_post_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nrf52_device_id\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nrf52_device_id\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"network_init\"} 2500000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"network_init\"} 0\n"
+               "ruuvigw_boot_first_adv_relayed_us 2500000\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"10\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"25\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"50\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"100\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"250\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"500\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"1000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"2500\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"5000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"10000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"25000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"100000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"+Inf\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"uart_parse\"} 38\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"uart_parse\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"2500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"5000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"10000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"25000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"100000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"json_gen_http\"} 1200\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"json_gen_http\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"2500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"5000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"10000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"25000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"100000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"json_gen_mqtt\"} 200000\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"json_gen_mqtt\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"1000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"2500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"5000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"10000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"25000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"100000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"hmac\"} 300\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"hmac\"} 1\n"
+               "ruuvigw_pipeline_uart_parse_err_cnt 1\n"
+               "ruuvigw_pipeline_filter_dropped_cnt 2\n"
+               "ruuvigw_pipeline_adv_table_dedup_cnt 3\n"
+               "ruuvigw_pipeline_adv_table_evicted_cnt 0\n"
+               "ruuvigw_pipeline_queue_depth{list=\"http_ruuvi\"} 5\n"
+               "ruuvigw_pipeline_queue_depth{list=\"http_custom\"} 7\n"
+               "ruuvigw_pipeline_queue_depth{list=\"mqtt\"} 0\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_EXEC\"} 194796\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_32BIT\"} 201116\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_8BIT\"} 134284\n"
@@ -552,6 +1154,176 @@ TEST_F(TestMetrics, test_metrics_generate) // NOLINT
                "ruuvigw_nrf_self_reboot_cnt 3\n"
                "ruuvigw_nrf_ext_hw_reset_cnt 4\n"
                "ruuvigw_nrf_lost_ack_cnt 6\n"
+               "ruuvigw_adv_ring_high_water_mark 17\n"
+               "ruuvigw_adv_ring_overflow_cnt 2\n"
+               "ruuvigw_adv_table_no_mem_drop_cnt 3\n"
+               "ruuvigw_recv_adv_suppressed_notify_cnt 345\n"
+               "ruuvigw_adv_spool_size_bytes 1048576\n"
+               "ruuvigw_adv_spool_used_bytes 4608\n"
+               "ruuvigw_adv_spool_stored_advs 120\n"
+               "ruuvigw_adv_spool_sent_advs 80\n"
+               "ruuvigw_adv_spool_dropped_advs 5\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"10\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"25\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"50\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"100\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"250\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"500\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"1000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"2500\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"5000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"10000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"30000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"60000\"} 2\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"instant\",le=\"+Inf\"} 3\n"
+               "ruuvigw_mqtt_publish_latency_ms_sum{mode=\"instant\"} 70043\n"
+               "ruuvigw_mqtt_publish_latency_ms_count{mode=\"instant\"} 3\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"10\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"25\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"50\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"100\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"250\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"1000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"2500\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"5000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"10000\"} 0\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"30000\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"60000\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_bucket{mode=\"periodic\",le=\"+Inf\"} 1\n"
+               "ruuvigw_mqtt_publish_latency_ms_sum{mode=\"periodic\"} 12000\n"
+               "ruuvigw_mqtt_publish_latency_ms_count{mode=\"periodic\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"250\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"500\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"1000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"2500\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"5000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"10000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"30000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"60000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"ruuvi\",le=\"+Inf\"} 1\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"ruuvi\"} 180\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"ruuvi\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"10000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"30000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"60000\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"custom\",le=\"+Inf\"} 1\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"custom\"} 5200\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"custom\"} 1\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"10\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"25\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"50\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"100\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"250\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"1000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"2500\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"5000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"10000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"30000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"60000\"} 0\n"
+               "ruuvigw_http_post_duration_ms_bucket{target=\"stats\",le=\"+Inf\"} 0\n"
+               "ruuvigw_http_post_duration_ms_sum{target=\"stats\"} 0\n"
+               "ruuvigw_http_post_duration_ms_count{target=\"stats\"} 0\n"
+               "ruuvigw_http_conn_handshake_cnt 2\n"
+               "ruuvigw_http_conn_reused_cnt 2\n"
+               "ruuvigw_http_conn_reuse_ratio 0.500\n"
+               "ruuvigw_http_conn_handshake_time_ms_avg 300\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nvs_init\"} 120000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nvs_init\"} 30000\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"gw_cfg_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"gw_cfg_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"gwui_mount\"} 150000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"gwui_mount\"} 2350000\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nrf52_fw_check\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nrf52_fw_check\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"adv_post_init\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"adv_post_init\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"nrf52_device_id\"} 0\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"nrf52_device_id\"} 0\n"
+               "ruuvigw_boot_stage_begin_us{stage=\"network_init\"} 2500000\n"
+               "ruuvigw_boot_stage_duration_us{stage=\"network_init\"} 0\n"
+               "ruuvigw_boot_first_adv_relayed_us 2500000\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"10\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"25\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"50\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"100\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"250\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"500\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"1000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"2500\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"5000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"10000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"25000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"100000\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"uart_parse\",le=\"+Inf\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"uart_parse\"} 38\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"uart_parse\"} 2\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"2500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"5000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"10000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"25000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"100000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_http\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"json_gen_http\"} 1200\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"json_gen_http\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"1000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"2500\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"5000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"10000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"25000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"100000\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"json_gen_mqtt\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"json_gen_mqtt\"} 200000\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"json_gen_mqtt\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"10\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"25\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"50\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"100\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"250\"} 0\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"1000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"2500\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"5000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"10000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"25000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"100000\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_bucket{stage=\"hmac\",le=\"+Inf\"} 1\n"
+               "ruuvigw_pipeline_stage_time_us_sum{stage=\"hmac\"} 300\n"
+               "ruuvigw_pipeline_stage_time_us_count{stage=\"hmac\"} 1\n"
+               "ruuvigw_pipeline_uart_parse_err_cnt 1\n"
+               "ruuvigw_pipeline_filter_dropped_cnt 2\n"
+               "ruuvigw_pipeline_adv_table_dedup_cnt 3\n"
+               "ruuvigw_pipeline_adv_table_evicted_cnt 0\n"
+               "ruuvigw_pipeline_queue_depth{list=\"http_ruuvi\"} 5\n"
+               "ruuvigw_pipeline_queue_depth{list=\"http_custom\"} 7\n"
+               "ruuvigw_pipeline_queue_depth{list=\"mqtt\"} 0\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_EXEC\"} 194796\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_32BIT\"} 201116\n"
                "ruuvigw_heap_free_bytes{capability=\"MALLOC_CAP_8BIT\"} 134284\n"
@@ -586,3 +1358,32 @@ TEST_F(TestMetrics, test_metrics_generate) // NOLINT
     ASSERT_TRUE(esp_log_wrapper_is_empty());
     ASSERT_TRUE(g_pTestClass->m_mem_alloc_trace.is_empty());
 }
+
+TEST_F(TestMetrics, test_metrics_gw_cfg_hash_cached) // NOLINT
+{
+    metrics_init();
+
+    char* p_metrics_str = metrics_generate();
+    ASSERT_NE(nullptr, p_metrics_str);
+    ASSERT_NE(nullptr, strstr(p_metrics_str, "ruuvigw_gw_cfg_crc32 2864434397\n"));
+    ASSERT_NE(nullptr, strstr(p_metrics_str, "ruuvigw_ruuvi_json_crc32 2864434397\n"));
+    os_free(p_metrics_str);
+
+    // The hashes are not recalculated on every request
+    this->m_crc32 = 0x11223344;
+    p_metrics_str = metrics_generate();
+    ASSERT_NE(nullptr, p_metrics_str);
+    ASSERT_NE(nullptr, strstr(p_metrics_str, "ruuvigw_gw_cfg_crc32 2864434397\n"));
+    ASSERT_NE(nullptr, strstr(p_metrics_str, "ruuvigw_ruuvi_json_crc32 2864434397\n"));
+    os_free(p_metrics_str);
+
+    metrics_gw_cfg_hash_update();
+    p_metrics_str = metrics_generate();
+    ASSERT_NE(nullptr, p_metrics_str);
+    ASSERT_NE(nullptr, strstr(p_metrics_str, "ruuvigw_gw_cfg_crc32 287454020\n"));
+    ASSERT_NE(nullptr, strstr(p_metrics_str, "ruuvigw_ruuvi_json_crc32 287454020\n"));
+    os_free(p_metrics_str);
+
+    ASSERT_TRUE(esp_log_wrapper_is_empty());
+    ASSERT_TRUE(g_pTestClass->m_mem_alloc_trace.is_empty());
+}
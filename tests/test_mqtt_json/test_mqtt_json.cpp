@@ -161,6 +161,7 @@ TEST_F(TestMqttJson, test_1) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -203,6 +204,7 @@ TEST_F(TestMqttJson, test_insufficient_chunk_size) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -215,6 +217,134 @@ TEST_F(TestMqttJson, test_insufficient_chunk_size) // NOLINT
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
 
+TEST_F(TestMqttJson, test_1_in_buf) // NOLINT
+{
+    const time_t                 timestamp     = 1612358920;
+    const mac_address_str_t      gw_mac_addr   = { .str_buf = "AA:CC:EE:00:11:22" };
+    const char*                  p_coordinates = "170.112233,59.445566";
+    const std::array<uint8_t, 1> data          = { 0xAAU };
+
+    adv_report_t adv_report = {
+        .timestamp = 1612358929,
+        .tag_mac   = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x03 },
+        .rssi      = -70,
+        .data_len  = data.size(),
+    };
+    memcpy(adv_report.data_buf, data.data(), data.size());
+
+    std::array<char, 1024>                                           buf {};
+    std::array<uint64_t, (1024U + MQTT_JSON_GEN_ARENA_OVERHEAD) / 8> arena_mem {};
+
+    mqtt_json_gen_arena_t arena = {};
+    arena.p_mem                 = reinterpret_cast<uint8_t*>(arena_mem.data());
+    arena.size                  = sizeof(arena_mem);
+
+    const string exp_json = string(
+        "{"
+        "\"gw_mac\":\"AA:CC:EE:00:11:22\","
+        "\"rssi\":-70,"
+        "\"aoa\":[],"
+        "\"gwts\":1612358920,"
+        "\"ts\":1612358929,"
+        "\"data\":\"AA\","
+        "\"coords\":\"170.112233,59.445566\""
+        "}");
+
+    // The arena is reused for every message
+    for (int i = 0; i < 2; ++i)
+    {
+        str_buf_t str_buf = str_buf_init(buf.data(), buf.size());
+        ASSERT_TRUE(mqtt_create_json_str_in_buf(
+            &str_buf,
+            &arena,
+            &adv_report,
+            nullptr,
+            true,
+            timestamp,
+            &gw_mac_addr,
+            p_coordinates,
+            GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW));
+        ASSERT_EQ(exp_json, string(buf.data()));
+        ASSERT_EQ(exp_json.size(), str_buf.idx);
+        ASSERT_NE(0, arena.used);
+        ASSERT_LE(arena.used, arena.size);
+    }
+    ASSERT_EQ(0, this->m_malloc_cnt);
+}
+
+TEST_F(TestMqttJson, test_1_in_buf_insufficient_buf_size) // NOLINT
+{
+    const time_t                 timestamp     = 1612358920;
+    const mac_address_str_t      gw_mac_addr   = { .str_buf = "AA:CC:EE:00:11:22" };
+    const char*                  p_coordinates = "170.112233,59.445566";
+    const std::array<uint8_t, 1> data          = { 0xAAU };
+
+    adv_report_t adv_report = {
+        .timestamp = 1612358929,
+        .tag_mac   = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x03 },
+        .rssi      = -70,
+        .data_len  = data.size(),
+    };
+    memcpy(adv_report.data_buf, data.data(), data.size());
+
+    std::array<char, 51>                                             buf {};
+    std::array<uint64_t, (1024U + MQTT_JSON_GEN_ARENA_OVERHEAD) / 8> arena_mem {};
+
+    mqtt_json_gen_arena_t arena = {};
+    arena.p_mem                 = reinterpret_cast<uint8_t*>(arena_mem.data());
+    arena.size                  = sizeof(arena_mem);
+
+    str_buf_t str_buf = str_buf_init(buf.data(), buf.size());
+    ASSERT_FALSE(mqtt_create_json_str_in_buf(
+        &str_buf,
+        &arena,
+        &adv_report,
+        nullptr,
+        true,
+        timestamp,
+        &gw_mac_addr,
+        p_coordinates,
+        GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW));
+    ASSERT_EQ(string(""), string(buf.data()));
+    ASSERT_EQ(0, str_buf.idx);
+    ASSERT_EQ(0, this->m_malloc_cnt);
+}
+
+TEST_F(TestMqttJson, test_1_in_buf_insufficient_arena_size) // NOLINT
+{
+    const mac_address_str_t      gw_mac_addr = { .str_buf = "AA:CC:EE:00:11:22" };
+    const std::array<uint8_t, 1> data        = { 0xAAU };
+
+    adv_report_t adv_report = {
+        .timestamp = 1612358929,
+        .tag_mac   = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x03 },
+        .rssi      = -70,
+        .data_len  = data.size(),
+    };
+    memcpy(adv_report.data_buf, data.data(), data.size());
+
+    std::array<char, 1024>   buf {};
+    std::array<uint64_t, 64> arena_mem {}; // Smaller than the JSON buffer
+
+    mqtt_json_gen_arena_t arena = {};
+    arena.p_mem                 = reinterpret_cast<uint8_t*>(arena_mem.data());
+    arena.size                  = sizeof(arena_mem);
+
+    str_buf_t str_buf = str_buf_init(buf.data(), buf.size());
+    ASSERT_FALSE(mqtt_create_json_str_in_buf(
+        &str_buf,
+        &arena,
+        &adv_report,
+        nullptr,
+        false,
+        0,
+        &gw_mac_addr,
+        "",
+        GW_CFG_MQTT_DATA_FORMAT_RUUVI_RAW));
+    ASSERT_EQ(0, str_buf.idx);
+    ASSERT_EQ(0, this->m_malloc_cnt);
+}
+
 TEST_F(TestMqttJson, test_1_without_timestamps) // NOLINT
 {
     const json_stream_gen_size_t max_chunk_size = 1024U;
@@ -233,6 +363,7 @@ TEST_F(TestMqttJson, test_1_without_timestamps) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         false,
         timestamp,
         &gw_mac_addr,
@@ -277,6 +408,7 @@ TEST_F(TestMqttJson, test_raw_and_decoded_df5) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -334,6 +466,71 @@ TEST_F(TestMqttJson, test_decoded_df5) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
+        true,
+        timestamp,
+        &gw_mac_addr,
+        p_coordinates,
+        GW_CFG_MQTT_DATA_FORMAT_RUUVI_DECODED,
+        max_chunk_size);
+    ASSERT_NE(nullptr, this->m_json_str.buf);
+
+    ASSERT_EQ(
+        string("{"
+               "\"gw_mac\":\"AA:CC:EE:00:11:22\","
+               "\"rssi\":-70,"
+               "\"aoa\":[],"
+               "\"gwts\":1612358920,"
+               "\"ts\":1612358929,"
+               "\"dataFormat\":5,"
+               "\"temperature\":29.455,"
+               "\"humidity\":76.3800,"
+               "\"pressure\":100631,"
+               "\"accelX\":1.020,"
+               "\"accelY\":-0.208,"
+               "\"accelZ\":-0.008,"
+               "\"movementCounter\":183,"
+               "\"voltage\":2.784,"
+               "\"txPower\":4,"
+               "\"measurementSequenceNumber\":38282,"
+               "\"id\":\"E3:75:CF:37:4E:23\","
+               "\"coords\":\"170.112233,59.445566\""
+               "}"),
+        string(this->m_json_str.buf));
+    str_buf_free_buf(&this->m_json_str);
+    ASSERT_EQ(2, this->m_malloc_cnt);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestMqttJson, test_decoded_df5_delta) // NOLINT
+{
+    const json_stream_gen_size_t  max_chunk_size = 1024U;
+    const time_t                  timestamp      = 1612358920;
+    const mac_address_str_t       gw_mac_addr    = { .str_buf = "AA:CC:EE:00:11:22" };
+    const char*                   p_coordinates  = "170.112233,59.445566";
+    const std::array<uint8_t, 31> data           = {
+                  0x02U, 0x01U, 0x06U, 0x1BU, 0xFFU, 0x99U, 0x04U, 0x05U, 0x17U, 0x03U, 0x77U, 0x58U, 0xC5U, 0xC7U, 0x03U, 0xFCU,
+                  0xFFU, 0x30U, 0xFFU, 0xF8U, 0x94U, 0x16U, 0xB7U, 0x95U, 0x8AU, 0xE3U, 0x75U, 0xCFU, 0x37U, 0x4EU, 0x23U,
+    };
+    // The previously published data differs only in temperature (0x1705 instead of 0x1703)
+    const std::array<uint8_t, 31> data_prev = {
+        0x02U, 0x01U, 0x06U, 0x1BU, 0xFFU, 0x99U, 0x04U, 0x05U, 0x17U, 0x05U, 0x77U, 0x58U, 0xC5U, 0xC7U, 0x03U, 0xFCU,
+        0xFFU, 0x30U, 0xFFU, 0xF8U, 0x94U, 0x16U, 0xB7U, 0x95U, 0x8AU, 0xE3U, 0x75U, 0xCFU, 0x37U, 0x4EU, 0x23U,
+    };
+
+    adv_report_t adv_report = {
+        .timestamp = 1612358929,
+        .tag_mac   = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x03 },
+        .rssi      = -70,
+        .data_len  = data.size(),
+    };
+    memcpy(adv_report.data_buf, data.data(), data.size());
+    adv_report_t adv_report_prev = adv_report;
+    memcpy(adv_report_prev.data_buf, data_prev.data(), data_prev.size());
+
+    this->m_json_str = mqtt_create_json_str(
+        &adv_report,
+        &adv_report_prev,
         true,
         timestamp,
         &gw_mac_addr,
@@ -342,6 +539,61 @@ TEST_F(TestMqttJson, test_decoded_df5) // NOLINT
         max_chunk_size);
     ASSERT_NE(nullptr, this->m_json_str.buf);
 
+    ASSERT_EQ(
+        string("{"
+               "\"gw_mac\":\"AA:CC:EE:00:11:22\","
+               "\"rssi\":-70,"
+               "\"aoa\":[],"
+               "\"gwts\":1612358920,"
+               "\"ts\":1612358929,"
+               "\"dataFormat\":5,"
+               "\"delta\":true,"
+               "\"temperature\":29.455,"
+               "\"measurementSequenceNumber\":38282,"
+               "\"id\":\"E3:75:CF:37:4E:23\","
+               "\"coords\":\"170.112233,59.445566\""
+               "}"),
+        string(this->m_json_str.buf));
+    str_buf_free_buf(&this->m_json_str);
+    ASSERT_EQ(2, this->m_malloc_cnt);
+    ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
+}
+
+TEST_F(TestMqttJson, test_decoded_df5_delta_prev_with_other_data_format) // NOLINT
+{
+    const json_stream_gen_size_t  max_chunk_size = 1024U;
+    const time_t                  timestamp      = 1612358920;
+    const mac_address_str_t       gw_mac_addr    = { .str_buf = "AA:CC:EE:00:11:22" };
+    const char*                   p_coordinates  = "170.112233,59.445566";
+    const std::array<uint8_t, 31> data           = {
+                  0x02U, 0x01U, 0x06U, 0x1BU, 0xFFU, 0x99U, 0x04U, 0x05U, 0x17U, 0x03U, 0x77U, 0x58U, 0xC5U, 0xC7U, 0x03U, 0xFCU,
+                  0xFFU, 0x30U, 0xFFU, 0xF8U, 0x94U, 0x16U, 0xB7U, 0x95U, 0x8AU, 0xE3U, 0x75U, 0xCFU, 0x37U, 0x4EU, 0x23U,
+    };
+
+    adv_report_t adv_report = {
+        .timestamp = 1612358929,
+        .tag_mac   = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x03 },
+        .rssi      = -70,
+        .data_len  = data.size(),
+    };
+    memcpy(adv_report.data_buf, data.data(), data.size());
+    adv_report_t adv_report_prev = adv_report;
+    memset(adv_report_prev.data_buf, 0, sizeof(adv_report_prev.data_buf));
+    adv_report_prev.data_len    = 1;
+    adv_report_prev.data_buf[0] = 0xAAU;
+
+    this->m_json_str = mqtt_create_json_str(
+        &adv_report,
+        &adv_report_prev,
+        true,
+        timestamp,
+        &gw_mac_addr,
+        p_coordinates,
+        GW_CFG_MQTT_DATA_FORMAT_RUUVI_DECODED,
+        max_chunk_size);
+    ASSERT_NE(nullptr, this->m_json_str.buf);
+
+    // The previous data can't be decoded as data format 5, so all fields are generated (keyframe)
     ASSERT_EQ(
         string("{"
                "\"gw_mac\":\"AA:CC:EE:00:11:22\","
@@ -404,6 +656,7 @@ TEST_F(TestMqttJson, test_raw_df6) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -463,6 +716,7 @@ TEST_F(TestMqttJson, test_raw_and_decoded_df6) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -537,6 +791,7 @@ TEST_F(TestMqttJson, test_decoded_df6) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -615,6 +870,7 @@ TEST_F(TestMqttJson, test_raw_df_e1) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -680,6 +936,7 @@ TEST_F(TestMqttJson, test_raw_and_decoded_df_e1) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -765,6 +1022,7 @@ TEST_F(TestMqttJson, test_decoded_df_e1) // NOLINT
 
     this->m_json_str = mqtt_create_json_str(
         &adv_report,
+        nullptr,
         true,
         timestamp,
         &gw_mac_addr,
@@ -807,3 +1065,105 @@ TEST_F(TestMqttJson, test_decoded_df_e1) // NOLINT
     ASSERT_EQ(2, this->m_malloc_cnt);
     ASSERT_TRUE(this->m_mem_alloc_trace.is_empty());
 }
+
+TEST_F(TestMqttJson, test_batch) // NOLINT
+{
+    const time_t            timestamp     = 1612358920;
+    const mac_address_str_t gw_mac_addr   = { .str_buf = "AA:CC:EE:00:11:22" };
+    const char*             p_coordinates = "170.112233,59.445566";
+
+    std::array<adv_report_t, 2> advs = { {
+        {
+            .timestamp = 1612358929,
+            .tag_mac   = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x03 },
+            .rssi      = -70,
+            .data_len  = 1,
+            .data_buf  = { 0xAAU },
+        },
+        {
+            .timestamp = 1612358930,
+            .tag_mac   = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, 0x04 },
+            .rssi      = -71,
+            .data_len  = 2,
+            .data_buf  = { 0xBBU, 0x01U },
+        },
+    } };
+
+    std::array<char, 1024> buf {};
+    str_buf_t              str_buf = str_buf_init(buf.data(), buf.size());
+
+    ASSERT_EQ(
+        2,
+        mqtt_create_json_batch(&str_buf, advs.data(), advs.size(), true, timestamp, &gw_mac_addr, p_coordinates));
+    ASSERT_EQ(
+        string("{"
+               "\"gw_mac\":\"AA:CC:EE:00:11:22\","
+               "\"gwts\":1612358920,"
+               "\"coords\":\"170.112233,59.445566\","
+               "\"tags\":{"
+               "\"AA:BB:CC:01:02:03\":{\"rssi\":-70,\"ts\":1612358929,\"data\":\"AA\"},"
+               "\"AA:BB:CC:01:02:04\":{\"rssi\":-71,\"ts\":1612358930,\"data\":\"BB01\"}"
+               "}}"),
+        string(buf.data()));
+    ASSERT_EQ(strlen(buf.data()), str_buf.idx);
+    ASSERT_EQ(0, this->m_malloc_cnt);
+
+    // The buffer is reused and the counters are used instead of the timestamps.
+    ASSERT_EQ(1, mqtt_create_json_batch(&str_buf, advs.data(), 1, false, timestamp, &gw_mac_addr, "a\"b\\c"));
+    ASSERT_EQ(
+        string("{"
+               "\"gw_mac\":\"AA:CC:EE:00:11:22\","
+               "\"coords\":\"a\\\"b\\\\c\","
+               "\"tags\":{"
+               "\"AA:BB:CC:01:02:03\":{\"rssi\":-70,\"cnt\":1612358929,\"data\":\"AA\"}"
+               "}}"),
+        string(buf.data()));
+    ASSERT_EQ(0, this->m_malloc_cnt);
+}
+
+TEST_F(TestMqttJson, test_batch_limited_by_buffer_size) // NOLINT
+{
+    const mac_address_str_t gw_mac_addr = { .str_buf = "AA:CC:EE:00:11:22" };
+
+    std::array<adv_report_t, 3> advs = {};
+    for (uint32_t i = 0; i < advs.size(); ++i)
+    {
+        advs[i].timestamp   = 100 + i;
+        advs[i].tag_mac     = { 0xaa, 0xbb, 0xcc, 0x01, 0x02, static_cast<uint8_t>(i) };
+        advs[i].rssi        = -50;
+        advs[i].data_len    = 1;
+        advs[i].data_buf[0] = 0x11U;
+    }
+    const string exp_json_2_tags = string(
+        "{"
+        "\"gw_mac\":\"AA:CC:EE:00:11:22\","
+        "\"coords\":\"\","
+        "\"tags\":{"
+        "\"AA:BB:CC:01:02:00\":{\"rssi\":-50,\"cnt\":100,\"data\":\"11\"},"
+        "\"AA:BB:CC:01:02:01\":{\"rssi\":-50,\"cnt\":101,\"data\":\"11\"}"
+        "}}");
+
+    // Exactly enough space for two tags (plus the null terminator)
+    std::array<char, 1024> buf {};
+    str_buf_t              str_buf = str_buf_init(buf.data(), exp_json_2_tags.size() + 1);
+    ASSERT_EQ(2, mqtt_create_json_batch(&str_buf, advs.data(), advs.size(), false, 0, &gw_mac_addr, ""));
+    ASSERT_EQ(exp_json_2_tags, string(buf.data()));
+
+    // One byte less - only one tag fits
+    str_buf = str_buf_init(buf.data(), exp_json_2_tags.size());
+    ASSERT_EQ(1, mqtt_create_json_batch(&str_buf, advs.data(), advs.size(), false, 0, &gw_mac_addr, ""));
+    ASSERT_EQ(
+        string("{"
+               "\"gw_mac\":\"AA:CC:EE:00:11:22\","
+               "\"coords\":\"\","
+               "\"tags\":{"
+               "\"AA:BB:CC:01:02:00\":{\"rssi\":-50,\"cnt\":100,\"data\":\"11\"}"
+               "}}"),
+        string(buf.data()));
+
+    // Not enough space even for one tag
+    str_buf = str_buf_init(buf.data(), 60);
+    ASSERT_EQ(0, mqtt_create_json_batch(&str_buf, advs.data(), advs.size(), false, 0, &gw_mac_addr, ""));
+    ASSERT_EQ(string(""), string(buf.data()));
+    ASSERT_EQ(0, this->m_malloc_cnt);
+}
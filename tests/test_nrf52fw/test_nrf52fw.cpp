@@ -19,6 +19,7 @@
 #include "freertos/FreeRTOS.h"
 #include "os_task.h"
 #include "os_malloc.h"
+#include "os_mutex.h"
 #include "nrf52swd.h"
 
 using namespace std;
@@ -383,6 +384,24 @@ nrf52swd_init_gpio_cfg_nreset(void)
     return true;
 }
 
+os_mutex_t
+os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
+{
+    return reinterpret_cast<os_mutex_t>(p_mutex_static);
+}
+
+void
+os_mutex_lock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
+void
+os_mutex_unlock(os_mutex_t const h_mutex)
+{
+    (void)h_mutex;
+}
+
 const char*
 os_task_get_name(void)
 {